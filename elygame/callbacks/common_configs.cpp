@@ -29,6 +29,7 @@ using namespace ely;
 void callbacksInit()
 {
 	PRINT_DEBUG("Executing callbacksInit");
+	ELY_REGISTER_FUNCTION(CALLBACKS, default_callback__);
 	callAllInits();
 }
 
@@ -36,6 +37,9 @@ void callbacksEnd()
 {
 	PRINT_DEBUG("Executing callbacksEnd");
 	callAllEnds();
+	//the registered functions are no more valid
+	FunctionRegistry::GetSingleton().unregisterFunctions(
+			FunctionRegistry::CALLBACKS);
 }
 
 void default_callback__(const Event* event, void* data)
@@ -25,6 +25,7 @@
 #define COMMON_CONFIGS_H_
 
 #include <eventHandler.h>
+#include "ObjectModel/FunctionRegistry.h"
 
 __attribute__((constructor)) void callbacksInit();
 void callAllInits();
@@ -233,6 +233,27 @@ void fast_down_Activity_Actor(const Event* event, void* data)
 ///Init/end functions: see common_configs.cpp
 void Actor_clbkInit()
 {
+	//register the functions
+	ELY_REGISTER_FUNCTION(CALLBACKS, fast_Activity_Actor);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_fast_Activity_Actor);
+	ELY_REGISTER_FUNCTION(CALLBACKS, forward_Activity_Actor);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_forward_Activity_Actor);
+	ELY_REGISTER_FUNCTION(CALLBACKS, fast_forward_Activity_Actor);
+	ELY_REGISTER_FUNCTION(CALLBACKS, backward_Activity_Actor);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_backward_Activity_Actor);
+	ELY_REGISTER_FUNCTION(CALLBACKS, fast_backward_Activity_Actor);
+	ELY_REGISTER_FUNCTION(CALLBACKS, head_left_Activity_Actor);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_head_left_Activity_Actor);
+	ELY_REGISTER_FUNCTION(CALLBACKS, fast_head_left_Activity_Actor);
+	ELY_REGISTER_FUNCTION(CALLBACKS, head_right_Activity_Actor);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_head_right_Activity_Actor);
+	ELY_REGISTER_FUNCTION(CALLBACKS, fast_head_right_Activity_Actor);
+	ELY_REGISTER_FUNCTION(CALLBACKS, up_Activity_Actor);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_up_Activity_Actor);
+	ELY_REGISTER_FUNCTION(CALLBACKS, fast_up_Activity_Actor);
+	ELY_REGISTER_FUNCTION(CALLBACKS, down_Activity_Actor);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_down_Activity_Actor);
+	ELY_REGISTER_FUNCTION(CALLBACKS, fast_down_Activity_Actor);
 }
 void Actor_clbkEnd()
 {
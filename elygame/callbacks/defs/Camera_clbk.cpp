@@ -401,6 +401,49 @@ void stop_hold_lookat_Chaser_Camera(const Event* event, void* data)
 ///Init/end functions: see common_configs.cpp
 void Camera_clbkInit()
 {
+	//register the functions
+	ELY_REGISTER_FUNCTION(CALLBACKS, fast_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_fast_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, forward_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_forward_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, fast_forward_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, backward_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_backward_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, fast_backward_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, strafe_left_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_strafe_left_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, fast_strafe_left_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, strafe_right_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_strafe_right_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, fast_strafe_right_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, head_left_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_head_left_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, fast_head_left_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, head_right_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_head_right_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, fast_head_right_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, pitch_up_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_pitch_up_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, fast_pitch_up_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, pitch_down_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_pitch_down_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, fast_pitch_down_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, up_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_up_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, fast_up_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, down_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_down_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, fast_down_Driver_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, head_left_Chaser_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_head_left_Chaser_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, head_right_Chaser_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_head_right_Chaser_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, pitch_up_Chaser_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_pitch_up_Chaser_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, pitch_down_Chaser_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_pitch_down_Chaser_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, hold_lookat_Chaser_Camera);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_hold_lookat_Chaser_Camera);
 }
 void Camera_clbkEnd()
 {
@@ -124,6 +124,17 @@ void stop_brake_Vehicle_Car(const Event* event, void* data)
 ///Init/end functions: see common_configs.cpp
 void Car_clbkInit()
 {
+	//register the functions
+	ELY_REGISTER_FUNCTION(CALLBACKS, forward_Vehicle_Car);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_forward_Vehicle_Car);
+	ELY_REGISTER_FUNCTION(CALLBACKS, backward_Vehicle_Car);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_backward_Vehicle_Car);
+	ELY_REGISTER_FUNCTION(CALLBACKS, turn_left_Vehicle_Car);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_turn_left_Vehicle_Car);
+	ELY_REGISTER_FUNCTION(CALLBACKS, turn_right_Vehicle_Car);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_turn_right_Vehicle_Car);
+	ELY_REGISTER_FUNCTION(CALLBACKS, brake_Vehicle_Car);
+	ELY_REGISTER_FUNCTION(CALLBACKS, stop_brake_Vehicle_Car);
 }
 void Car_clbkEnd()
 {
@@ -103,6 +103,9 @@ void groundAirPlayer0(const Event * event, void * data)
 ///Init/end functions: see common_configs.cpp
 void Character_clbkInit()
 {
+	//register the functions
+	ELY_REGISTER_FUNCTION(CALLBACKS, activityPlayer0);
+	ELY_REGISTER_FUNCTION(CALLBACKS, groundAirPlayer0);
 }
 void Character_clbkEnd()
 {
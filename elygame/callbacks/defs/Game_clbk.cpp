@@ -117,6 +117,12 @@ void notifyCollisions(const Event* event, void* data)
 ///Init/end functions: see common_configs.cpp
 void Game_clbkInit()
 {
+	//register the functions
+	ELY_REGISTER_FUNCTION(CALLBACKS, carMoveSteady);
+	ELY_REGISTER_FUNCTION(CALLBACKS, characterGroundAir);
+	ELY_REGISTER_FUNCTION(CALLBACKS, handleHits);
+	ELY_REGISTER_FUNCTION(CALLBACKS, carGhostOverlap);
+	ELY_REGISTER_FUNCTION(CALLBACKS, notifyCollisions);
 }
 void Game_clbkEnd()
 {
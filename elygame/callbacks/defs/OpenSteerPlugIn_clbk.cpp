@@ -62,6 +62,8 @@ void steerPluginsToggleDebug(const Event* event, void* data)
 ///Init/end functions: see common_configs.cpp
 void OpenSteerPlugIn_clbkInit()
 {
+	//register the functions
+	ELY_REGISTER_FUNCTION(CALLBACKS, steerPluginsToggleDebug);
 }
 void OpenSteerPlugIn_clbkEnd()
 {
@@ -92,10 +92,10 @@ void add_crowd_agent_NavMesh_RecastNavMesh(const Event* event, void* data)
 	//set CrowdAgent add_to_plugin
 	compParams["CrowdAgent"].erase("add_to_navmesh");
 	compParams["CrowdAgent"].insert(std::make_pair("add_to_navmesh", navMeshObjectId));
-	//create actually the clone
+	//create actually the clone (restorable by a Snapshot)
 	ObjectTemplateManager::GetSingletonPtr()->
 	createObject(toBeClonedObject->objectTmpl()->objectType(), ObjectId(),
-			objParams, compParams, false);
+			objParams, compParams, true);
 }
 
 void remove_crowd_agent_NavMesh_RecastNavMesh(const Event* event, void* data)
@@ -145,6 +145,10 @@ void navMeshesToggleDebug(const Event* event, void* data)
 ///Init/end functions: see common_configs.cpp
 void RecastNavMesh_clbkInit()
 {
+	//register the functions
+	ELY_REGISTER_FUNCTION(CALLBACKS, add_crowd_agent_NavMesh_RecastNavMesh);
+	ELY_REGISTER_FUNCTION(CALLBACKS, remove_crowd_agent_NavMesh_RecastNavMesh);
+	ELY_REGISTER_FUNCTION(CALLBACKS, navMeshesToggleDebug);
 }
 void RecastNavMesh_clbkEnd()
 {
@@ -24,6 +24,10 @@
 #include "elygame.h"
 #include "elygame_ini.h"
 #include <pandaFramework.h>
+#include <configVariableBool.h>
+#include <configVariableDouble.h>
+#include <configVariableInt.h>
+#include <configVariableString.h>
 
 using namespace ely;
 
@@ -64,6 +68,85 @@ int main(int argc, char **argv)
 	ELY_INITIALIZATIONS_LA);
 	GameManager::GetSingletonPtr()->setDataInfo(GameManager::INSTANCEUPDATES,
 	ELY_INSTANCEUPDATES_LA);
+	// Game function libraries: opened once, on first lookup
+	FunctionRegistry& functionRegistry = FunctionRegistry::GetSingleton();
+	functionRegistry.setLibraryPath(FunctionRegistry::CALLBACKS,
+	ELY_CALLBACKS_LA);
+	functionRegistry.setLibraryPath(FunctionRegistry::TRANSITIONS,
+	ELY_TRANSITIONS_LA);
+	functionRegistry.setLibraryPath(FunctionRegistry::INITIALIZATIONS,
+	ELY_INITIALIZATIONS_LA);
+	functionRegistry.setLibraryPath(FunctionRegistry::INSTANCEUPDATES,
+	ELY_INSTANCEUPDATES_LA);
+	// Frame profiler: zones are recorded only when enabled
+	Profiler* profiler = new Profiler();
+	ConfigVariableBool profile("ely-profile", false,
+			"Records the frame profiler zones.");
+	ConfigVariableBool profilePStats("ely-profile-pstats", false,
+			"Drives PStats collectors with the frame profiler zones.");
+	ConfigVariableString profileTrace("ely-profile-trace", "",
+			"Chrome trace file of the last profiled frames (written at exit).");
+	profiler->setEnabled(profile);
+	profiler->setPStatsBridge(profilePStats);
+	std::string traceName = profileTrace.get_value();
+	// Session recording/replay: config variables or command line switches
+	ConfigVariableString recordFile("ely-record", "",
+			"Records the game session into this file.");
+	ConfigVariableString replayFile("ely-replay", "",
+			"Replays the game session from this file (then exits).");
+	std::string recordName = recordFile.get_value();
+	std::string replayName = replayFile.get_value();
+	for (int i = 1; i < argc - 1; ++i)
+	{
+		if (std::string(argv[i]) == std::string("--record"))
+		{
+			recordName = argv[++i];
+		}
+		else if (std::string(argv[i]) == std::string("--replay"))
+		{
+			replayName = argv[++i];
+		}
+	}
+	Replay* replay = NULL;
+	if (not replayName.empty())
+	{
+		// a replay is a benchmark run: profile it
+		replay = new Replay(Replay::REPLAYING, replayName);
+		replay->setExitAtEnd(true);
+		profiler->setEnabled(true);
+		if (traceName.empty())
+		{
+			traceName = replayName + std::string(".trace.json");
+		}
+	}
+	else if (not recordName.empty())
+	{
+		replay = new Replay(Replay::RECORDING, recordName);
+	}
+	// Replication: config variables or command line switches
+	ConfigVariableString replicationMode("ely-replication", "",
+			"Replicates the game world as a \"server\" or a \"client\".");
+	ConfigVariableString replicationHost("ely-replication-host", "localhost",
+			"The replication server host (client).");
+	ConfigVariableInt replicationPort("ely-replication-port", 9099,
+			"The replication server port.");
+	ConfigVariableDouble replicationRadius("ely-replication-radius", 0.0,
+			"The replication relevance radius (server, 0 = all).");
+	std::string replicationName = replicationMode.get_value();
+	std::string replicationHostName = replicationHost.get_value();
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::string(argv[i]) == std::string("--server"))
+		{
+			replicationName = "server";
+		}
+		else if ((std::string(argv[i]) == std::string("--client"))
+				and (i < argc - 1))
+		{
+			replicationName = "client";
+			replicationHostName = argv[++i];
+		}
+	}
 	// Other managers (depending on GameManager)
 #ifdef ELY_THREAD
 	unsigned long int completedMask;
@@ -152,6 +235,44 @@ int main(int argc, char **argv)
 	//Behavior
 	GameBehaviorManager* gameBehaviorMgr = new GameBehaviorManager(10);
 #endif
+	// Typed event bus: dispatched after the managers' updates
+	EventBus* eventBus = new EventBus(20);
+	// Area of interest grid: refreshed before the event bus dispatch
+	InterestGrid* interestGrid = NULL;
+	ConfigVariableDouble interestGridCell("ely-interest-grid-cell", 0.0,
+			"Area of interest grid cell size (0 = no grid).");
+	if (interestGridCell > 0.0)
+	{
+		interestGrid = new InterestGrid(interestGridCell, 4096, 15);
+	}
+	// Spatial index (loose octree) of the created objects: updated before the
+	// event bus dispatch
+	SpatialIndex* spatialIndex = NULL;
+	ConfigVariableDouble spatialIndexSize("ely-spatial-index-size", 0.0,
+			"Spatial index region half width (0 = no index).");
+	if (spatialIndexSize > 0.0)
+	{
+		ConfigVariableInt spatialIndexDepth("ely-spatial-index-depth", 6,
+				"Spatial index maximum octree depth.");
+		spatialIndex = new SpatialIndex(LPoint3f::zero(), spatialIndexSize,
+				spatialIndexDepth, 16);
+	}
+	// Deterministic (lockstep) mode: the tick ends after the event bus
+	Lockstep* lockstep = NULL;
+	ConfigVariableBool lockstepMode("ely-lockstep", false,
+			"Runs the simulation deterministically with a fixed tick.");
+	if (lockstepMode)
+	{
+		ConfigVariableDouble lockstepTick("ely-lockstep-tick", 60.0,
+				"Lockstep tick rate (Hz).");
+		ConfigVariableInt lockstepSeed("ely-lockstep-seed", 0,
+				"Lockstep random seed.");
+		ConfigVariableInt lockstepChecksums("ely-lockstep-checksums", 256,
+				"Lockstep recent ticks' state checksums kept (0 = none).");
+		lockstep = new Lockstep(
+				lockstepTick > 0.0 ? 1.0 / lockstepTick : 1.0 / 60.0,
+				lockstepSeed, lockstepChecksums, 25);
+	}
 
 #if defined (ELY_THREAD) && defined (ELY_DEBUG)
 	//threading
@@ -200,9 +321,81 @@ int main(int argc, char **argv)
 	// Set the game up
 	gameMgr->gameSetup();
 
+	// Record/replay the session from now on (the game world is excluded)
+	if (replay and (not replay->start()))
+	{
+		std::cerr << "Ely::main: cannot open the session file" << std::endl;
+		delete replay;
+		replay = NULL;
+	}
+
+	// Replicate the game world (server) or get it replicated (client)
+	Replication* replication = NULL;
+	if ((replicationName == std::string("server"))
+			or (replicationName == std::string("client")))
+	{
+		Replication::Settings settings;
+		settings.mServerHost = replicationHostName;
+		settings.mPort = replicationPort;
+		settings.mRelevanceRadius = replicationRadius;
+		replication = new Replication(
+				replicationName == std::string("server") ?
+						Replication::SERVER : Replication::CLIENT, settings);
+		if (not replication->start())
+		{
+			std::cerr << "Ely::main: cannot start the replication" << std::endl;
+			delete replication;
+			replication = NULL;
+		}
+		else if (replicationName == std::string("server"))
+		{
+			std::list<SMARTPTR(Object)> objects =
+					objectTmplMgr->getCreatedObjects();
+			std::list<SMARTPTR(Object)>::const_iterator iter;
+			for (iter = objects.begin(); iter != objects.end(); ++iter)
+			{
+				replication->addObject((*iter)->objectId());
+			}
+		}
+	}
+
 	// Do the main loop
 	gameMgr->main_loop();
 
+	// Session summary
+	if (replay)
+	{
+		Replay::ReplayStats stats = replay->getStats();
+		std::cout << "Ely::main: session "
+				<< (replay->getMode() == Replay::RECORDING ?
+						"recorded" : "replayed") << ": " << stats.mFrames
+				<< " frames in " << stats.mTotalTime << " s (frame time min/mean/max: "
+				<< stats.mMinFrameTime << "/"
+				<< (stats.mFrames > 0 ? stats.mTotalTime / stats.mFrames : 0.0)
+				<< "/" << stats.mMaxFrameTime << " s)" << std::endl;
+		delete replay;
+	}
+
+	// Replication summary
+	if (replication)
+	{
+		Replication::ReplicationStats stats = replication->getStats();
+		std::cout << "Ely::main: replication: " << stats.mBytesSent
+				<< " bytes sent, " << stats.mBytesReceived << " received, "
+				<< stats.mPacketsDropped << " packets dropped" << std::endl;
+		std::vector<Replication::ClientStats> clientStats =
+				replication->getClientStats();
+		for (unsigned int c = 0; c < clientStats.size(); ++c)
+		{
+			std::cout << "\tclient " << clientStats[c].mAddress << ": "
+					<< clientStats[c].mSnapshots << " snapshots, "
+					<< clientStats[c].mBytesSent << " bytes ("
+					<< clientStats[c].mBytesPerSecond << " bytes/s)"
+					<< std::endl;
+		}
+		delete replication;
+	}
+
 	// Clean the game up
 	gameMgr->gameCleanup();
 
@@ -216,6 +409,10 @@ int main(int argc, char **argv)
 	}
 	AsyncTaskManager::get_global_ptr()->remove(fireManagersTask);
 #endif
+	delete lockstep;
+	delete spatialIndex;
+	delete interestGrid;
+	delete eventBus;
 	delete gameBehaviorMgr;
 	delete gameAudioMgr;
 	delete gamePhysicsMgr;
@@ -223,9 +420,16 @@ int main(int argc, char **argv)
 	delete gameControlMgr;
 	delete gameAIMgr;
 	delete gameGUIMgr;
+	if (not traceName.empty())
+	{
+		profiler->writeChromeTrace(traceName);
+	}
+	delete profiler;
 	delete gameMgr;
 	delete objectTmplMgr;
 	delete componentTmplMgr;
+	// Close the game function libraries
+	FunctionRegistry::GetSingleton().closeLibraries();
 	// Libtool: shut down libltdl and close all modules.
 	if (lt_dlexit() != 0)
 	{
@@ -34,7 +34,15 @@
 #include "Game/GamePhysicsManager.h"
 #include "Game/GameSceneManager.h"
 #include "ObjectModel/ComponentTemplateManager.h"
+#include "ObjectModel/FunctionRegistry.h"
 #include "ObjectModel/ObjectTemplateManager.h"
+#include "Support/EventBus.h"
+#include "Support/InterestGrid.h"
+#include "Support/Lockstep.h"
+#include "Support/Profiler.h"
+#include "Support/Replay.h"
+#include "Support/Replication.h"
+#include "Support/SpatialIndex.h"
 
 #ifdef ELY_THREAD
 ///Define a manager for a given subsystem:
@@ -21,16 +21,9 @@
  * \author consultit
  */
 
-#include "Support/MemoryPool/MemoryPool.h"
-#include "Support/MemoryPool/MemoryMacros.h"
-
-//Set the static objects used to initialize/finalize memory pools
-//that some objects and/or components would use
-#include "CommonComponents/Default.h"
-
-namespace ely
-{
-GCC_MEMORYPOOL_AUTOINIT(Default, 16);
-
-}  // namespace ely
+#include "Support/MemoryPool/ConcurrentMemoryPool.h"
 
+//Components, Objects and OpenSteer vehicles are allocated through the
+//thread-safe size class pools (see MemoryMacros.h): they need no setup.
+//Auto trimming is left off: the blocks no longer used are given back
+//explicitly (see GameManager::gameCleanup()).
@@ -33,6 +33,9 @@ void initializationsEnd()
 {
 	PRINT_DEBUG("Executing initializationsEnd");
 	callAllEnds();
+	//the registered functions are no more valid
+	FunctionRegistry::GetSingleton().unregisterFunctions(
+			FunctionRegistry::INITIALIZATIONS);
 }
 
 ///Insert declarations of all init/end functions
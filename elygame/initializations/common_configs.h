@@ -25,6 +25,7 @@
 #define COMMON_CONFIGS_H_
 
 #include "ObjectModel/Object.h"
+#include "ObjectModel/FunctionRegistry.h"
 
 using namespace ely;
 
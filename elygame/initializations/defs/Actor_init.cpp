@@ -107,6 +107,8 @@ PandaFramework* pandaFramework, WindowFramework* windowFramework)
 
 void Actor_initInit()
 {
+	//register the functions
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, Actor1_initialization);
 }
 
 void Actor_initEnd()
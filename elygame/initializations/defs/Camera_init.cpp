@@ -680,10 +680,13 @@ inline void setCameraType(const CameraType& newType,
 			RETURN_ON_COND(
 					DCAST(Driver, camera->getComponent( ComponentFamilyType("Control")))->enable() != Driver::Result::OK,
 					)
-			//picker off: add
-			new Picker(camera->objectTmpl()->pandaFramework(),
-					camera->objectTmpl()->windowFramework(), "shift-mouse1",
-					"mouse1-up", pickerCsIspherical, 0.0);
+			//picker off: add (not if headless: no mouse to pick with)
+			if (camera->objectTmpl()->windowFramework())
+			{
+				new Picker(camera->objectTmpl()->pandaFramework(),
+						camera->objectTmpl()->windowFramework(), "shift-mouse1",
+						"mouse1-up", pickerCsIspherical, 0.0);
+			}
 
 			//write text
 			writeText(textNode, "Object Picker Active", 0.05,
@@ -740,6 +743,8 @@ PandaFramework* pandaFramework, WindowFramework* windowFramework)
 
 void Camera_initInit()
 {
+	//register the functions
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, camera_initialization);
 }
 
 void Camera_initEnd()
@@ -53,6 +53,8 @@ PandaFramework* pandaFramework, WindowFramework* windowFramework)
 
 void Character_initInit()
 {
+	//register the functions
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, player0_initialization);
 }
 
 void Character_initEnd()
@@ -24,6 +24,7 @@
 #include "../common_configs.h"
 #include "Game/GamePhysicsManager.h"
 #include "Support/Raycaster.h"
+#include "Support/Replay.h"
 #include "Game_init.h"
 #include "../../elygame.h"
 #include "Game/GameGUIManager.h"
@@ -91,8 +92,11 @@ void rocketEventHandler(const Rocket::Core::String& value,
 void elyPreObjects_initialization(SMARTPTR(Object)object, const ParameterTable& paramTable,
 PandaFramework* pandaFramework, WindowFramework* windowFramework)
 {
-	//create the global ray caster
-	new Raycaster(pandaFramework, windowFramework, GamePhysicsManager::GetSingleton().bulletWorld(), CALLBACKSNUM);
+	//create the global ray caster (not if headless)
+	if (windowFramework)
+	{
+		new Raycaster(pandaFramework, windowFramework, GamePhysicsManager::GetSingleton().bulletWorld(), CALLBACKSNUM);
+	}
 
 	//register the add element function to gui (Rocket) main menu
 	//register the event handler to gui main menu for each event value
@@ -104,6 +108,9 @@ PandaFramework* pandaFramework, WindowFramework* windowFramework)
 void elyPostObjects_initialization(SMARTPTR(Object)object, const ParameterTable& paramTable,
 PandaFramework* pandaFramework, WindowFramework* windowFramework)
 {
+	//no gui if headless
+	RETURN_ON_COND(not windowFramework,)
+
 	///Gui (libRocket)
 	//add show main menu event handler
 	EventHandler::get_global_event_handler()->add_hook("m", &showMainMenu);
@@ -111,10 +118,17 @@ PandaFramework* pandaFramework, WindowFramework* windowFramework)
 	windowFramework->get_graphics_window()->set_close_request_event("close_request_event");
 	EventHandler::get_global_event_handler()->add_hook("close_request_event", &showExitMenu);
 	EventHandler::get_global_event_handler()->add_hook("escape", &showExitMenu);
+	//these are recorded/replayed too
+	Replay::watchEvent("m");
+	Replay::watchEvent("close_request_event");
+	Replay::watchEvent("escape");
 }
 
 void Game_initInit()
 {
+	//register the functions
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, elyPreObjects_initialization);
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, elyPostObjects_initialization);
 }
 
 void Game_initEnd()
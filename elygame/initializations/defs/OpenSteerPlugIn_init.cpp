@@ -948,10 +948,10 @@ void add_vehicle(const Event* event)
 	compParams["SteerVehicle"].insert(
 			std::make_pair("add_to_plugin", steerPlugInObjectId));
 
-	//create actually the clone and...
+	//create actually the clone (restorable by a Snapshot) and...
 	SMARTPTR(Object)clone = ObjectTemplateManager::GetSingletonPtr()->createObject(
 			toBeClonedObject->objectTmpl()->objectType(), ObjectId(), objParams,
-			compParams, false);
+			compParams, true);
 	//...initialize it
 	clone->worldSetup();
 }
@@ -1069,6 +1069,10 @@ void remove_vehicle(const Event* event)
 //render plugins' static drawing
 AsyncTask::DoneStatus drawStaticGeometry(GenericAsyncTask* task, void * data)
 {
+	//nothing to render to if headless
+	RETURN_ON_COND(not GameManager::GetSingletonPtr()->windowFramework(),
+			AsyncTask::DS_done)
+
 	//first render textures on terrain
 	if (drawStaticGeometryInitDone)
 	{
@@ -1553,8 +1557,11 @@ PandaFramework* pandaFramework, WindowFramework* windowFramework)
 	getAbstractPlugIn());
 #ifdef ELY_DEBUG
 	//set windowWidth
-	mapDrivePlugIn->windowWidth =
-	windowFramework->get_graphics_window()->get_properties().get_x_size();
+	if (windowFramework)
+	{
+		mapDrivePlugIn->windowWidth =
+		windowFramework->get_graphics_window()->get_properties().get_x_size();
+	}
 #endif
 	//create the map
 	OpenSteer::PolylineSegmentedPathwaySegmentRadii* pathWay =
@@ -1639,6 +1646,16 @@ PandaFramework* pandaFramework, WindowFramework* windowFramework)
 ///init/end
 void OpenSteerPlugIn_initInit()
 {
+	//register the functions
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, steerPlugInOneTurning1_initialization);
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, steerPlugInPedestrian1_initialization);
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, steerPlugInBoid1_initialization);
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, steerPlugInMultiplePursuit1_initialization);
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, steerPlugInSoccer1_initialization);
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, steerPlugInCtf1_initialization);
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, steerPlugInLST1_initialization);
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, steerPlugInMapDrive1_initialization);
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, steerVehicleToBeCloned_init);
 }
 
 void OpenSteerPlugIn_initEnd()
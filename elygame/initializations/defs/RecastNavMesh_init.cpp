@@ -75,6 +75,8 @@ PandaFramework* pandaFramework, WindowFramework* windowFramework)
 ///init/end
 void RecastNavMesh_initInit()
 {
+	//register the functions
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, course2_initialization);
 }
 
 void RecastNavMesh_initEnd()
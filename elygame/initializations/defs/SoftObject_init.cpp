@@ -128,6 +128,11 @@ PandaFramework* pandaFramework, WindowFramework* windowFramework)
 ///init/end
 void SoftObject_initInit()
 {
+	//register the functions
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, cover1_initialization);
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, softBall1_initialization);
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, softCube1_initialization);
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, softModel1_initialization);
 }
 
 void SoftObject_initEnd()
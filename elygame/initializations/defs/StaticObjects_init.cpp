@@ -96,6 +96,9 @@ PandaFramework* pandaFramework, WindowFramework* windowFramework)
 ///init/end
 void StaticObjects_initInit()
 {
+	//register the functions
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, Terrain1_initialization);
+	ELY_REGISTER_FUNCTION(INITIALIZATIONS, ghost_beachhouse2_initialization);
 }
 
 void StaticObjects_initEnd()
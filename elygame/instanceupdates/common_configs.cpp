@@ -33,6 +33,9 @@ void instanceupdatesEnd()
 {
 	PRINT_DEBUG("Executing instanceupdatesEnd");
 	callAllEnds();
+	//the registered functions are no more valid
+	FunctionRegistry::GetSingleton().unregisterFunctions(
+			FunctionRegistry::INSTANCEUPDATES);
 }
 
 ///Insert declarations of all init/end functions
@@ -25,6 +25,7 @@
 #define INSTANCEUPDATES_CONFIGS_H_
 
 #include "BehaviorComponents/Activity.h"
+#include "ObjectModel/FunctionRegistry.h"
 
 using namespace ely;
 
@@ -45,5 +46,8 @@ extern "C"
 
 ///Common declarations
 typedef void INSTANCEUPDATE(float, Activity&);
+///Optional batch version, named "<INSTANCEUPDATE name>_Batch"
+typedef void INSTANCEBATCHUPDATE(float,
+		const std::vector<SMARTPTR(Activity)>&);
 
 #endif /* INSTANCEUPDATES_CONFIGS_H_ */
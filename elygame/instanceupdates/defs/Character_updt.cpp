@@ -83,6 +83,8 @@ void playerUpdate(float dt, Activity& activity)
 ///Init/end functions: see common_configs.cpp
 void Character_updtInit()
 {
+	//register the functions
+	ELY_REGISTER_FUNCTION(INSTANCEUPDATES, playerUpdate);
 }
 void Character_updtEnd()
 {
@@ -33,6 +33,9 @@ void transitionsEnd()
 {
 	PRINT_DEBUG("Executing transitionsEnd");
 	callAllEnds();
+	//the registered functions are no more valid
+	FunctionRegistry::GetSingleton().unregisterFunctions(
+			FunctionRegistry::TRANSITIONS);
 }
 
 ///Insert declarations of all init/end functions
@@ -25,6 +25,7 @@
 #define COMMON_CONFIGS_H_
 
 #include "BehaviorComponents/Activity.h"
+#include "ObjectModel/FunctionRegistry.h"
 
 using namespace ely;
 
@@ -49,5 +50,11 @@ typedef void EXIT(fsm*, Activity&);
 typedef ValueList FILTER(fsm*, Activity&, const std::string&,
 		const ValueList&);
 typedef void FROMTO(fsm*, Activity&, const ValueList&);
+///Fast FSM declarations (for Activities with "fast_fsm" true)
+typedef void FENTER(afsm*, Activity&, const FSMArgs&);
+typedef void FEXIT(afsm*, Activity&);
+typedef afsm::StateId FFILTER(afsm*, Activity&, afsm::StateId,
+		const FSMArgs&, FSMArgs&);
+typedef void FFROMTO(afsm*, Activity&, const FSMArgs&);
 
 #endif /* COMMON_CONFIGS_H_ */
@@ -188,6 +188,27 @@ void forward_FromTo_strafe_right_Actor(fsm*, Activity& activity,
 ///Init/end functions: see common_configs.cpp
 void Actor_trnsInit()
 {
+	//register the functions
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_forward_Actor);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_forward_Actor);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Filter_forward_Actor);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_backward_Actor);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_backward_Actor);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Filter_backward_Actor);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_strafe_left_Actor);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_strafe_left_Actor);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Filter_strafe_left_Actor);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_strafe_right_Actor);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_strafe_right_Actor);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Filter_strafe_right_Actor);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_up_Actor);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_up_Actor);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Filter_up_Actor);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_down_Actor);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_down_Actor);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Filter_down_Actor);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, forward_FromTo_strafe_left_Actor);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, forward_FromTo_strafe_right_Actor);
 }
 void Actor_trnsEnd()
 {
@@ -988,6 +988,73 @@ void Exit_Sl_Rl_Q_Character(fsm*, Activity& activity)
 ///Init/end functions: see common_configs.cpp
 void Character_trnsInit()
 {
+	//register the functions
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_I_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_I_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_F_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_F_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_B_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_B_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_Sr_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_Sr_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_Sl_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_Sl_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_Rr_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_Rr_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_Rl_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_Rl_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_J_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_J_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_F_Rr_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_F_Rr_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_F_Rl_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_F_Rl_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_F_Rr_Rl_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_F_Rr_Rl_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_Rr_Rl_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_Rr_Rl_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_F_J_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_F_J_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_B_Rr_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_B_Rr_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_B_Rl_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_B_Rl_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_Sr_Rr_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_Sr_Rr_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_Sr_Rl_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_Sr_Rl_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_Sl_Rr_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_Sl_Rr_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_Sl_Rl_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_Sl_Rl_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_F_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_F_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_Sr_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_Sr_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_Sl_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_Sl_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_Rr_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_Rr_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_Rl_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_Rl_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_F_Rr_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_F_Rr_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_F_Rl_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_F_Rl_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_F_Rr_Rl_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_F_Rr_Rl_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_Rr_Rl_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_Rr_Rl_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_F_J_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_F_J_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_Sr_Rr_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_Sr_Rr_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_Sr_Rl_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_Sr_Rl_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_Sl_Rr_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_Sl_Rr_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Enter_Sl_Rl_Q_Character);
+	ELY_REGISTER_FUNCTION(TRANSITIONS, Exit_Sl_Rl_Q_Character);
 }
 void Character_trnsEnd()
 {
@@ -26,6 +26,7 @@
 
 #include "ObjectModel/Component.h"
 #include "ObjectModel/Object.h"
+#include "Support/EventBus.h"
 #include <DetourCrowd.h>
 #include <throw_event.h>
 #include <bulletWorld.h>
@@ -128,6 +129,17 @@ public:
 	 */
 	SMARTPTR(NavMesh) getNavMesh() const;
 
+	/**
+	 * \name Runtime state serialization: the move target and velocity.
+	 *
+	 * Restoring re-adds the CrowdAgent to its NavMesh's crowd (see
+	 * NavMesh::resetCrowdAgent()).
+	 */
+	///@{
+	virtual void write_datagram(BamWriter* manager, Datagram& dg);
+	virtual void fillin(DatagramIterator& scan, BamReader* manager);
+	///@}
+
 	///CrowdAgent thrown events.
 	enum EventThrown
 	{
@@ -194,7 +206,7 @@ private:
 	ThrowEventData mMove, mSteady;
 	///Helper.
 	void doEnableCrowdAgentEvent(EventThrown event, ThrowEventData eventData);
-	void doThrowEvent(ThrowEventData& eventData);
+	void doThrowEvent(ThrowEventData& eventData, EventBus::EventId busId);
 	std::string mThrownEventsParam;
 	///@}
 
@@ -309,23 +321,30 @@ inline void CrowdAgent::enableCrowdAgentEvent(EventThrown event,
 	doEnableCrowdAgentEvent(event, eventData);
 }
 
-inline void CrowdAgent::doThrowEvent(ThrowEventData& eventData)
+inline void CrowdAgent::doThrowEvent(ThrowEventData& eventData,
+		EventBus::EventId busId)
 {
 	if (eventData.mThrown)
 	{
 		eventData.mTimeElapsed += ClockObject::get_global_clock()->get_dt();
 		if (eventData.mTimeElapsed >= eventData.mPeriod)
 		{
-			//enough time is passed: throw the event
-			throw_event(eventData.mEventName, EventParameter(this));
+			//enough time is passed: post the event (and throw it if asked)
+			if (EventBus::postEvent(busId, eventData.mEventName, this))
+			{
+				throw_event(eventData.mEventName, EventParameter(this));
+			}
 			//update elapsed time
 			eventData.mTimeElapsed -= eventData.mPeriod;
 		}
 	}
 	else
 	{
-		//throw the event
-		throw_event(eventData.mEventName, EventParameter(this));
+		//post the event (and throw it if asked)
+		if (EventBus::postEvent(busId, eventData.mEventName, this))
+		{
+			throw_event(eventData.mEventName, EventParameter(this));
+		}
 		eventData.mThrown = true;
 	}
 }
@@ -36,6 +36,7 @@
 #include <DetourTileCache.h>
 #include <nodePath.h>
 #include <conditionVar.h>
+#include <fstream>
 
 namespace ely
 {
@@ -84,10 +85,18 @@ class NavMeshTemplate;
  * | *area_flags_cost*				|multiple| - | each one specified as "area_type@flag1[:flag2...:flagN]@cost" note: flags are or-ed
  * | *crowd_include_flags*			|single| - | specified as "flag1[:flag2...:flagN]" note: flags are or-ed
  * | *crowd_exclude_flags*			|single| - | specified as "flag1[:flag2...:flagN]" note: flags are or-ed
+ * | *max_crowd_agents*			|single| 128 | max agents of each crowd
+ * | *crowd_shards*				|single| 1 | crowds partitioning the navmesh (in strips)
+ * | *crowd_threads*				|single| 0 | threads updating the crowds (0 = update thread)
+ * | *stats*						|single| *false* | -
+ * | *stats_file*					|single| - | CSV file (JSON lines if ending with ".json")
+ * | *stats_interval*				|single| 60 | frames between two stats_file records
  * | *convex_volume*				|multiple| - | each one specified as "x1,y1,z1[:x2,y2,z2...:xN,yN,zN]@area_type"
  * | *offmesh_connection*			|multiple| - | each one specified as "xB,yB,zB:xE,yE,zE@bidirectional" with bidirectional=true,false
  *
  * \note parts inside [] are optional.\n
+ * \note with crowd_shards > 1 agents are simulated by a crowd per shard
+ * (\see CrowdShards) and the crowd debug draw is not available.
  */
 class NavMesh: public Component
 {
@@ -174,6 +183,52 @@ public:
 	LVecBase3f getRecastBoundsMax() const;
 	///@}
 
+	/**
+	 * \brief Counters of the last update (available in release builds).
+	 *
+	 * They are collected only when enabled, otherwise update() has no
+	 * additional cost.
+	 */
+	struct Stats
+	{
+		///Frames updated while collecting.
+		unsigned long int mFrame;
+		///Whole update time (crowd, tile cache...) in microseconds.
+		int mUpdateTime;
+		///Crowd update time in microseconds.
+		int mCrowdUpdateTime;
+		///Active crowd agents.
+		int mActiveAgents;
+		///Velocity samples taken by obstacle avoidance.
+		int mVelocitySamples;
+		///Agents waiting for a path (path request queue).
+		int mPathQueueLength;
+		///Nodes visited by the last pathfinding iterations.
+		int mPathNodes;
+		///Tiles rebuilt by the last update and since collecting.
+		int mTileRebuilds;
+		unsigned long int mTotalTileRebuilds;
+		///Obstacles waiting to be added or removed.
+		int mObstacleQueueLength;
+	};
+	/**
+	 * \name Stats related methods.
+	 */
+	///@{
+	Result enableStats(bool enable);
+	bool isStatsEnabled() const;
+	Stats getStats() const;
+	/**
+	 * \brief Periodically dumps the Stats (and enables their collection).
+	 * @param fileName The file: CSV, or JSON lines if ending with ".json";
+	 * an empty name stops dumping.
+	 * @param interval Frames between two records.
+	 * @return Result::OK on success, Result::ERROR if the file cannot be
+	 * opened.
+	 */
+	Result dumpStats(const std::string& fileName, int interval = 60);
+	///@}
+
 	/**
 	 * \brief Adds a CrowdAgent component to the dtCrowd handling
 	 * mechanism.
@@ -204,6 +259,19 @@ public:
 			const LVector3f& moveVelocity);
 	///@}
 
+	/**
+	 * \brief Resets a CrowdAgent with a restored state.
+	 *
+	 * The CrowdAgent is re-added to the dtCrowd at the current position of
+	 * its owner object, with the given move target and velocity.
+	 * @param crowdAgent The CrowdAgent to reset.
+	 * @param moveTarget The move target.
+	 * @param moveVelocity The move velocity.
+	 * @return Result::OK on successful reset, various error conditions otherwise.
+	 */
+	Result resetCrowdAgent(SMARTPTR(CrowdAgent)crowdAgent,
+			const LPoint3f& moveTarget, const LVector3f& moveVelocity);
+
 	/**
 	 * \brief Sets up NavMesh to be ready for CrowdAgents handling.
 	 *
@@ -269,6 +337,24 @@ private:
 	///Crowd include & exclude flags settings.
 	std::string mCrowdIncludeFlagsParam, mCrowdExcludeFlagsParam;
 	int mCrowdIncludeFlags, mCrowdExcludeFlags;
+	///Crowd capacity, shards and threads.
+	int mMaxCrowdAgents, mCrowdShards, mCrowdThreads;
+	///Stats.
+	///@{
+	bool mStatsEnabled;
+	Stats mStats;
+	///Tiles' salt sum (incremented when a tile is removed) of mStatsNavMesh.
+	unsigned long int mStatsSaltSum;
+	const dtNavMesh* mStatsNavMesh;
+	std::string mStatsFileParam;
+	std::ofstream mStatsFile;
+	bool mStatsJSON;
+	int mStatsInterval;
+	void doResetStats();
+	void doUpdateStats(CrowdToolState* crowdState, int updateTime);
+	void doAddCrowdStats(const dtCrowd* crowd);
+	void doWriteStats();
+	///@}
 	///Convex volumes.
 	std::list<std::string> mConvexVolumesParam;
 	std::list<PointListArea> mConvexVolumes;
@@ -428,6 +514,18 @@ inline void NavMesh::reset()
 	mCrowdIncludeFlagsParam.clear();
 	mCrowdExcludeFlagsParam.clear();
 	mCrowdIncludeFlags = mCrowdExcludeFlags = 0;
+	mMaxCrowdAgents = CrowdToolState::DEFAULT_MAX_AGENTS;
+	mCrowdShards = 1;
+	mCrowdThreads = 0;
+	mStatsEnabled = false;
+	doResetStats();
+	mStatsFileParam.clear();
+	if (mStatsFile.is_open())
+	{
+		mStatsFile.close();
+	}
+	mStatsJSON = false;
+	mStatsInterval = 60;
 	mConvexVolumesParam.clear();
 	mConvexVolumes.clear();
 	mOffMeshConnectionsParam.clear();
@@ -653,6 +751,22 @@ inline LVecBase3f NavMesh::getRecastBoundsMax() const
 			RecastToLVecBase3f(mGeom->getMeshBoundsMax()) : LVecBase3f::zero());
 }
 
+inline bool NavMesh::isStatsEnabled() const
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	return mStatsEnabled;
+}
+
+inline NavMesh::Stats NavMesh::getStats() const
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	return mStats;
+}
+
 inline NavMeshType& NavMesh::getNavMeshType()
 {
 	return *mNavMeshType;
@@ -25,6 +25,7 @@
 
 #include "ObjectModel/Component.h"
 #include "ObjectModel/Object.h"
+#include "Support/EventBus.h"
 #include "Support/OpenSteerLocal/common.h"
 #include <bulletWorld.h>
 #include <bulletClosestHitRayResult.h>
@@ -209,7 +210,7 @@ private:
 	mAvoidCloseNeighbor, mAvoidNeighbor;
 	///Helper.
 	void doEnableSteerVehicleEvent(EventThrown event, ThrowEventData eventData);
-	void doThrowEvent(ThrowEventData& eventData);
+	void doThrowEvent(ThrowEventData& eventData, EventBus::EventId busId);
 	void doHandleSteerLibraryEvent(ThrowEventData& eventData, bool callbackCalled);
 	std::string mThrownEventsParam;
 	///@}
@@ -294,7 +295,8 @@ inline void SteerVehicle::doPathFollowing(const OpenSteer::Vec3& future,
 	//handle Path Following event
 	if (mPathFollowing.mEnable)
 	{
-		doThrowEvent(mPathFollowing);
+		doThrowEvent(mPathFollowing,
+				EventBus::STEERVEHICLE_PATHFOLLOWING_EVENT);
 		//set the flag
 		mPFCallbackCalled = true;
 	}
@@ -305,7 +307,8 @@ inline void SteerVehicle::doAvoidObstacle(const float minDistanceToCollision)
 	//handle Avoid Obstacle event
 	if (mAvoidObstacle.mEnable)
 	{
-		doThrowEvent(mAvoidObstacle);
+		doThrowEvent(mAvoidObstacle,
+				EventBus::STEERVEHICLE_AVOIDOBSTACLE_EVENT);
 		//set the flag
 		mAOCallbackCalled = true;
 	}
@@ -317,7 +320,8 @@ inline void SteerVehicle::doAvoidCloseNeighbor(const OpenSteer::AbstractVehicle&
 	//handle Avoid Close Neighbor event
 	if (mAvoidCloseNeighbor.mEnable)
 	{
-		doThrowEvent(mAvoidCloseNeighbor);
+		doThrowEvent(mAvoidCloseNeighbor,
+				EventBus::STEERVEHICLE_AVOIDCLOSENEIGHBOR_EVENT);
 		//set the flag
 		mACNCallbackCalled = true;
 	}
@@ -330,29 +334,37 @@ inline void SteerVehicle::doAvoidNeighbor(const OpenSteer::AbstractVehicle& thre
 	//handle Avoid Neighbor event
 	if (mAvoidNeighbor.mEnable)
 	{
-		doThrowEvent(mAvoidNeighbor);
+		doThrowEvent(mAvoidNeighbor,
+				EventBus::STEERVEHICLE_AVOIDNEIGHBOR_EVENT);
 		//set the flag
 		mANCallbackCalled = true;
 	}
 }
 
-inline void SteerVehicle::doThrowEvent(ThrowEventData& eventData)
+inline void SteerVehicle::doThrowEvent(ThrowEventData& eventData,
+		EventBus::EventId busId)
 {
 	if (eventData.mThrown)
 	{
 		eventData.mTimeElapsed += ClockObject::get_global_clock()->get_dt();
 		if (eventData.mTimeElapsed >= eventData.mPeriod)
 		{
-			//enough time is passed: throw the event
-			throw_event(eventData.mEventName, EventParameter(this));
+			//enough time is passed: post the event (and throw it if asked)
+			if (EventBus::postEvent(busId, eventData.mEventName, this))
+			{
+				throw_event(eventData.mEventName, EventParameter(this));
+			}
 			//update elapsed time
 			eventData.mTimeElapsed -= eventData.mPeriod;
 		}
 	}
 	else
 	{
-		//throw the event
-		throw_event(eventData.mEventName, EventParameter(this));
+		//post the event (and throw it if asked)
+		if (EventBus::postEvent(busId, eventData.mEventName, this))
+		{
+			throw_event(eventData.mEventName, EventParameter(this));
+		}
 		eventData.mThrown = true;
 	}
 }
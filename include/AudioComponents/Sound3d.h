@@ -53,6 +53,16 @@ class Sound3dTemplate;
  * ------|------|---------|-----
  * | *scene_root* 			|single| *render* | -
  * | *sound_files* 			|multiple| - | each one specified as "sound_name1@sound_file1[:sound_name2@sound_file2:...:sound_nameN@sound_fileN]"
+ * | *priority* 			|single| 1.0 | -
+ * | *audible_distance* 	|single| 0.0 | <=0 means always audible
+ *
+ * Sounds are got from (and released to) the GameAudioManager's sound
+ * bank, so sound files are shared by all components.\n
+ * Every sound is a voice of the GameAudioManager (with this component's
+ * *priority* and *audible_distance*): its 3d attributes are applied only
+ * while it is real, and positions are gathered only while this component
+ * has active voices. A sound that may be virtual should be stopped with
+ * stopSound().
  *
  * \note parts inside [] are optional.\n
  */
@@ -101,6 +111,14 @@ public:
 	 */
 	Result removeSound(const std::string& soundName);
 
+	/**
+	 * \brief Stops a sound, both if it is real or virtual.
+	 *
+	 * @param soundName The sound name.
+	 * @return True if successful, false otherwise.
+	 */
+	Result stopSound(const std::string& soundName);
+
 	/**
 	 * \name Sets/gets Sound Min Distance.
 	 * \brief Controls the distance (in units) that these sounds begin
@@ -183,6 +201,20 @@ private:
 	LPoint3f mPosition;
 	///@}
 
+	/**
+	 * \name Voices.
+	 */
+	///@{
+	float mPriority, mAudibleDistance;
+	///Voice handles by sound name.
+	typedef std::map<std::string, int> VoiceTable;
+	VoiceTable mVoices;
+	///Set if there were active voices at the last update.
+	bool mWasActive;
+	void doSetSound(const std::string& soundName, SMARTPTR(AudioSound) sound);
+	void doRemoveSound(const std::string& soundName);
+	///@}
+
 	/**
 	 * \brief Actually sets position/velocity for static objects.
 	 */
@@ -226,6 +258,10 @@ inline void Sound3d::reset()
 	mMinDist = FLT_MIN;
 	mMaxDist = FLT_MAX;
 	mPosition = LPoint3f::zero();
+	mPriority = 1.0;
+	mAudibleDistance = 0.0;
+	mVoices.clear();
+	mWasActive = false;
 }
 
 inline float Sound3d::getMinDistance()
@@ -26,11 +26,17 @@
 
 #include <boost/bind.hpp>
 #include "Support/FSM.h"
+#include "Support/FastFSM.h"
+#include "Support/TickScheduler.h"
 #include "ObjectModel/Component.h"
 
 namespace ely
 {
 class ActivityTemplate;
+class Activity;
+
+///The fast FSM driven by an Activity.
+typedef FastFSM<Activity> afsm;
 
 /**
  * \brief Component representing the activity of an object.
@@ -40,7 +46,14 @@ class ActivityTemplate;
  * specify transitions from state to state upon event (types) reception.\n
  * Moreover it gives an object instance the chance to do custom update through a
  * function loaded at runtime from a dynamic linked library
- * (\see GameManager::GameDataInfo::INSTANCEUPDATES).
+ * (\see GameManager::GameDataInfo::INSTANCEUPDATES).\n
+ * Instance updates are batched by GameBehaviorManager: Activities are
+ * grouped by instance update function and current state, and the
+ * Activities of a group are updated together once every "tick period" of
+ * that state (*tick_periods*, or *tick_period* for unlisted states; 0 means
+ * every frame), with the time elapsed since the group's last update.
+ * If the library defines also a "<instance_update>_Batch" function, it is
+ * called once per group with all the group's Activities.
  * .
  * All objects of the same type share the same activity component's states.\n
  * A state transition can be request by delegating its embedded FSM
@@ -80,6 +93,11 @@ class ActivityTemplate;
  * the type of this event, ask the transition table for the next state to go.\n
  * Transition table elements, besides for states and event types, are defined
  * on a "per ObjectTemplate (i.e. Object type)" basis.\n
+ * If *fast_fsm* is true, states and transition functions are added to an
+ * embedded FastFSM (i.e. afsm, see getFastFSM()) instead, and the
+ * transition functions loaded must have the FastFSM signatures (these
+ * don't allocate on transitions). Requests posted to the afsm by other
+ * threads are performed at this component's update.\n
  *
  * > **XML Param(s)**:
  * param | type | default | note
@@ -90,6 +108,9 @@ class ActivityTemplate;
  * | *from_to_transition*	|multiple| - | each one specified as "state11@state21[:state12@state22:...:state1N@state2N]$fromToName" into Object definition
  * | *transition_table*		|multiple| - | each one specified as "current_state1,event_type1@next_state1[:current_state2,event_type2@next_state2:...:current_stateN,event_typeN@next_stateN]" into ObjectTemplate definition
  * | *instance_update* 		|single| - | -
+ * | *fast_fsm* 			|single| *false* | -
+ * | *tick_period* 			|single| 0.0 | seconds
+ * | *tick_periods* 		|multiple| - | each one specified as "state1@period1[:state2@period2:...:stateN@periodN]"
  *
  * \note in "states_transition" and "from_to_transition" any of
  * enterName, exitName, filterName, fromToName could be empty (meaning
@@ -102,6 +123,7 @@ class Activity: public Component
 {
 protected:
 	friend class ActivityTemplate;
+	friend class GameBehaviorManager;
 
 	Activity(SMARTPTR(ActivityTemplate)tmpl);
 	virtual void reset();
@@ -120,6 +142,29 @@ public:
 	///@{
 	fsm& getFSM();
 	operator fsm&();
+	afsm& getFastFSM();
+	bool isFastFSM() const;
+	///@}
+
+	/**
+	 * \name Current (or next) state getter and forced setter, by key.
+	 *
+	 * Forcing calls the exit/enter functions, only if the state differs.
+	 */
+	///@{
+	std::string getCurrentState();
+	void forceState(const std::string& state);
+	///@}
+
+	/**
+	 * \name Runtime state serialization: the current (or next) state.
+	 *
+	 * Restoring forces a transition to the saved state (if different), so
+	 * its exit/enter functions are called.
+	 */
+	///@{
+	virtual void write_datagram(BamWriter* manager, Datagram& dg);
+	virtual void fillin(DatagramIterator& scan, BamReader* manager);
 	///@}
 
 	/**
@@ -142,9 +187,28 @@ public:
 	operator TransitionTable&();
 	///@}
 
+	/**
+	 * \name Instance update functions' types.
+	 */
+	///@{
+	typedef void* (*PINSTANCEUPDATE)(float dt, Activity& activity);
+	typedef void (*PINSTANCEBATCHUPDATE)(float dt,
+			const std::vector<SMARTPTR(Activity)>& activities);
+	///@}
+
+	/**
+	 * \brief Returns the tick period of a state.
+	 * @param state The state.
+	 * @return The tick period (seconds).
+	 */
+	float getTickPeriod(const std::string& state) const;
+
 private:
 	///The underlying FSM (read-only after creation & before destruction).
 	fsm mFSM;
+	///The underlying fast FSM (used if mUseFastFSM).
+	afsm mFastFSM;
+	bool mUseFastFSM;
 	//Transition functions library management.
 	///State transitions.
 	std::list<std::string> mStateTransitionListParam;
@@ -172,10 +236,9 @@ private:
 	void doSetupFSMData();
 	///@}
 	/**
-	 * \name Handles, typedefs, for managing library of transition functions.
+	 * \name Typedefs of transition functions.
 	 */
 	///@{
-	lt_dlhandle mTransitionLib;
 	typedef void (*PENTER)(fsm*, Activity&, const ValueList&);
 	typedef void (*PEXIT)(fsm*, Activity&);
 	typedef ValueList (*PFILTER)(fsm*, Activity&, const std::string&,
@@ -200,15 +263,9 @@ private:
 	///@}
 
 	//Update management data types, variables and functions.
-	/**
-	 * \name Handles, typedefs, for managing library of instances' update functions.
-	 */
-	///@{
-	lt_dlhandle mInstanceUpdateLib;
-	typedef void* (*PINSTANCEUPDATE)(float dt, Activity& activity);
-	///@}
-	///Instance update function.
+	///Instance update function (and its batch version, if any).
 	PINSTANCEUPDATE mInstanceUpdate;
+	PINSTANCEBATCHUPDATE mInstanceBatchUpdate;
 	///Instance update function name.
 	std::string mInstanceUpdateName;
 	/**
@@ -219,6 +276,29 @@ private:
 	void doUnloadInstanceUpdate();
 	///@}
 
+	/**
+	 * \name Batched update scheduling data (managed by GameBehaviorManager).
+	 */
+	///@{
+	float mTickPeriod;
+	std::list<std::string> mTickPeriodListParam;
+	std::map<std::string, float> mTickPeriods;
+	///State by the last check.
+	std::string mScheduleState;
+	int mScheduleStateId;
+	///FSM transitions by the last check (the state is compared only if
+	///they changed) and if a check was done at all.
+	unsigned int mScheduleTransitions;
+	bool mScheduleChecked;
+	///Group, slot and time elapsed in the behavior manager's scheduler.
+	TickSchedule mSchedule;
+	template<typename MEMBER, typename KEY> friend class TickScheduler;
+	///Returns true (and the state) if the state changed since last check.
+	bool doCheckScheduleState(std::string& state);
+	///Forces the state check.
+	void doResetScheduleState();
+	///@}
+
 	///TypedObject semantics: hardcoded
 public:
 	static TypeHandle get_class_type()
@@ -250,11 +330,19 @@ private:
 inline void Activity::reset()
 {
 	mFSM.cleanup();
+	mFastFSM.cleanup();
 	mStateTransitionListParam.clear();
 	mFromToTransitionListParam.clear();
 	mTransitionTable.clear();
 }
 
+inline void Activity::doResetScheduleState()
+{
+	mScheduleStateId = afsm::Null;
+	mScheduleState.clear();
+	mScheduleChecked = false;
+}
+
 inline fsm& Activity::getFSM()
 {
 	return mFSM;
@@ -265,6 +353,16 @@ inline Activity::operator fsm&()
 	return mFSM;
 }
 
+inline afsm& Activity::getFastFSM()
+{
+	return mFastFSM;
+}
+
+inline bool Activity::isFastFSM() const
+{
+	return mUseFastFSM;
+}
+
 inline Activity::TransitionTable& Activity::getTransitionTable()
 {
 	return mTransitionTable;
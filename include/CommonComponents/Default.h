@@ -25,8 +25,6 @@
 #define DEFAULT_H_
 
 #include "ObjectModel/Component.h"
-#include "Support/MemoryPool/MemoryPool.h"
-#include "Support/MemoryPool/MemoryMacros.h"
 
 namespace ely
 {
@@ -86,9 +84,6 @@ public:
 
 private:
 	static TypeHandle _type_handle;
-
-	///MemoryPool semantics: hardcoded
-	GCC_MEMORYPOOL_DECLARATION(0)
 };
 
 ///inline definitions
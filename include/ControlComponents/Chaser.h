@@ -25,6 +25,7 @@
 #define CHASER_H_
 
 #include <nodePath.h>
+#include <bulletShape.h>
 #include <cfloat>
 #include "ObjectModel/Component.h"
 #include "ObjectModel/Object.h"
@@ -64,6 +65,25 @@ class ChaserTemplate;
  * | *sens_x*  					|single| 0.2 | -
  * | *sens_y*  					|single| 0.2 | -
  * | *inverted_rotation*		|single| *false* | -
+ * | *occlusion_check*			|single| *true* | -
+ * | *sweep_radius*				|single| 0.5 | -
+ * | *sweep_mask*				|single| *all_on* | -
+ * | *cache_lifetime*			|single| 0.1 | in seconds
+ * | *cache_tolerance*			|single| 0.25 | -
+ * | *terrain_object*			|single| - | -
+ * | *height_cell_size*			|single| 2.0 | -
+ *
+ * The chaser is kept above the ground and, if *occlusion_check* is true,
+ * in line of sight with the chased object: a sphere (of *sweep_radius*)
+ * is swept from the look at point to the desired chaser position and the
+ * chaser is moved in front of the first obstacle found. Sweep results are
+ * reused while both end points move less than *cache_tolerance* and are
+ * not older than *cache_lifetime*.\n
+ * Ground height is read directly from the Terrain component of the
+ * *terrain_object* (if any), otherwise it is computed by a bounded
+ * downward ray whose result is cached for a coarse cell (of
+ * *height_cell_size*) for *cache_lifetime* seconds.\n
+ * Bullet is queried with the GamePhysicsManager mutex held.
  *
  * \note parts inside [] are optional.\n
  */
@@ -162,6 +182,47 @@ public:
 	void setChasedObject(const ObjectId& objectId);
 	///@}
 
+	/**
+	 * \brief Gets the distance along a ray at which it leaves a sphere: the
+	 * occlusion sweep starts there, outside the chased object.
+	 * @param from The ray origin.
+	 * @param dir The ray (normalized) direction.
+	 * @param center The sphere center.
+	 * @param radius The sphere radius.
+	 * @return The distance (0 if the ray misses the sphere or leaves it
+	 * behind the origin).
+	 */
+	static float getSphereExit(const LPoint3f& from, const LVector3f& dir,
+			const LPoint3f& center, float radius);
+
+	/**
+	 * \brief Ground height cache: the last heights found by coarse cell
+	 * (wrt world) under a given terrain, the oldest replaced first.
+	 */
+	class HeightCache
+	{
+	public:
+		HeightCache();
+		///Forgets all heights (e.g. the terrain was swapped).
+		void invalidate();
+		bool lookup(int cellX, int cellY, int cellZ, unsigned int terrain,
+				double now, double lifetime, float& height) const;
+		void store(int cellX, int cellY, int cellZ, unsigned int terrain,
+				double now, float height);
+		static const int SIZE = 8;
+	private:
+		struct Entry
+		{
+			bool mValid;
+			int mCellX, mCellY, mCellZ;
+			unsigned int mTerrain;
+			float mHeight;
+			double mTime;
+		};
+		Entry mEntries[SIZE];
+		int mNext;
+	};
+
 private:
 	///The chased object's node path.
 	NodePath mChasedNodePath;
@@ -211,6 +272,13 @@ private:
 	float mSensX, mSensY, mHeadSensX, mHeadSensY;
 	int mCentX, mCentY;
 	///@}
+	/**
+	 * \brief Gets the pointer movement since the last call (recorded, or
+	 * replaced by the replayed one, see Replay).
+	 * @param deltaX, deltaY The movement (out parameters).
+	 * @return True if the pointer has moved, false otherwise.
+	 */
+	bool doGetPointerDelta(float& deltaX, float& deltaY);
 
 	/**
 	 * \brief Calculates the dynamic position of the chaser.
@@ -228,6 +296,68 @@ private:
 	 * @param baseHeight The corrected height cannot be shorter than this.
 	 */
 	void doCorrectChaserHeight(LPoint3f& newPos, float baseHeight);
+	/**
+	 * \brief Moves the chaser in front of any obstacle between it and the
+	 * chased object.
+	 * @param newPos The position that may be corrected (wrt reference).
+	 * @param lookAtPos The look at position (wrt reference).
+	 */
+	void doCorrectChaserOcclusion(LPoint3f& newPos, const LPoint3f& lookAtPos);
+	/**
+	 * \brief Gets the distance along a ray at which it leaves the bounding
+	 * sphere of the chased object.
+	 * @param from The ray origin (wrt world).
+	 * @param dir The ray (normalized) direction (wrt world).
+	 * @param worldNP The scene root.
+	 * @return The distance (0 if the ray misses the bounds).
+	 */
+	float doGetChasedExit(const LPoint3f& from, const LVector3f& dir,
+			const NodePath& worldNP);
+	/**
+	 * \brief Gets the ground height below a given position.
+	 * @param pos The position (wrt reference).
+	 * @param baseHeight The height returned if nothing is found below pos.
+	 * @return The ground height (wrt reference).
+	 */
+	float doGetGroundHeight(const LPoint3f& pos, float baseHeight);
+	/**
+	 * \brief Looks up the ground height from the terrain object heightfield.
+	 * @param pos The position (wrt reference).
+	 * @param height The ground height (wrt reference) (out parameter).
+	 * @return True if pos lies over the terrain, false otherwise.
+	 */
+	bool doGetTerrainHeight(const LPoint3f& pos, float& height);
+
+	/**
+	 * \name Occlusion and ground height (cached) queries.
+	 */
+	///@{
+	///Occlusion check flag.
+	bool mOcclusionCheck;
+	///Sweep test shape (a sphere), radius and mask.
+	SMARTPTR(BulletShape) mSweepShape;
+	float mSweepRadius;
+	BitMask32 mSweepMask;
+	///Cache lifetime (seconds) and tolerance.
+	float mCacheLifetime, mCacheTolerance;
+	///Last sweep test result (wrt world).
+	struct SweepCache
+	{
+		bool mValid, mHit;
+		LPoint3f mFrom, mTo;
+		float mHitFraction;
+		double mTime;
+	} mSweepCache;
+	///The terrain object (its terrain component is looked up when needed,
+	///so it is not kept alive by the chaser).
+	ObjectId mTerrainId;
+	///Ground height cache: indexed by coarse cell (wrt world) and terrain;
+	///the terrain component last seen and its stamp (changed on swaps).
+	float mHeightCellSize;
+	HeightCache mHeightCache;
+	SMARTPTR(Component) mHeightCacheTerrain;
+	unsigned int mHeightCacheStamp;
+	///@}
 
 	///TypedObject semantics: hardcoded
 public:
@@ -280,6 +410,20 @@ inline void Chaser::reset()
 	mSignOfMouse = 1;
 	mSensX = mSensY = 0.0;
 	mCentX = mCentY = 0.0;
+	mOcclusionCheck = false;
+	mSweepShape.clear();
+	mSweepRadius = 0.0;
+	mSweepMask = BitMask32::all_off();
+	mCacheLifetime = mCacheTolerance = 0.0;
+	mSweepCache.mValid = mSweepCache.mHit = false;
+	mSweepCache.mFrom = mSweepCache.mTo = LPoint3f::zero();
+	mSweepCache.mHitFraction = 1.0;
+	mSweepCache.mTime = 0.0;
+	mTerrainId = ObjectId();
+	mHeightCellSize = 1.0;
+	mHeightCache.invalidate();
+	mHeightCacheTerrain.clear();
+	mHeightCacheStamp = 0;
 }
 
 inline bool Chaser::isEnabled()
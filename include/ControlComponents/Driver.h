@@ -198,6 +198,14 @@ public:
 	LVector3f getCurrentSpeeds(float& angularSpeedH, float& angularSpeedP);
 	///@}
 
+	/**
+	 * \name Runtime state serialization: the current speeds.
+	 */
+	///@{
+	virtual void write_datagram(BamWriter* manager, Datagram& dg);
+	virtual void fillin(DatagramIterator& scan, BamReader* manager);
+	///@}
+
 private:
 	///Enabling flags.
 	bool mStartEnabled, mEnabled;
@@ -229,6 +237,13 @@ private:
 	float mSensX, mSensY;
 	int mCentX, mCentY;
 	///@}
+	/**
+	 * \brief Gets the pointer movement since the last call (recorded, or
+	 * replaced by the replayed one, see Replay).
+	 * @param deltaX, deltaY The movement (out parameters).
+	 * @return True if the pointer has moved, false otherwise.
+	 */
+	bool doGetPointerDelta(float& deltaX, float& deltaY);
 #ifdef ELY_THREAD
 	bool mDisabling;
 #endif
@@ -27,6 +27,10 @@
 #include "Utilities/Tools.h"
 #include <list>
 #include <audioManager.h>
+#include <audioSound.h>
+#include <filename.h>
+#include <vector>
+#include <map>
 #include "ObjectModel/Component.h"
 
 namespace ely
@@ -34,6 +38,24 @@ namespace ely
 /**
  * \brief Singleton manager updating audio components.
  *
+ * This manager also manages voices, i.e. the sounds of audio components
+ * added with addVoice(): at every update, after audio components have
+ * set the positions of their active voices (i.e. those playing or
+ * virtual), only the active voices that are audible (i.e. within their
+ * audible distance from the listener, if any) are candidates to be real;
+ * of these, the "voice budget" ones with the highest
+ * priority/(1+distance) are real (i.e. playing and 3d updated), while the
+ * others are virtual (i.e. stopped, but their play time advances, so
+ * they resume at the right point when they become real again).\n
+ * A virtual voice must be stopped with stopVoice() (stopping its sound
+ * doesn't prevent it to resume).\n
+ * Audio components should get their sounds through the sound bank
+ * (getSound()/releaseSound()): a sample file is read and decoded once and
+ * its data is shared by all the sounds (instances) of that file; the data
+ * is kept while there are instances and evicted when the last one is
+ * released. Files whose size exceeds the "stream threshold" are streamed
+ * from disk by every instance instead of being loaded whole.
+ *
  * Prepared for multi-threading.
  */
 class GameAudioManager: public Singleton<GameAudioManager>
@@ -83,6 +105,85 @@ public:
 	 */
 	AsyncTask::DoneStatus update(GenericAsyncTask* task);
 
+	/**
+	 * \name Voice management.
+	 */
+	///@{
+	/**
+	 * \brief Adds a voice.
+	 * @param sound The voice's sound.
+	 * @param priority The voice priority (>0).
+	 * @param audibleDistance Distance from the listener beyond which the
+	 * voice is virtual (<=0 means always audible).
+	 * @return The voice handle.
+	 */
+	int addVoice(SMARTPTR(AudioSound) sound, float priority,
+			float audibleDistance);
+	void removeVoice(int handle);
+	/**
+	 * \brief Sets position/velocity of a voice (wrt the listener's
+	 * reference, e.g. render).
+	 *
+	 * 3d attributes are applied to the sound only while the voice is real.
+	 */
+	void setVoiceAttributes(int handle, const LPoint3f& position,
+			const LVector3f& velocity);
+	bool isVoiceActive(int handle);
+	bool isVoiceVirtual(int handle);
+	void stopVoice(int handle);
+	void setVoiceBudget(int budget);
+	int getVoiceBudget() const;
+	///Voice counters (by the last update).
+	struct VoiceStats
+	{
+		unsigned int mReal, mVirtual;
+		///Voices that became virtual/real.
+		unsigned int mVirtualized, mRealized;
+	};
+	VoiceStats getVoiceStats() const;
+	///@}
+
+	/**
+	 * \name Sound bank.
+	 */
+	///@{
+	///How a sound file is loaded.
+	enum SoundLoadMode
+	{
+		SAMPLE, ///decoded once, shared
+		STREAM, ///streamed from disk by every instance
+		AUTO ///STREAM if file size > stream threshold, SAMPLE otherwise
+	};
+	/**
+	 * \brief Gets a new sound (instance) of a sound file.
+	 *
+	 * The load mode is decided when the file is first requested, and
+	 * kept while there are instances of it.
+	 * @param fileName The sound file.
+	 * @param positional The positional flag.
+	 * @param mode The load mode.
+	 * @return The sound (NULL on error).
+	 */
+	SMARTPTR(AudioSound) getSound(const Filename& fileName, bool positional,
+			SoundLoadMode mode = AUTO);
+	/**
+	 * \brief Releases a sound got by getSound().
+	 * @param sound The sound.
+	 */
+	void releaseSound(SMARTPTR(AudioSound) sound);
+	void setStreamThreshold(unsigned long int bytes);
+	unsigned long int getStreamThreshold() const;
+	///Sound bank counters.
+	struct SoundBankStats
+	{
+		///Files loaded as samples/streams and their instances.
+		unsigned int mSamples, mStreams, mInstances;
+		///Requests of already loaded/not loaded files.
+		unsigned long int mHits, mMisses;
+	};
+	SoundBankStats getSoundBankStats();
+	///@}
+
 #ifdef ELY_THREAD
 	/**
 	 * \brief Get the mutex to lock the entire structure.
@@ -101,6 +202,54 @@ private:
 	AudioComponentList mAudioComponents;
 	///@}
 
+	/**
+	 * \name Voices.
+	 */
+	///@{
+	struct Voice
+	{
+		SMARTPTR(AudioSound) mSound;
+		float mPriority, mAudibleDistance;
+		LPoint3f mPosition;
+		LVector3f mVelocity;
+		///Virtual voice: play time when virtualized and virtualization time.
+		bool mVirtual;
+		float mVirtualTime;
+		double mVirtualStart;
+		///Selection score (by the last update, -1 if not a candidate).
+		float mScore;
+		bool mValid;
+	};
+	std::vector<Voice> mVoices;
+	std::vector<int> mFreeVoices;
+	int mVoiceBudget;
+	VoiceStats mVoiceStats;
+	void doUpdateVoices();
+	void doVirtualizeVoice(Voice& voice, double now);
+	bool doRealizeVoice(Voice& voice, double now);
+	///@}
+
+	/**
+	 * \name Sound bank.
+	 */
+	///@{
+	struct SoundBankEntry
+	{
+		///The first instance: it keeps the (shared) sample data loaded.
+		SMARTPTR(AudioSound) mPrototype;
+		bool mStream;
+		unsigned int mRefCount;
+	};
+	///File full path -> entry.
+	typedef std::map<std::string, SoundBankEntry> SoundBank;
+	SoundBank mSoundBank;
+	///Instance -> file full path.
+	std::map<AudioSound*, std::string> mSoundInstances;
+	unsigned long int mStreamThreshold;
+	unsigned long int mSoundBankHits, mSoundBankMisses;
+	bool doIsLongFile(const Filename& fileName);
+	///@}
+
 	///@{
 	///A task data for update.
 	SMARTPTR(TaskInterface<GameAudioManager>::TaskData) mUpdateData;
@@ -123,6 +272,21 @@ private:
 
 ///inline definitions
 
+inline int GameAudioManager::getVoiceBudget() const
+{
+	return mVoiceBudget;
+}
+
+inline GameAudioManager::VoiceStats GameAudioManager::getVoiceStats() const
+{
+	return mVoiceStats;
+}
+
+inline unsigned long int GameAudioManager::getStreamThreshold() const
+{
+	return mStreamThreshold;
+}
+
 #ifdef ELY_THREAD
 inline ReMutex& GameAudioManager::getMutex()
 {
@@ -27,13 +27,24 @@
 
 #include "Utilities/Tools.h"
 #include <list>
+#include <vector>
+#include <map>
 #include "ObjectModel/Component.h"
+#include "BehaviorComponents/Activity.h"
+#include "Support/TickScheduler.h"
 
 namespace ely
 {
 /**
  * \brief Singleton manager updating Behavior components.
  *
+ * Activities are updated by a scheduler: they are grouped by instance
+ * update function, current state and state's tick period, and each group
+ * is updated over its contiguous batch of Activities once every tick
+ * period (0 means every frame). Every frame Activities are only checked
+ * for a state change (which moves them into another group) and, if they
+ * use a fast FSM, for posted requests.
+ *
  * Prepared for multi-threading.
  */
 class GameBehaviorManager: public Singleton<GameBehaviorManager>
@@ -68,6 +79,24 @@ public:
 	 */
 	void removeFromBehaviorUpdate(SMARTPTR(Component) behaviorComp);
 
+	/**
+	 * \name Adds/removes (if not present/present) an Activity to/from the
+	 * batched updating.
+	 */
+	///@{
+	void addToActivityUpdate(SMARTPTR(Activity) activity);
+	void removeFromActivityUpdate(SMARTPTR(Activity) activity);
+	///@}
+	///Scheduler counters (by the last update).
+	struct ActivityStats
+	{
+		///Non empty groups and scheduled Activities.
+		unsigned int mGroups, mActivities;
+		///Updated Activities and Activities which changed group.
+		unsigned int mTicked, mRegrouped;
+	};
+	ActivityStats getActivityStats() const;
+
 	/**
 	 * \brief Updates Behavior components.
 	 *
@@ -93,6 +122,23 @@ private:
 	BehaviorComponentList mBehaviorComponents;
 	///@}
 
+	/**
+	 * \name Activities' scheduler.
+	 */
+	///@{
+	///Activities keyed by (update function, state) and state's period.
+	typedef std::pair<Activity::PINSTANCEUPDATE, std::string> ActivityKey;
+	TickScheduler<SMARTPTR(Activity), ActivityKey> mActivityScheduler;
+	unsigned int mNumActivities;
+	ActivityStats mActivityStats;
+	void doAddToGroup(SMARTPTR(Activity) activity, const std::string& state);
+	void doUpdateActivities(float dt);
+	///The Activities of a group ticked in batch and the others (scratch).
+	std::vector<SMARTPTR(Activity)> mActivityBatch;
+	std::vector<std::pair<SMARTPTR(Activity), float> > mActivityOthers;
+	void doBatchUpdate(float dt, Activity::PINSTANCEBATCHUPDATE batchUpdate);
+	///@}
+
 	///@{
 	///A task data for step simulation update.
 	SMARTPTR(TaskInterface<GameBehaviorManager>::TaskData) mUpdateData;
@@ -114,6 +160,11 @@ private:
 
 ///inline definitions
 
+inline GameBehaviorManager::ActivityStats GameBehaviorManager::getActivityStats() const
+{
+	return mActivityStats;
+}
+
 #ifdef ELY_THREAD
 inline ReMutex& GameBehaviorManager::getMutex()
 {
@@ -122,6 +122,18 @@ public:
 
 	virtual void ProcessEvent(Rocket::Core::Event& event);
 
+	/**
+	 * \brief Processes an event given its (listener) value.
+	 */
+	static void processEvent(const Rocket::Core::String& value,
+			Rocket::Core::Event& event);
+
+	/**
+	 * \brief Processes an event of a replayed session (see Replay).
+	 */
+	static void replayEvent(const std::string& value,
+			const ParameterTable& params);
+
 };
 
 class MainEventListenerInstancer: public EventListenerInstancer
@@ -84,6 +84,18 @@ public:
 	 */
 	virtual void createGameWorld(const std::string& gameWorldXML);
 
+	/**
+	 * \brief Enables/disables the streaming creation of the game world.
+	 *
+	 * If enabled, createGameWorld() reads the description file through a
+	 * memory mapped XMLStream (SAX-like, in-situ) instead of building its
+	 * whole tinyxml2 document (default).
+	 */
+	///@{
+	void setXMLStreaming(bool enable);
+	bool getXMLStreaming() const;
+	///@}
+
 	/**
 	 * \brief Porting of python function direct.showbase.ShowBase.enableMouse.
 	 */
@@ -105,6 +117,30 @@ public:
 	 */
 	WindowFramework* const windowFramework() const;
 
+	/**
+	 * \brief Returns true if the game runs headless.
+	 *
+	 * Headless mode is selected by the "--headless" command line switch or
+	 * by the "ely-headless" config variable: no window is opened and the GUI
+	 * is not set up, so windowFramework() returns NULL and control
+	 * components get no mouse input.\n
+	 * The frame clock can run at a fixed tick ("ely-headless-tick", in Hz),
+	 * optionally as fast as possible ("ely-headless-free-run"), and the game
+	 * can exit after a number of frames ("ely-headless-frames").
+	 */
+	bool isHeadless() const;
+
+	/**
+	 * \name Scene graph roots: those of the window or, if headless, their
+	 * stand-ins (with a "cam" Camera under the camera group).
+	 */
+	///@{
+	NodePath getRender() const;
+	NodePath getRender2d() const;
+	NodePath getAspect2d() const;
+	NodePath getCameraGroup() const;
+	///@}
+
 	/**
 	 * \name Gets/sets game data infos.
 	 */
@@ -171,9 +207,20 @@ protected:
 
 	/// Common members
 	WindowFramework * mWindow;
-	NodePath mRender;
+	NodePath mRender, mRender2d, mAspect2d, mCameraGroup;
 	SMARTPTR(ClockObject) mGlobalClock;
 
+	///Headless mode.
+	bool mHeadless;
+	int mHeadlessFrames;
+	void doSetupHeadless();
+	///@{
+	///A task data for exiting after the headless frames.
+	SMARTPTR(TaskInterface<GameManager>::TaskData) mHeadlessData;
+	SMARTPTR(AsyncTask) mHeadlessTask;
+	AsyncTask::DoneStatus headlessUpdate(GenericAsyncTask* task);
+	///@}
+
 	/// NodePaths for enable_mouse/disable_mouse.
 	NodePath mTrackBall, mMouse2cam;
 
@@ -185,6 +232,10 @@ protected:
 	///Game data info DB.
 	std::map<GameDataInfo, std::string> mInfoDB;
 
+	///Streaming game world creation.
+	bool mXMLStreaming;
+	void doCreateGameWorldStreaming(const std::string& gameWorldXML);
+
 #ifdef ELY_DEBUG
 	bool mPhysicsDebugEnabled;
 	SMARTPTR(EventCallbackInterface<GameManager>::EventCallbackData) mPhysicsDebugData;
@@ -209,6 +260,41 @@ inline std::string GameManager::getDataInfo(GameDataInfo info)
 	return mInfoDB[info];
 }
 
+inline void GameManager::setXMLStreaming(bool enable)
+{
+	mXMLStreaming = enable;
+}
+
+inline bool GameManager::getXMLStreaming() const
+{
+	return mXMLStreaming;
+}
+
+inline bool GameManager::isHeadless() const
+{
+	return mHeadless;
+}
+
+inline NodePath GameManager::getRender() const
+{
+	return mRender;
+}
+
+inline NodePath GameManager::getRender2d() const
+{
+	return mRender2d;
+}
+
+inline NodePath GameManager::getAspect2d() const
+{
+	return mAspect2d;
+}
+
+inline NodePath GameManager::getCameraGroup() const
+{
+	return mCameraGroup;
+}
+
 #ifdef ELY_THREAD
 inline ReMutex& GameManager::getMutex()
 {
@@ -29,6 +29,8 @@
 #include <bulletWorld.h>
 #include <windowFramework.h>
 #include "ObjectModel/Component.h"
+#include "Support/EventBus.h"
+#include "Support/FrameArena.h"
 
 namespace ely
 {
@@ -327,16 +329,33 @@ private:
 			mCollidingNodePairData->mCount = _count;
 			*mRefCount = 1;
 		}
+		//lookup key constructor: data are scratch allocated from arena
+		CollidingNodePair(PandaNode *_pnode0, PandaNode *_pnode1, FrameArena& arena) :
+				mCollidingNodePairData(
+						new (arena.alloc(sizeof(CollidingNodePairData))) CollidingNodePairData),
+				mRefCount(NULL)
+		{
+			mCollidingNodePairData->mPnode = (_pnode0 > _pnode1 ?
+					std::make_pair(_pnode1, _pnode0) : std::make_pair(_pnode0, _pnode1));
+		}
 		//copy constructor
 		CollidingNodePair(const CollidingNodePair& on) :
 				mCollidingNodePairData(on.mCollidingNodePairData), mRefCount(on.mRefCount)
 		{
-			++(*mRefCount);
+			if (mRefCount)
+			{
+				++(*mRefCount);
+			}
 		}
 		//destructor
 		~CollidingNodePair()
 		{
-			if (--(*mRefCount) == 0)
+			if (not mRefCount)
+			{
+				//scratch data: memory is released by the arena
+				mCollidingNodePairData->~CollidingNodePairData();
+			}
+			else if (--(*mRefCount) == 0)
 			{
 				delete mCollidingNodePairData;
 				delete mRefCount;
@@ -362,8 +381,12 @@ private:
 	ThrowEventData mCollisionNotify;
 	std::set<CollidingNodePair> mCollidingNodePairs;
 	btCollisionDispatcher* mCollisionDispatcher;
-	///Helper.
+	///Helpers.
 	void doEnableCollisionNotify(EventThrown event, ThrowEventData eventData);
+	bool doPostCollisionEvent(EventBus::EventId id,
+			const std::string& pandaEvent,
+			const CollidingNodePair::CollidingNodePairData& data,
+			int numContacts);
 	///@}
 
 #ifdef ELY_THREAD
@@ -27,6 +27,9 @@
 #include "Utilities/Tools.h"
 #include <list>
 #include "ObjectModel/Component.h"
+#include "Support/InstanceBatch.h"
+#include "Support/ModelLoader.h"
+#include <map>
 
 namespace ely
 {
@@ -77,6 +80,38 @@ public:
 	 */
 	AsyncTask::DoneStatus update(GenericAsyncTask* task);
 
+	/**
+	 * \brief Gets (creating if needed) the instance batch of a model.
+	 *
+	 * Instance batches are updated after scene components.
+	 * @param key The batch key (e.g. the model object id).
+	 * @param model The model to be instanced.
+	 * @param reference The node path cells are attached to.
+	 * @param cellSize The cell size.
+	 * @return The instance batch.
+	 */
+	SMARTPTR(InstanceBatch) getInstanceBatch(const std::string& key,
+			const NodePath& model, const NodePath& reference, float cellSize);
+	/**
+	 * \brief Replaces the model of an instance batch (if present).
+	 *
+	 * Called when an asynchronously loaded model completes.
+	 * @param key The batch key.
+	 * @param model The model to be instanced.
+	 */
+	void refreshInstanceBatch(const std::string& key, const NodePath& model);
+	/**
+	 * \brief Removes (if present) an instance batch without instances.
+	 * @param key The batch key.
+	 */
+	void releaseInstanceBatch(const std::string& key);
+
+	/**
+	 * \brief Returns the model loader (shared cache and loader thread).
+	 * @return The model loader.
+	 */
+	SMARTPTR(ModelLoader) modelLoader() const;
+
 #ifdef ELY_THREAD
 	/**
 	 * \brief Get the mutex to lock the entire structure.
@@ -93,6 +128,15 @@ private:
 	SceneComponentList mSceneComponents;
 	///@}
 
+	///@{
+	///Table of instance batches.
+	typedef std::map<std::string, SMARTPTR(InstanceBatch)> InstanceBatchTable;
+	InstanceBatchTable mInstanceBatches;
+	///@}
+
+	///The model loader.
+	SMARTPTR(ModelLoader) mModelLoader;
+
 	///@{
 	///A task data for update.
 	SMARTPTR(TaskInterface<GameSceneManager>::TaskData) mUpdateData;
@@ -115,6 +159,11 @@ private:
 
 ///inline definitions
 
+inline SMARTPTR(ModelLoader) GameSceneManager::modelLoader() const
+{
+	return mModelLoader;
+}
+
 #ifdef ELY_THREAD
 inline ReMutex& GameSceneManager::getMutex()
 {
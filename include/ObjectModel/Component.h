@@ -25,8 +25,13 @@
 #define COMPONENT_H_
 
 #include "Utilities/Tools.h"
+#include "FunctionRegistry.h"
+#include "Support/MemoryPool/ConcurrentMemoryPool.h"
+#include "Support/MemoryPool/MemoryMacros.h"
 #include <pandaFramework.h>
 #include <typedWritableReferenceCount.h>
+#include <datagram.h>
+#include <datagramIterator.h>
 #include <genericAsyncTask.h>
 #include <pmutex.h>
 #include <conditionVar.h>
@@ -368,6 +373,18 @@ public:
 	 */
 	void setFreeFlag(bool freeComponent);
 
+	/**
+	 * \name Runtime state serialization (see Snapshot).
+	 *
+	 * Components with a runtime state not kept by their owner Object's
+	 * NodePath override these, calling the base ones first. The manager can
+	 * be NULL.
+	 */
+	///@{
+	virtual void write_datagram(BamWriter* manager, Datagram& dg);
+	virtual void fillin(DatagramIterator& scan, BamReader* manager);
+	///@}
+
 #ifdef ELY_THREAD
 	/**
 	 * \brief Get the mutex to lock the entire structure.
@@ -395,6 +412,22 @@ protected:
 	ReMutex mMutex;
 #endif
 
+	/**
+	 * \brief Finds a game function for this Component.
+	 *
+	 * Functions whose name is shared by the Objects of a type (i.e. the
+	 * default names) are resolved once per owner Object's template, the
+	 * others (e.g. specified by per Object parameters) are looked up into
+	 * the FunctionRegistry.
+	 * @param library The library the function belongs to.
+	 * @param name The function name.
+	 * @param shared True if the name is shared by the Objects of a type.
+	 * @return The function, NULL if not found.
+	 */
+	FunctionRegistry::Function doFindFunction(
+			FunctionRegistry::Library library, const std::string& name,
+			bool shared);
+
 	/**
 	 * \name Helper functions to register/unregister events' callbacks.
 	 *
@@ -417,13 +450,8 @@ protected:
 
 private:
 	//Event management data types and variables.
-	/**
-	 * \name Handles, typedefs, for managing library of event callbacks.
-	 */
-	///@{
-	lt_dlhandle mCallbackLib;
+	///Event callback type (resolved through the FunctionRegistry).
 	typedef EventHandler::EventCallbackFunction* PCALLBACK;
-	///@}
 
 	///Table of events keyed by event types.
 	std::map<std::string, std::string> mEventTable;
@@ -471,6 +499,9 @@ public:
 
 private:
 	static TypeHandle _type_handle;
+
+	///MemoryPool semantics: hardcoded
+	ELY_MEMORYPOOL_OPERATORS
 };
 
 ///inline definitions
@@ -611,6 +642,13 @@ public:
 	 */
 	WindowFramework* const windowFramework() const;
 
+	/**
+	 * \brief Gets the cache of the game functions shared by the
+	 * Components of this template.
+	 * @return The function cache.
+	 */
+	FunctionCache& functionCache();
+
 #ifdef ELY_THREAD
 	/**
 	 * \brief Get the mutex to lock the entire structure.
@@ -626,6 +664,8 @@ protected:
 	PandaFramework* mPandaFramework;
 	///The WindowFramework .
 	WindowFramework* mWindowFramework;
+	///Game functions resolved once per template.
+	FunctionCache mFunctionCache;
 
 #ifdef ELY_THREAD
 	///The mutex associated with this Template.
@@ -670,6 +710,11 @@ inline WindowFramework* const ComponentTemplate::windowFramework() const
 	return mWindowFramework;
 }
 
+inline FunctionCache& ComponentTemplate::functionCache()
+{
+	return mFunctionCache;
+}
+
 inline ParameterTable ComponentTemplate::getParameterTable() const
 {
 	//lock (guard) the mutex
@@ -0,0 +1,214 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/ObjectModel/FunctionRegistry.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef FUNCTIONREGISTRY_H_
+#define FUNCTIONREGISTRY_H_
+
+#include "Utilities/Tools.h"
+#include <reMutex.h>
+#include <boost/unordered_map.hpp>
+
+namespace ely
+{
+
+/**
+ * \brief Table of the game functions (event callbacks, transition
+ * functions, initialization functions and instance updates) looked up
+ * by name.
+ *
+ * Game functions register themselves at load time (see
+ * ELY_REGISTER_FUNCTION) so that every lookup is a (hash) table hit.
+ * Missing functions aren't kept into the table, since names can be per
+ * Object (e.g. "<OBJECTID>_initialization"): names shared by the Objects
+ * (or Components) of a template are resolved once per template through
+ * its FunctionCache.\n
+ * When a library path is set, the library is opened (once) the first
+ * time one of its functions is missing from the table: this runs its
+ * constructor which registers its functions. In plug-in mode, a function
+ * which is not registered is further looked up into the opened library
+ * with lt_dlsym.\n
+ * The registry is created on first use, so it can be used by static
+ * initializers, and is never destroyed.
+ */
+class FunctionRegistry
+{
+public:
+	/**
+	 * \brief The game function libraries.
+	 */
+	enum Library
+	{
+		CALLBACKS,
+		TRANSITIONS,
+		INITIALIZATIONS,
+		INSTANCEUPDATES,
+		LIBRARY_NUM
+	};
+	///Generic function pointer: cast to the real type on lookup.
+	typedef void (*Function)();
+
+	static FunctionRegistry& GetSingleton();
+
+	/**
+	 * \brief Registers/unregisters functions.
+	 */
+	///@{
+	void registerFunction(Library library, const std::string& name,
+			Function function);
+	void unregisterFunctions(Library library);
+	///@}
+
+	/**
+	 * \brief Finds a function by name.
+	 * @param library The library the function belongs to.
+	 * @param name The function name.
+	 * @return The function, NULL if not found.
+	 */
+	///@{
+	Function findFunction(Library library, const std::string& name);
+	template<typename F> F find(Library library, const std::string& name);
+	///@}
+
+	/**
+	 * \name Library paths and plug-in mode.
+	 */
+	///@{
+	void setLibraryPath(Library library, const std::string& path);
+	void setPluginMode(bool enable);
+	bool isPluginMode();
+	void closeLibraries();
+	///@}
+
+	/**
+	 * \name Lookup statistics.
+	 */
+	///@{
+	unsigned int getNumFunctions();
+	unsigned long int getLookups() const;
+	unsigned long int getLibrarySymbolLookups() const;
+	///@}
+
+	/**
+	 * \brief Returns the number of changes of the tables (functions
+	 * registered/unregistered or libraries closed).
+	 */
+	unsigned long int getGeneration();
+
+private:
+	FunctionRegistry();
+	~FunctionRegistry();
+
+	///The per library data.
+	struct LibraryEntry
+	{
+		LibraryEntry() :
+				mHandle(NULL), mOpened(false)
+		{
+		}
+		///The table: function name -> function.
+		typedef boost::unordered_map<std::string, Function> FunctionTable;
+		FunctionTable mTable;
+		std::string mPath;
+		lt_dlhandle mHandle;
+		bool mOpened;
+	};
+	LibraryEntry mLibraries[LIBRARY_NUM];
+	bool mPluginMode;
+	unsigned long int mLookups, mLibrarySymbolLookups, mGeneration;
+	///Protects the tables (reentrant: libraries register their functions
+	///while being opened).
+	ReMutex mMutex;
+
+	///Helper.
+	void doOpenLibrary(LibraryEntry& entry);
+};
+
+/**
+ * \brief Cache of FunctionRegistry lookups, missing functions included.
+ *
+ * Kept by Object and Component templates for the function names shared by
+ * the Objects (Components) they create, so each name is resolved once per
+ * template. It is emptied when the registry tables change.
+ */
+class FunctionCache
+{
+public:
+	FunctionCache();
+
+	/**
+	 * \brief Finds a function by name, from the cache or the registry.
+	 * @param library The library the function belongs to.
+	 * @param name The function name.
+	 * @return The function, NULL if not found.
+	 */
+	///@{
+	FunctionRegistry::Function findFunction(FunctionRegistry::Library library,
+			const std::string& name);
+	template<typename F> F find(FunctionRegistry::Library library,
+			const std::string& name);
+	///@}
+
+	void clear();
+	unsigned int getNumFunctions();
+
+private:
+	typedef boost::unordered_map<std::string, FunctionRegistry::Function> FunctionTable;
+	FunctionTable mTables[FunctionRegistry::LIBRARY_NUM];
+	///The registry generation the cached functions belong to.
+	unsigned long int mGeneration;
+	ReMutex mMutex;
+};
+
+///Registers a function into the table of a library (e.g. CALLBACKS).
+#define ELY_REGISTER_FUNCTION(_library_,_function_) \
+	ely::FunctionRegistry::GetSingleton().registerFunction(\
+		ely::FunctionRegistry::_library_, #_function_,\
+		reinterpret_cast<ely::FunctionRegistry::Function>(&_function_))
+
+///inline definitions
+
+template<typename F> inline F FunctionRegistry::find(Library library,
+		const std::string& name)
+{
+	return reinterpret_cast<F>(findFunction(library, name));
+}
+
+template<typename F> inline F FunctionCache::find(
+		FunctionRegistry::Library library, const std::string& name)
+{
+	return reinterpret_cast<F>(findFunction(library, name));
+}
+
+inline unsigned long int FunctionRegistry::getLookups() const
+{
+	return mLookups;
+}
+
+inline unsigned long int FunctionRegistry::getLibrarySymbolLookups() const
+{
+	return mLibrarySymbolLookups;
+}
+
+} // namespace ely
+
+#endif /* FUNCTIONREGISTRY_H_ */
@@ -26,9 +26,14 @@
 
 #include "Utilities/Tools.h"
 #include "Component.h"
+#include "ObjectIndex.h"
+#include "Support/MemoryPool/ConcurrentMemoryPool.h"
+#include "Support/MemoryPool/MemoryMacros.h"
 #include <pandaFramework.h>
 #include <nodePath.h>
 #include <typedWritableReferenceCount.h>
+#include <datagram.h>
+#include <datagramIterator.h>
 
 namespace ely
 {
@@ -77,6 +82,7 @@ class Object: public TypedWritableReferenceCount
 {
 private:
 	friend class ObjectTemplateManager;
+	friend class ObjectIndex;
 
 	/**
 	 * \brief Constructor.
@@ -214,6 +220,12 @@ public:
 	 */
 	ObjectId objectId() const;
 
+	/**
+	 * \brief Gets the handle of this Object (valid while it is created).
+	 * @return The handle of this Object.
+	 */
+	ObjectHandle getHandle() const;
+
 	/**
 	 * \brief NodePath getter/setter & conversion function.
 	 */
@@ -260,6 +272,11 @@ public:
 	 * @return The Components' parameter tables.
 	 */
 	ParameterTableMap getStoredCompTmplParams() const;
+	/**
+	 * \brief Returns true if the parameters have been stored (and not freed
+	 * since).
+	 */
+	bool hasStoredParams() const;
 	///@}
 
 	/**
@@ -271,6 +288,18 @@ public:
 	 */
 	void freeParameters();
 
+	/**
+	 * \name Runtime state serialization (see Snapshot).
+	 *
+	 * The transform of the NodePath (wrt its parent) and the runtime state of
+	 * every Component, by type (see Component::write_datagram()). The Object
+	 * identity (id, type, owner) is not included. The manager can be NULL.
+	 */
+	///@{
+	virtual void write_datagram(BamWriter* manager, Datagram& dg);
+	void fillin(DatagramIterator& scan, BamReader* manager);
+	///@}
+
 	/**
 	 * \brief Gets/sets this Object's owner, i.e. the Object
 	 * responsible of its lifetime (if any).
@@ -296,6 +325,8 @@ private:
 	NodePath mNodePath;
 	///Unique identifier for this Object (read only after creation).
 	ObjectId mObjectId;
+	///Handle into the ObjectTemplateManager's index.
+	ObjectHandle mHandle;
 	///The owner of this Object (responsible for its lifetime).
 	SMARTPTR(Object) mOwner;
 	///@{
@@ -330,8 +361,6 @@ private:
 	///some optimization.
 	bool mIsSteady;
 
-	///Handle of the library of initialization functions.
-	lt_dlhandle mInitializationLib;
 	///Helper flag.
 	bool mInitializationsLoaded;
 	///Initialization function name (optional).
@@ -340,7 +369,7 @@ private:
 	PINITIALIZATION mInitializationFunction;
 
 	/**
-	 * \name Helper functions to load/unload initialization functions.
+	 * \name Helper functions to load/unload initialization function.
 	 */
 	///@{
 	void doLoadInitializationFunctions();
@@ -353,6 +382,7 @@ private:
 	///@{
 	ParameterTable mObjTmplParams;
 	ParameterTableMap mCompTmplParams;
+	bool mParamsStored;
 	///@}
 
 #ifdef ELY_THREAD
@@ -384,6 +414,9 @@ public:
 
 private:
 	static TypeHandle _type_handle;
+
+	///MemoryPool semantics: hardcoded
+	ELY_MEMORYPOOL_OPERATORS
 };
 
 ///inline definitions
@@ -393,19 +426,17 @@ inline ObjectId Object::objectId() const
 	return mObjectId;
 }
 
-inline NodePath Object::getNodePath() const
+inline ObjectHandle Object::getHandle() const
 {
-	return mNodePath;
+	return mHandle;
 }
 
-inline void Object::setNodePath(const NodePath& nodePath)
+inline NodePath Object::getNodePath() const
 {
-	//called only by ObjectTemplateManager methods which
-	//already lock the Object mutex
-
-	mNodePath = nodePath;
+	return mNodePath;
 }
 
+
 inline Object::operator NodePath() const
 {
 	return mNodePath;
@@ -452,11 +483,20 @@ inline ParameterTableMap Object::getStoredCompTmplParams() const
 	return mCompTmplParams;
 }
 
+inline bool Object::hasStoredParams() const
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	return mParamsStored;
+}
+
 inline void Object::doStoreParameters(const ParameterTable& objTmplParams,
 		const ParameterTableMap& compTmplParams)
 {
 	mObjTmplParams = objTmplParams;
 	mCompTmplParams = compTmplParams;
+	mParamsStored = true;
 }
 
 inline void Object::freeParameters()
@@ -466,6 +506,7 @@ inline void Object::freeParameters()
 
 	mObjTmplParams.clear();
 	mCompTmplParams.clear();
+	mParamsStored = false;
 }
 
 inline bool Object::isSteady() const
@@ -527,7 +568,7 @@ public:
 	 * @param name The name of this template.
 	 * @param objectTmplMgr The ObjectTemplateManager.
 	 * @param pandaFramework The PandaFramework.
-	 * @param windowFramework The WindowFramework.
+	 * @param windowFramework The WindowFramework (NULL when headless).
 	 */
 	ObjectTemplate(const ObjectType& name, ObjectTemplateManager* objectTmplMgr,
 			PandaFramework* pandaFramework, WindowFramework* windowFramework);
@@ -676,6 +717,13 @@ public:
 	std::list<std::string> componentTypeParameterValues(const std::string& paramName,
 			ComponentType compType);
 
+	/**
+	 * \brief Gets the cache of the game functions shared by the Objects
+	 * of this template (and by their Components).
+	 * @return The function cache.
+	 */
+	FunctionCache& functionCache();
+
 #ifdef ELY_THREAD
 	/**
 	 * \brief Get the mutex to lock the entire structure.
@@ -703,6 +751,9 @@ private:
 	///Component of a given type, belonging to any Object of a given type.
 	std::map<ComponentType, ParameterTable> mComponentParameterTables;
 
+	///Game functions resolved once per template.
+	FunctionCache mFunctionCache;
+
 	///@{
 	struct componentHasType
 	{
@@ -794,6 +845,11 @@ inline WindowFramework* const ObjectTemplate::windowFramework() const
 	return mWindowFramework;
 }
 
+inline FunctionCache& ObjectTemplate::functionCache()
+{
+	return mFunctionCache;
+}
+
 #ifdef ELY_THREAD
 inline ReMutex& ObjectTemplate::getMutex()
 {
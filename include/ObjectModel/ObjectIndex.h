@@ -0,0 +1,207 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/ObjectModel/ObjectIndex.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef OBJECTINDEX_H_
+#define OBJECTINDEX_H_
+
+#include "Utilities/Tools.h"
+#include <atomicAdjust.h>
+#include <pandaNode.h>
+#include <vector>
+
+namespace ely
+{
+
+class Object;
+
+/**
+ * \brief Handle of a created Object.
+ *
+ * It is a (dense) index into the ObjectIndex's slots plus the generation
+ * of the slot: a handle of a destroyed Object is no longer valid, even
+ * if its slot has been reused.
+ */
+struct ObjectHandle
+{
+	unsigned int mIndex;
+	unsigned int mGeneration;
+
+	ObjectHandle() :
+			mIndex(0), mGeneration(0)
+	{
+	}
+	bool isValid() const
+	{
+		return mGeneration != 0;
+	}
+	bool operator==(const ObjectHandle& other) const
+	{
+		return (mIndex == other.mIndex) and (mGeneration == other.mGeneration);
+	}
+};
+
+/**
+ * \brief Index of the created Objects: by identifier, by handle and by
+ * (the PandaNode of) their NodePath.
+ *
+ * Objects are kept into a dense table of slots (addressed by handle),
+ * while two open addressing hash tables map identifier hashes and
+ * PandaNode pointers to slots.\n
+ * Lookups are lock-free. Writers must be serialized by the caller
+ * (ObjectTemplateManager's mutex): tables are grown by publishing a new
+ * copy, and the old copies, the slots of the removed Objects and the
+ * references to them, are retired and released with an epoch based
+ * reclamation (so a reader never sees freed memory nor a reused slot):
+ * - a reader enters the current epoch (counting itself into one of two
+ * counters, by the epoch's parity) for the duration of the lookup;
+ * - the epoch can advance when the counter of the previous epoch drains,
+ * so the readers are at most one epoch behind the current one;
+ * - data retired at epoch E is released once the epoch reaches E+2.
+ *
+ * Both readers (when leaving, if there is retired data) and writers
+ * advance the epoch: a steady flow of lookups doesn't delay reclamation.
+ */
+class ObjectIndex
+{
+public:
+	ObjectIndex();
+	~ObjectIndex();
+
+	/**
+	 * \name Writers (to be serialized).
+	 */
+	///@{
+	///Inserts an Object (taking a reference to it).
+	ObjectHandle insert(Object* object, const std::string& objectId,
+			PandaNode* node);
+	///Removes an Object (its reference is released later).
+	bool erase(const ObjectHandle& handle);
+	///Updates the PandaNode of an Object.
+	void setNode(const ObjectHandle& handle, PandaNode* node);
+	///@}
+
+	/**
+	 * \name Lock-free readers.
+	 */
+	///@{
+	ObjectHandle findHandle(const std::string& objectId) const;
+	SMARTPTR(Object) find(const std::string& objectId) const;
+	SMARTPTR(Object) find(const ObjectHandle& handle) const;
+	SMARTPTR(Object) findByNode(PandaNode* node) const;
+	///@}
+
+	unsigned int getNumObjects() const;
+
+private:
+	///A slot: the Object and its generation (incremented on removal).
+	struct Slot
+	{
+		AtomicAdjust::Pointer mObject;
+		AtomicAdjust::Integer mGeneration;
+		///Writer only data.
+		unsigned long int mIdHash;
+		PandaNode* mNode;
+	};
+	///Slots are allocated in chunks, which are never moved.
+	static const unsigned int CHUNK_SIZE = 1024;
+	static const unsigned int MAX_CHUNKS = 1024;
+	AtomicAdjust::Pointer mChunks[MAX_CHUNKS];
+	unsigned int mNumSlots;
+
+	///Hash table: key -> slot index + 1 (0 = empty).
+	struct Entry
+	{
+		AtomicAdjust::Integer mKey;
+		AtomicAdjust::Integer mValue;
+	};
+	struct Table
+	{
+		unsigned int mMask;
+		///Used entries (tombstones included).
+		unsigned int mUsed;
+		Entry* mEntries;
+	};
+	AtomicAdjust::Pointer mIdTable, mNodeTable;
+	unsigned int mNumObjects;
+
+	///The current epoch and the readers inside a lookup, by epoch parity.
+	mutable AtomicAdjust::Integer mEpoch;
+	mutable AtomicAdjust::Integer mReaders[2];
+	///Non zero while there is retired data (hint for the readers).
+	mutable AtomicAdjust::Integer mRetiring;
+	///Data retired at an epoch (one of the pointers, or the slot).
+	struct Retired
+	{
+		AtomicAdjust::Integer mEpoch;
+		Table* mTable;
+		Object* mObject;
+		int mSlot;
+	};
+	std::vector<Retired> mRetired;
+	std::vector<unsigned int> mFreeSlots;
+
+	///Helpers.
+	Slot* doGetSlot(unsigned int index) const;
+	static unsigned long int doHashId(const std::string& objectId);
+	static unsigned long int doHashNode(unsigned long int node);
+	///By identifier (objectId != NULL) or by node.
+	unsigned int doLookup(const AtomicAdjust::Pointer& table,
+			unsigned long int key, const std::string* objectId) const;
+	void doInsert(AtomicAdjust::Pointer& table, unsigned long int key,
+			unsigned int value, bool byNode);
+	void doErase(AtomicAdjust::Pointer& table, unsigned long int key,
+			unsigned int value, bool byNode);
+	static Table* doNewTable(unsigned int capacity);
+	static void doDeleteTable(Table* table);
+	static void doPlace(Table* table, unsigned long int key,
+			unsigned long int hash, unsigned int value);
+	///Epoch based reclamation.
+	void doRetire(Table* table, Object* object, int slot);
+	bool doAdvanceEpoch() const;
+	void doReclaim(bool all = false);
+
+	///Marks a lookup: the reader enters the current epoch.
+	struct ReaderScope
+	{
+		ReaderScope(const ObjectIndex& index);
+		~ReaderScope();
+		const ObjectIndex& mIndex;
+		AtomicAdjust::Integer* mReaders;
+	};
+	friend struct ReaderScope;
+
+	// don't allow copy
+	ObjectIndex(const ObjectIndex&);
+	ObjectIndex& operator=(const ObjectIndex&);
+};
+
+///inline definitions
+
+inline unsigned int ObjectIndex::getNumObjects() const
+{
+	return mNumObjects;
+}
+
+} // namespace ely
+
+#endif /* OBJECTINDEX_H_ */
@@ -26,6 +26,7 @@
 
 #include "Utilities/Tools.h"
 #include "Object.h"
+#include "ObjectIndex.h"
 
 namespace ely
 {
@@ -34,6 +35,9 @@ namespace ely
  *
  * This manager has the additional responsibility to create game Objects
  * and to maintain a table of (references to) all created Objects, indexed by ObjectId.\n
+ * Created Objects can be looked up by ObjectId, by ObjectHandle (resolved
+ * once, e.g. at setup) and by (the PandaNode of) their NodePath: these
+ * lookups go through an ObjectIndex, so they are O(1) and lock-free.\n
  * Thread-safe during utilization.
  */
 class ObjectTemplateManager: public Singleton<ObjectTemplateManager>
@@ -90,6 +94,8 @@ public:
 	 * (and before being initialized).
 	 * @param owner The owner Object
 	 * @return The just created Object, or NULL if the Object cannot be created.
+	 * \note While recording a session the creation is recorded; while
+	 * replaying one only the recorded creations are performed (see Replay).
 	 */
 	SMARTPTR(Object) createObject(ObjectType objectType, ObjectId objectId = ObjectId(""),
 			const ParameterTable& objectParams = ParameterTable(),
@@ -140,6 +146,36 @@ public:
 	 */
 	SMARTPTR(Object) getCreatedObject(const ObjectId& objectId) const;
 
+	/**
+	 * \name Indexed lookups of created Objects (lock-free).
+	 */
+	///@{
+	/**
+	 * \brief Gets the handle of a created Object by its identifier.
+	 * @return The handle (not valid on error).
+	 */
+	ObjectHandle getCreatedObjectHandle(const ObjectId& objectId) const;
+	/**
+	 * \brief Gets a created Object by its handle.
+	 * @return A reference to the created Object (NULL if the handle is stale).
+	 */
+	SMARTPTR(Object) getCreatedObjectByHandle(const ObjectHandle& handle) const;
+	/**
+	 * \brief Gets the created Object owning a NodePath.
+	 *
+	 * The NodePath and its ancestors are checked in turn, so that a NodePath
+	 * below an Object's one (e.g. a picked geometry) resolves to the Object.
+	 * @return A reference to the created Object (NULL if there is none).
+	 */
+	SMARTPTR(Object) getCreatedObjectByNodePath(const NodePath& nodePath) const;
+	/**
+	 * \brief Gets the created Object with a given PandaNode (e.g. a Bullet
+	 * node) as its NodePath's node.
+	 * @return A reference to the created Object (NULL if there is none).
+	 */
+	SMARTPTR(Object) getCreatedObjectByPandaNode(PandaNode* pandaNode) const;
+	///@}
+
 	/**
 	 * \brief Gets a list of all created Objects.
 	 * @return A list of references to the created Objects.
@@ -149,11 +185,12 @@ public:
 	/**
 	 * \brief Destroys a created Object by its identifier.
 	 * @return True if successful, false otherwise.
+	 * \note Recorded/replayed like the creations (see createObject()).
 	 */
 	bool destroyObject(const ObjectId& objectId);
 
 	/**
-	 * \brief Destroys all created Objects.
+	 * \brief Destroys all created Objects (not recorded/replayed).
 	 */
 	void destroyAllObjects();
 
@@ -166,10 +203,22 @@ public:
 #endif
 
 private:
+	friend class Object;
+
 	///Table of ObjectTemplates indexed by their name.
 	ObjectTemplateTable mObjectTemplates;
 	/// The table of created game Objects.
 	ObjectTable mCreatedObjects;
+	///The index of created game Objects.
+	ObjectIndex mIndex;
+	/**
+	 * \brief Updates the index when an Object's NodePath changes.
+	 */
+	void doIndexObjectNode(Object* object);
+	/**
+	 * \brief Actual Object destruction (the mutex should be held).
+	 */
+	bool doDestroyObject(const ObjectId& objectId);
 
 	///The unique identifier for created Objects.
 	IdType id;
@@ -187,6 +236,24 @@ private:
 
 ///inline definitions
 
+inline ObjectHandle ObjectTemplateManager::getCreatedObjectHandle(
+		const ObjectId& objectId) const
+{
+	return mIndex.findHandle(objectId);
+}
+
+inline SMARTPTR(Object) ObjectTemplateManager::getCreatedObjectByHandle(
+		const ObjectHandle& handle) const
+{
+	return mIndex.find(handle);
+}
+
+inline SMARTPTR(Object) ObjectTemplateManager::getCreatedObjectByPandaNode(
+		PandaNode* pandaNode) const
+{
+	return mIndex.findByNode(pandaNode);
+}
+
 #ifdef ELY_THREAD
 inline ReMutex& ObjectTemplateManager::getMutex()
 {
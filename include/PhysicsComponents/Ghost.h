@@ -247,16 +247,32 @@ private:
 			mOverlappingNodeData->mCount = _count;
 			*mRefCount = 1;
 		}
+		//lookup key constructor: data are scratch allocated from arena
+		OverlappingNode(PandaNode* _pnode, FrameArena& arena) :
+				mOverlappingNodeData(
+						new (arena.alloc(sizeof(OverlappingNodeData))) OverlappingNodeData),
+				mRefCount(NULL)
+		{
+			mOverlappingNodeData->mPnode = _pnode;
+		}
 		//copy constructor
 		OverlappingNode(const OverlappingNode& on) :
 				mOverlappingNodeData(on.mOverlappingNodeData), mRefCount(on.mRefCount)
 		{
-			++(*mRefCount);
+			if (mRefCount)
+			{
+				++(*mRefCount);
+			}
 		}
 		//destructor
 		~OverlappingNode()
 		{
-			if (--(*mRefCount) == 0)
+			if (not mRefCount)
+			{
+				//scratch data: memory is released by the arena
+				mOverlappingNodeData->~OverlappingNodeData();
+			}
+			else if (--(*mRefCount) == 0)
 			{
 				delete mOverlappingNodeData;
 				delete mRefCount;
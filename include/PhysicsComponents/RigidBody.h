@@ -137,6 +137,15 @@ public:
 	operator BulletRigidBodyNode&();
 	///@}
 
+	/**
+	 * \name Runtime state serialization: the type, the velocities and the
+	 * activation state (the transform is restored by the owner Object).
+	 */
+	///@{
+	virtual void write_datagram(BamWriter* manager, Datagram& dg);
+	virtual void fillin(DatagramIterator& scan, BamReader* manager);
+	///@}
+
 private:
 	///The NodePath associated to this rigid body.
 	NodePath mNodePath;
@@ -27,6 +27,7 @@
 #include <nodePath.h>
 #include "ObjectModel/Component.h"
 #include "ObjectModel/Object.h"
+#include "Support/InstanceBatch.h"
 
 namespace ely
 {
@@ -40,6 +41,17 @@ class InstanceOfTemplate;
  * ------|------|---------|-----
  * | *instance_of*  		|single| - | -
  * | *scale*  				|single| 1.0 | specified as "scalex[,scaley,scalez]"
+ * | *instanced*  			|single| *false* | -
+ * | *cell_size*  			|single| 64.0 | instanced only
+ *
+ * If *instanced* is true, this instance's node path has no geometry (it
+ * only gives the instance transform): the instance is drawn by the
+ * InstanceBatch (managed by GameSceneManager) shared by all instanced
+ * InstanceOf of the same object: only instances which moved have their
+ * transform updated and cells of *cell_size* are culled in bulk. The
+ * instanced model is drawn with the batch shader (unlit, first texture
+ * only) and shouldn't be animated. If the model is loaded asynchronously,
+ * the batch draws its placeholder (if any) until the load completes.
  *
  * \note parts inside [] are optional.\n
  */
@@ -75,6 +87,11 @@ public:
 	SMARTPTR(Object) getInstancedObject() const;
 	///@}
 
+	/**
+	 * \brief Returns the instance batch (if instanced) or NULL.
+	 */
+	SMARTPTR(InstanceBatch) getInstanceBatch() const;
+
 private:
 	///The NodePath associated to this instance of.
 	NodePath mNodePath;
@@ -92,6 +109,16 @@ private:
 	///Scaling.
 	LVecBase3f mScale;
 
+	/**
+	 * \name Hardware instancing.
+	 */
+	///@{
+	bool mInstanced;
+	float mCellSize;
+	SMARTPTR(InstanceBatch) mInstanceBatch;
+	int mInstanceHandle;
+	///@}
+
 	///TypedObject semantics: hardcoded
 public:
 	static TypeHandle get_class_type()
@@ -128,6 +155,14 @@ inline SMARTPTR(Object)InstanceOf::getInstancedObject() const
 	return mInstancedObject;
 }
 
+inline SMARTPTR(InstanceBatch) InstanceOf::getInstanceBatch() const
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	return mInstanceBatch;
+}
+
 inline void InstanceOf::reset()
 {
 	//
@@ -135,6 +170,10 @@ inline void InstanceOf::reset()
 	mInstanceOfId = ObjectId();
 	mInstancedObject.clear();
 	mScale = LVecBase3f::zero();
+	mInstanced = false;
+	mCellSize = 0.0;
+	mInstanceBatch.clear();
+	mInstanceHandle = -1;
 }
 
 inline void InstanceOf::onAddToSceneSetup()
@@ -31,6 +31,8 @@
 #include <ropeNode.h>
 #include <texture.h>
 #include "ObjectModel/Component.h"
+#include <asyncTask.h>
+#include <pmutex.h>
 
 namespace ely
 {
@@ -68,6 +70,18 @@ class ModelTemplate;
  * | *texture_file*				|single| - | -
  * | *texture_uscale*			|single| 1.0 | -
  * | *texture_vscale*			|single| 1.0 | -
+ * | *async_load*				|single| *false* | from file only
+ * | *placeholder_file*		|single| - | async load only
+ *
+ * Model (and animation) files are loaded through the GameSceneManager's
+ * ModelLoader, so repeated loads of the same file are copies of a
+ * single parsed model.\n
+ * If *async_load* is true, the model is loaded and its animations are
+ * bound on the loader thread: meanwhile the node path of this component
+ * is an empty node with the *placeholder_file* model (if any) as child.
+ * When loading is completed the model replaces the placeholder and the
+ * event "<ObjectId>_Model_Loaded" is thrown, with this component as
+ * argument.
  *
  * \note parts inside [] are optional.\n
  */
@@ -87,6 +101,19 @@ protected:
 public:
 	virtual ~Model();
 
+	/**
+	 * \brief Completes an asynchronous load.
+	 *
+	 * Will be called automatically by an scene manager update.
+	 * @param data The custom data.
+	 */
+	virtual void update(void* data);
+
+	/**
+	 * \brief Returns true while an asynchronous load is pending.
+	 */
+	bool isLoading() const;
+
 	/**
 	 * \brief Gets/sets the node path associated to this model.
 	 */
@@ -167,6 +194,50 @@ private:
 	 * by their names.
 	 */
 	void do_r_find_bundles(SMARTPTR(PandaNode) node, Anims &anims, Parts &parts);
+	/**
+	 * \brief Loads the model and binds its animations.
+	 *
+	 * Doesn't modify this component, so it can be executed by the
+	 * loader thread.
+	 * @return false if the model file cannot be loaded.
+	 */
+	bool doLoadFromFile(const std::string& modelNameParam,
+			const std::list<std::string>& animFileListParam, NodePath& modelNP,
+			AnimControlCollection& animations,
+			SMARTPTR(PartBundle)& firstPartBundle);
+	///@}
+
+	/**
+	 * \name Asynchronous load.
+	 */
+	///@{
+	bool mAsyncLoad;
+	std::string mPlaceholderParam;
+	NodePath mPlaceholder;
+	///Set while a load is pending.
+	bool mLoading;
+	///Load results (written by the loader thread).
+	bool mLoadReady;
+	NodePath mLoadedNP;
+	AnimControlCollection mLoadedAnimations;
+	SMARTPTR(PartBundle) mLoadedPartBundle;
+	///Protects load results.
+	Mutex mLoadMutex;
+	/**
+	 * \brief Load task, executed on the loader thread.
+	 */
+	class LoadTask: public AsyncTask
+	{
+	public:
+		LoadTask(Model* model, const std::string& modelNameParam,
+				const std::list<std::string>& animFileListParam);
+		virtual DoneStatus do_task();
+	private:
+		SMARTPTR(Model) mModel;
+		std::string mModelNameParam;
+		std::list<std::string> mAnimFileListParam;
+	};
+	friend class LoadTask;
 	///@}
 
 	///TypedObject semantics: hardcoded
@@ -214,6 +285,13 @@ inline void Model::reset()
 	mRopeThickness = 0.0;
 	mAnimations.clear_anims();
 	mFirstPartBundle.clear();
+	mAsyncLoad = false;
+	mPlaceholderParam.clear();
+	mPlaceholder = NodePath();
+	mLoading = mLoadReady = false;
+	mLoadedNP = NodePath();
+	mLoadedAnimations.clear_anims();
+	mLoadedPartBundle.clear();
 }
 
 inline AnimControlCollection Model::animations() const
@@ -224,12 +302,12 @@ inline AnimControlCollection Model::animations() const
 	return mAnimations;
 }
 
-inline void Model::onAddToSceneSetup()
+inline bool Model::isLoading() const
 {
-}
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
 
-inline void Model::onRemoveFromSceneCleanup()
-{
+	return mLoading;
 }
 
 inline NodePath Model::getNodePath() const
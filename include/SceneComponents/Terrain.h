@@ -29,6 +29,8 @@
 #include <texture.h>
 #include "ObjectModel/Component.h"
 #include "ObjectModel/Object.h"
+#include "Support/TerrainQuadTree.h"
+#include "Support/TerrainPager.h"
 
 namespace ely
 {
@@ -56,6 +58,35 @@ class GeoMipTerrainRef;
  * | *texture_file*				|single| - | -
  * | *texture_uscale*			|single| 1.0 | -
  * | *texture_vscale*			|single| 1.0 | -
+ * | *update_mode*				|single| *geomip* | values: geomip,quadtree,paged
+ * | *regen_budget*				|single| 4 | quadtree,paged modes only
+ * | *regen_threads*			|single| 2 | quadtree,paged modes only
+ * | *page_heightfield*			|single| - | paged mode only
+ * | *page_texture*				|single| - | paged mode only
+ * | *pages_x*					|single| 1 | paged mode only
+ * | *pages_y*					|single| 1 | paged mode only
+ * | *page_size*				|single| 257 | paged mode only
+ * | *page_radius*				|single| 1 | paged mode only
+ * | *page_physics*				|single| *true* | paged mode only
+ *
+ * With *update_mode* "geomip" the terrain is updated by GeoMipTerrain,
+ * i.e. every block is checked and regenerated in the scene manager thread.\n
+ * With *update_mode* "quadtree" the GeoMipTerrain is used only for its
+ * heightfield and root, while blocks are managed by a TerrainQuadTree:
+ * levels are selected through a quadtree of blocks, at most *regen_budget*
+ * blocks per frame are regenerated by *regen_threads* worker threads, and
+ * the new geometry is swapped in at the next update (*brute_force* is
+ * ignored).\n
+ * With *update_mode* "paged" the world is a grid of *pages_x* x *pages_y*
+ * heightfield pages of *page_size* pixels, whose files are given by
+ * *page_heightfield* (and *page_texture*) patterns where "{x}" and "{y}"
+ * are replaced by the page coordinates (*heightfield_file* is ignored
+ * and *texture_file* applies to pages without a texture). Pages within *page_radius* of the focal
+ * point's page are loaded by *regen_threads* worker threads (at most
+ * *regen_budget* dispatched per frame), pages beyond *page_radius*+1 are
+ * evicted, and, if *page_physics* is true, every resident page has a
+ * static Bullet HEIGHTFIELD body. *near_percent*/*far_percent* refer to
+ * the page size.
  *
  * \note parts inside [] are optional.\n
  */
@@ -91,6 +122,31 @@ public:
 	float getHeightScale() const;
 	///@}
 
+	/**
+	 * \brief Update mode.
+	 */
+	enum UpdateMode
+	{
+		GEOMIP,//!< GEOMIP GeoMipTerrain update
+		QUADTREE,//!< QUADTREE TerrainQuadTree update
+		PAGED//!< PAGED TerrainPager update
+	};
+	UpdateMode getUpdateMode() const;
+
+	/**
+	 * \name Quadtree mode regeneration budget and counters.
+	 */
+	///@{
+	void setRegenBudget(int budget);
+	int getRegenBudget() const;
+	TerrainQuadTree::Stats getUpdateStats() const;
+	///@}
+
+	/**
+	 * \brief Paged mode counters.
+	 */
+	TerrainPager::Stats getPagingStats() const;
+
 	/**
 	 * \name GeoMipTerrain reference getter & conversion function.
 	 */
@@ -140,6 +196,23 @@ private:
 	///Flag if brute force is enabled.
 	bool mBruteForce;
 
+	/**
+	 * \name Quadtree update mode stuff.
+	 */
+	///@{
+	UpdateMode mUpdateMode;
+	SMARTPTR(TerrainQuadTree) mQuadTree;
+	int mRegenBudget, mRegenThreads;
+	///@}
+
+	/**
+	 * \name Paged update mode stuff.
+	 */
+	///@{
+	SMARTPTR(TerrainPager) mPager;
+	TerrainPager::Settings mPageSettings;
+	///@}
+
 	///TypedObject semantics: hardcoded
 public:
 	static TypeHandle get_class_type()
@@ -220,6 +293,15 @@ inline void Terrain::reset()
 	mFocalPointNP = NodePath();
 	mTerrainRootNetPos = LPoint3f::zero();
 	mBruteForce = false;
+	mUpdateMode = GEOMIP;
+	mQuadTree.clear();
+	mRegenBudget = mRegenThreads = 0;
+	mPager.clear();
+	mPageSettings = TerrainPager::Settings();
+	mPageSettings.mPagesX = mPageSettings.mPagesY = 1;
+	mPageSettings.mPageSize = 2;
+	mPageSettings.mRadius = 0;
+	mPageSettings.mPhysics = false;
 }
 
 inline float Terrain::getWidthScale() const
@@ -237,6 +319,58 @@ inline float Terrain::getHeightScale() const
 	return mHeightScale;
 }
 
+inline Terrain::UpdateMode Terrain::getUpdateMode() const
+{
+	return mUpdateMode;
+}
+
+inline void Terrain::setRegenBudget(int budget)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	mRegenBudget = (budget > 0 ? budget : 1);
+	if (mQuadTree)
+	{
+		mQuadTree->setBudget(mRegenBudget);
+	}
+	if (mPager)
+	{
+		mPager->setBudget(mRegenBudget);
+	}
+}
+
+inline int Terrain::getRegenBudget() const
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	return mRegenBudget;
+}
+
+inline TerrainQuadTree::Stats Terrain::getUpdateStats() const
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	TerrainQuadTree::Stats stats;
+	stats.mRegenerated = stats.mDispatched = stats.mPending =
+			stats.mVisited = 0;
+	stats.mTotalRegenerated = 0;
+	return (mQuadTree ? mQuadTree->getStats() : stats);
+}
+
+inline TerrainPager::Stats Terrain::getPagingStats() const
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	TerrainPager::Stats stats;
+	stats.mResident = stats.mLoading = stats.mMissing = 0;
+	stats.mTotalLoaded = stats.mTotalEvicted = 0;
+	return (mPager ? mPager->getStats() : stats);
+}
+
 inline GeoMipTerrainRef& Terrain::getGeoMipTerrain()
 {
 	return *mTerrain;
@@ -0,0 +1,259 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/Support/EventBus.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef EVENTBUS_H_
+#define EVENTBUS_H_
+
+#include "Utilities/Tools.h"
+#include "ObjectModel/Object.h"
+#include <typedWritableReferenceCount.h>
+#include <vector>
+#include <deque>
+#include <map>
+
+namespace ely
+{
+
+/**
+ * \brief Singleton bus of typed events.
+ *
+ * Events are identified by integer ids: the ids of the events thrown by
+ * the engine are pre-registered (see BuiltinEvent), other ids can be
+ * registered by name with registerEvent().\n
+ * An event is a fixed size Payload: it is posted into the per-frame queue
+ * of its id (only if the id has subscribers) and, once per frame, each
+ * queue is drained by calling its subscribers with the whole batch of
+ * events posted during the frame (events posted while dispatching go to
+ * the next frame).\n
+ * Event sources call postEvent(), which returns if the corresponding
+ * Panda (string named) event should still be thrown: this is true only if
+ * the EventHandler has hooks for it (so callbacks registered with it keep
+ * working) and the "Panda bridge" of the id hasn't been disabled (by
+ * default it is enabled, and it is ignored if there is no EventBus).\n
+ * Subscribers can be restricted to the events near an observer Object (see
+ * subscribeNear()): they get only the events whose objects (or their
+ * owners) are within a radius of it, according to the InterestGrid.\n
+ * Subscribers are called without holding the bus' mutex, so they can post,
+ * (un)subscribe and query the bus.
+ *
+ * Prepared for multi-threading.
+ */
+class EventBus: public Singleton<EventBus>
+{
+public:
+	typedef int EventId;
+	/**
+	 * \brief The events pre-registered by the engine.
+	 */
+	enum BuiltinEvent
+	{
+		INVALID_EVENT = -1,
+		COLLISION_EVENT, //!< GamePhysicsManager: (first, second) collide
+		COLLISION_OFF_EVENT, //!< GamePhysicsManager: (first, second) stop
+		OVERLAP_EVENT, //!< Ghost: first overlaps the ghost (second)
+		OVERLAP_OFF_EVENT, //!< Ghost: first stops overlapping (second)
+		CROWDAGENT_MOVE_EVENT,
+		CROWDAGENT_STEADY_EVENT,
+		STEERVEHICLE_MOVE_EVENT,
+		STEERVEHICLE_STEADY_EVENT,
+		STEERVEHICLE_PATHFOLLOWING_EVENT,
+		STEERVEHICLE_AVOIDOBSTACLE_EVENT,
+		STEERVEHICLE_AVOIDCLOSENEIGHBOR_EVENT,
+		STEERVEHICLE_AVOIDNEIGHBOR_EVENT,
+		BUILTIN_EVENT_NUM
+	};
+
+	/**
+	 * \brief The event payload.
+	 */
+	struct Payload
+	{
+		EventId mId;
+		///The (optional) objects of the event: usually components.
+		SMARTPTR(TypedWritableReferenceCount) mFirst, mSecond;
+		///An (optional) value.
+		float mValue;
+	};
+	///A subscriber: called with the batch of events of an id.
+	typedef void (*Subscriber)(EventId id, const std::vector<Payload>& events,
+			void* data);
+
+	/**
+	 * \brief Constructor.
+	 * @param sort The dispatch task sort (should be after the managers').
+	 * @param priority The dispatch task priority.
+	 */
+	EventBus(int sort = 20, int priority = 0);
+	virtual ~EventBus();
+
+	/**
+	 * \name Event ids.
+	 */
+	///@{
+	EventId registerEvent(const std::string& name);
+	EventId getEventId(const std::string& name);
+	std::string getEventName(EventId id);
+	unsigned int getNumEvents();
+	///@}
+
+	/**
+	 * \name Subscribers.
+	 */
+	///@{
+	void subscribe(EventId id, Subscriber subscriber, void* data = NULL);
+	void unsubscribe(EventId id, Subscriber subscriber, void* data = NULL);
+	bool hasSubscribers(EventId id);
+	///@}
+
+	/**
+	 * \name Subscribers interested only in the events near an observer.
+	 *
+	 * An event is near if its first or second object (or its owner Object,
+	 * for a Component) is the observer or is within the radius of the
+	 * observer. Without an InterestGrid these get all the events.
+	 */
+	///@{
+	void subscribeNear(EventId id, const ObjectId& observerId, float radius,
+			Subscriber subscriber, void* data = NULL);
+	void unsubscribeNear(EventId id, const ObjectId& observerId,
+			Subscriber subscriber, void* data = NULL);
+	///@}
+
+	/**
+	 * \brief Posts an event into the queue of its id (if it has subscribers).
+	 * @param id The event id.
+	 * @param pandaEvent The name of the corresponding Panda event (if any).
+	 * @param first The first object.
+	 * @param second The second object.
+	 * @param value The value.
+	 * @return True if the Panda event should be thrown too.
+	 */
+	bool post(EventId id, const std::string& pandaEvent,
+			TypedWritableReferenceCount* first = NULL,
+			TypedWritableReferenceCount* second = NULL, float value = 0.0);
+
+	/**
+	 * \brief Posts an event to the EventBus (if any).
+	 * @return True if the corresponding Panda event should be thrown too.
+	 */
+	static bool postEvent(EventId id, const std::string& pandaEvent,
+			TypedWritableReferenceCount* first = NULL,
+			TypedWritableReferenceCount* second = NULL, float value = 0.0);
+
+	/**
+	 * \name Enables/disables the throwing of Panda events for an id.
+	 */
+	///@{
+	void setPandaBridge(EventId id, bool enable);
+	bool getPandaBridge(EventId id);
+	///@}
+
+	/**
+	 * \brief Drains all the queues by calling their subscribers.
+	 *
+	 * Called once per frame by the dispatch task (only one thread at a time
+	 * should call it).
+	 */
+	void dispatch();
+
+	/**
+	 * \brief Dispatch task.
+	 */
+	AsyncTask::DoneStatus update(GenericAsyncTask* task);
+
+	/**
+	 * \brief Statistics.
+	 */
+	struct EventBusStats
+	{
+		unsigned long int mPosted, mDispatched, mBatches;
+	};
+	EventBusStats getStats();
+
+private:
+	///The per id data.
+	struct EventQueue
+	{
+		std::string mName;
+		///Double buffered queue: events posted and events dispatched.
+		std::vector<Payload> mPending, mDispatching;
+		std::vector<std::pair<Subscriber, void*> > mSubscribers;
+		struct NearSubscriber
+		{
+			Subscriber mSubscriber;
+			void* mData;
+			ObjectId mObserverId;
+			float mRadius;
+		};
+		std::vector<NearSubscriber> mNearSubscribers;
+		bool mPandaBridge;
+	};
+	///A deque: registering events doesn't move the queues.
+	std::deque<EventQueue> mQueues;
+	std::map<std::string, EventId> mEventIds;
+	EventBusStats mStats;
+	///Helpers.
+	///@{
+	bool doIsValid(EventId id) const;
+	bool doHasSubscribers(const EventQueue& queue) const;
+	///Panda event with hooks (the EventHandler's).
+	static bool doHasPandaHooks(const std::string& pandaEvent);
+	///Calls a near subscriber with the events near its observer.
+	bool doDispatchNear(EventId id, const std::vector<Payload>& events,
+			const EventQueue::NearSubscriber& near);
+	///Scratch buffers (capacity kept between frames), used by dispatch()
+	///only, without holding the mutex.
+	std::vector<std::pair<Subscriber, void*> > mDispatchSubscribers;
+	std::vector<EventQueue::NearSubscriber> mDispatchNearSubscribers;
+	std::vector<ObjectId> mNearIds;
+	std::vector<Payload> mNearEvents;
+	///@}
+
+	///@{
+	///A task data for dispatch.
+	SMARTPTR(TaskInterface<EventBus>::TaskData) mUpdateData;
+	SMARTPTR(AsyncTask) mUpdateTask;
+	///@}
+
+#ifdef ELY_THREAD
+	///The mutex associated with this bus.
+	ReMutex mMutex;
+#endif
+};
+
+///inline definitions
+
+inline bool EventBus::doIsValid(EventId id) const
+{
+	return (id >= 0) and (id < (EventId) mQueues.size());
+}
+
+inline bool EventBus::doHasSubscribers(const EventQueue& queue) const
+{
+	return (not queue.mSubscribers.empty())
+			or (not queue.mNearSubscribers.empty());
+}
+
+} // namespace ely
+
+#endif /* EVENTBUS_H_ */
@@ -376,6 +376,14 @@ public:
 	 */
 	bool isInTransition() const;
 
+	/**
+	 * \brief Returns the number of transitions started so far.
+	 *
+	 * A cheap way to know if the state changed since a previous call.
+	 * @return The number of transitions.
+	 */
+	unsigned int getNumTransitions() const;
+
 	/**
 	 * \brief Changes unconditionally to the indicated state.
 	 *
@@ -549,6 +557,9 @@ protected:
 	StateKey mStateKey, mOldStateKey, mNewStateKey;
 	///@}
 
+	///Transitions started so far.
+	unsigned int mTransitions;
+
 	///Flag for notifying on every state change.
 	bool mBroadcastStateChanges;
 
@@ -598,6 +609,7 @@ template<typename StateKey> void FSM<StateKey>::initialize(const StateKey& name)
 	mStateKey = Off;
 	mOldStateKey = Null;
 	mNewStateKey = Null;
+	mTransitions = 0;
 	//set up bindings of the default functions
 	defaultEnterPTR = &FSM<StateKey>::defaultEnter;
 	defaultExitPTR = &FSM<StateKey>::defaultExit;
@@ -676,6 +688,14 @@ template<typename StateKey> bool FSM<StateKey>::getCurrentStateOrTransition(
 	return false;
 }
 
+template<typename StateKey> unsigned int FSM<StateKey>::getNumTransitions() const
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	return mTransitions;
+}
+
 template<typename StateKey> bool FSM<StateKey>::isInTransition() const
 {
 	//lock (guard) the mutex
@@ -921,6 +941,7 @@ template<typename StateKey> StateKey FSM<StateKey>::setState(
 	mOldStateKey = mStateKey;
 	mNewStateKey = newStateKey;
 	mStateKey = InTransition;
+	++mTransitions;
 	//check what transition function(s) to call
 	std::pair<StateKey, StateKey> fromTo(mOldStateKey, mNewStateKey);
 	typename FromToFunctionTable::iterator iter = mFromToFunctions.find(fromTo);
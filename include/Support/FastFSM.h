@@ -0,0 +1,872 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/Support/FastFSM.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef FASTFSM_H_
+#define FASTFSM_H_
+
+#include "Utilities/Tools.h"
+#include <atomicAdjust.h>
+#include <throw_event.h>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+namespace ely
+{
+
+/**
+ * \brief Small-buffer transition arguments.
+ *
+ * Up to MAX_ARGS scalar values (int, float, bool, pointer or state id)
+ * stored inline: copying and passing them never allocates.
+ */
+class FSMArgs
+{
+public:
+	enum
+	{
+		MAX_ARGS = 4
+	};
+	enum Type
+	{
+		NONE, INT, FLOAT, BOOL, POINTER, STATE
+	};
+
+	FSMArgs();
+
+	/**
+	 * \name Appends a value.
+	 *
+	 * @return False if there are already MAX_ARGS values.
+	 */
+	///@{
+	bool pushInt(int value);
+	bool pushFloat(float value);
+	bool pushBool(bool value);
+	bool pushPointer(void* value);
+	bool pushState(int value);
+	///@}
+
+	/**
+	 * \name Getters (by index).
+	 *
+	 * A getter called for a different type or an invalid index returns a
+	 * zero value.
+	 */
+	///@{
+	unsigned int size() const;
+	Type type(unsigned int i) const;
+	int getInt(unsigned int i) const;
+	float getFloat(unsigned int i) const;
+	bool getBool(unsigned int i) const;
+	void* getPointer(unsigned int i) const;
+	int getState(unsigned int i) const;
+	///@}
+
+	void clear();
+
+private:
+	struct Arg
+	{
+		Type mType;
+		union
+		{
+			int mInt;
+			float mFloat;
+			bool mBool;
+			void* mPointer;
+		};
+	};
+	Arg mArgs[MAX_ARGS];
+	unsigned int mNum;
+	Arg* doPush(Type type);
+	const Arg* doGet(unsigned int i, Type type) const;
+};
+
+/**
+ * \brief Bounded multiple producers single consumer lock-free queue of
+ * FSM requests.
+ *
+ * Any thread can push(), only the FSM's owner thread can pop(). Memory is
+ * allocated at construction only.
+ */
+class FSMRequestQueue
+{
+public:
+	struct Request
+	{
+		int mState;
+		bool mForce;
+		FSMArgs mArgs;
+	};
+
+	/**
+	 * \brief Constructor.
+	 * @param capacity The capacity (rounded up to a power of 2).
+	 */
+	FSMRequestQueue(unsigned int capacity);
+
+	/**
+	 * \brief Enqueues a request (thread safe).
+	 * @return False if the queue is full.
+	 */
+	bool push(const Request& request);
+	/**
+	 * \brief Dequeues a request (consumer thread only).
+	 * @return False if the queue is empty.
+	 */
+	bool pop(Request& request);
+
+private:
+	struct Cell
+	{
+		AtomicAdjust::Integer mSequence;
+		Request mRequest;
+	};
+	std::vector<Cell> mCells;
+	AtomicAdjust::Integer mMask;
+	///Producers' and consumer's positions (on different cache lines).
+	AtomicAdjust::Integer mEnqueuePos;
+	char mPad[64];
+	AtomicAdjust::Integer mDequeuePos;
+};
+
+/**
+ * \brief A Finite State Machine with the same enter/exit/filter/fromTo
+ * semantics of FSM, tuned for many instances.
+ *
+ * Differences from FSM:
+ * - state keys (strings) are interned to dense ids, so that states are
+ * stored into a table indexed by id and transitions never look up keys
+ * - callbacks are plain function pointers receiving the owner object
+ * (Owner&) and the transition arguments as FSMArgs, so transitions
+ * don't allocate
+ * - there is no mutex: transitions are performed by the owner thread;
+ * other threads can post() requests into a lock-free queue, which are
+ * performed by processRequests() (or, as with demand() and
+ * forceTransition() requests queued up during a transition, at the end of
+ * the current transition).
+ *
+ * Callbacks' signatures:
+ * - <em>Enter functions</em>: <tt> void f(FastFSM<Owner>*, Owner&, const FSMArgs&); </tt>
+ * - <em>Exit functions</em>: <tt> void f(FastFSM<Owner>*, Owner&); </tt>
+ * - <em>FromTo functions</em>: <tt> void f(FastFSM<Owner>*, Owner&, const FSMArgs&); </tt>
+ * - <em>Filter functions</em>: <tt> int f(FastFSM<Owner>*, Owner&, int toState, const FSMArgs& args, FSMArgs& enterArgs); </tt>
+ * \note the Filter functions return the id of the state to transition to
+ * (Null if the transition must be denied) and set the arguments passed to
+ * the transition.
+ */
+template<typename Owner> class FastFSM
+{
+public:
+	typedef int StateId;
+	///The "Null", "InTransition" and "Off" state ids.
+	enum
+	{
+		Null = -1, InTransition = -2, Off = 0
+	};
+
+	/**
+	 * \name Callback types.
+	 */
+	///@{
+	typedef void (*EnterFunc)(FastFSM<Owner>*, Owner&, const FSMArgs&);
+	typedef void (*ExitFunc)(FastFSM<Owner>*, Owner&);
+	typedef void (*FromToFunc)(FastFSM<Owner>*, Owner&, const FSMArgs&);
+	typedef StateId (*FilterFunc)(FastFSM<Owner>*, Owner&, StateId,
+			const FSMArgs&, FSMArgs&);
+	///@}
+
+	/**
+	 * \brief Constructor.
+	 * @param name The FSM's name.
+	 * @param owner The object passed to callbacks.
+	 * @param queueSize The request queue capacity.
+	 */
+	FastFSM(const std::string& name, Owner& owner, unsigned int queueSize =
+			64);
+	virtual ~FastFSM();
+
+	/**
+	 * \brief Transitions to Off and removes all states.
+	 */
+	void cleanup();
+
+	/**
+	 * \name State keys interning.
+	 *
+	 * These look up (and may add) keys, so should be used at setup time
+	 * and the returned ids stored.
+	 */
+	///@{
+	StateId intern(const std::string& key);
+	StateId getStateId(const std::string& key) const;
+	std::string getStateKey(StateId state) const;
+	///@}
+
+	/**
+	 * \name FSM construction functions.
+	 */
+	///@{
+	bool addState(const std::string& key, EnterFunc enterFunc,
+			ExitFunc exitFunc, FilterFunc filterFunc,
+			const std::vector<StateId>& allowedStates =
+					std::vector<StateId>());
+	bool removeState(const std::string& key);
+	bool addFromToFunc(const std::string& from, const std::string& to,
+			FromToFunc fromToFunc);
+	bool removeFromToFunc(const std::string& from, const std::string& to);
+	unsigned int getNumStates() const;
+	///@}
+
+	/**
+	 * \name State queries.
+	 *
+	 * See FSM.
+	 */
+	///@{
+	StateId getCurrentOrNextState() const;
+	bool getCurrentStateOrTransition(StateId& currState,
+			StateId& toState) const;
+	bool isInTransition() const;
+	///@}
+
+	/**
+	 * \name Transition requests (owner thread only).
+	 *
+	 * See FSM.
+	 */
+	///@{
+	StateId request(StateId state, const FSMArgs& args = FSMArgs());
+	void demand(StateId state, const FSMArgs& args = FSMArgs());
+	void forceTransition(StateId state, const FSMArgs& args = FSMArgs());
+	///@}
+
+	/**
+	 * \brief Posts a demand() (or a forceTransition()) request (thread safe).
+	 * @return False if the request queue is full.
+	 */
+	bool post(StateId state, const FSMArgs& args = FSMArgs(), bool force =
+			false);
+
+	/**
+	 * \brief Performs the posted requests (owner thread only).
+	 * @return The number of performed requests.
+	 */
+	unsigned int processRequests();
+
+	/**
+	 * \name State change broadcasting.
+	 *
+	 * See FSM.
+	 */
+	///@{
+	void setBroadcastStateChanges(bool doBroadcast);
+	std::string getStateChangeEvent() const;
+	///@}
+
+private:
+	///The name.
+	std::string mName;
+	///The owner.
+	Owner& mOwner;
+	///The state change event.
+	std::string mStateChangeEvent;
+
+	/**
+	 * \brief State table element.
+	 */
+	struct StateEntry
+	{
+		std::string mKey;
+		bool mDefined;
+		EnterFunc mEnter;
+		ExitFunc mExit;
+		FilterFunc mFilter;
+		///Sorted allowed states (examined by the default filter).
+		std::vector<StateId> mAllowedStates;
+		///FromTo functions from this state.
+		std::vector<std::pair<StateId, FromToFunc> > mFromTos;
+	};
+	///The state table indexed by state id (Off included).
+	std::vector<StateEntry> mStates;
+	std::map<std::string, StateId> mStateIds;
+
+	///The current/old/new states.
+	StateId mState, mOldState, mNewState;
+	bool mBroadcastStateChanges, mFiltering;
+	///Posted and queued up requests.
+	FSMRequestQueue mRequestQueue;
+	///Set while queued requests are being performed.
+	bool mPerforming;
+	unsigned long int mNumPerformed;
+
+	bool doIsDefined(StateId state) const;
+	StateId doSetState(StateId newState, const FSMArgs& args);
+	void doPerform(const FSMRequestQueue::Request& request);
+	FromToFunc doGetFromTo(StateId from, StateId to) const;
+	StateId doDefaultFilter(StateId toState, const FSMArgs& args,
+			FSMArgs& enterArgs) const;
+	static int SerialNum;
+};
+
+///inline definitions
+
+inline FSMArgs::FSMArgs() :
+		mNum(0)
+{
+}
+
+inline FSMArgs::Arg* FSMArgs::doPush(Type type)
+{
+	RETURN_ON_COND(mNum >= MAX_ARGS, NULL)
+
+	mArgs[mNum].mType = type;
+	return &mArgs[mNum++];
+}
+
+inline const FSMArgs::Arg* FSMArgs::doGet(unsigned int i, Type type) const
+{
+	return ((i < mNum) and (mArgs[i].mType == type)) ? &mArgs[i] : NULL;
+}
+
+inline bool FSMArgs::pushInt(int value)
+{
+	Arg* arg = doPush(INT);
+	return arg ? (arg->mInt = value, true) : false;
+}
+
+inline bool FSMArgs::pushFloat(float value)
+{
+	Arg* arg = doPush(FLOAT);
+	return arg ? (arg->mFloat = value, true) : false;
+}
+
+inline bool FSMArgs::pushBool(bool value)
+{
+	Arg* arg = doPush(BOOL);
+	return arg ? (arg->mBool = value, true) : false;
+}
+
+inline bool FSMArgs::pushPointer(void* value)
+{
+	Arg* arg = doPush(POINTER);
+	return arg ? (arg->mPointer = value, true) : false;
+}
+
+inline bool FSMArgs::pushState(int value)
+{
+	Arg* arg = doPush(STATE);
+	return arg ? (arg->mInt = value, true) : false;
+}
+
+inline unsigned int FSMArgs::size() const
+{
+	return mNum;
+}
+
+inline FSMArgs::Type FSMArgs::type(unsigned int i) const
+{
+	return i < mNum ? mArgs[i].mType : NONE;
+}
+
+inline int FSMArgs::getInt(unsigned int i) const
+{
+	const Arg* arg = doGet(i, INT);
+	return arg ? arg->mInt : 0;
+}
+
+inline float FSMArgs::getFloat(unsigned int i) const
+{
+	const Arg* arg = doGet(i, FLOAT);
+	return arg ? arg->mFloat : 0.0;
+}
+
+inline bool FSMArgs::getBool(unsigned int i) const
+{
+	const Arg* arg = doGet(i, BOOL);
+	return arg ? arg->mBool : false;
+}
+
+inline void* FSMArgs::getPointer(unsigned int i) const
+{
+	const Arg* arg = doGet(i, POINTER);
+	return arg ? arg->mPointer : NULL;
+}
+
+inline int FSMArgs::getState(unsigned int i) const
+{
+	const Arg* arg = doGet(i, STATE);
+	return arg ? arg->mInt : -1;
+}
+
+inline void FSMArgs::clear()
+{
+	mNum = 0;
+}
+
+////////////////////////////////////////////////////////////////////////
+template<typename Owner> int FastFSM<Owner>::SerialNum = 0;
+
+template<typename Owner> FastFSM<Owner>::FastFSM(const std::string& name,
+		Owner& owner, unsigned int queueSize) :
+		mName(name), mOwner(owner), mState(Off), mOldState(Null), mNewState(
+				Null), mBroadcastStateChanges(false), mFiltering(false), mRequestQueue(
+				queueSize), mPerforming(false), mNumPerformed(0)
+{
+	std::ostringstream stateChange;
+	stateChange << "FastFSM-" << ++SerialNum << "-" << mName
+			<< "-stateChange";
+	mStateChangeEvent = stateChange.str();
+	//the Off state
+	intern("__Off");
+}
+
+template<typename Owner> FastFSM<Owner>::~FastFSM()
+{
+}
+
+template<typename Owner> void FastFSM<Owner>::cleanup()
+{
+	if (mState != Off)
+	{
+		doSetState(Off, FSMArgs());
+	}
+	//interned ids stay valid
+	for (unsigned int s = 0; s < mStates.size(); ++s)
+	{
+		StateEntry& entry = mStates[s];
+		entry.mDefined = false;
+		entry.mEnter = NULL;
+		entry.mExit = NULL;
+		entry.mFilter = NULL;
+		entry.mAllowedStates.clear();
+		entry.mFromTos.clear();
+	}
+	mBroadcastStateChanges = false;
+}
+
+template<typename Owner> typename FastFSM<Owner>::StateId FastFSM<Owner>::intern(
+		const std::string& key)
+{
+	typename std::map<std::string, StateId>::const_iterator iter =
+			mStateIds.find(key);
+	if (iter != mStateIds.end())
+	{
+		return iter->second;
+	}
+	StateId state = mStates.size();
+	mStates.push_back(StateEntry());
+	StateEntry& entry = mStates.back();
+	entry.mKey = key;
+	entry.mDefined = false;
+	entry.mEnter = NULL;
+	entry.mExit = NULL;
+	entry.mFilter = NULL;
+	mStateIds[key] = state;
+	return state;
+}
+
+template<typename Owner> typename FastFSM<Owner>::StateId FastFSM<Owner>::getStateId(
+		const std::string& key) const
+{
+	typename std::map<std::string, StateId>::const_iterator iter =
+			mStateIds.find(key);
+	return iter != mStateIds.end() ? iter->second : (StateId) Null;
+}
+
+template<typename Owner> std::string FastFSM<Owner>::getStateKey(
+		StateId state) const
+{
+	RETURN_ON_COND((state < 0) or (state >= (StateId) mStates.size()),
+			std::string("__Null"))
+
+	return mStates[state].mKey;
+}
+
+template<typename Owner> bool FastFSM<Owner>::addState(
+		const std::string& key, EnterFunc enterFunc, ExitFunc exitFunc,
+		FilterFunc filterFunc, const std::vector<StateId>& allowedStates)
+{
+	if (mState == InTransition)
+	{
+		std::cerr
+				<< "FastFSM::addState: Cannot be called in enter/exit/fromTo functions"
+				<< std::endl;
+		return false;
+	}
+	StateId state = intern(key);
+	if ((state == Off) or (state == mState))
+	{
+		std::cerr << "FastFSM::addState: The state '" << key
+				<< "' cannot be added/updated" << std::endl;
+		return false;
+	}
+	StateEntry& entry = mStates[state];
+	entry.mDefined = true;
+	entry.mEnter = enterFunc;
+	entry.mExit = exitFunc;
+	entry.mFilter = filterFunc;
+	entry.mAllowedStates = allowedStates;
+	std::sort(entry.mAllowedStates.begin(), entry.mAllowedStates.end());
+	return true;
+}
+
+template<typename Owner> bool FastFSM<Owner>::removeState(
+		const std::string& key)
+{
+	if (mState == InTransition)
+	{
+		std::cerr
+				<< "FastFSM::removeState: Cannot be called in enter/exit/fromTo functions"
+				<< std::endl;
+		return false;
+	}
+	StateId state = getStateId(key);
+	if ((state == mState) or (state == Off))
+	{
+		std::cerr << "FastFSM::removeState: Current state '" << key
+				<< "' cannot be removed" << std::endl;
+		return false;
+	}
+	if (not doIsDefined(state))
+	{
+		std::cerr << "FastFSM::removeState: State '" << key
+				<< "' doesn't exist" << std::endl;
+		return false;
+	}
+	//the key stays interned
+	mStates[state].mDefined = false;
+	return true;
+}
+
+template<typename Owner> bool FastFSM<Owner>::addFromToFunc(
+		const std::string& from, const std::string& to,
+		FromToFunc fromToFunc)
+{
+	if (mState == InTransition)
+	{
+		std::cerr
+				<< "FastFSM::addFromToFunc: Cannot be called in enter/exit/fromTo functions"
+				<< std::endl;
+		return false;
+	}
+	StateId fromState = intern(from), toState = intern(to);
+	std::vector<std::pair<StateId, FromToFunc> >& fromTos =
+			mStates[fromState].mFromTos;
+	for (unsigned int i = 0; i < fromTos.size(); ++i)
+	{
+		if (fromTos[i].first == toState)
+		{
+			fromTos[i].second = fromToFunc;
+			return true;
+		}
+	}
+	fromTos.push_back(std::pair<StateId, FromToFunc>(toState, fromToFunc));
+	return true;
+}
+
+template<typename Owner> bool FastFSM<Owner>::removeFromToFunc(
+		const std::string& from, const std::string& to)
+{
+	if (mState == InTransition)
+	{
+		std::cerr
+				<< "FastFSM::removeFromToFunc: Cannot be called in enter/exit/fromTo functions"
+				<< std::endl;
+		return false;
+	}
+	StateId fromState = getStateId(from), toState = getStateId(to);
+	if ((fromState != Null) and (toState != Null))
+	{
+		std::vector<std::pair<StateId, FromToFunc> >& fromTos =
+				mStates[fromState].mFromTos;
+		for (unsigned int i = 0; i < fromTos.size(); ++i)
+		{
+			if (fromTos[i].first == toState)
+			{
+				fromTos.erase(fromTos.begin() + i);
+				return true;
+			}
+		}
+	}
+	std::cerr << "FastFSM::removeFromToFunc: Function from state '" << from
+			<< "' to state '" << to << "' doesn't exist" << std::endl;
+	return false;
+}
+
+template<typename Owner> unsigned int FastFSM<Owner>::getNumStates() const
+{
+	unsigned int numStates = 0;
+	for (unsigned int s = Off + 1; s < mStates.size(); ++s)
+	{
+		if (mStates[s].mDefined)
+		{
+			++numStates;
+		}
+	}
+	return numStates;
+}
+
+template<typename Owner> typename FastFSM<Owner>::StateId FastFSM<Owner>::getCurrentOrNextState() const
+{
+	return mState != InTransition ? mState : mNewState;
+}
+
+template<typename Owner> bool FastFSM<Owner>::getCurrentStateOrTransition(
+		StateId& currState, StateId& toState) const
+{
+	if (mState != InTransition)
+	{
+		currState = mState;
+		return true;
+	}
+	currState = mOldState;
+	toState = mNewState;
+	return false;
+}
+
+template<typename Owner> bool FastFSM<Owner>::isInTransition() const
+{
+	return mState == InTransition;
+}
+
+template<typename Owner> typename FastFSM<Owner>::StateId FastFSM<Owner>::request(
+		StateId state, const FSMArgs& args)
+{
+	if (mState == InTransition)
+	{
+		std::cerr
+				<< "FastFSM::request: Cannot be called in enter/exit/fromTo functions: (state: '"
+				<< getStateKey(mOldState) << "')" << std::endl;
+		return Null;
+	}
+	if (mFiltering)
+	{
+		std::cerr
+				<< "FastFSM::request: Cannot be called in filter functions: (state: '"
+				<< getStateKey(mState) << "')" << std::endl;
+		return Null;
+	}
+	FSMArgs enterArgs;
+	StateId acceptedState;
+	mFiltering = true;
+	if (mState == Off)
+	{
+		//from Off we can always go directly to any other state
+		enterArgs = args;
+		acceptedState = state;
+	}
+	else if (mStates[mState].mFilter)
+	{
+		acceptedState = mStates[mState].mFilter(this, mOwner, state, args,
+				enterArgs);
+	}
+	else
+	{
+		acceptedState = doDefaultFilter(state, args, enterArgs);
+	}
+	mFiltering = false;
+	return doSetState(acceptedState, enterArgs);
+}
+
+template<typename Owner> void FastFSM<Owner>::demand(StateId state,
+		const FSMArgs& args)
+{
+	if (mState == InTransition)
+	{
+		//queue up the request for later calling
+		if (not post(state, args, false))
+		{
+			std::cerr << "FastFSM::demand: Request queue full" << std::endl;
+		}
+		return;
+	}
+	if (request(state, args) == Null)
+	{
+		std::cerr << "FastFSM::demand: Request denied from '"
+				<< getStateKey(mState) << "' to '" << getStateKey(state)
+				<< "'" << std::endl;
+	}
+}
+
+template<typename Owner> void FastFSM<Owner>::forceTransition(StateId state,
+		const FSMArgs& args)
+{
+	if (mState == InTransition)
+	{
+		//queue up the request for later calling
+		if (not post(state, args, true))
+		{
+			std::cerr << "FastFSM::forceTransition: Request queue full"
+					<< std::endl;
+		}
+		return;
+	}
+	doSetState(state, args);
+}
+
+template<typename Owner> bool FastFSM<Owner>::post(StateId state,
+		const FSMArgs& args, bool force)
+{
+	FSMRequestQueue::Request request;
+	request.mState = state;
+	request.mForce = force;
+	request.mArgs = args;
+	return mRequestQueue.push(request);
+}
+
+template<typename Owner> unsigned int FastFSM<Owner>::processRequests()
+{
+	RETURN_ON_COND((mState == InTransition) or mPerforming, 0)
+
+	unsigned long int numPerformed = mNumPerformed;
+	mPerforming = true;
+	FSMRequestQueue::Request request;
+	while (mRequestQueue.pop(request))
+	{
+		doPerform(request);
+	}
+	mPerforming = false;
+	return mNumPerformed - numPerformed;
+}
+
+template<typename Owner> void FastFSM<Owner>::setBroadcastStateChanges(
+		bool doBroadcast)
+{
+	mBroadcastStateChanges = doBroadcast;
+}
+
+template<typename Owner> std::string FastFSM<Owner>::getStateChangeEvent() const
+{
+	return mStateChangeEvent;
+}
+
+template<typename Owner> bool FastFSM<Owner>::doIsDefined(StateId state) const
+{
+	return (state > Off) and (state < (StateId) mStates.size())
+			and mStates[state].mDefined;
+}
+
+template<typename Owner> typename FastFSM<Owner>::StateId FastFSM<Owner>::doSetState(
+		StateId newState, const FSMArgs& args)
+{
+	if ((newState != Off) and (not doIsDefined(newState)))
+	{
+		if (newState == Null)
+		{
+			std::cerr << "FastFSM::setState: State transition has been denied"
+					<< std::endl;
+		}
+		else
+		{
+			std::cerr << "FastFSM::setState: State '" << getStateKey(newState)
+					<< "' doesn't exist" << std::endl;
+		}
+		return mState;
+	}
+	mOldState = mState;
+	mNewState = newState;
+	mState = InTransition;
+	FromToFunc fromTo = doGetFromTo(mOldState, mNewState);
+	if (fromTo)
+	{
+		fromTo(this, mOwner, args);
+	}
+	else
+	{
+		if ((mOldState != Off) and mStates[mOldState].mExit)
+		{
+			mStates[mOldState].mExit(this, mOwner);
+		}
+		if ((mNewState != Off) and mStates[mNewState].mEnter)
+		{
+			mStates[mNewState].mEnter(this, mOwner, args);
+		}
+	}
+	if (mBroadcastStateChanges)
+	{
+		throw_event(mStateChangeEvent);
+	}
+	//transition completed
+	mState = mNewState;
+	mOldState = Null;
+	mNewState = Null;
+	//perform the queued up requests: as in FSM each one is performed
+	//after the previous transition, but iteratively
+	if (not mPerforming)
+	{
+		mPerforming = true;
+		FSMRequestQueue::Request request;
+		while (mRequestQueue.pop(request))
+		{
+			doPerform(request);
+		}
+		mPerforming = false;
+	}
+	return mState;
+}
+
+template<typename Owner> void FastFSM<Owner>::doPerform(
+		const FSMRequestQueue::Request& request)
+{
+	++mNumPerformed;
+	request.mForce ?
+			forceTransition(request.mState, request.mArgs) :
+			demand(request.mState, request.mArgs);
+}
+
+template<typename Owner> typename FastFSM<Owner>::FromToFunc FastFSM<Owner>::doGetFromTo(
+		StateId from, StateId to) const
+{
+	const std::vector<std::pair<StateId, FromToFunc> >& fromTos =
+			mStates[from].mFromTos;
+	for (unsigned int i = 0; i < fromTos.size(); ++i)
+	{
+		if (fromTos[i].first == to)
+		{
+			return fromTos[i].second;
+		}
+	}
+	return NULL;
+}
+
+template<typename Owner> typename FastFSM<Owner>::StateId FastFSM<Owner>::doDefaultFilter(
+		StateId toState, const FSMArgs& args, FSMArgs& enterArgs) const
+{
+	const std::vector<StateId>& allowed = mStates[mState].mAllowedStates;
+	//we can always go to the Off state; an empty allowed set
+	//accepts all requests
+	if ((toState == Off) or allowed.empty()
+			or std::binary_search(allowed.begin(), allowed.end(), toState))
+	{
+		enterArgs = args;
+		return toState;
+	}
+	std::cerr << "FastFSM::defaultFilter: No allowed states" << std::endl;
+	return Null;
+}
+
+} // namespace ely
+
+#endif /* FASTFSM_H_ */
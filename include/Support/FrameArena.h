@@ -0,0 +1,323 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/Support/FrameArena.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef FRAMEARENA_H_
+#define FRAMEARENA_H_
+
+#include "Utilities/Tools.h"
+#include <vector>
+#include <list>
+#include <map>
+#include <set>
+#include <limits>
+#include <new>
+
+namespace ely
+{
+
+/**
+ * \brief Bump allocator for per-frame scratch data.
+ *
+ * Memory is allocated by bumping an offset into a list of blocks, and is
+ * never freed individually: it is all released at once by rewinding the
+ * arena to a previous marker (or by resetting it). Blocks are kept between
+ * rewinds, so an arena at regime doesn't allocate from the heap.\n
+ * Every thread has its own arena (getThreadArena()): a Scope object placed
+ * at the beginning of an update (e.g. of a manager) rewinds the arena at
+ * its end, so scopes can be nested.\n
+ * Objects allocated into an arena are not destroyed: only trivially
+ * destructible ones, or those explicitly destroyed, should be placed there.
+ * \note With poisoning enabled (by default in debug builds) the released
+ * memory is filled with POISON_BYTE, to catch dangling uses.
+ *
+ * Not thread-safe: an arena must be used by one thread only.
+ */
+class FrameArena
+{
+public:
+	/**
+	 * \brief Constructor.
+	 * @param blockSize The (minimum) size of the blocks.
+	 */
+	FrameArena(size_t blockSize = 64 * 1024);
+	~FrameArena();
+
+	/**
+	 * \brief Returns the arena of the calling thread.
+	 *
+	 * The arena is created on first use and destroyed when the thread exits.
+	 */
+	static FrameArena& getThreadArena();
+
+	/**
+	 * \brief Allocates memory.
+	 * @param size The size.
+	 * @param alignment The alignment (a power of 2).
+	 * @return The allocated memory.
+	 */
+	void* alloc(size_t size, size_t alignment = DEFAULT_ALIGNMENT);
+	///Allocates an array of (uninitialized) objects.
+	template<typename T> T* allocArray(size_t num);
+
+	/**
+	 * \name Releasing memory.
+	 */
+	///@{
+	struct Marker
+	{
+		unsigned int mBlock;
+		size_t mOffset;
+	};
+	Marker getMarker() const;
+	void rewind(const Marker& marker);
+	void reset();
+	///@}
+
+	/**
+	 * \brief Rewinds an arena (by default the thread's one) at scope end.
+	 */
+	class Scope
+	{
+	public:
+		Scope();
+		Scope(FrameArena& arena);
+		~Scope();
+		FrameArena& getArena() const;
+	private:
+		FrameArena& mArena;
+		Marker mMarker;
+		// don't allow copy
+		Scope(const Scope&);
+		Scope& operator=(const Scope&);
+	};
+
+	/**
+	 * \name Debug poisoning of released memory.
+	 */
+	///@{
+	void setPoison(bool enable);
+	bool getPoison() const;
+	static const unsigned char POISON_BYTE = 0xDD;
+	///@}
+
+	/**
+	 * \brief Statistics.
+	 */
+	struct FrameArenaStats
+	{
+		size_t mUsed, mCapacity, mHighWater;
+		unsigned int mBlocks;
+	};
+	FrameArenaStats getStats() const;
+
+	static const size_t DEFAULT_ALIGNMENT = 2 * sizeof(void*);
+
+private:
+	///The blocks: memory and size.
+	std::vector<std::pair<unsigned char*, size_t> > mBlocks;
+	size_t mBlockSize;
+	///The current position.
+	unsigned int mCurrentBlock;
+	size_t mOffset;
+	///Statistics.
+	size_t mUsedInPreviousBlocks, mHighWater;
+	bool mPoison;
+
+	///Helpers.
+	size_t doGetUsed() const;
+	void doNextBlock(size_t minSize);
+
+	// don't allow copy
+	FrameArena(const FrameArena&);
+	FrameArena& operator=(const FrameArena&);
+};
+
+/**
+ * \brief STL allocator adaptor allocating from a FrameArena.
+ *
+ * Deallocation does nothing: memory is released when the arena is rewound,
+ * so containers using this allocator must not outlive the Scope in which
+ * they are created. By default it uses the thread's arena.
+ */
+template<typename T>
+class FrameAllocator
+{
+public:
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef size_t size_type;
+	typedef ptrdiff_t difference_type;
+	template<typename U> struct rebind
+	{
+		typedef FrameAllocator<U> other;
+	};
+
+	FrameAllocator() :
+			mArena(&FrameArena::getThreadArena())
+	{
+	}
+	FrameAllocator(FrameArena& arena) :
+			mArena(&arena)
+	{
+	}
+	template<typename U> FrameAllocator(const FrameAllocator<U>& other) :
+			mArena(other.getArena())
+	{
+	}
+
+	pointer address(reference x) const
+	{
+		return &x;
+	}
+	const_pointer address(const_reference x) const
+	{
+		return &x;
+	}
+	pointer allocate(size_type n, const void* hint = 0)
+	{
+		return mArena->allocArray<T>(n);
+	}
+	void deallocate(pointer p, size_type n)
+	{
+	}
+	size_type max_size() const
+	{
+		return std::numeric_limits<size_type>::max() / sizeof(T);
+	}
+	void construct(pointer p, const T& val)
+	{
+		new (static_cast<void*>(p)) T(val);
+	}
+	void destroy(pointer p)
+	{
+		p->~T();
+	}
+	FrameArena* getArena() const
+	{
+		return mArena;
+	}
+
+private:
+	FrameArena* mArena;
+};
+
+template<typename T, typename U>
+inline bool operator==(const FrameAllocator<T>& a, const FrameAllocator<U>& b)
+{
+	return a.getArena() == b.getArena();
+}
+
+template<typename T, typename U>
+inline bool operator!=(const FrameAllocator<T>& a, const FrameAllocator<U>& b)
+{
+	return a.getArena() != b.getArena();
+}
+
+/**
+ * \name Scratch containers allocating from a FrameArena.
+ */
+///@{
+template<typename T> struct FrameVector
+{
+	typedef std::vector<T, FrameAllocator<T> > type;
+};
+template<typename T> struct FrameList
+{
+	typedef std::list<T, FrameAllocator<T> > type;
+};
+template<typename T, typename C = std::less<T> > struct FrameSet
+{
+	typedef std::set<T, C, FrameAllocator<T> > type;
+};
+template<typename K, typename V, typename C = std::less<K> > struct FrameMap
+{
+	typedef std::map<K, V, C, FrameAllocator<std::pair<const K, V> > > type;
+};
+///@}
+
+///inline definitions
+
+template<typename T> inline T* FrameArena::allocArray(size_t num)
+{
+	size_t alignment =
+			sizeof(T) < DEFAULT_ALIGNMENT ? sizeof(T) : DEFAULT_ALIGNMENT;
+	//alignment must be a power of 2
+	while (alignment & (alignment - 1))
+	{
+		alignment &= alignment - 1;
+	}
+	return reinterpret_cast<T*>(alloc(num * sizeof(T), alignment));
+}
+
+inline FrameArena::Marker FrameArena::getMarker() const
+{
+	Marker marker;
+	marker.mBlock = mCurrentBlock;
+	marker.mOffset = mOffset;
+	return marker;
+}
+
+inline void FrameArena::reset()
+{
+	Marker marker;
+	marker.mBlock = 0;
+	marker.mOffset = 0;
+	rewind(marker);
+}
+
+inline void FrameArena::setPoison(bool enable)
+{
+	mPoison = enable;
+}
+
+inline bool FrameArena::getPoison() const
+{
+	return mPoison;
+}
+
+inline FrameArena::Scope::Scope() :
+		mArena(FrameArena::getThreadArena()), mMarker(mArena.getMarker())
+{
+}
+
+inline FrameArena::Scope::Scope(FrameArena& arena) :
+		mArena(arena), mMarker(mArena.getMarker())
+{
+}
+
+inline FrameArena::Scope::~Scope()
+{
+	mArena.rewind(mMarker);
+}
+
+inline FrameArena& FrameArena::Scope::getArena() const
+{
+	return mArena;
+}
+
+} // namespace ely
+
+#endif /* FRAMEARENA_H_ */
@@ -0,0 +1,230 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/Support/InstanceBatch.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef INSTANCEBATCH_H_
+#define INSTANCEBATCH_H_
+
+#include "Utilities/Tools.h"
+#include <nodePath.h>
+#include <texture.h>
+#include <shader.h>
+#include <transformState.h>
+#include <vector>
+#include <map>
+
+namespace ely
+{
+
+/**
+ * \brief Hardware instanced rendering of many copies of a model.
+ *
+ * The (flattened) model is drawn once per cell with an instance count
+ * equal to the number of instances in the cell: the per instance
+ * transforms are stored into a buffer texture (4 texels, i.e. matrix
+ * rows, per instance) and applied by the batch shader.\n
+ * The reference plane (x,y) is split into square cells of cellSize: every
+ * cell is a single node with bounds enclosing all its instances, so it is
+ * culled in bulk.\n
+ * On update() instances' transforms (wrt reference) are checked and
+ * only those of the instances that moved are rewritten into their cell's
+ * buffer; an instance moving into another cell is moved into that cell's
+ * buffer.\n
+ * Instances are identified by handles returned by addInstance().
+ */
+class InstanceBatch: public ReferenceCount
+{
+public:
+	/**
+	 * \brief Constructor.
+	 * @param name The name.
+	 * @param model The model to be instanced (it is copied, see setModel()).
+	 * @param reference The node path cells are attached to (e.g. render).
+	 * @param cellSize The cell size.
+	 */
+	InstanceBatch(const std::string& name, const NodePath& model,
+			const NodePath& reference, float cellSize);
+	virtual ~InstanceBatch();
+
+	/**
+	 * \brief Adds/removes an instance.
+	 *
+	 * An added instance is placed into its cell at the next update.
+	 * @param instanceNP The node path whose transform (wrt reference) is
+	 * the instance's transform.
+	 * @return The instance handle.
+	 */
+	///@{
+	int addInstance(const NodePath& instanceNP);
+	void removeInstance(int handle);
+	///@}
+
+	/**
+	 * \brief Replaces the instanced model.
+	 *
+	 * The model is copied and flattened again, so this should be called
+	 * when it has changed (e.g. a model loaded asynchronously replaced its
+	 * placeholder).
+	 * @param model The model to be instanced (it is copied).
+	 */
+	void setModel(const NodePath& model);
+
+	/**
+	 * \brief Rewrites the transforms of moved instances and updates cells.
+	 *
+	 * Must be called by the thread owning the scene graph under reference.
+	 */
+	void update();
+
+	/**
+	 * \brief Removes all cells' nodes.
+	 */
+	void cleanup();
+
+	/**
+	 * \name Getters.
+	 */
+	///@{
+	NodePath getRoot() const;
+	unsigned int getNumInstances() const;
+	///@}
+
+	/**
+	 * \brief Update counters.
+	 */
+	struct Stats
+	{
+		///Instances and (non empty) cells.
+		unsigned int mInstances, mCells;
+		///Instances rewritten by the last update.
+		unsigned int mMoved;
+		///Instances which changed cell by the last update.
+		unsigned int mCellChanges;
+	};
+	Stats getStats() const;
+
+private:
+	///Name.
+	std::string mName;
+	///Root of all cells (child of reference).
+	NodePath mRoot, mReference;
+	///The flattened model copy shared by all cells.
+	NodePath mModel;
+	///Model bounding sphere.
+	LPoint3f mModelCenter;
+	float mModelRadius;
+	///The batch shader.
+	PT(Shader) mShader;
+	///Cell size.
+	float mCellSize;
+
+	/**
+	 * \brief An instance.
+	 */
+	struct Instance
+	{
+		NodePath mNP;
+		///Last transform written.
+		CPT(TransformState) mTransform;
+		///Cell index and slot inside cell buffer (-1 if not placed yet).
+		int mCell, mSlot;
+		bool mValid;
+	};
+	std::vector<Instance> mInstances;
+	std::vector<int> mFreeHandles;
+	unsigned int mNumInstances;
+
+	/**
+	 * \brief A cell: one instanced draw.
+	 */
+	struct Cell
+	{
+		NodePath mNP;
+		///Transforms buffer and its capacity (in instances).
+		PT(Texture) mBuffer;
+		int mCapacity;
+		///Instance handle per slot.
+		std::vector<int> mSlots;
+		///Set when bounds and instance count must be recomputed.
+		bool mDirty;
+	};
+	std::vector<Cell> mCells;
+	std::map<std::pair<int, int>, int> mCellIndexes;
+
+	///Counters.
+	Stats mStats;
+
+	///Helpers.
+	///@{
+	int doGetCell(const LPoint3f& pos);
+	void doAddToCell(int handle, int cellIdx);
+	void doRemoveFromCell(int handle);
+	void doWriteSlot(Cell& cell, int slot);
+	void doUpdateCell(Cell& cell);
+	///@}
+
+	///TypedObject semantics: hardcoded
+public:
+	static TypeHandle get_class_type()
+	{
+		return _type_handle;
+	}
+	static void init_type()
+	{
+		ReferenceCount::init_type();
+		register_type(_type_handle, "InstanceBatch",
+				ReferenceCount::get_class_type());
+	}
+	virtual TypeHandle get_type() const
+	{
+		return get_class_type();
+	}
+	virtual TypeHandle force_init_type()
+	{
+		init_type();
+		return get_class_type();
+	}
+
+private:
+	static TypeHandle _type_handle;
+};
+
+///inline definitions
+
+inline NodePath InstanceBatch::getRoot() const
+{
+	return mRoot;
+}
+
+inline unsigned int InstanceBatch::getNumInstances() const
+{
+	return mNumInstances;
+}
+
+inline InstanceBatch::Stats InstanceBatch::getStats() const
+{
+	return mStats;
+}
+
+} // namespace ely
+
+#endif /* INSTANCEBATCH_H_ */
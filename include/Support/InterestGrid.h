@@ -0,0 +1,173 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/Support/InterestGrid.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef INTERESTGRID_H_
+#define INTERESTGRID_H_
+
+#include "Utilities/Tools.h"
+#include "ObjectModel/Object.h"
+#include <vector>
+#include <map>
+
+namespace ely
+{
+
+/**
+ * \brief Singleton area of interest grid of the created Objects.
+ *
+ * Every created Object is tracked (by the ObjectTemplateManager) into the
+ * cell of a uniform grid, on the (x, y) plane, containing the position of
+ * its NodePath (wrt the scene root). Cells are hashed into a fixed number of
+ * buckets, so the grid is unbounded.\n
+ * Once per frame the positions are refreshed and only the Objects changing
+ * cell are moved between buckets. "Who is near" queries only visit the
+ * cells overlapping the query circle, so their cost is proportional to the
+ * local density, not to the number of Objects.\n
+ * The EventBus (see EventBus::subscribeNear()) and the Replication use it,
+ * if present, to target only the interested observers.
+ *
+ * Prepared for multi-threading.
+ */
+class InterestGrid: public Singleton<InterestGrid>
+{
+public:
+	/**
+	 * \brief Constructor.
+	 *
+	 * The already created Objects are tracked too.
+	 * @param cellSize The cell size (should be about the common query radius).
+	 * @param numBuckets The buckets (rounded up to a power of 2).
+	 * @param sort The refresh task sort (should be after the managers' and
+	 * before the event bus dispatch).
+	 * @param priority The refresh task priority.
+	 */
+	InterestGrid(float cellSize = 20.0, unsigned int numBuckets = 4096,
+			int sort = 15, int priority = 0);
+	virtual ~InterestGrid();
+
+	/**
+	 * \name Tracked Objects.
+	 */
+	///@{
+	void addObject(SMARTPTR(Object) object);
+	void removeObject(const ObjectId& objectId);
+	///Updates an Object's position and cell now (not only once per frame).
+	void updateObject(const ObjectId& objectId);
+	///Updates all Objects' positions and cells.
+	void refresh();
+	///@}
+
+	/**
+	 * \name Queries.
+	 */
+	///@{
+	///The tracked position of an Object.
+	bool getPosition(const ObjectId& objectId, LPoint3f& pos);
+	///The Objects within a radius of a point (on the plane).
+	void queryRadius(const LPoint3f& center, float radius,
+			std::vector<ObjectId>& result);
+	///The Objects within a radius of an Object (excluding it).
+	bool queryNear(const ObjectId& objectId, float radius,
+			std::vector<ObjectId>& result);
+	///@}
+
+	float getCellSize() const;
+
+	/**
+	 * \brief Refresh task.
+	 */
+	AsyncTask::DoneStatus update(GenericAsyncTask* task);
+
+	/**
+	 * \brief Statistics: the last refresh moves and the query totals.
+	 */
+	struct InterestGridStats
+	{
+		unsigned int mObjects, mCellChanges;
+		unsigned long int mQueries, mVisited, mFound;
+	};
+	InterestGridStats getStats();
+
+private:
+	float mCellSize;
+
+	///A tracked Object.
+	struct Entry
+	{
+		ObjectId mObjectId;
+		SMARTPTR(Object) mObject;
+		LPoint3f mPos;
+		int mCellX, mCellY;
+		///The bucket (if placed) and the index into it.
+		bool mPlaced;
+		unsigned int mBucket, mBucketIndex;
+	};
+	std::vector<Entry> mEntries;
+	std::vector<unsigned int> mFreeEntries;
+	std::map<ObjectId, unsigned int> mEntryIds;
+
+	///Entries by hashed cell.
+	std::vector<std::vector<unsigned int> > mBuckets;
+	unsigned int mBucketMask;
+
+	///Helpers.
+	///@{
+	unsigned int doGetBucket(int cellX, int cellY) const;
+	int doGetCell(float coord) const;
+	///Places an entry into its (possibly new) cell.
+	bool doPlace(unsigned int entryIdx);
+	void doUnplace(unsigned int entryIdx);
+	void doQueryRadius(const LPoint3f& center, float radius,
+			const ObjectId& excluded, std::vector<ObjectId>& result);
+	///@}
+
+	InterestGridStats mStats;
+
+	///@{
+	///A task data for refreshing.
+	SMARTPTR(TaskInterface<InterestGrid>::TaskData) mUpdateData;
+	SMARTPTR(AsyncTask) mUpdateTask;
+	///@}
+
+#ifdef ELY_THREAD
+	///The mutex associated with this grid.
+	ReMutex mMutex;
+#endif
+};
+
+///inline definitions
+
+inline float InterestGrid::getCellSize() const
+{
+	return mCellSize;
+}
+
+inline unsigned int InterestGrid::doGetBucket(int cellX, int cellY) const
+{
+	return ((static_cast<unsigned int>(cellX) * 73856093U)
+			^ (static_cast<unsigned int>(cellY) * 19349663U)) & mBucketMask;
+}
+
+} // namespace ely
+
+#endif /* INTERESTGRID_H_ */
@@ -0,0 +1,195 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/Support/Lockstep.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef LOCKSTEP_H_
+#define LOCKSTEP_H_
+
+#include "Utilities/Tools.h"
+#include "ObjectModel/Component.h"
+#include "Support/Replay.h"
+#include <clockObject.h>
+#include <numeric_types.h>
+#include <vector>
+#include <string>
+
+namespace ely
+{
+
+/**
+ * \brief Singleton driving the deterministic (lockstep) simulation mode.
+ *
+ * When a Lockstep exists:
+ * - all game managers update their components with the same fixed tick
+ * delta time (see getFrameDt()), independent of the frame rate;
+ * - components are kept into the managers' update lists ordered by owner
+ * object id and component type, independent of the insertion order (see
+ * getInsertPosition());
+ * - the C library random generator (used by OpenSteer) is seeded from the
+ * seed, the tick and a key before each keyed use (see seedRandom());
+ * - at the end of each tick a checksum of the state (the transforms of the
+ * created objects, in id order) is computed and kept for the recent ticks.
+ *
+ * So the same inputs give the same results (and checksums) across runs.\n
+ * The simulation advances one tick per frame: for real time pacing the
+ * frame rate should be limited to the tick rate (e.g. "clock-mode limited").
+ * \note The tick ends (and its number advances) after the managers' updates
+ * and the event bus dispatch, so the end task's sort should follow them.
+ */
+class Lockstep: public Singleton<Lockstep>
+{
+public:
+	/**
+	 * \brief Constructor.
+	 * @param tickDt The fixed tick delta time.
+	 * @param seed The random seed.
+	 * @param numChecksums The recent ticks' checksums kept (0 = no checksum).
+	 * @param sort The tick end task sort.
+	 * @param priority The tick end task priority.
+	 */
+	Lockstep(float tickDt = 1.0 / 60.0, unsigned int seed = 0,
+			unsigned int numChecksums = 256, int sort = 25, int priority = 0);
+	virtual ~Lockstep();
+
+	/**
+	 * \name Tick.
+	 */
+	///@{
+	float getTickDt() const;
+	unsigned int getSeed() const;
+	///The current tick number (since creation).
+	unsigned long int getTick() const;
+	///@}
+
+	/**
+	 * \brief Returns the frame delta time for the game managers: the fixed
+	 * tick one if there is a Lockstep, the recorded one if a session is being
+	 * replayed, the global clock's one otherwise.
+	 */
+	static float getFrameDt();
+
+	/**
+	 * \brief Returns where a component should be inserted into an update
+	 * list: at the end or, if there is a Lockstep, before the first one
+	 * following it in (owner object id, component type) order.
+	 */
+	template<typename LIST> static typename LIST::iterator getInsertPosition(
+			LIST& components, const SMARTPTR(Component)& component);
+	static bool componentLess(const SMARTPTR(Component)& first,
+			const SMARTPTR(Component)& second);
+
+	/**
+	 * \brief Seeds the C library random generator from the seed, the
+	 * current tick and a key (e.g. an object id), if there is a Lockstep.
+	 */
+	static void seedRandom(const std::string& key);
+
+	/**
+	 * \name State checksums.
+	 */
+	///@{
+	///Computes the checksum of the current state.
+	unsigned int computeChecksum() const;
+	///Gets the checksum of a recent tick (false if not available).
+	bool getChecksum(unsigned long int tick, unsigned int& checksum) const;
+	///@}
+
+	/**
+	 * \brief Tick end task: records the checksum and advances the tick.
+	 */
+	AsyncTask::DoneStatus endTick(GenericAsyncTask* task);
+
+	/**
+	 * \brief 32 bit FNV-1a hash of bytes, chained to a previous one.
+	 */
+	static unsigned int hash(const void* data, unsigned int size,
+			unsigned int hash = 2166136261U);
+	/**
+	 * \brief Hash of an integer as 64 bits in little endian order, so it
+	 * doesn't depend on the platform's integer size and byte order.
+	 */
+	static unsigned int hash64(PN_uint64 value,
+			unsigned int hash = 2166136261U);
+
+private:
+	float mTickDt;
+	unsigned int mSeed;
+	unsigned long int mTick;
+
+	///Checksums' ring.
+	struct Checksum
+	{
+		unsigned long int mTick;
+		unsigned int mValue;
+	};
+	std::vector<Checksum> mChecksums;
+
+	///@{
+	///A task data for ending the tick.
+	SMARTPTR(TaskInterface<Lockstep>::TaskData) mEndTickData;
+	SMARTPTR(AsyncTask) mEndTickTask;
+	///@}
+};
+
+///inline definitions
+
+inline float Lockstep::getTickDt() const
+{
+	return mTickDt;
+}
+
+inline unsigned int Lockstep::getSeed() const
+{
+	return mSeed;
+}
+
+inline unsigned long int Lockstep::getTick() const
+{
+	return mTick;
+}
+
+inline float Lockstep::getFrameDt()
+{
+	Lockstep* lockstep = GetSingletonPtr();
+	RETURN_ON_COND(lockstep, lockstep->mTickDt)
+	Replay* replay = Replay::GetSingletonPtr();
+	RETURN_ON_COND(replay and replay->isReplaying(), replay->getFrameDt())
+
+	return ClockObject::get_global_clock()->get_dt();
+}
+
+template<typename LIST> inline typename LIST::iterator Lockstep::getInsertPosition(
+		LIST& components, const SMARTPTR(Component)& component)
+{
+	RETURN_ON_COND(not GetSingletonPtr(), components.end())
+
+	typename LIST::iterator iter = components.begin();
+	while ((iter != components.end()) and (not componentLess(component, *iter)))
+	{
+		++iter;
+	}
+	return iter;
+}
+
+} // namespace ely
+
+#endif /* LOCKSTEP_H_ */
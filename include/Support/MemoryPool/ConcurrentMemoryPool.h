@@ -0,0 +1,162 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/Support/MemoryPool/ConcurrentMemoryPool.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef CONCURRENTMEMORYPOOL_H_
+#define CONCURRENTMEMORYPOOL_H_
+
+#include "Support/MemoryPool/MemoryPool.h"
+#include <pmutex.h>
+
+namespace ely
+{
+
+/**
+ * \brief Memory pool statistics.
+ *
+ * Hits are allocations served by a thread cache, misses those which had
+ * to refill the cache from the shared depot. Outstanding chunks are those
+ * out of the depot (in use or held by thread caches): the high-water mark
+ * is their maximum. Invalid chunks are those given back which don't
+ * belong to the pool (they are ignored).\n
+ * Hits are accumulated by threads and added to the totals whenever they
+ * access the depot: so they lag behind by at most a cache size.
+ */
+struct MemoryPoolStats
+{
+	unsigned int mChunkSize, mBlocks;
+	unsigned long int mHits, mMisses, mOutstanding, mHighWater, mTrimmed,
+			mInvalid;
+};
+
+/**
+ * \brief Thread-safe pool of fixed size chunks.
+ *
+ * Every thread allocates from (and frees to) its own free-list cache,
+ * without locking. An empty cache is refilled with a batch of chunks
+ * from the shared depot (a MemoryPool) and a full cache gives half of
+ * its chunks back to it: only these transfers lock the depot.\n
+ * A thread cache is given back to the depot when its thread exits.\n
+ * Trim() releases the depot blocks whose chunks are all free: the depot
+ * keeps the free count of each block, so it costs a scan of the blocks
+ * unless there are some to release. Auto trimming (off by default) calls
+ * it whenever chunks are given back to the depot.
+ */
+class ConcurrentMemoryPool
+{
+public:
+	ConcurrentMemoryPool();
+	~ConcurrentMemoryPool();
+
+	/**
+	 * \brief Initializes the pool.
+	 * @param chunkSize Chunk size (at least a pointer size).
+	 * @param numChunks Number of chunks of a depot block.
+	 * @param cacheSize Maximum number of chunks of a thread cache.
+	 * @return False on error.
+	 */
+	bool init(unsigned int chunkSize, unsigned int numChunks,
+			unsigned int cacheSize);
+
+	///@{
+	void* alloc();
+	void free(void* pMem);
+	///@}
+
+	///@{
+	unsigned int trim();
+	void setAutoTrim(bool enable);
+	MemoryPoolStats getStats();
+	unsigned int getChunkSize() const;
+	///@}
+
+	///Maximum number of pools (i.e. thread cache slots).
+	static const unsigned int MAX_POOLS = 32;
+
+private:
+	///The per thread cache.
+	struct ThreadCache
+	{
+		void* mHead;
+		unsigned int mCount;
+		unsigned long int mHits;
+	};
+	ThreadCache& doGetCache();
+	void doRefill(ThreadCache& cache);
+	void doDrain(ThreadCache& cache, unsigned int num);
+	static void doCreateCachesKey();
+	static void doReleaseThreadCaches(void* caches);
+
+	///The depot and its mutex.
+	MemoryPool mDepot;
+	Mutex mMutex;
+	unsigned int mChunkSize, mCacheSize;
+	bool mAutoTrim;
+	///Thread cache slot.
+	int mSlot;
+	MemoryPoolStats mStats;
+
+	// don't allow copy
+	ConcurrentMemoryPool(const ConcurrentMemoryPool&);
+	ConcurrentMemoryPool& operator=(const ConcurrentMemoryPool&);
+};
+
+/**
+ * \brief Size class pools used by the MemoryPool-ed classes.
+ *
+ * A request is served by the pool of the smallest size class not
+ * less than its size, while bigger requests use the global heap.
+ */
+class SizeClassPools
+{
+public:
+	///@{
+	static void* alloc(size_t size);
+	static void free(void* pMem, size_t size);
+	///@}
+
+	/**
+	 * \name Configuration and statistics.
+	 */
+	///@{
+	static unsigned int getNumSizeClasses();
+	static MemoryPoolStats getStats(unsigned int sizeClass);
+	static unsigned int trim();
+	static void setAutoTrim(bool enable);
+	///@}
+
+private:
+	static ConcurrentMemoryPool* doGetPool(size_t size);
+	static ConcurrentMemoryPool* doGetPools();
+	static ConcurrentMemoryPool* doCreatePools();
+};
+
+///inline definitions
+
+inline unsigned int ConcurrentMemoryPool::getChunkSize() const
+{
+	return mChunkSize;
+}
+
+} // namespace ely
+
+#endif /* CONCURRENTMEMORYPOOL_H_ */
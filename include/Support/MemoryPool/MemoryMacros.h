@@ -152,4 +152,21 @@ static _className_ ## _AutoInitializedMemoryPool s_ ## _className_ ## _AutoIniti
 
 #define GCC_MEMORYPOOL_AUTOINIT(_className_, _numChunks_) GCC_MEMORYPOOL_AUTOINIT_DEBUGNAME(_className_, _numChunks_, #_className_)
 
+//---------------------------------------------------------------------------------------------------------------------
+// This macro is placed inside the body of a (base) class whose objects, and those of all its derived classes, should
+// be allocated through the thread-safe size class pools (see ConcurrentMemoryPool.h): no definition or initialization
+// is needed.  The sized delete operator gives each object back to the pool of its own size class.
+//---------------------------------------------------------------------------------------------------------------------
+#define ELY_MEMORYPOOL_OPERATORS \
+    public: \
+        static void* operator new(size_t size) \
+        { \
+            return ely::SizeClassPools::alloc(size); \
+        } \
+        static void operator delete(void* pPtr, size_t size) \
+        { \
+            ely::SizeClassPools::free(pPtr, size); \
+        } \
+    private: \
+
 #endif /* MEMORYMACROS_H_ */
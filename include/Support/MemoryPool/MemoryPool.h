@@ -78,7 +78,8 @@ namespace ely
 //--------------------------------------------------------------------------------------------------
 class MemoryPool
 {
-	unsigned char** m_ppRawMemoryArray;  // an array of memory blocks, each split up into chunks and connected
+	unsigned char** m_ppRawMemoryArray;  // an array of memory blocks (sorted by address), each split up into chunks and connected
+	unsigned int* m_pFreeCounts;  // the number of free chunks of each block
 	unsigned char* m_pHead;  // the front of the memory chunk linked list
 	unsigned int m_chunkSize, m_numChunks;  // the size of each chunk and number of chunks per array, respectively
 	unsigned int m_memArraySize;  // the number elements in the memory array
@@ -99,8 +100,15 @@ public:
 	
 	// allocation functions
 	void* Alloc(void);
-	void Free(void* pMem);
+	bool Free(void* pMem);  // false (and ignored) if pMem doesn't belong to the pool
 	unsigned int GetChunkSize(void) const { return m_chunkSize; }
+	unsigned int GetNumChunksPerBlock(void) const { return m_numChunks; }
+	unsigned int GetNumBlocks(void) const { return m_memArraySize; }
+
+	// releases the blocks whose chunks are all free, returns their number
+	// (it walks the free list only if there are any)
+	unsigned int Trim(void);
+	unsigned int GetNumFreeBlocks(void) const;
 	
 	// settings
 	void SetAllowResize(bool toAllowResize) { m_toAllowResize = toAllowResize; }
@@ -124,6 +132,8 @@ private:
 	unsigned char* AllocateNewMemoryBlock(void);
 	
 	// internal linked list management
+	// the index of the block of a chunk (by binary search), -1 if none
+	int FindBlock(unsigned char* pChunk) const;
 	unsigned char* GetNext(unsigned char* pBlock);
 	void SetNext(unsigned char* pBlockToChange, unsigned char* pNewNext);
 	
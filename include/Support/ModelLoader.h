@@ -0,0 +1,128 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/Support/ModelLoader.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef MODELLOADER_H_
+#define MODELLOADER_H_
+
+#include "Utilities/Tools.h"
+#include <nodePath.h>
+#include <filename.h>
+#include <asyncTask.h>
+#include <pmutex.h>
+#include <set>
+
+namespace ely
+{
+
+/**
+ * \brief Model (and animation) files loader with a shared cache and
+ * loader threads.
+ *
+ * Every file is read and parsed once: the parsed model is kept into
+ * Panda's ModelPool and every load returns a copy of it, which can be
+ * freely modified (e.g. reparented or bound to animations).\n
+ * loadModel() is thread safe, so it can be called by tasks dispatched
+ * with dispatch() to the loader threads.
+ */
+class ModelLoader: public ReferenceCount
+{
+public:
+	/**
+	 * \brief Constructor.
+	 * @param name The name (used for the loader task chain).
+	 * @param numThreads Number of loader threads.
+	 */
+	ModelLoader(const std::string& name, int numThreads);
+	virtual ~ModelLoader();
+
+	/**
+	 * \brief Loads a model file (from the cache if already loaded).
+	 * @param fileName The model file.
+	 * @return A copy of the loaded model (empty on error).
+	 */
+	NodePath loadModel(const Filename& fileName);
+
+	/**
+	 * \brief Executes a task on a loader thread.
+	 * @param task The task.
+	 */
+	void dispatch(AsyncTask* task);
+
+	/**
+	 * \brief Waits for dispatched tasks and stops loader threads.
+	 */
+	void cleanup();
+
+	/**
+	 * \name Cache management.
+	 *
+	 * Only the files loaded by this loader are released from the pool.
+	 */
+	///@{
+	void clearCache();
+	unsigned int getCacheSize();
+	unsigned long int getCacheHits();
+	unsigned long int getCacheMisses();
+	///@}
+
+private:
+	///Name.
+	std::string mName;
+	///The files loaded into the ModelPool.
+	std::set<std::string> mFiles;
+	///Protects the files and the counters.
+	Mutex mCacheMutex;
+	///Cache counters.
+	unsigned long int mCacheHits, mCacheMisses;
+	///Loader task chain.
+	std::string mTaskChainName;
+
+	///TypedObject semantics: hardcoded
+public:
+	static TypeHandle get_class_type()
+	{
+		return _type_handle;
+	}
+	static void init_type()
+	{
+		ReferenceCount::init_type();
+		register_type(_type_handle, "ModelLoader",
+				ReferenceCount::get_class_type());
+	}
+	virtual TypeHandle get_type() const
+	{
+		return get_class_type();
+	}
+	virtual TypeHandle force_init_type()
+	{
+		init_type();
+		return get_class_type();
+	}
+
+private:
+	static TypeHandle _type_handle;
+};
+
+} // namespace ely
+
+#endif /* MODELLOADER_H_ */
@@ -33,6 +33,8 @@
 #include <OpenSteer/PolylineSegmentedPathwaySingleRadius.h>
 #include "SimpleVehicle.h"
 #include "DrawMeshDrawer.h"
+#include "Support/MemoryPool/ConcurrentMemoryPool.h"
+#include "Support/MemoryPool/MemoryMacros.h"
 
 extern ely::DrawMeshDrawer *gDrawer3d, *gDrawer2d;
 extern ReMutex gOpenSteerDebugMutex;
@@ -240,6 +242,9 @@ protected:
 	VehicleSettings m_settings;
 	///The vehicle start position.
 	OpenSteer::Vec3 m_start;
+
+	///MemoryPool semantics: hardcoded
+	ELY_MEMORYPOOL_OPERATORS
 };
 
 //Obstacles: redefinition of draw
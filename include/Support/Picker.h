@@ -38,6 +38,8 @@ namespace ely
  * \brief A class for picking (physics) objects.
  *
  * \note Bullet based.
+ * \note Without a window (headless mode) there is no mouse: the Picker
+ * does nothing.
  */
 class Picker: public Singleton<Picker>
 {
@@ -0,0 +1,317 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/Support/Profiler.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include "Utilities/Tools.h"
+#include <atomicAdjust.h>
+#include <typedObject.h>
+#include <pStatCollector.h>
+#include <pmutex.h>
+#include <vector>
+#include <map>
+
+namespace ely
+{
+
+/**
+ * \brief Singleton hierarchical frame profiler.
+ *
+ * Threads open and close zones (identified by registered names) with
+ * begin()/end() or, better, with the ProfileScope and ProfileTypeBatch
+ * helpers and the PROFILE_ZONE macro. Each thread writes its events into
+ * its own single producer/single consumer ring, without locking.\n
+ * Once per frame the collector task drains the rings, pairs the events
+ * into nested zones and stores them into a ring of recent frames, which
+ * can be queried or exported as a Chrome trace (JSON, for chrome://tracing).
+ * Optionally each zone also drives the PStats collector with its name.\n
+ * The profiler is disabled by default: then a zone costs only the test of
+ * a flag.
+ */
+class Profiler: public Singleton<Profiler>
+{
+public:
+	typedef int ZoneId;
+
+	/**
+	 * \brief Constructor.
+	 * @param numFrames The recent frames kept.
+	 * @param ringSize The events of a thread's ring (a power of 2).
+	 * @param sort The collector task sort (should be after the managers').
+	 * @param priority The collector task priority.
+	 */
+	Profiler(unsigned int numFrames = 120, unsigned int ringSize = 16384,
+			int sort = 30, int priority = 0);
+	virtual ~Profiler();
+
+	/**
+	 * \name Runtime enabling.
+	 */
+	///@{
+	void setEnabled(bool enable);
+	bool isEnabled() const;
+	///@}
+
+	/**
+	 * \name Zone ids (can be registered without a Profiler too).
+	 */
+	///@{
+	static ZoneId registerZone(const std::string& name);
+	static std::string getZoneName(ZoneId id);
+	///The zone named after a type (cached per thread).
+	ZoneId getTypeZone(TypeHandle type);
+	///@}
+
+	/**
+	 * \name Zone events of the current thread.
+	 */
+	///@{
+	void begin(ZoneId id);
+	void end(ZoneId id);
+	///@}
+
+	/**
+	 * \brief A closed zone.
+	 */
+	struct Zone
+	{
+		ZoneId mId;
+		///The thread (ring) index and the nesting depth.
+		int mThread, mDepth;
+		///Times in seconds.
+		double mStart, mEnd;
+	};
+	/**
+	 * \brief A frame: the zones closed during it.
+	 */
+	struct Frame
+	{
+		unsigned long int mNumber;
+		double mStart, mEnd;
+		std::vector<Zone> mZones;
+	};
+
+	/**
+	 * \brief Drains the threads' rings into a new frame.
+	 *
+	 * Called once per frame by the collector task.
+	 */
+	void collect();
+
+	/**
+	 * \brief Collector task.
+	 */
+	AsyncTask::DoneStatus update(GenericAsyncTask* task);
+
+	/**
+	 * \name Recorded frames.
+	 */
+	///@{
+	///Copies the recent frames, the oldest first.
+	void getFrames(std::vector<Frame>& frames);
+	///Writes the recent frames in the Chrome trace event format.
+	bool writeChromeTrace(const std::string& fileName);
+	///@}
+
+	/**
+	 * \name Enables/disables driving the PStats collectors.
+	 */
+	///@{
+	void setPStatsBridge(bool enable);
+	bool getPStatsBridge() const;
+	///@}
+
+	/**
+	 * \brief Statistics.
+	 */
+	struct ProfilerStats
+	{
+		unsigned long int mFrames, mZones, mDropped;
+		unsigned int mThreads;
+	};
+	ProfilerStats getStats();
+
+private:
+	///An event: a begin (mId >= 0) or an end (~mId).
+	struct Event
+	{
+		double mTime;
+		ZoneId mId;
+	};
+	///A thread's ring: written by the thread, read by the collector.
+	struct ThreadRing
+	{
+		int mThread;
+		std::vector<Event> mEvents;
+		AtomicAdjust::Integer mHead, mTail, mDropped;
+		///Thread only: the type zones' cache.
+		std::map<int, ZoneId> mTypeZones;
+		///Collector only: the open zones.
+		std::vector<Event> mOpen;
+	};
+	std::vector<ThreadRing*> mRings;
+	Mutex mRingsMutex;
+	unsigned int mRingMask;
+	ThreadRing* doGetThreadRing();
+	void doPush(Event event);
+	int mSerial;
+
+	///Frames' ring.
+	std::vector<Frame> mFrames;
+	unsigned long int mNumFrames;
+	double mFrameStart;
+
+	AtomicAdjust::Integer mEnabled, mPStatsBridge;
+	///Lazily created PStats collectors, by zone.
+	static const int MAX_PSTATS_ZONES = 4096;
+	AtomicAdjust::Pointer mPStatsCollectors[MAX_PSTATS_ZONES];
+	PStatCollector* doGetPStatsCollector(ZoneId id);
+
+	ProfilerStats mStats;
+
+	///@{
+	///A task data for collecting.
+	SMARTPTR(TaskInterface<Profiler>::TaskData) mUpdateData;
+	SMARTPTR(AsyncTask) mUpdateTask;
+	///@}
+
+	///Protects the frames.
+	Mutex mMutex;
+};
+
+/**
+ * \brief Opens a zone until the end of the scope (if profiling).
+ */
+class ProfileScope
+{
+public:
+	ProfileScope(Profiler::ZoneId id);
+	~ProfileScope();
+private:
+	Profiler* mProfiler;
+	Profiler::ZoneId mId;
+};
+
+/**
+ * \brief Opens a zone (named after the type) for each run of objects of
+ * the same type in an update loop, until the end of the scope.
+ */
+class ProfileTypeBatch
+{
+public:
+	ProfileTypeBatch();
+	~ProfileTypeBatch();
+	void next(TypedObject* object);
+	///Closes the current zone (before the end of the scope).
+	void end();
+private:
+	Profiler* mProfiler;
+	Profiler::ZoneId mId;
+	int mTypeIndex;
+};
+
+///Opens a zone with a (constant) name until the end of the scope.
+#define ELY_PROFILE_CONCAT_IMPL(_a_,_b_) _a_##_b_
+#define ELY_PROFILE_CONCAT(_a_,_b_) ELY_PROFILE_CONCAT_IMPL(_a_,_b_)
+#define PROFILE_ZONE(_name_) \
+	static const ely::Profiler::ZoneId ELY_PROFILE_CONCAT(profileZone,__LINE__) =\
+	ely::Profiler::registerZone(_name_);\
+	ely::ProfileScope ELY_PROFILE_CONCAT(profileScope,__LINE__)(\
+	ELY_PROFILE_CONCAT(profileZone,__LINE__))
+
+///inline definitions
+
+inline bool Profiler::isEnabled() const
+{
+	return AtomicAdjust::get(mEnabled) != 0;
+}
+
+inline bool Profiler::getPStatsBridge() const
+{
+	return AtomicAdjust::get(mPStatsBridge) != 0;
+}
+
+inline ProfileScope::ProfileScope(Profiler::ZoneId id) :
+		mProfiler(Profiler::GetSingletonPtr()), mId(id)
+{
+	if (mProfiler and mProfiler->isEnabled())
+	{
+		mProfiler->begin(mId);
+	}
+	else
+	{
+		mProfiler = NULL;
+	}
+}
+
+inline ProfileScope::~ProfileScope()
+{
+	if (mProfiler)
+	{
+		mProfiler->end(mId);
+	}
+}
+
+inline ProfileTypeBatch::ProfileTypeBatch() :
+		mProfiler(Profiler::GetSingletonPtr()), mId(-1), mTypeIndex(-1)
+{
+	if (mProfiler and (not mProfiler->isEnabled()))
+	{
+		mProfiler = NULL;
+	}
+}
+
+inline ProfileTypeBatch::~ProfileTypeBatch()
+{
+	end();
+}
+
+inline void ProfileTypeBatch::end()
+{
+	if (mProfiler and (mId != -1))
+	{
+		mProfiler->end(mId);
+		mId = mTypeIndex = -1;
+	}
+}
+
+inline void ProfileTypeBatch::next(TypedObject* object)
+{
+	RETURN_ON_COND(not mProfiler,)
+
+	TypeHandle type = object->get_type();
+	RETURN_ON_COND(type.get_index() == mTypeIndex,)
+
+	if (mId != -1)
+	{
+		mProfiler->end(mId);
+	}
+	mTypeIndex = type.get_index();
+	mId = mProfiler->getTypeZone(type);
+	mProfiler->begin(mId);
+}
+
+} // namespace ely
+
+#endif /* PROFILER_H_ */
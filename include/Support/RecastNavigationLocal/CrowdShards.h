@@ -0,0 +1,245 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/Support/RecastNavigationLocal/CrowdShards.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef CROWDSHARDS_H_
+#define CROWDSHARDS_H_
+
+#include <DetourNavMesh.h>
+#ifndef WITHCHARACTER
+#	include <DetourCrowd.h>
+#else
+#	include <DetourCrowdPhysics.h>
+#endif
+#include <asyncTask.h>
+#include <string>
+#include <vector>
+
+namespace ely
+{
+
+/**
+ * \brief Crowd simulation partitioned into spatial shards.
+ *
+ * The navigation mesh bounds are split into strips along their longest
+ * horizontal axis: each strip (shard) is simulated by its own dtCrowd over
+ * the same (read only) dtNavMesh, so shards can be updated in parallel by
+ * the threads of a task chain.\n
+ * Agents are addressed by stable indexes, independent of the shard they
+ * currently belong to:
+ * - an agent that leaves its strip (by more than its radius) migrates to
+ * the shard containing it, keeping its parameters, velocity and move
+ * request;
+ * - an agent whose collision query range crosses a strip boundary is
+ * mirrored as a passive "ghost" agent (no path following, current
+ * velocity) into the neighbor shards, so agents near a boundary avoid each
+ * other as in a single crowd.
+ *
+ * Ghosts live into a capacity reserved for them in each shard's crowd (so
+ * they never take room from owned agents) and are persistent: a ghost is
+ * updated in place on every update while its agent stays near the
+ * boundary, and is removed only when the agent moves away (or into the
+ * ghost's shard). Ghosts that don't fit into a full neighbor shard are
+ * dropped and counted (see getNumDroppedGhosts()), like the migrations
+ * deferred because the destination shard is full.
+ *
+ * \note The dtNavMesh must not be modified during update().
+ */
+class CrowdShards
+{
+public:
+	CrowdShards();
+	~CrowdShards();
+
+	/**
+	 * \brief Creates the shards.
+	 * @param numShards The number of shards.
+	 * @param maxAgents The maximum number of agents of each shard.
+	 * @param maxGhosts The maximum number of ghost agents of each shard.
+	 * @param maxAgentRadius The maximum agent radius.
+	 * @param nav The navigation mesh.
+	 * @param prototype The crowd whose query filters and obstacle avoidance
+	 * params are copied into the shards.
+	 * @param bmin, bmax The navigation mesh bounds.
+	 * @param numThreads The number of update threads (0 for updating into
+	 * the calling thread).
+	 * @param name The name of the task chain.
+	 * @return True if successful, false otherwise.
+	 */
+	bool init(int numShards, int maxAgents, int maxGhosts,
+			float maxAgentRadius, dtNavMesh* nav, const dtCrowd* prototype,
+			const float* bmin, const float* bmax, int numThreads,
+			const std::string& name);
+	void cleanup();
+
+	/**
+	 * \name Agents (dtCrowd like) interface.
+	 */
+	///@{
+	int addAgent(const float* pos, const dtCrowdAgentParams* params);
+	void removeAgent(int idx);
+	bool updateAgentParameters(int idx, const dtCrowdAgentParams* params);
+	bool requestMoveTarget(int idx, dtPolyRef ref, const float* pos);
+	bool requestMoveVelocity(int idx, const float* vel);
+	const dtCrowdAgent* getAgent(int idx) const;
+	int getAgentCount() const;
+	///@}
+
+	/**
+	 * \brief Migrates agents, updates the shards and mirrors the agents
+	 * near boundaries.
+	 * @param dt The delta time.
+	 */
+	void update(float dt);
+
+	/**
+	 * \name Statistics.
+	 */
+	///@{
+	int getNumShards() const;
+	int getShardAgentCount(int shard) const;
+	dtCrowd* getShardCrowd(int shard) const;
+	///Total migrations since init().
+	unsigned int getNumMigrations() const;
+	///Ghost agents of the last update.
+	unsigned int getNumGhosts() const;
+	///Ghost agents not mirrored, because of full shards, by the last update.
+	unsigned int getNumDroppedGhosts() const;
+	///Migrations deferred because of full shards, since init().
+	unsigned int getNumDeferredMigrations() const;
+	///@}
+
+private:
+	///An agent: its location and its last move request.
+	struct Agent
+	{
+		enum Request
+		{
+			NONE, TARGET, VELOCITY
+		};
+		int mShard, mIdx;
+		Request mRequest;
+		dtPolyRef mTargetRef;
+		float mTarget[3];
+	};
+	std::vector<Agent> mAgents;
+	std::vector<int> mFreeAgents;
+
+	///A shard: its crowd, its strip, its (crowd index -> agent) tables, for
+	///owned agents and ghosts, and its (agent -> ghost crowd index) table.
+	struct Shard
+	{
+		dtCrowd* mCrowd;
+		float mMin, mMax;
+		std::vector<int> mOwners, mGhostOwners;
+		///The last update a ghost has been mirrored.
+		std::vector<unsigned int> mGhostStamps;
+		std::vector<int> mGhostOf;
+		int mNumAgents, mNumGhosts;
+	};
+	std::vector<Shard> mShards;
+	int mMaxAgents, mMaxGhosts;
+	///Current update.
+	unsigned int mStamp;
+	///Strips' axis (0 = x, 2 = z).
+	int mAxis;
+	float mBoundMin, mStripSize;
+
+	///Update threads.
+	std::string mTaskChainName;
+	int mNumThreads;
+	class UpdateTask: public AsyncTask
+	{
+	public:
+		UpdateTask(CrowdShards* shards, int shard, float dt);
+		virtual DoneStatus do_task();
+	private:
+		CrowdShards* mShards;
+		int mShard;
+		float mDt;
+	};
+	friend class UpdateTask;
+
+	///Statistics.
+	unsigned int mNumMigrations, mNumGhosts, mNumDroppedGhosts,
+			mNumDeferredMigrations;
+
+	///Helpers.
+	int doGetShard(const float* pos) const;
+	void doMigrate();
+	void doMirrorAgents();
+	bool doMirror(int idx, const dtCrowdAgent* ag, int shard);
+	void doRemoveGhost(Shard& shard, int ghostIdx);
+	void doRemoveStaleGhosts();
+	bool doMoveAgent(int idx, int shard);
+	static dtCrowdAgent* doEditAgent(dtCrowd* crowd, int idx);
+
+	// don't allow copy
+	CrowdShards(const CrowdShards&);
+	CrowdShards& operator=(const CrowdShards&);
+};
+
+///inline definitions
+
+inline int CrowdShards::getNumShards() const
+{
+	return (int) mShards.size();
+}
+
+inline int CrowdShards::getShardAgentCount(int shard) const
+{
+	return mShards[shard].mNumAgents;
+}
+
+inline dtCrowd* CrowdShards::getShardCrowd(int shard) const
+{
+	return mShards[shard].mCrowd;
+}
+
+inline int CrowdShards::getAgentCount() const
+{
+	return (int) mAgents.size();
+}
+
+inline unsigned int CrowdShards::getNumMigrations() const
+{
+	return mNumMigrations;
+}
+
+inline unsigned int CrowdShards::getNumGhosts() const
+{
+	return mNumGhosts;
+}
+
+inline unsigned int CrowdShards::getNumDroppedGhosts() const
+{
+	return mNumDroppedGhosts;
+}
+
+inline unsigned int CrowdShards::getNumDeferredMigrations() const
+{
+	return mNumDeferredMigrations;
+}
+
+} // namespace ely
+
+#endif /* CROWDSHARDS_H_ */
@@ -27,6 +27,8 @@
 #define CROWDTOOL_H
 
 #include "NavMeshType.h"
+#include "CrowdShards.h"
+#include <vector>
 
 namespace ely
 {
@@ -73,13 +75,16 @@ class CrowdToolState : public NavMeshTypeToolState
 	dtObstacleAvoidanceDebugData* m_vod;
 	
 	static const int AGENT_MAX_TRAIL = 64;
-	static const int MAX_AGENTS = 128;
 	struct AgentTrail
 	{
 		float trail[AGENT_MAX_TRAIL*3];
 		int htrail;
 	};
-	AgentTrail m_trails[MAX_AGENTS];
+	int m_maxAgents;
+	std::vector<AgentTrail> m_trails;
+	
+	// Optional partitioned crowds: when set agents live into them.
+	CrowdShards* m_shards;
 	
 //	ValueHistory m_crowdTotalTime;
 //	ValueHistory m_crowdSampleCount;
@@ -87,8 +92,14 @@ class CrowdToolState : public NavMeshTypeToolState
 	CrowdToolParams m_toolParams;
 
 	bool m_run;
+	
+	// Always available update timing (when enabled).
+	bool m_collectStats;
+	int m_updateTime;
 
 public:
+	static const int DEFAULT_MAX_AGENTS = 128;
+
 	CrowdToolState();
 	virtual ~CrowdToolState();
 	
@@ -101,10 +112,23 @@ public:
 	inline bool isRunning() const { return m_run; }
 	inline void setRunning(const bool s) { m_run = s; }
 	dtCrowd* getCrowd(){ return m_crowd; }
+	// Max agents (per crowd): takes effect at next init().
+	inline int getMaxAgents() const { return m_maxAgents; }
+	inline void setMaxAgents(const int maxAgents) { m_maxAgents = maxAgents; }
+	// Partitions agents into numShards crowds (like the current one).
+	bool initShards(int numShards, int numThreads, const std::string& name);
+	CrowdShards* getShards(){ return m_shards; }
+	// Timing of the last update (microseconds).
+	inline bool isCollectingStats() const { return m_collectStats; }
+	inline void setCollectStats(const bool s) { m_collectStats = s; m_updateTime = 0; }
+	inline int getUpdateTime() const { return m_updateTime; }
 	
+
 	int addAgent(const float* pos);
 	int addAgent(const float* p, const dtCrowdAgentParams* params);
 	void removeAgent(const int idx);
+	const dtCrowdAgent* getAgent(const int idx);
+	void updateAgentParameters(const int idx, const dtCrowdAgentParams* params);
 	void hilightAgent(const int idx);
 	void updateAgentParams();
 	int hitTestAgents(const float* s, const float* p);
@@ -135,9 +159,10 @@ class CrowdTool : public NavMeshTypeTool
 		TOOLMODE_TOGGLE_POLYS,
 	};
 	ToolMode m_mode;
+	int m_maxAgents;
 	
 public:
-	CrowdTool();
+	CrowdTool(int maxAgents = CrowdToolState::DEFAULT_MAX_AGENTS);
 	
 	CrowdToolState* getState(){return m_state;}
 
@@ -0,0 +1,261 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/Support/Replay.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include "Utilities/Tools.h"
+#include <pmutex.h>
+#include <fstream>
+#include <string>
+#include <map>
+
+namespace ely
+{
+
+/**
+ * \brief Singleton recording a game session into, or replaying it from, a
+ * compact binary stream.
+ *
+ * Once started (after the game world creation), for each frame it records:
+ * - the frame delta time;
+ * - the watched Panda events (those of the Control components and of the
+ * GUI hooks);
+ * - the pointer movements consumed by the Control components (by key);
+ * - the GUI events dispatched to the game;
+ * - the Objects created and destroyed at runtime through the
+ * ObjectTemplateManager.
+ *
+ * When replaying, at the start of each frame the recorded Objects are
+ * created/destroyed, the events are queued (and dispatched in the same
+ * frame), the recorded pointer movements and delta time are provided to
+ * the consumers and the GUI events are fed back (if there is a GUI).
+ * The stream is authoritative: runtime creations/destructions not coming
+ * from it are ignored.\n
+ * Replaying works both in headless and windowed mode; it collects the real
+ * frame times too, for comparing replay runs (i.e. benchmarks).
+ */
+class Replay: public Singleton<Replay>
+{
+public:
+	enum Mode
+	{
+		RECORDING, REPLAYING
+	};
+
+	/**
+	 * \brief Constructor.
+	 * @param mode Recording or replaying.
+	 * @param fileName The stream file.
+	 * @param sort The frame task sort (should be before the event one).
+	 * @param priority The frame task priority.
+	 */
+	Replay(Mode mode, const std::string& fileName, int sort = -10,
+			int priority = 0);
+	virtual ~Replay();
+
+	/**
+	 * \brief Starts recording/replaying.
+	 * @return True if the stream could be opened, false otherwise.
+	 */
+	bool start();
+
+	/**
+	 * \name Status.
+	 */
+	///@{
+	Mode getMode() const;
+	bool isRecording() const;
+	bool isReplaying() const;
+	///Replaying: the stream has been consumed.
+	bool isFinished() const;
+	///Replaying: sets the exit flag when the stream has been consumed.
+	void setExitAtEnd(bool exit);
+	///Replaying: true while applying recorded Objects' creations/destructions.
+	bool isApplying() const;
+	///@}
+
+	/**
+	 * \name Panda events recorded/replayed (a watch count is kept for each).
+	 */
+	///@{
+	static void watchEvent(const std::string& event);
+	static void unwatchEvent(const std::string& event);
+	///@}
+
+	/**
+	 * \brief Pointer movement consumed by a control component.
+	 *
+	 * Recording, the given movement (if any) is recorded; replaying, it is
+	 * replaced by the recorded one.
+	 * @param key The consumer key (e.g. its owner object id).
+	 * @param moved Whether there is a movement.
+	 * @param deltaX, deltaY The movement.
+	 */
+	static void pointerInput(const std::string& key, bool& moved,
+			float& deltaX, float& deltaY);
+
+	/**
+	 * \name GUI events.
+	 */
+	///@{
+	typedef void (*GUIEVENTHANDLER)(const std::string& value,
+			const ParameterTable& params);
+	///The handler the GUI events are fed back to.
+	void setGuiEventHandler(GUIEVENTHANDLER handler);
+	void recordGuiEvent(const std::string& value, const ParameterTable& params);
+	///@}
+
+	/**
+	 * \name Objects' runtime creations/destructions.
+	 */
+	///@{
+	void recordSpawn(const std::string& objectType, const std::string& objectId,
+			const ParameterTable& objectParams,
+			const ParameterTableMap& componentsParams, bool storeParams,
+			const std::string& ownerId);
+	void recordDestroy(const std::string& objectId);
+	///@}
+
+	/**
+	 * \brief Replaying: the recorded delta time of the current frame.
+	 */
+	float getFrameDt() const;
+
+	/**
+	 * \brief Frame task.
+	 */
+	AsyncTask::DoneStatus update(GenericAsyncTask* task);
+
+	/**
+	 * \brief Statistics: frames and real frame times (in seconds).
+	 */
+	struct ReplayStats
+	{
+		unsigned long int mFrames;
+		double mTotalTime, mMinFrameTime, mMaxFrameTime;
+	};
+	ReplayStats getStats() const;
+
+private:
+	///Record types.
+	enum RecordType
+	{
+		FRAME = 1, EVENT, POINTER, GUI, SPAWN, DESTROY
+	};
+
+	Mode mMode;
+	std::string mFileName;
+	bool mStarted, mFinished, mExitAtEnd, mApplying;
+
+	///Recording: the current frame's records and the stream.
+	std::string mBuffer;
+	std::ofstream mOut;
+	void doWriteUInt(unsigned int value);
+	void doWriteFloat(float value);
+	void doWriteString(const std::string& value);
+	void doWriteParams(const ParameterTable& params);
+
+	///Replaying: the whole stream and the read position.
+	std::string mData;
+	unsigned int mPos;
+	bool doReadUInt(unsigned int& value);
+	bool doReadFloat(float& value);
+	bool doReadString(std::string& value);
+	bool doReadParams(ParameterTable& params);
+	bool doReplayFrame();
+
+	///Watched events.
+	std::map<std::string, int> mWatchedEvents;
+	static void doRecordEvent(const Event* event, void* data);
+
+	///Replaying: the current frame's pointer movements and delta time.
+	std::map<std::string, std::pair<float, float> > mPointers;
+	float mFrameDt;
+
+	GUIEVENTHANDLER mGuiEventHandler;
+
+	///Statistics.
+	ReplayStats mStats;
+	double mLastTime;
+
+	///@{
+	///A task data for the frames.
+	SMARTPTR(TaskInterface<Replay>::TaskData) mUpdateData;
+	SMARTPTR(AsyncTask) mUpdateTask;
+	///@}
+
+	///Protects the records.
+	Mutex mMutex;
+};
+
+///inline definitions
+
+inline Replay::Mode Replay::getMode() const
+{
+	return mMode;
+}
+
+inline bool Replay::isRecording() const
+{
+	return mStarted and (mMode == RECORDING);
+}
+
+inline bool Replay::isReplaying() const
+{
+	return mStarted and (mMode == REPLAYING) and (not mFinished);
+}
+
+inline bool Replay::isFinished() const
+{
+	return mFinished;
+}
+
+inline void Replay::setExitAtEnd(bool exit)
+{
+	mExitAtEnd = exit;
+}
+
+inline bool Replay::isApplying() const
+{
+	return mApplying;
+}
+
+inline void Replay::setGuiEventHandler(GUIEVENTHANDLER handler)
+{
+	mGuiEventHandler = handler;
+}
+
+inline float Replay::getFrameDt() const
+{
+	return mFrameDt;
+}
+
+inline Replay::ReplayStats Replay::getStats() const
+{
+	return mStats;
+}
+
+} // namespace ely
+
+#endif /* REPLAY_H_ */
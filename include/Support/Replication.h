@@ -0,0 +1,283 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/Support/Replication.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef REPLICATION_H_
+#define REPLICATION_H_
+
+#include "Utilities/Tools.h"
+#include "ObjectModel/Object.h"
+#include "Support/ReplicationCodec.h"
+#include <queuedConnectionManager.h>
+#include <queuedConnectionReader.h>
+#include <connectionWriter.h>
+#include <netAddress.h>
+#include <datagram.h>
+#include <datagramIterator.h>
+#include <netDatagram.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+
+namespace ely
+{
+
+/**
+ * \brief Server authoritative replication of Objects' state over UDP.
+ *
+ * The server replicates a set of Objects, each with its own fields: the
+ * NodePath transform (wrt the scene root), the CrowdAgent move velocity and
+ * the Activity (FSM) state.\n
+ * At the send rate, for each client the server sends a snapshot of the
+ * Objects relevant to it (within a radius of the client viewpoint, found
+ * through the InterestGrid if any), with the fields quantized and delta
+ * compressed against the last snapshot acknowledged by the client (see
+ * ReplicationCodec), split into datagrams of at most the max packet size.\n
+ * The client acknowledges the snapshots (sending its viewpoint too),
+ * creates/destroys the replicated Objects as needed and interpolates their
+ * state between snapshots, a delay behind the server time: transforms and
+ * FSM states are applied, velocities can be queried.\n
+ * Both sides keep bandwidth statistics (per client on the server). Server
+ * and client can run in the same process (e.g. over the loopback).
+ * \note The quantization steps must be the same on both sides.
+ */
+class Replication: public ReplicationCodec
+{
+public:
+	enum Mode
+	{
+		SERVER, CLIENT
+	};
+
+	/**
+	 * \brief Replication settings.
+	 */
+	struct Settings
+	{
+		Settings();
+		///Server: the listening port; client: the server one.
+		int mPort;
+		///Client: the server host and the own port (0 = any).
+		std::string mServerHost;
+		int mClientPort;
+		///Snapshots (server) or acknowledgments (client) per second.
+		float mSendRate;
+		///Server: the relevance radius around a client viewpoint (<= 0 = all).
+		float mRelevanceRadius;
+		///Quantization steps: position, angle (degrees), velocity.
+		float mPositionStep, mAngleStep, mVelocityStep;
+		///Client: the interpolation delay (seconds).
+		float mInterpolationDelay;
+		///Snapshots kept as delta baselines.
+		unsigned int mHistory;
+		///Server: seconds without acknowledgments before dropping a client.
+		float mClientTimeout;
+		///Server: the snapshot datagrams' max size (bytes, <= 65507).
+		unsigned int mMaxPacketSize;
+	};
+
+	/**
+	 * \brief Constructor.
+	 * @param mode Server or client.
+	 * @param settings The settings.
+	 * @param sort The update task sort (should be after the managers').
+	 * @param priority The update task priority.
+	 */
+	Replication(Mode mode, const Settings& settings = Settings(), int sort = 35,
+			int priority = 0);
+	virtual ~Replication();
+
+	/**
+	 * \brief Opens the UDP connection and starts the update task.
+	 * @return True on success, false otherwise.
+	 */
+	bool start();
+
+	/**
+	 * \name Server: replicated Objects.
+	 */
+	///@{
+	void addObject(const ObjectId& objectId, unsigned int fields = ALL_FIELDS);
+	void removeObject(const ObjectId& objectId);
+	///@}
+
+	/**
+	 * \name Client.
+	 */
+	///@{
+	///Sets the viewpoint sent to the server (for relevance).
+	void setViewpoint(const LPoint3f& viewpoint);
+	///Gets the interpolated state of a replicated Object.
+	bool getObjectState(const ObjectId& objectId, LPoint3f& pos,
+			LVecBase3f& hpr, LVector3f& velocity, std::string& fsmState) const;
+	///@}
+
+	/**
+	 * \brief Update task.
+	 */
+	AsyncTask::DoneStatus update(GenericAsyncTask* task);
+
+	/**
+	 * \brief Statistics: totals and bytes per second (over the last second).
+	 */
+	struct ReplicationStats
+	{
+		unsigned long int mBytesSent, mBytesReceived, mPacketsSent,
+				mPacketsReceived, mPacketsDropped;
+		float mBytesPerSecondSent, mBytesPerSecondReceived;
+		unsigned int mObjects, mClients;
+	};
+	ReplicationStats getStats() const;
+
+	/**
+	 * \brief Server: per client statistics.
+	 */
+	struct ClientStats
+	{
+		std::string mAddress;
+		unsigned long int mBytesSent, mSnapshots;
+		float mBytesPerSecond;
+		unsigned int mRelevantObjects, mLastSnapshotSize;
+	};
+	std::vector<ClientStats> getClientStats() const;
+
+private:
+	Mode mMode;
+	Settings mSettings;
+	bool mStarted;
+	double mSendTime;
+
+	///Packet types.
+	enum PacketType
+	{
+		SNAPSHOT = 1, ACK
+	};
+
+	///Network.
+	///@{
+	QueuedConnectionManager mManager;
+	QueuedConnectionReader mReader;
+	ConnectionWriter mWriter;
+	PT(Connection) mConnection;
+	bool doSend(const Datagram& dg, const NetAddress& address, double now);
+	///@}
+
+	///Bytes per second window.
+	struct RateWindow
+	{
+		RateWindow();
+		void add(unsigned int bytes, double now);
+		unsigned long int mBytes;
+		double mStart;
+		float mRate;
+	};
+
+	///Server side.
+	///@{
+	struct ReplicatedObject
+	{
+		unsigned int mNetId, mFields;
+	};
+	std::map<ObjectId, ReplicatedObject> mObjects;
+	unsigned int mNextNetId;
+	struct Client
+	{
+		NetAddress mAddress;
+		LPoint3f mViewpoint;
+		unsigned int mSequence, mAckSequence;
+		double mLastHeard;
+		std::deque<std::pair<unsigned int, EntityStates> > mHistory;
+		ClientStats mStats;
+		RateWindow mRate;
+	};
+	std::map<std::string, Client> mClients;
+	void doServerReceive(double now);
+	void doServerSend(double now);
+	EntityState doQuantize(SMARTPTR(Object) object, unsigned int fields) const;
+	bool doIsNear(const EntityState& state, const LPoint3f& viewpoint,
+			float radius) const;
+	///@}
+
+	///Client side.
+	///@{
+	NetAddress mServerAddress;
+	LPoint3f mViewpoint;
+	unsigned int mLastSequence;
+	std::deque<std::pair<unsigned int, EntityStates> > mHistory;
+	///The parts received of the newest snapshot.
+	unsigned int mPartsSequence, mNumPartsReceived;
+	std::vector<NetDatagram> mParts;
+	///Server clock offset estimate.
+	double mServerTimeOffset;
+	bool mHasServerTime;
+	///Interpolation buffers, by Object id.
+	struct Sample
+	{
+		double mTime;
+		EntityState mState;
+	};
+	struct Interpolated
+	{
+		std::deque<Sample> mSamples;
+		LPoint3f mPos;
+		LVecBase3f mHpr;
+		LVector3f mVelocity;
+		std::string mFSMState;
+		bool mCreated;
+	};
+	std::map<ObjectId, Interpolated> mInterpolated;
+	void doClientReceive(double now);
+	bool doClientSnapshot(double now);
+	void doClientSend(double now);
+	void doClientInterpolate(double now);
+	void doApply(const ObjectId& objectId, Interpolated& interpolated,
+			unsigned int fields, const std::string& objectType);
+	///@}
+
+	///Statistics.
+	ReplicationStats mStats;
+	RateWindow mSentRate, mReceivedRate;
+
+	///@{
+	///A task data for the updates.
+	SMARTPTR(TaskInterface<Replication>::TaskData) mUpdateData;
+	SMARTPTR(AsyncTask) mUpdateTask;
+	int mSort, mPriority;
+	///@}
+};
+
+///inline definitions
+
+inline void Replication::setViewpoint(const LPoint3f& viewpoint)
+{
+	mViewpoint = viewpoint;
+}
+
+inline Replication::ReplicationStats Replication::getStats() const
+{
+	return mStats;
+}
+
+} // namespace ely
+
+#endif /* REPLICATION_H_ */
@@ -0,0 +1,107 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/Support/ReplicationCodec.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef REPLICATIONCODEC_H_
+#define REPLICATIONCODEC_H_
+
+#include "Utilities/Tools.h"
+#include <datagram.h>
+#include <datagramIterator.h>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace ely
+{
+
+/**
+ * \brief The snapshot codec of the Replication.
+ *
+ * The Objects' states are quantized and written against a baseline (the
+ * last snapshot acknowledged by the receiver): unchanged states are
+ * omitted, changed fields are written as variable length differences and
+ * the states no longer present are marked removed.\n
+ * A snapshot can be split in parts no bigger than a given size, each one
+ * readable by itself once the previous ones have been applied: the
+ * entries are never split.\n
+ * It doesn't depend on the Objects nor on the network, so it can be used
+ * (and tested) by itself.
+ */
+class ReplicationCodec
+{
+public:
+	///Replicated fields of an Object.
+	enum Field
+	{
+		TRANSFORM = 1 << 0,
+		VELOCITY = 1 << 1,
+		FSM_STATE = 1 << 2,
+		ALL_FIELDS = TRANSFORM | VELOCITY | FSM_STATE
+	};
+
+	/**
+	 * \brief Quantized state of a replicated Object (with its identity).
+	 */
+	struct EntityState
+	{
+		EntityState();
+		std::string mObjectId;
+		std::string mObjectType;
+		unsigned int mFields;
+		int mPos[3], mHpr[3], mVelocity[3];
+		std::string mFSMState;
+	};
+	///Snapshot: states by net id.
+	typedef std::map<unsigned int, EntityState> EntityStates;
+
+	/**
+	 * \name Snapshot codec.
+	 *
+	 * Writes/reads the states against a baseline (empty = none).
+	 */
+	///@{
+	static void writeDelta(const EntityStates& baseline,
+			const EntityStates& states, Datagram& dg);
+	static bool readDelta(const EntityStates& baseline, DatagramIterator& scan,
+			EntityStates& states);
+	///@}
+
+	/**
+	 * \name Split snapshot codec.
+	 *
+	 * Writes the states against a baseline in parts of at most maxPartSize
+	 * bytes (at least one part, an entry bigger than that goes alone);
+	 * reads a part into the states, which must be the baseline updated with
+	 * all the previous parts.
+	 */
+	///@{
+	static void writeDelta(const EntityStates& baseline,
+			const EntityStates& states, std::vector<Datagram>& parts,
+			unsigned int maxPartSize);
+	static bool applyDelta(DatagramIterator& scan, EntityStates& states);
+	///@}
+};
+
+} // namespace ely
+
+#endif /* REPLICATIONCODEC_H_ */
@@ -0,0 +1,180 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/Support/Snapshot.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include "Utilities/Tools.h"
+#include "ObjectModel/Object.h"
+#include <asyncTask.h>
+#include <datagram.h>
+#include <datagramIterator.h>
+#include <pmutex.h>
+#include <string>
+#include <list>
+#include <map>
+#include <set>
+
+namespace ely
+{
+
+/**
+ * \brief Binary snapshot of the whole game world (e.g. for save games,
+ * checkpoints and level restarts).
+ *
+ * A snapshot keeps a record for each created Object: its identity (id,
+ * type, owner), its stored creation parameters (if any, see
+ * ObjectTemplateManager::createObject()) and its runtime state as written by
+ * Object::write_datagram() (the transform and the Components' state, such as
+ * Bullet bodies, crowd agents and FSMs).\n
+ * Snapshots are incremental: take() only updates the records of the Objects
+ * changed since the previous one, and save() writes to a file a full chunk
+ * the first time, then only delta chunks (the changed and removed records)
+ * appended to it. Chunks are built on the main thread and written in order
+ * by a worker task chain.\n
+ * restore() applies the records in place: existing Objects are filled in,
+ * missing ones are (re)created and those not in the snapshot are destroyed,
+ * so no game world reload is needed. A missing Object can be recreated
+ * only if its creation parameters were stored: otherwise restore() reports
+ * it and refuses to change the game world.
+ * \note take() and restore() must be called from the main thread, between
+ * frames: take() serializes every created Object there (its cost grows with
+ * the game world, see SnapshotStats::mTakeTime), so it is meant for
+ * checkpoints rather than for every frame; only the file writing is done
+ * off-thread.
+ */
+class Snapshot
+{
+public:
+	/**
+	 * \brief Constructor.
+	 * @param name The name (of the worker task chain too).
+	 */
+	Snapshot(const std::string& name = "Snapshot");
+	virtual ~Snapshot();
+
+	/**
+	 * \brief Updates the records from the current game world.
+	 * @return The number of changed (or removed) records.
+	 */
+	unsigned int take();
+
+	/**
+	 * \brief Queues the records' writing to a file (done off-thread).
+	 *
+	 * A full chunk is written if the file differs from the last one saved
+	 * (or loaded), otherwise a delta chunk is appended.
+	 * @param fileName The file.
+	 */
+	void save(const std::string& fileName);
+
+	/**
+	 * \brief Waits until all queued saves have been written.
+	 */
+	void waitSaved();
+
+	/**
+	 * \brief Reads the records from a file (its chunks in order).
+	 * @return True if the file has been read, false otherwise.
+	 */
+	bool load(const std::string& fileName);
+
+	/**
+	 * \brief Applies the records to the current game world.
+	 * @return True if all records have been applied, false otherwise (the
+	 * game world is left untouched if a missing Object cannot be recreated).
+	 */
+	bool restore();
+
+	/**
+	 * \brief Removes all records.
+	 */
+	void clear();
+
+	/**
+	 * \brief Waits for the saves and removes the worker task chain.
+	 */
+	void cleanup();
+
+	/**
+	 * \brief Statistics (times in seconds).
+	 */
+	struct SnapshotStats
+	{
+		unsigned int mRecords, mChunks, mErrors;
+		///Missing Objects the last restore() couldn't recreate.
+		unsigned int mUnrestorable;
+		unsigned long int mSavedBytes;
+		double mTakeTime, mRestoreTime;
+	};
+	SnapshotStats getStats();
+
+private:
+	std::string mName;
+
+	///Records by Object id: identity, parameters and runtime state.
+	std::map<ObjectId, std::string> mRecords;
+	///Changes since the last save.
+	std::set<ObjectId> mChanged, mRemoved;
+	///The last file saved (or loaded).
+	std::string mFileName;
+
+	///Record's helpers.
+	///@{
+	std::string doWriteRecord(SMARTPTR(Object) object) const;
+	void doReadRecordIdentity(DatagramIterator& scan, ObjectType& objectType,
+			ObjectId& ownerId, bool& paramsStored, ParameterTable& objectParams,
+			ParameterTableMap& componentsParams) const;
+	bool doApplyChunk(const std::string& chunk);
+	///@}
+
+	///Saves' queue: written in order by the worker task chain.
+	struct SaveRequest
+	{
+		std::string mFileName;
+		bool mFull;
+		std::string mChunk;
+	};
+	std::list<SaveRequest> mSaveQueue;
+	Mutex mSaveMutex;
+	std::string mTaskChainName;
+
+	/**
+	 * \brief Save task, executed on a worker thread: drains the queue.
+	 */
+	class SaveTask: public AsyncTask
+	{
+	public:
+		SaveTask(Snapshot* snapshot);
+		virtual DoneStatus do_task();
+	private:
+		Snapshot* mSnapshot;
+	};
+	friend class SaveTask;
+
+	SnapshotStats mStats;
+};
+
+} // namespace ely
+
+#endif /* SNAPSHOT_H_ */
@@ -0,0 +1,277 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/Support/SpatialIndex.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef SPATIALINDEX_H_
+#define SPATIALINDEX_H_
+
+#include "Utilities/Tools.h"
+#include "ObjectModel/Object.h"
+#include <nodePath.h>
+#include <boundingHexahedron.h>
+#include <lplane.h>
+#include <vector>
+#include <map>
+#ifdef ELY_THREAD
+#include <pmutex.h>
+#include <conditionVarFull.h>
+#endif
+
+namespace ely
+{
+
+/**
+ * \brief Singleton spatial index of bounding spheres: a loose octree.
+ *
+ * The octree (grown from the training/octree.cpp prototype) covers a cubic
+ * world region; a node's loose bounds are twice its cell, so an entry is
+ * stored at the depth matching its radius, in the node of the cell
+ * containing its center: insertion and relocation cost only a descent and
+ * never split or merge entries. Entries outside the region are kept by the
+ * root. Nodes are created on demand and released when empty.\n
+ * An entry is a sphere either tracking a NodePath (its position wrt the
+ * scene root) or moved explicitly; every created Object is tracked (by the
+ * ObjectTemplateManager) through its NodePath. Once per frame the tracked
+ * entries are
+ * updated in batch: the new positions are gathered first, then the entries
+ * are moved together (unless removed meanwhile) and relinked only if their
+ * node changed.\n
+ * Sphere, box, frustum and ray queries visit only the nodes whose loose
+ * bounds are intersected and not empty.
+ *
+ * Prepared for multi-threading: queries take a shared (readers') lock so
+ * they can run concurrently, changes an exclusive (writer's) one.
+ */
+class SpatialIndex: public Singleton<SpatialIndex>
+{
+public:
+	///Entry identifier (reused after removal).
+	typedef unsigned int EntryId;
+	static const EntryId INVALID_ENTRY;
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * The already created Objects are tracked too.
+	 * @param center The center of the indexed region.
+	 * @param halfWidth The half width of the (cubic) indexed region.
+	 * @param maxDepth The maximum octree depth.
+	 * @param sort The update task sort (should be after the managers').
+	 * @param priority The update task priority.
+	 */
+	SpatialIndex(const LPoint3f& center = LPoint3f::zero(),
+			float halfWidth = 1024.0, unsigned int maxDepth = 6, int sort = 16,
+			int priority = 0);
+	virtual ~SpatialIndex();
+
+	/**
+	 * \name Entries.
+	 */
+	///@{
+	///Inserts a sphere tracking a NodePath (radius < 0: from its bounds).
+	EntryId insert(const NodePath& nodePath, float radius = -1.0,
+			void* userData = NULL);
+	///Inserts a sphere moved explicitly.
+	EntryId insert(const LPoint3f& center, float radius,
+			void* userData = NULL);
+	void remove(EntryId entryId);
+	void move(EntryId entryId, const LPoint3f& center);
+	void setRadius(EntryId entryId, float radius);
+	bool getSphere(EntryId entryId, LPoint3f& center, float& radius);
+	NodePath getNodePath(EntryId entryId);
+	void* getUserData(EntryId entryId);
+	unsigned int getNumEntries();
+	///@}
+
+	/**
+	 * \name Tracked Objects: entries tracking their NodePaths.
+	 */
+	///@{
+	///Inserts an Object's entry (radius < 0: from its bounds).
+	void addObject(SMARTPTR(Object) object, float radius = -1.0);
+	void removeObject(const ObjectId& objectId);
+	EntryId getObjectEntry(const ObjectId& objectId);
+	///The Object of an entry (empty if none).
+	ObjectId getObjectId(EntryId entryId);
+	///@}
+
+	/**
+	 * \brief Moves the entries tracking NodePaths in batch.
+	 *
+	 * Called once per frame by the update task (only one thread at a time
+	 * should call it).
+	 * @return The number of moved entries.
+	 */
+	unsigned int refresh();
+
+	/**
+	 * \name Queries: the entries whose spheres are intersected.
+	 */
+	///@{
+	void querySphere(const LPoint3f& center, float radius,
+			std::vector<EntryId>& result);
+	void queryBox(const LPoint3f& min, const LPoint3f& max,
+			std::vector<EntryId>& result);
+	///Planes' normals point outwards (as in BoundingHexahedron).
+	void queryFrustum(const std::vector<LPlanef>& planes,
+			std::vector<EntryId>& result);
+	void queryFrustum(const BoundingHexahedron& frustum,
+			std::vector<EntryId>& result);
+	///The frustum of a camera's lens (wrt the scene root).
+	void queryFrustum(const NodePath& camera, std::vector<EntryId>& result);
+	///Hits are sorted by distance along the ray (up to the length).
+	void queryRay(const LPoint3f& origin, const LVector3f& direction,
+			float length, std::vector<EntryId>& result);
+	///@}
+
+	/**
+	 * \brief Update task.
+	 */
+	AsyncTask::DoneStatus update(GenericAsyncTask* task);
+
+	/**
+	 * \brief Statistics: the last update moves and relinks.
+	 */
+	struct SpatialIndexStats
+	{
+		unsigned int mEntries, mNodes, mMoved, mRelinked;
+	};
+	SpatialIndexStats getStats();
+
+private:
+	LPoint3f mCenter;
+	float mHalfWidth;
+	unsigned int mMaxDepth;
+
+	///An indexed sphere.
+	struct Entry
+	{
+		LPoint3f mCenter;
+		float mRadius;
+		NodePath mNodePath;
+		void* mUserData;
+		ObjectId mObjectId;
+		bool mUsed;
+		///Incremented on removal (the id is reused).
+		unsigned int mGeneration;
+		///The containing node and the index into it.
+		int mNode;
+		unsigned int mNodeIndex;
+	};
+	std::vector<Entry> mEntries;
+	std::vector<EntryId> mFreeEntries;
+	std::map<ObjectId, EntryId> mObjectEntries;
+
+	///An octree node: its cell and its loose bounds (twice the cell).
+	struct Node
+	{
+		LPoint3f mCenter;
+		float mHalfWidth;
+		int mParent;
+		unsigned int mIndex;
+		int mChildren[8];
+		unsigned int mDepth;
+		std::vector<EntryId> mEntries;
+		///The entries' spheres (center, radius), scanned by queries.
+		std::vector<LVecBase4f> mSpheres;
+		///Entries in the subtree.
+		unsigned int mCount;
+	};
+	std::vector<Node> mNodes;
+	std::vector<int> mFreeNodes;
+
+	///Helpers.
+	///@{
+	EntryId doInsert(const LPoint3f& center, float radius,
+			const NodePath& nodePath, void* userData);
+	bool doIsValid(EntryId entryId) const;
+	void doRemove(EntryId entryId);
+	///A NodePath's sphere (radius < 0: from its bounds).
+	void doGetSphere(const NodePath& nodePath, LPoint3f& center,
+			float& radius) const;
+	///The node for a sphere (created if requested).
+	int doFindNode(const LPoint3f& center, float radius, bool create);
+	int doNewNode(int parent, unsigned int index);
+	void doLink(EntryId entryId, int node);
+	void doUnlink(EntryId entryId);
+	void doMove(EntryId entryId, const LPoint3f& center);
+	///@}
+
+	///Queries' traversal (on the nodes' loose bounds).
+	///@{
+	struct Shape;
+	void doQuery(int node, const Shape& shape, std::vector<EntryId>& result);
+	///@}
+
+	///Batched update: the moves and their entries' generation.
+	struct Move
+	{
+		EntryId mEntryId;
+		unsigned int mGeneration;
+		LPoint3f mCenter;
+	};
+	std::vector<Move> mMoves;
+	SpatialIndexStats mStats;
+
+	///@{
+	///A task data for the updates.
+	SMARTPTR(TaskInterface<SpatialIndex>::TaskData) mUpdateData;
+	SMARTPTR(AsyncTask) mUpdateTask;
+	///@}
+
+#ifdef ELY_THREAD
+	///Readers/writer lock: shared by queries, exclusive for changes.
+	Mutex mLockMutex;
+	ConditionVarFull mLockVar;
+	unsigned int mReaders, mWritersWaiting;
+	bool mWriter;
+	class ReadHolder
+	{
+	public:
+		ReadHolder(SpatialIndex* index);
+		~ReadHolder();
+	private:
+		SpatialIndex* mIndex;
+	};
+	class WriteHolder
+	{
+	public:
+		WriteHolder(SpatialIndex* index);
+		~WriteHolder();
+	private:
+		SpatialIndex* mIndex;
+	};
+	friend class ReadHolder;
+	friend class WriteHolder;
+#endif
+};
+
+///inline definitions
+
+inline bool SpatialIndex::doIsValid(EntryId entryId) const
+{
+	return (entryId < mEntries.size()) and mEntries[entryId].mUsed;
+}
+
+} // namespace ely
+
+#endif /* SPATIALINDEX_H_ */
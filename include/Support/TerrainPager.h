@@ -0,0 +1,321 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/Support/TerrainPager.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef TERRAINPAGER_H_
+#define TERRAINPAGER_H_
+
+#include "Utilities/Tools.h"
+#include <nodePath.h>
+#include <geoMipTerrain.h>
+#include <textureStage.h>
+#include <bulletRigidBodyNode.h>
+#include <asyncTask.h>
+#include <pmutex.h>
+#include <vector>
+
+namespace ely
+{
+
+/**
+ * \brief Terrain split into a grid of heightfield pages, which are
+ * streamed in and out around a focal point.
+ *
+ * Page (X,Y) is loaded from the heightfield file obtained by replacing
+ * "{x}" and "{y}" in the page pattern with X and Y (and the same is done
+ * for the optional texture pattern). Every page should be pageSize x
+ * pageSize pixels (pageSize = 2^n+1): page (X,Y) covers heightfield
+ * cells [X*(pageSize-1),(X+1)*(pageSize-1)] x [Y*(pageSize-1),(Y+1)*(pageSize-1)],
+ * so adjacent pages share their border pixels.\n
+ * On update():
+ * - pages loaded by the worker threads since the last update are attached
+ * to the scene (and their static Bullet HEIGHTFIELD body to the physics
+ * world);
+ * - pages farther than radius+1 pages from the focal page are evicted,
+ * i.e. detached and freed (the extra page is a hysteresis band);
+ * - at most "budget" missing pages within radius (nearest first) are
+ * dispatched to the worker threads, which load the image, generate the
+ * GeoMipTerrain and create the Bullet shape; pages whose heightfield
+ * couldn't be read are retried, waiting twice as long after each failure;
+ * - resident pages' GeoMipTerrain are updated (if not brute force).
+ *
+ * So at most (2*radius+3)^2 pages are resident at the same time, whatever
+ * the number of pages is. Coordinates are those of the heightfield (one
+ * unit per pixel, height in [0,1]): the root node path can be scaled to
+ * get world dimensions (Bullet bodies are children of the root so they
+ * are scaled too).
+ */
+class TerrainPager: public ReferenceCount
+{
+public:
+	/**
+	 * \brief Page settings.
+	 */
+	struct Settings
+	{
+		///Heightfield and (optional) texture file patterns.
+		std::string mHeightfieldPattern, mTexturePattern;
+		///Texture stage of page textures.
+		SMARTPTR(TextureStage) mTextureStage;
+		///Number of pages along x and y, and page size (pixels).
+		int mPagesX, mPagesY, mPageSize;
+		///Radius (in pages) of the resident area.
+		int mRadius;
+		///Per page GeoMipTerrain settings (near/far in heightfield units).
+		int mBlockSize, mMinLevel;
+		float mNear, mFar;
+		bool mBruteForce;
+		GeoMipTerrain::AutoFlattenMode mFlattenMode;
+		///Create Bullet HEIGHTFIELD bodies.
+		bool mPhysics;
+	};
+
+	/**
+	 * \brief Constructor.
+	 * @param name The name (used for nodes and the worker task chain).
+	 * @param settings The page settings.
+	 * @param budget Maximum number of page loads dispatched per update.
+	 * @param numThreads Number of worker threads.
+	 */
+	TerrainPager(const std::string& name, const Settings& settings, int budget,
+			int numThreads);
+	virtual ~TerrainPager();
+
+	/**
+	 * \brief Loads synchronously the page under the current focal point.
+	 *
+	 * The other pages are streamed in by the next updates.
+	 */
+	void generate();
+
+	/**
+	 * \brief Attaches loaded pages, evicts far pages, dispatches page
+	 * loads (within budget) and updates resident pages.
+	 *
+	 * Must be called by the thread owning the scene graph under root.
+	 */
+	void update();
+
+	/**
+	 * \brief Waits for pending loads, stops worker threads and evicts
+	 * all pages.
+	 */
+	void cleanup();
+
+	/**
+	 * \name Getters/setters.
+	 */
+	///@{
+	NodePath getRoot() const;
+	void setFocalPoint(const LPoint3f& focalPoint);
+	void setBudget(int budget);
+	int getBudget() const;
+	///@}
+
+	/**
+	 * \brief Paging counters.
+	 */
+	struct Stats
+	{
+		///Pages currently attached.
+		unsigned int mResident;
+		///Pages being loaded by workers.
+		unsigned int mLoading;
+		///Pages whose heightfield couldn't be read.
+		unsigned int mMissing;
+		///Pages attached/evicted since creation.
+		unsigned long int mTotalLoaded, mTotalEvicted;
+	};
+	Stats getStats() const;
+
+	/**
+	 * \brief A page GeoMipTerrain, reference counted.
+	 */
+	class PageTerrain: public GeoMipTerrain, public ReferenceCount
+	{
+	public:
+		PageTerrain(const std::string& name);
+
+		///TypedObject semantics: hardcoded
+	public:
+		static TypeHandle get_class_type()
+		{
+			return _type_handle;
+		}
+		static void init_type()
+		{
+			ReferenceCount::init_type();
+			register_type(_type_handle, "TerrainPager::PageTerrain",
+					ReferenceCount::get_class_type());
+		}
+		virtual TypeHandle get_type() const
+		{
+			return get_class_type();
+		}
+		virtual TypeHandle force_init_type()
+		{
+			init_type();
+			return get_class_type();
+		}
+
+	private:
+		static TypeHandle _type_handle;
+	};
+
+private:
+	///Name.
+	std::string mName;
+	///Root of all pages.
+	NodePath mRoot;
+	///Settings.
+	Settings mSettings;
+	LPoint3f mFocalPoint;
+	///Maximum loads dispatched per update.
+	int mBudget;
+
+	/**
+	 * \brief A page.
+	 */
+	struct Page
+	{
+		enum State
+		{
+			EVICTED, LOADING, RESIDENT, MISSING
+		} mState;
+		///The page terrain.
+		PT(PageTerrain) mTerrain;
+		///The static heightfield body (if any).
+		PT(BulletRigidBodyNode) mBody;
+		///Node paths under root.
+		NodePath mTerrainNP, mBodyNP;
+		///MISSING: failed loads and the (frame) time of the next retry.
+		int mRetries;
+		double mNextRetry;
+	};
+	std::vector<Page> mPages;
+
+	/**
+	 * \brief Data loaded by a worker, waiting to be attached.
+	 */
+	struct LoadedPage
+	{
+		int mPage;
+		PT(PageTerrain) mTerrain;
+		PT(BulletRigidBodyNode) mBody;
+	};
+	std::vector<LoadedPage> mLoadedPages;
+	///Protects mLoadedPages.
+	Mutex mLoadedMutex;
+
+	///Worker task chain.
+	std::string mTaskChainName;
+
+	///Counters.
+	Stats mStats;
+
+	/**
+	 * \brief Page load task, executed on a worker thread.
+	 */
+	class LoadTask: public AsyncTask
+	{
+	public:
+		LoadTask(TerrainPager* pager, int page);
+		virtual DoneStatus do_task();
+	private:
+		PT(TerrainPager) mPager;
+		int mPage;
+	};
+	friend class LoadTask;
+
+	///Helpers.
+	///@{
+	LoadedPage doLoadPage(int pageIdx) const;
+	void doAttachPage(const LoadedPage& loaded);
+	void doEvictPage(int pageIdx);
+	void doGetFocalPage(int& fx, int& fy) const;
+	int doGetPageDistance(int pageIdx, int fx, int fy) const;
+	std::string doGetPageFileName(const std::string& pattern, int x,
+			int y) const;
+	float doGetPageWidth() const;
+	///@}
+
+	///TypedObject semantics: hardcoded
+public:
+	static TypeHandle get_class_type()
+	{
+		return _type_handle;
+	}
+	static void init_type()
+	{
+		ReferenceCount::init_type();
+		register_type(_type_handle, "TerrainPager",
+				ReferenceCount::get_class_type());
+	}
+	virtual TypeHandle get_type() const
+	{
+		return get_class_type();
+	}
+	virtual TypeHandle force_init_type()
+	{
+		init_type();
+		return get_class_type();
+	}
+
+private:
+	static TypeHandle _type_handle;
+};
+
+///inline definitions
+
+inline NodePath TerrainPager::getRoot() const
+{
+	return mRoot;
+}
+
+inline void TerrainPager::setFocalPoint(const LPoint3f& focalPoint)
+{
+	mFocalPoint = focalPoint;
+}
+
+inline void TerrainPager::setBudget(int budget)
+{
+	mBudget = (budget > 0 ? budget : 1);
+}
+
+inline int TerrainPager::getBudget() const
+{
+	return mBudget;
+}
+
+inline TerrainPager::Stats TerrainPager::getStats() const
+{
+	return mStats;
+}
+
+inline float TerrainPager::doGetPageWidth() const
+{
+	return (float) (mSettings.mPageSize - 1);
+}
+
+} // namespace ely
+
+#endif /* TERRAINPAGER_H_ */
@@ -0,0 +1,280 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/Support/TerrainQuadTree.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef TERRAINQUADTREE_H_
+#define TERRAINQUADTREE_H_
+
+#include "Utilities/Tools.h"
+#include <nodePath.h>
+#include <geomNode.h>
+#include <pnmImage.h>
+#include <asyncTask.h>
+#include <pmutex.h>
+#include <vector>
+
+namespace ely
+{
+
+/**
+ * \brief Heightfield terrain whose blocks are updated with bounded cost.
+ *
+ * The heightfield is split into square blocks of blockSize x blockSize
+ * cells, like GeoMipTerrain: block level L is rendered with a step of 2^L
+ * cells, and the level is chosen by the distance from the focal point,
+ * linearly between near (minimum level) and far (maximum level).\n
+ * On update():
+ * - blocks whose geometry has been built since the last update are
+ * swapped in (this is the only place where the scene graph is modified);
+ * - levels are selected by visiting a quadtree of blocks: a subtree whose
+ * blocks all fall into the same level is assigned in bulk and is not
+ * visited again until its level changes;
+ * - at most "budget" blocks whose level changed (nearest first) are
+ * dispatched to the worker threads, which build their new geometry into
+ * a back buffer.
+ *
+ * Coordinates are those of the heightfield (one unit per pixel, height
+ * in [0,1]), with the same orientation as GeoMipTerrain: the root node
+ * path can be scaled to get world dimensions.
+ */
+class TerrainQuadTree: public ReferenceCount
+{
+public:
+	/**
+	 * \brief Constructor.
+	 * @param name The name (used for nodes and the worker task chain).
+	 * @param heightField The heightfield: sizes should be 2^n+1.
+	 * @param blockSize The block size (a power of 2).
+	 * @param minLevel The level of the nearest blocks.
+	 * @param nearDist Distance below which blocks are at minLevel.
+	 * @param farDist Distance beyond which blocks are at maximum level.
+	 * @param budget Maximum number of blocks dispatched for regeneration
+	 * per update.
+	 * @param numThreads Number of worker threads.
+	 */
+	TerrainQuadTree(const std::string& name, const PNMImage& heightField,
+			int blockSize, int minLevel, float nearDist, float farDist,
+			int budget, int numThreads);
+	virtual ~TerrainQuadTree();
+
+	/**
+	 * \brief Builds synchronously all blocks for the current focal point.
+	 */
+	void generate();
+
+	/**
+	 * \brief Swaps in ready blocks, selects levels and dispatches
+	 * regenerations (within budget).
+	 *
+	 * Must be called by the thread owning the scene graph under root.
+	 */
+	void update();
+
+	/**
+	 * \brief Waits for pending regenerations and stops worker threads.
+	 */
+	void cleanup();
+
+	/**
+	 * \name Getters/setters.
+	 */
+	///@{
+	NodePath getRoot() const;
+	void setFocalPoint(const LPoint3f& focalPoint);
+	void setBudget(int budget);
+	int getBudget() const;
+	int getMaxLevel() const;
+	///@}
+
+	/**
+	 * \brief Update counters.
+	 */
+	struct Stats
+	{
+		///Blocks swapped in by the last update.
+		unsigned int mRegenerated;
+		///Blocks dispatched to workers by the last update.
+		unsigned int mDispatched;
+		///Blocks waiting for a regeneration.
+		unsigned int mPending;
+		///Quadtree nodes visited by the last update.
+		unsigned int mVisited;
+		///Blocks swapped in since creation.
+		unsigned long int mTotalRegenerated;
+	};
+	Stats getStats() const;
+
+private:
+	///Name.
+	std::string mName;
+	///Root of all blocks.
+	NodePath mRoot;
+	///Heights and sizes.
+	std::vector<float> mHeights;
+	int mXSize, mYSize;
+	///Blocks.
+	int mBlockSize, mMinLevel, mMaxLevel, mNumBlocksX, mNumBlocksY;
+	float mNear, mFar;
+	LPoint3f mFocalPoint;
+	///Maximum regenerations dispatched per update.
+	int mBudget;
+
+	/**
+	 * \brief A terrain block: its node is double buffered, i.e. the
+	 * current geometry stays attached while the next one is being built.
+	 */
+	struct Block
+	{
+		int mX, mY;
+		LPoint3f mCenter;
+		///Level of the attached geometry, wanted level, level being built.
+		int mLevel, mWantedLevel, mBuildLevel;
+		///Set when the block is in the dirty list.
+		bool mDirty;
+		///Set while a worker is building the geometry.
+		bool mBuilding;
+		///Back buffer: built geometry waiting to be swapped in.
+		PT(GeomNode) mBackBuffer;
+		///The node path under root.
+		NodePath mNP;
+	};
+	std::vector<Block> mBlocks;
+
+	/**
+	 * \brief A quadtree node: covers blocks in [mX0,mX1)x[mY0,mY1).
+	 */
+	struct QuadNode
+	{
+		int mX0, mY0, mX1, mY1;
+		LPoint3f mMin, mMax;
+		///Children indexes (-1 if none).
+		int mChildren[4];
+		///Level assigned in bulk to all blocks (-1 if not uniform).
+		int mUniformLevel;
+	};
+	std::vector<QuadNode> mQuadNodes;
+
+	///Blocks whose wanted level differs from their level.
+	std::vector<int> mDirtyBlocks;
+	///Blocks whose back buffer is ready (filled by workers).
+	std::vector<int> mReadyBlocks;
+	///Protects mReadyBlocks, Block::mBackBuffer, Block::mBuildLevel and
+	///mLastStats.
+	mutable Mutex mReadyMutex;
+
+	///Worker task chain.
+	std::string mTaskChainName;
+
+	///Counters: updated by update() and published at its end (the
+	///copy returned by getStats()).
+	Stats mStats, mLastStats;
+
+	/**
+	 * \brief Regeneration task, executed on a worker thread.
+	 */
+	class RegenTask: public AsyncTask
+	{
+	public:
+		RegenTask(TerrainQuadTree* tree, int block, int level);
+		virtual DoneStatus do_task();
+	private:
+		PT(TerrainQuadTree) mTree;
+		int mBlock, mLevel;
+	};
+	friend class RegenTask;
+
+	///Helpers.
+	///@{
+	int doBuildQuadNode(int x0, int y0, int x1, int y1);
+	void doSelectLevels(int nodeIdx);
+	void doAssignLevel(int nodeIdx, int level);
+	void doSetWantedLevel(int blockIdx, int level);
+	int doGetLevel(float distance) const;
+	float doGetHeight(int x, int y) const;
+	PT(GeomNode) doBuildBlockGeom(int blockIdx, int level) const;
+	void doSwapBlock(int blockIdx, PT(GeomNode) geomNode);
+	///@}
+
+	///TypedObject semantics: hardcoded
+public:
+	static TypeHandle get_class_type()
+	{
+		return _type_handle;
+	}
+	static void init_type()
+	{
+		ReferenceCount::init_type();
+		register_type(_type_handle, "TerrainQuadTree",
+				ReferenceCount::get_class_type());
+	}
+	virtual TypeHandle get_type() const
+	{
+		return get_class_type();
+	}
+	virtual TypeHandle force_init_type()
+	{
+		init_type();
+		return get_class_type();
+	}
+
+private:
+	static TypeHandle _type_handle;
+};
+
+///inline definitions
+
+inline NodePath TerrainQuadTree::getRoot() const
+{
+	return mRoot;
+}
+
+inline void TerrainQuadTree::setFocalPoint(const LPoint3f& focalPoint)
+{
+	mFocalPoint = focalPoint;
+}
+
+inline void TerrainQuadTree::setBudget(int budget)
+{
+	mBudget = (budget > 0 ? budget : 1);
+}
+
+inline int TerrainQuadTree::getBudget() const
+{
+	return mBudget;
+}
+
+inline int TerrainQuadTree::getMaxLevel() const
+{
+	return mMaxLevel;
+}
+
+inline float TerrainQuadTree::doGetHeight(int x, int y) const
+{
+	//clamp to heightfield borders
+	x = (x < 0 ? 0 : (x >= mXSize ? mXSize - 1 : x));
+	y = (y < 0 ? 0 : (y >= mYSize ? mYSize - 1 : y));
+	return mHeights[y * mXSize + x];
+}
+
+} // namespace ely
+
+#endif /* TERRAINQUADTREE_H_ */
@@ -0,0 +1,280 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/Support/TickScheduler.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef TICKSCHEDULER_H_
+#define TICKSCHEDULER_H_
+
+#include <vector>
+#include <map>
+
+namespace ely
+{
+
+/**
+ * \brief Per member data of a TickScheduler.
+ */
+struct TickSchedule
+{
+	TickSchedule() :
+			mGroup(-1), mSlot(-1), mElapsed(0.0), mFrame(0)
+	{
+	}
+	///Group and slot into the group (-1 if not scheduled).
+	int mGroup, mSlot;
+	///Time elapsed since the last tick (or since joining the group).
+	float mElapsed;
+	///Scheduler frame of the last tick (or of joining the group).
+	unsigned long int mFrame;
+};
+
+/**
+ * \brief Scheduler ticking groups of members once every group's period.
+ *
+ * Members are grouped by key and period, and each group is ticked once
+ * every period (0 means every frame) over its contiguous members. The
+ * members which joined a group since its last tick elapsed less time than
+ * the group: they are told apart by the frame (an integer count) they
+ * started counting at, not by comparing their elapsed times.\n
+ * MEMBER is a (smart) pointer to a class with a TickSchedule "mSchedule"
+ * member, accessible by the scheduler.
+ */
+template<typename MEMBER, typename KEY> class TickScheduler
+{
+public:
+	TickScheduler();
+
+	/**
+	 * \name Adds/removes a member to/from the group of (key, period).
+	 *
+	 * A member can be moved into another group by removing and adding it
+	 * again, but not while its group is being ticked.
+	 */
+	///@{
+	void add(MEMBER member, const KEY& key, float period);
+	void remove(MEMBER member);
+	void clear();
+	///@}
+
+	/**
+	 * \brief Starts a new frame, adding its time to groups and members.
+	 * @param dt The frame time.
+	 */
+	void advance(float dt);
+
+	/**
+	 * \brief Ticks a group whose period is elapsed.
+	 *
+	 * The group's members are split into those which elapsed the same
+	 * time as the group and the others (with their own elapsed time), then
+	 * they all restart counting.
+	 * @param group The group index.
+	 * @param inSync The members which elapsed the group's time.
+	 * @param others The other members with their elapsed time.
+	 * @return The group's elapsed time, or a negative value if the group
+	 * is empty or its period isn't elapsed (nothing is returned).
+	 */
+	float tick(int group, std::vector<MEMBER>& inSync,
+			std::vector<std::pair<MEMBER, float> >& others);
+
+	/**
+	 * \name Getters.
+	 */
+	///@{
+	int getNumGroups() const;
+	const KEY& getKey(int group) const;
+	float getPeriod(int group) const;
+	const std::vector<MEMBER>& getMembers(int group) const;
+	unsigned long int getFrame() const;
+	///@}
+
+private:
+	struct Group
+	{
+		KEY mKey;
+		float mPeriod, mElapsed;
+		///Frame of the last tick (or since the group isn't empty).
+		unsigned long int mFrame;
+		std::vector<MEMBER> mMembers;
+	};
+	std::vector<Group> mGroups;
+	///(key, period) -> group index.
+	std::map<std::pair<KEY, float>, int> mGroupIndexes;
+	///Current frame.
+	unsigned long int mFrame;
+};
+
+///inline definitions
+
+template<typename MEMBER, typename KEY> TickScheduler<MEMBER, KEY>::TickScheduler() :
+		mFrame(0)
+{
+}
+
+template<typename MEMBER, typename KEY> void TickScheduler<MEMBER, KEY>::add(
+		MEMBER member, const KEY& key, float period)
+{
+	std::pair<KEY, float> groupKey(key, period);
+	typename std::map<std::pair<KEY, float>, int>::const_iterator iter =
+			mGroupIndexes.find(groupKey);
+	int groupIdx;
+	if (iter != mGroupIndexes.end())
+	{
+		groupIdx = iter->second;
+	}
+	else
+	{
+		groupIdx = mGroups.size();
+		mGroups.push_back(Group());
+		mGroups.back().mKey = key;
+		mGroups.back().mPeriod = period;
+		mGroupIndexes[groupKey] = groupIdx;
+	}
+	Group& group = mGroups[groupIdx];
+	if (group.mMembers.empty())
+	{
+		//the group (re)starts counting with its first member
+		group.mElapsed = 0.0;
+		group.mFrame = mFrame;
+	}
+	//the time elapsed in the group doesn't belong to the newcomer
+	member->mSchedule.mGroup = groupIdx;
+	member->mSchedule.mSlot = group.mMembers.size();
+	member->mSchedule.mElapsed = 0.0;
+	member->mSchedule.mFrame = mFrame;
+	group.mMembers.push_back(member);
+}
+
+template<typename MEMBER, typename KEY> void TickScheduler<MEMBER, KEY>::remove(
+		MEMBER member)
+{
+	if (member->mSchedule.mGroup < 0)
+	{
+		return;
+	}
+	std::vector<MEMBER>& members = mGroups[member->mSchedule.mGroup].mMembers;
+	//move the last one into the freed slot
+	int slot = member->mSchedule.mSlot;
+	members[slot] = members.back();
+	members[slot]->mSchedule.mSlot = slot;
+	member->mSchedule.mGroup = member->mSchedule.mSlot = -1;
+	members.pop_back();
+}
+
+template<typename MEMBER, typename KEY> void TickScheduler<MEMBER, KEY>::clear()
+{
+	for (unsigned int g = 0; g < mGroups.size(); ++g)
+	{
+		for (unsigned int m = 0; m < mGroups[g].mMembers.size(); ++m)
+		{
+			mGroups[g].mMembers[m]->mSchedule.mGroup =
+					mGroups[g].mMembers[m]->mSchedule.mSlot = -1;
+		}
+	}
+	mGroups.clear();
+	mGroupIndexes.clear();
+}
+
+template<typename MEMBER, typename KEY> void TickScheduler<MEMBER, KEY>::advance(
+		float dt)
+{
+	++mFrame;
+	for (unsigned int g = 0; g < mGroups.size(); ++g)
+	{
+		Group& group = mGroups[g];
+		if (group.mMembers.empty())
+		{
+			continue;
+		}
+		group.mElapsed += dt;
+		for (unsigned int m = 0; m < group.mMembers.size(); ++m)
+		{
+			group.mMembers[m]->mSchedule.mElapsed += dt;
+		}
+	}
+}
+
+template<typename MEMBER, typename KEY> float TickScheduler<MEMBER, KEY>::tick(
+		int group, std::vector<MEMBER>& inSync,
+		std::vector<std::pair<MEMBER, float> >& others)
+{
+	inSync.clear();
+	others.clear();
+	Group& tickGroup = mGroups[group];
+	if (tickGroup.mMembers.empty() or (tickGroup.mElapsed < tickGroup.mPeriod))
+	{
+		return -1.0;
+	}
+	for (unsigned int m = 0; m < tickGroup.mMembers.size(); ++m)
+	{
+		MEMBER& member = tickGroup.mMembers[m];
+		if (member->mSchedule.mFrame == tickGroup.mFrame)
+		{
+			inSync.push_back(member);
+		}
+		else
+		{
+			others.push_back(
+					std::pair<MEMBER, float>(member,
+							member->mSchedule.mElapsed));
+		}
+		member->mSchedule.mElapsed = 0.0;
+		member->mSchedule.mFrame = mFrame;
+	}
+	float elapsed = tickGroup.mElapsed;
+	tickGroup.mElapsed = 0.0;
+	tickGroup.mFrame = mFrame;
+	return elapsed;
+}
+
+template<typename MEMBER, typename KEY> inline int TickScheduler<MEMBER, KEY>::getNumGroups() const
+{
+	return mGroups.size();
+}
+
+template<typename MEMBER, typename KEY> inline const KEY& TickScheduler<
+		MEMBER, KEY>::getKey(int group) const
+{
+	return mGroups[group].mKey;
+}
+
+template<typename MEMBER, typename KEY> inline float TickScheduler<MEMBER, KEY>::getPeriod(
+		int group) const
+{
+	return mGroups[group].mPeriod;
+}
+
+template<typename MEMBER, typename KEY> inline const std::vector<MEMBER>& TickScheduler<
+		MEMBER, KEY>::getMembers(int group) const
+{
+	return mGroups[group].mMembers;
+}
+
+template<typename MEMBER, typename KEY> inline unsigned long int TickScheduler<
+		MEMBER, KEY>::getFrame() const
+{
+	return mFrame;
+}
+
+} // namespace ely
+
+#endif /* TICKSCHEDULER_H_ */
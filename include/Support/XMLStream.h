@@ -0,0 +1,194 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/include/Support/XMLStream.h
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#ifndef XMLSTREAM_H_
+#define XMLSTREAM_H_
+
+#include <string>
+#include <vector>
+#include <cstring>
+
+namespace ely
+{
+
+/**
+ * \brief A (not owned) view of characters into an XMLStream buffer.
+ *
+ * Element and attribute names and attribute values are NUL terminated
+ * too, so c_str() can be used on them; text and CDATA views are not.
+ */
+struct XMLStringView
+{
+	const char* mData;
+	size_t mSize;
+
+	XMLStringView() :
+			mData(""), mSize(0)
+	{
+	}
+	XMLStringView(const char* data, size_t size) :
+			mData(data), mSize(size)
+	{
+	}
+	bool empty() const
+	{
+		return mSize == 0;
+	}
+	const char* c_str() const
+	{
+		return mData;
+	}
+	std::string str() const
+	{
+		return std::string(mData, mSize);
+	}
+	bool operator==(const char* other) const
+	{
+		return (strncmp(mData, other, mSize) == 0) and (other[mSize] == '\0');
+	}
+	bool operator!=(const char* other) const
+	{
+		return not operator==(other);
+	}
+};
+
+/**
+ * \brief An element attribute.
+ */
+struct XMLStreamAttribute
+{
+	XMLStringView mName, mValue;
+};
+
+/**
+ * \brief SAX-like handler of the XMLStream events.
+ *
+ * Each method returns false to stop parsing.
+ */
+class XMLStreamHandler
+{
+public:
+	virtual ~XMLStreamHandler()
+	{
+	}
+	virtual bool startElement(const XMLStringView& name,
+			const XMLStreamAttribute* attributes, unsigned int numAttributes) = 0;
+	virtual bool endElement(const XMLStringView& name) = 0;
+	///Not white space only text and CDATA sections.
+	virtual bool text(const XMLStringView& text)
+	{
+		return true;
+	}
+};
+
+/**
+ * \brief Streaming XML parser working in-situ over a memory mapped file.
+ *
+ * The file is privately mapped (copy-on-write) and parsed in a single
+ * pass: elements, attributes and text are reported to a handler as views
+ * into the mapped buffer, so no document tree is built and nothing is
+ * allocated per element or attribute. Entity references and new lines are
+ * decoded in place (only the pages containing them are copied).\n
+ * Views are valid until the stream is closed.\n
+ * Character classification and references are those of tinyxml2
+ * (XMLUtil). Processing instructions, comments and DTDs are skipped.
+ */
+class XMLStream
+{
+public:
+	XMLStream();
+	~XMLStream();
+
+	/**
+	 * \name Opens a file or a writable buffer.
+	 *
+	 * The buffer is owned by the caller and must have room for a NUL
+	 * terminator (size + 1 characters).
+	 */
+	///@{
+	bool open(const std::string& fileName);
+	bool openBuffer(char* buffer, size_t size);
+	void close();
+	///@}
+
+	/**
+	 * \brief Parses the opened file (or buffer).
+	 * @param handler The handler.
+	 * @return False on error.
+	 */
+	bool parse(XMLStreamHandler& handler);
+
+	/**
+	 * \name Error reporting.
+	 */
+	///@{
+	const std::string& getErrorStr() const;
+	int getErrorLine() const;
+	///@}
+
+	size_t getSize() const;
+
+private:
+	///The buffer (always NUL terminated).
+	char* mBuffer;
+	size_t mSize;
+	///The memory mapped size (0 if the buffer is not mapped).
+	size_t mMapSize;
+	bool mOwnedBuffer;
+	///Reused between elements.
+	std::vector<XMLStreamAttribute> mAttributes;
+	std::vector<XMLStringView> mElements;
+	///Error data.
+	std::string mErrorStr;
+	int mErrorLine;
+
+	///Helpers.
+	bool doSetError(const char* p, const std::string& error);
+	char* doParseName(char* p, XMLStringView& name);
+	size_t doDecode(char* data, size_t size);
+
+	// don't allow copy
+	XMLStream(const XMLStream&);
+	XMLStream& operator=(const XMLStream&);
+};
+
+///inline definitions
+
+inline const std::string& XMLStream::getErrorStr() const
+{
+	return mErrorStr;
+}
+
+inline int XMLStream::getErrorLine() const
+{
+	return mErrorLine;
+}
+
+inline size_t XMLStream::getSize() const
+{
+	return mSize;
+}
+
+} // namespace ely
+
+#endif /* XMLSTREAM_H_ */
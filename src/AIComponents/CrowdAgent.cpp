@@ -357,6 +357,42 @@ void CrowdAgent::setMoveVelocity(const LVector3f& vel)
 	mNavMesh->setCrowdAgentVelocity(this, vel);
 }
 
+void CrowdAgent::write_datagram(BamWriter* manager, Datagram& dg)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	Component::write_datagram(manager, dg);
+	mMoveTarget.write_datagram(dg);
+	mMoveVelocity.write_datagram(dg);
+}
+
+void CrowdAgent::fillin(DatagramIterator& scan, BamReader* manager)
+{
+	Component::fillin(scan, manager);
+	LPoint3f moveTarget;
+	LVector3f moveVelocity;
+	moveTarget.read_datagram(scan);
+	moveVelocity.read_datagram(scan);
+
+	//lock (guard) the CrowdAgent NavMesh mutex
+	HOLD_REMUTEX(mNavMeshMutex)
+
+	if (mNavMesh)
+	{
+		//request NavMesh to reset this CrowdAgent
+		mNavMesh->resetCrowdAgent(this, moveTarget, moveVelocity);
+	}
+	else
+	{
+		//lock (guard) the mutex
+		HOLD_REMUTEX(mMutex)
+
+		mMoveTarget = moveTarget;
+		mMoveVelocity = moveVelocity;
+	}
+}
+
 SMARTPTR(NavMesh) CrowdAgent::getNavMesh() const
 {
 	//lock (guard) the CrowdAgent NavMesh mutex
@@ -406,7 +442,7 @@ void CrowdAgent::doUpdatePosDir(float dt, const LPoint3f& pos, const LVector3f&
 		//throw Move event (if enabled)
 		if (mMove.mEnable)
 		{
-			doThrowEvent(mMove);
+			doThrowEvent(mMove, EventBus::CROWDAGENT_MOVE_EVENT);
 		}
 		//reset Steady event (if enabled and if thrown)
 		if (mSteady.mEnable and mSteady.mThrown)
@@ -428,7 +464,7 @@ void CrowdAgent::doUpdatePosDir(float dt, const LPoint3f& pos, const LVector3f&
 		//throw Steady event (if enabled)
 		if (mSteady.mEnable)
 		{
-			doThrowEvent(mSteady);
+			doThrowEvent(mSteady, EventBus::CROWDAGENT_STEADY_EVENT);
 		}
 	}
 }
@@ -475,8 +511,6 @@ CrowdAgentTemplate::CrowdAgentTemplate(PandaFramework* pandaFramework,
 {
 	CHECK_EXISTENCE_DEBUG(pandaFramework,
 			"CrowdAgentTemplate::CrowdAgentTemplate: invalid PandaFramework")
-	CHECK_EXISTENCE_DEBUG(windowFramework,
-			"CrowdAgentTemplate::CrowdAgentTemplate: invalid WindowFramework")
 	CHECK_EXISTENCE_DEBUG(GameAIManager::GetSingletonPtr(),
 			"CrowdAgentTemplate::CrowdAgentTemplate: invalid GameAIManager")
 	CHECK_EXISTENCE_DEBUG(GamePhysicsManager::GetSingletonPtr(),
@@ -33,6 +33,8 @@
 #include "Game/GamePhysicsManager.h"
 #include "SceneComponents/Model.h"
 #include "SceneComponents/InstanceOf.h"
+#include <DetourNode.h>
+#include <cstring>
 
 namespace ely
 {
@@ -167,6 +169,34 @@ bool NavMesh::initialize()
 			std::string("crowd_include_flags"));
 	mCrowdExcludeFlagsParam = mTmpl->parameter(
 			std::string("crowd_exclude_flags"));
+	//max crowd agents
+	valueInt = strtol(mTmpl->parameter(std::string("max_crowd_agents")).c_str(),
+			NULL, 0);
+	mMaxCrowdAgents = (valueInt > 0 ? valueInt : -valueInt);
+	if (mMaxCrowdAgents == 0)
+	{
+		mMaxCrowdAgents = CrowdToolState::DEFAULT_MAX_AGENTS;
+	}
+	//crowd shards
+	valueInt = strtol(mTmpl->parameter(std::string("crowd_shards")).c_str(),
+			NULL, 0);
+	mCrowdShards = (valueInt > 1 ? valueInt : 1);
+	//crowd threads
+	valueInt = strtol(mTmpl->parameter(std::string("crowd_threads")).c_str(),
+			NULL, 0);
+	mCrowdThreads = (valueInt >= 0 ? valueInt : -valueInt);
+	//stats
+	mStatsEnabled = (
+			mTmpl->parameter(std::string("stats"))
+					== std::string("true") ? true : false);
+	mStatsFileParam = mTmpl->parameter(std::string("stats_file"));
+	valueInt = strtol(mTmpl->parameter(std::string("stats_interval")).c_str(),
+			NULL, 0);
+	mStatsInterval = (valueInt > 0 ? valueInt : 60);
+	if (not mStatsFileParam.empty())
+	{
+		dumpStats(mStatsFileParam, mStatsInterval);
+	}
 	//convex volumes
 	mConvexVolumesParam = mTmpl->parameterList(std::string("convex_volume"));
 	//off mesh connections
@@ -739,7 +769,7 @@ AsyncTask::DoneStatus NavMesh::navMeshAsyncSetup(GenericAsyncTask* task)
 	doBuildNavMesh();
 
 	//set recast crowd
-	CrowdTool* crowdTool = new CrowdTool();
+	CrowdTool* crowdTool = new CrowdTool(mMaxCrowdAgents);
 	mNavMeshType->setTool(crowdTool);
 
 	//set recast areas' costs
@@ -758,6 +788,18 @@ AsyncTask::DoneStatus NavMesh::navMeshAsyncSetup(GenericAsyncTask* task)
 	crowdTool->getState()->getCrowd()->getEditableFilter(0)->setExcludeFlags(
 			mCrowdExcludeFlags);
 
+	//partition the crowd (if requested): shards share the above settings
+	if (mCrowdShards > 1)
+	{
+		if (not crowdTool->getState()->initShards(mCrowdShards, mCrowdThreads,
+				mComponentId))
+		{
+			PRINT_ERR_DEBUG(
+					"NavMesh::navMeshAsyncSetup: cannot create crowd shards for "
+					<< mComponentId);
+		}
+	}
+
 	//<this code is executed only when in manual setup:
 	//add to recast previously added CrowdAgents.
 	//mCrowdAgents could be modified during iteration so use this pattern:
@@ -1456,7 +1498,7 @@ NavMesh::Result NavMesh::setCrowdAgentParams(SMARTPTR(CrowdAgent)crowdAgent,
 				ap.radius = mNavMeshType->getNavMeshSettings().m_agentRadius;
 				ap.height = mNavMeshType->getNavMeshSettings().m_agentHeight;
 				dynamic_cast<CrowdTool*>(mNavMeshType->getTool())->
-				getState()->getCrowd()->updateAgentParameters(crowdAgent->mAgentIdx, &ap);
+				getState()->updateAgentParameters(crowdAgent->mAgentIdx, &ap);
 			}
 			crowdAgent->mAgentParams = params;
 		}
@@ -1549,6 +1591,46 @@ NavMesh::Result NavMesh::setCrowdAgentVelocity(SMARTPTR(CrowdAgent)crowdAgent,
 	return Result::OK;
 }
 
+NavMesh::Result NavMesh::resetCrowdAgent(SMARTPTR(CrowdAgent)crowdAgent,
+		const LPoint3f& moveTarget, const LVector3f& moveVelocity)
+{
+	RETURN_ON_COND(not crowdAgent, Result::ERROR)
+
+	//lock (guard) the crowdAgent NavMesh mutex
+	HOLD_REMUTEX(crowdAgent->mNavMeshMutex)
+	{
+		//return if crowdAgent doesn't belong to this mesh
+		RETURN_ON_COND(crowdAgent->mNavMesh != this, Result::ERROR)
+
+		//lock (guard) the mutex
+		HOLD_REMUTEX(mMutex)
+
+		//return if destroying
+		RETURN_ON_ASYNC_COND(mDestroying, Result::DESTROYING)
+
+		{
+			//lock (guard) the crowdAgent mutex
+			HOLD_REMUTEX(crowdAgent->mMutex)
+
+			//return if crowdAgent is destroying
+			RETURN_ON_ASYNC_COND(crowdAgent->mDestroying, Result::Result::ERROR)
+
+			crowdAgent->mMoveTarget = moveTarget;
+			crowdAgent->mMoveVelocity = moveVelocity;
+			//return if NavMesh has not been setup yet
+			RETURN_ON_COND(not mNavMeshType, Result::NAVMESHTYPE_NULL)
+
+			//re-add to recast update: at the current position and with
+			//the current target/velocity
+			doRemoveCrowdAgentFromRecastUpdate(crowdAgent);
+			RETURN_ON_COND(not doAddCrowdAgentToRecastUpdate(crowdAgent),
+					Result::ERROR)
+		}
+	}
+	//
+	return Result::OK;
+}
+
 void NavMesh::update(void* data)
 {
 	//lock (guard) the mutex
@@ -1562,10 +1644,23 @@ void NavMesh::update(void* data)
 
 	//update is done only when there is a crowd tool
 	CrowdTool* crowdTool = dynamic_cast<CrowdTool*>(mNavMeshType->getTool());
-	dtCrowd* crowd = crowdTool->getState()->getCrowd();
+	CrowdToolState* crowdState = crowdTool->getState();
 
 	//update crowd agents' pos/vel
-	mNavMeshType->handleUpdate(dt);
+	if (mStatsEnabled != crowdState->isCollectingStats())
+	{
+		crowdState->setCollectStats(mStatsEnabled);
+	}
+	if (mStatsEnabled)
+	{
+		TimeVal startTime = getPerfTime();
+		mNavMeshType->handleUpdate(dt);
+		doUpdateStats(crowdState, getPerfTimeUsec(getPerfTime() - startTime));
+	}
+	else
+	{
+		mNavMeshType->handleUpdate(dt);
+	}
 
 	std::list<SMARTPTR(CrowdAgent)>::const_iterator iter;
 	//post-update all agent positions
@@ -1574,8 +1669,9 @@ void NavMesh::update(void* data)
 	{
 		int agentIdx = (*iter)->mAgentIdx;
 		//give CrowdAgent chance to update its pos/vel
-		const float* vel = crowd->getAgent(agentIdx)->vel;
-		const float* pos = crowd->getAgent(agentIdx)->npos;
+		const dtCrowdAgent* agent = crowdState->getAgent(agentIdx);
+		const float* vel = agent->vel;
+		const float* pos = agent->npos;
 		(*iter)->doUpdatePosDir(dt, RecastToLVecBase3f(pos),
 				RecastToLVecBase3f(vel));
 	}
@@ -1589,6 +1685,179 @@ void NavMesh::update(void* data)
 #endif
 }
 
+NavMesh::Result NavMesh::enableStats(bool enable)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	//return if destroying
+	RETURN_ON_ASYNC_COND(mDestroying, Result::DESTROYING)
+
+	if (enable and (not mStatsEnabled))
+	{
+		doResetStats();
+	}
+	mStatsEnabled = enable;
+	//
+	return Result::OK;
+}
+
+NavMesh::Result NavMesh::dumpStats(const std::string& fileName, int interval)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	//return if destroying
+	RETURN_ON_ASYNC_COND(mDestroying, Result::DESTROYING)
+
+	if (mStatsFile.is_open())
+	{
+		mStatsFile.close();
+	}
+	RETURN_ON_COND(fileName.empty(), Result::OK)
+
+	mStatsFile.open(fileName.c_str(), std::ios::out | std::ios::trunc);
+	RETURN_ON_COND(not mStatsFile.is_open(), Result::ERROR)
+
+	std::string::size_type dot = fileName.rfind('.');
+	mStatsJSON = (dot != std::string::npos)
+			and (fileName.substr(dot) == std::string(".json"));
+	mStatsInterval = (interval > 0 ? interval : 1);
+	if (not mStatsJSON)
+	{
+		mStatsFile << "frame,update_time,crowd_update_time,active_agents,"
+				"velocity_samples,path_queue_length,path_nodes,tile_rebuilds,"
+				"total_tile_rebuilds,obstacle_queue_length" << std::endl;
+	}
+	enableStats(true);
+	//
+	return Result::OK;
+}
+
+void NavMesh::doResetStats()
+{
+	memset(&mStats, 0, sizeof(Stats));
+	mStatsSaltSum = 0;
+	mStatsNavMesh = NULL;
+}
+
+void NavMesh::doUpdateStats(CrowdToolState* crowdState, int updateTime)
+{
+	++mStats.mFrame;
+	mStats.mUpdateTime = updateTime;
+	mStats.mCrowdUpdateTime = crowdState->getUpdateTime();
+	//crowd(s)
+	mStats.mActiveAgents = mStats.mVelocitySamples = mStats.mPathQueueLength =
+			mStats.mPathNodes = 0;
+	CrowdShards* shards = crowdState->getShards();
+	if (shards)
+	{
+		for (int s = 0; s < shards->getNumShards(); ++s)
+		{
+			doAddCrowdStats(shards->getShardCrowd(s));
+		}
+		//ghosts are not agents
+		mStats.mActiveAgents -= shards->getNumGhosts();
+	}
+	else
+	{
+		doAddCrowdStats(crowdState->getCrowd());
+	}
+	//tiles: a tile's salt is incremented when the tile is removed (so
+	//when it is rebuilt)
+	const dtNavMesh* navMesh = mNavMeshType->getNavMesh();
+	unsigned long int saltSum = 0;
+	for (int i = 0; navMesh and (i < navMesh->getMaxTiles()); ++i)
+	{
+		saltSum += navMesh->getTile(i)->salt;
+	}
+	mStats.mTileRebuilds = 0;
+	if ((navMesh == mStatsNavMesh) and (saltSum >= mStatsSaltSum))
+	{
+		mStats.mTileRebuilds = saltSum - mStatsSaltSum;
+		mStats.mTotalTileRebuilds += mStats.mTileRebuilds;
+	}
+	mStatsSaltSum = saltSum;
+	mStatsNavMesh = navMesh;
+	//obstacles
+	mStats.mObstacleQueueLength = 0;
+	if (mNavMeshTypeEnum == OBSTACLE)
+	{
+		dtTileCache* tileCache =
+				static_cast<NavMeshType_Obstacle*>(mNavMeshType)->getTileCache();
+		for (int i = 0; tileCache and (i < tileCache->getObstacleCount()); ++i)
+		{
+			const dtTileCacheObstacle* obstacle = tileCache->getObstacle(i);
+			if ((obstacle->state == DT_OBSTACLE_PROCESSING)
+					or (obstacle->state == DT_OBSTACLE_REMOVING))
+			{
+				++mStats.mObstacleQueueLength;
+			}
+		}
+	}
+	//dump
+	if (mStatsFile.is_open() and (mStats.mFrame % mStatsInterval == 0))
+	{
+		doWriteStats();
+	}
+}
+
+void NavMesh::doAddCrowdStats(const dtCrowd* crowd)
+{
+	RETURN_ON_COND(not crowd,)
+
+	for (int i = 0; i < crowd->getAgentCount(); ++i)
+	{
+		const dtCrowdAgent* agent = crowd->getAgent(i);
+		if (not agent->active)
+		{
+			continue;
+		}
+		++mStats.mActiveAgents;
+		if ((agent->targetState == DT_CROWDAGENT_TARGET_REQUESTING)
+				or (agent->targetState
+						== DT_CROWDAGENT_TARGET_WAITING_FOR_QUEUE)
+				or (agent->targetState == DT_CROWDAGENT_TARGET_WAITING_FOR_PATH))
+		{
+			++mStats.mPathQueueLength;
+		}
+	}
+	mStats.mVelocitySamples += crowd->getVelocitySampleCount();
+	const dtPathQueue* pathQueue = crowd->getPathQueue();
+	if (pathQueue and pathQueue->getNavQuery()
+			and pathQueue->getNavQuery()->getNodePool())
+	{
+		mStats.mPathNodes +=
+				pathQueue->getNavQuery()->getNodePool()->getNodeCount();
+	}
+}
+
+void NavMesh::doWriteStats()
+{
+	if (mStatsJSON)
+	{
+		mStatsFile << "{\"frame\":" << mStats.mFrame << ",\"update_time\":"
+				<< mStats.mUpdateTime << ",\"crowd_update_time\":"
+				<< mStats.mCrowdUpdateTime << ",\"active_agents\":"
+				<< mStats.mActiveAgents << ",\"velocity_samples\":"
+				<< mStats.mVelocitySamples << ",\"path_queue_length\":"
+				<< mStats.mPathQueueLength << ",\"path_nodes\":"
+				<< mStats.mPathNodes << ",\"tile_rebuilds\":"
+				<< mStats.mTileRebuilds << ",\"total_tile_rebuilds\":"
+				<< mStats.mTotalTileRebuilds << ",\"obstacle_queue_length\":"
+				<< mStats.mObstacleQueueLength << "}" << std::endl;
+	}
+	else
+	{
+		mStatsFile << mStats.mFrame << "," << mStats.mUpdateTime << ","
+				<< mStats.mCrowdUpdateTime << "," << mStats.mActiveAgents << ","
+				<< mStats.mVelocitySamples << "," << mStats.mPathQueueLength
+				<< "," << mStats.mPathNodes << "," << mStats.mTileRebuilds << ","
+				<< mStats.mTotalTileRebuilds << ","
+				<< mStats.mObstacleQueueLength << std::endl;
+	}
+}
+
 #ifdef ELY_DEBUG
 NodePath NavMesh::getDebugNodePath() const
 {
@@ -1646,8 +1915,6 @@ NavMeshTemplate::NavMeshTemplate(PandaFramework* pandaFramework,
 {
 	CHECK_EXISTENCE_DEBUG(pandaFramework,
 			"NavMeshTemplate::NavMeshTemplate: invalid PandaFramework")
-	CHECK_EXISTENCE_DEBUG(windowFramework,
-			"NavMeshTemplate::NavMeshTemplate: invalid WindowFramework")
 	CHECK_EXISTENCE_DEBUG(GameAIManager::GetSingletonPtr(),
 			"NavMeshTemplate::NavMeshTemplate: invalid GameAIManager")
 	//
@@ -1710,6 +1977,13 @@ void NavMeshTemplate::setParametersDefaults()
 	mParameterTable.insert(ParameterNameValue("max_tiles", "128"));
 	mParameterTable.insert(ParameterNameValue("max_polys_per_tile", "32768"));
 	mParameterTable.insert(ParameterNameValue("tile_size", "32"));
+	//crowd
+	mParameterTable.insert(ParameterNameValue("max_crowd_agents", "128"));
+	mParameterTable.insert(ParameterNameValue("crowd_shards", "1"));
+	mParameterTable.insert(ParameterNameValue("crowd_threads", "0"));
+	//stats
+	mParameterTable.insert(ParameterNameValue("stats", "false"));
+	mParameterTable.insert(ParameterNameValue("stats_interval", "60"));
 	//area flags cost
 	//NAVMESH_POLYAREA_GROUND@NAVMESH_POLYFLAGS_WALK@1.0
 	mParameterTable.insert(ParameterNameValue("area_flags_cost", "0@0x01@1.0"));
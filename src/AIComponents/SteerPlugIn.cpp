@@ -35,6 +35,7 @@
 #include "Game/GamePhysicsManager.h"
 #include "SceneComponents/Model.h"
 #include "SceneComponents/InstanceOf.h"
+#include "Support/Lockstep.h"
 
 namespace ely
 {
@@ -387,6 +388,8 @@ SteerPlugIn::Result SteerPlugIn::addSteerVehicle(SMARTPTR(SteerVehicle)steerVehi
 
 			//add to the set of SteerVehicles
 			mSteerVehicles.insert(steerVehicle);
+			//lockstep: reproducible randomization of the added vehicle
+			Lockstep::seedRandom(steerVehicle->getOwnerObject()->objectId());
 			//do add to real update list
 			dynamic_cast<PlugIn*>(mPlugIn)->addVehicle(&steerVehicle->getAbstractVehicle());
 			//set steerVehicle reference to this plugin
@@ -658,6 +661,9 @@ void SteerPlugIn::update(void* data)
 	}
 #endif
 
+	//lockstep: reproducible random draws of this tick
+	Lockstep::seedRandom(mOwnerObject->objectId());
+
 #ifdef ELY_DEBUG
 		{
 			//lock (guard) the Drawers' mutex
@@ -774,8 +780,6 @@ SteerPlugInTemplate::SteerPlugInTemplate(PandaFramework* pandaFramework,
 {
 	CHECK_EXISTENCE_DEBUG(pandaFramework,
 			"OpenSteerPlugInTemplate::OpenSteerPlugInTemplate: invalid PandaFramework")
-	CHECK_EXISTENCE_DEBUG(windowFramework,
-			"OpenSteerPlugInTemplate::OpenSteerPlugInTemplate: invalid WindowFramework")
 	CHECK_EXISTENCE_DEBUG(GameAIManager::GetSingletonPtr(),
 			"OpenSteerPlugInTemplate::OpenSteerPlugInTemplate: invalid GameAIManager")
 	//
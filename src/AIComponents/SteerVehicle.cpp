@@ -516,7 +516,7 @@ void SteerVehicle::doUpdateSteerVehicle(const float currentTime,
 		//throw Move event (if enabled)
 		if (mMove.mEnable)
 		{
-			doThrowEvent(mMove);
+			doThrowEvent(mMove, EventBus::STEERVEHICLE_MOVE_EVENT);
 		}
 		//reset Steady event (if enabled and if thrown)
 		if (mSteady.mEnable and mSteady.mThrown)
@@ -538,7 +538,7 @@ void SteerVehicle::doUpdateSteerVehicle(const float currentTime,
 		//throw Steady event (if enabled)
 		if (mSteady.mEnable)
 		{
-			doThrowEvent(mSteady);
+			doThrowEvent(mSteady, EventBus::STEERVEHICLE_STEADY_EVENT);
 		}
 	}
 
@@ -650,8 +650,6 @@ SteerVehicleTemplate::SteerVehicleTemplate(PandaFramework* pandaFramework,
 {
 	CHECK_EXISTENCE_DEBUG(pandaFramework,
 			"OpenSteerVehicleTemplate::OpenSteerVehicleTemplate: invalid PandaFramework")
-	CHECK_EXISTENCE_DEBUG(windowFramework,
-			"OpenSteerVehicleTemplate::OpenSteerVehicleTemplate: invalid WindowFramework")
 	CHECK_EXISTENCE_DEBUG(GameAIManager::GetSingletonPtr(),
 			"OpenSteerVehicleTemplate::OpenSteerVehicleTemplate: invalid GameAIManager")
 	//
@@ -179,8 +179,6 @@ ListenerTemplate::ListenerTemplate(PandaFramework* pandaFramework,
 {
 	CHECK_EXISTENCE_DEBUG(pandaFramework,
 			"ListenerTemplate::ListenerTemplate: invalid PandaFramework")
-	CHECK_EXISTENCE_DEBUG(windowFramework,
-			"ListenerTemplate::ListenerTemplate: invalid WindowFramework")
 	CHECK_EXISTENCE_DEBUG(GameAudioManager::GetSingletonPtr(),
 			"ListenerTemplate::ListenerTemplate: invalid GameAudioManager")
 	//
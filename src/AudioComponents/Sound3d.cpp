@@ -49,6 +49,13 @@ bool Sound3d::initialize()
 	mSceneRootId = ObjectId(mTmpl->parameter(std::string("scene_root")));
 	//sound files
 	mSoundFileListParam = mTmpl->parameterList(std::string("sound_files"));
+	//priority
+	float value = strtof(mTmpl->parameter(std::string("priority")).c_str(),
+			NULL);
+	mPriority = (value > 0.0 ? value : 1.0);
+	//audible distance
+	mAudibleDistance = strtof(
+			mTmpl->parameter(std::string("audible_distance")).c_str(), NULL);
 	//
 	return result;
 }
@@ -78,12 +85,12 @@ void Sound3d::onAddToObjectSetup()
 					//sound name == nameFilePair[0]
 					//sound file name == nameFilePair[1]
 					SMARTPTR(AudioSound)sound =
-					GameAudioManager::GetSingletonPtr()->audioMgr()->get_sound(
-							nameFilePair[1], true).p();
+					GameAudioManager::GetSingletonPtr()->getSound(
+							nameFilePair[1], true);
 					if (not sound.is_null())
 					{
 						//an empty ("") sound name is allowed
-						mSounds[nameFilePair[0]] = sound;
+						doSetSound(nameFilePair[0], sound);
 					}
 				}
 			}
@@ -124,6 +131,16 @@ void Sound3d::onRemoveFromObjectCleanup()
 			iter->second->stop();
 		}
 	}
+	//remove voices and release sounds
+	VoiceTable::iterator voiceIter;
+	for (voiceIter = mVoices.begin(); voiceIter != mVoices.end(); ++voiceIter)
+	{
+		GameAudioManager::GetSingletonPtr()->removeVoice(voiceIter->second);
+	}
+	for (iter = mSounds.begin(); iter != mSounds.end(); ++iter)
+	{
+		GameAudioManager::GetSingletonPtr()->releaseSound(iter->second);
+	}
 	//
 	reset();
 }
@@ -168,12 +185,11 @@ Sound3d::Result Sound3d::addSound(const std::string& soundName, const std::strin
 
 		//get the sound from fileName
 		SMARTPTR(AudioSound)sound =
-		GameAudioManager::GetSingletonPtr()->audioMgr()->get_sound(fileName,
-				true).p();
+		GameAudioManager::GetSingletonPtr()->getSound(fileName, true);
 		if (sound)
 		{
 			//add sound with soundName
-			mSounds[soundName] = sound;
+			doSetSound(soundName, sound);
 			result = Result::OK;
 			// try to add this component to updating (if not present)
 			// only if object is dynamic
@@ -206,6 +222,7 @@ Sound3d::Result Sound3d::removeSound(const std::string& soundName)
 		HOLD_REMUTEX(mMutex)
 
 		//make mSounds modifications
+		doRemoveSound(soundName);
 		size_t removed = mSounds.erase(soundName);
 		if (removed == 1)
 		{
@@ -224,6 +241,46 @@ Sound3d::Result Sound3d::removeSound(const std::string& soundName)
 	return result;
 }
 
+Sound3d::Result Sound3d::stopSound(const std::string& soundName)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	//return if destroying
+	RETURN_ON_ASYNC_COND(mDestroying, Result::DESTROYING)
+
+	VoiceTable::iterator iter = mVoices.find(soundName);
+	RETURN_ON_COND(iter == mVoices.end(), Result::ERROR)
+
+	GameAudioManager::GetSingletonPtr()->stopVoice(iter->second);
+	return Result::OK;
+}
+
+void Sound3d::doSetSound(const std::string& soundName,
+		SMARTPTR(AudioSound) sound)
+{
+	//replace any previous voice
+	doRemoveSound(soundName);
+	mSounds[soundName] = sound;
+	mVoices[soundName] = GameAudioManager::GetSingletonPtr()->addVoice(sound,
+			mPriority, mAudibleDistance);
+}
+
+void Sound3d::doRemoveSound(const std::string& soundName)
+{
+	VoiceTable::iterator iter = mVoices.find(soundName);
+	if (iter != mVoices.end())
+	{
+		GameAudioManager::GetSingletonPtr()->removeVoice(iter->second);
+		mVoices.erase(iter);
+	}
+	SoundTable::iterator soundIter = mSounds.find(soundName);
+	if (soundIter != mSounds.end())
+	{
+		GameAudioManager::GetSingletonPtr()->releaseSound(soundIter->second);
+	}
+}
+
 void Sound3d::setMinDistance(float dist)
 {
 	//lock (guard) the mutex
@@ -277,6 +334,12 @@ void Sound3d::doSet3dStaticAttributes()
 		iter->second->set_3d_attributes(mPosition.get_x(), mPosition.get_y(),
 				mPosition.get_z(), 0.0, 0.0, 0.0);
 	}
+	VoiceTable::iterator voiceIter;
+	for (voiceIter = mVoices.begin(); voiceIter != mVoices.end(); ++voiceIter)
+	{
+		GameAudioManager::GetSingletonPtr()->setVoiceAttributes(
+				voiceIter->second, mPosition, LVector3f::zero());
+	}
 }
 
 SMARTPTR(AudioSound)Sound3d::getSound(const std::string& soundName)
@@ -330,24 +393,39 @@ void Sound3d::update(void* data)
 	dt = 0.016666667; //60 fps
 #endif
 
+	//gather the position only if there are active (playing or virtual) voices
+	bool active = false;
+	VoiceTable::iterator iter;
+	for (iter = mVoices.begin(); (iter != mVoices.end()) and (not active);
+			++iter)
+	{
+		active = GameAudioManager::GetSingletonPtr()->isVoiceActive(
+				iter->second);
+	}
+	if (not active)
+	{
+		mWasActive = false;
+		return;
+	}
 	//get the new position
 	//note on threading: this should be an atomic operation
 	LPoint3f newPosition = mOwnerObject->getNodePath().get_pos(mSceneRoot);
-	//get the velocity (mPosition holds the previous position)
+	//get the velocity (mPosition holds the previous position, which is
+	//stale if there were no active voices)
 	LVector3f deltaPos = (newPosition - mPosition);
 	LVector3f velocity;
-	dt > 0.0 ? velocity = deltaPos / dt : velocity = LVector3f::zero();
-	//update sounds' velocity and position
-	SoundTable::iterator iter;
-	for (iter = mSounds.begin(); iter != mSounds.end(); ++iter)
+	(dt > 0.0) and mWasActive ?
+			velocity = deltaPos / dt : velocity = LVector3f::zero();
+	//update voices' velocity and position: these are applied to sounds
+	//by the audio manager for real voices only
+	for (iter = mVoices.begin(); iter != mVoices.end(); ++iter)
 	{
-		//note on threading: this should be an atomic operation
-		iter->second->set_3d_attributes(newPosition.get_x(),
-				newPosition.get_y(), newPosition.get_z(), velocity.get_x(),
-				velocity.get_y(), velocity.get_z());
+		GameAudioManager::GetSingletonPtr()->setVoiceAttributes(iter->second,
+				newPosition, velocity);
 	}
 	//update current position
 	mPosition = newPosition;
+	mWasActive = true;
 }
 
 //TypedObject semantics: hardcoded
@@ -361,8 +439,6 @@ Sound3dTemplate::Sound3dTemplate(PandaFramework* pandaFramework,
 {
 	CHECK_EXISTENCE_DEBUG(pandaFramework,
 			"Sound3dTemplate::Sound3dTemplate: invalid PandaFramework")
-	CHECK_EXISTENCE_DEBUG(windowFramework,
-			"Sound3dTemplate::Sound3dTemplate: invalid WindowFramework")
 	CHECK_EXISTENCE_DEBUG(GameAudioManager::GetSingletonPtr(),
 			"Sound3dTemplate::Sound3dTemplate: invalid GameAudioManager")
 	//
@@ -404,6 +480,8 @@ void Sound3dTemplate::setParametersDefaults()
 	mParameterTable.clear();
 	//sets the (mandatory) parameters to their default values:
 	mParameterTable.insert(ParameterNameValue("scene_root", "render"));
+	mParameterTable.insert(ParameterNameValue("priority", "1.0"));
+	mParameterTable.insert(ParameterNameValue("audible_distance", "0.0"));
 }
 
 //TypedObject semantics: hardcoded
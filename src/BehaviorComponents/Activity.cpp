@@ -23,6 +23,7 @@
 
 #include "BehaviorComponents/Activity.h"
 #include "ObjectModel/Object.h"
+#include "ObjectModel/FunctionRegistry.h"
 #include "Game/GameBehaviorManager.h"
 #include "Game/GameManager.h"
 
@@ -30,8 +31,11 @@ namespace ely
 {
 
 Activity::Activity(SMARTPTR(ActivityTemplate)tmpl) :
-		mFSM("FSM"), mTransitionLib(NULL), mTransitionsLoaded(false),
-		mInstanceUpdateLib(NULL), mInstanceUpdate(NULL), mInstanceUpdateName("")
+		mFSM("FSM"), mFastFSM("FastFSM", *this), mUseFastFSM(false),
+		mTransitionsLoaded(false), mInstanceUpdate(NULL),
+		mInstanceBatchUpdate(NULL), mInstanceUpdateName(""), mTickPeriod(0.0),
+		mScheduleStateId(afsm::Null), mScheduleTransitions(0),
+		mScheduleChecked(false)
 {
 	mTmpl = tmpl;
 	reset();
@@ -52,6 +56,14 @@ bool Activity::initialize()
 			std::string("from_to_transition"));
 	//update function name
 	mInstanceUpdateName = mTmpl->parameter(std::string("instance_update"));
+	//fast fsm
+	mUseFastFSM = (mTmpl->parameter(std::string("fast_fsm"))
+			== std::string("true"));
+	//tick periods
+	float value = strtof(mTmpl->parameter(std::string("tick_period")).c_str(),
+			NULL);
+	mTickPeriod = (value >= 0.0 ? value : 0.0);
+	mTickPeriodListParam = mTmpl->parameterList(std::string("tick_periods"));
 	//
 	return result;
 }
@@ -227,6 +239,30 @@ void Activity::doSetupTransitionTableData()
 
 void Activity::onAddToObjectSetup()
 {
+	//setup tick periods
+	mTickPeriods.clear();
+	std::list<std::string>::const_iterator iter;
+	for (iter = mTickPeriodListParam.begin();
+			iter != mTickPeriodListParam.end(); ++iter)
+	{
+		//each one is "state1@period1:state2@period2:...:stateN@periodN"
+		std::vector<std::string> statePeriods = parseCompoundString(*iter,
+				':');
+		std::vector<std::string>::const_iterator iterSP;
+		for (iterSP = statePeriods.begin(); iterSP != statePeriods.end();
+				++iterSP)
+		{
+			std::vector<std::string> statePeriod = parseCompoundString(*iterSP,
+					'@');
+			if ((statePeriod.size() >= 2) and (not statePeriod[0].empty()))
+			{
+				float value = strtof(statePeriod[1].c_str(), NULL);
+				mTickPeriods[statePeriod[0]] = (value >= 0.0 ? value : 0.0);
+			}
+		}
+	}
+	mTickPeriodListParam.clear();
+
 	//setup the FSM
 	doSetupFSMData();
 	//setup the Transition Table
@@ -257,19 +293,104 @@ void Activity::onRemoveFromObjectCleanup()
 
 void Activity::onAddToSceneSetup()
 {
-	if ((not mInstanceUpdateName.empty()) and mInstanceUpdate)
+	//the fast fsm performs posted requests at update
+	if (((not mInstanceUpdateName.empty()) and mInstanceUpdate) or mUseFastFSM)
 	{
-		GameBehaviorManager::GetSingletonPtr()->addToBehaviorUpdate(this);
+		GameBehaviorManager::GetSingletonPtr()->addToActivityUpdate(this);
 	}
 }
 
 void Activity::onRemoveFromSceneCleanup()
 {
-	if ((not mInstanceUpdateName.empty()) and mInstanceUpdate)
+	if (((not mInstanceUpdateName.empty()) and mInstanceUpdate) or mUseFastFSM)
 	{
 		//remove from behavior update
-		GameBehaviorManager::GetSingletonPtr()->removeFromBehaviorUpdate(this);
+		GameBehaviorManager::GetSingletonPtr()->removeFromActivityUpdate(this);
+	}
+}
+
+float Activity::getTickPeriod(const std::string& state) const
+{
+	std::map<std::string, float>::const_iterator iter = mTickPeriods.find(
+			state);
+	return iter != mTickPeriods.end() ? iter->second : mTickPeriod;
+}
+
+std::string Activity::getCurrentState()
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	return mUseFastFSM ?
+			mFastFSM.getStateKey(mFastFSM.getCurrentOrNextState()) :
+			mFSM.getCurrentOrNextState();
+}
+
+void Activity::forceState(const std::string& state)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	if (mUseFastFSM)
+	{
+		afsm::StateId stateId = mFastFSM.getStateId(state);
+		if ((stateId >= 0) and (stateId != mFastFSM.getCurrentOrNextState()))
+		{
+			mFastFSM.forceTransition(stateId);
+		}
+	}
+	else if (state != mFSM.getCurrentOrNextState())
+	{
+		mFSM.forceTransition(state);
+	}
+}
+
+void Activity::write_datagram(BamWriter* manager, Datagram& dg)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	Component::write_datagram(manager, dg);
+	dg.add_string(getCurrentState());
+}
+
+void Activity::fillin(DatagramIterator& scan, BamReader* manager)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	Component::fillin(scan, manager);
+	forceState(scan.get_string());
+}
+
+bool Activity::doCheckScheduleState(std::string& state)
+{
+	if (mUseFastFSM)
+	{
+		//compare ids only
+		int stateId = mFastFSM.getCurrentOrNextState();
+		RETURN_ON_COND(stateId == mScheduleStateId, false)
+
+		mScheduleStateId = stateId;
+		mScheduleState = mFastFSM.getStateKey(stateId);
 	}
+	else
+	{
+		//compare states only if a transition happened meanwhile
+		unsigned int transitions = mFSM.getNumTransitions();
+		RETURN_ON_COND(mScheduleChecked and (transitions == mScheduleTransitions),
+				false)
+
+		mScheduleTransitions = transitions;
+		std::string currentState = mFSM.getCurrentOrNextState();
+		RETURN_ON_COND(mScheduleChecked and (currentState == mScheduleState),
+				false)
+
+		mScheduleState = currentState;
+	}
+	mScheduleChecked = true;
+	state = mScheduleState;
+	return true;
 }
 
 void Activity::doLoadTransitionFunctions()
@@ -279,33 +400,16 @@ void Activity::doLoadTransitionFunctions()
 	{
 		return;
 	}
-	// reset errors
-	lt_dlerror();
-	//load the transition functions library
-	mTransitionLib = lt_dlopen(
-			GameManager::GetSingletonPtr()->getDataInfo(
-					GameManager::TRANSITIONS).c_str());
-	if (mTransitionLib == NULL)
-	{
-		std::cerr << "Error loading library: "
-				<< GameManager::GetSingletonPtr()->getDataInfo(
-						GameManager::TRANSITIONS) << ": " << lt_dlerror()
-				<< std::endl;
-		return;
-	}
-
 	//for each state load transition functions' names
 	std::map<std::string, TransitionNameTriple>::const_iterator iterTable;
 	for (iterTable = mStateTransitionTable.begin();
 			iterTable != mStateTransitionTable.end(); ++iterTable)
 	{
-		const char* dlsymError;
 		std::string functionName, functionNameTmp;
 
-		//reset errors
-		lt_dlerror();
 		//set enter functionName
-		if (not iterTable->second.mEnter.empty())
+		bool shared = iterTable->second.mEnter.empty();
+		if (not shared)
 		{
 			//set enter function name as specified (if any)
 			functionName = iterTable->second.mEnter;
@@ -318,19 +422,16 @@ void Activity::doLoadTransitionFunctions()
 			functionName = replaceCharacter(functionNameTmp, '-', '_');
 
 		}
-		PENTER pEnterFunction = (PENTER) lt_dlsym(mTransitionLib,
-				functionName.c_str());
-		dlsymError = lt_dlerror();
-		if (dlsymError)
+		PENTER pEnterFunction = reinterpret_cast<PENTER>(doFindFunction(
+				FunctionRegistry::TRANSITIONS, functionName, shared));
+		if (not pEnterFunction)
 		{
-			PRINT_ERR_DEBUG("Cannot load " << functionName << ": " << dlsymError);
-			pEnterFunction = NULL;
+			PRINT_ERR_DEBUG("Cannot load " << functionName);
 		}
 
-		//reset errors
-		lt_dlerror();
 		//set exit functionName
-		if (not iterTable->second.mExit.empty())
+		shared = iterTable->second.mExit.empty();
+		if (not shared)
 		{
 			//set exit function name as specified (if any)
 			functionName = iterTable->second.mExit;
@@ -342,19 +443,16 @@ void Activity::doLoadTransitionFunctions()
 					+ mOwnerObject->objectTmpl()->objectType();
 			functionName = replaceCharacter(functionNameTmp, '-', '_');
 		}
-		PEXIT pExitFunction = (PEXIT) lt_dlsym(mTransitionLib,
-				functionName.c_str());
-		dlsymError = lt_dlerror();
-		if (dlsymError)
+		PEXIT pExitFunction = reinterpret_cast<PEXIT>(doFindFunction(
+				FunctionRegistry::TRANSITIONS, functionName, shared));
+		if (not pExitFunction)
 		{
-			PRINT_ERR_DEBUG("Cannot load " << functionName << ": " << dlsymError);
-			pExitFunction = NULL;
+			PRINT_ERR_DEBUG("Cannot load " << functionName);
 		}
 
-		//reset errors
-		lt_dlerror();
 		//set filter functionName
-		if (not iterTable->second.mFilter.empty())
+		shared = iterTable->second.mFilter.empty();
+		if (not shared)
 		{
 			//set filter function name as specified (if any)
 			functionName = iterTable->second.mFilter;
@@ -366,15 +464,22 @@ void Activity::doLoadTransitionFunctions()
 					+ "_" + mOwnerObject->objectTmpl()->objectType();
 			functionName = replaceCharacter(functionNameTmp, '-', '_');
 		}
-		PFILTER pFilterFunction = (PFILTER) lt_dlsym(mTransitionLib,
-				functionName.c_str());
-		dlsymError = lt_dlerror();
-		if (dlsymError)
+		PFILTER pFilterFunction = reinterpret_cast<PFILTER>(doFindFunction(
+				FunctionRegistry::TRANSITIONS, functionName, shared));
+		if (not pFilterFunction)
 		{
-			PRINT_ERR_DEBUG("Cannot load " << functionName << ": " << dlsymError);
-			pFilterFunction = NULL;
+			PRINT_ERR_DEBUG("Cannot load " << functionName);
 		}
 		//add the state with the current transition functions
+		if (mUseFastFSM)
+		{
+			//the loaded functions have the fast FSM signatures
+			mFastFSM.addState(iterTable->first,
+					(afsm::EnterFunc) pEnterFunction,
+					(afsm::ExitFunc) pExitFunction,
+					(afsm::FilterFunc) pFilterFunction);
+			continue;
+		}
 		fsm::EnterFuncPTR enterFunc = NULL;
 		if (pEnterFunction != NULL)
 		{
@@ -400,16 +505,14 @@ void Activity::doLoadTransitionFunctions()
 	for (iterTable1 = mStatePairFromToTable.begin();
 			iterTable1 != mStatePairFromToTable.end(); ++iterTable1)
 	{
-		const char* dlsymError;
 		std::string stateA, stateB, functionName, functionNameTmp;
 
-		//reset errors
-		lt_dlerror();
 		//set states
 		stateA = iterTable1->first.first;
 		stateB = iterTable1->first.second;
 		//set FromTo functionName
-		if (not iterTable1->second.empty())
+		bool shared = iterTable1->second.empty();
+		if (not shared)
 		{
 			//set FromTo function name as specified (if any)
 			functionName = iterTable1->second;
@@ -421,15 +524,22 @@ void Activity::doLoadTransitionFunctions()
 					+ mOwnerObject->objectTmpl()->objectType();
 			functionName = replaceCharacter(functionNameTmp, '-', '_');
 		}
-		PFROMTO pFromToFunction = (PFROMTO) lt_dlsym(mTransitionLib,
-				functionName.c_str());
-		dlsymError = lt_dlerror();
-		if (dlsymError)
+		PFROMTO pFromToFunction = reinterpret_cast<PFROMTO>(doFindFunction(
+				FunctionRegistry::TRANSITIONS, functionName, shared));
+		if (not pFromToFunction)
 		{
-			PRINT_ERR_DEBUG("Cannot load " << functionName << ": " << dlsymError);
-			pFromToFunction = NULL;
+			PRINT_ERR_DEBUG("Cannot load " << functionName);
 		}
 		//add the FromTo function
+		if (mUseFastFSM)
+		{
+			if (pFromToFunction != NULL)
+			{
+				mFastFSM.addFromToFunc(stateA, stateB,
+						(afsm::FromToFunc) pFromToFunction);
+			}
+			continue;
+		}
 		mFSM.addFromToFunc(stateA, stateB,
 				boost::bind(pFromToFunction, _1, boost::ref(*this), _2));
 	}
@@ -448,16 +558,7 @@ void Activity::doUnloadTransitionFunctions()
 	{
 		return;
 	}
-	//Close the transition functions library
-	// reset errors
-	lt_dlerror();
-	if (lt_dlclose(mTransitionLib) != 0)
-	{
-		std::cerr << "Error closing library: "
-				<< GameManager::GetSingletonPtr()->getDataInfo(
-						GameManager::TRANSITIONS) << ": " << lt_dlerror()
-				<< std::endl;
-	}
+	//the transition functions library is owned by the FunctionRegistry
 	//transitions unloaded
 	mTransitionsLoaded = false;
 }
@@ -467,38 +568,25 @@ void Activity::doLoadInstanceUpdate()
 	//if instance updates already loaded do nothing
 	RETURN_ON_COND(mInstanceUpdate,)
 
-	// reset errors
-	lt_dlerror();
-	//load the instance updates library
-	mInstanceUpdateLib =
-			lt_dlopen(
-					GameManager::GetSingletonPtr()->getDataInfo(
-							GameManager::INSTANCEUPDATES).c_str());
-	if (mInstanceUpdateLib == NULL)
-	{
-		std::cerr << "Error loading library: "
-				<< GameManager::GetSingletonPtr()->getDataInfo(
-						GameManager::INSTANCEUPDATES) << ": " << lt_dlerror()
-				<< std::endl;
-		return;
-	}
-	// reset errors
-	lt_dlerror();
 	//set the instance update function (if any)
 	if (not mInstanceUpdateName.empty())
 	{
-		mInstanceUpdate = (PINSTANCEUPDATE) lt_dlsym(mInstanceUpdateLib,
-				mInstanceUpdateName.c_str());
-		const char* dlsymError = lt_dlerror();
-		if (dlsymError)
+		//usually shared by the Activities of this template
+		FunctionCache& functions = mTmpl->functionCache();
+		mInstanceUpdate = functions.find<PINSTANCEUPDATE>(
+				FunctionRegistry::INSTANCEUPDATES, mInstanceUpdateName);
+		if (not mInstanceUpdate)
 		{
 			PRINT_ERR_DEBUG(
 					"Cannot find instance update function \"" <<
-					mInstanceUpdateName << "\": "<< dlsymError);
-			//mInstanceUpdate == NULL;
+					mInstanceUpdateName << "\"");
 			//cannot load instance update function
 			return;
 		}
+		//the batch version is optional
+		mInstanceBatchUpdate = functions.find<PINSTANCEBATCHUPDATE>(
+				FunctionRegistry::INSTANCEUPDATES,
+				mInstanceUpdateName + "_Batch");
 	}
 }
 
@@ -507,18 +595,9 @@ void Activity::doUnloadInstanceUpdate()
 	//if instance updates not loaded do nothing
 	RETURN_ON_COND(not mInstanceUpdate,)
 
-	//Close the event instance updates library
-	// reset errors
-	lt_dlerror();
-	if (lt_dlclose(mInstanceUpdateLib) != 0)
-	{
-		std::cerr << "Error closing library: "
-				<< GameManager::GetSingletonPtr()->getDataInfo(
-						GameManager::INSTANCEUPDATES) << ": " << lt_dlerror()
-				<< std::endl;
-	}
-	//
+	//the instance updates library is owned by the FunctionRegistry
 	mInstanceUpdate = NULL;
+	mInstanceBatchUpdate = NULL;
 }
 
 void Activity::update(void* data)
@@ -526,17 +605,23 @@ void Activity::update(void* data)
 	//lock (guard) the mutex
 	HOLD_REMUTEX(mMutex)
 
-	float dt = *(reinterpret_cast<float*>(data));
+	RETURN_ON_ASYNC_COND(mDestroying,)
 
-#ifdef TESTING
-	dt = 0.016666667; //60 fps
-#endif
+	//called by GameBehaviorManager with the time elapsed since the last
+	//update (it is already fixed when TESTING)
+	float dt = *(reinterpret_cast<float*>(data));
 
-#ifdef ELY_DEBUG
-	RETURN_ON_COND(not mInstanceUpdate,)
-#endif
+	//perform requests posted to the fast fsm
+	if (mUseFastFSM)
+	{
+		mFastFSM.processRequests();
+	}
 	//update should be called if and only if mInstanceUpdate != NULL
-	mInstanceUpdate(dt, *this);
+	//or the fast fsm is used
+	if (mInstanceUpdate)
+	{
+		mInstanceUpdate(dt, *this);
+	}
 }
 
 //TypedObject semantics: hardcoded
@@ -550,8 +635,6 @@ ActivityTemplate::ActivityTemplate(PandaFramework* pandaFramework,
 {
 	CHECK_EXISTENCE_DEBUG(pandaFramework,
 			"ActivityTemplate::ActivityTemplate: invalid PandaFramework")
-	CHECK_EXISTENCE_DEBUG(windowFramework,
-			"ActivityTemplate::ActivityTemplate: invalid WindowFramework")
 	//
 	setParametersDefaults();
 }
@@ -591,6 +674,8 @@ void ActivityTemplate::setParametersDefaults()
 	mParameterTable.clear();
 	//sets the (mandatory) parameters to their default values:
 	mParameterTable.insert(ParameterNameValue("instance_update", ""));
+	mParameterTable.insert(ParameterNameValue("fast_fsm", "false"));
+	mParameterTable.insert(ParameterNameValue("tick_period", "0.0"));
 }
 
 //TypedObject semantics: hardcoded
@@ -39,9 +39,6 @@ Default::~Default()
 //TypedObject semantics: hardcoded
 TypeHandle Default::_type_handle;
 
-//MemoryPool semantics: hardcoded
-GCC_MEMORYPOOL_DEFINITION(Default);
-
 ///Template
 
 DefaultTemplate::DefaultTemplate(PandaFramework* pandaFramework,
@@ -22,8 +22,13 @@
  */
 
 #include "ControlComponents/Chaser.h"
+#include "SceneComponents/Terrain.h"
 #include "Game/GameControlManager.h"
 #include "Game/GamePhysicsManager.h"
+#include "Support/Replay.h"
+#include <bulletSphereShape.h>
+#include <boundingSphere.h>
+#include <cmath>
 
 namespace ely
 {
@@ -133,6 +138,43 @@ bool Chaser::initialize()
 	NULL);
 	mSensY = (value >= 0.0 ? value : -value);
 	mHeadSensY = mSensY * 375.0;
+	//occlusion check
+	mOcclusionCheck = (
+			mTmpl->parameter(std::string("occlusion_check"))
+					== std::string("false") ? false : true);
+	//sweep radius
+	value = strtof(mTmpl->parameter(std::string("sweep_radius")).c_str(),
+	NULL);
+	mSweepRadius = (value >= 0.0 ? value : -value);
+	//sweep mask
+	std::string sweepMask = mTmpl->parameter(std::string("sweep_mask"));
+	if (sweepMask == std::string("all_on"))
+	{
+		mSweepMask = BitMask32::all_on();
+	}
+	else if (sweepMask == std::string("all_off"))
+	{
+		mSweepMask = BitMask32::all_off();
+	}
+	else
+	{
+		uint32_t mask = (uint32_t) strtol(sweepMask.c_str(), NULL, 0);
+		mSweepMask.set_word(mask);
+	}
+	//cache lifetime
+	value = strtof(mTmpl->parameter(std::string("cache_lifetime")).c_str(),
+	NULL);
+	mCacheLifetime = (value >= 0.0 ? value : -value);
+	//cache tolerance
+	value = strtof(mTmpl->parameter(std::string("cache_tolerance")).c_str(),
+	NULL);
+	mCacheTolerance = (value >= 0.0 ? value : -value);
+	//terrain object id
+	mTerrainId = ObjectId(mTmpl->parameter(std::string("terrain_object")));
+	//height cell size
+	value = strtof(mTmpl->parameter(std::string("height_cell_size")).c_str(),
+	NULL);
+	mHeightCellSize = (value > 0.0 ? value : (value < 0.0 ? -value : 1.0));
 	//
 	return result;
 }
@@ -166,10 +208,25 @@ void Chaser::onAddToObjectSetup()
 			mReferenceNodePath = mChasedNodePath.get_parent();
 		}
 	}
+	//create the shape used for occlusion sweep tests
+	if (mOcclusionCheck)
+	{
+		mSweepShape = new BulletSphereShape(mSweepRadius);
+	}
 	//
-	GraphicsWindow* win = mTmpl->windowFramework()->get_graphics_window();
-	mCentX = win->get_properties().get_x_size() / 2;
-	mCentY = win->get_properties().get_y_size() / 2;
+	GraphicsWindow* win =
+			mTmpl->windowFramework() ?
+					mTmpl->windowFramework()->get_graphics_window() : NULL;
+	if (win)
+	{
+		mCentX = win->get_properties().get_x_size() / 2;
+		mCentY = win->get_properties().get_y_size() / 2;
+	}
+	else
+	{
+		//headless: pointer input only from a replay
+		mCentX = mCentY = 0;
+	}
 }
 
 void Chaser::onRemoveFromObjectCleanup()
@@ -181,9 +238,13 @@ void Chaser::onRemoveFromObjectCleanup()
 		//show mouse cursor
 		WindowProperties props;
 		props.set_cursor_hidden(false);
-		SMARTPTR(GraphicsWindow)win =
-		mTmpl->windowFramework()->get_graphics_window();
-		win->request_properties(props);
+		GraphicsWindow* win =
+				mTmpl->windowFramework() ?
+						mTmpl->windowFramework()->get_graphics_window() : NULL;
+		if (win)
+		{
+			win->request_properties(props);
+		}
 	}
 	//
 	reset();
@@ -252,11 +313,15 @@ void Chaser::doEnable()
 		//hide mouse cursor
 		WindowProperties props;
 		props.set_cursor_hidden(true);
-		SMARTPTR(GraphicsWindow)win =
-		mTmpl->windowFramework()->get_graphics_window();
-		win->request_properties(props);
-		//reset mouse to start position
-		win->move_pointer(0, mCentX, mCentY);
+		GraphicsWindow* win =
+				mTmpl->windowFramework() ?
+						mTmpl->windowFramework()->get_graphics_window() : NULL;
+		if (win)
+		{
+			win->request_properties(props);
+			//reset mouse to start position
+			win->move_pointer(0, mCentX, mCentY);
+		}
 	}
 	//
 	mFixedLookAtNodePath = mOwnerObject->getNodePath().get_parent().attach_new_node(
@@ -319,9 +384,13 @@ void Chaser::doDisable()
 		//show mouse cursor
 		WindowProperties props;
 		props.set_cursor_hidden(false);
-		SMARTPTR(GraphicsWindow)win =
-		mTmpl->windowFramework()->get_graphics_window();
-		win->request_properties(props);
+		GraphicsWindow* win =
+				mTmpl->windowFramework() ?
+						mTmpl->windowFramework()->get_graphics_window() : NULL;
+		if (win)
+		{
+			win->request_properties(props);
+		}
 	}
 	//
 #ifdef ELY_THREAD
@@ -331,6 +400,25 @@ void Chaser::doDisable()
 	mEnabled = false;
 }
 
+bool Chaser::doGetPointerDelta(float& deltaX, float& deltaY)
+{
+	bool moved = false;
+	deltaX = deltaY = 0.0;
+	GraphicsWindow* win =
+			mTmpl->windowFramework() ?
+					mTmpl->windowFramework()->get_graphics_window() : NULL;
+	if (win)
+	{
+		MouseData md = win->get_pointer(0);
+		deltaX = md.get_x() - mCentX;
+		deltaY = md.get_y() - mCentY;
+		moved = win->move_pointer(0, mCentX, mCentY);
+	}
+	//recorded or replayed
+	Replay::pointerInput(mOwnerObject->objectId(), moved, deltaX, deltaY);
+	return moved;
+}
+
 void Chaser::update(void* data)
 {
 	//lock (guard) the mutex
@@ -384,6 +472,13 @@ void Chaser::update(void* data)
 			newPos = currentChaserPos;
 		}
 	}
+	//keep the chased object in sight
+	if (mOcclusionCheck)
+	{
+		doCorrectChaserOcclusion(newPos,
+				mReferenceNodePath.get_relative_point(mChasedNodePath,
+						mLookAtPosition));
+	}
 	//
 	mOwnerObject->getNodePath().set_pos(mReferenceNodePath, newPos);
 	//orientation
@@ -401,13 +496,8 @@ void Chaser::update(void* data)
 		bool wantRotate = false;
 		if (mMouseEnabledH or mMouseEnabledP)
 		{
-			GraphicsWindow* win =
-					mTmpl->windowFramework()->get_graphics_window();
-			MouseData md = win->get_pointer(0);
-			float deltaX = md.get_x() - mCentX;
-			float deltaY = md.get_y() - mCentY;
-
-			if (win->move_pointer(0, mCentX, mCentY))
+			float deltaX, deltaY;
+			if (doGetPointerDelta(deltaX, deltaY))
 			{
 				if (mMouseEnabledH and (deltaX != 0.0))
 				{
@@ -506,11 +596,7 @@ LPoint3f Chaser::doGetChaserPos(LPoint3f desiredChaserPos,
 void Chaser::doCorrectChaserHeight(LPoint3f& newPos, float baseHeight)
 {
 	//correct chaser height (not in OgreBulletDemos)
-	LPoint3f downTo = LPoint3f(newPos.get_x(), newPos.get_y(), -1000000.0);
-	BulletClosestHitRayResult result =
-			GamePhysicsManager::GetSingleton().bulletWorld()->ray_test_closest(
-					newPos, downTo);
-	float hitPosZ = max(result.get_hit_pos().get_z(), baseHeight);
+	float hitPosZ = doGetGroundHeight(newPos, baseHeight);
 	if (newPos.get_z() < hitPosZ + mAbsMinHeight)
 	{
 		newPos.set_z(hitPosZ + mAbsMinHeight);
@@ -521,6 +607,237 @@ void Chaser::doCorrectChaserHeight(LPoint3f& newPos, float baseHeight)
 	}
 }
 
+void Chaser::doCorrectChaserOcclusion(LPoint3f& newPos,
+		const LPoint3f& lookAtPos)
+{
+	//bullet world is wrt the scene graph root
+	NodePath worldNP = mReferenceNodePath.get_top();
+	LPoint3f from = worldNP.get_relative_point(mReferenceNodePath, lookAtPos);
+	LPoint3f to = worldNP.get_relative_point(mReferenceNodePath, newPos);
+	double now = ClockObject::get_global_clock()->get_frame_time();
+	//reuse the last result if still valid
+	if (not (mSweepCache.mValid
+			and (now - mSweepCache.mTime <= mCacheLifetime)
+			and ((from - mSweepCache.mFrom).length() <= mCacheTolerance)
+			and ((to - mSweepCache.mTo).length() <= mCacheTolerance)))
+	{
+		//the look at point is inside the chased object: start the sweep
+		//outside its bounds, otherwise its body would hide the obstacles
+		LVector3f sweepDir = to - from;
+		float sweepLength = sweepDir.length();
+		float start = 0.0;
+		if (sweepLength > 0.0)
+		{
+			sweepDir /= sweepLength;
+			start = doGetChasedExit(from, sweepDir, worldNP) + mSweepRadius;
+		}
+		mSweepCache.mHit = false;
+		mSweepCache.mHitFraction = 1.0;
+		if (start < sweepLength)
+		{
+			//sweep a sphere from there to the desired position
+			BulletClosestHitSweepResult result =
+					BulletClosestHitSweepResult::empty();
+			{
+				HOLD_REMUTEX(GamePhysicsManager::GetSingletonPtr()->getMutex())
+				result =
+						GamePhysicsManager::GetSingleton().bulletWorld()->sweep_test_closest(
+								mSweepShape.p(),
+								*TransformState::make_pos(
+										from + sweepDir * start),
+								*TransformState::make_pos(to), mSweepMask);
+			}
+			//the closest hit on the chaser itself hides nothing; hits on the
+			//chased object (a concave part) are not occlusions either
+			mSweepCache.mHit = result.has_hit()
+					and (result.get_node() != mChasedNodePath.node())
+					and (result.get_node() != mOwnerObject->getNodePath().node());
+			//the fraction along the whole segment
+			mSweepCache.mHitFraction = (start
+					+ result.get_hit_fraction() * (sweepLength - start))
+					/ sweepLength;
+		}
+		mSweepCache.mFrom = from;
+		mSweepCache.mTo = to;
+		mSweepCache.mTime = now;
+		mSweepCache.mValid = true;
+	}
+	//move in front of the obstacle
+	if (mSweepCache.mHit)
+	{
+		newPos = lookAtPos + (newPos - lookAtPos) * mSweepCache.mHitFraction;
+	}
+}
+
+float Chaser::doGetChasedExit(const LPoint3f& from, const LVector3f& dir,
+		const NodePath& worldNP)
+{
+	CPT(BoundingVolume)bounds = mChasedNodePath.get_bounds();
+	RETURN_ON_COND(not bounds->is_of_type(BoundingSphere::get_class_type()),
+			0.0)
+	const BoundingSphere* sphere = DCAST(BoundingSphere, bounds);
+	RETURN_ON_COND(sphere->is_empty() or sphere->is_infinite(), 0.0)
+
+	//the bounding sphere wrt world
+	LPoint3f center = worldNP.get_relative_point(mChasedNodePath,
+			sphere->get_center());
+	LVecBase3f scale = mChasedNodePath.get_scale(worldNP);
+	float radius = sphere->get_radius()
+			* max(fabs(scale.get_x()), max(fabs(scale.get_y()), fabs(scale.get_z())));
+	return getSphereExit(from, dir, center, radius);
+}
+
+float Chaser::getSphereExit(const LPoint3f& from, const LVector3f& dir,
+		const LPoint3f& center, float radius)
+{
+	//farthest intersection of the ray from -> dir with the sphere
+	LVector3f delta = from - center;
+	float b = delta.dot(dir);
+	float disc = b * b - (delta.length_squared() - radius * radius);
+	RETURN_ON_COND(disc < 0.0, 0.0)
+
+	return max(0.0f, -b + sqrt(disc));
+}
+
+float Chaser::doGetGroundHeight(const LPoint3f& pos, float baseHeight)
+{
+	float height;
+	//common case: the heightfield answers
+	if (doGetTerrainHeight(pos, height))
+	{
+		return max(height, baseHeight);
+	}
+	//lookup the cache of coarse cells (wrt world)
+	NodePath worldNP = mReferenceNodePath.get_top();
+	LPoint3f worldPos = worldNP.get_relative_point(mReferenceNodePath, pos);
+	//the ray starts at pos: its height matters too
+	int cellX = (int) floor(worldPos.get_x() / mHeightCellSize);
+	int cellY = (int) floor(worldPos.get_y() / mHeightCellSize);
+	int cellZ = (int) floor(worldPos.get_z() / mHeightCellSize);
+	double now = ClockObject::get_global_clock()->get_frame_time();
+	if (mHeightCache.lookup(cellX, cellY, cellZ, mHeightCacheStamp, now,
+			mCacheLifetime, height))
+	{
+		return max(height, baseHeight);
+	}
+	//cache miss: ray down, but not below the base height
+	LPoint3f worldDownTo = worldNP.get_relative_point(mReferenceNodePath,
+			LPoint3f(pos.get_x(), pos.get_y(), baseHeight));
+	BulletClosestHitRayResult result = BulletClosestHitRayResult::empty();
+	{
+		HOLD_REMUTEX(GamePhysicsManager::GetSingletonPtr()->getMutex())
+		result =
+				GamePhysicsManager::GetSingleton().bulletWorld()->ray_test_closest(
+						worldPos, worldDownTo);
+	}
+	height = baseHeight;
+	if (result.has_hit())
+	{
+		height = mReferenceNodePath.get_relative_point(worldNP,
+				result.get_hit_pos()).get_z();
+	}
+	mHeightCache.store(cellX, cellY, cellZ, mHeightCacheStamp, now, height);
+	//
+	return max(height, baseHeight);
+}
+
+bool Chaser::doGetTerrainHeight(const LPoint3f& pos, float& height)
+{
+	//the terrain object could have been destroyed (or its terrain
+	//component swapped) meanwhile
+	SMARTPTR(Component) sceneComp;
+	SMARTPTR(Object) terrainObject = (
+			mTerrainId != ObjectId() ?
+					ObjectTemplateManager::GetSingleton().getCreatedObject(
+							mTerrainId) :
+					SMARTPTR(Object)());
+	if (terrainObject)
+	{
+		sceneComp = terrainObject->getComponent(ComponentFamilyType("Scene"));
+		if (sceneComp
+				and (sceneComp->componentType() != ComponentType("Terrain")))
+		{
+			sceneComp.clear();
+		}
+	}
+	//a different terrain: the cached heights are stale
+	if (sceneComp != mHeightCacheTerrain)
+	{
+		mHeightCacheTerrain = sceneComp;
+		++mHeightCacheStamp;
+		mHeightCache.invalidate();
+	}
+	RETURN_ON_COND(not sceneComp, false)
+	//paged terrain: heights are known only by its (resident) physics pages
+	RETURN_ON_COND(DCAST(Terrain, sceneComp)->getUpdateMode() == Terrain::PAGED,
+			false)
+
+	GeoMipTerrainRef& terrain = DCAST(Terrain, sceneComp)->getGeoMipTerrain();
+	NodePath terrainRootNP = terrain.get_root();
+	//heightfield coordinates
+	LPoint3f terrainPos = terrainRootNP.get_relative_point(mReferenceNodePath,
+			pos);
+	float x = terrainPos.get_x();
+	float y = terrainPos.get_y();
+	if ((x < 0.0) or (y < 0.0)
+			or (x > terrain.heightfield().get_x_size() - 1)
+			or (y > terrain.heightfield().get_y_size() - 1))
+	{
+		return false;
+	}
+	//elevation is in [0,1], scaled by the terrain root transform
+	height = mReferenceNodePath.get_relative_point(terrainRootNP,
+			LPoint3f(x, y, terrain.get_elevation(x, y))).get_z();
+	return true;
+}
+
+Chaser::HeightCache::HeightCache()
+{
+	invalidate();
+}
+
+void Chaser::HeightCache::invalidate()
+{
+	for (int i = 0; i < SIZE; ++i)
+	{
+		mEntries[i].mValid = false;
+	}
+	mNext = 0;
+}
+
+bool Chaser::HeightCache::lookup(int cellX, int cellY, int cellZ,
+		unsigned int terrain, double now, double lifetime, float& height) const
+{
+	for (int i = 0; i < SIZE; ++i)
+	{
+		const Entry& entry = mEntries[i];
+		if (entry.mValid and (entry.mCellX == cellX)
+				and (entry.mCellY == cellY) and (entry.mCellZ == cellZ)
+				and (entry.mTerrain == terrain)
+				and (now - entry.mTime <= lifetime))
+		{
+			height = entry.mHeight;
+			return true;
+		}
+	}
+	return false;
+}
+
+void Chaser::HeightCache::store(int cellX, int cellY, int cellZ,
+		unsigned int terrain, double now, float height)
+{
+	//replace the oldest entry
+	Entry& entry = mEntries[mNext];
+	entry.mValid = true;
+	entry.mCellX = cellX;
+	entry.mCellY = cellY;
+	entry.mCellZ = cellZ;
+	entry.mTerrain = terrain;
+	entry.mHeight = height;
+	entry.mTime = now;
+	mNext = (mNext + 1) % SIZE;
+}
+
 //TypedObject semantics: hardcoded
 TypeHandle Chaser::_type_handle;
 
@@ -532,8 +849,6 @@ ChaserTemplate::ChaserTemplate(PandaFramework* pandaFramework,
 {
 	CHECK_EXISTENCE_DEBUG(pandaFramework,
 			"DriverTemplate::ChaserTemplate: invalid PandaFramework")
-	CHECK_EXISTENCE_DEBUG(windowFramework,
-			"DriverTemplate::ChaserTemplate: invalid WindowFramework")
 	CHECK_EXISTENCE_DEBUG(GameControlManager::GetSingletonPtr(),
 			"DriverTemplate::ChaserTemplate: invalid GameControlManager")
 	//
@@ -588,6 +903,12 @@ void ChaserTemplate::setParametersDefaults()
 	mParameterTable.insert(ParameterNameValue("sens_x", "0.2"));
 	mParameterTable.insert(ParameterNameValue("sens_y", "0.2"));
 	mParameterTable.insert(ParameterNameValue("inverted_rotation", "false"));
+	mParameterTable.insert(ParameterNameValue("occlusion_check", "true"));
+	mParameterTable.insert(ParameterNameValue("sweep_radius", "0.5"));
+	mParameterTable.insert(ParameterNameValue("sweep_mask", "all_on"));
+	mParameterTable.insert(ParameterNameValue("cache_lifetime", "0.1"));
+	mParameterTable.insert(ParameterNameValue("cache_tolerance", "0.25"));
+	mParameterTable.insert(ParameterNameValue("height_cell_size", "2.0"));
 }
 
 //TypedObject semantics: hardcoded
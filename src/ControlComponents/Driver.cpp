@@ -24,6 +24,7 @@
 #include "ControlComponents/Driver.h"
 #include "ObjectModel/Object.h"
 #include "Game/GameControlManager.h"
+#include "Support/Replay.h"
 #include <cmath>
 
 namespace ely
@@ -203,9 +204,19 @@ bool Driver::initialize()
 void Driver::onAddToObjectSetup()
 {
 	//
-	GraphicsWindow* win = mTmpl->windowFramework()->get_graphics_window();
-	mCentX = win->get_properties().get_x_size() / 2;
-	mCentY = win->get_properties().get_y_size() / 2;
+	GraphicsWindow* win =
+			mTmpl->windowFramework() ?
+					mTmpl->windowFramework()->get_graphics_window() : NULL;
+	if (win)
+	{
+		mCentX = win->get_properties().get_x_size() / 2;
+		mCentY = win->get_properties().get_y_size() / 2;
+	}
+	else
+	{
+		//headless: pointer input only from a replay
+		mCentX = mCentY = 0;
+	}
 }
 
 void Driver::onRemoveFromObjectCleanup()
@@ -217,9 +228,13 @@ void Driver::onRemoveFromObjectCleanup()
 		//show mouse cursor
 		WindowProperties props;
 		props.set_cursor_hidden(false);
-		SMARTPTR(GraphicsWindow)win =
-		mTmpl->windowFramework()->get_graphics_window();
-		win->request_properties(props);
+		GraphicsWindow* win =
+				mTmpl->windowFramework() ?
+						mTmpl->windowFramework()->get_graphics_window() : NULL;
+		if (win)
+		{
+			win->request_properties(props);
+		}
 	}
 	//
 	reset();
@@ -269,11 +284,15 @@ void Driver::doEnable()
 		//hide mouse cursor
 		WindowProperties props;
 		props.set_cursor_hidden(true);
-		SMARTPTR(GraphicsWindow)win =
-		mTmpl->windowFramework()->get_graphics_window();
-		win->request_properties(props);
-		//reset mouse to start position
-		win->move_pointer(0, mCentX, mCentY);
+		GraphicsWindow* win =
+				mTmpl->windowFramework() ?
+						mTmpl->windowFramework()->get_graphics_window() : NULL;
+		if (win)
+		{
+			win->request_properties(props);
+			//reset mouse to start position
+			win->move_pointer(0, mCentX, mCentY);
+		}
 	}
 	//
 	mEnabled = true;
@@ -327,9 +346,13 @@ void Driver::doDisable()
 		//show mouse cursor
 		WindowProperties props;
 		props.set_cursor_hidden(false);
-		SMARTPTR(GraphicsWindow)win =
-		mTmpl->windowFramework()->get_graphics_window();
-		win->request_properties(props);
+		GraphicsWindow* win =
+				mTmpl->windowFramework() ?
+						mTmpl->windowFramework()->get_graphics_window() : NULL;
+		if (win)
+		{
+			win->request_properties(props);
+		}
 	}
 	//
 #ifdef ELY_THREAD
@@ -339,6 +362,47 @@ void Driver::doDisable()
 	mEnabled = false;
 }
 
+void Driver::write_datagram(BamWriter* manager, Datagram& dg)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	Component::write_datagram(manager, dg);
+	mActualSpeedXYZ.write_datagram(dg);
+	dg.add_float32(mActualSpeedH);
+	dg.add_float32(mActualSpeedP);
+}
+
+void Driver::fillin(DatagramIterator& scan, BamReader* manager)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	Component::fillin(scan, manager);
+	mActualSpeedXYZ.read_datagram(scan);
+	mActualSpeedH = scan.get_float32();
+	mActualSpeedP = scan.get_float32();
+}
+
+bool Driver::doGetPointerDelta(float& deltaX, float& deltaY)
+{
+	bool moved = false;
+	deltaX = deltaY = 0.0;
+	GraphicsWindow* win =
+			mTmpl->windowFramework() ?
+					mTmpl->windowFramework()->get_graphics_window() : NULL;
+	if (win)
+	{
+		MouseData md = win->get_pointer(0);
+		deltaX = md.get_x() - mCentX;
+		deltaY = md.get_y() - mCentY;
+		moved = win->move_pointer(0, mCentX, mCentY);
+	}
+	//recorded or replayed
+	Replay::pointerInput(mOwnerObject->objectId(), moved, deltaX, deltaY);
+	return moved;
+}
+
 void Driver::update(void* data)
 {
 	//lock (guard) the mutex
@@ -355,12 +419,8 @@ void Driver::update(void* data)
 	//handle mouse
 	if (mMouseMove and (mMouseEnabledH or mMouseEnabledP))
 	{
-		GraphicsWindow* win = mTmpl->windowFramework()->get_graphics_window();
-		MouseData md = win->get_pointer(0);
-		float deltaX = md.get_x() - mCentX;
-		float deltaY = md.get_y() - mCentY;
-
-		if (win->move_pointer(0, mCentX, mCentY))
+		float deltaX, deltaY;
+		if (doGetPointerDelta(deltaX, deltaY))
 		{
 			if (mMouseEnabledH and (deltaX != 0.0))
 			{
@@ -723,8 +783,6 @@ DriverTemplate::DriverTemplate(PandaFramework* pandaFramework,
 {
 	CHECK_EXISTENCE_DEBUG(pandaFramework,
 			"DriverTemplate::DriverTemplate: invalid PandaFramework")
-	CHECK_EXISTENCE_DEBUG(windowFramework,
-			"DriverTemplate::DriverTemplate: invalid WindowFramework")
 	CHECK_EXISTENCE_DEBUG(GameControlManager::GetSingletonPtr(),
 			"DriverTemplate::DriverTemplate: invalid GameControlManager")
 	//
@@ -22,6 +22,9 @@
  */
 
 #include "Game/GameAIManager.h"
+#include "Support/FrameArena.h"
+#include "Support/Profiler.h"
+#include "Support/Lockstep.h"
 #include "Game/GameManager.h"
 
 namespace ely
@@ -89,7 +92,8 @@ void GameAIManager::addToAIUpdate(SMARTPTR(Component)aiComp)
 	mAIComponents.end(), aiComp);
 	if (iter == mAIComponents.end())
 	{
-		mAIComponents.push_back(aiComp);
+		mAIComponents.insert(
+				Lockstep::getInsertPosition(mAIComponents, aiComp), aiComp);
 	}
 }
 
@@ -125,6 +129,9 @@ AsyncTask::DoneStatus GameAIManager::update(GenericAsyncTask* task)
 	{
 		//lock (guard) the mutex
 		HOLD_REMUTEX(mMutex)
+		//scratch memory is released at the end of the update
+		FrameArena::Scope scratch;
+		PROFILE_ZONE("GameAIManager::update");
 
 		//XXX: HACK
 		if (mStartFrame > 0)
@@ -134,7 +141,7 @@ AsyncTask::DoneStatus GameAIManager::update(GenericAsyncTask* task)
 		else
 		{
 
-			float dt = ClockObject::get_global_clock()->get_dt();
+			float dt = Lockstep::getFrameDt();
 
 #ifdef TESTING
 			dt = 0.016666667; //60 fps
@@ -142,11 +149,14 @@ AsyncTask::DoneStatus GameAIManager::update(GenericAsyncTask* task)
 
 			// call all AI components update functions, passing delta time
 			AIComponentList::iterator iter;
+			ProfileTypeBatch profileBatch;
 			for (iter = mAIComponents.begin(); iter != mAIComponents.end();
 					++iter)
 			{
+				profileBatch.next(*iter);
 				(*iter)->update(reinterpret_cast<void*>(&dt));
 			}
+			profileBatch.end();
 		}
 	}
 #ifdef ELY_THREAD
@@ -22,11 +22,41 @@
  */
 
 #include "Game/GameAudioManager.h"
+#include "Support/FrameArena.h"
+#include "Support/Profiler.h"
+#include "Support/Lockstep.h"
 #include "Game/GameManager.h"
+#include <virtualFileSystem.h>
+#include <config_util.h>
+#include <algorithm>
+#include <cmath>
 
 namespace ely
 {
 
+namespace
+{
+///Default number of real voices.
+const int DEFAULT_VOICE_BUDGET = 32;
+///Default size (bytes) beyond which sound files are streamed.
+const unsigned long int DEFAULT_STREAM_THRESHOLD = 2 * 1024 * 1024;
+
+///Orders (candidate) voice indexes by decreasing score.
+struct VoiceScoreGreater
+{
+	VoiceScoreGreater(const std::vector<float>& scores) :
+			mScores(scores)
+	{
+	}
+	bool operator()(int v1, int v2) const
+	{
+		return mScores[v1] > mScores[v2];
+	}
+private:
+	const std::vector<float>& mScores;
+};
+}
+
 GameAudioManager::GameAudioManager(
 #ifdef ELY_THREAD
 		Mutex& managersMutex, ConditionVarFull& managersVar,
@@ -48,6 +78,17 @@ GameAudioManager::GameAudioManager(
 	mUpdateData.clear();
 	mUpdateTask.clear();
 	mAudioMgr = AudioManager::create_AudioManager();
+	//voices
+	mVoices.clear();
+	mFreeVoices.clear();
+	mVoiceBudget = DEFAULT_VOICE_BUDGET;
+	mVoiceStats.mReal = mVoiceStats.mVirtual = mVoiceStats.mVirtualized =
+			mVoiceStats.mRealized = 0;
+	//sound bank
+	mSoundBank.clear();
+	mSoundInstances.clear();
+	mStreamThreshold = DEFAULT_STREAM_THRESHOLD;
+	mSoundBankHits = mSoundBankMisses = 0;
 	//create the task for updating the active audio components
 	mUpdateData = new TaskInterface<GameAudioManager>::TaskData(this,
 			&GameAudioManager::update);
@@ -79,6 +120,10 @@ GameAudioManager::~GameAudioManager()
 		AsyncTaskManager::get_global_ptr()->remove(mUpdateTask);
 	}
 	mAudioComponents.clear();
+	mVoices.clear();
+	mFreeVoices.clear();
+	mSoundInstances.clear();
+	mSoundBank.clear();
 }
 
 void GameAudioManager::addToAudioUpdate(SMARTPTR(Component) audioComp)
@@ -90,7 +135,9 @@ void GameAudioManager::addToAudioUpdate(SMARTPTR(Component) audioComp)
 			mAudioComponents.end(), audioComp);
 	if (iter == mAudioComponents.end())
 	{
-		mAudioComponents.push_back(audioComp);
+		mAudioComponents.insert(
+				Lockstep::getInsertPosition(mAudioComponents, audioComp),
+				audioComp);
 	}
 }
 
@@ -112,6 +159,319 @@ SMARTPTR(AudioManager) GameAudioManager::audioMgr() const
 	return mAudioMgr;
 }
 
+int GameAudioManager::addVoice(SMARTPTR(AudioSound) sound, float priority,
+		float audibleDistance)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	int handle;
+	if (not mFreeVoices.empty())
+	{
+		handle = mFreeVoices.back();
+		mFreeVoices.pop_back();
+	}
+	else
+	{
+		handle = mVoices.size();
+		mVoices.push_back(Voice());
+	}
+	Voice& voice = mVoices[handle];
+	voice.mSound = sound;
+	voice.mPriority = (priority > 0.0 ? priority : 1.0);
+	voice.mAudibleDistance = audibleDistance;
+	voice.mPosition = LPoint3f::zero();
+	voice.mVelocity = LVector3f::zero();
+	voice.mVirtual = false;
+	voice.mVirtualTime = 0.0;
+	voice.mVirtualStart = 0.0;
+	voice.mScore = -1.0;
+	voice.mValid = true;
+	return handle;
+}
+
+void GameAudioManager::removeVoice(int handle)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	RETURN_ON_COND((handle < 0) or (handle >= (int) mVoices.size())
+			or (not mVoices[handle].mValid),)
+
+	mVoices[handle].mSound.clear();
+	mVoices[handle].mValid = false;
+	mFreeVoices.push_back(handle);
+}
+
+void GameAudioManager::setVoiceAttributes(int handle,
+		const LPoint3f& position, const LVector3f& velocity)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	RETURN_ON_COND((handle < 0) or (handle >= (int) mVoices.size()),)
+
+	mVoices[handle].mPosition = position;
+	mVoices[handle].mVelocity = velocity;
+}
+
+bool GameAudioManager::isVoiceActive(int handle)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	RETURN_ON_COND((handle < 0) or (handle >= (int) mVoices.size())
+			or (not mVoices[handle].mValid), false)
+
+	Voice& voice = mVoices[handle];
+	return voice.mVirtual or (voice.mSound->status() == AudioSound::PLAYING);
+}
+
+bool GameAudioManager::isVoiceVirtual(int handle)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	RETURN_ON_COND((handle < 0) or (handle >= (int) mVoices.size())
+			or (not mVoices[handle].mValid), false)
+
+	return mVoices[handle].mVirtual;
+}
+
+void GameAudioManager::stopVoice(int handle)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	RETURN_ON_COND((handle < 0) or (handle >= (int) mVoices.size())
+			or (not mVoices[handle].mValid),)
+
+	mVoices[handle].mVirtual = false;
+	mVoices[handle].mSound->stop();
+}
+
+void GameAudioManager::setVoiceBudget(int budget)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	mVoiceBudget = (budget >= 0 ? budget : 0);
+}
+
+SMARTPTR(AudioSound) GameAudioManager::getSound(const Filename& fileName,
+		bool positional, SoundLoadMode mode)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	SMARTPTR(AudioSound) sound;
+	std::string key = fileName.get_fullpath();
+	SoundBank::iterator iter = mSoundBank.find(key);
+	if (iter != mSoundBank.end())
+	{
+		//the audio manager shares the cached sample data, while
+		//the prototype keeps it from being evicted
+		sound = mAudioMgr->get_sound(fileName, positional,
+				iter->second.mStream ?
+						AudioManager::SM_stream : AudioManager::SM_sample).p();
+		RETURN_ON_COND(not sound, NULL)
+
+		++iter->second.mRefCount;
+		++mSoundBankHits;
+	}
+	else
+	{
+		bool stream = (mode == STREAM)
+				or ((mode == AUTO) and doIsLongFile(fileName));
+		sound = mAudioMgr->get_sound(fileName, positional,
+				stream ? AudioManager::SM_stream : AudioManager::SM_sample).p();
+		RETURN_ON_COND(not sound, NULL)
+
+		SoundBankEntry& entry = mSoundBank[key];
+		entry.mPrototype = sound;
+		entry.mStream = stream;
+		entry.mRefCount = 1;
+		++mSoundBankMisses;
+	}
+	mSoundInstances[sound.p()] = key;
+	return sound;
+}
+
+void GameAudioManager::releaseSound(SMARTPTR(AudioSound) sound)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	std::map<AudioSound*, std::string>::iterator instIter =
+			mSoundInstances.find(sound.p());
+	RETURN_ON_COND(instIter == mSoundInstances.end(),)
+
+	SoundBank::iterator iter = mSoundBank.find(instIter->second);
+	mSoundInstances.erase(instIter);
+	RETURN_ON_COND(iter == mSoundBank.end(),)
+
+	if (--iter->second.mRefCount == 0)
+	{
+		//last instance: evict the file's data
+		iter->second.mPrototype->stop();
+		iter->second.mPrototype.clear();
+		mAudioMgr->uncache_sound(Filename(iter->first));
+		mSoundBank.erase(iter);
+	}
+}
+
+void GameAudioManager::setStreamThreshold(unsigned long int bytes)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	mStreamThreshold = bytes;
+}
+
+GameAudioManager::SoundBankStats GameAudioManager::getSoundBankStats()
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	SoundBankStats stats;
+	stats.mSamples = stats.mStreams = 0;
+	SoundBank::const_iterator iter;
+	for (iter = mSoundBank.begin(); iter != mSoundBank.end(); ++iter)
+	{
+		iter->second.mStream ? ++stats.mStreams : ++stats.mSamples;
+	}
+	stats.mInstances = mSoundInstances.size();
+	stats.mHits = mSoundBankHits;
+	stats.mMisses = mSoundBankMisses;
+	return stats;
+}
+
+bool GameAudioManager::doIsLongFile(const Filename& fileName)
+{
+	//sound files are searched along the model path
+	Filename path(fileName);
+	VirtualFileSystem* vfs = VirtualFileSystem::get_global_ptr();
+	RETURN_ON_COND(not vfs->resolve_filename(path, get_model_path()), false)
+
+	PT(VirtualFile) file = vfs->get_file(path);
+	return file and (file->get_file_size() > mStreamThreshold);
+}
+
+void GameAudioManager::doUpdateVoices()
+{
+	mVoiceStats.mReal = mVoiceStats.mVirtual = mVoiceStats.mVirtualized =
+			mVoiceStats.mRealized = 0;
+	RETURN_ON_COND(mVoices.empty(),)
+
+	double now = ClockObject::get_global_clock()->get_frame_time();
+	//listener position
+	PN_stdfloat lx, ly, lz, vx, vy, vz, fx, fy, fz, ux, uy, uz;
+	mAudioMgr->audio_3d_get_listener_attributes(&lx, &ly, &lz, &vx, &vy, &vz,
+			&fx, &fy, &fz, &ux, &uy, &uz);
+	LPoint3f listenerPos(lx, ly, lz);
+	//candidates: active and audible voices
+	std::vector<float> scores(mVoices.size(), -1.0);
+	std::vector<int> candidates;
+	for (unsigned int v = 0; v < mVoices.size(); ++v)
+	{
+		Voice& voice = mVoices[v];
+		if ((not voice.mValid)
+				or ((not voice.mVirtual)
+						and (voice.mSound->status() != AudioSound::PLAYING)))
+		{
+			continue;
+		}
+		float distance = (voice.mPosition - listenerPos).length();
+		if ((voice.mAudibleDistance > 0.0)
+				and (distance > voice.mAudibleDistance))
+		{
+			//inaudible: virtual
+			if (not voice.mVirtual)
+			{
+				doVirtualizeVoice(voice, now);
+			}
+			continue;
+		}
+		scores[v] = voice.mPriority / (1.0 + distance);
+		candidates.push_back(v);
+	}
+	//the best ones (within budget) are real
+	std::sort(candidates.begin(), candidates.end(), VoiceScoreGreater(scores));
+	for (unsigned int c = 0; c < candidates.size(); ++c)
+	{
+		Voice& voice = mVoices[candidates[c]];
+		if (c < (unsigned int) mVoiceBudget)
+		{
+			if (voice.mVirtual and (not doRealizeVoice(voice, now)))
+			{
+				//finished while virtual
+				continue;
+			}
+			voice.mSound->set_3d_attributes(voice.mPosition.get_x(),
+					voice.mPosition.get_y(), voice.mPosition.get_z(),
+					voice.mVelocity.get_x(), voice.mVelocity.get_y(),
+					voice.mVelocity.get_z());
+		}
+		else if (not voice.mVirtual)
+		{
+			doVirtualizeVoice(voice, now);
+		}
+	}
+	//count
+	for (unsigned int v = 0; v < mVoices.size(); ++v)
+	{
+		Voice& voice = mVoices[v];
+		if (not voice.mValid)
+		{
+			continue;
+		}
+		if (voice.mVirtual)
+		{
+			//non looping virtual voices end as if they were playing
+			if ((not voice.mSound->get_loop())
+					and (voice.mVirtualTime + (now - voice.mVirtualStart)
+							>= voice.mSound->length()))
+			{
+				voice.mVirtual = false;
+				continue;
+			}
+			++mVoiceStats.mVirtual;
+		}
+		else if (voice.mSound->status() == AudioSound::PLAYING)
+		{
+			++mVoiceStats.mReal;
+		}
+	}
+}
+
+void GameAudioManager::doVirtualizeVoice(Voice& voice, double now)
+{
+	voice.mVirtualTime = voice.mSound->get_time();
+	voice.mVirtualStart = now;
+	voice.mVirtual = true;
+	voice.mSound->stop();
+	++mVoiceStats.mVirtualized;
+}
+
+bool GameAudioManager::doRealizeVoice(Voice& voice, double now)
+{
+	voice.mVirtual = false;
+	float time = voice.mVirtualTime + (now - voice.mVirtualStart);
+	float length = voice.mSound->length();
+	if (voice.mSound->get_loop() and (length > 0.0))
+	{
+		time = fmod(time, length);
+	}
+	else if (time >= length)
+	{
+		return false;
+	}
+	voice.mSound->set_time(time);
+	voice.mSound->play();
+	++mVoiceStats.mRealized;
+	return true;
+}
+
 AsyncTask::DoneStatus GameAudioManager::update(GenericAsyncTask* task)
 {
 #ifdef ELY_THREAD
@@ -131,8 +491,11 @@ AsyncTask::DoneStatus GameAudioManager::update(GenericAsyncTask* task)
 	{
 		//lock (guard) the mutex
 		HOLD_REMUTEX(mMutex)
+		//scratch memory is released at the end of the update
+		FrameArena::Scope scratch;
+		PROFILE_ZONE("GameAudioManager::update");
 
-		float dt = ClockObject::get_global_clock()->get_dt();
+		float dt = Lockstep::getFrameDt();
 
 #ifdef TESTING
 		dt = 0.016666667; //60 fps
@@ -140,11 +503,16 @@ AsyncTask::DoneStatus GameAudioManager::update(GenericAsyncTask* task)
 
 		// call all audio components update functions, passing delta time
 		AudioComponentList::iterator iter;
+		ProfileTypeBatch profileBatch;
 		for (iter = mAudioComponents.begin(); iter != mAudioComponents.end();
 				++iter)
 		{
+			profileBatch.next(*iter);
 			(*iter)->update(reinterpret_cast<void*>(&dt));
 		}
+		profileBatch.end();
+		//select real/virtual voices
+		doUpdateVoices();
 		//Update audio manager
 		mAudioMgr->update();
 	}
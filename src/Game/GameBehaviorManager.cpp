@@ -22,6 +22,9 @@
  */
 
 #include "Game/GameBehaviorManager.h"
+#include "Support/FrameArena.h"
+#include "Support/Profiler.h"
+#include "Support/Lockstep.h"
 #include "Game/GameManager.h"
 
 namespace ely
@@ -45,6 +48,10 @@ GameBehaviorManager::GameBehaviorManager(
 	CHECK_EXISTENCE_DEBUG(GameManager::GetSingletonPtr(),
 			"GameBehaviorManager::GameBehaviorManager: invalid GameManager")
 	mBehaviorComponents.clear();
+	mActivityScheduler.clear();
+	mNumActivities = 0;
+	mActivityStats.mGroups = mActivityStats.mActivities =
+			mActivityStats.mTicked = mActivityStats.mRegrouped = 0;
 	mUpdateData.clear();
 	mUpdateTask.clear();
 	//create the task for updating Behavior components
@@ -78,6 +85,7 @@ GameBehaviorManager::~GameBehaviorManager()
 		AsyncTaskManager::get_global_ptr()->remove(mUpdateTask);
 	}
 	mBehaviorComponents.clear();
+	mActivityScheduler.clear();
 }
 
 void GameBehaviorManager::addToBehaviorUpdate(SMARTPTR(Component)behaviorComp)
@@ -89,7 +97,9 @@ void GameBehaviorManager::addToBehaviorUpdate(SMARTPTR(Component)behaviorComp)
 			mBehaviorComponents.end(), behaviorComp);
 	if (iter == mBehaviorComponents.end())
 	{
-		mBehaviorComponents.push_back(behaviorComp);
+		mBehaviorComponents.insert(
+				Lockstep::getInsertPosition(mBehaviorComponents, behaviorComp),
+				behaviorComp);
 	}
 }
 
@@ -106,6 +116,177 @@ void GameBehaviorManager::removeFromBehaviorUpdate(SMARTPTR(Component)behaviorCo
 	}
 }
 
+void GameBehaviorManager::addToActivityUpdate(SMARTPTR(Activity) activity)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	RETURN_ON_COND(activity->mSchedule.mGroup >= 0,)
+
+	//force a state check
+	std::string state;
+	{
+		//lock (guard) the Activity mutex
+		HOLD_REMUTEX(activity->mMutex)
+
+		activity->doResetScheduleState();
+		activity->doCheckScheduleState(state);
+	}
+	doAddToGroup(activity, state);
+	++mNumActivities;
+}
+
+void GameBehaviorManager::removeFromActivityUpdate(
+		SMARTPTR(Activity) activity)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	RETURN_ON_COND(activity->mSchedule.mGroup < 0,)
+
+	mActivityScheduler.remove(activity);
+	--mNumActivities;
+}
+
+void GameBehaviorManager::doAddToGroup(SMARTPTR(Activity) activity,
+		const std::string& state)
+{
+	mActivityScheduler.add(activity,
+			ActivityKey(activity->mInstanceUpdate, state),
+			activity->getTickPeriod(state));
+}
+
+void GameBehaviorManager::doUpdateActivities(float dt)
+{
+	mActivityStats.mTicked = mActivityStats.mRegrouped = 0;
+	mActivityScheduler.advance(dt);
+	//check states: Activities which changed state are moved (and will be
+	//considered) into their new group
+	std::vector<std::pair<SMARTPTR(Activity), std::string> > changed;
+	for (int g = 0; g < mActivityScheduler.getNumGroups(); ++g)
+	{
+		const std::vector<SMARTPTR(Activity)>& activities =
+				mActivityScheduler.getMembers(g);
+		for (unsigned int a = 0; a < activities.size(); ++a)
+		{
+			Activity* activity = activities[a];
+			//lock (guard) the Activity mutex
+			HOLD_REMUTEX(activity->mMutex)
+#ifdef ELY_THREAD
+			if (activity->mDestroying)
+			{
+				continue;
+			}
+#endif
+			if (activity->mUseFastFSM)
+			{
+				activity->mFastFSM.processRequests();
+			}
+			std::string state;
+			if (activity->doCheckScheduleState(state))
+			{
+				changed.push_back(
+						std::pair<SMARTPTR(Activity), std::string>(activity,
+								state));
+			}
+		}
+	}
+	for (unsigned int c = 0; c < changed.size(); ++c)
+	{
+		mActivityScheduler.remove(changed[c].first);
+		doAddToGroup(changed[c].first, changed[c].second);
+	}
+	mActivityStats.mRegrouped = changed.size();
+	//update groups whose tick period is elapsed
+	mActivityStats.mGroups = 0;
+	for (int g = 0; g < mActivityScheduler.getNumGroups(); ++g)
+	{
+		unsigned int numActivities = mActivityScheduler.getMembers(g).size();
+		if (numActivities == 0)
+		{
+			continue;
+		}
+		++mActivityStats.mGroups;
+		//fast fsm only Activities have no instance update
+		if (not mActivityScheduler.getKey(g).first)
+		{
+			continue;
+		}
+		float elapsed = mActivityScheduler.tick(g, mActivityBatch,
+				mActivityOthers);
+		if (elapsed < 0.0)
+		{
+			continue;
+		}
+		//every Activity gets the time elapsed since its own last update
+		//(i.e. less than the group's if it joined meanwhile)
+		for (unsigned int a = 0; a < mActivityOthers.size(); ++a)
+		{
+			float othersElapsed = mActivityOthers[a].second;
+			mActivityOthers[a].first->update(
+					reinterpret_cast<void*>(&othersElapsed));
+		}
+		mActivityOthers.clear();
+		if (not mActivityBatch.empty())
+		{
+			Activity::PINSTANCEBATCHUPDATE batchUpdate =
+					mActivityBatch.front()->mInstanceBatchUpdate;
+			if (batchUpdate)
+			{
+				doBatchUpdate(elapsed, batchUpdate);
+			}
+			else
+			{
+				for (unsigned int a = 0; a < mActivityBatch.size(); ++a)
+				{
+					float batchElapsed = elapsed;
+					mActivityBatch[a]->update(
+							reinterpret_cast<void*>(&batchElapsed));
+				}
+				mActivityBatch.clear();
+			}
+		}
+		mActivityStats.mTicked += numActivities;
+	}
+	mActivityStats.mActivities = mNumActivities;
+}
+
+void GameBehaviorManager::doBatchUpdate(float dt,
+		Activity::PINSTANCEBATCHUPDATE batchUpdate)
+{
+#ifdef ELY_THREAD
+	//lock the Activities' mutexes, leaving out those being destroyed
+	unsigned int locked = 0;
+	for (unsigned int a = 0; a < mActivityBatch.size(); ++a)
+	{
+		mActivityBatch[a]->mMutex.acquire();
+		if (mActivityBatch[a]->mDestroying)
+		{
+			mActivityBatch[a]->mMutex.release();
+			continue;
+		}
+		mActivityBatch[locked++] = mActivityBatch[a];
+	}
+	mActivityBatch.resize(locked);
+#endif
+	for (unsigned int a = 0; a < mActivityBatch.size(); ++a)
+	{
+		//perform requests posted to the fast fsm (as Activity::update())
+		if (mActivityBatch[a]->mUseFastFSM)
+		{
+			mActivityBatch[a]->mFastFSM.processRequests();
+		}
+	}
+	batchUpdate(dt, mActivityBatch);
+#ifdef ELY_THREAD
+	for (unsigned int a = 0; a < mActivityBatch.size(); ++a)
+	{
+		mActivityBatch[a]->mMutex.release();
+	}
+#endif
+	mActivityBatch.clear();
+}
+
 AsyncTask::DoneStatus GameBehaviorManager::update(GenericAsyncTask* task)
 {
 #ifdef ELY_THREAD
@@ -125,8 +306,11 @@ AsyncTask::DoneStatus GameBehaviorManager::update(GenericAsyncTask* task)
 	{
 		//lock (guard) the mutex
 		HOLD_REMUTEX(mMutex)
+		//scratch memory is released at the end of the update
+		FrameArena::Scope scratch;
+		PROFILE_ZONE("GameBehaviorManager::update");
 
-		float dt = ClockObject::get_global_clock()->get_dt();
+		float dt = Lockstep::getFrameDt();
 
 #ifdef TESTING
 		dt = 0.016666667; //60 fps
@@ -134,11 +318,16 @@ AsyncTask::DoneStatus GameBehaviorManager::update(GenericAsyncTask* task)
 
 		// call all Behavior components update functions, passing delta time
 		BehaviorComponentList::iterator iter;
+		ProfileTypeBatch profileBatch;
 		for (iter = mBehaviorComponents.begin();
 				iter != mBehaviorComponents.end(); ++iter)
 		{
+			profileBatch.next(*iter);
 			(*iter)->update(reinterpret_cast<void*>(&dt));
 		}
+		profileBatch.end();
+		//scheduled Activities
+		doUpdateActivities(dt);
 	}
 #ifdef ELY_THREAD
 	//manager multithread
@@ -22,6 +22,9 @@
  */
 
 #include "Game/GameControlManager.h"
+#include "Support/FrameArena.h"
+#include "Support/Profiler.h"
+#include "Support/Lockstep.h"
 #include "Game/GameManager.h"
 
 namespace ely
@@ -89,7 +92,9 @@ void GameControlManager::addToControlUpdate(SMARTPTR(Component)controlComp)
 			mControlComponents.end(), controlComp);
 	if (iter == mControlComponents.end())
 	{
-		mControlComponents.push_back(controlComp);
+		mControlComponents.insert(
+				Lockstep::getInsertPosition(mControlComponents, controlComp),
+				controlComp);
 	}
 }
 
@@ -125,8 +130,11 @@ AsyncTask::DoneStatus GameControlManager::update(GenericAsyncTask* task)
 	{
 		//lock (guard) the mutex
 		HOLD_REMUTEX(mMutex)
+		//scratch memory is released at the end of the update
+		FrameArena::Scope scratch;
+		PROFILE_ZONE("GameControlManager::update");
 
-		float dt = ClockObject::get_global_clock()->get_dt();
+		float dt = Lockstep::getFrameDt();
 
 #ifdef TESTING
 		dt = 0.016666667; //60 fps
@@ -134,11 +142,14 @@ AsyncTask::DoneStatus GameControlManager::update(GenericAsyncTask* task)
 
 		// call all control components update functions, passing delta time
 		ControlComponentList::iterator iter;
+		ProfileTypeBatch profileBatch;
 		for (iter = mControlComponents.begin();
 				iter != mControlComponents.end(); ++iter)
 		{
+			profileBatch.next(*iter);
 			(*iter)->update(reinterpret_cast<void*>(&dt));
 		}
+		profileBatch.end();
 	}
 #ifdef ELY_THREAD
 	//manager multithread
@@ -25,6 +25,7 @@
 #include <rocketRegion.h>
 #include <Rocket/Debugger.h>
 #include "Game/GameManager.h"
+#include "Support/Replay.h"
 
 namespace ely
 {
@@ -96,6 +97,13 @@ void GameGUIManager::guiSetup()
 	Rocket::Debugger::Initialise(gGuiRocketContext);
 	Rocket::Debugger::SetVisible(true);
 #endif
+
+	//GUI events of a replayed session
+	if (Replay::GetSingletonPtr())
+	{
+		Replay::GetSingletonPtr()->setGuiEventHandler(
+				&MainEventListener::replayEvent);
+	}
 }
 
 void GameGUIManager::showMainMenu()
@@ -214,7 +222,52 @@ void MainEventListener::ProcessEvent(Rocket::Core::Event& event)
 	PRINT_DEBUG("");
 #endif
 
-	if (mValue == "MAIN::ENTER_GAME")
+	//record the event of a recorded session
+	Replay* replay = Replay::GetSingletonPtr();
+	if (replay and replay->isRecording())
+	{
+		ParameterTable params;
+		int pos = 0;
+		Rocket::Core::String paramKey;
+		Rocket::Core::Variant* paramValue;
+		while (event.GetParameters()->Iterate(pos, paramKey, paramValue))
+		{
+			params.insert(
+					ParameterNameValue(paramKey.CString(),
+							paramValue->Get<Rocket::Core::String>().CString()));
+		}
+		replay->recordGuiEvent(mValue.CString(), params);
+	}
+	processEvent(mValue, event);
+}
+
+void MainEventListener::replayEvent(const std::string& value,
+		const ParameterTable& params)
+{
+	Rocket::Core::Context* context =
+			GameGUIManager::GetSingletonPtr()->gGuiRocketContext;
+	RETURN_ON_COND(not context,)
+
+	//rebuild the event targeted to the root element
+	Rocket::Core::Dictionary parameters;
+	ParameterTable::const_iterator iter;
+	for (iter = params.begin(); iter != params.end(); ++iter)
+	{
+		parameters.Set(iter->first.c_str(),
+				Rocket::Core::String(iter->second.c_str()));
+	}
+	Rocket::Core::Event* event = Rocket::Core::Factory::InstanceEvent(
+			context->GetRootElement(), value.c_str(), parameters, false);
+	RETURN_ON_COND(not event,)
+
+	processEvent(value.c_str(), *event);
+	event->RemoveReference();
+}
+
+void MainEventListener::processEvent(const Rocket::Core::String& value,
+		Rocket::Core::Event& event)
+{
+	if (value == "MAIN::ENTER_GAME")
 	{
 		//call all registered commit functions
 		std::vector<void (*)()>::iterator iter;
@@ -231,11 +284,11 @@ void MainEventListener::ProcessEvent(Rocket::Core::Event& event)
 		//close (i.e. unload) the main document and set as closed..
 		GameGUIManager::GetSingletonPtr()->gGuiMainMenu->Close();
 	}
-	else if (mValue == "MAIN::EXIT_GAME")
+	else if (value == "MAIN::EXIT_GAME")
 	{
 		GameGUIManager::GetSingletonPtr()->showExitMenu();
 	}
-	else if (mValue == "EXIT::SUBMIT_EXIT")
+	else if (value == "EXIT::SUBMIT_EXIT")
 	{
 		Rocket::Core::String paramValue;
 		//check if ok or cancel
@@ -268,11 +321,11 @@ void MainEventListener::ProcessEvent(Rocket::Core::Event& event)
 	else
 	{
 		//check if it is a registered event name
-		if (GameGUIManager::GetSingletonPtr()->gGuiEventHandlers.find(mValue)
+		if (GameGUIManager::GetSingletonPtr()->gGuiEventHandlers.find(value)
 				!= GameGUIManager::GetSingletonPtr()->gGuiEventHandlers.end())
 		{
 			//call the registered event handler
-			GameGUIManager::GetSingletonPtr()->gGuiEventHandlers[mValue](mValue,
+			GameGUIManager::GetSingletonPtr()->gGuiEventHandlers[value](value,
 					event);
 		}
 	}
@@ -25,24 +25,52 @@
 #include "ObjectModel/ComponentTemplateManager.h"
 #include "ObjectModel/ObjectTemplateManager.h"
 #include "Utilities/ComponentSuite.h"
+#include "Support/XMLStream.h"
 #include "Support/tinyxlm2/tinyxml2.h"
+#include "Support/MemoryPool/ConcurrentMemoryPool.h"
 #include "Game/GameGUIManager.h"
+#include <configVariableBool.h>
+#include <configVariableDouble.h>
+#include <configVariableInt.h>
+#include <camera.h>
+#include <algorithm>
+#include <list>
 
 namespace ely
 {
 
 GameManager::GameManager(int argc, char* argv[]) :
-		PandaFramework()
+		PandaFramework(), mWindow(NULL), mHeadless(false), mHeadlessFrames(0),
+		mXMLStreaming(false)
 #ifdef ELY_DEBUG
 , mPhysicsDebugEnabled(false)
 #endif
 {
 	// Open the framework
 	open_framework(argc, argv);
-	// Set a nice title
-	set_window_title("Ely");
-	// Open it!
-	mWindow = open_window();
+	mGlobalClock = ClockObject::get_global_clock();
+	// Check headless mode: config variable or command line switch
+	ConfigVariableBool headless("ely-headless", false,
+			"Runs the game without window and GUI.");
+	mHeadless = headless;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::string(argv[i]) == std::string("--headless"))
+		{
+			mHeadless = true;
+		}
+	}
+	if (mHeadless)
+	{
+		doSetupHeadless();
+	}
+	else
+	{
+		// Set a nice title
+		set_window_title("Ely");
+		// Open it!
+		mWindow = open_window();
+	}
 	// Check whether the window is loaded correctly
 	if (mWindow != (WindowFramework*) NULL)
 	{
@@ -50,9 +78,11 @@ GameManager::GameManager(int argc, char* argv[]) :
 		// common setup
 		mWindow->enable_keyboard(); // Enable keyboard detection
 		mRender = mWindow->get_render();
-		mGlobalClock = ClockObject::get_global_clock();
+		mRender2d = mWindow->get_render_2d();
+		mAspect2d = mWindow->get_aspect_2d();
+		mCameraGroup = mWindow->get_camera_group();
 	}
-	else
+	else if (not mHeadless)
 	{
 		PRINT_DEBUG("Could not load the window!");
 	}
@@ -64,6 +94,10 @@ GameManager::GameManager(int argc, char* argv[]) :
 
 GameManager::~GameManager()
 {
+	if (mHeadlessTask)
+	{
+		AsyncTaskManager::get_global_ptr()->remove(mHeadlessTask);
+	}
 	// close the framework
 	close_framework();
 }
@@ -84,7 +118,10 @@ void GameManager::gameSetup()
 	//</DEFAULT CAMERA CONTROL>
 
 #ifdef ELY_DEBUG
-	GamePhysicsManager::GetSingletonPtr()->initDebug(mWindow);
+	if (mWindow)
+	{
+		GamePhysicsManager::GetSingletonPtr()->initDebug(mWindow);
+	}
 	mPhysicsDebugEnabled = false;
 #endif
 
@@ -97,8 +134,11 @@ void GameManager::gameSetup()
 	//create the game world (static definition)
 	createGameWorld(mInfoDB[CONFIGFILE]);
 
-	//gui system initialization
-	GameGUIManager::GetSingletonPtr()->guiSetup();
+	//gui system initialization (not if headless)
+	if (not mHeadless)
+	{
+		GameGUIManager::GetSingletonPtr()->guiSetup();
+	}
 
 	//play the game
 	GamePlay();
@@ -108,6 +148,8 @@ void GameManager::gameCleanup()
 {
 	//destroy all created game Objects
 	ObjectTemplateManager::GetSingletonPtr()->destroyAllObjects();
+	//give back the memory pools' blocks no longer used
+	SizeClassPools::trim();
 }
 
 void GameManager::GamePlay()
@@ -209,6 +251,8 @@ void GameManager::setupCompTmplMgr()
 
 namespace
 {
+using namespace ely;
+
 bool checkTag(tinyxml2::XMLElement* tag, const char* tagStr)
 {
 	if (not tag)
@@ -218,6 +262,247 @@ bool checkTag(tinyxml2::XMLElement* tag, const char* tagStr)
 	}
 	return true;
 }
+
+///Reads a game world while streaming its xml file: the parameters are
+///stored into the object templates and into the objects' ParameterTables
+///as soon as they are read.
+class GameWorldStreamHandler: public XMLStreamHandler
+{
+public:
+	GameWorldStreamHandler(PandaFramework* pandaFramework,
+			WindowFramework* windowFramework) :
+			mGame(false), mObjectTmplSet(false), mObjectSet(false), mPandaFramework(
+					pandaFramework), mWindowFramework(windowFramework)
+	{
+		mContexts.push_back(DOCUMENT);
+	}
+
+	///An Object to be created once the whole file has been read.
+	struct ObjectEntry
+	{
+		std::string mType, mId;
+		int mPriority;
+		ParameterTable mObjectParams;
+		ParameterTableMap mComponentsParams;
+	};
+
+	///The tags found (only the first <Game>, <ObjectTmplSet> and
+	///<ObjectSet> are read).
+	bool mGame, mObjectTmplSet, mObjectSet;
+	///The object templates, in document order.
+	std::vector<SMARTPTR(ObjectTemplate)> mObjectTmpls;
+	///The objects, in document order.
+	std::list<ObjectEntry> mObjects;
+
+	virtual bool startElement(const XMLStringView& name,
+			const XMLStreamAttribute* attributes, unsigned int numAttributes)
+	{
+		Context context = SKIP;
+		switch (mContexts.back())
+		{
+		case DOCUMENT:
+			if ((name == "Game") and (not mGame))
+			{
+				mGame = true;
+				context = GAME;
+			}
+			break;
+		case GAME:
+			if ((name == "ObjectTmplSet") and (not mObjectTmplSet))
+			{
+				mObjectTmplSet = true;
+				context = OBJECTTMPLSET;
+			}
+			else if ((name == "ObjectSet") and (not mObjectSet))
+			{
+				mObjectSet = true;
+				context = OBJECTSET;
+			}
+			break;
+		case OBJECTTMPLSET:
+			if (name == "ObjectTmpl")
+			{
+				const XMLStringView* type = doFind(attributes, numAttributes,
+						"type");
+				if (type)
+				{
+					PRINT_DEBUG("  Adding Object Template for '" << type->str() << "' type");
+					//create a new object template
+					mObjectTmpl = new ObjectTemplate(ObjectType(type->str()),
+							ObjectTemplateManager::GetSingletonPtr(),
+							mPandaFramework, mWindowFramework);
+					mComponentTmpls.clear();
+					context = OBJECTTMPL;
+				}
+			}
+			break;
+		case OBJECTTMPL:
+			if (name == "ComponentTmpl")
+			{
+				const XMLStringView* family = doFind(attributes, numAttributes,
+						"family");
+				const XMLStringView* type = doFind(attributes, numAttributes,
+						"type");
+				if (family and type)
+				{
+					PRINT_DEBUG(
+							"    Component of family '" << family->str() << "' and type '" << type->str() << "'");
+					const XMLStringView* priority = doFind(attributes,
+							numAttributes, "priority");
+					mComponentTmpls.push_back(ComponentTmplEntry());
+					mComponentTmpls.back().mType = type->str();
+					mComponentTmpls.back().mPriority =
+							priority ? strtol(priority->c_str(), NULL, 0) : 0;
+					context = COMPONENTTMPL;
+				}
+			}
+			break;
+		case COMPONENTTMPL:
+			//only the first attribute of a <Param>
+			if ((name == "Param") and (numAttributes > 0))
+			{
+				PRINT_DEBUG(
+						"      Param '" << attributes[0].mName.str() << "' = '" << attributes[0].mValue.str() << "'");
+				//add attribute for this component type of this object.
+				mObjectTmpl->addComponentTypeParameter(
+						attributes[0].mName.str(), attributes[0].mValue.str(),
+						ComponentType(mComponentTmpls.back().mType));
+			}
+			break;
+		case OBJECTSET:
+			if (name == "Object")
+			{
+				//no object without type allowed
+				const XMLStringView* type = doFind(attributes, numAttributes,
+						"type");
+				if (type)
+				{
+					const XMLStringView* id = doFind(attributes, numAttributes,
+							"id");
+					const XMLStringView* priority = doFind(attributes,
+							numAttributes, "priority");
+					mObjects.push_back(ObjectEntry());
+					mObjects.back().mType = type->str();
+					mObjects.back().mId = id ? id->str() : std::string("");
+					mObjects.back().mPriority =
+							priority ? strtol(priority->c_str(), NULL, 0) : 0;
+					context = OBJECT;
+				}
+			}
+			break;
+		case OBJECT:
+			if (name == "Component")
+			{
+				//no component without type allowed
+				//but not defined component types are allowed!
+				const XMLStringView* type = doFind(attributes, numAttributes,
+						"type");
+				if (type)
+				{
+					mComponentType = type->str();
+					context = COMPONENT;
+				}
+			}
+			else if ((name == "Param") and (numAttributes > 0))
+			{
+				mObjects.back().mObjectParams.insert(
+						ParameterTable::value_type(attributes[0].mName.str(),
+								attributes[0].mValue.str()));
+			}
+			break;
+		case COMPONENT:
+			if ((name == "Param") and (numAttributes > 0))
+			{
+				mObjects.back().mComponentsParams[mComponentType].insert(
+						ParameterTable::value_type(attributes[0].mName.str(),
+								attributes[0].mValue.str()));
+			}
+			break;
+		default:
+			break;
+		}
+		mContexts.push_back(context);
+		return true;
+	}
+
+	virtual bool endElement(const XMLStringView& name)
+	{
+		if (mContexts.back() == OBJECTTMPL)
+		{
+			//add the component templates in order of priority
+			std::stable_sort(mComponentTmpls.begin(), mComponentTmpls.end());
+			std::vector<ComponentTmplEntry>::const_iterator iter;
+			for (iter = mComponentTmpls.begin(); iter != mComponentTmpls.end();
+					++iter)
+			{
+				SMARTPTR(ComponentTemplate)compTmpl =
+				ComponentTemplateManager::GetSingleton().getComponentTemplate(
+						ComponentType(iter->mType));
+				if (compTmpl == NULL)
+				{
+					continue;
+				}
+				mObjectTmpl->addComponentTemplate(compTmpl);
+			}
+			mObjectTmpls.push_back(mObjectTmpl);
+			mObjectTmpl.clear();
+		}
+		mContexts.pop_back();
+		return true;
+	}
+
+private:
+	enum Context
+	{
+		DOCUMENT,
+		GAME,
+		OBJECTTMPLSET,
+		OBJECTTMPL,
+		COMPONENTTMPL,
+		OBJECTSET,
+		OBJECT,
+		COMPONENT,
+		SKIP
+	};
+	std::vector<Context> mContexts;
+	PandaFramework* mPandaFramework;
+	WindowFramework* mWindowFramework;
+	///The object template being read.
+	SMARTPTR(ObjectTemplate) mObjectTmpl;
+	struct ComponentTmplEntry
+	{
+		std::string mType;
+		int mPriority;
+		bool operator<(const ComponentTmplEntry& other) const
+		{
+			//higher priority first
+			return mPriority > other.mPriority;
+		}
+	};
+	std::vector<ComponentTmplEntry> mComponentTmpls;
+	///The type of the component being read.
+	std::string mComponentType;
+
+	const XMLStringView* doFind(const XMLStreamAttribute* attributes,
+			unsigned int numAttributes, const char* name)
+	{
+		for (unsigned int i = 0; i < numAttributes; ++i)
+		{
+			if (attributes[i].mName == name)
+			{
+				return &attributes[i].mValue;
+			}
+		}
+		return NULL;
+	}
+};
+
+///Orders the objects by priority (higher first).
+bool higherPriority(const GameWorldStreamHandler::ObjectEntry* first,
+		const GameWorldStreamHandler::ObjectEntry* second)
+{
+	return first->mPriority > second->mPriority;
+}
 }
 
 namespace ely
@@ -225,11 +510,16 @@ namespace ely
 
 void GameManager::createGameWorld(const std::string& gameWorldXML)
 {
+	if (mXMLStreaming)
+	{
+		doCreateGameWorldStreaming(gameWorldXML);
+		return;
+	}
 	//read the game configuration file
 	tinyxml2::XMLDocument gameDoc;
 	//load file
 	PRINT_DEBUG("Loading '" << gameWorldXML << "'...");
-	if (tinyxml2::XML_NO_ERROR != gameDoc.LoadFile(gameWorldXML.c_str()))
+	if (tinyxml2::XML_SUCCESS != gameDoc.LoadFile(gameWorldXML.c_str()))
 	{
 		fprintf(stderr, "Error detected on '%s':\n", gameWorldXML.c_str());
 		gameDoc.PrintError();
@@ -304,6 +594,7 @@ void GameManager::createGameWorld(const std::string& gameWorldXML)
 			const char* compTypeTAG = componentTmplTAG->Attribute("type", NULL);
 			if (not compFamilyTAG or not compTypeTAG)
 			{
+				orderedComponentTmplsTAG.pop();
 				continue;
 			}
 			PRINT_DEBUG(
@@ -332,6 +623,7 @@ void GameManager::createGameWorld(const std::string& gameWorldXML)
 					ComponentType(compTypeTAG));
 			if (compTmpl == NULL)
 			{
+				orderedComponentTmplsTAG.pop();
 				continue;
 			}
 			objTmplPtr->addComponentTemplate(compTmpl);
@@ -451,24 +743,26 @@ void GameManager::createGameWorld(const std::string& gameWorldXML)
 							attributeTAG->Value()));
 		}
 		//////////////////////////////////////////
-		//create the object actually
+		//create the object actually (storing its parameters, so it can be
+		//recreated by a Snapshot restore)
 		SMARTPTR(Object)objectPtr;
 		if ((objIdTAG != NULL) and (std::string(objIdTAG) != std::string("")))
 		{
 			// set id with the passed id
 			objectPtr = ObjectTemplateManager::GetSingleton().createObject(
 					ObjectType(objTypeTAG), ObjectId(objIdTAG),
-					objTmplParams, compTmplParams);
+					objTmplParams, compTmplParams, true);
 		}
 		else
 		{
 			// set id with the internally generated id
 			objectPtr = ObjectTemplateManager::GetSingleton().createObject(
 					ObjectType(objTypeTAG), ObjectId(""), objTmplParams,
-					compTmplParams);
+					compTmplParams, true);
 		}
 		if (objectPtr == NULL)
 		{
+			orderedObjectsTAG.pop();
 			continue;
 		}
 		createdObjectQueue.push(objectPtr);
@@ -489,6 +783,112 @@ void GameManager::createGameWorld(const std::string& gameWorldXML)
 	}
 }
 
+void GameManager::doCreateGameWorldStreaming(const std::string& gameWorldXML)
+{
+	//stream the game configuration file through its memory map
+	XMLStream gameStream;
+	GameWorldStreamHandler gameHandler(this, mWindow);
+	PRINT_DEBUG("Streaming '" << gameWorldXML << "'...");
+	if ((not gameStream.open(gameWorldXML))
+			or (not gameStream.parse(gameHandler)))
+	{
+		fprintf(stderr, "Error detected on '%s':\n%s (line %d)\n",
+				gameWorldXML.c_str(), gameStream.getErrorStr().c_str(),
+				gameStream.getErrorLine());
+		throw GameException(
+				"GameManager::setupGameWorld: Failed to load/parse "
+						+ gameWorldXML);
+	}
+	//check <Game> tag
+	PRINT_DEBUG("Checking <Game> tag ...");
+	if (not gameHandler.mGame)
+	{
+		fprintf(stderr, "<%s> tag not found!\n", "Game");
+		throw GameException(
+				"GameManager::setupGameWorld: No <Game> in " + gameWorldXML);
+	}
+	//////////////////////////////////////////
+	//<!-- Object Templates Definition -->
+	//Setup object template manager
+	PRINT_DEBUG("Setting up Object Template Manager");
+	//check <Game>--<ObjectTmplSet> tag
+	PRINT_DEBUG("  Checking <ObjectTmplSet> tag ...");
+	if (not gameHandler.mObjectTmplSet)
+	{
+		fprintf(stderr, "<%s> tag not found!\n", "ObjectTmplSet");
+		throw GameException(
+				"GameManager::setupGameWorld: No <ObjectTmplSet> in "
+						+ gameWorldXML);
+	}
+	// add all kind of object templates to manager
+	std::vector<SMARTPTR(ObjectTemplate)>::const_iterator objectTmplIter;
+	for (objectTmplIter = gameHandler.mObjectTmpls.begin();
+			objectTmplIter != gameHandler.mObjectTmpls.end(); ++objectTmplIter)
+	{
+		ObjectTemplateManager::GetSingleton().addObjectTemplate(
+				*objectTmplIter);
+	}
+	//////////////////////////////////////////
+	//<!-- Objects Creation -->
+	//Create game objects
+	PRINT_DEBUG("Creating Game Objects");
+	//check <Game>--<ObjectSet> tag
+	PRINT_DEBUG("  Checking <ObjectSet> tag ...");
+	if (not gameHandler.mObjectSet)
+	{
+		fprintf(stderr, "<%s> tag not found!\n", "ObjectSet");
+		throw GameException(
+				"GameManager::setupGameWorld: No <ObjectSet> in "
+						+ gameWorldXML);
+	}
+	//reset all component templates parameters to their default values
+	ComponentTemplateManager::GetSingleton().resetComponentTemplatesParams();
+	//store created objects in this queue
+	std::queue<SMARTPTR(Object)> createdObjectQueue;
+	//order the objects by priority (document order on ties)
+	std::vector<GameWorldStreamHandler::ObjectEntry*> orderedObjects;
+	std::list<GameWorldStreamHandler::ObjectEntry>::iterator objectIter;
+	for (objectIter = gameHandler.mObjects.begin();
+			objectIter != gameHandler.mObjects.end(); ++objectIter)
+	{
+		orderedObjects.push_back(&(*objectIter));
+	}
+	std::stable_sort(orderedObjects.begin(), orderedObjects.end(),
+			higherPriority);
+	//cycle through the Object(s)' definitions in order of priority
+	for (unsigned int o = 0; o < orderedObjects.size(); ++o)
+	{
+		const GameWorldStreamHandler::ObjectEntry& object = *orderedObjects[o];
+		PRINT_DEBUG(
+				"  Creating Object '" << (not object.mId.empty() ? object.mId : "UNNAMED") << "'...");
+		//create the object actually (with the internally generated id if
+		//there is none, and storing its parameters, so it can be recreated
+		//by a Snapshot restore)
+		SMARTPTR(Object)objectPtr =
+		ObjectTemplateManager::GetSingleton().createObject(
+				ObjectType(object.mType), ObjectId(object.mId),
+				object.mObjectParams, object.mComponentsParams, true);
+		if (objectPtr == NULL)
+		{
+			//object type doesn't exist
+			continue;
+		}
+		createdObjectQueue.push(objectPtr);
+		PRINT_DEBUG( "  ...Created Object '" << objectPtr->objectId() << "'");
+	}
+	//give a chance to objects to initialize themselves,
+	//in order of creation, after the game world has been created.
+	while(not createdObjectQueue.empty())
+	{
+		//get front element
+		SMARTPTR(Object) object = createdObjectQueue.front();
+		//use front element
+		object->worldSetup();
+		//remove front element
+		createdObjectQueue.pop();
+	}
+}
+
 void GameManager::enable_mouse()
 {
 	if (mMouse2cam)
@@ -515,6 +915,54 @@ WindowFramework* const GameManager::windowFramework() const
 	return mWindow;
 }
 
+void GameManager::doSetupHeadless()
+{
+	PRINT_DEBUG("Running headless: no window will be opened");
+	//stand-ins for the window's scene graph roots
+	mRender = NodePath("render");
+	mRender2d = NodePath("render2d");
+	mAspect2d = mRender2d.attach_new_node("aspect2d");
+	mCameraGroup = mRender.attach_new_node("camera");
+	mCameraGroup.attach_new_node(new Camera("cam"));
+	//frame clock: real time (default) or a fixed tick, limited to the wall
+	//clock or as fast as possible
+	ConfigVariableDouble tick("ely-headless-tick", 0.0,
+			"Fixed frame rate (Hz) when headless (0 = real time).");
+	ConfigVariableBool freeRun("ely-headless-free-run", false,
+			"Runs the fixed frame rate as fast as possible when headless.");
+	if (tick > 0.0)
+	{
+		mGlobalClock->set_mode(
+				freeRun ? ClockObject::M_non_real_time : ClockObject::M_limited);
+		mGlobalClock->set_frame_rate(tick);
+	}
+	//exit after a number of frames (batch runs)
+	ConfigVariableInt frames("ely-headless-frames", 0,
+			"Frames to run when headless before exiting (0 = unlimited).");
+	mHeadlessFrames = frames;
+	if (mHeadlessFrames > 0)
+	{
+		mHeadlessData = new TaskInterface<GameManager>::TaskData(this,
+				&GameManager::headlessUpdate);
+		mHeadlessTask = new GenericAsyncTask("GameManager::headlessUpdate",
+				&TaskInterface<GameManager>::taskFunction,
+				reinterpret_cast<void*>(mHeadlessData.p()));
+		//after the managers' updates
+		mHeadlessTask->set_sort(40);
+		AsyncTaskManager::get_global_ptr()->add(mHeadlessTask);
+	}
+}
+
+AsyncTask::DoneStatus GameManager::headlessUpdate(GenericAsyncTask* task)
+{
+	RETURN_ON_COND(mGlobalClock->get_frame_count() < mHeadlessFrames,
+			AsyncTask::DS_cont)
+
+	PRINT_DEBUG("Headless frames completed: exiting");
+	set_exit_flag();
+	return AsyncTask::DS_done;
+}
+
 #ifdef ELY_DEBUG
 void GameManager::togglePhysicsDebug(const Event* event)
 {
@@ -36,6 +36,9 @@
 #include "Game/GamePhysicsManager.h"
 #include "Game/GameManager.h"
 #include "ObjectModel/Object.h"
+#include "Support/EventBus.h"
+#include "Support/Profiler.h"
+#include "Support/Lockstep.h"
 #include <throw_event.h>
 
 namespace ely
@@ -116,7 +119,9 @@ void GamePhysicsManager::addToPhysicsUpdate(SMARTPTR(Component) physicsComp)
 			mPhysicsComponents.end(), physicsComp);
 	if (iter == mPhysicsComponents.end())
 	{
-		mPhysicsComponents.push_back(physicsComp);
+		mPhysicsComponents.insert(
+				Lockstep::getInsertPosition(mPhysicsComponents, physicsComp),
+				physicsComp);
 	}
 }
 
@@ -154,11 +159,14 @@ AsyncTask::DoneStatus GamePhysicsManager::update(GenericAsyncTask* task)
 		}
 	}
 #endif
+	//scratch memory is released at the end of the update
+	FrameArena::Scope scratch;
 	{
 		//lock (guard) the mutex
 		HOLD_REMUTEX(mMutex)
+		PROFILE_ZONE("GamePhysicsManager::update");
 
-		float dt = ClockObject::get_global_clock()->get_dt();
+		float dt = Lockstep::getFrameDt();
 
 		int maxSubSteps;
 
@@ -168,11 +176,14 @@ AsyncTask::DoneStatus GamePhysicsManager::update(GenericAsyncTask* task)
 
 		// call all physics components update functions, passing delta time
 		PhysicsComponentList::iterator iter;
+		ProfileTypeBatch profileBatch;
 		for (iter = mPhysicsComponents.begin();
 				iter != mPhysicsComponents.end(); ++iter)
 		{
+			profileBatch.next(*iter);
 			(*iter)->update(reinterpret_cast<void*>(&dt));
 		}
+		profileBatch.end();
 		// do physics step simulation
 		// timeStep < maxSubSteps * fixedTimeStep (=1/60.0=0.016666667) -->
 		// supposing a minimum of 6,666666667 fps, we have a maximum
@@ -213,7 +224,10 @@ AsyncTask::DoneStatus GamePhysicsManager::update(GenericAsyncTask* task)
 		{
 			maxSubSteps = 9;
 		}
-		mBulletWorld->do_physics(dt, maxSubSteps);
+		{
+			PROFILE_ZONE("BulletWorld::do_physics");
+			mBulletWorld->do_physics(dt, maxSubSteps);
+		}
 	}
 
 	//notify collisions
@@ -229,7 +243,7 @@ AsyncTask::DoneStatus GamePhysicsManager::update(GenericAsyncTask* task)
 		{
 			//update elapsed time
 			mCollisionNotify.mTimeElapsed +=
-					ClockObject::get_global_clock()->get_dt();
+					Lockstep::getFrameDt();
 			// iterate through all of the manifolds in the dispatcher
 			for (int i = 0; i < mCollisionDispatcher->getNumManifolds(); ++i)
 			{
@@ -250,12 +264,16 @@ AsyncTask::DoneStatus GamePhysicsManager::update(GenericAsyncTask* task)
 					GamePhysicsManager::GetSingletonPtr()->getPhysicsComponentByPandaNode(node0);
 					SMARTPTR(Component)physicsComponent1 =
 					GamePhysicsManager::GetSingletonPtr()->getPhysicsComponentByPandaNode(node1);
-					//insert a default: check of equality is done only on CollidingNodePair::mPnode member
-					std::pair<std::set<CollidingNodePair>::iterator, bool> res =
-							mCollidingNodePairs.insert(
-									CollidingNodePair(node0, node1));
+					//look up with a scratch key: check of equality is done only on CollidingNodePair::mPnode member
+					std::pair<std::set<CollidingNodePair>::iterator, bool> res;
+					res.first = mCollidingNodePairs.find(
+							CollidingNodePair(node0, node1, scratch.getArena()));
+					res.second = (res.first == mCollidingNodePairs.end());
 					if (res.second)
 					{
+						//insert a default
+						res.first = mCollidingNodePairs.insert(
+								CollidingNodePair(node0, node1)).first;
 						//this is a "new" colliding object pair
 						//event name: <CollidingObjectType1>_<CollidingObjectType2>_Collision
 						std::string objectType0 =
@@ -283,11 +301,17 @@ AsyncTask::DoneStatus GamePhysicsManager::update(GenericAsyncTask* task)
 							(res.first)->mCollidingNodePairData->mEventParameters[1] =
 									EventParameter(physicsComponent0);
 						}
-						//throw the event
-						throw_event(
+						//post the event (and throw it if asked)
+						if (doPostCollisionEvent(EventBus::COLLISION_EVENT,
 								(res.first)->mCollidingNodePairData->mEventName,
-								(res.first)->mCollidingNodePairData->mEventParameters[0],
-								(res.first)->mCollidingNodePairData->mEventParameters[1]);
+								*(res.first)->mCollidingNodePairData,
+								pManifold->getNumContacts()))
+						{
+							throw_event(
+									(res.first)->mCollidingNodePairData->mEventName,
+									(res.first)->mCollidingNodePairData->mEventParameters[0],
+									(res.first)->mCollidingNodePairData->mEventParameters[1]);
+						}
 					}
 					else
 					{
@@ -295,11 +319,17 @@ AsyncTask::DoneStatus GamePhysicsManager::update(GenericAsyncTask* task)
 						if (mCollisionNotify.mTimeElapsed
 								>= mCollisionNotify.mPeriod)
 						{
-							//throw the event
-							throw_event(
+							//post the event (and throw it if asked)
+							if (doPostCollisionEvent(EventBus::COLLISION_EVENT,
 									(res.first)->mCollidingNodePairData->mEventName,
-									(res.first)->mCollidingNodePairData->mEventParameters[0],
-									(res.first)->mCollidingNodePairData->mEventParameters[1]);
+									*(res.first)->mCollidingNodePairData,
+									pManifold->getNumContacts()))
+							{
+								throw_event(
+										(res.first)->mCollidingNodePairData->mEventName,
+										(res.first)->mCollidingNodePairData->mEventParameters[0],
+										(res.first)->mCollidingNodePairData->mEventParameters[1]);
+							}
 						}
 					}
 					//update count flag
@@ -325,10 +355,15 @@ AsyncTask::DoneStatus GamePhysicsManager::update(GenericAsyncTask* task)
 			//check if it has a previous count
 			if (i->mCollidingNodePairData->mCount != (int) mCollisionNotify.mCount)
 			{
-				//throw the "off" event
-				throw_event(i->mCollidingNodePairData->mEventName + "Off",
-						i->mCollidingNodePairData->mEventParameters[0],
-						i->mCollidingNodePairData->mEventParameters[1]);
+				//post the "off" event (and throw it if asked)
+				if (doPostCollisionEvent(EventBus::COLLISION_OFF_EVENT,
+						i->mCollidingNodePairData->mEventName + "Off",
+						*i->mCollidingNodePairData, 0))
+				{
+					throw_event(i->mCollidingNodePairData->mEventName + "Off",
+							i->mCollidingNodePairData->mEventParameters[0],
+							i->mCollidingNodePairData->mEventParameters[1]);
+				}
 				//erase the object
 				mCollidingNodePairs.erase(i++);
 			}
@@ -580,6 +615,16 @@ void GamePhysicsManager::doEnableCollisionNotify(EventThrown event, ThrowEventDa
 	}
 }
 
+bool GamePhysicsManager::doPostCollisionEvent(EventBus::EventId id,
+		const std::string& pandaEvent,
+		const CollidingNodePair::CollidingNodePairData& data, int numContacts)
+{
+	//the event parameters hold the colliding components
+	return EventBus::postEvent(id, pandaEvent,
+			data.mEventParameters[0].get_ptr(),
+			data.mEventParameters[1].get_ptr(), (float) numContacts);
+}
+
 #ifdef ELY_DEBUG
 NodePath GamePhysicsManager::getDebugNodePath() const
 {
@@ -22,6 +22,9 @@
  */
 
 #include "Game/GameSceneManager.h"
+#include "Support/FrameArena.h"
+#include "Support/Profiler.h"
+#include "Support/Lockstep.h"
 #include "Game/GameManager.h"
 
 namespace ely
@@ -66,6 +69,8 @@ GameSceneManager::GameSceneManager(
 #endif
 	//Adds mUpdateTask to the active queue.
 	AsyncTaskManager::get_global_ptr()->add(mUpdateTask);
+	//the model loader
+	mModelLoader = new ModelLoader("GameSceneManager", 1);
 }
 
 GameSceneManager::~GameSceneManager()
@@ -78,6 +83,15 @@ GameSceneManager::~GameSceneManager()
 		AsyncTaskManager::get_global_ptr()->remove(mUpdateTask);
 	}
 	mSceneComponents.clear();
+	InstanceBatchTable::iterator batchIter;
+	for (batchIter = mInstanceBatches.begin();
+			batchIter != mInstanceBatches.end(); ++batchIter)
+	{
+		batchIter->second->cleanup();
+	}
+	mInstanceBatches.clear();
+	mModelLoader->cleanup();
+	mModelLoader.clear();
 }
 
 void GameSceneManager::addToSceneUpdate(SMARTPTR(Component)sceneComp)
@@ -89,7 +103,9 @@ void GameSceneManager::addToSceneUpdate(SMARTPTR(Component)sceneComp)
 			mSceneComponents.end(), sceneComp);
 	if (iter == mSceneComponents.end())
 	{
-		mSceneComponents.push_back(sceneComp);
+		mSceneComponents.insert(
+				Lockstep::getInsertPosition(mSceneComponents, sceneComp),
+				sceneComp);
 	}
 }
 
@@ -106,6 +122,50 @@ void GameSceneManager::removeFromSceneUpdate(SMARTPTR(Component)sceneComp)
 	}
 }
 
+SMARTPTR(InstanceBatch) GameSceneManager::getInstanceBatch(
+		const std::string& key, const NodePath& model,
+		const NodePath& reference, float cellSize)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	InstanceBatchTable::iterator iter = mInstanceBatches.find(key);
+	if (iter != mInstanceBatches.end())
+	{
+		return iter->second;
+	}
+	SMARTPTR(InstanceBatch) batch = new InstanceBatch(key, model, reference,
+			cellSize);
+	mInstanceBatches[key] = batch;
+	return batch;
+}
+
+void GameSceneManager::refreshInstanceBatch(const std::string& key,
+		const NodePath& model)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	InstanceBatchTable::iterator iter = mInstanceBatches.find(key);
+	RETURN_ON_COND(iter == mInstanceBatches.end(),)
+
+	iter->second->setModel(model);
+}
+
+void GameSceneManager::releaseInstanceBatch(const std::string& key)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	InstanceBatchTable::iterator iter = mInstanceBatches.find(key);
+	if ((iter != mInstanceBatches.end())
+			and (iter->second->getNumInstances() == 0))
+	{
+		iter->second->cleanup();
+		mInstanceBatches.erase(iter);
+	}
+}
+
 AsyncTask::DoneStatus GameSceneManager::update(GenericAsyncTask* task)
 {
 #ifdef ELY_THREAD
@@ -125,19 +185,34 @@ AsyncTask::DoneStatus GameSceneManager::update(GenericAsyncTask* task)
 	{
 		//lock (guard) the mutex
 		HOLD_REMUTEX(mMutex)
+		//scratch memory is released at the end of the update
+		FrameArena::Scope scratch;
+		PROFILE_ZONE("GameSceneManager::update");
 
-		float dt = ClockObject::get_global_clock()->get_dt();
+		float dt = Lockstep::getFrameDt();
 
 #ifdef TESTING
 		dt = 0.016666667; //60 fps
 #endif
 
 		// call all scene components update functions, passing delta time
+		// (a component may remove itself from the update list)
 		SceneComponentList::iterator iter;
-		for (iter = mSceneComponents.begin(); iter != mSceneComponents.end();
-				++iter)
+		ProfileTypeBatch profileBatch;
+		for (iter = mSceneComponents.begin(); iter != mSceneComponents.end();)
+		{
+			SMARTPTR(Component) sceneComp = *iter;
+			++iter;
+			profileBatch.next(sceneComp);
+			sceneComp->update(reinterpret_cast<void*>(&dt));
+		}
+		profileBatch.end();
+		// update instance batches (after instances have moved)
+		InstanceBatchTable::iterator batchIter;
+		for (batchIter = mInstanceBatches.begin();
+				batchIter != mInstanceBatches.end(); ++batchIter)
 		{
-			(*iter)->update(reinterpret_cast<void*>(&dt));
+			batchIter->second->update();
 		}
 	}
 #ifdef ELY_THREAD
@@ -23,7 +23,9 @@
 
 #include "ObjectModel/Component.h"
 #include "ObjectModel/Object.h"
+#include "ObjectModel/FunctionRegistry.h"
 #include "Game/GameManager.h"
+#include "Support/Replay.h"
 
 namespace ely
 {
@@ -43,7 +45,7 @@ Component::Component() :
 #ifdef ELY_THREAD
 		mDestroying(false),
 #endif
-		mCallbackLib(NULL), mCallbacksLoaded(false), mCallbacksRegistered(false)
+		mCallbacksLoaded(false), mCallbacksRegistered(false)
 {
 	mTmpl.clear();
 	mComponentId = ComponentId();
@@ -90,6 +92,16 @@ void Component::removeFromObjectCleanup()
 	doCleanupEventTables();
 }
 
+void Component::write_datagram(BamWriter* manager, Datagram& dg)
+{
+	TypedWritableReferenceCount::write_datagram(manager, dg);
+}
+
+void Component::fillin(DatagramIterator& scan, BamReader* manager)
+{
+	TypedWritableReferenceCount::fillin(scan, manager);
+}
+
 SMARTPTR(Object)Component::getOwnerObject() const
 {
 	return mOwnerObject;
@@ -172,38 +184,13 @@ void Component::doLoadEventCallbacks()
 	//if callbacks already loaded do nothing
 	RETURN_ON_COND(mCallbacksLoaded,)
 
-	// reset errors
-	lt_dlerror();
-	//load the event callbacks library
-	mCallbackLib =
-			lt_dlopen(
-					GameManager::GetSingletonPtr()->getDataInfo(
-							GameManager::CALLBACKS).c_str());
-	if (mCallbackLib == NULL)
-	{
-		std::cerr << "Error loading library: "
-				<< GameManager::GetSingletonPtr()->getDataInfo(
-						GameManager::CALLBACKS) << ": " << lt_dlerror()
-				<< std::endl;
-		return;
-	}
-	// reset errors
-	lt_dlerror();
 	//check the default callback
-	PCALLBACK pDefaultCallback = (PCALLBACK) lt_dlsym(mCallbackLib,
-	DEFAULT_CALLBACK_NAME);
-	const char* dlsymError = lt_dlerror();
-	if (dlsymError)
+	PCALLBACK pDefaultCallback = reinterpret_cast<PCALLBACK>(doFindFunction(
+			FunctionRegistry::CALLBACKS, DEFAULT_CALLBACK_NAME, true));
+	if (not pDefaultCallback)
 	{
 		std::cerr << "Cannot find default callback " << DEFAULT_CALLBACK_NAME
-				<< dlsymError << std::endl;
-		//Close the event callbacks library
-		if (lt_dlclose(mCallbackLib) != 0)
-		{
-			std::cerr << "Error closing library: "
-					<< GameManager::GetSingletonPtr()->getDataInfo(
-							GameManager::CALLBACKS) << std::endl;
-		}
+				<< std::endl;
 		return;
 	}
 	//load every callback, as specified in callbacks' name table
@@ -212,7 +199,8 @@ void Component::doLoadEventCallbacks()
 			iterCallbackTable != mCallbackTable.end(); ++iterCallbackTable)
 	{
 		std::string callbackName;
-		if (not iterCallbackTable->second.first.empty())
+		bool shared = iterCallbackTable->second.first.empty();
+		if (not shared)
 		{
 			//the callback name has been specified as parameter
 			callbackName = iterCallbackTable->second.first;
@@ -227,16 +215,12 @@ void Component::doLoadEventCallbacks()
 			//replace hyphens
 			callbackName = replaceCharacter(callbackNameTmp, '-', '_');
 		}
-		//reset errors
-		lt_dlerror();
 		//load the callback
-		PCALLBACK pCallback = (PCALLBACK) lt_dlsym(mCallbackLib,
-				callbackName.c_str());
-		dlsymError = lt_dlerror();
-		if (dlsymError)
+		PCALLBACK pCallback = reinterpret_cast<PCALLBACK>(doFindFunction(
+				FunctionRegistry::CALLBACKS, callbackName, shared));
+		if (not pCallback)
 		{
-			PRINT_ERR_DEBUG(
-					"Cannot load callback " << callbackName << ": " << dlsymError);
+			PRINT_ERR_DEBUG("Cannot load callback " << callbackName);
 			//set default callback for this event
 			mCallbackTable[iterCallbackTable->first].second = pDefaultCallback;
 			//continue with the next event
@@ -250,22 +234,24 @@ void Component::doLoadEventCallbacks()
 	mCallbacksLoaded = true;
 }
 
+FunctionRegistry::Function Component::doFindFunction(
+		FunctionRegistry::Library library, const std::string& name,
+		bool shared)
+{
+	if (shared and mOwnerObject)
+	{
+		return mOwnerObject->objectTmpl()->functionCache().findFunction(
+				library, name);
+	}
+	return FunctionRegistry::GetSingleton().findFunction(library, name);
+}
+
 void Component::doUnloadEventCallbacks()
 {
 	//if callbacks not loaded do nothing
 	RETURN_ON_COND(not mCallbacksLoaded,)
 
-	//Close the event callbacks library
-	// reset errors
-	lt_dlerror();
-	if (lt_dlclose(mCallbackLib) != 0)
-	{
-		std::cerr << "Error closing library: "
-				<< GameManager::GetSingletonPtr()->getDataInfo(
-						GameManager::CALLBACKS) << ": " << lt_dlerror()
-				<< std::endl;
-	}
-
+	//the callbacks library is owned by the FunctionRegistry
 	//callbacks unloaded
 	mCallbacksLoaded = false;
 }
@@ -291,6 +277,11 @@ void Component::registerEventCallbacks()
 		EventHandler::get_global_event_handler()->add_hook(
 				mEventTable[iterCallbackTable->first],
 				iterCallbackTable->second.second, static_cast<void*>(this));
+		//input events are recorded/replayed
+		if (componentFamilyType() == ComponentFamilyType("Control"))
+		{
+			Replay::watchEvent(mEventTable[iterCallbackTable->first]);
+		}
 	}
 
 	//handlers registered
@@ -306,6 +297,15 @@ void Component::unregisterEventCallbacks()
 //	mTmpl->pandaFramework()->get_event_handler().remove_hooks_with(
 //			(void*) this);
 	EventHandler::get_global_event_handler()->remove_hooks_with((void*) this);
+	if (componentFamilyType() == ComponentFamilyType("Control"))
+	{
+		std::map<std::string, NameCallbackPair>::iterator iterCallbackTable;
+		for (iterCallbackTable = mCallbackTable.begin();
+				iterCallbackTable != mCallbackTable.end(); ++iterCallbackTable)
+		{
+			Replay::unwatchEvent(mEventTable[iterCallbackTable->first]);
+		}
+	}
 
 	//handlers unregistered
 	mCallbacksRegistered = false;
@@ -0,0 +1,244 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/ObjectModel/FunctionRegistry.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "ObjectModel/FunctionRegistry.h"
+#include <reMutexHolder.h>
+
+namespace ely
+{
+
+FunctionRegistry::FunctionRegistry() :
+		mPluginMode(true), mLookups(0), mLibrarySymbolLookups(0), mGeneration(0)
+{
+}
+
+FunctionRegistry::~FunctionRegistry()
+{
+}
+
+FunctionRegistry& FunctionRegistry::GetSingleton()
+{
+	//created on first use (possibly by a static initializer) and never
+	//destroyed: libraries' destructors could use it at any time
+	static FunctionRegistry* registry = new FunctionRegistry();
+	return *registry;
+}
+
+void FunctionRegistry::registerFunction(Library library,
+		const std::string& name, Function function)
+{
+	ReMutexHolder guard(mMutex);
+
+	mLibraries[library].mTable[name] = function;
+	//cached missing functions could be registered now
+	++mGeneration;
+}
+
+void FunctionRegistry::unregisterFunctions(Library library)
+{
+	ReMutexHolder guard(mMutex);
+
+	mLibraries[library].mTable.clear();
+	++mGeneration;
+}
+
+FunctionRegistry::Function FunctionRegistry::findFunction(Library library,
+		const std::string& name)
+{
+	ReMutexHolder guard(mMutex);
+
+	++mLookups;
+	LibraryEntry& entry = mLibraries[library];
+	LibraryEntry::FunctionTable::const_iterator iter = entry.mTable.find(name);
+	if (iter != entry.mTable.end())
+	{
+		return iter->second;
+	}
+	//not yet resolved: open the library (once) so it registers its functions
+	if (not entry.mOpened)
+	{
+		doOpenLibrary(entry);
+		iter = entry.mTable.find(name);
+		if (iter != entry.mTable.end())
+		{
+			return iter->second;
+		}
+	}
+	Function function = NULL;
+	//plug-in mode: look up the unregistered function into the library
+	if (mPluginMode and entry.mHandle)
+	{
+		++mLibrarySymbolLookups;
+		lt_dlerror();
+		function = (Function) lt_dlsym(entry.mHandle, name.c_str());
+		const char* dlsymError = lt_dlerror();
+		if (dlsymError)
+		{
+			PRINT_ERR_DEBUG("Cannot load " << name << ": " << dlsymError);
+			function = NULL;
+		}
+	}
+	//record the function found, but not a missing one: the table would
+	//grow with every per Object name looked up
+	if (function)
+	{
+		entry.mTable[name] = function;
+	}
+	return function;
+}
+
+void FunctionRegistry::setLibraryPath(Library library, const std::string& path)
+{
+	ReMutexHolder guard(mMutex);
+
+	mLibraries[library].mPath = path;
+}
+
+void FunctionRegistry::setPluginMode(bool enable)
+{
+	ReMutexHolder guard(mMutex);
+
+	mPluginMode = enable;
+}
+
+bool FunctionRegistry::isPluginMode()
+{
+	ReMutexHolder guard(mMutex);
+
+	return mPluginMode;
+}
+
+void FunctionRegistry::closeLibraries()
+{
+	ReMutexHolder guard(mMutex);
+
+	for (int i = 0; i < LIBRARY_NUM; ++i)
+	{
+		LibraryEntry& entry = mLibraries[i];
+		//the functions are no more valid
+		entry.mTable.clear();
+		entry.mOpened = false;
+		if (not entry.mHandle)
+		{
+			continue;
+		}
+		lt_dlerror();
+		if (lt_dlclose(entry.mHandle) != 0)
+		{
+			std::cerr << "Error closing library: " << entry.mPath << ": "
+					<< lt_dlerror() << std::endl;
+		}
+		entry.mHandle = NULL;
+	}
+	++mGeneration;
+}
+
+unsigned int FunctionRegistry::getNumFunctions()
+{
+	ReMutexHolder guard(mMutex);
+
+	unsigned int num = 0;
+	for (int i = 0; i < LIBRARY_NUM; ++i)
+	{
+		num += mLibraries[i].mTable.size();
+	}
+	return num;
+}
+
+unsigned long int FunctionRegistry::getGeneration()
+{
+	ReMutexHolder guard(mMutex);
+
+	return mGeneration;
+}
+
+void FunctionRegistry::doOpenLibrary(LibraryEntry& entry)
+{
+	entry.mOpened = true;
+	//no path: the functions are linked in (and already registered)
+	RETURN_ON_COND(entry.mPath.empty(),)
+
+	lt_dlerror();
+	//the library constructor registers its functions
+	entry.mHandle = lt_dlopen(entry.mPath.c_str());
+	if (entry.mHandle == NULL)
+	{
+		std::cerr << "Error loading library: " << entry.mPath << ": "
+				<< lt_dlerror() << std::endl;
+	}
+}
+
+FunctionCache::FunctionCache() :
+		mGeneration(0)
+{
+}
+
+FunctionRegistry::Function FunctionCache::findFunction(
+		FunctionRegistry::Library library, const std::string& name)
+{
+	ReMutexHolder guard(mMutex);
+
+	FunctionRegistry& registry = FunctionRegistry::GetSingleton();
+	//the registry tables changed: cached functions could be stale
+	unsigned long int generation = registry.getGeneration();
+	if (generation != mGeneration)
+	{
+		clear();
+		mGeneration = generation;
+	}
+	FunctionTable& table = mTables[library];
+	FunctionTable::const_iterator iter = table.find(name);
+	if (iter != table.end())
+	{
+		return iter->second;
+	}
+	//record the function, even if missing, so it is resolved only once
+	FunctionRegistry::Function function = registry.findFunction(library,
+			name);
+	table[name] = function;
+	return function;
+}
+
+void FunctionCache::clear()
+{
+	ReMutexHolder guard(mMutex);
+
+	for (int i = 0; i < FunctionRegistry::LIBRARY_NUM; ++i)
+	{
+		mTables[i].clear();
+	}
+}
+
+unsigned int FunctionCache::getNumFunctions()
+{
+	ReMutexHolder guard(mMutex);
+
+	unsigned int num = 0;
+	for (int i = 0; i < FunctionRegistry::LIBRARY_NUM; ++i)
+	{
+		num += mTables[i].size();
+	}
+	return num;
+}
+
+} // namespace ely
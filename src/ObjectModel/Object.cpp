@@ -23,15 +23,16 @@
 
 #include "ObjectModel/Object.h"
 #include "ObjectModel/ObjectTemplateManager.h"
+#include "ObjectModel/FunctionRegistry.h"
 #include "Game/GameManager.h"
 
 namespace ely
 {
 
 Object::Object(const ObjectId& objectId, SMARTPTR(ObjectTemplate)tmpl) :
-mTmpl(tmpl), mObjectId(objectId), mOwner(NULL),mInitializationLib(NULL),
+mTmpl(tmpl), mObjectId(objectId), mOwner(NULL),
 mInitializationsLoaded(false), mInititializationFuncName(""),
-mInitializationFunction(NULL)
+mInitializationFunction(NULL), mParamsStored(false)
 {
 	//by default set node path to not empty
 	mNodePath = NodePath(mObjectId);
@@ -100,6 +101,19 @@ bool Object::doRemoveComponent(SMARTPTR(Component)component)
 	return true;
 }
 
+void Object::setNodePath(const NodePath& nodePath)
+{
+	//called only by ObjectTemplateManager methods which
+	//already lock the Object mutex
+
+	mNodePath = nodePath;
+	//keep the index up to date, if this Object has been created
+	if (mHandle.isValid())
+	{
+		ObjectTemplateManager::GetSingleton().doIndexObjectNode(this);
+	}
+}
+
 void Object::onRemoveObjectCleanup()
 {
 	//
@@ -168,30 +182,8 @@ void Object::onAddToSceneSetup()
 	//set initialization function (if any)
 	//get initialization function name
 	mInititializationFuncName = mTmpl->parameter(std::string("init_func"));
-	//load initialization functions library.
+	//load initialization function (if any).
 	doLoadInitializationFunctions();
-	//execute the initialization function (if any)
-	if (mInitializationsLoaded)
-	{
-		const char* dlsymError;
-		std::string functionName;
-
-		//load initialization function (if any): <OBJECTID>_initialization
-		// doReset errors
-		lt_dlerror();
-		functionName = (
-				not mInititializationFuncName.empty() ?
-						mInititializationFuncName :
-						std::string(mObjectId) + "_initialization");
-		mInitializationFunction = (PINITIALIZATION) lt_dlsym(mInitializationLib,
-				functionName.c_str());
-		dlsymError = lt_dlerror();
-		if (dlsymError)
-		{
-			PRINT_ERR_DEBUG(
-					"No initialization function '" << functionName << "': " << dlsymError);
-		}
-	}
 }
 
 void Object::onRemoveFromSceneCleanup()
@@ -221,24 +213,88 @@ void Object::worldSetup()
 	}
 }
 
+void Object::write_datagram(BamWriter* manager, Datagram& dg)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	TypedWritableReferenceCount::write_datagram(manager, dg);
+	//the transform
+	dg.add_bool(not mNodePath.is_empty());
+	if (not mNodePath.is_empty())
+	{
+		mNodePath.get_mat().write_datagram(dg);
+	}
+	//the components' runtime state, each one into its own datagram
+	dg.add_uint16(mComponents.size());
+	FamilyTypeComponentList::const_iterator iter;
+	for (iter = mComponents.begin(); iter != mComponents.end(); ++iter)
+	{
+		Datagram componentDg;
+		iter->second->write_datagram(manager, componentDg);
+		dg.add_string(std::string(iter->second->componentType()));
+		dg.add_string(componentDg.get_message());
+	}
+}
+
+void Object::fillin(DatagramIterator& scan, BamReader* manager)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	TypedWritableReferenceCount::fillin(scan, manager);
+	//the transform
+	if (scan.get_bool())
+	{
+		LMatrix4f mat;
+		mat.read_datagram(scan);
+		if (not mNodePath.is_empty())
+		{
+			mNodePath.set_mat(mat);
+		}
+	}
+	//the components' runtime state (missing components are skipped)
+	int numComponents = scan.get_uint16();
+	for (int i = 0; i < numComponents; ++i)
+	{
+		ComponentType componentType(scan.get_string());
+		Datagram componentDg(scan.get_string());
+		FamilyTypeComponentList::const_iterator iter = find_if(
+				mComponents.begin(), mComponents.end(),
+				componentHasType(componentType));
+		if (iter != mComponents.end())
+		{
+			DatagramIterator componentScan(componentDg);
+			iter->second->fillin(componentScan, manager);
+		}
+	}
+}
+
 void Object::doLoadInitializationFunctions()
 {
 	//if initializations loaded do nothing
 	RETURN_ON_COND(mInitializationsLoaded,)
 
-	// doReset errors
-	lt_dlerror();
-	//load the initialization functions library
-	mInitializationLib = lt_dlopen(
-			GameManager::GetSingletonPtr()->getDataInfo(
-					GameManager::INITIALIZATIONS).c_str());
-	if (mInitializationLib == NULL)
+	//load initialization function (if any): the one specified is resolved
+	//once per template, <OBJECTID>_initialization (per Object) is looked up
+	//into the registry, which doesn't record it if missing
+	std::string functionName;
+	if (not mInititializationFuncName.empty())
+	{
+		functionName = mInititializationFuncName;
+		mInitializationFunction = mTmpl->functionCache().find<PINITIALIZATION>(
+				FunctionRegistry::INITIALIZATIONS, functionName);
+	}
+	else
+	{
+		functionName = std::string(mObjectId) + "_initialization";
+		mInitializationFunction =
+				FunctionRegistry::GetSingleton().find<PINITIALIZATION>(
+						FunctionRegistry::INITIALIZATIONS, functionName);
+	}
+	if (not mInitializationFunction)
 	{
-		std::cerr << "Error loading library: "
-				<< GameManager::GetSingletonPtr()->getDataInfo(
-						GameManager::INITIALIZATIONS) << ": " << lt_dlerror()
-				<< std::endl;
-		return;
+		PRINT_ERR_DEBUG("No initialization function '" << functionName << "'");
 	}
 	//initializations loaded
 	mInitializationsLoaded = true;
@@ -249,16 +305,8 @@ void Object::doUnloadInitializationFunctions()
 	//if initializations not loaded do nothing
 	RETURN_ON_COND(not mInitializationsLoaded,)
 
-	//Close the initialization functions library
-	// doReset errors
-	lt_dlerror();
-	if (lt_dlclose(mInitializationLib) != 0)
-	{
-		std::cerr << "Error closing library: "
-				<< GameManager::GetSingletonPtr()->getDataInfo(
-						GameManager::INITIALIZATIONS) << ": " << lt_dlerror()
-				<< std::endl;
-	}
+	//the initialization functions library is owned by the FunctionRegistry
+	mInitializationFunction = NULL;
 	//initializations unloaded
 	mInitializationsLoaded = false;
 }
@@ -280,10 +328,11 @@ ObjectTemplate::ObjectTemplate(const ObjectType& name,
 				"ObjectTemplate::ObjectTemplate: invalid ObjectTemplateManager");
 
 	}
-	if (not pandaFramework or not windowFramework)
+	//no WindowFramework when headless
+	if (not pandaFramework)
 	{
 		throw GameException(
-				"ObjectTemplate::ObjectTemplate: invalid PandaFramework or WindowFramework");
+				"ObjectTemplate::ObjectTemplate: invalid PandaFramework");
 	}
 	//reset parameters
 	setParametersDefaults();
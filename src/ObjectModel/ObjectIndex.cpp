@@ -0,0 +1,521 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/ObjectModel/ObjectIndex.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "ObjectModel/ObjectIndex.h"
+#include "ObjectModel/Object.h"
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+///Value of the erased entries.
+const AtomicAdjust::Integer TOMBSTONE = -1;
+///Minimum hash table capacity (a power of 2).
+const unsigned int MIN_CAPACITY = 64;
+}
+
+namespace ely
+{
+
+const unsigned int ObjectIndex::CHUNK_SIZE;
+const unsigned int ObjectIndex::MAX_CHUNKS;
+
+ObjectIndex::ObjectIndex() :
+		mNumSlots(0), mNumObjects(0)
+{
+	for (unsigned int i = 0; i < MAX_CHUNKS; ++i)
+	{
+		AtomicAdjust::set_ptr(mChunks[i], NULL);
+	}
+	AtomicAdjust::set_ptr(mIdTable, doNewTable(MIN_CAPACITY));
+	AtomicAdjust::set_ptr(mNodeTable, doNewTable(MIN_CAPACITY));
+	AtomicAdjust::set(mEpoch, 0);
+	AtomicAdjust::set(mReaders[0], 0);
+	AtomicAdjust::set(mReaders[1], 0);
+	AtomicAdjust::set(mRetiring, 0);
+}
+
+ObjectIndex::~ObjectIndex()
+{
+	//no more readers: release everything
+	for (unsigned int i = 0; i < mNumSlots; ++i)
+	{
+		Object* object = reinterpret_cast<Object*>(AtomicAdjust::get_ptr(
+				doGetSlot(i)->mObject));
+		if (object)
+		{
+			unref_delete(object);
+		}
+	}
+	doReclaim(true);
+	for (unsigned int i = 0; i < MAX_CHUNKS; ++i)
+	{
+		free(AtomicAdjust::get_ptr(mChunks[i]));
+	}
+	doDeleteTable(reinterpret_cast<Table*>(AtomicAdjust::get_ptr(mIdTable)));
+	doDeleteTable(reinterpret_cast<Table*>(AtomicAdjust::get_ptr(mNodeTable)));
+}
+
+ObjectHandle ObjectIndex::insert(Object* object, const std::string& objectId,
+		PandaNode* node)
+{
+	RETURN_ON_COND(not object, ObjectHandle())
+
+	//get a slot: a free one or a new one
+	unsigned int index;
+	if (not mFreeSlots.empty())
+	{
+		index = mFreeSlots.back();
+		mFreeSlots.pop_back();
+	}
+	else
+	{
+		RETURN_ON_COND(mNumSlots == CHUNK_SIZE * MAX_CHUNKS, ObjectHandle())
+
+		index = mNumSlots;
+		if (index % CHUNK_SIZE == 0)
+		{
+			void* chunk = calloc(CHUNK_SIZE, sizeof(Slot));
+			if (not chunk)
+			{
+				throw std::bad_alloc();
+			}
+			AtomicAdjust::set_ptr(mChunks[index / CHUNK_SIZE], chunk);
+		}
+		++mNumSlots;
+	}
+	//fill the slot before publishing it into the tables: in use slots
+	//have odd generations
+	Slot* slot = doGetSlot(index);
+	object->ref();
+	slot->mIdHash = doHashId(objectId);
+	slot->mNode = node;
+	AtomicAdjust::set_ptr(slot->mObject, object);
+	AtomicAdjust::inc(slot->mGeneration);
+	doInsert(mIdTable, slot->mIdHash, index + 1, false);
+	if (node)
+	{
+		doInsert(mNodeTable, reinterpret_cast<unsigned long int>(node),
+				index + 1, true);
+	}
+	++mNumObjects;
+	doReclaim();
+	//
+	ObjectHandle handle;
+	handle.mIndex = index;
+	handle.mGeneration = AtomicAdjust::get(slot->mGeneration);
+	return handle;
+}
+
+bool ObjectIndex::erase(const ObjectHandle& handle)
+{
+	RETURN_ON_COND((not handle.isValid()) or (handle.mIndex >= mNumSlots),
+			false)
+
+	Slot* slot = doGetSlot(handle.mIndex);
+	RETURN_ON_COND(
+			static_cast<unsigned int>(AtomicAdjust::get(slot->mGeneration))
+					!= handle.mGeneration, false)
+
+	doErase(mIdTable, slot->mIdHash, handle.mIndex + 1, false);
+	if (slot->mNode)
+	{
+		doErase(mNodeTable, reinterpret_cast<unsigned long int>(slot->mNode),
+				handle.mIndex + 1, true);
+	}
+	Object* object = reinterpret_cast<Object*>(AtomicAdjust::get_ptr(
+			slot->mObject));
+	AtomicAdjust::compare_and_exchange_ptr(slot->mObject, object, NULL);
+	AtomicAdjust::inc(slot->mGeneration);
+	slot->mNode = NULL;
+	doRetire(NULL, object, handle.mIndex);
+	--mNumObjects;
+	doReclaim();
+	return true;
+}
+
+void ObjectIndex::setNode(const ObjectHandle& handle, PandaNode* node)
+{
+	RETURN_ON_COND((not handle.isValid()) or (handle.mIndex >= mNumSlots),)
+
+	Slot* slot = doGetSlot(handle.mIndex);
+	RETURN_ON_COND(
+			(static_cast<unsigned int>(AtomicAdjust::get(slot->mGeneration))
+					!= handle.mGeneration) or (slot->mNode == node),)
+
+	if (slot->mNode)
+	{
+		doErase(mNodeTable, reinterpret_cast<unsigned long int>(slot->mNode),
+				handle.mIndex + 1, true);
+	}
+	slot->mNode = node;
+	if (node)
+	{
+		doInsert(mNodeTable, reinterpret_cast<unsigned long int>(node),
+				handle.mIndex + 1, true);
+	}
+	doReclaim();
+}
+
+ObjectHandle ObjectIndex::findHandle(const std::string& objectId) const
+{
+	ReaderScope scope(*this);
+
+	unsigned int value = doLookup(mIdTable, doHashId(objectId), &objectId);
+	RETURN_ON_COND(value == 0, ObjectHandle())
+
+	ObjectHandle handle;
+	handle.mIndex = value - 1;
+	handle.mGeneration = AtomicAdjust::get(doGetSlot(handle.mIndex)->mGeneration);
+	//an even generation means the Object has just been removed
+	RETURN_ON_COND(not (handle.mGeneration & 1), ObjectHandle())
+
+	return handle;
+}
+
+SMARTPTR(Object)ObjectIndex::find(const std::string& objectId) const
+{
+	ReaderScope scope(*this);
+
+	unsigned int value = doLookup(mIdTable, doHashId(objectId), &objectId);
+	RETURN_ON_COND(value == 0, NULL)
+
+	return reinterpret_cast<Object*>(AtomicAdjust::get_ptr(
+			doGetSlot(value - 1)->mObject));
+}
+
+SMARTPTR(Object)ObjectIndex::find(const ObjectHandle& handle) const
+{
+	RETURN_ON_COND((not handle.isValid())
+			or (handle.mIndex >= CHUNK_SIZE * MAX_CHUNKS), NULL)
+
+	ReaderScope scope(*this);
+
+	Slot* chunk = reinterpret_cast<Slot*>(AtomicAdjust::get_ptr(
+			mChunks[handle.mIndex / CHUNK_SIZE]));
+	RETURN_ON_COND(not chunk, NULL)
+
+	Slot& slot = chunk[handle.mIndex % CHUNK_SIZE];
+	Object* object = reinterpret_cast<Object*>(AtomicAdjust::get_ptr(
+			slot.mObject));
+	RETURN_ON_COND(
+			static_cast<unsigned int>(AtomicAdjust::get(slot.mGeneration))
+					!= handle.mGeneration, NULL)
+
+	return object;
+}
+
+SMARTPTR(Object)ObjectIndex::findByNode(PandaNode* node) const
+{
+	RETURN_ON_COND(not node, NULL)
+
+	ReaderScope scope(*this);
+
+	unsigned int value = doLookup(mNodeTable,
+			reinterpret_cast<unsigned long int>(node), NULL);
+	RETURN_ON_COND(value == 0, NULL)
+
+	return reinterpret_cast<Object*>(AtomicAdjust::get_ptr(
+			doGetSlot(value - 1)->mObject));
+}
+
+ObjectIndex::Slot* ObjectIndex::doGetSlot(unsigned int index) const
+{
+	return reinterpret_cast<Slot*>(AtomicAdjust::get_ptr(
+			mChunks[index / CHUNK_SIZE])) + index % CHUNK_SIZE;
+}
+
+unsigned long int ObjectIndex::doHashId(const std::string& objectId)
+{
+	//FNV-1a
+	unsigned long int hash = 2166136261UL;
+	for (std::string::const_iterator iter = objectId.begin();
+			iter != objectId.end(); ++iter)
+	{
+		hash = (hash ^ static_cast<unsigned char>(*iter)) * 16777619UL;
+	}
+	return hash;
+}
+
+unsigned long int ObjectIndex::doHashNode(unsigned long int node)
+{
+	//nodes are aligned: mix the high bits into the low ones
+	node ^= node >> 16;
+	return node * 2654435761UL;
+}
+
+unsigned int ObjectIndex::doLookup(const AtomicAdjust::Pointer& table,
+		unsigned long int key, const std::string* objectId) const
+{
+	Table* current = reinterpret_cast<Table*>(AtomicAdjust::get_ptr(table));
+	unsigned long int hash = objectId ? key : doHashNode(key);
+	for (unsigned int i = hash & current->mMask, n = 0; n <= current->mMask;
+			i = (i + 1) & current->mMask, ++n)
+	{
+		Entry& entry = current->mEntries[i];
+		//the value is read first: the key of a free entry is written before
+		//its value
+		AtomicAdjust::Integer value = AtomicAdjust::get(entry.mValue);
+		if (value == 0)
+		{
+			break;
+		}
+		if ((value == TOMBSTONE)
+				or (static_cast<unsigned long int>(AtomicAdjust::get(
+						entry.mKey)) != key))
+		{
+			continue;
+		}
+		if (objectId)
+		{
+			//identifiers with the same hash
+			Object* object = reinterpret_cast<Object*>(AtomicAdjust::get_ptr(
+					doGetSlot(value - 1)->mObject));
+			if ((not object) or (object->mObjectId != *objectId))
+			{
+				continue;
+			}
+		}
+		return value;
+	}
+	return 0;
+}
+
+void ObjectIndex::doInsert(AtomicAdjust::Pointer& table, unsigned long int key,
+		unsigned int value, bool byNode)
+{
+	Table* current = reinterpret_cast<Table*>(AtomicAdjust::get_ptr(table));
+	unsigned long int hash = byNode ? doHashNode(key) : key;
+	if (byNode)
+	{
+		//a node belongs to one Object only: replace the existing value
+		for (unsigned int i = hash & current->mMask, n = 0;
+				n <= current->mMask; i = (i + 1) & current->mMask, ++n)
+		{
+			Entry& entry = current->mEntries[i];
+			AtomicAdjust::Integer entryValue = AtomicAdjust::get(entry.mValue);
+			if (entryValue == 0)
+			{
+				break;
+			}
+			if ((entryValue != TOMBSTONE)
+					and (static_cast<unsigned long int>(AtomicAdjust::get(
+							entry.mKey)) == key))
+			{
+				AtomicAdjust::set(entry.mValue, value);
+				return;
+			}
+		}
+	}
+	//keep the load factor (tombstones included) under 1/2
+	if ((current->mUsed + 1) * 2 > current->mMask + 1)
+	{
+		unsigned int live = 0;
+		for (unsigned int i = 0; i <= current->mMask; ++i)
+		{
+			if (AtomicAdjust::get(current->mEntries[i].mValue) > 0)
+			{
+				++live;
+			}
+		}
+		unsigned int capacity = MIN_CAPACITY;
+		while (capacity < (live + 1) * 4)
+		{
+			capacity *= 2;
+		}
+		//build and publish the new table: readers of the old one are safe
+		Table* newTable = doNewTable(capacity);
+		for (unsigned int i = 0; i <= current->mMask; ++i)
+		{
+			Entry& entry = current->mEntries[i];
+			AtomicAdjust::Integer entryValue = AtomicAdjust::get(entry.mValue);
+			if (entryValue > 0)
+			{
+				unsigned long int entryKey = AtomicAdjust::get(entry.mKey);
+				doPlace(newTable, entryKey,
+						byNode ? doHashNode(entryKey) : entryKey, entryValue);
+			}
+		}
+		AtomicAdjust::compare_and_exchange_ptr(table, current, newTable);
+		doRetire(current, NULL, -1);
+		current = newTable;
+	}
+	doPlace(current, key, hash, value);
+}
+
+void ObjectIndex::doErase(AtomicAdjust::Pointer& table, unsigned long int key,
+		unsigned int value, bool byNode)
+{
+	Table* current = reinterpret_cast<Table*>(AtomicAdjust::get_ptr(table));
+	unsigned long int hash = byNode ? doHashNode(key) : key;
+	for (unsigned int i = hash & current->mMask, n = 0; n <= current->mMask;
+			i = (i + 1) & current->mMask, ++n)
+	{
+		Entry& entry = current->mEntries[i];
+		AtomicAdjust::Integer entryValue = AtomicAdjust::get(entry.mValue);
+		if (entryValue == 0)
+		{
+			break;
+		}
+		if ((entryValue == static_cast<AtomicAdjust::Integer>(value))
+				and (static_cast<unsigned long int>(AtomicAdjust::get(
+						entry.mKey)) == key))
+		{
+			AtomicAdjust::set(entry.mValue, TOMBSTONE);
+			break;
+		}
+	}
+}
+
+ObjectIndex::Table* ObjectIndex::doNewTable(unsigned int capacity)
+{
+	Table* table = new Table;
+	table->mMask = capacity - 1;
+	table->mUsed = 0;
+	table->mEntries = reinterpret_cast<Entry*>(calloc(capacity, sizeof(Entry)));
+	if (not table->mEntries)
+	{
+		delete table;
+		throw std::bad_alloc();
+	}
+	return table;
+}
+
+void ObjectIndex::doDeleteTable(Table* table)
+{
+	free(table->mEntries);
+	delete table;
+}
+
+void ObjectIndex::doPlace(Table* table, unsigned long int key,
+		unsigned long int hash, unsigned int value)
+{
+	for (unsigned int i = hash & table->mMask;; i = (i + 1) & table->mMask)
+	{
+		Entry& entry = table->mEntries[i];
+		AtomicAdjust::Integer entryValue = AtomicAdjust::get(entry.mValue);
+		if ((entryValue == 0) or (entryValue == TOMBSTONE))
+		{
+			//the key is written before the value
+			AtomicAdjust::set(entry.mKey, key);
+			AtomicAdjust::set(entry.mValue, value);
+			if (entryValue == 0)
+			{
+				++table->mUsed;
+			}
+			return;
+		}
+	}
+}
+
+void ObjectIndex::doRetire(Table* table, Object* object, int slot)
+{
+	//the data has been unpublished with a full barrier (compare and
+	//exchange): the epoch read now is not less than the one of any reader
+	//that can still see it
+	Retired retired;
+	retired.mEpoch = AtomicAdjust::get(mEpoch);
+	retired.mTable = table;
+	retired.mObject = object;
+	retired.mSlot = slot;
+	mRetired.push_back(retired);
+	AtomicAdjust::set(mRetiring, 1);
+}
+
+bool ObjectIndex::doAdvanceEpoch() const
+{
+	AtomicAdjust::Integer epoch = AtomicAdjust::get(mEpoch);
+	//the readers of the previous epoch (same parity of the next one) must
+	//have left: readers are never more than one epoch behind
+	RETURN_ON_COND(AtomicAdjust::get(mReaders[(epoch + 1) & 1]) != 0, false)
+
+	return AtomicAdjust::compare_and_exchange(mEpoch, epoch, epoch + 1)
+			== epoch;
+}
+
+void ObjectIndex::doReclaim(bool all)
+{
+	RETURN_ON_COND(mRetired.empty(),)
+
+	if (not all)
+	{
+		//two advances release what has been retired in the current epoch
+		doAdvanceEpoch();
+		doAdvanceEpoch();
+	}
+	AtomicAdjust::Integer epoch = AtomicAdjust::get(mEpoch);
+	//retired data is ordered by epoch
+	unsigned int released = 0;
+	for (; released < mRetired.size(); ++released)
+	{
+		Retired& retired = mRetired[released];
+		if ((not all) and (epoch - retired.mEpoch < 2))
+		{
+			break;
+		}
+		if (retired.mTable)
+		{
+			doDeleteTable(retired.mTable);
+		}
+		if (retired.mObject)
+		{
+			unref_delete(retired.mObject);
+		}
+		if (retired.mSlot >= 0)
+		{
+			mFreeSlots.push_back(retired.mSlot);
+		}
+	}
+	mRetired.erase(mRetired.begin(), mRetired.begin() + released);
+	AtomicAdjust::set(mRetiring, mRetired.empty() ? 0 : 1);
+}
+
+ObjectIndex::ReaderScope::ReaderScope(const ObjectIndex& index) :
+		mIndex(index)
+{
+	//enter the current epoch: retry if it has advanced meanwhile (so the
+	//counter is not bypassed by a concurrent advance)
+	while (true)
+	{
+		AtomicAdjust::Integer epoch = AtomicAdjust::get(mIndex.mEpoch);
+		mReaders = &mIndex.mReaders[epoch & 1];
+		AtomicAdjust::inc(*mReaders);
+		if (AtomicAdjust::get(mIndex.mEpoch) == epoch)
+		{
+			break;
+		}
+		AtomicAdjust::dec(*mReaders);
+	}
+}
+
+ObjectIndex::ReaderScope::~ReaderScope()
+{
+	AtomicAdjust::dec(*mReaders);
+	//help the writers: their retired data is released after two advances
+	if (AtomicAdjust::get(mIndex.mRetiring) != 0)
+	{
+		mIndex.doAdvanceEpoch();
+	}
+}
+
+} // namespace ely
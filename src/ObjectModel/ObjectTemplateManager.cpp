@@ -23,6 +23,9 @@
 
 #include "ObjectModel/ObjectTemplateManager.h"
 #include "ObjectModel/ComponentTemplateManager.h"
+#include "Support/Replay.h"
+#include "Support/InterestGrid.h"
+#include "Support/SpatialIndex.h"
 
 namespace ely
 {
@@ -41,7 +44,7 @@ ObjectTemplateManager::~ObjectTemplateManager()
 	{
 		ObjectTable::iterator iter = mCreatedObjects.begin();
 		ObjectId objId = iter->first;
-		destroyObject(objId);
+		doDestroyObject(objId);
 	}
 	//remove Object templates
 	while (mObjectTemplates.size() > 0)
@@ -118,6 +121,11 @@ SMARTPTR(Object)ObjectTemplateManager::createObject(ObjectType objectType,
 	SMARTPTR(Object) oldObject = getCreatedObject(objectId);
 	RETURN_ON_COND(oldObject, oldObject)
 
+	//when replaying only the recorded Objects are created
+	Replay* replay = Replay::GetSingletonPtr();
+	RETURN_ON_COND(replay and replay->isReplaying() and (not replay->isApplying()),
+			NULL)
+
 	//retrieve the ObjectTemplate
 	ObjectTemplateTable::iterator it1 = mObjectTemplates.find(objectType);
 	RETURN_ON_COND(it1 == mObjectTemplates.end(), NULL)
@@ -236,8 +244,27 @@ SMARTPTR(Object)ObjectTemplateManager::createObject(ObjectType objectType,
 #endif //ELY_THREAD
 
 	//Now the Object is completely existent so insert
-	//it in the table of created objects.
+	//it in the table of created objects and into the index.
 	mCreatedObjects[newId] = newObj;
+	NodePath objectNP = newObj->getNodePath();
+	newObj->mHandle = mIndex.insert(newObj, newId,
+			objectNP.is_empty() ? NULL : objectNP.node());
+	//track it into the interest grid and the spatial index (if any)
+	InterestGrid* interestGrid = InterestGrid::GetSingletonPtr();
+	if (interestGrid)
+	{
+		interestGrid->addObject(newObj);
+	}
+	SpatialIndex* spatialIndex = SpatialIndex::GetSingletonPtr();
+	if (spatialIndex)
+	{
+		spatialIndex->addObject(newObj);
+	}
+	if (replay and replay->isRecording())
+	{
+		replay->recordSpawn(objectType, newId, objectParams, componentsParams,
+				storeParams, owner ? owner->objectId() : ObjectId(""));
+	}
 	return newObj;
 }
 
@@ -246,6 +273,22 @@ bool ObjectTemplateManager::destroyObject(const ObjectId& objectId)
 	//lock (guard) the mutex
 	HOLD_REMUTEX(mMutex)
 
+	//when replaying only the recorded Objects are destroyed
+	Replay* replay = Replay::GetSingletonPtr();
+	RETURN_ON_COND(replay and replay->isReplaying() and (not replay->isApplying()),
+			false)
+
+	RETURN_ON_COND(not doDestroyObject(objectId), false)
+
+	if (replay and replay->isRecording())
+	{
+		replay->recordDestroy(objectId);
+	}
+	return true;
+}
+
+bool ObjectTemplateManager::doDestroyObject(const ObjectId& objectId)
+{
 	ObjectTable::iterator objectIter;
 	objectIter = mCreatedObjects.find(objectId);
 	RETURN_ON_COND(objectIter == mCreatedObjects.end(), false)
@@ -312,7 +355,20 @@ bool ObjectTemplateManager::destroyObject(const ObjectId& objectId)
 	}
 #endif //ELY_THREAD
 
-	//remove Object from the table of created objects.
+	//remove Object from the interest grid and the spatial index (if any),
+	//from the index and from the table of created objects.
+	InterestGrid* interestGrid = InterestGrid::GetSingletonPtr();
+	if (interestGrid)
+	{
+		interestGrid->removeObject(object->objectId());
+	}
+	SpatialIndex* spatialIndex = SpatialIndex::GetSingletonPtr();
+	if (spatialIndex)
+	{
+		spatialIndex->removeObject(object->objectId());
+	}
+	mIndex.erase(object->mHandle);
+	object->mHandle = ObjectHandle();
 	mCreatedObjects.erase(objectIter);
 	return true;
 }
@@ -336,14 +392,14 @@ void ObjectTemplateManager::destroyAllObjects()
 	//remove not owned objects
 	for (unsigned int i = 0; i < notOwnedObjectIds.size(); ++i)
 	{
-		destroyObject(notOwnedObjectIds[i]);
+		doDestroyObject(notOwnedObjectIds[i]);
 	}
 	//remove any remaining (zombie) objects: should be none
 	while (mCreatedObjects.size() > 0)
 	{
 		ObjectTable::iterator iter = mCreatedObjects.begin();
 		ObjectId objId = iter->first;
-		destroyObject(objId);
+		doDestroyObject(objId);
 	}
 }
 
@@ -476,15 +532,33 @@ bool ObjectTemplateManager::removeComponentFromObject(ObjectId objectId,
 }
 
 SMARTPTR(Object)ObjectTemplateManager::getCreatedObject(const ObjectId& objectId) const
+{
+	//lock-free: no need to lock the mutex
+	return mIndex.find(objectId);
+}
+
+SMARTPTR(Object)ObjectTemplateManager::getCreatedObjectByNodePath(
+		const NodePath& nodePath) const
+{
+	//walk up the ancestors
+	NodePath current = nodePath;
+	while (not current.is_empty())
+	{
+		SMARTPTR(Object) object = mIndex.findByNode(current.node());
+		RETURN_ON_COND(object, object)
+
+		current = current.get_parent();
+	}
+	return NULL;
+}
+
+void ObjectTemplateManager::doIndexObjectNode(Object* object)
 {
 	//lock (guard) the mutex
 	HOLD_REMUTEX(mMutex)
 
-	ObjectTable::const_iterator iterObj;
-	iterObj = mCreatedObjects.find(objectId);
-	RETURN_ON_COND(iterObj == mCreatedObjects.end(), NULL)
-
-	return iterObj->second;
+	mIndex.setNode(object->mHandle,
+			object->mNodePath.is_empty() ? NULL : object->mNodePath.node());
 }
 
 std::list<SMARTPTR(Object)> ObjectTemplateManager::getCreatedObjects() const
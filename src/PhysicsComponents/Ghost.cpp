@@ -27,6 +27,7 @@
 #include "SceneComponents/Model.h"
 #include "SceneComponents/InstanceOf.h"
 #include "SceneComponents/Terrain.h"
+#include "Support/EventBus.h"
 #include <throw_event.h>
 
 namespace ely
@@ -560,30 +561,45 @@ void Ghost::update(void* data)
 			{
 				SMARTPTR(Component)physicsComponent = GamePhysicsManager::GetSingletonPtr()->getPhysicsComponentByPandaNode(
 						mGhostNode->get_overlapping_node(i));
-				//insert a default: check of equality is done only on OverlapNodeData::mPnode member
-				std::pair<std::set<OverlappingNode>::iterator, bool> res =
-				mOverlappingNodes.insert(
-						OverlappingNode(
-								mGhostNode->get_overlapping_node(i)));
+				//look up with a scratch key: check of equality is done only on OverlapNodeData::mPnode member
+				std::pair<std::set<OverlappingNode>::iterator, bool> res;
+				res.first = mOverlappingNodes.find(
+						OverlappingNode(mGhostNode->get_overlapping_node(i),
+								FrameArena::getThreadArena()));
+				res.second = (res.first == mOverlappingNodes.end());
 				if (res.second)
 				{
+					//insert a default
+					res.first = mOverlappingNodes.insert(
+							OverlappingNode(
+									mGhostNode->get_overlapping_node(i))).first;
 					//this is a "new" overlapping object
 					//event name: <OverlappingObjectType>_<GhostObjectType>_Overlap
 					(res.first)->mOverlappingNodeData->mEventName =
 						physicsComponent->getOwnerObject()->objectTmpl()->objectType()
 						+ "_" + mOverlap.mEventName;
-					//throw the event
-					throw_event((res.first)->mOverlappingNodeData->mEventName,
-							EventParameter(physicsComponent), EventParameter(this));
+					//post the event (and throw it if asked)
+					if (EventBus::postEvent(EventBus::OVERLAP_EVENT,
+							(res.first)->mOverlappingNodeData->mEventName,
+							physicsComponent, this))
+					{
+						throw_event((res.first)->mOverlappingNodeData->mEventName,
+								EventParameter(physicsComponent), EventParameter(this));
+					}
 				}
 				else
 				{
 					//this is an "old" overlapping object
 					if (mOverlap.mTimeElapsed >= mOverlap.mPeriod)
 					{
-						//throw the event
-						throw_event((res.first)->mOverlappingNodeData->mEventName,
-								EventParameter(physicsComponent), EventParameter(this));
+						//post the event (and throw it if asked)
+						if (EventBus::postEvent(EventBus::OVERLAP_EVENT,
+								(res.first)->mOverlappingNodeData->mEventName,
+								physicsComponent, this))
+						{
+							throw_event((res.first)->mOverlappingNodeData->mEventName,
+									EventParameter(physicsComponent), EventParameter(this));
+						}
 					}
 				}
 				//update count flag
@@ -608,9 +624,14 @@ void Ghost::update(void* data)
 			{
 				SMARTPTR(Component)physicsComponent = GamePhysicsManager::GetSingletonPtr()->getPhysicsComponentByPandaNode(
 						i->mOverlappingNodeData->mPnode);
-				//throw the "off" event
-				throw_event(i->mOverlappingNodeData->mEventName + "Off",
-						EventParameter(physicsComponent), EventParameter(this));
+				//post the "off" event (and throw it if asked)
+				if (EventBus::postEvent(EventBus::OVERLAP_OFF_EVENT,
+						i->mOverlappingNodeData->mEventName + "Off",
+						physicsComponent, this))
+				{
+					throw_event(i->mOverlappingNodeData->mEventName + "Off",
+							EventParameter(physicsComponent), EventParameter(this));
+				}
 				//erase the object
 				mOverlappingNodes.erase(i++);
 			}
@@ -720,8 +741,6 @@ GhostTemplate::GhostTemplate(PandaFramework* pandaFramework,
 {
 	CHECK_EXISTENCE_DEBUG(pandaFramework,
 			"GhostTemplate::GhostTemplate: invalid PandaFramework")
-	CHECK_EXISTENCE_DEBUG(windowFramework,
-			"GhostTemplate::GhostTemplate: invalid WindowFramework")
 	CHECK_EXISTENCE_DEBUG(GamePhysicsManager::GetSingletonPtr(),
 			"GhostTemplate::GhostTemplate: invalid GamePhysicsManager")
 	//
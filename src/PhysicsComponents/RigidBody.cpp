@@ -491,6 +491,42 @@ void RigidBody::doSwitchBodyType(BodyType bodyType)
 	}
 }
 
+void RigidBody::write_datagram(BamWriter* manager, Datagram& dg)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	Component::write_datagram(manager, dg);
+	BodyType bodyType =
+			mRigidBodyNode->is_kinematic() ? KINEMATIC :
+			(mRigidBodyNode->is_static() ? STATIC : DYNAMIC);
+	dg.add_uint8(bodyType);
+	mRigidBodyNode->get_linear_velocity().write_datagram(dg);
+	mRigidBodyNode->get_angular_velocity().write_datagram(dg);
+	dg.add_bool(mRigidBodyNode->is_active());
+}
+
+void RigidBody::fillin(DatagramIterator& scan, BamReader* manager)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	Component::fillin(scan, manager);
+	BodyType bodyType = static_cast<BodyType>(scan.get_uint8());
+	LVector3f linearVelocity, angularVelocity;
+	linearVelocity.read_datagram(scan);
+	angularVelocity.read_datagram(scan);
+	bool active = scan.get_bool();
+	//return if destroying
+	RETURN_ON_ASYNC_COND(mDestroying,)
+
+	doSwitchBodyType(bodyType);
+	mRigidBodyNode->clear_forces();
+	mRigidBodyNode->set_linear_velocity(linearVelocity);
+	mRigidBodyNode->set_angular_velocity(angularVelocity);
+	mRigidBodyNode->set_active(active, true);
+}
+
 SMARTPTR(BulletShape)RigidBody::doCreateShape(GamePhysicsManager::ShapeType shapeType)
 {
 	//check if it should use shape of another (already) created object
@@ -566,8 +602,6 @@ RigidBodyTemplate::RigidBodyTemplate(PandaFramework* pandaFramework,
 {
 	CHECK_EXISTENCE_DEBUG(pandaFramework,
 			"RigidBodyTemplate::RigidBodyTemplate: invalid PandaFramework")
-	CHECK_EXISTENCE_DEBUG(windowFramework,
-			"RigidBodyTemplate::RigidBodyTemplate: invalid WindowFramework")
 	CHECK_EXISTENCE_DEBUG(GamePhysicsManager::GetSingletonPtr(),
 			"RigidBodyTemplate::RigidBodyTemplate: invalid GamePhysicsManager")
 	//
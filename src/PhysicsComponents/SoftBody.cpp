@@ -590,8 +590,6 @@ SoftBodyTemplate::SoftBodyTemplate(PandaFramework* pandaFramework,
 {
 	CHECK_EXISTENCE_DEBUG(pandaFramework,
 			"SoftBodyTemplate::SoftBodyTemplate: invalid PandaFramework")
-	CHECK_EXISTENCE_DEBUG(windowFramework,
-			"SoftBodyTemplate::SoftBodyTemplate: invalid WindowFramework")
 	CHECK_EXISTENCE_DEBUG(GamePhysicsManager::GetSingletonPtr(),
 			"SoftBodyTemplate::SoftBodyTemplate: invalid GamePhysicsManager")
 	//
@@ -572,8 +572,6 @@ CharacterControllerTemplate::CharacterControllerTemplate(PandaFramework* pandaFr
 {
 	CHECK_EXISTENCE_DEBUG(pandaFramework,
 			"CharacterTemplate::CharacterTemplate: invalid PandaFramework")
-	CHECK_EXISTENCE_DEBUG(windowFramework,
-			"CharacterTemplate::CharacterTemplate: invalid WindowFramework")
 	CHECK_EXISTENCE_DEBUG(GamePhysicsManager::GetSingletonPtr(),
 			"CharacterTemplate::CharacterTemplate: invalid GamePhysicsManager")
 	//
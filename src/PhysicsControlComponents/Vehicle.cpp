@@ -603,12 +603,12 @@ void Vehicle::onAddToSceneSetup()
 		//Scene component scale param
 		compTmplParams[sceneCompType].insert(
 				ParameterTable::value_type("scale", mWheelScaleParam[idx]));
-		//actually create the wheel object
+		//actually create the wheel object (restorable by a Snapshot)
 		mWheelObjects[idx] = ObjectTemplateManager::GetSingletonPtr()->
 		createObject(ObjectType(mWheelTmpl),
 				ObjectId(mComponentId + std::string("Wheel") +
 						dynamic_cast<std::ostringstream&>(std::ostringstream().operator <<(idx)).str()),
-				objTmplParam, compTmplParams, false, mOwnerObject);
+				objTmplParam, compTmplParams, true, mOwnerObject);
 		//object initialization
 		mWheelObjects[idx]->worldSetup();
 
@@ -827,8 +827,6 @@ VehicleTemplate::VehicleTemplate(PandaFramework* pandaFramework,
 {
 	CHECK_EXISTENCE_DEBUG(pandaFramework,
 			"VehicleTemplate::VehicleTemplate: invalid PandaFramework")
-	CHECK_EXISTENCE_DEBUG(windowFramework,
-			"VehicleTemplate::VehicleTemplate: invalid WindowFramework")
 	CHECK_EXISTENCE_DEBUG(GamePhysicsManager::GetSingletonPtr(),
 			"VehicleTemplate::VehicleTemplate: invalid GamePhysicsManager")
 	//
@@ -69,6 +69,13 @@ bool InstanceOf::initialize()
 		value = strtof(paramValuesStr[idx].c_str(), NULL);
 		mScale[idx] = (value >= 0.0 ? value : -value);
 	}
+	//instanced
+	mInstanced = (
+			mTmpl->parameter(std::string("instanced")) == std::string("true") ?
+					true : false);
+	//cell size
+	value = strtof(mTmpl->parameter(std::string("cell_size")).c_str(), NULL);
+	mCellSize = (value > 0.0 ? value : (value < 0.0 ? -value : 64.0));
 	//
 	return result;
 }
@@ -97,7 +104,27 @@ void InstanceOf::onAddToObjectSetup()
 		if (sceneComponent and
 				(sceneComponent->componentType() == ComponentType("Model")))
 		{
-			DCAST(Model, sceneComponent)->getNodePath().instance_to(mNodePath);
+			if (mInstanced)
+			{
+				//drawn by the batch of the instanced object (wrt render)
+				NodePath renderNP =
+						ObjectTemplateManager::GetSingleton().getCreatedObject(
+								ObjectId("render"))->getNodePath();
+				mInstanceBatch =
+						GameSceneManager::GetSingletonPtr()->getInstanceBatch(
+								mInstanceOfId,
+								DCAST(Model, sceneComponent)->getNodePath(),
+								renderNP, mCellSize);
+				//lock (guard) the scene manager mutex
+				HOLD_REMUTEX(GameSceneManager::GetSingletonPtr()->getMutex())
+
+				mInstanceHandle = mInstanceBatch->addInstance(mNodePath);
+			}
+			else
+			{
+				DCAST(Model, sceneComponent)->getNodePath().instance_to(
+						mNodePath);
+			}
 		}
 	}
 	//reparent this InstanceOf node path to the object node path
@@ -106,8 +133,20 @@ void InstanceOf::onAddToObjectSetup()
 
 void InstanceOf::onRemoveFromObjectCleanup()
 {
+	//remove from the instance batch (if any)
+	if (mInstanceBatch)
+	{
+		{
+			//lock (guard) the scene manager mutex
+			HOLD_REMUTEX(GameSceneManager::GetSingletonPtr()->getMutex())
+
+			mInstanceBatch->removeInstance(mInstanceHandle);
+		}
+		GameSceneManager::GetSingletonPtr()->releaseInstanceBatch(
+				mInstanceOfId);
+	}
 	//detach the first child of this instance of node path (if any)
-	if (mInstancedObject and (mNodePath.get_num_children() > 0))
+	else if (mInstancedObject and (mNodePath.get_num_children() > 0))
 	{
 		// \see NodePath::instance_to() documentation.
 		mNodePath.get_child(0).detach_node();
@@ -130,8 +169,6 @@ InstanceOfTemplate::InstanceOfTemplate(PandaFramework* pandaFramework,
 {
 	CHECK_EXISTENCE_DEBUG(pandaFramework,
 			"InstanceOfTemplate::InstanceOfTemplate: invalid PandaFramework")
-	CHECK_EXISTENCE_DEBUG(windowFramework,
-			"InstanceOfTemplate::InstanceOfTemplate: invalid WindowFramework")
 	CHECK_EXISTENCE_DEBUG(GameSceneManager::GetSingletonPtr(),
 			"InstanceOfTemplate::InstanceOfTemplate: invalid GameSceneManager")
 	//
@@ -173,6 +210,8 @@ void InstanceOfTemplate::setParametersDefaults()
 	mParameterTable.clear();
 	//sets the (mandatory) parameters to their default values:
 	mParameterTable.insert(ParameterNameValue("scale", "1.0"));
+	mParameterTable.insert(ParameterNameValue("instanced", "false"));
+	mParameterTable.insert(ParameterNameValue("cell_size", "64.0"));
 }
 
 //TypedObject semantics: hardcoded
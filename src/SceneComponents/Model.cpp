@@ -30,6 +30,8 @@
 #include <sheetNode.h>
 #include <geomNode.h>
 #include <texturePool.h>
+#include <mutexHolder.h>
+#include <throw_event.h>
 
 namespace ely
 {
@@ -91,6 +93,11 @@ bool Model::initialize()
 	mModelNameParam = mTmpl->parameter(std::string("model_file"));
 	//more animations
 	mAnimFileListParam = mTmpl->parameterList(std::string("anim_files"));
+	//async load
+	mAsyncLoad = (
+			mTmpl->parameter(std::string("async_load")) == std::string("true") ?
+					true : false);
+	mPlaceholderParam = mTmpl->parameter(std::string("placeholder_file"));
 	//if model not from file then get which type
 	mModelTypeParam = mTmpl->parameter(std::string("model_type"));
 	//
@@ -217,165 +224,157 @@ bool Model::initialize()
 	return result;
 }
 
-void Model::onAddToObjectSetup()
+bool Model::doLoadFromFile(const std::string& modelNameParam,
+		const std::list<std::string>& animFileListParam, NodePath& modelNP,
+		AnimControlCollection& animations,
+		SMARTPTR(PartBundle)& firstPartBundle)
 {
-	//build model
-	if (mFromFile)
+	// some declarations
+	Parts parts;
+	Anims anims;
+	Parts::const_iterator partsIter;
+	Anims::const_iterator animsIter;
+	PartBundles::const_iterator partBundlesIter;
+	AnimBundles::const_iterator animBundlesIter;
+	parts.clear();
+	anims.clear();
+	//setup model (with possible animations)
+	//modelNameParam can have this form: [anim_name1@anim_name2@
+	// ...@anim_nameN@]model_filename ([] means optional)
+	std::vector<std::string> animsFileNames = parseCompoundString(
+			modelNameParam, '@');
+	if (animsFileNames.empty())
 	{
-		PRINT_DEBUG(
-				"'" <<getOwnerObject()->objectId() << "'::'" << mComponentId << "'::onAddToObjectSetup");
-		// some declarations
-		Parts parts;
-		Anims anims;
-		Parts::const_iterator partsIter;
-		Anims::const_iterator animsIter;
-		PartBundles::const_iterator partBundlesIter;
-		AnimBundles::const_iterator animBundlesIter;
-		parts.clear();
-		anims.clear();
-		//setup model (with possible animations)
-		//mModelNameParam can have this form: [anim_name1@anim_name2@
-		// ...@anim_nameN@]model_filename ([] means optional)
-		std::vector<std::string> animsFileNames = parseCompoundString(
-				mModelNameParam, '@');
-		if (animsFileNames.empty())
-		{
-			animsFileNames.push_back("");
-		}
-		//use the last element (model file name)
-		std::string modelFileName = animsFileNames.back();
-		//remove last element
-		animsFileNames.pop_back();
-		mNodePath = mTmpl->windowFramework()->load_model(
-				mTmpl->pandaFramework()->get_models(), Filename(modelFileName));
-		if (mNodePath.is_empty())
+		animsFileNames.push_back("");
+	}
+	//use the last element (model file name)
+	std::string modelFileName = animsFileNames.back();
+	//remove last element
+	animsFileNames.pop_back();
+	modelNP = GameSceneManager::GetSingletonPtr()->modelLoader()->loadModel(
+			Filename(modelFileName));
+	RETURN_ON_COND(modelNP.is_empty(), false)
+
+	//find all the bundles into modelNP.node
+	do_r_find_bundles(modelNP.node(), anims, parts);
+	firstPartBundle.clear();
+	//check if there is at least one PartBundle
+	for (partsIter = parts.begin(); partsIter != parts.end(); ++partsIter)
+	{
+		for (partBundlesIter = partsIter->second.begin();
+				partBundlesIter != partsIter->second.end();
+				++partBundlesIter)
 		{
-			//On error loads our favorite blue triangle.
-			mTmpl->windowFramework()->load_default_model(
-					mTmpl->pandaFramework()->get_models());
+			if (not firstPartBundle)
+			{
+				//set the first PartBundle
+				firstPartBundle = *partBundlesIter;
+				PRINT_DEBUG(
+						"\tFirst PartBundle: '" << (*partBundlesIter)->get_name() << "'");
+			}
+			else
+			{
+				PRINT_DEBUG(
+						"\tNext PartBundle: '" << (*partBundlesIter)->get_name() << "'");
+			}
 		}
-		//find all the bundles into mNodePath.node
-		do_r_find_bundles(mNodePath.node(), anims, parts);
-		mFirstPartBundle.clear();
-		//check if there is at least one PartBundle
-		for (partsIter = parts.begin(); partsIter != parts.end(); ++partsIter)
+	}
+	//proceeds with animations only if there is at least one PartBundle
+	if (firstPartBundle)
+	{
+		//check if there are some AnimBundles within the model file
+		//and bind them to the first PartBundle
+		std::string animName;
+		int j = 1;
+		for (animsIter = anims.begin(); animsIter != anims.end();
+				++animsIter)
 		{
-			for (partBundlesIter = partsIter->second.begin();
-					partBundlesIter != partsIter->second.end();
-					++partBundlesIter)
+			for (animBundlesIter = animsIter->second.begin();
+					animBundlesIter != animsIter->second.end();
+					++animBundlesIter)
 			{
-				if (not mFirstPartBundle)
+				if (not animsFileNames.empty())
 				{
-					//set the first PartBundle
-					mFirstPartBundle = *partBundlesIter;
-					PRINT_DEBUG(
-							"\tFirst PartBundle: '" << (*partBundlesIter)->get_name() << "'");
+					//anim file names specified not finished:
+					//use the first name
+					animName = animsFileNames.front();
+					//remove first name
+					animsFileNames.erase(animsFileNames.begin());
 				}
 				else
 				{
-					PRINT_DEBUG(
-							"\tNext PartBundle: '" << (*partBundlesIter)->get_name() << "'");
+					//anim names finished
+					animName = modelFileName + '.' + format_string(j);
+					++j;
 				}
+				PRINT_DEBUG(
+						"\tBinding animation '" << (*animBundlesIter)->get_name() << "' (from '" << modelFileName << "') with name '" << animName << "'");
+				SMARTPTR(AnimControl)control = (firstPartBundle->bind_anim(*animBundlesIter,
+								PartGroup::HMF_ok_wrong_root_name|PartGroup::HMF_ok_part_extra|PartGroup::HMF_ok_anim_extra)).p();
+				animations.store_anim(control, animName);
 			}
 		}
-		//proceeds with animations only if there is at least one PartBundle
-		if (mFirstPartBundle)
-		{
-			//check if there are some AnimBundles within the model file
-			//and bind them to the first PartBundle
-			std::string animName;
-			int j = 1;
-			for (animsIter = anims.begin(); animsIter != anims.end();
-					++animsIter)
-			{
-				for (animBundlesIter = animsIter->second.begin();
-						animBundlesIter != animsIter->second.end();
-						++animBundlesIter)
-				{
-					if (not animsFileNames.empty())
-					{
-						//anim file names specified not finished:
-						//use the first name
-						animName = animsFileNames.front();
-						//remove first name
-						animsFileNames.erase(animsFileNames.begin());
-					}
-					else
-					{
-						//anim names finished
-						animName = modelFileName + '.' + format_string(j);
-						++j;
-					}
-					PRINT_DEBUG(
-							"\tBinding animation '" << (*animBundlesIter)->get_name() << "' (from '" << modelFileName << "') with name '" << animName << "'");
-					SMARTPTR(AnimControl)control = (mFirstPartBundle->bind_anim(*animBundlesIter,
-									PartGroup::HMF_ok_wrong_root_name|PartGroup::HMF_ok_part_extra|PartGroup::HMF_ok_anim_extra)).p();
-					mAnimations.store_anim(control, animName);
-				}
-			}
 
-			//setup more animations (if any)
-			std::list<std::string>::iterator iter;
-			for (iter = mAnimFileListParam.begin();
-					iter != mAnimFileListParam.end(); ++iter)
+		//setup more animations (if any)
+		std::list<std::string>::const_iterator iter;
+		for (iter = animFileListParam.begin();
+				iter != animFileListParam.end(); ++iter)
+		{
+			//any "anim_files" string is a "compound" one, i.e. could have the form:
+			// "anim_name1@anim_file1:anim_name2@anim_file2:...:anim_nameN@anim_fileN"
+			std::vector<std::string> nameFilePairs = parseCompoundString(
+					*iter, ':');
+			std::vector<std::string>::const_iterator iterPair;
+			for (iterPair = nameFilePairs.begin();
+					iterPair != nameFilePairs.end(); ++iterPair)
 			{
-				//any "anim_files" string is a "compound" one, i.e. could have the form:
-				// "anim_name1@anim_file1:anim_name2@anim_file2:...:anim_nameN@anim_fileN"
-				std::vector<std::string> nameFilePairs = parseCompoundString(
-						*iter, ':');
-				std::vector<std::string>::const_iterator iterPair;
-				for (iterPair = nameFilePairs.begin();
-						iterPair != nameFilePairs.end(); ++iterPair)
+				//an empty anim_name@anim_file is ignored
+				if (not iterPair->empty())
 				{
-					//an empty anim_name@anim_file is ignored
-					if (not iterPair->empty())
+					parts.clear();
+					anims.clear();
+					//get anim name and anim file name
+					std::vector<std::string> nameFilePair =
+							parseCompoundString(*iterPair, '@');
+					//check only if there is a pair
+					if (nameFilePair.size() == 2)
 					{
-						parts.clear();
-						anims.clear();
-						//get anim name and anim file name
-						std::vector<std::string> nameFilePair =
-								parseCompoundString(*iterPair, '@');
-						//check only if there is a pair
-						if (nameFilePair.size() == 2)
+						//anim name == nameFilePair[0]
+						//anim file name == nameFilePair[1]
+						//get the AnimBundle node path
+						NodePath animNP =
+								GameSceneManager::GetSingletonPtr()->modelLoader()->loadModel(
+										Filename(nameFilePair[1]));
+						if (not animNP.is_empty())
 						{
-							//anim name == nameFilePair[0]
-							//anim file name == nameFilePair[1]
-							//get the AnimBundle node path
-							NodePath animNP =
-									mTmpl->windowFramework()->load_model(
-											mNodePath,
-											Filename(nameFilePair[1]));
-							if (animNP.is_empty())
-							{
-								animNP = NodePath();
-							}
-							//find all the bundles into animNP.node
-							do_r_find_bundles(animNP.node(), anims, parts);
-							for (animsIter = anims.begin();
-									animsIter != anims.end(); ++animsIter)
+							animNP.reparent_to(modelNP);
+						}
+						//find all the bundles into animNP.node
+						do_r_find_bundles(animNP.node(), anims, parts);
+						for (animsIter = anims.begin();
+								animsIter != anims.end(); ++animsIter)
+						{
+							int j;
+							for (j = 0, animBundlesIter =
+									animsIter->second.begin();
+									animBundlesIter
+											!= animsIter->second.end();
+									++animBundlesIter, ++j)
 							{
-								int j;
-								for (j = 0, animBundlesIter =
-										animsIter->second.begin();
-										animBundlesIter
-												!= animsIter->second.end();
-										++animBundlesIter, ++j)
+								if (j > 0)
+								{
+									animName = nameFilePair[0] + '.'
+											+ format_string(j);
+								}
+								else
 								{
-									if (j > 0)
-									{
-										animName = nameFilePair[0] + '.'
-												+ format_string(j);
-									}
-									else
-									{
-										animName = nameFilePair[0];
-									}
-									PRINT_DEBUG(
-											"\tBinding animation '" << (*animBundlesIter)->get_name() << "' (from '" << nameFilePair[1] << "') with name '" << animName << "'");
-									SMARTPTR(AnimControl)control = (mFirstPartBundle->bind_anim(*animBundlesIter,
-													PartGroup::HMF_ok_wrong_root_name|PartGroup::HMF_ok_part_extra|PartGroup::HMF_ok_anim_extra)).p();
-									mAnimations.store_anim(control, animName);
+									animName = nameFilePair[0];
 								}
+								PRINT_DEBUG(
+										"\tBinding animation '" << (*animBundlesIter)->get_name() << "' (from '" << nameFilePair[1] << "') with name '" << animName << "'");
+								SMARTPTR(AnimControl)control = (firstPartBundle->bind_anim(*animBundlesIter,
+												PartGroup::HMF_ok_wrong_root_name|PartGroup::HMF_ok_part_extra|PartGroup::HMF_ok_anim_extra)).p();
+								animations.store_anim(control, animName);
 							}
 						}
 					}
@@ -383,6 +382,48 @@ void Model::onAddToObjectSetup()
 			}
 		}
 	}
+	//
+	return true;
+}
+
+void Model::onAddToObjectSetup()
+{
+	//build model
+	if (mFromFile)
+	{
+		PRINT_DEBUG(
+				"'" <<getOwnerObject()->objectId() << "'::'" << mComponentId << "'::onAddToObjectSetup");
+		if (mAsyncLoad)
+		{
+			//Component standard name: ObjectId_ObjectType_ComponentId_ComponentType
+			mNodePath = NodePath(COMPONENT_STANDARD_NAME);
+			//placeholder (if any) shown until the model is loaded
+			if (not mPlaceholderParam.empty())
+			{
+				mPlaceholder =
+						GameSceneManager::GetSingletonPtr()->modelLoader()->loadModel(
+								Filename(mPlaceholderParam));
+				if (not mPlaceholder.is_empty())
+				{
+					mPlaceholder.reparent_to(mNodePath);
+				}
+			}
+			//load and bind on the loader thread
+			mLoading = true;
+			GameSceneManager::GetSingletonPtr()->modelLoader()->dispatch(
+					new LoadTask(this, mModelNameParam, mAnimFileListParam));
+		}
+		else if (not doLoadFromFile(mModelNameParam, mAnimFileListParam,
+				mNodePath, mAnimations, mFirstPartBundle))
+		{
+			//On error loads our favorite blue triangle (if not headless).
+			if (mTmpl->windowFramework())
+			{
+				mTmpl->windowFramework()->load_default_model(
+						mTmpl->pandaFramework()->get_models());
+			}
+		}
+	}
 	else
 	{
 		//not from file: model is programmatically generated
@@ -437,9 +478,12 @@ void Model::onAddToObjectSetup()
 		}
 		else
 		{
-			//On error loads our favorite blue triangle.
-			mNodePath = mTmpl->windowFramework()->load_default_model(
-					mTmpl->pandaFramework()->get_models());
+			//On error loads our favorite blue triangle (an empty node if
+			//headless).
+			mNodePath = mTmpl->windowFramework() ?
+					mTmpl->windowFramework()->load_default_model(
+							mTmpl->pandaFramework()->get_models()) :
+					NodePath(COMPONENT_STANDARD_NAME);
 		}
 		//texturing
 		SMARTPTR(TextureStage) textureStage0 =
@@ -472,10 +516,102 @@ void Model::onRemoveFromObjectCleanup()
 {
 	//Remove node path
 	mNodePath.remove_node();
-	//
+	//a pending load could be writing its results
+	MutexHolder guard(mLoadMutex);
 	reset();
 }
 
+void Model::onAddToSceneSetup()
+{
+	//Add to the scene manager update if loading
+	if (mLoading)
+	{
+		GameSceneManager::GetSingletonPtr()->addToSceneUpdate(this);
+	}
+}
+
+void Model::onRemoveFromSceneCleanup()
+{
+	//remove from the scene manager update (if added)
+	GameSceneManager::GetSingletonPtr()->removeFromSceneUpdate(this);
+}
+
+void Model::update(void* data)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	RETURN_ON_COND(not mLoading,)
+
+	//get load results (if ready)
+	NodePath loadedNP;
+	{
+		MutexHolder guard(mLoadMutex);
+		RETURN_ON_COND(not mLoadReady,)
+
+		loadedNP = mLoadedNP;
+		mAnimations = mLoadedAnimations;
+		mFirstPartBundle = mLoadedPartBundle;
+		mLoadedNP = NodePath();
+		mLoadedAnimations.clear_anims();
+		mLoadedPartBundle.clear();
+		mLoadReady = false;
+	}
+	mLoading = false;
+	//no more updates needed
+	GameSceneManager::GetSingletonPtr()->removeFromSceneUpdate(this);
+	//replace the placeholder (kept on error)
+	if (not loadedNP.is_empty())
+	{
+		if (not mPlaceholder.is_empty())
+		{
+			mPlaceholder.remove_node();
+		}
+		loadedNP.reparent_to(mNodePath);
+		//instanced copies of the placeholder are replaced too
+		GameSceneManager::GetSingletonPtr()->refreshInstanceBatch(
+				getOwnerObject()->objectId(), mNodePath);
+	}
+	else
+	{
+		PRINT_ERR_DEBUG(
+				"Model::update: '" << getOwnerObject()->objectId() << "' model not loaded");
+	}
+	//throw the event
+	throw_event(getOwnerObject()->objectId() + "_Model_Loaded",
+			EventParameter(this));
+}
+
+Model::LoadTask::LoadTask(Model* model, const std::string& modelNameParam,
+		const std::list<std::string>& animFileListParam) :
+		AsyncTask(modelNameParam + "-load"), mModel(model), mModelNameParam(
+				modelNameParam), mAnimFileListParam(animFileListParam)
+{
+}
+
+AsyncTask::DoneStatus Model::LoadTask::do_task()
+{
+	//load and bind out of the scene graph
+	NodePath modelNP;
+	AnimControlCollection animations;
+	SMARTPTR(PartBundle) firstPartBundle;
+	if (not mModel->doLoadFromFile(mModelNameParam, mAnimFileListParam,
+			modelNP, animations, firstPartBundle))
+	{
+		modelNP = NodePath();
+	}
+	//hand over to update()
+	{
+		MutexHolder guard(mModel->mLoadMutex);
+		mModel->mLoadedNP = modelNP;
+		mModel->mLoadedAnimations = animations;
+		mModel->mLoadedPartBundle = firstPartBundle;
+		mModel->mLoadReady = true;
+	}
+	//
+	return DS_done;
+}
+
 SMARTPTR(PartBundle)Model::getPartBundle() const
 {
 	//lock (guard) the mutex
@@ -495,8 +631,6 @@ ModelTemplate::ModelTemplate(PandaFramework* pandaFramework,
 {
 	CHECK_EXISTENCE_DEBUG(pandaFramework,
 			"ModelTemplate::ModelTemplate: invalid PandaFramework")
-	CHECK_EXISTENCE_DEBUG(windowFramework,
-			"ModelTemplate::ModelTemplate: invalid WindowFramework")
 	CHECK_EXISTENCE_DEBUG(GameSceneManager::GetSingletonPtr(),
 			"ModelTemplate::ModelTemplate: invalid GameSceneManager")
 	//
@@ -550,6 +684,7 @@ void ModelTemplate::setParametersDefaults()
 	mParameterTable.insert(ParameterNameValue("sheet_num_v_subdiv", "2"));
 	mParameterTable.insert(ParameterNameValue("texture_uscale", "1.0"));
 	mParameterTable.insert(ParameterNameValue("texture_vscale", "1.0"));
+	mParameterTable.insert(ParameterNameValue("async_load", "false"));
 }
 
 //TypedObject semantics: hardcoded
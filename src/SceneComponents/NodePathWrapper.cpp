@@ -24,6 +24,7 @@
 #include "SceneComponents/NodePathWrapper.h"
 #include "ObjectModel/Object.h"
 #include "Game/GameSceneManager.h"
+#include "Game/GameManager.h"
 
 namespace ely
 {
@@ -53,26 +54,49 @@ bool NodePathWrapper::initialize()
 void NodePathWrapper::onAddToObjectSetup()
 {
 	//setup the wrapped NodePath
-	if (mWrappedNodePathParam == std::string("render"))
+	WindowFramework* window = mTmpl->windowFramework();
+	if (not window)
 	{
-		mNodePath = mTmpl->windowFramework()->get_render();
+		//headless: the game manager's stand-ins
+		GameManager* gameMgr = GameManager::GetSingletonPtr();
+		if (mWrappedNodePathParam == std::string("render2d"))
+		{
+			mNodePath = gameMgr->getRender2d();
+		}
+		else if (mWrappedNodePathParam == std::string("aspect2d"))
+		{
+			mNodePath = gameMgr->getAspect2d();
+		}
+		else if (mWrappedNodePathParam == std::string("camera"))
+		{
+			mNodePath = gameMgr->getCameraGroup();
+		}
+		else
+		{
+			//default is render
+			mNodePath = gameMgr->getRender();
+		}
+	}
+	else if (mWrappedNodePathParam == std::string("render"))
+	{
+		mNodePath = window->get_render();
 	}
 	else if (mWrappedNodePathParam == std::string("render2d"))
 	{
-		mNodePath = mTmpl->windowFramework()->get_render_2d();
+		mNodePath = window->get_render_2d();
 	}
 	else if (mWrappedNodePathParam == std::string("aspect2d"))
 	{
-		mNodePath = mTmpl->windowFramework()->get_aspect_2d();
+		mNodePath = window->get_aspect_2d();
 	}
 	else if (mWrappedNodePathParam == std::string("camera"))
 	{
-		mNodePath = mTmpl->windowFramework()->get_camera_group();
+		mNodePath = window->get_camera_group();
 	}
 	else
 	{
 		//default is render
-		mNodePath = mTmpl->windowFramework()->get_render();
+		mNodePath = window->get_render();
 	}
 
 	//set the object node path to this NodePathWrapper of node path
@@ -102,8 +126,6 @@ NodePathWrapperTemplate::NodePathWrapperTemplate(PandaFramework* pandaFramework,
 {
 	CHECK_EXISTENCE_DEBUG(pandaFramework,
 			"NodePathWrapperTemplate::NodePathWrapperTemplate: invalid PandaFramework")
-	CHECK_EXISTENCE_DEBUG(windowFramework,
-			"NodePathWrapperTemplate::NodePathWrapperTemplate: invalid WindowFramework")
 	CHECK_EXISTENCE_DEBUG(GameSceneManager::GetSingletonPtr(),
 			"NodePathWrapperTemplate::NodePathWrapperTemplate: invalid GameSceneManager")
 	//
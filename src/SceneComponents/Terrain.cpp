@@ -104,9 +104,6 @@ bool Terrain::initialize()
 	valueInt = strtol(mTmpl->parameter(std::string("minimum_level")).c_str(),
 			NULL, 0);
 	mMinimumLevel = (valueInt >= 0.0 ? valueInt : -valueInt);
-	//heightfield file
-	mHeightField = PNMImage(
-			Filename(mTmpl->parameter(std::string("heightfield_file"))));
 	//texture
 	mTextureImage = TexturePool::load_texture(
 			Filename(mTmpl->parameter(std::string("texture_file"))));
@@ -118,6 +115,68 @@ bool Terrain::initialize()
 	value = strtof(mTmpl->parameter(std::string("texture_vscale")).c_str(),
 			NULL);
 	mTextureVscale = (value >= 0.0 ? value : -value);
+	//update mode
+	std::string updateMode = mTmpl->parameter(std::string("update_mode"));
+	if (updateMode == std::string("quadtree"))
+	{
+		mUpdateMode = QUADTREE;
+	}
+	else if (updateMode == std::string("paged"))
+	{
+		mUpdateMode = PAGED;
+	}
+	else
+	{
+		mUpdateMode = GEOMIP;
+	}
+	//regen budget
+	valueInt = strtol(mTmpl->parameter(std::string("regen_budget")).c_str(),
+			NULL, 0);
+	mRegenBudget = (valueInt > 0 ? valueInt : (valueInt < 0 ? -valueInt : 1));
+	//regen threads
+	valueInt = strtol(mTmpl->parameter(std::string("regen_threads")).c_str(),
+			NULL, 0);
+	mRegenThreads = (valueInt >= 0 ? valueInt : -valueInt);
+	//paged mode
+	if (mUpdateMode == PAGED)
+	{
+		//page files
+		mPageSettings.mHeightfieldPattern = mTmpl->parameter(
+				std::string("page_heightfield"));
+		mPageSettings.mTexturePattern = mTmpl->parameter(
+				std::string("page_texture"));
+		//pages x, y
+		valueInt = strtol(mTmpl->parameter(std::string("pages_x")).c_str(),
+				NULL, 0);
+		mPageSettings.mPagesX = (valueInt > 0 ? valueInt : 1);
+		valueInt = strtol(mTmpl->parameter(std::string("pages_y")).c_str(),
+				NULL, 0);
+		mPageSettings.mPagesY = (valueInt > 0 ? valueInt : 1);
+		//page size
+		valueInt = strtol(mTmpl->parameter(std::string("page_size")).c_str(),
+				NULL, 0);
+		mPageSettings.mPageSize = (valueInt > 1 ? valueInt : 257);
+		//page radius
+		valueInt = strtol(mTmpl->parameter(std::string("page_radius")).c_str(),
+				NULL, 0);
+		mPageSettings.mRadius = (valueInt >= 0 ? valueInt : -valueInt);
+		//page physics
+		mPageSettings.mPhysics = (
+				mTmpl->parameter(std::string("page_physics"))
+						== std::string("false") ? false : true);
+		//a page heightfield pattern is mandatory
+		if (mPageSettings.mHeightfieldPattern.empty())
+		{
+			PRINT_ERR_DEBUG("Terrain::initialize: no page_heightfield in paged mode");
+			result = false;
+		}
+	}
+	else
+	{
+		//heightfield file (paged mode: pages have their own)
+		mHeightField = PNMImage(
+				Filename(mTmpl->parameter(std::string("heightfield_file"))));
+	}
 	//
 	return result;
 }
@@ -129,26 +188,31 @@ void Terrain::onAddToObjectSetup()
 	//Component standard name: ObjectId_ObjectType_ComponentId_ComponentType
 	std::string name = COMPONENT_STANDARD_NAME;
 	mTerrain = new GeoMipTerrainRef(name);
-	//set height field
-	if (not mTerrain->set_heightfield(mHeightField))
+	//paged mode: the terrain root only parents the pages
+	if (mUpdateMode != PAGED)
 	{
-		//heightField the image is set to an
-		//empty (black) image with 512x512 dimensions.
-		mTerrain->set_heightfield(PNMImage(512, 512));
+		//set height field
+		if (not mTerrain->set_heightfield(mHeightField))
+		{
+			//heightField the image is set to an
+			//empty (black) image with 512x512 dimensions.
+			mTerrain->set_heightfield(PNMImage(512, 512));
+		}
+		//sizing
+		float environmentWidthX = (mHeightField.get_x_size() - 1) * mWidthScale;
+		float environmentWidthY = (mHeightField.get_y_size() - 1) * mWidthScale;
+		float environmentWidth = (environmentWidthX + environmentWidthY) / 2.0;
+		//set terrain properties effectively
+		mTerrain->set_block_size(mBlockSize);
+		mTerrain->set_near(mNearPercent * environmentWidth);
+		mTerrain->set_far(mFarPercent * environmentWidth);
+		//other properties
+		float terrainLODmin = min<float>(mMinimumLevel, mTerrain->get_max_level());
+		mTerrain->set_min_level(terrainLODmin);
+		mTerrain->set_auto_flatten(mFlattenMode);
+		mTerrain->set_bruteforce(mBruteForce);
 	}
-	//sizing
-	float environmentWidthX = (mHeightField.get_x_size() - 1) * mWidthScale;
-	float environmentWidthY = (mHeightField.get_y_size() - 1) * mWidthScale;
-	float environmentWidth = (environmentWidthX + environmentWidthY) / 2.0;
-	//set terrain properties effectively
-	mTerrain->set_block_size(mBlockSize);
-	mTerrain->set_near(mNearPercent * environmentWidth);
-	mTerrain->set_far(mFarPercent * environmentWidth);
-	//other properties
-	float terrainLODmin = min<float>(mMinimumLevel, mTerrain->get_max_level());
-	mTerrain->set_min_level(terrainLODmin);
-	mTerrain->set_auto_flatten(mFlattenMode);
-	mTerrain->set_bruteforce(mBruteForce);
+	//terrain scaling
 	if (mDoScale)
 	{
 		mTerrain->get_root().set_sx(mWidthScale);
@@ -181,11 +245,62 @@ void Terrain::onAddToObjectSetup()
 	}
 	mFocalPointNP = createdObject->getNodePath();
 	//Generate the terrain
-	mTerrain->generate();
+	if (mUpdateMode == QUADTREE)
+	{
+		//blocks are managed by the quadtree, under the terrain root:
+		//distances are in heightfield units
+		float heightfieldWidth = ((mHeightField.get_x_size() - 1)
+				+ (mHeightField.get_y_size() - 1)) / 2.0;
+		mQuadTree = new TerrainQuadTree(name, mTerrain->heightfield(),
+				mBlockSize, mMinimumLevel, mNearPercent * heightfieldWidth,
+				mFarPercent * heightfieldWidth, mRegenBudget, mRegenThreads);
+		mQuadTree->getRoot().reparent_to(mTerrain->get_root());
+		mQuadTree->setFocalPoint(
+				mTerrain->get_root().get_relative_point(mFocalPointNP,
+						LPoint3f::zero()));
+		mQuadTree->generate();
+	}
+	else if (mUpdateMode == PAGED)
+	{
+		//pages are managed by the pager, under the terrain root:
+		//distances are in heightfield units
+		float pageWidth = mPageSettings.mPageSize - 1;
+		mPageSettings.mTextureStage = textureStage0;
+		mPageSettings.mBlockSize = mBlockSize;
+		mPageSettings.mMinLevel = mMinimumLevel;
+		mPageSettings.mNear = mNearPercent * pageWidth;
+		mPageSettings.mFar = mFarPercent * pageWidth;
+		mPageSettings.mBruteForce = mBruteForce;
+		mPageSettings.mFlattenMode = mFlattenMode;
+		mPager = new TerrainPager(name, mPageSettings, mRegenBudget,
+				mRegenThreads);
+		mPager->getRoot().reparent_to(mTerrain->get_root());
+		mPager->setFocalPoint(
+				mTerrain->get_root().get_relative_point(mFocalPointNP,
+						LPoint3f::zero()));
+		//only the focal page is loaded now: startup time is bounded
+		mPager->generate();
+	}
+	else
+	{
+		mTerrain->generate();
+	}
 }
 
 void Terrain::onRemoveFromObjectCleanup()
 {
+	//stop quadtree workers (if any)
+	if (mQuadTree)
+	{
+		mQuadTree->cleanup();
+		mQuadTree->getRoot().remove_node();
+	}
+	//stop pager workers and evict pages (if any)
+	if (mPager)
+	{
+		mPager->cleanup();
+		mPager->getRoot().remove_node();
+	}
 	//
 	reset();
 }
@@ -196,7 +311,7 @@ void Terrain::onAddToSceneSetup()
 	mTerrainRootNetPos = mTerrain->get_root().get_net_transform()->get_pos();
 
 	//Add to the scene manager update if not brute force
-	if(not mBruteForce)
+	if((not mBruteForce) or (mUpdateMode != GEOMIP))
 	{
 		//Add to the scene manager update if not brute force
 		GameSceneManager::GetSingletonPtr()->addToSceneUpdate(this);
@@ -206,7 +321,7 @@ void Terrain::onAddToSceneSetup()
 void Terrain::onRemoveFromSceneCleanup()
 {
 	//check if not brute force and if game scene manager exists
-	if (not mBruteForce)
+	if ((not mBruteForce) or (mUpdateMode != GEOMIP))
 	{
 		//remove from the scene manager update
 		GameSceneManager::GetSingletonPtr()->removeFromSceneUpdate(this);
@@ -224,6 +339,25 @@ void Terrain::update(void* data)
 	dt = 0.016666667; //60 fps
 #endif
 
+	if (mUpdateMode == QUADTREE)
+	{
+		//set focal point (wrt terrain root) and do a bounded cost update
+		mQuadTree->setFocalPoint(
+				mTerrain->get_root().get_relative_point(mFocalPointNP,
+						LPoint3f::zero()));
+		mQuadTree->update();
+		return;
+	}
+	if (mUpdateMode == PAGED)
+	{
+		//set focal point (wrt terrain root) and stream pages
+		mPager->setFocalPoint(
+				mTerrain->get_root().get_relative_point(mFocalPointNP,
+						LPoint3f::zero()));
+		mPager->update();
+		return;
+	}
+
 	//set focal point
 	//see https://www.panda3d.org/forums/viewtopic.php?t=5384
 	LPoint3f focalPointNetPos = mFocalPointNP.get_net_transform()->get_pos();
@@ -252,8 +386,6 @@ TerrainTemplate::TerrainTemplate(PandaFramework* pandaFramework,
 {
 	CHECK_EXISTENCE_DEBUG(pandaFramework,
 			"TerrainTemplate::TerrainTemplate: invalid PandaFramework")
-	CHECK_EXISTENCE_DEBUG(windowFramework,
-			"TerrainTemplate::TerrainTemplate: invalid WindowFramework")
 	CHECK_EXISTENCE_DEBUG(GameSceneManager::GetSingletonPtr(),
 			"TerrainTemplate::TerrainTemplate: invalid GameSceneManager")
 	//
@@ -306,6 +438,14 @@ void TerrainTemplate::setParametersDefaults()
 	mParameterTable.insert(ParameterNameValue("minimum_level", "0"));
 	mParameterTable.insert(ParameterNameValue("texture_uscale", "1.0"));
 	mParameterTable.insert(ParameterNameValue("texture_vscale", "1.0"));
+	mParameterTable.insert(ParameterNameValue("update_mode", "geomip"));
+	mParameterTable.insert(ParameterNameValue("regen_budget", "4"));
+	mParameterTable.insert(ParameterNameValue("regen_threads", "2"));
+	mParameterTable.insert(ParameterNameValue("pages_x", "1"));
+	mParameterTable.insert(ParameterNameValue("pages_y", "1"));
+	mParameterTable.insert(ParameterNameValue("page_size", "257"));
+	mParameterTable.insert(ParameterNameValue("page_radius", "1"));
+	mParameterTable.insert(ParameterNameValue("page_physics", "true"));
 }
 
 //TypedObject semantics: hardcoded
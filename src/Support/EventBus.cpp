@@ -0,0 +1,405 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/Support/EventBus.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "Support/EventBus.h"
+#include "Support/InterestGrid.h"
+#include "ObjectModel/Component.h"
+#include <asyncTaskManager.h>
+#include <eventHandler.h>
+#include <algorithm>
+
+namespace
+{
+///The id of the Object of an event object: itself or its owner.
+ely::ObjectId getObjectId(TypedWritableReferenceCount* object)
+{
+	RETURN_ON_COND(not object, ely::ObjectId())
+
+	if (object->is_of_type(ely::Object::get_class_type()))
+	{
+		return DCAST(ely::Object, object)->objectId();
+	}
+	if (object->is_of_type(ely::Component::get_class_type()))
+	{
+		SMARTPTR(ely::Object) owner =
+				DCAST(ely::Component, object)->getOwnerObject();
+		return owner ? owner->objectId() : ely::ObjectId();
+	}
+	return ely::ObjectId();
+}
+}
+
+namespace ely
+{
+
+EventBus::EventBus(int sort, int priority)
+{
+	mStats.mPosted = mStats.mDispatched = mStats.mBatches = 0;
+	//pre-register the builtin events (in BuiltinEvent order)
+	const char* builtinNames[BUILTIN_EVENT_NUM] =
+	{ "Collision", "CollisionOff", "Overlap", "OverlapOff", "CrowdAgent_Move",
+			"CrowdAgent_Steady", "SteerVehicle_Move", "SteerVehicle_Steady",
+			"SteerVehicle_PathFollowing", "SteerVehicle_AvoidObstacle",
+			"SteerVehicle_AvoidCloseNeighbor", "SteerVehicle_AvoidNeighbor" };
+	for (int i = 0; i < BUILTIN_EVENT_NUM; ++i)
+	{
+		registerEvent(builtinNames[i]);
+	}
+	//create the task for dispatching the events
+	mUpdateData = new TaskInterface<EventBus>::TaskData(this,
+			&EventBus::update);
+	mUpdateTask = new GenericAsyncTask("EventBus::update",
+			&TaskInterface<EventBus>::taskFunction,
+			reinterpret_cast<void*>(mUpdateData.p()));
+	//set sort/priority
+	mUpdateTask->set_sort(sort);
+	mUpdateTask->set_priority(priority);
+	//Adds mUpdateTask to the active queue.
+	AsyncTaskManager::get_global_ptr()->add(mUpdateTask);
+}
+
+EventBus::~EventBus()
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	if (mUpdateTask)
+	{
+		AsyncTaskManager::get_global_ptr()->remove(mUpdateTask);
+	}
+	mQueues.clear();
+	mEventIds.clear();
+}
+
+EventBus::EventId EventBus::registerEvent(const std::string& name)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	std::map<std::string, EventId>::const_iterator iter = mEventIds.find(name);
+	RETURN_ON_COND(iter != mEventIds.end(), iter->second)
+
+	EventId id = mQueues.size();
+	mQueues.push_back(EventQueue());
+	mQueues.back().mName = name;
+	mQueues.back().mPandaBridge = true;
+	mEventIds[name] = id;
+	return id;
+}
+
+EventBus::EventId EventBus::getEventId(const std::string& name)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	std::map<std::string, EventId>::const_iterator iter = mEventIds.find(name);
+	return iter != mEventIds.end() ? iter->second : (EventId) INVALID_EVENT;
+}
+
+std::string EventBus::getEventName(EventId id)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	RETURN_ON_COND(not doIsValid(id), std::string(""))
+
+	return mQueues[id].mName;
+}
+
+unsigned int EventBus::getNumEvents()
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	return mQueues.size();
+}
+
+void EventBus::subscribe(EventId id, Subscriber subscriber, void* data)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	RETURN_ON_COND((not doIsValid(id)) or (not subscriber),)
+
+	std::pair<Subscriber, void*> entry(subscriber, data);
+	std::vector<std::pair<Subscriber, void*> >& subscribers =
+			mQueues[id].mSubscribers;
+	if (std::find(subscribers.begin(), subscribers.end(), entry)
+			== subscribers.end())
+	{
+		subscribers.push_back(entry);
+	}
+}
+
+void EventBus::unsubscribe(EventId id, Subscriber subscriber, void* data)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	RETURN_ON_COND(not doIsValid(id),)
+
+	std::vector<std::pair<Subscriber, void*> >& subscribers =
+			mQueues[id].mSubscribers;
+	subscribers.erase(
+			std::remove(subscribers.begin(), subscribers.end(),
+					std::pair<Subscriber, void*>(subscriber, data)),
+			subscribers.end());
+	//no more subscribers: discard pending events
+	if (not doHasSubscribers(mQueues[id]))
+	{
+		mQueues[id].mPending.clear();
+	}
+}
+
+bool EventBus::hasSubscribers(EventId id)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	return doIsValid(id) and doHasSubscribers(mQueues[id]);
+}
+
+void EventBus::subscribeNear(EventId id, const ObjectId& observerId,
+		float radius, Subscriber subscriber, void* data)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	RETURN_ON_COND((not doIsValid(id)) or (not subscriber),)
+
+	std::vector<EventQueue::NearSubscriber>& subscribers =
+			mQueues[id].mNearSubscribers;
+	std::vector<EventQueue::NearSubscriber>::iterator iter;
+	for (iter = subscribers.begin(); iter != subscribers.end(); ++iter)
+	{
+		if ((iter->mSubscriber == subscriber) and (iter->mData == data)
+				and (iter->mObserverId == observerId))
+		{
+			//already subscribed: update the radius
+			iter->mRadius = radius;
+			return;
+		}
+	}
+	EventQueue::NearSubscriber entry;
+	entry.mSubscriber = subscriber;
+	entry.mData = data;
+	entry.mObserverId = observerId;
+	entry.mRadius = radius;
+	subscribers.push_back(entry);
+}
+
+void EventBus::unsubscribeNear(EventId id, const ObjectId& observerId,
+		Subscriber subscriber, void* data)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	RETURN_ON_COND(not doIsValid(id),)
+
+	std::vector<EventQueue::NearSubscriber>& subscribers =
+			mQueues[id].mNearSubscribers;
+	std::vector<EventQueue::NearSubscriber>::iterator iter;
+	for (iter = subscribers.begin(); iter != subscribers.end(); ++iter)
+	{
+		if ((iter->mSubscriber == subscriber) and (iter->mData == data)
+				and (iter->mObserverId == observerId))
+		{
+			subscribers.erase(iter);
+			break;
+		}
+	}
+	//no more subscribers: discard pending events
+	if (not doHasSubscribers(mQueues[id]))
+	{
+		mQueues[id].mPending.clear();
+	}
+}
+
+bool EventBus::post(EventId id, const std::string& pandaEvent,
+		TypedWritableReferenceCount* first, TypedWritableReferenceCount* second,
+		float value)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	RETURN_ON_COND(not doIsValid(id), doHasPandaHooks(pandaEvent))
+
+	EventQueue& queue = mQueues[id];
+	if (doHasSubscribers(queue))
+	{
+		//the queue capacity is kept between frames: no allocations at regime
+		queue.mPending.resize(queue.mPending.size() + 1);
+		Payload& payload = queue.mPending.back();
+		payload.mId = id;
+		payload.mFirst = first;
+		payload.mSecond = second;
+		payload.mValue = value;
+		++mStats.mPosted;
+	}
+	//the Panda event is thrown only if someone could handle it
+	return queue.mPandaBridge and doHasPandaHooks(pandaEvent);
+}
+
+bool EventBus::postEvent(EventId id, const std::string& pandaEvent,
+		TypedWritableReferenceCount* first, TypedWritableReferenceCount* second,
+		float value)
+{
+	EventBus* bus = GetSingletonPtr();
+	RETURN_ON_COND(not bus, doHasPandaHooks(pandaEvent))
+
+	return bus->post(id, pandaEvent, first, second, value);
+}
+
+bool EventBus::doHasPandaHooks(const std::string& pandaEvent)
+{
+	return (not pandaEvent.empty())
+			and EventHandler::get_global_event_handler()->has_hook(pandaEvent);
+}
+
+void EventBus::setPandaBridge(EventId id, bool enable)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	RETURN_ON_COND(not doIsValid(id),)
+
+	mQueues[id].mPandaBridge = enable;
+}
+
+bool EventBus::getPandaBridge(EventId id)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	return doIsValid(id) ? mQueues[id].mPandaBridge : true;
+}
+
+void EventBus::dispatch()
+{
+	unsigned long int dispatched = 0, batches = 0;
+	for (EventId id = 0;; ++id)
+	{
+		EventQueue* queue;
+		{
+			//lock (guard) the mutex
+			HOLD_REMUTEX(mMutex)
+
+			if (not doIsValid(id))
+			{
+				mStats.mDispatched += dispatched;
+				mStats.mBatches += batches;
+				return;
+			}
+			//the deque doesn't move the queues: the pointer stays valid
+			queue = &mQueues[id];
+			if (queue->mPending.empty())
+			{
+				continue;
+			}
+			//events posted by subscribers go to the next frame
+			queue->mDispatching.swap(queue->mPending);
+			//subscribers could (un)subscribe: copy them
+			mDispatchSubscribers = queue->mSubscribers;
+			mDispatchNearSubscribers = queue->mNearSubscribers;
+		}
+		//call the subscribers without holding the mutex: mDispatching is
+		//touched only here
+		const std::vector<Payload>& events = queue->mDispatching;
+		std::vector<std::pair<Subscriber, void*> >::const_iterator iter;
+		for (iter = mDispatchSubscribers.begin();
+				iter != mDispatchSubscribers.end(); ++iter)
+		{
+			iter->first(id, events, iter->second);
+			++batches;
+		}
+		std::vector<EventQueue::NearSubscriber>::const_iterator iterNear;
+		for (iterNear = mDispatchNearSubscribers.begin();
+				iterNear != mDispatchNearSubscribers.end(); ++iterNear)
+		{
+			if (doDispatchNear(id, events, *iterNear))
+			{
+				++batches;
+			}
+		}
+		dispatched += events.size();
+		//release the objects but keep the capacity
+		queue->mDispatching.clear();
+	}
+}
+
+bool EventBus::doDispatchNear(EventId id, const std::vector<Payload>& events,
+		const EventQueue::NearSubscriber& near)
+{
+	InterestGrid* interestGrid = InterestGrid::GetSingletonPtr();
+	if (not interestGrid)
+	{
+		//no grid: all events are near
+		near.mSubscriber(id, events, near.mData);
+		return true;
+	}
+	//the observer and the Objects near it, sorted
+	mNearIds.clear();
+	RETURN_ON_COND(
+			not interestGrid->queryNear(near.mObserverId, near.mRadius, mNearIds),
+			false)
+	mNearIds.push_back(near.mObserverId);
+	std::sort(mNearIds.begin(), mNearIds.end());
+	//filter the batch
+	mNearEvents.clear();
+	std::vector<Payload>::const_iterator iter;
+	for (iter = events.begin(); iter != events.end(); ++iter)
+	{
+		if (std::binary_search(mNearIds.begin(), mNearIds.end(),
+				getObjectId(iter->mFirst.p()))
+				or std::binary_search(mNearIds.begin(), mNearIds.end(),
+						getObjectId(iter->mSecond.p())))
+		{
+			mNearEvents.push_back(*iter);
+		}
+	}
+	bool called = not mNearEvents.empty();
+	if (called)
+	{
+		near.mSubscriber(id, mNearEvents, near.mData);
+	}
+	//release the objects but keep the capacity
+	mNearEvents.clear();
+	return called;
+}
+
+AsyncTask::DoneStatus EventBus::update(GenericAsyncTask* task)
+{
+	dispatch();
+	//
+	return AsyncTask::DS_cont;
+}
+
+EventBus::EventBusStats EventBus::getStats()
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	return mStats;
+}
+
+} // namespace ely
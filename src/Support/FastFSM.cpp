@@ -0,0 +1,99 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/Support/FastFSM.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "Support/FastFSM.h"
+
+namespace ely
+{
+
+FSMRequestQueue::FSMRequestQueue(unsigned int capacity)
+{
+	unsigned int size = 2;
+	while (size < capacity)
+	{
+		size *= 2;
+	}
+	mCells.resize(size);
+	//a cell is free for the producer at position pos when its sequence
+	//is pos, and ready for the consumer when it is pos+1
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		AtomicAdjust::set(mCells[i].mSequence, i);
+	}
+	mMask = size - 1;
+	AtomicAdjust::set(mEnqueuePos, 0);
+	mDequeuePos = 0;
+}
+
+bool FSMRequestQueue::push(const Request& request)
+{
+	AtomicAdjust::Integer pos = AtomicAdjust::get(mEnqueuePos);
+	Cell* cell;
+	for (;;)
+	{
+		cell = &mCells[pos & mMask];
+		long int diff = (long int) AtomicAdjust::get(cell->mSequence)
+				- (long int) pos;
+		if (diff == 0)
+		{
+			//try to claim the position
+			AtomicAdjust::Integer prev = AtomicAdjust::compare_and_exchange(
+					mEnqueuePos, pos, pos + 1);
+			if (prev == pos)
+			{
+				break;
+			}
+			pos = prev;
+		}
+		else if (diff < 0)
+		{
+			//full
+			return false;
+		}
+		else
+		{
+			//another producer claimed the position
+			pos = AtomicAdjust::get(mEnqueuePos);
+		}
+	}
+	cell->mRequest = request;
+	//publish
+	AtomicAdjust::set(cell->mSequence, pos + 1);
+	return true;
+}
+
+bool FSMRequestQueue::pop(Request& request)
+{
+	Cell& cell = mCells[mDequeuePos & mMask];
+	long int diff = (long int) AtomicAdjust::get(cell.mSequence)
+			- (long int) (mDequeuePos + 1);
+	RETURN_ON_COND(diff < 0, false)
+
+	request = cell.mRequest;
+	//free the cell for the next round
+	AtomicAdjust::set(cell.mSequence, mDequeuePos + mMask + 1);
+	++mDequeuePos;
+	return true;
+}
+
+} // namespace ely
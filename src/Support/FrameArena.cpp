@@ -0,0 +1,179 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/Support/FrameArena.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "Support/FrameArena.h"
+#include <pthread.h>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+///The current thread's arena.
+__thread ely::FrameArena* tArena = NULL;
+///Destroys the arena at thread exit.
+pthread_key_t sArenaKey;
+pthread_once_t sArenaKeyOnce = PTHREAD_ONCE_INIT;
+
+void destroyArena(void* arena)
+{
+	tArena = NULL;
+	delete reinterpret_cast<ely::FrameArena*>(arena);
+}
+
+void createArenaKey()
+{
+	pthread_key_create(&sArenaKey, &destroyArena);
+}
+}
+
+namespace ely
+{
+
+const unsigned char FrameArena::POISON_BYTE;
+const size_t FrameArena::DEFAULT_ALIGNMENT;
+
+FrameArena::FrameArena(size_t blockSize) :
+		mBlockSize(blockSize), mCurrentBlock(0), mOffset(0),
+		mUsedInPreviousBlocks(0), mHighWater(0)
+{
+#ifdef ELY_DEBUG
+	mPoison = true;
+#else
+	mPoison = false;
+#endif
+	doNextBlock(0);
+}
+
+FrameArena::~FrameArena()
+{
+	for (unsigned int i = 0; i < mBlocks.size(); ++i)
+	{
+		free(mBlocks[i].first);
+	}
+}
+
+FrameArena& FrameArena::getThreadArena()
+{
+	if (not tArena)
+	{
+		//first use by this thread
+		tArena = new FrameArena();
+		pthread_once(&sArenaKeyOnce, &createArenaKey);
+		pthread_setspecific(sArenaKey, tArena);
+	}
+	return *tArena;
+}
+
+void* FrameArena::alloc(size_t size, size_t alignment)
+{
+	//fit into the current block or the next ones
+	while (true)
+	{
+		unsigned char* block = mBlocks[mCurrentBlock].first;
+		size_t address = reinterpret_cast<size_t>(block) + mOffset;
+		size_t padding = (alignment - (address & (alignment - 1)))
+				& (alignment - 1);
+		if (mOffset + padding + size <= mBlocks[mCurrentBlock].second)
+		{
+			void* pMem = block + mOffset + padding;
+			mOffset += padding + size;
+			//update high-water mark
+			size_t used = doGetUsed();
+			if (used > mHighWater)
+			{
+				mHighWater = used;
+			}
+			return pMem;
+		}
+		doNextBlock(size + alignment);
+	}
+}
+
+void FrameArena::rewind(const Marker& marker)
+{
+	RETURN_ON_COND((marker.mBlock > mCurrentBlock) or
+			((marker.mBlock == mCurrentBlock) and (marker.mOffset >= mOffset)),)
+
+	if (mPoison)
+	{
+		//poison the released memory
+		for (unsigned int i = marker.mBlock; i <= mCurrentBlock; ++i)
+		{
+			size_t begin = (i == marker.mBlock ? marker.mOffset : 0);
+			size_t end = (i == mCurrentBlock ? mOffset : mBlocks[i].second);
+			memset(mBlocks[i].first + begin, POISON_BYTE, end - begin);
+		}
+	}
+	for (unsigned int i = marker.mBlock; i < mCurrentBlock; ++i)
+	{
+		mUsedInPreviousBlocks -= mBlocks[i].second;
+	}
+	mCurrentBlock = marker.mBlock;
+	mOffset = marker.mOffset;
+}
+
+FrameArena::FrameArenaStats FrameArena::getStats() const
+{
+	FrameArenaStats stats;
+	stats.mUsed = doGetUsed();
+	stats.mCapacity = 0;
+	for (unsigned int i = 0; i < mBlocks.size(); ++i)
+	{
+		stats.mCapacity += mBlocks[i].second;
+	}
+	stats.mHighWater = mHighWater;
+	stats.mBlocks = mBlocks.size();
+	return stats;
+}
+
+size_t FrameArena::doGetUsed() const
+{
+	return mUsedInPreviousBlocks + mOffset;
+}
+
+void FrameArena::doNextBlock(size_t minSize)
+{
+	if (not mBlocks.empty())
+	{
+		//the rest of the current block is wasted until rewinding
+		mUsedInPreviousBlocks += mBlocks[mCurrentBlock].second;
+		++mCurrentBlock;
+		mOffset = 0;
+		//reuse the next block if big enough
+		if ((mCurrentBlock < mBlocks.size())
+				and (mBlocks[mCurrentBlock].second >= minSize))
+		{
+			return;
+		}
+	}
+	//allocate a new block (inserted at the current position)
+	size_t size = minSize > mBlockSize ? minSize : mBlockSize;
+	unsigned char* block = reinterpret_cast<unsigned char*>(malloc(size));
+	if (not block)
+	{
+		throw std::bad_alloc();
+	}
+	mBlocks.insert(mBlocks.begin() + mCurrentBlock, std::make_pair(block, size));
+}
+
+} // namespace ely
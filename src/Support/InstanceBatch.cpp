@@ -0,0 +1,338 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/Support/InstanceBatch.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "Support/InstanceBatch.h"
+#include <boundingBox.h>
+#include <cstring>
+#include <cmath>
+
+namespace ely
+{
+
+namespace
+{
+///Initial capacity (in instances) of a cell buffer.
+const int CELL_MIN_CAPACITY = 16;
+
+///The batch shader: instance transform rows are fetched from the buffer.
+const char* INSTANCE_VERTEX_SHADER =
+		"#version 140\n"
+		"uniform mat4 p3d_ModelViewProjectionMatrix;\n"
+		"uniform samplerBuffer instanceTransforms;\n"
+		"in vec4 p3d_Vertex;\n"
+		"in vec4 p3d_Color;\n"
+		"in vec2 p3d_MultiTexCoord0;\n"
+		"out vec4 color;\n"
+		"out vec2 texcoord;\n"
+		"void main() {\n"
+		"  int base = gl_InstanceID * 4;\n"
+		"  vec4 pos = p3d_Vertex.x * texelFetch(instanceTransforms, base)\n"
+		"    + p3d_Vertex.y * texelFetch(instanceTransforms, base + 1)\n"
+		"    + p3d_Vertex.z * texelFetch(instanceTransforms, base + 2)\n"
+		"    + texelFetch(instanceTransforms, base + 3);\n"
+		"  gl_Position = p3d_ModelViewProjectionMatrix * pos;\n"
+		"  color = p3d_Color;\n"
+		"  texcoord = p3d_MultiTexCoord0;\n"
+		"}\n";
+const char* INSTANCE_FRAGMENT_SHADER =
+		"#version 140\n"
+		"uniform sampler2D p3d_Texture0;\n"
+		"uniform vec4 p3d_ColorScale;\n"
+		"in vec4 color;\n"
+		"in vec2 texcoord;\n"
+		"void main() {\n"
+		"  gl_FragColor = texture(p3d_Texture0, texcoord) * color * p3d_ColorScale;\n"
+		"}\n";
+}
+
+InstanceBatch::InstanceBatch(const std::string& name, const NodePath& model,
+		const NodePath& reference, float cellSize) :
+		mName(name), mReference(reference), mNumInstances(0)
+{
+	mRoot = mReference.attach_new_node(name + "_InstanceBatchRoot");
+	setModel(model);
+	mShader = Shader::make(Shader::SL_GLSL, INSTANCE_VERTEX_SHADER,
+			INSTANCE_FRAGMENT_SHADER);
+	mCellSize = (cellSize > 0.0 ? cellSize : 1.0);
+	//counters
+	mStats.mInstances = mStats.mCells = mStats.mMoved = mStats.mCellChanges =
+			0;
+}
+
+InstanceBatch::~InstanceBatch()
+{
+}
+
+int InstanceBatch::addInstance(const NodePath& instanceNP)
+{
+	int handle;
+	if (not mFreeHandles.empty())
+	{
+		handle = mFreeHandles.back();
+		mFreeHandles.pop_back();
+	}
+	else
+	{
+		handle = mInstances.size();
+		mInstances.push_back(Instance());
+	}
+	Instance& instance = mInstances[handle];
+	instance.mNP = instanceNP;
+	instance.mTransform.clear();
+	instance.mCell = instance.mSlot = -1;
+	instance.mValid = true;
+	++mNumInstances;
+	return handle;
+}
+
+void InstanceBatch::removeInstance(int handle)
+{
+	RETURN_ON_COND((handle < 0) or (handle >= (int) mInstances.size())
+			or (not mInstances[handle].mValid),)
+
+	if (mInstances[handle].mCell >= 0)
+	{
+		doRemoveFromCell(handle);
+	}
+	Instance& instance = mInstances[handle];
+	instance.mNP = NodePath();
+	instance.mTransform.clear();
+	instance.mValid = false;
+	mFreeHandles.push_back(handle);
+	--mNumInstances;
+}
+
+void InstanceBatch::setModel(const NodePath& model)
+{
+	//the model copy: transforms are baked into vertices, since the
+	//instance transform is applied by the shader to model coordinates
+	mModel = NodePath(mName + "_Model");
+	model.copy_to(mModel);
+	mModel.flatten_strong();
+	LPoint3f minP, maxP;
+	if (mModel.calc_tight_bounds(minP, maxP))
+	{
+		mModelCenter = (minP + maxP) / 2.0;
+		mModelRadius = (maxP - minP).length() / 2.0;
+	}
+	else
+	{
+		mModelCenter = LPoint3f::zero();
+		mModelRadius = 0.0;
+	}
+	//existing cells draw the new model: their bounds are recomputed
+	for (unsigned int c = 0; c < mCells.size(); ++c)
+	{
+		Cell& cell = mCells[c];
+		cell.mNP.node()->remove_all_children();
+		mModel.instance_to(cell.mNP);
+		cell.mDirty = true;
+	}
+}
+
+void InstanceBatch::update()
+{
+	mStats.mMoved = mStats.mCellChanges = 0;
+	//rewrite moved instances only
+	for (unsigned int h = 0; h < mInstances.size(); ++h)
+	{
+		Instance& instance = mInstances[h];
+		if ((not instance.mValid) or instance.mNP.is_empty())
+		{
+			continue;
+		}
+		CPT(TransformState) transform = instance.mNP.get_transform(mReference);
+		if (instance.mCell >= 0)
+		{
+			//transform states are (mostly) unique: compare pointers first
+			if ((transform == instance.mTransform)
+					or transform->get_mat().almost_equal(
+							instance.mTransform->get_mat()))
+			{
+				instance.mTransform = transform;
+				continue;
+			}
+		}
+		instance.mTransform = transform;
+		int cellIdx = doGetCell(transform->get_pos());
+		if (cellIdx != instance.mCell)
+		{
+			if (instance.mCell >= 0)
+			{
+				doRemoveFromCell(h);
+				++mStats.mCellChanges;
+			}
+			doAddToCell(h, cellIdx);
+		}
+		else
+		{
+			Cell& cell = mCells[cellIdx];
+			doWriteSlot(cell, instance.mSlot);
+			cell.mDirty = true;
+		}
+		++mStats.mMoved;
+	}
+	//update changed cells
+	mStats.mCells = 0;
+	for (unsigned int c = 0; c < mCells.size(); ++c)
+	{
+		if (mCells[c].mDirty)
+		{
+			doUpdateCell(mCells[c]);
+		}
+		if (not mCells[c].mSlots.empty())
+		{
+			++mStats.mCells;
+		}
+	}
+	mStats.mInstances = mNumInstances;
+}
+
+void InstanceBatch::cleanup()
+{
+	mRoot.remove_node();
+	mCells.clear();
+	mCellIndexes.clear();
+	mInstances.clear();
+	mFreeHandles.clear();
+	mNumInstances = 0;
+}
+
+int InstanceBatch::doGetCell(const LPoint3f& pos)
+{
+	std::pair<int, int> key((int) floor(pos.get_x() / mCellSize),
+			(int) floor(pos.get_y() / mCellSize));
+	std::map<std::pair<int, int>, int>::const_iterator iter =
+			mCellIndexes.find(key);
+	if (iter != mCellIndexes.end())
+	{
+		return iter->second;
+	}
+	//create a new (empty) cell
+	int cellIdx = mCells.size();
+	mCells.push_back(Cell());
+	Cell& cell = mCells.back();
+	std::ostringstream cellName;
+	cellName << mName << "_Cell_" << key.first << "_" << key.second;
+	cell.mNP = mRoot.attach_new_node(cellName.str());
+	mModel.instance_to(cell.mNP);
+	//cell bounds are set explicitly
+	cell.mNP.node()->set_final(true);
+	cell.mNP.set_shader(mShader);
+	cell.mBuffer = new Texture(cellName.str() + "_Transforms");
+	cell.mCapacity = 0;
+	cell.mDirty = true;
+	cell.mNP.hide();
+	mCellIndexes[key] = cellIdx;
+	return cellIdx;
+}
+
+void InstanceBatch::doAddToCell(int handle, int cellIdx)
+{
+	Cell& cell = mCells[cellIdx];
+	Instance& instance = mInstances[handle];
+	instance.mCell = cellIdx;
+	instance.mSlot = cell.mSlots.size();
+	cell.mSlots.push_back(handle);
+	cell.mDirty = true;
+	if ((int) cell.mSlots.size() > cell.mCapacity)
+	{
+		//grow the buffer and rewrite all slots
+		cell.mCapacity = max(CELL_MIN_CAPACITY, 2 * cell.mCapacity);
+		cell.mBuffer->setup_buffer_texture(cell.mCapacity * 4, Texture::T_float,
+				Texture::F_rgba32, GeomEnums::UH_dynamic);
+		cell.mNP.set_shader_input("instanceTransforms", cell.mBuffer);
+		for (unsigned int s = 0; s < cell.mSlots.size(); ++s)
+		{
+			doWriteSlot(cell, s);
+		}
+		return;
+	}
+	doWriteSlot(cell, instance.mSlot);
+}
+
+void InstanceBatch::doRemoveFromCell(int handle)
+{
+	Instance& instance = mInstances[handle];
+	Cell& cell = mCells[instance.mCell];
+	//move the last slot into the freed one
+	int lastHandle = cell.mSlots.back();
+	cell.mSlots[instance.mSlot] = lastHandle;
+	mInstances[lastHandle].mSlot = instance.mSlot;
+	cell.mSlots.pop_back();
+	if (instance.mSlot < (int) cell.mSlots.size())
+	{
+		doWriteSlot(cell, instance.mSlot);
+	}
+	cell.mDirty = true;
+	instance.mCell = instance.mSlot = -1;
+}
+
+void InstanceBatch::doWriteSlot(Cell& cell, int slot)
+{
+	const LMatrix4f& mat = mInstances[cell.mSlots[slot]].mTransform->get_mat();
+	PTA_uchar image = cell.mBuffer->modify_ram_image();
+	memcpy(image.p() + slot * 16 * sizeof(float), mat.get_data(),
+			16 * sizeof(float));
+}
+
+void InstanceBatch::doUpdateCell(Cell& cell)
+{
+	cell.mDirty = false;
+	if (cell.mSlots.empty())
+	{
+		cell.mNP.hide();
+		return;
+	}
+	cell.mNP.show();
+	cell.mNP.set_instance_count(cell.mSlots.size());
+	//bounds enclosing the bounding spheres of all instances
+	LPoint3f minP, maxP;
+	for (unsigned int s = 0; s < cell.mSlots.size(); ++s)
+	{
+		const TransformState* transform =
+				mInstances[cell.mSlots[s]].mTransform;
+		LPoint3f center = transform->get_mat().xform_point(mModelCenter);
+		LVecBase3f scale = transform->get_scale();
+		float radius = mModelRadius
+				* max(max(fabs(scale[0]), fabs(scale[1])), fabs(scale[2]));
+		LVector3f extent(radius, radius, radius);
+		if (s == 0)
+		{
+			minP = center - extent;
+			maxP = center + extent;
+			continue;
+		}
+		for (int i = 0; i < 3; ++i)
+		{
+			minP[i] = min(minP[i], center[i] - radius);
+			maxP[i] = max(maxP[i], center[i] + radius);
+		}
+	}
+	cell.mNP.node()->set_bounds(new BoundingBox(minP, maxP));
+}
+
+//TypedObject semantics: hardcoded
+TypeHandle InstanceBatch::_type_handle;
+
+} // namespace ely
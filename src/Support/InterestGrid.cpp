@@ -0,0 +1,326 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/Support/InterestGrid.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "Support/InterestGrid.h"
+#include "ObjectModel/ObjectTemplateManager.h"
+#include <asyncTaskManager.h>
+#include <cmath>
+
+namespace ely
+{
+
+InterestGrid::InterestGrid(float cellSize, unsigned int numBuckets, int sort,
+		int priority) :
+		mCellSize(cellSize > 0.0 ? cellSize : 20.0)
+{
+	//buckets: a power of 2
+	unsigned int buckets = 1;
+	while (buckets < numBuckets)
+	{
+		buckets <<= 1;
+	}
+	mBuckets.resize(buckets);
+	mBucketMask = buckets - 1;
+	mStats.mObjects = mStats.mCellChanges = 0;
+	mStats.mQueries = mStats.mVisited = mStats.mFound = 0;
+	//track the already created objects
+	ObjectTemplateManager* objectTmplMgr =
+			ObjectTemplateManager::GetSingletonPtr();
+	if (objectTmplMgr)
+	{
+		std::list<SMARTPTR(Object)> objects = objectTmplMgr->getCreatedObjects();
+		std::list<SMARTPTR(Object)>::const_iterator iter;
+		for (iter = objects.begin(); iter != objects.end(); ++iter)
+		{
+			addObject(*iter);
+		}
+	}
+	//create the task for refreshing the grid
+	mUpdateData = new TaskInterface<InterestGrid>::TaskData(this,
+			&InterestGrid::update);
+	mUpdateTask = new GenericAsyncTask("InterestGrid::update",
+			&TaskInterface<InterestGrid>::taskFunction,
+			reinterpret_cast<void*>(mUpdateData.p()));
+	//set sort/priority
+	mUpdateTask->set_sort(sort);
+	mUpdateTask->set_priority(priority);
+	//Adds mUpdateTask to the active queue.
+	AsyncTaskManager::get_global_ptr()->add(mUpdateTask);
+}
+
+InterestGrid::~InterestGrid()
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	if (mUpdateTask)
+	{
+		AsyncTaskManager::get_global_ptr()->remove(mUpdateTask);
+	}
+	mBuckets.clear();
+	mEntryIds.clear();
+	mFreeEntries.clear();
+	mEntries.clear();
+}
+
+void InterestGrid::addObject(SMARTPTR(Object) object)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	RETURN_ON_COND(not object,)
+	RETURN_ON_COND(mEntryIds.find(object->objectId()) != mEntryIds.end(),)
+
+	unsigned int entryIdx;
+	if (not mFreeEntries.empty())
+	{
+		entryIdx = mFreeEntries.back();
+		mFreeEntries.pop_back();
+	}
+	else
+	{
+		entryIdx = mEntries.size();
+		mEntries.push_back(Entry());
+	}
+	Entry& entry = mEntries[entryIdx];
+	entry.mObjectId = object->objectId();
+	entry.mObject = object;
+	entry.mPos = LPoint3f::zero();
+	entry.mCellX = entry.mCellY = 0;
+	entry.mPlaced = false;
+	entry.mBucket = entry.mBucketIndex = 0;
+	mEntryIds[entry.mObjectId] = entryIdx;
+	doPlace(entryIdx);
+	++mStats.mObjects;
+}
+
+void InterestGrid::removeObject(const ObjectId& objectId)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	std::map<ObjectId, unsigned int>::iterator iter = mEntryIds.find(objectId);
+	RETURN_ON_COND(iter == mEntryIds.end(),)
+
+	unsigned int entryIdx = iter->second;
+	doUnplace(entryIdx);
+	mEntries[entryIdx].mObject.clear();
+	mEntries[entryIdx].mObjectId = ObjectId();
+	mFreeEntries.push_back(entryIdx);
+	mEntryIds.erase(iter);
+	--mStats.mObjects;
+}
+
+void InterestGrid::updateObject(const ObjectId& objectId)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	std::map<ObjectId, unsigned int>::const_iterator iter = mEntryIds.find(
+			objectId);
+	RETURN_ON_COND(iter == mEntryIds.end(),)
+
+	doPlace(iter->second);
+}
+
+void InterestGrid::refresh()
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	mStats.mCellChanges = 0;
+	std::map<ObjectId, unsigned int>::const_iterator iter;
+	for (iter = mEntryIds.begin(); iter != mEntryIds.end(); ++iter)
+	{
+		if (doPlace(iter->second))
+		{
+			++mStats.mCellChanges;
+		}
+	}
+}
+
+bool InterestGrid::getPosition(const ObjectId& objectId, LPoint3f& pos)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	std::map<ObjectId, unsigned int>::const_iterator iter = mEntryIds.find(
+			objectId);
+	RETURN_ON_COND(iter == mEntryIds.end(), false)
+	RETURN_ON_COND(not mEntries[iter->second].mPlaced, false)
+
+	pos = mEntries[iter->second].mPos;
+	return true;
+}
+
+void InterestGrid::queryRadius(const LPoint3f& center, float radius,
+		std::vector<ObjectId>& result)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	doQueryRadius(center, radius, ObjectId(), result);
+}
+
+bool InterestGrid::queryNear(const ObjectId& objectId, float radius,
+		std::vector<ObjectId>& result)
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	std::map<ObjectId, unsigned int>::const_iterator iter = mEntryIds.find(
+			objectId);
+	RETURN_ON_COND(iter == mEntryIds.end(), false)
+	RETURN_ON_COND(not mEntries[iter->second].mPlaced, false)
+
+	LPoint3f center = mEntries[iter->second].mPos;
+	doQueryRadius(center, radius, objectId, result);
+	return true;
+}
+
+AsyncTask::DoneStatus InterestGrid::update(GenericAsyncTask* task)
+{
+	refresh();
+	//
+	return AsyncTask::DS_cont;
+}
+
+InterestGrid::InterestGridStats InterestGrid::getStats()
+{
+	//lock (guard) the mutex
+	HOLD_REMUTEX(mMutex)
+
+	return mStats;
+}
+
+int InterestGrid::doGetCell(float coord) const
+{
+	return static_cast<int>(floor(coord / mCellSize));
+}
+
+bool InterestGrid::doPlace(unsigned int entryIdx)
+{
+	Entry& entry = mEntries[entryIdx];
+	NodePath nodePath = entry.mObject->getNodePath();
+	if (nodePath.is_empty())
+	{
+		//not placeable (yet)
+		doUnplace(entryIdx);
+		return false;
+	}
+	entry.mPos = nodePath.get_pos(nodePath.get_top());
+	int cellX = doGetCell(entry.mPos.get_x());
+	int cellY = doGetCell(entry.mPos.get_y());
+	RETURN_ON_COND(
+			entry.mPlaced and (cellX == entry.mCellX) and (cellY == entry.mCellY),
+			false)
+
+	//move to the new cell's bucket
+	doUnplace(entryIdx);
+	entry.mCellX = cellX;
+	entry.mCellY = cellY;
+	entry.mBucket = doGetBucket(cellX, cellY);
+	entry.mBucketIndex = mBuckets[entry.mBucket].size();
+	mBuckets[entry.mBucket].push_back(entryIdx);
+	entry.mPlaced = true;
+	return true;
+}
+
+void InterestGrid::doUnplace(unsigned int entryIdx)
+{
+	Entry& entry = mEntries[entryIdx];
+	RETURN_ON_COND(not entry.mPlaced,)
+
+	//swap with the last of the bucket and pop
+	std::vector<unsigned int>& bucket = mBuckets[entry.mBucket];
+	unsigned int lastIdx = bucket.back();
+	bucket[entry.mBucketIndex] = lastIdx;
+	mEntries[lastIdx].mBucketIndex = entry.mBucketIndex;
+	bucket.pop_back();
+	entry.mPlaced = false;
+}
+
+void InterestGrid::doQueryRadius(const LPoint3f& center, float radius,
+		const ObjectId& excluded, std::vector<ObjectId>& result)
+{
+	++mStats.mQueries;
+	RETURN_ON_COND(radius < 0.0,)
+
+	float radiusSquared = radius * radius;
+	int minX = doGetCell(center.get_x() - radius);
+	int maxX = doGetCell(center.get_x() + radius);
+	int minY = doGetCell(center.get_y() - radius);
+	int maxY = doGetCell(center.get_y() + radius);
+	double numCells = (static_cast<double>(maxX) - minX + 1)
+			* (static_cast<double>(maxY) - minY + 1);
+	if (numCells > static_cast<double>(mBuckets.size()))
+	{
+		//a huge circle: visit the entries once instead of its cells
+		std::map<ObjectId, unsigned int>::const_iterator iter;
+		for (iter = mEntryIds.begin(); iter != mEntryIds.end(); ++iter)
+		{
+			const Entry& entry = mEntries[iter->second];
+			++mStats.mVisited;
+			if (entry.mPlaced and (entry.mObjectId != excluded))
+			{
+				LVector2f delta(entry.mPos.get_x() - center.get_x(),
+						entry.mPos.get_y() - center.get_y());
+				if (delta.length_squared() <= radiusSquared)
+				{
+					result.push_back(entry.mObjectId);
+					++mStats.mFound;
+				}
+			}
+		}
+		return;
+	}
+	for (int cellX = minX; cellX <= maxX; ++cellX)
+	{
+		for (int cellY = minY; cellY <= maxY; ++cellY)
+		{
+			const std::vector<unsigned int>& bucket = mBuckets[doGetBucket(
+					cellX, cellY)];
+			std::vector<unsigned int>::const_iterator iter;
+			for (iter = bucket.begin(); iter != bucket.end(); ++iter)
+			{
+				const Entry& entry = mEntries[*iter];
+				++mStats.mVisited;
+				//skip the other cells hashed into this bucket
+				if ((entry.mCellX != cellX) or (entry.mCellY != cellY)
+						or (entry.mObjectId == excluded))
+				{
+					continue;
+				}
+				LVector2f delta(entry.mPos.get_x() - center.get_x(),
+						entry.mPos.get_y() - center.get_y());
+				if (delta.length_squared() <= radiusSquared)
+				{
+					result.push_back(entry.mObjectId);
+					++mStats.mFound;
+				}
+			}
+		}
+	}
+}
+
+} // namespace ely
@@ -0,0 +1,159 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/Support/Lockstep.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "Support/Lockstep.h"
+#include "ObjectModel/Object.h"
+#include "ObjectModel/ObjectTemplateManager.h"
+#include <asyncTaskManager.h>
+#include <cstdlib>
+
+namespace ely
+{
+
+Lockstep::Lockstep(float tickDt, unsigned int seed, unsigned int numChecksums,
+		int sort, int priority) :
+		mTickDt(tickDt > 0.0 ? tickDt : 1.0 / 60.0), mSeed(seed), mTick(0)
+{
+	Checksum none;
+	none.mTick = 0;
+	none.mValue = 0;
+	mChecksums.resize(numChecksums, none);
+	//random draws before the first tick (e.g. at world creation)
+	srand(mSeed);
+	//create the task for ending the ticks
+	mEndTickData = new TaskInterface<Lockstep>::TaskData(this,
+			&Lockstep::endTick);
+	mEndTickTask = new GenericAsyncTask("Lockstep::endTick",
+			&TaskInterface<Lockstep>::taskFunction,
+			reinterpret_cast<void*>(mEndTickData.p()));
+	//set sort/priority
+	mEndTickTask->set_sort(sort);
+	mEndTickTask->set_priority(priority);
+	//Adds mEndTickTask to the active queue.
+	AsyncTaskManager::get_global_ptr()->add(mEndTickTask);
+}
+
+Lockstep::~Lockstep()
+{
+	if (mEndTickTask)
+	{
+		AsyncTaskManager::get_global_ptr()->remove(mEndTickTask);
+	}
+}
+
+bool Lockstep::componentLess(const SMARTPTR(Component)& first,
+		const SMARTPTR(Component)& second)
+{
+	SMARTPTR(Object) firstOwner = first->getOwnerObject();
+	SMARTPTR(Object) secondOwner = second->getOwnerObject();
+	//components without owner go last
+	RETURN_ON_COND(not secondOwner, (bool) firstOwner)
+	RETURN_ON_COND(not firstOwner, false)
+
+	ObjectId firstId = firstOwner->objectId();
+	ObjectId secondId = secondOwner->objectId();
+	RETURN_ON_COND(firstId != secondId, firstId < secondId)
+
+	return first->componentType() < second->componentType();
+}
+
+void Lockstep::seedRandom(const std::string& key)
+{
+	Lockstep* lockstep = GetSingletonPtr();
+	RETURN_ON_COND(not lockstep,)
+
+	unsigned int seed = hash64(lockstep->mSeed);
+	seed = hash64(lockstep->mTick, seed);
+	seed = hash(key.data(), key.size(), seed);
+	srand(seed);
+}
+
+unsigned int Lockstep::computeChecksum() const
+{
+	unsigned int checksum = hash64(mTick);
+	//created objects are listed in id order
+	std::list<SMARTPTR(Object)> objects =
+			ObjectTemplateManager::GetSingletonPtr()->getCreatedObjects();
+	std::list<SMARTPTR(Object)>::const_iterator iter;
+	for (iter = objects.begin(); iter != objects.end(); ++iter)
+	{
+		ObjectId objectId = (*iter)->objectId();
+		checksum = hash(objectId.data(), objectId.size(), checksum);
+		NodePath nodePath = (*iter)->getNodePath();
+		if (nodePath.is_empty())
+		{
+			continue;
+		}
+		LMatrix4f mat = nodePath.get_mat();
+		checksum = hash(mat.get_data(), mat.get_num_components() * sizeof(float),
+				checksum);
+	}
+	return checksum;
+}
+
+bool Lockstep::getChecksum(unsigned long int tick, unsigned int& checksum) const
+{
+	RETURN_ON_COND(mChecksums.empty(), false)
+
+	const Checksum& entry = mChecksums[tick % mChecksums.size()];
+	RETURN_ON_COND((entry.mTick != tick) or (tick >= mTick), false)
+
+	checksum = entry.mValue;
+	return true;
+}
+
+AsyncTask::DoneStatus Lockstep::endTick(GenericAsyncTask* task)
+{
+	if (not mChecksums.empty())
+	{
+		Checksum& entry = mChecksums[mTick % mChecksums.size()];
+		entry.mTick = mTick;
+		entry.mValue = computeChecksum();
+	}
+	++mTick;
+	//
+	return AsyncTask::DS_cont;
+}
+
+unsigned int Lockstep::hash(const void* data, unsigned int size,
+		unsigned int hash)
+{
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		hash = (hash ^ bytes[i]) * 16777619U;
+	}
+	return hash;
+}
+
+unsigned int Lockstep::hash64(PN_uint64 value, unsigned int hash)
+{
+	unsigned char bytes[8];
+	for (unsigned int i = 0; i < sizeof(bytes); ++i)
+	{
+		bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+	}
+	return Lockstep::hash(bytes, sizeof(bytes), hash);
+}
+
+} // namespace ely
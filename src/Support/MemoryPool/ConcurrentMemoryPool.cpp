@@ -0,0 +1,360 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/Support/MemoryPool/ConcurrentMemoryPool.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "Support/MemoryPool/ConcurrentMemoryPool.h"
+#include <mutexHolder.h>
+#include <pthread.h>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+///The current thread's caches (one per pool slot).
+__thread void* tCaches = NULL;
+///Releases the caches at thread exit.
+pthread_key_t sCachesKey;
+pthread_once_t sCachesKeyOnce = PTHREAD_ONCE_INIT;
+///The pools by slot.
+ely::ConcurrentMemoryPool* sPools[ely::ConcurrentMemoryPool::MAX_POOLS];
+
+Mutex& slotsMutex()
+{
+	static Mutex* mutex = new Mutex("ConcurrentMemoryPool::slots");
+	return *mutex;
+}
+}
+
+namespace ely
+{
+
+ConcurrentMemoryPool::ConcurrentMemoryPool() :
+		mChunkSize(0), mCacheSize(0), mAutoTrim(false), mSlot(-1)
+{
+	mStats.mChunkSize = mStats.mBlocks = 0;
+	mStats.mHits = mStats.mMisses = mStats.mOutstanding = mStats.mHighWater =
+			mStats.mTrimmed = mStats.mInvalid = 0;
+	//get a thread cache slot
+	MutexHolder guard(slotsMutex());
+	for (unsigned int i = 0; i < MAX_POOLS; ++i)
+	{
+		if (not sPools[i])
+		{
+			sPools[i] = this;
+			mSlot = i;
+			break;
+		}
+	}
+	GCC_ASSERT(mSlot >= 0);
+}
+
+ConcurrentMemoryPool::~ConcurrentMemoryPool()
+{
+	MutexHolder guard(slotsMutex());
+	if (mSlot >= 0)
+	{
+		sPools[mSlot] = NULL;
+		//the chunks cached by this thread go with the depot: don't let a
+		//later pool in the same slot use them (the other threads' caches
+		//should be already released)
+		ThreadCache* caches = reinterpret_cast<ThreadCache*>(tCaches);
+		if (caches)
+		{
+			caches[mSlot].mHead = NULL;
+			caches[mSlot].mCount = 0;
+			caches[mSlot].mHits = 0;
+		}
+	}
+}
+
+bool ConcurrentMemoryPool::init(unsigned int chunkSize, unsigned int numChunks,
+		unsigned int cacheSize)
+{
+	MutexHolder guard(mMutex);
+
+	//a free chunk holds the link to the next one
+	mChunkSize = chunkSize < sizeof(void*) ? sizeof(void*) : chunkSize;
+	mCacheSize = cacheSize < 2 ? 2 : cacheSize;
+	mStats.mChunkSize = mChunkSize;
+	return mDepot.Init(mChunkSize, numChunks);
+}
+
+void* ConcurrentMemoryPool::alloc()
+{
+	RETURN_ON_COND(mSlot < 0, NULL)
+
+	ThreadCache& cache = doGetCache();
+	if (cache.mHead)
+	{
+		++cache.mHits;
+	}
+	else
+	{
+		doRefill(cache);
+		RETURN_ON_COND(not cache.mHead, NULL)
+	}
+	//pop the head
+	void* pMem = cache.mHead;
+	cache.mHead = *reinterpret_cast<void**>(pMem);
+	--cache.mCount;
+	return pMem;
+}
+
+void ConcurrentMemoryPool::free(void* pMem)
+{
+	RETURN_ON_COND((not pMem) or (mSlot < 0),)
+
+	ThreadCache& cache = doGetCache();
+	//push on the head
+	*reinterpret_cast<void**>(pMem) = cache.mHead;
+	cache.mHead = pMem;
+	++cache.mCount;
+	if (cache.mCount > mCacheSize)
+	{
+		//give half the cache back
+		doDrain(cache, cache.mCount - mCacheSize / 2);
+	}
+}
+
+unsigned int ConcurrentMemoryPool::trim()
+{
+	MutexHolder guard(mMutex);
+
+	unsigned int trimmed = mDepot.Trim();
+	mStats.mTrimmed += trimmed;
+	mStats.mBlocks = mDepot.GetNumBlocks();
+	return trimmed;
+}
+
+void ConcurrentMemoryPool::setAutoTrim(bool enable)
+{
+	MutexHolder guard(mMutex);
+
+	mAutoTrim = enable;
+}
+
+MemoryPoolStats ConcurrentMemoryPool::getStats()
+{
+	MutexHolder guard(mMutex);
+
+	return mStats;
+}
+
+ConcurrentMemoryPool::ThreadCache& ConcurrentMemoryPool::doGetCache()
+{
+	ThreadCache* caches = reinterpret_cast<ThreadCache*>(tCaches);
+	if (not caches)
+	{
+		//first use by this thread
+		caches = reinterpret_cast<ThreadCache*>(calloc(MAX_POOLS,
+				sizeof(ThreadCache)));
+		if (not caches)
+		{
+			throw std::bad_alloc();
+		}
+		tCaches = caches;
+		pthread_once(&sCachesKeyOnce, &doCreateCachesKey);
+		pthread_setspecific(sCachesKey, caches);
+	}
+	return caches[mSlot];
+}
+
+void ConcurrentMemoryPool::doRefill(ThreadCache& cache)
+{
+	MutexHolder guard(mMutex);
+
+	mStats.mHits += cache.mHits;
+	cache.mHits = 0;
+	++mStats.mMisses;
+	//take a batch of chunks
+	unsigned int batch = mCacheSize / 2;
+	for (unsigned int i = 0; i < batch; ++i)
+	{
+		void* pMem = mDepot.Alloc();
+		if (not pMem)
+		{
+			break;
+		}
+		*reinterpret_cast<void**>(pMem) = cache.mHead;
+		cache.mHead = pMem;
+		++cache.mCount;
+		++mStats.mOutstanding;
+	}
+	if (mStats.mOutstanding > mStats.mHighWater)
+	{
+		mStats.mHighWater = mStats.mOutstanding;
+	}
+	mStats.mBlocks = mDepot.GetNumBlocks();
+}
+
+void ConcurrentMemoryPool::doDrain(ThreadCache& cache, unsigned int num)
+{
+	MutexHolder guard(mMutex);
+
+	mStats.mHits += cache.mHits;
+	cache.mHits = 0;
+	for (unsigned int i = 0; (i < num) and cache.mHead; ++i)
+	{
+		void* pMem = cache.mHead;
+		cache.mHead = *reinterpret_cast<void**>(pMem);
+		--cache.mCount;
+		if (mDepot.Free(pMem))
+		{
+			--mStats.mOutstanding;
+		}
+		else
+		{
+			++mStats.mInvalid;
+		}
+	}
+	//trim only when the depot holds more than two free blocks' chunks
+	if (mAutoTrim
+			and (mDepot.GetNumBlocks() * mDepot.GetNumChunksPerBlock()
+					> mStats.mOutstanding + 2 * mDepot.GetNumChunksPerBlock()))
+	{
+		mStats.mTrimmed += mDepot.Trim();
+	}
+	mStats.mBlocks = mDepot.GetNumBlocks();
+}
+
+void ConcurrentMemoryPool::doCreateCachesKey()
+{
+	pthread_key_create(&sCachesKey, &doReleaseThreadCaches);
+}
+
+void ConcurrentMemoryPool::doReleaseThreadCaches(void* caches)
+{
+	ThreadCache* threadCaches = reinterpret_cast<ThreadCache*>(caches);
+	{
+		MutexHolder guard(slotsMutex());
+		for (unsigned int i = 0; i < MAX_POOLS; ++i)
+		{
+			if (sPools[i] and (threadCaches[i].mCount > 0))
+			{
+				sPools[i]->doDrain(threadCaches[i], threadCaches[i].mCount);
+			}
+		}
+	}
+	tCaches = NULL;
+	::free(threadCaches);
+}
+
+///SizeClassPools
+
+namespace
+{
+///The size classes.
+const unsigned int SIZE_CLASSES[] =
+{ 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096 };
+const unsigned int NUM_SIZE_CLASSES = sizeof(SIZE_CLASSES)
+		/ sizeof(SIZE_CLASSES[0]);
+}
+
+void* SizeClassPools::alloc(size_t size)
+{
+	ConcurrentMemoryPool* pool = doGetPool(size);
+	RETURN_ON_COND(not pool, ::operator new(size))
+
+	void* pMem = pool->alloc();
+	if (not pMem)
+	{
+		throw std::bad_alloc();
+	}
+	return pMem;
+}
+
+void SizeClassPools::free(void* pMem, size_t size)
+{
+	ConcurrentMemoryPool* pool = doGetPool(size);
+	if (pool)
+	{
+		pool->free(pMem);
+	}
+	else
+	{
+		::operator delete(pMem);
+	}
+}
+
+unsigned int SizeClassPools::getNumSizeClasses()
+{
+	return NUM_SIZE_CLASSES;
+}
+
+MemoryPoolStats SizeClassPools::getStats(unsigned int sizeClass)
+{
+	RETURN_ON_COND(sizeClass >= NUM_SIZE_CLASSES, MemoryPoolStats())
+
+	return doGetPools()[sizeClass].getStats();
+}
+
+unsigned int SizeClassPools::trim()
+{
+	unsigned int trimmed = 0;
+	for (unsigned int i = 0; i < NUM_SIZE_CLASSES; ++i)
+	{
+		trimmed += doGetPools()[i].trim();
+	}
+	return trimmed;
+}
+
+void SizeClassPools::setAutoTrim(bool enable)
+{
+	for (unsigned int i = 0; i < NUM_SIZE_CLASSES; ++i)
+	{
+		doGetPools()[i].setAutoTrim(enable);
+	}
+}
+
+ConcurrentMemoryPool* SizeClassPools::doGetPool(size_t size)
+{
+	for (unsigned int i = 0; i < NUM_SIZE_CLASSES; ++i)
+	{
+		if (size <= SIZE_CLASSES[i])
+		{
+			return &doGetPools()[i];
+		}
+	}
+	return NULL;
+}
+
+ConcurrentMemoryPool* SizeClassPools::doGetPools()
+{
+	//created (thread-safely) on first use and never destroyed: objects can
+	//be freed during static destruction
+	static ConcurrentMemoryPool* pools = doCreatePools();
+	return pools;
+}
+
+ConcurrentMemoryPool* SizeClassPools::doCreatePools()
+{
+	ConcurrentMemoryPool* pools = new ConcurrentMemoryPool[NUM_SIZE_CLASSES];
+	for (unsigned int i = 0; i < NUM_SIZE_CLASSES; ++i)
+	{
+		//~64KB blocks and ~8KB thread caches
+		unsigned int size = SIZE_CLASSES[i];
+		pools[i].init(size, 65536 / size, 8192 / size);
+	}
+	return pools;
+}
+
+} // namespace ely
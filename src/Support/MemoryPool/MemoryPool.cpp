@@ -97,6 +97,7 @@ void MemoryPool::Destroy(void)
 		free(m_ppRawMemoryArray[i]);
 	}
 	free(m_ppRawMemoryArray);
+	free(m_pFreeCounts);
 
 	// update member variables
 	Reset();
@@ -126,31 +127,101 @@ void* MemoryPool::Alloc(void)
 	// grab the first chunk from the list and move to the next chunks
 	unsigned char* pRet = m_pHead;
 	m_pHead = GetNext(m_pHead);
+	--m_pFreeCounts[FindBlock(pRet)];
 	return (pRet + CHUNK_HEADER_SIZE);  // make sure we return a pointer to the data section only
 }
 
-void MemoryPool::Free(void* pMem)
+bool MemoryPool::Free(void* pMem)
 {
-	if (pMem != NULL)  	// calling Free() on a NULL pointer is perfectly valid
+	if (pMem == NULL)  	// calling Free() on a NULL pointer is perfectly valid
+		return true;
+
+	// The pointer we get back is just to the data section of the chunk.  This gets us the full chunk.
+	unsigned char* pBlock = ((unsigned char*)pMem) - CHUNK_HEADER_SIZE;
+
+	// linking a foreign chunk would corrupt the pool: refuse it
+	int block = FindBlock(pBlock);
+	if (block < 0)
 	{
-		// The pointer we get back is just to the data section of the chunk.  This gets us the full chunk.
-		unsigned char* pBlock = ((unsigned char*)pMem) - CHUNK_HEADER_SIZE;
-		
-		// push the chunk to the front of the list
-		SetNext(pBlock, m_pHead);
-		m_pHead = pBlock;
-		
+		GCC_ERROR("Freeing a chunk not belonging to the memory pool [" + std::string(GetDebugName()) + "]: ignored");
+		return false;
+	}
+
+	// push the chunk to the front of the list
+	SetNext(pBlock, m_pHead);
+	m_pHead = pBlock;
+	++m_pFreeCounts[block];
+
 #ifdef ELY_DEBUG
-        // update allocation reports
-        --m_numAllocs;
-        GCC_ASSERT(m_numAllocs >= 0);
+	// update allocation reports
+	--m_numAllocs;
+	GCC_ASSERT(m_numAllocs >= 0);
 #endif
+	return true;
+}
+
+unsigned int MemoryPool::GetNumFreeBlocks(void) const
+{
+	unsigned int numFreeBlocks = 0;
+	for (unsigned int i = 0; i < m_memArraySize; ++i)
+	{
+		if (m_pFreeCounts[i] == m_numChunks)
+			++numFreeBlocks;
 	}
+	return numFreeBlocks;
+}
+
+unsigned int MemoryPool::Trim(void)
+{
+	// the free counts are kept by Alloc()/Free(): nothing to walk unless
+	// some block is totally free
+	if (GetNumFreeBlocks() == 0)
+		return 0;
+
+	// unlink the chunks of the totally free blocks (keeping the list order)
+	unsigned char* pNewHead = NULL;
+	unsigned char* pTail = NULL;
+	unsigned char* pCurr = m_pHead;
+	while (pCurr)
+	{
+		unsigned char* pNext = GetNext(pCurr);
+		if (m_pFreeCounts[FindBlock(pCurr)] != m_numChunks)
+		{
+			if (pTail)
+				SetNext(pTail, pCurr);
+			else
+				pNewHead = pCurr;
+			pTail = pCurr;
+		}
+		pCurr = pNext;
+	}
+	if (pTail)
+		SetNext(pTail, NULL);
+	m_pHead = pNewHead;
+
+	// free those blocks and compact the memory array (still sorted)
+	unsigned int numTrimmed = 0, j = 0;
+	for (unsigned int i = 0; i < m_memArraySize; ++i)
+	{
+		if (m_pFreeCounts[i] == m_numChunks)
+		{
+			free(m_ppRawMemoryArray[i]);
+			++numTrimmed;
+		}
+		else
+		{
+			m_ppRawMemoryArray[j] = m_ppRawMemoryArray[i];
+			m_pFreeCounts[j++] = m_pFreeCounts[i];
+		}
+	}
+	m_memArraySize = j;
+	return numTrimmed;
 }
 
 void MemoryPool::Reset(void)
 {
 	m_ppRawMemoryArray = NULL;
+	m_pFreeCounts = NULL;
 	m_pHead = NULL;
 	m_chunkSize = 0;
 	m_numChunks = 0;
@@ -169,22 +240,36 @@ bool MemoryPool::GrowMemoryArray(void)
     ely::OutputDebugStringA(str.c_str());  // the logger is not initialized during many of the initial memory pool growths, so let's just use the OS version
 #endif
 
-	// allocate a new array
+	// allocate a new array, its free counts and a new block of memory
 	size_t allocationSize = sizeof(unsigned char*) * (m_memArraySize + 1);
 	unsigned char** ppNewMemArray = (unsigned char**)malloc(allocationSize);
+	unsigned int* pNewFreeCounts = (unsigned int*)malloc(sizeof(unsigned int) * (m_memArraySize + 1));
+	unsigned char* pNewBlock = AllocateNewMemoryBlock();
 	
-	// make sure the allocation succeeded
-	if (!ppNewMemArray)
+	// make sure the allocations succeeded
+	if (!ppNewMemArray || !pNewFreeCounts || !pNewBlock)
+	{
+		free(ppNewMemArray);
+		free(pNewFreeCounts);
+		free(pNewBlock);
 		return false;
+	}
 	
-	// copy any existing memory pointers over
-	for (unsigned int i = 0; i < m_memArraySize; ++i)
+	// copy any existing memory pointers over, inserting the new block so
+	// that the array stays sorted by address (see FindBlock())
+	unsigned int i = 0, j = 0;
+	for (; (i < m_memArraySize) && (m_ppRawMemoryArray[i] < pNewBlock); ++i, ++j)
 	{
-		ppNewMemArray[i] = m_ppRawMemoryArray[i];
+		ppNewMemArray[j] = m_ppRawMemoryArray[i];
+		pNewFreeCounts[j] = m_pFreeCounts[i];
+	}
+	ppNewMemArray[j] = pNewBlock;
+	pNewFreeCounts[j++] = m_numChunks;
+	for (; i < m_memArraySize; ++i, ++j)
+	{
+		ppNewMemArray[j] = m_ppRawMemoryArray[i];
+		pNewFreeCounts[j] = m_pFreeCounts[i];
 	}
-	
-	// allocate a new block of memory
-	ppNewMemArray[m_memArraySize] = AllocateNewMemoryBlock();  // indexing m_memArraySize here is safe because we haven't incremented it yet to reflect the new size	
 	
 	// attach the block to the end of the current memory list
 	if (m_pHead)
@@ -196,19 +281,20 @@ bool MemoryPool::GrowMemoryArray(void)
 			pCurr = pNext;
 			pNext = GetNext(pNext);
 		}
-		SetNext(pCurr, ppNewMemArray[m_memArraySize]);
+		SetNext(pCurr, pNewBlock);
 	}
 	else
 	{
-		m_pHead = ppNewMemArray[m_memArraySize];
+		m_pHead = pNewBlock;
 	}
 	
-	// destroy the old memory array
-	if (m_ppRawMemoryArray)
-		free(m_ppRawMemoryArray);
+	// destroy the old arrays
+	free(m_ppRawMemoryArray);
+	free(m_pFreeCounts);
 	
-	// assign the new memory array and increment the size count
+	// assign the new arrays and increment the size count
 	m_ppRawMemoryArray = ppNewMemArray;
+	m_pFreeCounts = pNewFreeCounts;
 	++m_memArraySize;
 	
 	return true;
@@ -244,6 +330,26 @@ unsigned char* MemoryPool::AllocateNewMemoryBlock(void)
 	return pNewMem;
 }
 
+int MemoryPool::FindBlock(unsigned char* pChunk) const
+{
+	size_t blockSize = m_chunkSize + CHUNK_HEADER_SIZE;
+	size_t trueSize = blockSize * m_numChunks;
+	// binary search: the blocks are sorted by address
+	unsigned int low = 0, high = m_memArraySize;
+	while (low < high)
+	{
+		unsigned int mid = (low + high) / 2;
+		if (pChunk < m_ppRawMemoryArray[mid])
+			high = mid;
+		else if (pChunk >= m_ppRawMemoryArray[mid] + trueSize)
+			low = mid + 1;
+		else
+			// inside the block: it must be the start of a chunk
+			return ((pChunk - m_ppRawMemoryArray[mid]) % blockSize == 0) ? (int)mid : -1;
+	}
+	return -1;
+}
+
 unsigned char* MemoryPool::GetNext(unsigned char* pBlock)
 {
 	unsigned char** ppChunkHeader = (unsigned char**)pBlock;
@@ -0,0 +1,137 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/Support/ModelLoader.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "Support/ModelLoader.h"
+#include <asyncTaskManager.h>
+#include <loader.h>
+#include <loaderOptions.h>
+#include <modelPool.h>
+#include <config_util.h>
+#include <mutexHolder.h>
+
+namespace ely
+{
+
+ModelLoader::ModelLoader(const std::string& name, int numThreads) :
+		mName(name), mCacheHits(0), mCacheMisses(0)
+{
+	//loader threads
+	mTaskChainName = name + "-loaderChain";
+	AsyncTaskChain* taskChain =
+			AsyncTaskManager::get_global_ptr()->make_task_chain(
+					mTaskChainName);
+	taskChain->set_num_threads(numThreads > 0 ? numThreads : 1);
+	taskChain->set_frame_sync(false);
+}
+
+ModelLoader::~ModelLoader()
+{
+}
+
+NodePath ModelLoader::loadModel(const Filename& fileName)
+{
+	//the loader keeps the parsed model into the ModelPool (by resolved
+	//name) and returns a copy of it; the pool is thread safe: concurrent
+	//misses of the same file are possible but harmless
+	Filename pathName(fileName);
+	pathName.resolve_filename(get_model_path().get_value());
+	bool cached = ModelPool::has_model(pathName);
+	LoaderOptions options(
+			LoaderOptions::LF_search | LoaderOptions::LF_report_errors);
+	PT(PandaNode) model = Loader::get_global_ptr()->load_sync(fileName,
+			options);
+	RETURN_ON_COND(not model, NodePath())
+
+	MutexHolder guard(mCacheMutex);
+	if (cached)
+	{
+		++mCacheHits;
+	}
+	else
+	{
+		mFiles.insert(pathName.get_fullpath());
+		++mCacheMisses;
+	}
+	return NodePath(model);
+}
+
+void ModelLoader::dispatch(AsyncTask* task)
+{
+	task->set_task_chain(mTaskChainName);
+	AsyncTaskManager::get_global_ptr()->add(task);
+}
+
+void ModelLoader::cleanup()
+{
+	AsyncTaskChain* taskChain =
+			AsyncTaskManager::get_global_ptr()->find_task_chain(mTaskChainName);
+	if (taskChain)
+	{
+		taskChain->wait_for_tasks();
+		AsyncTaskManager::get_global_ptr()->remove_task_chain(mTaskChainName);
+	}
+	clearCache();
+}
+
+void ModelLoader::clearCache()
+{
+	MutexHolder guard(mCacheMutex);
+	std::set<std::string>::const_iterator iter;
+	for (iter = mFiles.begin(); iter != mFiles.end(); ++iter)
+	{
+		ModelPool::release_model(Filename(*iter));
+	}
+	mFiles.clear();
+}
+
+unsigned int ModelLoader::getCacheSize()
+{
+	MutexHolder guard(mCacheMutex);
+	unsigned int size = 0;
+	std::set<std::string>::const_iterator iter;
+	for (iter = mFiles.begin(); iter != mFiles.end(); ++iter)
+	{
+		if (ModelPool::has_model(Filename(*iter)))
+		{
+			++size;
+		}
+	}
+	return size;
+}
+
+unsigned long int ModelLoader::getCacheHits()
+{
+	MutexHolder guard(mCacheMutex);
+	return mCacheHits;
+}
+
+unsigned long int ModelLoader::getCacheMisses()
+{
+	MutexHolder guard(mCacheMutex);
+	return mCacheMisses;
+}
+
+//TypedObject semantics: hardcoded
+TypeHandle ModelLoader::_type_handle;
+
+} // namespace ely
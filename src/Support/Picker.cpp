@@ -69,7 +69,6 @@ Picker::Picker(PandaFramework* app, WindowFramework* window,
 {
 	//some preliminary checks
 	CHECK_EXISTENCE_DEBUG(mApp, "Picker::Picker: invalid PandaFramework")
-	CHECK_EXISTENCE_DEBUG(mWindow, "Picker::Picker: invalid WindowFramework")
 	CHECK_EXISTENCE_DEBUG(ObjectTemplateManager::GetSingletonPtr(),
 			"Picker::Picker: invalid ObjectTemplateManager")
 	SMARTPTR(Object)render =
@@ -99,9 +98,13 @@ Picker::Picker(PandaFramework* app, WindowFramework* window,
 	//reset picking logic data
 	mCsPick.clear();
 	mPivotCamDist = 0.0;
-	// setup event callback for picking body
+	//soft body
+	mSoftResults.fraction = 1.f;
+	// setup event callback for picking body (not if headless: no mouse)
 	mPickKeyOn = pickKeyOn;
 	mPickKeyOff = pickKeyOff;
+	RETURN_ON_COND(not mWindow,)
+
 	mPickBodyData = new EventCallbackInterface<Picker>::EventCallbackData(this,
 			&Picker::pickBody);
 	mApp->define_key(mPickKeyOn, "pickBody",
@@ -110,8 +113,6 @@ Picker::Picker(PandaFramework* app, WindowFramework* window,
 	mApp->define_key(mPickKeyOff, "pickBodyUp",
 			&EventCallbackInterface<Picker>::eventCallbackFunction,
 			reinterpret_cast<void*>(mPickBodyData.p()));
-	//soft body
-	mSoftResults.fraction = 1.f;
 }
 
 Picker::~Picker()
@@ -119,7 +120,7 @@ Picker::~Picker()
 	//lock (guard) the mutex
 	HOLD_REMUTEX(mMutex)
 
-	if (mApp)
+	if (mApp and mPickBodyData)
 	{
 		// remove event callback for picking body
 		mApp->get_event_handler().remove_hooks_with(
@@ -132,6 +133,9 @@ void Picker::pickBody(const Event* event)
 	//lock (guard) the mutex
 	HOLD_REMUTEX(mMutex)
 
+	//no mouse if headless
+	RETURN_ON_COND(not mWindow,)
+
 	// handle body picking
 	if (event->get_name() == mPickKeyOn)
 	{
@@ -319,6 +323,9 @@ void Picker::pickBody(const Event* event)
 
 void Picker::movePicked (btDynamicsWorld *world, btScalar timeStep)
 {
+	//no mouse if headless
+	RETURN_ON_COND(not GetSingletonPtr()->mWindow,)
+
 	// handle picked body if any
 	if (not GetSingletonPtr()->mCsPick.is_null())
 	{
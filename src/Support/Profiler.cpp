@@ -0,0 +1,382 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/Support/Profiler.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "Support/Profiler.h"
+#include <asyncTaskManager.h>
+#include <trueClock.h>
+#include <mutexHolder.h>
+#include <fstream>
+
+namespace
+{
+///The zones' registry (shared by all profilers).
+Mutex sZonesMutex;
+std::vector<std::string> sZoneNames;
+std::map<std::string, ely::Profiler::ZoneId> sZoneIds;
+
+///The profilers' serial numbers.
+int sProfilers = 0;
+
+///The current thread's ring (and its profiler's serial number: a profiler
+///can be created at the address of a deleted one).
+__thread void* tRing = NULL;
+__thread int tRingOwner = 0;
+
+double getTime()
+{
+	return TrueClock::get_global_ptr()->get_short_time();
+}
+
+///Writes a string as a JSON string.
+void writeJSONString(std::ostream& out, const std::string& str)
+{
+	out << '\"';
+	for (std::string::const_iterator c = str.begin(); c != str.end(); ++c)
+	{
+		if ((*c == '\"') or (*c == '\\'))
+		{
+			out << '\\';
+		}
+		out << ((unsigned char) *c < 0x20 ? ' ' : *c);
+	}
+	out << '\"';
+}
+}
+
+namespace ely
+{
+
+Profiler::Profiler(unsigned int numFrames, unsigned int ringSize, int sort,
+		int priority) :
+		mNumFrames(0), mFrameStart(getTime())
+{
+	{
+		MutexHolder guard(sZonesMutex);
+		mSerial = ++sProfilers;
+	}
+	//rings' size is a power of 2
+	unsigned int size = 2;
+	while (size < ringSize)
+	{
+		size <<= 1;
+	}
+	mRingMask = size - 1;
+	mFrames.resize(numFrames > 0 ? numFrames : 1);
+	AtomicAdjust::set(mEnabled, 0);
+	AtomicAdjust::set(mPStatsBridge, 0);
+	for (int i = 0; i < MAX_PSTATS_ZONES; ++i)
+	{
+		AtomicAdjust::set_ptr(mPStatsCollectors[i], NULL);
+	}
+	mStats.mFrames = mStats.mZones = mStats.mDropped = 0;
+	mStats.mThreads = 0;
+	//create the task for collecting the frames
+	mUpdateData = new TaskInterface<Profiler>::TaskData(this,
+			&Profiler::update);
+	mUpdateTask = new GenericAsyncTask("Profiler::update",
+			&TaskInterface<Profiler>::taskFunction,
+			reinterpret_cast<void*>(mUpdateData.p()));
+	//set sort/priority
+	mUpdateTask->set_sort(sort);
+	mUpdateTask->set_priority(priority);
+	//Adds mUpdateTask to the active queue.
+	AsyncTaskManager::get_global_ptr()->add(mUpdateTask);
+}
+
+Profiler::~Profiler()
+{
+	AtomicAdjust::set(mEnabled, 0);
+	if (mUpdateTask)
+	{
+		AsyncTaskManager::get_global_ptr()->remove(mUpdateTask);
+	}
+	MutexHolder guard(mRingsMutex);
+	for (unsigned int i = 0; i < mRings.size(); ++i)
+	{
+		delete mRings[i];
+	}
+	mRings.clear();
+	for (int i = 0; i < MAX_PSTATS_ZONES; ++i)
+	{
+		delete reinterpret_cast<PStatCollector*>(AtomicAdjust::get_ptr(
+				mPStatsCollectors[i]));
+	}
+}
+
+void Profiler::setEnabled(bool enable)
+{
+	AtomicAdjust::set(mEnabled, enable ? 1 : 0);
+}
+
+Profiler::ZoneId Profiler::registerZone(const std::string& name)
+{
+	MutexHolder guard(sZonesMutex);
+	std::map<std::string, ZoneId>::const_iterator iter = sZoneIds.find(name);
+	RETURN_ON_COND(iter != sZoneIds.end(), iter->second)
+
+	ZoneId id = sZoneNames.size();
+	sZoneNames.push_back(name);
+	sZoneIds[name] = id;
+	return id;
+}
+
+std::string Profiler::getZoneName(ZoneId id)
+{
+	MutexHolder guard(sZonesMutex);
+	RETURN_ON_COND((id < 0) or (id >= (ZoneId) sZoneNames.size()),
+			std::string())
+
+	return sZoneNames[id];
+}
+
+Profiler::ZoneId Profiler::getTypeZone(TypeHandle type)
+{
+	ThreadRing* ring = doGetThreadRing();
+	std::map<int, ZoneId>::const_iterator iter = ring->mTypeZones.find(
+			type.get_index());
+	RETURN_ON_COND(iter != ring->mTypeZones.end(), iter->second)
+
+	ZoneId id = registerZone(type.get_name());
+	ring->mTypeZones[type.get_index()] = id;
+	return id;
+}
+
+void Profiler::begin(ZoneId id)
+{
+	Event event;
+	event.mTime = getTime();
+	event.mId = id;
+	doPush(event);
+	if (getPStatsBridge())
+	{
+		PStatCollector* collector = doGetPStatsCollector(id);
+		if (collector)
+		{
+			collector->start();
+		}
+	}
+}
+
+void Profiler::end(ZoneId id)
+{
+	if (getPStatsBridge())
+	{
+		PStatCollector* collector = doGetPStatsCollector(id);
+		if (collector)
+		{
+			collector->stop();
+		}
+	}
+	Event event;
+	event.mTime = getTime();
+	event.mId = ~id;
+	doPush(event);
+}
+
+void Profiler::collect()
+{
+	double now = getTime();
+	MutexHolder guard(mMutex);
+	Frame& frame = mFrames[mNumFrames % mFrames.size()];
+	frame.mNumber = mNumFrames;
+	frame.mStart = mFrameStart;
+	frame.mEnd = now;
+	frame.mZones.clear();
+	{
+		MutexHolder ringsGuard(mRingsMutex);
+		for (unsigned int r = 0; r < mRings.size(); ++r)
+		{
+			ThreadRing* ring = mRings[r];
+			int tail = AtomicAdjust::get(ring->mTail);
+			int head = AtomicAdjust::get(ring->mHead);
+			while (tail != head)
+			{
+				const Event& event = ring->mEvents[tail];
+				if (event.mId >= 0)
+				{
+					ring->mOpen.push_back(event);
+				}
+				else
+				{
+					//match the innermost open zone with the same id (zones
+					//whose begin has been dropped are discarded)
+					ZoneId id = ~event.mId;
+					int depth = ring->mOpen.size() - 1;
+					while ((depth >= 0) and (ring->mOpen[depth].mId != id))
+					{
+						--depth;
+					}
+					if (depth >= 0)
+					{
+						Zone zone;
+						zone.mId = id;
+						zone.mThread = ring->mThread;
+						zone.mDepth = depth;
+						zone.mStart = ring->mOpen[depth].mTime;
+						zone.mEnd = event.mTime;
+						frame.mZones.push_back(zone);
+						ring->mOpen.resize(depth);
+					}
+				}
+				tail = (tail + 1) & mRingMask;
+			}
+			AtomicAdjust::set(ring->mTail, tail);
+			mStats.mDropped += AtomicAdjust::set(ring->mDropped, 0);
+		}
+		mStats.mThreads = mRings.size();
+	}
+	mStats.mZones += frame.mZones.size();
+	++mStats.mFrames;
+	++mNumFrames;
+	mFrameStart = now;
+}
+
+AsyncTask::DoneStatus Profiler::update(GenericAsyncTask* task)
+{
+	if (isEnabled())
+	{
+		collect();
+	}
+	//
+	return AsyncTask::DS_cont;
+}
+
+void Profiler::getFrames(std::vector<Frame>& frames)
+{
+	MutexHolder guard(mMutex);
+	frames.clear();
+	unsigned long int numFrames =
+			mNumFrames < mFrames.size() ? mNumFrames : mFrames.size();
+	for (unsigned long int f = mNumFrames - numFrames; f < mNumFrames; ++f)
+	{
+		frames.push_back(mFrames[f % mFrames.size()]);
+	}
+}
+
+bool Profiler::writeChromeTrace(const std::string& fileName)
+{
+	std::vector<Frame> frames;
+	getFrames(frames);
+	std::ofstream out(fileName.c_str(), std::ios::out | std::ios::trunc);
+	RETURN_ON_COND(not out.is_open(), false)
+
+	//complete ("X") events, in microseconds
+	out << "{\"traceEvents\":[";
+	bool first = true;
+	for (unsigned int f = 0; f < frames.size(); ++f)
+	{
+		const Frame& frame = frames[f];
+		out << (first ? "\n" : ",\n") << "{\"name\":\"Frame "
+				<< frame.mNumber << "\",\"cat\":\"frame\",\"ph\":\"X\",\"ts\":"
+				<< (long long int) (frame.mStart * 1e6) << ",\"dur\":"
+				<< (long long int) ((frame.mEnd - frame.mStart) * 1e6)
+				<< ",\"pid\":1,\"tid\":0}";
+		first = false;
+		for (unsigned int z = 0; z < frame.mZones.size(); ++z)
+		{
+			const Zone& zone = frame.mZones[z];
+			out << ",\n{\"name\":";
+			writeJSONString(out, getZoneName(zone.mId));
+			out << ",\"cat\":\"zone\",\"ph\":\"X\",\"ts\":"
+					<< (long long int) (zone.mStart * 1e6) << ",\"dur\":"
+					<< (long long int) ((zone.mEnd - zone.mStart) * 1e6)
+					<< ",\"pid\":1,\"tid\":" << zone.mThread + 1 << "}";
+		}
+	}
+	out << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+	return out.good();
+}
+
+void Profiler::setPStatsBridge(bool enable)
+{
+	AtomicAdjust::set(mPStatsBridge, enable ? 1 : 0);
+}
+
+Profiler::ProfilerStats Profiler::getStats()
+{
+	MutexHolder guard(mMutex);
+	return mStats;
+}
+
+Profiler::ThreadRing* Profiler::doGetThreadRing()
+{
+	if ((tRingOwner != mSerial) or (not tRing))
+	{
+		//first use by this thread: rings are kept until destruction
+		ThreadRing* ring = new ThreadRing();
+		ring->mEvents.resize(mRingMask + 1);
+		AtomicAdjust::set(ring->mHead, 0);
+		AtomicAdjust::set(ring->mTail, 0);
+		AtomicAdjust::set(ring->mDropped, 0);
+		{
+			MutexHolder guard(mRingsMutex);
+			ring->mThread = mRings.size();
+			mRings.push_back(ring);
+		}
+		tRing = ring;
+		tRingOwner = mSerial;
+	}
+	return reinterpret_cast<ThreadRing*>(tRing);
+}
+
+void Profiler::doPush(Event event)
+{
+	ThreadRing* ring = doGetThreadRing();
+	int head = AtomicAdjust::get(ring->mHead);
+	int next = (head + 1) & mRingMask;
+	if (next == AtomicAdjust::get(ring->mTail))
+	{
+		//full: the collector is late
+		AtomicAdjust::inc(ring->mDropped);
+		return;
+	}
+	ring->mEvents[head] = event;
+	//publish the event
+	AtomicAdjust::set(ring->mHead, next);
+}
+
+PStatCollector* Profiler::doGetPStatsCollector(ZoneId id)
+{
+	RETURN_ON_COND((id < 0) or (id >= MAX_PSTATS_ZONES), NULL)
+
+	void* collector = AtomicAdjust::get_ptr(mPStatsCollectors[id]);
+	if (not collector)
+	{
+		//created once: a racing thread's copy is deleted
+		PStatCollector* newCollector = new PStatCollector(
+				std::string("Ely:") + getZoneName(id));
+		collector = AtomicAdjust::compare_and_exchange_ptr(
+				mPStatsCollectors[id], NULL, newCollector);
+		if (collector)
+		{
+			delete newCollector;
+		}
+		else
+		{
+			collector = newCollector;
+		}
+	}
+	return reinterpret_cast<PStatCollector*>(collector);
+}
+
+} // namespace ely
@@ -23,6 +23,7 @@
 
 #include "Support/Raycaster.h"
 #include "Game/GamePhysicsManager.h"
+#include "ObjectModel/ObjectTemplateManager.h"
 
 namespace ely
 {
@@ -218,8 +219,14 @@ inline void Raycaster::doRayCast(const BitMask32& bitMask)
 				//- BulletGhostNode
 
 				mHitNode = const_cast<PandaNode*>(mHitResult.get_node());
-				mHitObject = GamePhysicsManager::GetSingletonPtr()->
-				getPhysicsComponentByPandaNode(mHitNode)->getOwnerObject();
+				//the hit node is usually the Object's one: lock-free lookup
+				mHitObject = ObjectTemplateManager::GetSingletonPtr()->
+				getCreatedObjectByPandaNode(mHitNode);
+				if (not mHitObject)
+				{
+					mHitObject = GamePhysicsManager::GetSingletonPtr()->
+					getPhysicsComponentByPandaNode(mHitNode)->getOwnerObject();
+				}
 				mHitPos = mHitResult.get_hit_pos();
 				mHitNormal = mHitResult.get_hit_normal();
 				mHitFraction = mHitResult.get_hit_fraction();
@@ -0,0 +1,499 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/Support/RecastNavigationLocal/CrowdShards.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "Support/RecastNavigationLocal/CrowdShards.h"
+#include "Utilities/Tools.h"
+#include <DetourCommon.h>
+#include <asyncTaskManager.h>
+#include <cstring>
+
+namespace ely
+{
+
+CrowdShards::CrowdShards() :
+		mMaxAgents(0), mMaxGhosts(0), mStamp(0), mAxis(0), mBoundMin(0.0),
+		mStripSize(0.0), mNumThreads(0), mNumMigrations(0), mNumGhosts(0),
+		mNumDroppedGhosts(0), mNumDeferredMigrations(0)
+{
+}
+
+CrowdShards::~CrowdShards()
+{
+	cleanup();
+}
+
+bool CrowdShards::init(int numShards, int maxAgents, int maxGhosts,
+		float maxAgentRadius, dtNavMesh* nav, const dtCrowd* prototype,
+		const float* bmin, const float* bmax, int numThreads,
+		const std::string& name)
+{
+	cleanup();
+	RETURN_ON_COND((numShards <= 0) or (maxAgents <= 0) or (maxGhosts < 0)
+			or (not nav), false)
+
+	//strips along the longest horizontal axis
+	mAxis = (bmax[0] - bmin[0] >= bmax[2] - bmin[2] ? 0 : 2);
+	mBoundMin = bmin[mAxis];
+	mStripSize = (bmax[mAxis] - bmin[mAxis]) / numShards;
+	mMaxAgents = maxAgents;
+	mMaxGhosts = maxGhosts;
+	mShards.resize(numShards);
+	for (int s = 0; s < numShards; ++s)
+	{
+		Shard& shard = mShards[s];
+		shard.mCrowd = dtAllocCrowd();
+		shard.mMin = mBoundMin + s * mStripSize;
+		shard.mMax = mBoundMin + (s + 1) * mStripSize;
+		//ghosts have their own room
+		shard.mOwners.assign(maxAgents + maxGhosts, -1);
+		shard.mGhostOwners.assign(maxAgents + maxGhosts, -1);
+		shard.mGhostStamps.assign(maxAgents + maxGhosts, 0);
+		shard.mNumAgents = shard.mNumGhosts = 0;
+		if ((not shard.mCrowd)
+				or (not shard.mCrowd->init(maxAgents + maxGhosts,
+						maxAgentRadius, nav)))
+		{
+			cleanup();
+			return false;
+		}
+		//same filters and avoidance params of the prototype
+		if (prototype)
+		{
+			for (int f = 0; f < DT_CROWD_MAX_QUERY_FILTER_TYPE; ++f)
+			{
+				*shard.mCrowd->getEditableFilter(f) = *prototype->getFilter(f);
+			}
+			for (int p = 0; p < DT_CROWD_MAX_OBSTAVOIDANCE_PARAMS; ++p)
+			{
+				shard.mCrowd->setObstacleAvoidanceParams(p,
+						prototype->getObstacleAvoidanceParams(p));
+			}
+		}
+	}
+	//update threads
+	mNumThreads = numThreads;
+	if (mNumThreads > 0)
+	{
+		mTaskChainName = name + "-crowdShards";
+		AsyncTaskChain* taskChain =
+				AsyncTaskManager::get_global_ptr()->make_task_chain(
+						mTaskChainName);
+		taskChain->set_num_threads(mNumThreads);
+		taskChain->set_frame_sync(false);
+	}
+	mStamp = 0;
+	mNumMigrations = mNumGhosts = mNumDroppedGhosts = mNumDeferredMigrations =
+			0;
+	return true;
+}
+
+void CrowdShards::cleanup()
+{
+	if (not mTaskChainName.empty())
+	{
+		AsyncTaskChain* taskChain =
+				AsyncTaskManager::get_global_ptr()->find_task_chain(
+						mTaskChainName);
+		if (taskChain)
+		{
+			taskChain->wait_for_tasks();
+			AsyncTaskManager::get_global_ptr()->remove_task_chain(
+					mTaskChainName);
+		}
+		mTaskChainName.clear();
+	}
+	for (unsigned int s = 0; s < mShards.size(); ++s)
+	{
+		dtFreeCrowd(mShards[s].mCrowd);
+	}
+	mShards.clear();
+	mAgents.clear();
+	mFreeAgents.clear();
+	mNumThreads = 0;
+}
+
+int CrowdShards::addAgent(const float* pos, const dtCrowdAgentParams* params)
+{
+	RETURN_ON_COND(mShards.empty(), -1)
+
+	//the shard containing pos, or the nearest one with room
+	int home = doGetShard(pos);
+	int shardIdx = -1;
+	for (int d = 0; (d < (int) mShards.size()) and (shardIdx == -1); ++d)
+	{
+		if ((home - d >= 0) and (mShards[home - d].mNumAgents < mMaxAgents))
+		{
+			shardIdx = home - d;
+		}
+		else if ((home + d < (int) mShards.size())
+				and (mShards[home + d].mNumAgents < mMaxAgents))
+		{
+			shardIdx = home + d;
+		}
+	}
+	RETURN_ON_COND(shardIdx == -1, -1)
+
+	Shard& shard = mShards[shardIdx];
+	int crowdIdx = shard.mCrowd->addAgent(pos, params);
+	RETURN_ON_COND(crowdIdx == -1, -1)
+
+	int idx;
+	if (not mFreeAgents.empty())
+	{
+		idx = mFreeAgents.back();
+		mFreeAgents.pop_back();
+	}
+	else
+	{
+		idx = mAgents.size();
+		mAgents.push_back(Agent());
+	}
+	Agent& agent = mAgents[idx];
+	agent.mShard = shardIdx;
+	agent.mIdx = crowdIdx;
+	agent.mRequest = Agent::NONE;
+	agent.mTargetRef = 0;
+	shard.mOwners[crowdIdx] = idx;
+	++shard.mNumAgents;
+	return idx;
+}
+
+void CrowdShards::removeAgent(int idx)
+{
+	RETURN_ON_COND(not getAgent(idx),)
+
+	Agent& agent = mAgents[idx];
+	Shard& shard = mShards[agent.mShard];
+	shard.mCrowd->removeAgent(agent.mIdx);
+	shard.mOwners[agent.mIdx] = -1;
+	--shard.mNumAgents;
+	agent.mShard = agent.mIdx = -1;
+	mFreeAgents.push_back(idx);
+}
+
+bool CrowdShards::updateAgentParameters(int idx,
+		const dtCrowdAgentParams* params)
+{
+	RETURN_ON_COND(not getAgent(idx), false)
+
+	const Agent& agent = mAgents[idx];
+	mShards[agent.mShard].mCrowd->updateAgentParameters(agent.mIdx, params);
+	return true;
+}
+
+bool CrowdShards::requestMoveTarget(int idx, dtPolyRef ref, const float* pos)
+{
+	RETURN_ON_COND(not getAgent(idx), false)
+
+	Agent& agent = mAgents[idx];
+	//remember the request for migrations
+	agent.mRequest = Agent::TARGET;
+	agent.mTargetRef = ref;
+	dtVcopy(agent.mTarget, pos);
+	return mShards[agent.mShard].mCrowd->requestMoveTarget(agent.mIdx, ref,
+			pos);
+}
+
+bool CrowdShards::requestMoveVelocity(int idx, const float* vel)
+{
+	RETURN_ON_COND(not getAgent(idx), false)
+
+	Agent& agent = mAgents[idx];
+	agent.mRequest = Agent::VELOCITY;
+	dtVcopy(agent.mTarget, vel);
+	return mShards[agent.mShard].mCrowd->requestMoveVelocity(agent.mIdx, vel);
+}
+
+const dtCrowdAgent* CrowdShards::getAgent(int idx) const
+{
+	RETURN_ON_COND((idx < 0) or (idx >= (int) mAgents.size()), NULL)
+	RETURN_ON_COND(mAgents[idx].mShard == -1, NULL)
+
+	return mShards[mAgents[idx].mShard].mCrowd->getAgent(mAgents[idx].mIdx);
+}
+
+void CrowdShards::update(float dt)
+{
+	RETURN_ON_COND(mShards.empty(),)
+
+	//migrate before updating, so agents' velocities are up to date
+	doMigrate();
+	doMirrorAgents();
+	if ((mNumThreads > 0) and (mShards.size() > 1))
+	{
+		AsyncTaskChain* taskChain =
+				AsyncTaskManager::get_global_ptr()->find_task_chain(
+						mTaskChainName);
+		for (unsigned int s = 0; s < mShards.size(); ++s)
+		{
+			PT(AsyncTask) updateTask = new UpdateTask(this, s, dt);
+			updateTask->set_task_chain(mTaskChainName);
+			AsyncTaskManager::get_global_ptr()->add(updateTask);
+		}
+		taskChain->wait_for_tasks();
+	}
+	else
+	{
+		for (unsigned int s = 0; s < mShards.size(); ++s)
+		{
+			mShards[s].mCrowd->update(dt, NULL);
+		}
+	}
+}
+
+int CrowdShards::doGetShard(const float* pos) const
+{
+	RETURN_ON_COND(mStripSize <= 0.0, 0)
+
+	int shard = (int) ((pos[mAxis] - mBoundMin) / mStripSize);
+	if (shard < 0)
+	{
+		shard = 0;
+	}
+	else if (shard >= (int) mShards.size())
+	{
+		shard = mShards.size() - 1;
+	}
+	return shard;
+}
+
+void CrowdShards::doMigrate()
+{
+	for (unsigned int s = 0; s < mShards.size(); ++s)
+	{
+		Shard& shard = mShards[s];
+		for (int i = 0; i < (int) shard.mOwners.size(); ++i)
+		{
+			int idx = shard.mOwners[i];
+			if (idx == -1)
+			{
+				continue;
+			}
+			const dtCrowdAgent* ag = shard.mCrowd->getAgent(i);
+			//hysteresis: the agent must be out of the strip by its radius
+			float x = ag->npos[mAxis];
+			float margin = ag->params.radius;
+			if ((x >= shard.mMin - margin) and (x <= shard.mMax + margin))
+			{
+				continue;
+			}
+			int target = doGetShard(ag->npos);
+			if (target == (int) s)
+			{
+				continue;
+			}
+			//a full shard: retry on the next update
+			if (doMoveAgent(idx, target))
+			{
+				++mNumMigrations;
+			}
+			else
+			{
+				++mNumDeferredMigrations;
+			}
+		}
+	}
+}
+
+bool CrowdShards::doMoveAgent(int idx, int shardIdx)
+{
+	Agent& agent = mAgents[idx];
+	Shard& from = mShards[agent.mShard];
+	Shard& to = mShards[shardIdx];
+	RETURN_ON_COND(to.mNumAgents >= mMaxAgents, false)
+
+	//save the agent's state
+	const dtCrowdAgent* ag = from.mCrowd->getAgent(agent.mIdx);
+	dtCrowdAgentParams params = ag->params;
+	float pos[3], vel[3];
+	dtVcopy(pos, ag->npos);
+	dtVcopy(vel, ag->vel);
+	//add to the new shard, then remove from the old one
+	int crowdIdx = to.mCrowd->addAgent(pos, &params);
+	RETURN_ON_COND(crowdIdx == -1, false)
+
+	from.mCrowd->removeAgent(agent.mIdx);
+	from.mOwners[agent.mIdx] = -1;
+	--from.mNumAgents;
+	agent.mShard = shardIdx;
+	agent.mIdx = crowdIdx;
+	to.mOwners[crowdIdx] = idx;
+	++to.mNumAgents;
+	//restore velocity and move request
+	dtVcopy(doEditAgent(to.mCrowd, crowdIdx)->vel, vel);
+	if (agent.mRequest == Agent::TARGET)
+	{
+		to.mCrowd->requestMoveTarget(crowdIdx, agent.mTargetRef,
+				agent.mTarget);
+	}
+	else if (agent.mRequest == Agent::VELOCITY)
+	{
+		to.mCrowd->requestMoveVelocity(crowdIdx, agent.mTarget);
+	}
+	return true;
+}
+
+void CrowdShards::doMirrorAgents()
+{
+	++mStamp;
+	unsigned int dropped = mNumDroppedGhosts;
+	mNumDroppedGhosts = 0;
+	for (unsigned int s = 0; s < mShards.size(); ++s)
+	{
+		Shard& shard = mShards[s];
+		for (int i = 0; i < (int) shard.mOwners.size(); ++i)
+		{
+			int idx = shard.mOwners[i];
+			if (idx == -1)
+			{
+				continue;
+			}
+			const dtCrowdAgent* ag = shard.mCrowd->getAgent(i);
+			float x = ag->npos[mAxis];
+			float range = ag->params.collisionQueryRange;
+			//neighbor shards reached by the collision query range
+			int first = doGetShard(ag->npos);
+			int last = first;
+			while ((first > 0) and (x - range < mShards[first].mMin))
+			{
+				--first;
+			}
+			while ((last < (int) mShards.size() - 1)
+					and (x + range > mShards[last].mMax))
+			{
+				++last;
+			}
+			for (int n = first; n <= last; ++n)
+			{
+				if ((n != (int) s) and (not doMirror(idx, ag, n)))
+				{
+					++mNumDroppedGhosts;
+				}
+			}
+		}
+	}
+	//ghosts of agents gone away (removed, migrated or far from boundaries)
+	doRemoveStaleGhosts();
+	if ((mNumDroppedGhosts > 0) and (dropped == 0))
+	{
+		PRINT_ERR_DEBUG(
+				"CrowdShards::doMirrorAgents: full shards, ghosts dropped: "
+				<< mNumDroppedGhosts);
+	}
+}
+
+bool CrowdShards::doMirror(int idx, const dtCrowdAgent* ag, int shardIdx)
+{
+	Shard& shard = mShards[shardIdx];
+	if ((int) shard.mGhostOf.size() <= idx)
+	{
+		shard.mGhostOf.resize(mAgents.size(), -1);
+	}
+	//a passive copy: no steering, current velocity
+	dtCrowdAgentParams params = ag->params;
+	params.updateFlags = 0;
+	int ghostIdx = shard.mGhostOf[idx];
+	if (ghostIdx != -1)
+	{
+		//a ghost is moved in place (its corridor follows it during the
+		//update) unless it is too far: the agent has been teleported, or its
+		//index reused
+		dtCrowdAgent* ghost = doEditAgent(shard.mCrowd, ghostIdx);
+		if (dtVdist2DSqr(ghost->npos, ag->npos) <= dtSqr(ag->params.radius))
+		{
+			dtVcopy(ghost->npos, ag->npos);
+			shard.mCrowd->updateAgentParameters(ghostIdx, &params);
+		}
+		else
+		{
+			doRemoveGhost(shard, ghostIdx);
+			ghostIdx = -1;
+		}
+	}
+	if (ghostIdx == -1)
+	{
+		RETURN_ON_COND(shard.mNumGhosts >= mMaxGhosts, false)
+
+		ghostIdx = shard.mCrowd->addAgent(ag->npos, &params);
+		RETURN_ON_COND(ghostIdx == -1, false)
+
+		shard.mGhostOwners[ghostIdx] = idx;
+		shard.mGhostOf[idx] = ghostIdx;
+		++shard.mNumGhosts;
+	}
+	dtVcopy(doEditAgent(shard.mCrowd, ghostIdx)->vel, ag->vel);
+	shard.mCrowd->requestMoveVelocity(ghostIdx, ag->vel);
+	shard.mGhostStamps[ghostIdx] = mStamp;
+	return true;
+}
+
+void CrowdShards::doRemoveGhost(Shard& shard, int ghostIdx)
+{
+	shard.mCrowd->removeAgent(ghostIdx);
+	shard.mGhostOf[shard.mGhostOwners[ghostIdx]] = -1;
+	shard.mGhostOwners[ghostIdx] = -1;
+	--shard.mNumGhosts;
+}
+
+void CrowdShards::doRemoveStaleGhosts()
+{
+	mNumGhosts = 0;
+	for (unsigned int s = 0; s < mShards.size(); ++s)
+	{
+		Shard& shard = mShards[s];
+		for (int i = 0; i < (int) shard.mGhostOwners.size(); ++i)
+		{
+			if (shard.mGhostOwners[i] == -1)
+			{
+				continue;
+			}
+			if (shard.mGhostStamps[i] != mStamp)
+			{
+				doRemoveGhost(shard, i);
+			}
+		}
+		mNumGhosts += shard.mNumGhosts;
+	}
+}
+
+dtCrowdAgent* CrowdShards::doEditAgent(dtCrowd* crowd, int idx)
+{
+	//agents are owned by the crowd: their velocity can be safely edited
+	return const_cast<dtCrowdAgent*>(crowd->getAgent(idx));
+}
+
+CrowdShards::UpdateTask::UpdateTask(CrowdShards* shards, int shard, float dt) :
+		AsyncTask("CrowdShards-update"), mShards(shards), mShard(shard), mDt(
+				dt)
+{
+}
+
+AsyncTask::DoneStatus CrowdShards::UpdateTask::do_task()
+{
+	//each shard is touched by only one task
+	mShards->mShards[mShard].mCrowd->update(mDt, NULL);
+	//
+	return DS_done;
+}
+
+} // namespace ely
@@ -96,7 +96,11 @@ CrowdToolState::CrowdToolState() :
 	m_nav(0),
 	m_crowd(0),
 	m_targetRef(0),
-	m_run(true)
+	m_maxAgents(DEFAULT_MAX_AGENTS),
+	m_shards(0),
+	m_run(true),
+	m_collectStats(false),
+	m_updateTime(0)
 {
 	m_toolParams.m_expandSelectedDebugDraw = true;
 	m_toolParams.m_showCorners = false;
@@ -120,8 +124,6 @@ CrowdToolState::CrowdToolState() :
 	m_toolParams.m_separation = false;
 	m_toolParams.m_separationWeight = 2.0f;
 	
-	memset(m_trails, 0, sizeof(m_trails));
-	
 	m_vod = dtAllocObstacleAvoidanceDebugData();
 	m_vod->init(2048);
 	
@@ -132,6 +134,7 @@ CrowdToolState::CrowdToolState() :
 
 CrowdToolState::~CrowdToolState()
 {
+	delete m_shards;
 	dtFreeObstacleAvoidanceDebugData(m_vod);
 }
 
@@ -152,7 +155,12 @@ void CrowdToolState::init(class NavMeshType* sample)
 		m_nav = nav;
 		m_crowd = crowd;
 	
-		crowd->init(MAX_AGENTS, m_sample->getAgentRadius(), nav);
+		crowd->init(m_maxAgents, m_sample->getAgentRadius(), nav);
+		AgentTrail trail;
+		memset(&trail, 0, sizeof(trail));
+		m_trails.assign(m_maxAgents, trail);
+		delete m_shards;
+		m_shards = 0;
 		
 		// Make polygons with 'disabled' flag invalid.
 		crowd->getEditableFilter(0)->setExcludeFlags(NAVMESH_POLYFLAGS_DISABLED);
@@ -197,6 +205,25 @@ void CrowdToolState::reset()
 {
 }
 
+bool CrowdToolState::initShards(int numShards, int numThreads, const std::string& name)
+{
+	if (!m_sample || !m_nav || !m_crowd) return false;
+	
+	delete m_shards;
+	m_shards = new CrowdShards();
+	// Shards are like the current crowd (with its filters and avoidance params).
+	// Room for ghosts (agents near the boundaries) up to half the agents.
+	if (!m_shards->init(numShards, m_maxAgents, m_maxAgents / 2 + 1,
+			m_sample->getAgentRadius(), m_nav, m_crowd, m_sample->getBoundsMin(),
+			m_sample->getBoundsMax(), numThreads, name))
+	{
+		delete m_shards;
+		m_shards = 0;
+		return false;
+	}
+	return true;
+}
+
 void CrowdToolState::handleRender(duDebugDraw& dd)
 {
 //	DebugDrawGL dd;
@@ -631,13 +658,28 @@ void CrowdToolState::handleRender(duDebugDraw& dd)
 
 void CrowdToolState::handleUpdate(const float dt)
 {
-	if (m_run)
+	if (!m_run)
+		return;
+	if (m_collectStats)
+	{
+		TimeVal startTime = getPerfTime();
+		updateTick(dt);
+		m_updateTime = getPerfTimeUsec(getPerfTime() - startTime);
+	}
+	else
 		updateTick(dt);
 }
 
 int CrowdToolState::addAgent(const float* p, const dtCrowdAgentParams* params)
 {
 	if (!m_sample) return -1;
+	if (m_shards)
+	{
+		int idx = m_shards->addAgent(p, params);
+		if (idx != -1 && m_targetRef)
+			m_shards->requestMoveTarget(idx, m_targetRef, m_targetPos);
+		return idx;
+	}
 	dtCrowd* crowd = m_sample->getCrowd();
 
 	int idx = crowd->addAgent(p, params);
@@ -703,6 +745,11 @@ int CrowdToolState::addAgent(const float* p)
 void CrowdToolState::removeAgent(const int idx)
 {
 	if (!m_sample) return;
+	if (m_shards)
+	{
+		m_shards->removeAgent(idx);
+		return;
+	}
 	dtCrowd* crowd = m_sample->getCrowd();
 
 	crowd->removeAgent(idx);
@@ -711,6 +758,23 @@ void CrowdToolState::removeAgent(const int idx)
 		m_agentDebug.idx = -1;
 }
 
+const dtCrowdAgent* CrowdToolState::getAgent(const int idx)
+{
+	if (!m_sample) return 0;
+	if (m_shards)
+		return m_shards->getAgent(idx);
+	return m_sample->getCrowd()->getAgent(idx);
+}
+
+void CrowdToolState::updateAgentParameters(const int idx, const dtCrowdAgentParams* params)
+{
+	if (!m_sample) return;
+	if (m_shards)
+		m_shards->updateAgentParameters(idx, params);
+	else
+		m_sample->getCrowd()->updateAgentParameters(idx, params);
+}
+
 void CrowdToolState::hilightAgent(const int idx)
 {
 	m_agentDebug.idx = idx;
@@ -804,6 +868,11 @@ void CrowdToolState::setMoveTarget(int idx, const float* p)
 
 	navquery->findNearestPoly(p, ext, filter, &m_targetRef, m_targetPos);
 
+	if (m_shards)
+	{
+		m_shards->requestMoveTarget(idx, m_targetRef, m_targetPos);
+		return;
+	}
 	const dtCrowdAgent* ag = crowd->getAgent(idx);
 	if (ag && ag->active)
 		crowd->requestMoveTarget(idx, m_targetRef, m_targetPos);
@@ -814,6 +883,11 @@ void CrowdToolState::setMoveVelocity(int idx, const float* v)
 	if (!m_sample)
 		return;
 
+	if (m_shards)
+	{
+		m_shards->requestMoveVelocity(idx, v);
+		return;
+	}
 	dtCrowd* crowd = m_sample->getCrowd();
 
 	// Request velocity
@@ -897,6 +971,12 @@ void CrowdToolState::updateTick(const float dt)
 	dtCrowd* crowd = m_sample->getCrowd();
 	if (!nav || !crowd) return;
 	
+	if (m_shards)
+	{
+		m_shards->update(dt);
+		return;
+	}
+	
 #ifdef ELY_DEBUG
 
 //	TimeVal startTime = getPerfTime();
@@ -929,10 +1009,11 @@ void CrowdToolState::updateTick(const float dt)
 
 
 
-CrowdTool::CrowdTool() :
+CrowdTool::CrowdTool(int maxAgents) :
 	m_sample(0),
 	m_state(0),
-	m_mode(TOOLMODE_CREATE)
+	m_mode(TOOLMODE_CREATE),
+	m_maxAgents(maxAgents)
 {
 }
 
@@ -952,6 +1033,7 @@ void CrowdTool::init(NavMeshType* sample)
 		m_state = new CrowdToolState();
 		sample->setToolState(type(), m_state);
 	}
+	m_state->setMaxAgents(m_maxAgents);
 	m_state->init(sample);
 }
 
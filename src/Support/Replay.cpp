@@ -0,0 +1,463 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/Support/Replay.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "Support/Replay.h"
+#include "Support/Lockstep.h"
+#include "ObjectModel/ObjectTemplateManager.h"
+#include "Game/GameManager.h"
+#include <asyncTaskManager.h>
+#include <eventHandler.h>
+#include <eventQueue.h>
+#include <trueClock.h>
+#include <mutexHolder.h>
+#include <cstring>
+
+namespace
+{
+///Stream header: magic and version.
+const char MAGIC[4] =
+{ 'E', 'L', 'Y', 'R' };
+const unsigned int VERSION = 1;
+
+double getTime()
+{
+	return TrueClock::get_global_ptr()->get_short_time();
+}
+}
+
+namespace ely
+{
+
+Replay::Replay(Mode mode, const std::string& fileName, int sort, int priority) :
+		mMode(mode), mFileName(fileName), mStarted(false), mFinished(false),
+		mExitAtEnd(false), mApplying(false), mPos(0), mFrameDt(0.0),
+		mGuiEventHandler(NULL), mLastTime(0.0)
+{
+	mStats.mFrames = 0;
+	mStats.mTotalTime = mStats.mMinFrameTime = mStats.mMaxFrameTime = 0.0;
+	//create the task for the frames
+	mUpdateData = new TaskInterface<Replay>::TaskData(this, &Replay::update);
+	mUpdateTask = new GenericAsyncTask("Replay::update",
+			&TaskInterface<Replay>::taskFunction,
+			reinterpret_cast<void*>(mUpdateData.p()));
+	//set sort/priority
+	mUpdateTask->set_sort(sort);
+	mUpdateTask->set_priority(priority);
+	//Adds mUpdateTask to the active queue.
+	AsyncTaskManager::get_global_ptr()->add(mUpdateTask);
+}
+
+Replay::~Replay()
+{
+	if (mUpdateTask)
+	{
+		AsyncTaskManager::get_global_ptr()->remove(mUpdateTask);
+	}
+	EventHandler::get_global_event_handler()->remove_hooks_with(
+			static_cast<void*>(this));
+	MutexHolder guard(mMutex);
+	if (mOut.is_open())
+	{
+		//the last frame's records
+		mOut.write(mBuffer.data(), mBuffer.size());
+		mOut.close();
+	}
+}
+
+bool Replay::start()
+{
+	RETURN_ON_COND(mStarted, false)
+
+	if (mMode == RECORDING)
+	{
+		mOut.open(mFileName.c_str(),
+				std::ios::out | std::ios::binary | std::ios::trunc);
+		RETURN_ON_COND(not mOut.is_open(), false)
+
+		mOut.write(MAGIC, sizeof(MAGIC));
+		doWriteUInt(VERSION);
+		mOut.write(mBuffer.data(), mBuffer.size());
+		mBuffer.clear();
+	}
+	else
+	{
+		std::ifstream in(mFileName.c_str(), std::ios::in | std::ios::binary);
+		RETURN_ON_COND(not in.is_open(), false)
+
+		mData.assign(std::istreambuf_iterator<char>(in),
+				std::istreambuf_iterator<char>());
+		mPos = sizeof(MAGIC);
+		unsigned int version;
+		RETURN_ON_COND(
+				(mData.compare(0, sizeof(MAGIC), MAGIC, sizeof(MAGIC)) != 0)
+						or (not doReadUInt(version)) or (version != VERSION),
+				false)
+	}
+	mLastTime = getTime();
+	mStarted = true;
+	return true;
+}
+
+void Replay::watchEvent(const std::string& event)
+{
+	Replay* replay = GetSingletonPtr();
+	RETURN_ON_COND(not replay,)
+
+	MutexHolder guard(replay->mMutex);
+	if (replay->mWatchedEvents[event]++ == 0)
+	{
+		EventHandler::get_global_event_handler()->add_hook(event,
+				&Replay::doRecordEvent, static_cast<void*>(replay));
+	}
+}
+
+void Replay::unwatchEvent(const std::string& event)
+{
+	Replay* replay = GetSingletonPtr();
+	RETURN_ON_COND(not replay,)
+
+	MutexHolder guard(replay->mMutex);
+	std::map<std::string, int>::iterator iter = replay->mWatchedEvents.find(
+			event);
+	RETURN_ON_COND(iter == replay->mWatchedEvents.end(),)
+
+	if (--iter->second == 0)
+	{
+		EventHandler::get_global_event_handler()->remove_hook(event,
+				&Replay::doRecordEvent, static_cast<void*>(replay));
+		replay->mWatchedEvents.erase(iter);
+	}
+}
+
+void Replay::doRecordEvent(const Event* event, void* data)
+{
+	Replay* replay = reinterpret_cast<Replay*>(data);
+	RETURN_ON_COND(not replay->isRecording(),)
+
+	MutexHolder guard(replay->mMutex);
+	replay->mBuffer.push_back((char) EVENT);
+	replay->doWriteString(event->get_name());
+}
+
+void Replay::pointerInput(const std::string& key, bool& moved, float& deltaX,
+		float& deltaY)
+{
+	Replay* replay = GetSingletonPtr();
+	RETURN_ON_COND(not replay,)
+
+	if (replay->isReplaying())
+	{
+		MutexHolder guard(replay->mMutex);
+		std::map<std::string, std::pair<float, float> >::const_iterator iter =
+				replay->mPointers.find(key);
+		moved = (iter != replay->mPointers.end());
+		deltaX = moved ? iter->second.first : 0.0;
+		deltaY = moved ? iter->second.second : 0.0;
+	}
+	else if (replay->isRecording() and moved)
+	{
+		MutexHolder guard(replay->mMutex);
+		replay->mBuffer.push_back((char) POINTER);
+		replay->doWriteString(key);
+		replay->doWriteFloat(deltaX);
+		replay->doWriteFloat(deltaY);
+	}
+}
+
+void Replay::recordGuiEvent(const std::string& value,
+		const ParameterTable& params)
+{
+	RETURN_ON_COND(not isRecording(),)
+
+	MutexHolder guard(mMutex);
+	mBuffer.push_back((char) GUI);
+	doWriteString(value);
+	doWriteParams(params);
+}
+
+void Replay::recordSpawn(const std::string& objectType,
+		const std::string& objectId, const ParameterTable& objectParams,
+		const ParameterTableMap& componentsParams, bool storeParams,
+		const std::string& ownerId)
+{
+	RETURN_ON_COND(not isRecording(),)
+
+	MutexHolder guard(mMutex);
+	mBuffer.push_back((char) SPAWN);
+	doWriteString(objectType);
+	doWriteString(objectId);
+	doWriteParams(objectParams);
+	doWriteUInt(componentsParams.size());
+	ParameterTableMap::const_iterator iter;
+	for (iter = componentsParams.begin(); iter != componentsParams.end();
+			++iter)
+	{
+		doWriteString(iter->first);
+		doWriteParams(iter->second);
+	}
+	mBuffer.push_back(storeParams ? 1 : 0);
+	doWriteString(ownerId);
+}
+
+void Replay::recordDestroy(const std::string& objectId)
+{
+	RETURN_ON_COND(not isRecording(),)
+
+	MutexHolder guard(mMutex);
+	mBuffer.push_back((char) DESTROY);
+	doWriteString(objectId);
+}
+
+AsyncTask::DoneStatus Replay::update(GenericAsyncTask* task)
+{
+	RETURN_ON_COND((not mStarted) or mFinished, AsyncTask::DS_cont)
+
+	double now = getTime();
+	double frameTime = now - mLastTime;
+	mLastTime = now;
+	if (mMode == RECORDING)
+	{
+		MutexHolder guard(mMutex);
+		//the previous frame's records, then this one's delta time
+		mOut.write(mBuffer.data(), mBuffer.size());
+		mBuffer.clear();
+		mBuffer.push_back((char) FRAME);
+		doWriteFloat(Lockstep::getFrameDt());
+	}
+	else if (not doReplayFrame())
+	{
+		//stream consumed (or truncated)
+		mFinished = true;
+		{
+			MutexHolder guard(mMutex);
+			mPointers.clear();
+		}
+		if (mExitAtEnd and GameManager::GetSingletonPtr())
+		{
+			GameManager::GetSingletonPtr()->pandaFramework()->set_exit_flag();
+		}
+		return AsyncTask::DS_cont;
+	}
+	//statistics (the first frame follows start())
+	if ((mStats.mFrames == 0) or (frameTime < mStats.mMinFrameTime))
+	{
+		mStats.mMinFrameTime = frameTime;
+	}
+	if (frameTime > mStats.mMaxFrameTime)
+	{
+		mStats.mMaxFrameTime = frameTime;
+	}
+	mStats.mTotalTime += frameTime;
+	++mStats.mFrames;
+	//
+	return AsyncTask::DS_cont;
+}
+
+bool Replay::doReplayFrame()
+{
+	//a frame starts with its delta time
+	RETURN_ON_COND((mPos >= mData.size()) or (mData[mPos] != (char) FRAME),
+			false)
+
+	++mPos;
+	float dt;
+	RETURN_ON_COND(not doReadFloat(dt), false)
+
+	mFrameDt = dt;
+	{
+		MutexHolder guard(mMutex);
+		mPointers.clear();
+	}
+	//the frame's records
+	while ((mPos < mData.size()) and (mData[mPos] != (char) FRAME))
+	{
+		RecordType type = (RecordType) mData[mPos++];
+		if (type == EVENT)
+		{
+			std::string name;
+			RETURN_ON_COND(not doReadString(name), false)
+
+			//dispatched during this frame
+			EventQueue::get_global_event_queue()->queue_event(new Event(name));
+		}
+		else if (type == POINTER)
+		{
+			std::string key;
+			float deltaX, deltaY;
+			RETURN_ON_COND(
+					(not doReadString(key)) or (not doReadFloat(deltaX))
+							or (not doReadFloat(deltaY)), false)
+
+			MutexHolder guard(mMutex);
+			mPointers[key] = std::pair<float, float>(deltaX, deltaY);
+		}
+		else if (type == GUI)
+		{
+			std::string value;
+			ParameterTable params;
+			RETURN_ON_COND((not doReadString(value)) or (not doReadParams(params)),
+					false)
+
+			//no GUI (e.g. headless): dropped
+			if (mGuiEventHandler)
+			{
+				mGuiEventHandler(value, params);
+			}
+		}
+		else if (type == SPAWN)
+		{
+			std::string objectType, objectId, ownerId;
+			ParameterTable objectParams;
+			ParameterTableMap componentsParams;
+			unsigned int numComponents;
+			RETURN_ON_COND(
+					(not doReadString(objectType)) or (not doReadString(objectId))
+							or (not doReadParams(objectParams))
+							or (not doReadUInt(numComponents)), false)
+
+			for (unsigned int i = 0; i < numComponents; ++i)
+			{
+				std::string componentType;
+				RETURN_ON_COND(not doReadString(componentType), false)
+				RETURN_ON_COND(not doReadParams(componentsParams[componentType]),
+						false)
+			}
+			RETURN_ON_COND(mPos >= mData.size(), false)
+
+			bool storeParams = (mData[mPos++] != 0);
+			RETURN_ON_COND(not doReadString(ownerId), false)
+
+			ObjectTemplateManager* objectTmplMgr =
+					ObjectTemplateManager::GetSingletonPtr();
+			SMARTPTR(Object) owner;
+			if (not ownerId.empty())
+			{
+				owner = objectTmplMgr->getCreatedObject(ownerId);
+			}
+			mApplying = true;
+			objectTmplMgr->createObject(objectType, objectId, objectParams,
+					componentsParams, storeParams, owner);
+			mApplying = false;
+		}
+		else if (type == DESTROY)
+		{
+			std::string objectId;
+			RETURN_ON_COND(not doReadString(objectId), false)
+
+			mApplying = true;
+			ObjectTemplateManager::GetSingletonPtr()->destroyObject(objectId);
+			mApplying = false;
+		}
+		else
+		{
+			//corrupted stream
+			PRINT_ERR_DEBUG("Replay: unknown record type " << (int) type);
+			mPos = mData.size();
+			return false;
+		}
+	}
+	return true;
+}
+
+void Replay::doWriteUInt(unsigned int value)
+{
+	//little endian
+	for (int i = 0; i < 4; ++i)
+	{
+		mBuffer.push_back((char) ((value >> (8 * i)) & 0xFF));
+	}
+}
+
+void Replay::doWriteFloat(float value)
+{
+	unsigned int bits;
+	memcpy(&bits, &value, sizeof(bits));
+	doWriteUInt(bits);
+}
+
+void Replay::doWriteString(const std::string& value)
+{
+	doWriteUInt(value.size());
+	mBuffer.append(value);
+}
+
+void Replay::doWriteParams(const ParameterTable& params)
+{
+	doWriteUInt(params.size());
+	ParameterTable::const_iterator iter;
+	for (iter = params.begin(); iter != params.end(); ++iter)
+	{
+		doWriteString(iter->first);
+		doWriteString(iter->second);
+	}
+}
+
+bool Replay::doReadUInt(unsigned int& value)
+{
+	RETURN_ON_COND(mData.size() - mPos < 4, false)
+
+	value = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		value |= ((unsigned int) (unsigned char) mData[mPos++]) << (8 * i);
+	}
+	return true;
+}
+
+bool Replay::doReadFloat(float& value)
+{
+	unsigned int bits;
+	RETURN_ON_COND(not doReadUInt(bits), false)
+
+	memcpy(&value, &bits, sizeof(value));
+	return true;
+}
+
+bool Replay::doReadString(std::string& value)
+{
+	unsigned int size;
+	RETURN_ON_COND(not doReadUInt(size), false)
+	RETURN_ON_COND(mData.size() - mPos < size, false)
+
+	value.assign(mData, mPos, size);
+	mPos += size;
+	return true;
+}
+
+bool Replay::doReadParams(ParameterTable& params)
+{
+	unsigned int size;
+	RETURN_ON_COND(not doReadUInt(size), false)
+
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		std::string name, value;
+		RETURN_ON_COND((not doReadString(name)) or (not doReadString(value)),
+				false)
+
+		params.insert(ParameterNameValue(name, value));
+	}
+	return true;
+}
+
+} // namespace ely
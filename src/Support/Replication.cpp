@@ -0,0 +1,740 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/Support/Replication.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "Support/Replication.h"
+#include "Support/InterestGrid.h"
+#include "ObjectModel/ObjectTemplateManager.h"
+#include "AIComponents/CrowdAgent.h"
+#include "BehaviorComponents/Activity.h"
+#include <asyncTaskManager.h>
+#include <netDatagram.h>
+#include <trueClock.h>
+#include <sstream>
+#include <cmath>
+#include <set>
+
+namespace
+{
+///Acknowledgment size: type, sequence and viewpoint.
+const unsigned int ACK_SIZE = 1 + 4 + 3 * 4;
+///Snapshot header size: type, sequence, baseline sequence, time, part and
+///number of parts.
+const unsigned int SNAPSHOT_HEADER_SIZE = 1 + 4 + 4 + 8 + 2 + 2;
+///Snapshot datagram size: the max UDP payload and a sensible minimum.
+const unsigned int MAX_DATAGRAM_SIZE = 65507;
+const unsigned int MIN_DATAGRAM_SIZE = 256;
+
+double getTime()
+{
+	return TrueClock::get_global_ptr()->get_short_time();
+}
+
+int quantize(float value, float step)
+{
+	return static_cast<int>(floor(value / step + 0.5));
+}
+
+///Angle into [-180, 180).
+float normalizeAngle(float angle)
+{
+	angle = fmod(angle + 180.0f, 360.0f);
+	return (angle < 0.0 ? angle + 360.0f : angle) - 180.0f;
+}
+}
+
+namespace ely
+{
+
+Replication::Settings::Settings() :
+		mPort(9099), mServerHost("localhost"), mClientPort(0), mSendRate(20.0),
+		mRelevanceRadius(0.0), mPositionStep(0.01), mAngleStep(0.5),
+		mVelocityStep(0.01), mInterpolationDelay(0.1), mHistory(32),
+		mClientTimeout(5.0), mMaxPacketSize(1400)
+{
+}
+
+Replication::RateWindow::RateWindow() :
+		mBytes(0), mStart(0.0), mRate(0.0)
+{
+}
+
+void Replication::RateWindow::add(unsigned int bytes, double now)
+{
+	if (now - mStart >= 1.0)
+	{
+		mRate = mBytes / (now - mStart);
+		mBytes = 0;
+		mStart = now;
+	}
+	mBytes += bytes;
+}
+
+Replication::Replication(Mode mode, const Settings& settings, int sort,
+		int priority) :
+		mMode(mode), mSettings(settings), mStarted(false), mSendTime(0.0),
+		mReader(&mManager, 0), mWriter(&mManager, 0), mNextNetId(1),
+		mViewpoint(LPoint3f::zero()), mLastSequence(0), mPartsSequence(0),
+		mNumPartsReceived(0), mServerTimeOffset(0.0), mHasServerTime(false), mSort(sort),
+		mPriority(priority)
+{
+	mSettings.mSendRate = (mSettings.mSendRate > 0.0 ? mSettings.mSendRate : 20.0);
+	mSettings.mPositionStep = (
+			mSettings.mPositionStep > 0.0 ? mSettings.mPositionStep : 0.01);
+	mSettings.mAngleStep = (mSettings.mAngleStep > 0.0 ? mSettings.mAngleStep : 0.5);
+	mSettings.mVelocityStep = (
+			mSettings.mVelocityStep > 0.0 ? mSettings.mVelocityStep : 0.01);
+	mSettings.mHistory = (mSettings.mHistory > 0 ? mSettings.mHistory : 1);
+	mSettings.mMaxPacketSize = (
+			mSettings.mMaxPacketSize < MAX_DATAGRAM_SIZE ?
+					mSettings.mMaxPacketSize : MAX_DATAGRAM_SIZE);
+	mSettings.mMaxPacketSize = (
+			mSettings.mMaxPacketSize > MIN_DATAGRAM_SIZE ?
+					mSettings.mMaxPacketSize : MIN_DATAGRAM_SIZE);
+	mStats.mBytesSent = mStats.mBytesReceived = mStats.mPacketsSent =
+			mStats.mPacketsReceived = mStats.mPacketsDropped = 0;
+	mStats.mBytesPerSecondSent = mStats.mBytesPerSecondReceived = 0.0;
+	mStats.mObjects = mStats.mClients = 0;
+}
+
+Replication::~Replication()
+{
+	if (mUpdateTask)
+	{
+		AsyncTaskManager::get_global_ptr()->remove(mUpdateTask);
+	}
+	if (mConnection)
+	{
+		mReader.remove_connection(mConnection);
+		mManager.close_connection(mConnection);
+	}
+}
+
+bool Replication::start()
+{
+	RETURN_ON_COND(mStarted, true)
+
+	if (mMode == CLIENT)
+	{
+		RETURN_ON_COND(
+				not mServerAddress.set_host(mSettings.mServerHost, mSettings.mPort),
+				false)
+	}
+	mConnection = mManager.open_UDP_connection(
+			mMode == SERVER ? mSettings.mPort : mSettings.mClientPort);
+	RETURN_ON_COND(not mConnection, false)
+
+	mReader.add_connection(mConnection);
+	//create the task for the updates
+	mUpdateData = new TaskInterface<Replication>::TaskData(this,
+			&Replication::update);
+	mUpdateTask = new GenericAsyncTask("Replication::update",
+			&TaskInterface<Replication>::taskFunction,
+			reinterpret_cast<void*>(mUpdateData.p()));
+	//set sort/priority
+	mUpdateTask->set_sort(mSort);
+	mUpdateTask->set_priority(mPriority);
+	//Adds mUpdateTask to the active queue.
+	AsyncTaskManager::get_global_ptr()->add(mUpdateTask);
+	mStarted = true;
+	return true;
+}
+
+void Replication::addObject(const ObjectId& objectId, unsigned int fields)
+{
+	std::map<ObjectId, ReplicatedObject>::iterator iter = mObjects.find(
+			objectId);
+	if (iter != mObjects.end())
+	{
+		iter->second.mFields = fields;
+		return;
+	}
+	ReplicatedObject object;
+	object.mNetId = mNextNetId++;
+	object.mFields = fields;
+	mObjects[objectId] = object;
+}
+
+void Replication::removeObject(const ObjectId& objectId)
+{
+	mObjects.erase(objectId);
+}
+
+bool Replication::getObjectState(const ObjectId& objectId, LPoint3f& pos,
+		LVecBase3f& hpr, LVector3f& velocity, std::string& fsmState) const
+{
+	std::map<ObjectId, Interpolated>::const_iterator iter =
+			mInterpolated.find(objectId);
+	RETURN_ON_COND(iter == mInterpolated.end(), false)
+
+	pos = iter->second.mPos;
+	hpr = iter->second.mHpr;
+	velocity = iter->second.mVelocity;
+	fsmState = iter->second.mFSMState;
+	return true;
+}
+
+AsyncTask::DoneStatus Replication::update(GenericAsyncTask* task)
+{
+	double now = getTime();
+	bool sendTime = (now - mSendTime >= 1.0 / mSettings.mSendRate);
+	if (sendTime)
+	{
+		mSendTime = now;
+	}
+	if (mMode == SERVER)
+	{
+		doServerReceive(now);
+		if (sendTime)
+		{
+			doServerSend(now);
+		}
+	}
+	else
+	{
+		doClientReceive(now);
+		if (sendTime)
+		{
+			doClientSend(now);
+		}
+		doClientInterpolate(now);
+	}
+	//statistics
+	mSentRate.add(0, now);
+	mReceivedRate.add(0, now);
+	mStats.mBytesPerSecondSent = mSentRate.mRate;
+	mStats.mBytesPerSecondReceived = mReceivedRate.mRate;
+	mStats.mObjects = (mMode == SERVER ? mObjects.size() : mInterpolated.size());
+	mStats.mClients = mClients.size();
+	//
+	return AsyncTask::DS_cont;
+}
+
+std::vector<Replication::ClientStats> Replication::getClientStats() const
+{
+	std::vector<ClientStats> clientStats;
+	std::map<std::string, Client>::const_iterator iter;
+	for (iter = mClients.begin(); iter != mClients.end(); ++iter)
+	{
+		clientStats.push_back(iter->second.mStats);
+	}
+	return clientStats;
+}
+
+bool Replication::doSend(const Datagram& dg, const NetAddress& address,
+		double now)
+{
+	if (not mWriter.send(dg, mConnection, address))
+	{
+		++mStats.mPacketsDropped;
+		return false;
+	}
+	mStats.mBytesSent += dg.get_length();
+	++mStats.mPacketsSent;
+	mSentRate.add(dg.get_length(), now);
+	return true;
+}
+
+void Replication::doServerReceive(double now)
+{
+	while (mReader.data_available())
+	{
+		NetDatagram datagram;
+		if (not mReader.get_data(datagram))
+		{
+			break;
+		}
+		mStats.mBytesReceived += datagram.get_length();
+		++mStats.mPacketsReceived;
+		mReceivedRate.add(datagram.get_length(), now);
+		DatagramIterator scan(datagram);
+		if ((scan.get_remaining_size() < ACK_SIZE) or (scan.get_uint8() != ACK))
+		{
+			++mStats.mPacketsDropped;
+			continue;
+		}
+		//the client: by address
+		const NetAddress& address = datagram.get_address();
+		std::ostringstream key;
+		key << address.get_ip_string() << ":" << address.get_port();
+		std::map<std::string, Client>::iterator iter = mClients.find(key.str());
+		if (iter == mClients.end())
+		{
+			Client client;
+			client.mAddress = address;
+			client.mSequence = client.mAckSequence = 0;
+			client.mStats.mAddress = key.str();
+			client.mStats.mBytesSent = client.mStats.mSnapshots = 0;
+			client.mStats.mBytesPerSecond = 0.0;
+			client.mStats.mRelevantObjects = client.mStats.mLastSnapshotSize = 0;
+			iter = mClients.insert(std::make_pair(key.str(), client)).first;
+			PRINT_DEBUG("Replication: new client " << key.str());
+		}
+		Client& client = iter->second;
+		//acknowledgments may arrive out of order
+		unsigned int ackSequence = scan.get_uint32();
+		if (ackSequence > client.mAckSequence)
+		{
+			client.mAckSequence = ackSequence;
+		}
+		float x = scan.get_float32();
+		float y = scan.get_float32();
+		float z = scan.get_float32();
+		client.mViewpoint = LPoint3f(x, y, z);
+		client.mLastHeard = now;
+	}
+	//drop the silent clients
+	std::map<std::string, Client>::iterator iter = mClients.begin();
+	while (iter != mClients.end())
+	{
+		if (now - iter->second.mLastHeard > mSettings.mClientTimeout)
+		{
+			PRINT_DEBUG("Replication: dropped client " << iter->first);
+			mClients.erase(iter++);
+		}
+		else
+		{
+			++iter;
+		}
+	}
+}
+
+void Replication::doServerSend(double now)
+{
+	RETURN_ON_COND(mClients.empty(),)
+
+	//the current state of the replicated Objects
+	ObjectTemplateManager* objectTmplMgr =
+			ObjectTemplateManager::GetSingletonPtr();
+	EntityStates current, untransformed;
+	std::map<ObjectId, ReplicatedObject>::const_iterator objectIter;
+	for (objectIter = mObjects.begin(); objectIter != mObjects.end();
+			++objectIter)
+	{
+		SMARTPTR(Object) object = objectTmplMgr->getCreatedObject(
+				objectIter->first);
+		if (object)
+		{
+			EntityState& state = current[objectIter->second.mNetId];
+			state = doQuantize(object, objectIter->second.mFields);
+			if (not (state.mFields & TRANSFORM))
+			{
+				untransformed[objectIter->second.mNetId] = state;
+			}
+		}
+	}
+	float radius = mSettings.mRelevanceRadius;
+	InterestGrid* interestGrid = InterestGrid::GetSingletonPtr();
+	std::vector<ObjectId> nearIds;
+	std::vector<Datagram> parts;
+	std::map<std::string, Client>::iterator iter;
+	for (iter = mClients.begin(); iter != mClients.end(); ++iter)
+	{
+		Client& client = iter->second;
+		//the Objects relevant to the client (those without transform are)
+		EntityStates relevant;
+		EntityStates::const_iterator stateIter;
+		if ((radius > 0.0) and interestGrid)
+		{
+			//only visit the Objects near the viewpoint
+			relevant = untransformed;
+			nearIds.clear();
+			interestGrid->queryRadius(client.mViewpoint, radius, nearIds);
+			std::vector<ObjectId>::const_iterator idIter;
+			for (idIter = nearIds.begin(); idIter != nearIds.end(); ++idIter)
+			{
+				objectIter = mObjects.find(*idIter);
+				if (objectIter == mObjects.end())
+				{
+					continue;
+				}
+				stateIter = current.find(objectIter->second.mNetId);
+				if ((stateIter != current.end())
+						and (stateIter->second.mFields & TRANSFORM)
+						and doIsNear(stateIter->second, client.mViewpoint,
+								radius))
+				{
+					relevant.insert(*stateIter);
+				}
+			}
+		}
+		else
+		{
+			for (stateIter = current.begin(); stateIter != current.end();
+					++stateIter)
+			{
+				const EntityState& state = stateIter->second;
+				if ((radius > 0.0) and (state.mFields & TRANSFORM)
+						and (not doIsNear(state, client.mViewpoint, radius)))
+				{
+					continue;
+				}
+				relevant.insert(*stateIter);
+			}
+		}
+		//the baseline: the last acknowledged snapshot (older ones are useless)
+		while ((not client.mHistory.empty())
+				and (client.mHistory.front().first < client.mAckSequence))
+		{
+			client.mHistory.pop_front();
+		}
+		EntityStates none;
+		const EntityStates* baseline = &none;
+		unsigned int baselineSequence = 0;
+		if ((not client.mHistory.empty())
+				and (client.mHistory.front().first == client.mAckSequence))
+		{
+			baseline = &client.mHistory.front().second;
+			baselineSequence = client.mAckSequence;
+		}
+		//the snapshot: split in datagrams of at most the max packet size
+		writeDelta(*baseline, relevant, parts,
+				mSettings.mMaxPacketSize - SNAPSHOT_HEADER_SIZE);
+		++client.mSequence;
+		if (parts.size() > 0xFFFF)
+		{
+			PRINT_ERR_DEBUG("Replication: snapshot too big for client "
+					<< iter->first << " (" << parts.size() << " parts)");
+			parts.clear();
+		}
+		unsigned int snapshotSize = 0;
+		for (unsigned int p = 0; p < parts.size(); ++p)
+		{
+			Datagram dg;
+			dg.add_uint8(SNAPSHOT);
+			dg.add_uint32(client.mSequence);
+			dg.add_uint32(baselineSequence);
+			dg.add_float64(now);
+			dg.add_uint16(p);
+			dg.add_uint16(parts.size());
+			dg.append_data(parts[p].get_data(), parts[p].get_length());
+			if (doSend(dg, client.mAddress, now))
+			{
+				client.mStats.mBytesSent += dg.get_length();
+				client.mRate.add(dg.get_length(), now);
+			}
+			snapshotSize += dg.get_length();
+		}
+		++client.mStats.mSnapshots;
+		client.mStats.mLastSnapshotSize = snapshotSize;
+		client.mStats.mRelevantObjects = relevant.size();
+		client.mRate.add(0, now);
+		client.mStats.mBytesPerSecond = client.mRate.mRate;
+		//keep it as a possible baseline
+		client.mHistory.push_back(std::make_pair(client.mSequence, relevant));
+		while (client.mHistory.size() > mSettings.mHistory)
+		{
+			client.mHistory.pop_front();
+		}
+	}
+}
+
+bool Replication::doIsNear(const EntityState& state,
+		const LPoint3f& viewpoint, float radius) const
+{
+	LVector3f distance = LPoint3f(state.mPos[0] * mSettings.mPositionStep,
+			state.mPos[1] * mSettings.mPositionStep,
+			state.mPos[2] * mSettings.mPositionStep) - viewpoint;
+	return distance.length_squared() <= radius * radius;
+}
+
+Replication::EntityState Replication::doQuantize(SMARTPTR(Object) object,
+		unsigned int fields) const
+{
+	EntityState state;
+	state.mObjectId = object->objectId();
+	state.mObjectType = object->objectTmpl()->objectType();
+	state.mFields = fields;
+	NodePath nodePath = object->getNodePath();
+	if ((fields & TRANSFORM) and (not nodePath.is_empty()))
+	{
+		LPoint3f pos = nodePath.get_pos(nodePath.get_top());
+		LVecBase3f hpr = nodePath.get_hpr(nodePath.get_top());
+		for (int i = 0; i < 3; ++i)
+		{
+			state.mPos[i] = quantize(pos[i], mSettings.mPositionStep);
+			state.mHpr[i] = quantize(normalizeAngle(hpr[i]),
+					mSettings.mAngleStep);
+		}
+	}
+	if (fields & VELOCITY)
+	{
+		SMARTPTR(Component) component = object->getComponent(
+				ComponentType("CrowdAgent"));
+		if (component)
+		{
+			LVector3f velocity = DCAST(CrowdAgent, component)->getMoveVelocity();
+			for (int i = 0; i < 3; ++i)
+			{
+				state.mVelocity[i] = quantize(velocity[i],
+						mSettings.mVelocityStep);
+			}
+		}
+	}
+	if (fields & FSM_STATE)
+	{
+		SMARTPTR(Component) component = object->getComponent(
+				ComponentType("Activity"));
+		if (component)
+		{
+			state.mFSMState = DCAST(Activity, component)->getCurrentState();
+		}
+	}
+	return state;
+}
+
+void Replication::doClientReceive(double now)
+{
+	while (mReader.data_available())
+	{
+		NetDatagram datagram;
+		if (not mReader.get_data(datagram))
+		{
+			break;
+		}
+		mStats.mBytesReceived += datagram.get_length();
+		++mStats.mPacketsReceived;
+		mReceivedRate.add(datagram.get_length(), now);
+		DatagramIterator scan(datagram);
+		if ((scan.get_remaining_size() < SNAPSHOT_HEADER_SIZE)
+				or (scan.get_uint8() != SNAPSHOT))
+		{
+			++mStats.mPacketsDropped;
+			continue;
+		}
+		unsigned int sequence = scan.get_uint32();
+		scan.skip_bytes(4 + 8);
+		unsigned int part = scan.get_uint16();
+		unsigned int numParts = scan.get_uint16();
+		//old (out of order) snapshot, or a part of an abandoned one
+		if ((sequence <= mLastSequence) or (sequence < mPartsSequence)
+				or (part >= numParts))
+		{
+			++mStats.mPacketsDropped;
+			continue;
+		}
+		//a newer snapshot: the incomplete one is abandoned
+		if (sequence > mPartsSequence)
+		{
+			mStats.mPacketsDropped += mNumPartsReceived;
+			mPartsSequence = sequence;
+			mParts.assign(numParts, NetDatagram());
+			mNumPartsReceived = 0;
+		}
+		//inconsistent or duplicated part
+		if ((numParts != mParts.size()) or (mParts[part].get_length() > 0))
+		{
+			++mStats.mPacketsDropped;
+			continue;
+		}
+		mParts[part] = datagram;
+		if (++mNumPartsReceived < mParts.size())
+		{
+			continue;
+		}
+		//all the parts: the snapshot
+		if (not doClientSnapshot(now))
+		{
+			mStats.mPacketsDropped += mNumPartsReceived;
+		}
+		mParts.clear();
+		mNumPartsReceived = 0;
+	}
+}
+
+bool Replication::doClientSnapshot(double now)
+{
+	DatagramIterator scan(mParts.front(), 1 + 4);
+	unsigned int baselineSequence = scan.get_uint32();
+	double serverTime = scan.get_float64();
+	//the baseline (older ones are useless)
+	while ((not mHistory.empty())
+			and (mHistory.front().first < baselineSequence))
+	{
+		mHistory.pop_front();
+	}
+	EntityStates states;
+	if (baselineSequence != 0)
+	{
+		RETURN_ON_COND(
+				mHistory.empty() or (mHistory.front().first != baselineSequence),
+				false)
+
+		states = mHistory.front().second;
+	}
+	//the parts in order
+	for (unsigned int p = 0; p < mParts.size(); ++p)
+	{
+		DatagramIterator partScan(mParts[p], SNAPSHOT_HEADER_SIZE);
+		RETURN_ON_COND(not applyDelta(partScan, states), false)
+	}
+	mLastSequence = mPartsSequence;
+	//server clock offset: smoothed
+	double offset = serverTime - now;
+	mServerTimeOffset = (
+			mHasServerTime ?
+					mServerTimeOffset + 0.1 * (offset - mServerTimeOffset) :
+					offset);
+	mHasServerTime = true;
+	//interpolation samples
+	std::set<ObjectId> present;
+	EntityStates::const_iterator stateIter;
+	for (stateIter = states.begin(); stateIter != states.end(); ++stateIter)
+	{
+		const EntityState& state = stateIter->second;
+		present.insert(state.mObjectId);
+		std::map<ObjectId, Interpolated>::iterator iter = mInterpolated.find(
+				state.mObjectId);
+		if (iter == mInterpolated.end())
+		{
+			Interpolated interpolated;
+			interpolated.mPos = LPoint3f::zero();
+			interpolated.mHpr = LVecBase3f::zero();
+			interpolated.mVelocity = LVector3f::zero();
+			interpolated.mCreated = false;
+			iter = mInterpolated.insert(
+					std::make_pair(state.mObjectId, interpolated)).first;
+		}
+		Sample sample;
+		sample.mTime = serverTime;
+		sample.mState = state;
+		iter->second.mSamples.push_back(sample);
+	}
+	//no longer replicated (or relevant)
+	std::map<ObjectId, Interpolated>::iterator iter = mInterpolated.begin();
+	while (iter != mInterpolated.end())
+	{
+		if (present.find(iter->first) == present.end())
+		{
+			if (iter->second.mCreated)
+			{
+				ObjectTemplateManager::GetSingletonPtr()->destroyObject(
+						iter->first);
+			}
+			mInterpolated.erase(iter++);
+		}
+		else
+		{
+			++iter;
+		}
+	}
+	//keep it as a possible baseline
+	mHistory.push_back(std::make_pair(mPartsSequence, states));
+	while (mHistory.size() > mSettings.mHistory)
+	{
+		mHistory.pop_front();
+	}
+	return true;
+}
+
+void Replication::doClientSend(double now)
+{
+	Datagram dg;
+	dg.add_uint8(ACK);
+	dg.add_uint32(mLastSequence);
+	dg.add_float32(mViewpoint.get_x());
+	dg.add_float32(mViewpoint.get_y());
+	dg.add_float32(mViewpoint.get_z());
+	doSend(dg, mServerAddress, now);
+}
+
+void Replication::doClientInterpolate(double now)
+{
+	RETURN_ON_COND(not mHasServerTime,)
+
+	double renderTime = now + mServerTimeOffset - mSettings.mInterpolationDelay;
+	std::map<ObjectId, Interpolated>::iterator iter;
+	for (iter = mInterpolated.begin(); iter != mInterpolated.end(); ++iter)
+	{
+		std::deque<Sample>& samples = iter->second.mSamples;
+		//keep the last sample before the render time
+		while ((samples.size() >= 2) and (samples[1].mTime <= renderTime))
+		{
+			samples.pop_front();
+		}
+		if (samples.empty())
+		{
+			continue;
+		}
+		//interpolate between it and the next one (if any)
+		const EntityState& first = samples.front().mState;
+		const EntityState* second = &first;
+		float t = 0.0;
+		if ((samples.size() >= 2) and (renderTime > samples.front().mTime))
+		{
+			second = &samples[1].mState;
+			t = (renderTime - samples.front().mTime)
+					/ (samples[1].mTime - samples.front().mTime);
+			t = (t > 1.0 ? 1.0 : t);
+		}
+		Interpolated& interpolated = iter->second;
+		for (int i = 0; i < 3; ++i)
+		{
+			interpolated.mPos[i] = (first.mPos[i]
+					+ (second->mPos[i] - first.mPos[i]) * t)
+					* mSettings.mPositionStep;
+			//angles: the shortest way
+			float angle = first.mHpr[i] * mSettings.mAngleStep;
+			float delta = normalizeAngle(
+					second->mHpr[i] * mSettings.mAngleStep - angle);
+			interpolated.mHpr[i] = angle + delta * t;
+			interpolated.mVelocity[i] = (first.mVelocity[i]
+					+ (second->mVelocity[i] - first.mVelocity[i]) * t)
+					* mSettings.mVelocityStep;
+		}
+		interpolated.mFSMState = (t < 1.0 ? first : *second).mFSMState;
+		doApply(iter->first, interpolated, first.mFields, first.mObjectType);
+	}
+}
+
+void Replication::doApply(const ObjectId& objectId,
+		Interpolated& interpolated, unsigned int fields,
+		const std::string& objectType)
+{
+	ObjectTemplateManager* objectTmplMgr =
+			ObjectTemplateManager::GetSingletonPtr();
+	SMARTPTR(Object) object = objectTmplMgr->getCreatedObject(objectId);
+	if (not object)
+	{
+		object = objectTmplMgr->createObject(objectType, objectId);
+		RETURN_ON_COND(not object,)
+
+		interpolated.mCreated = true;
+	}
+	NodePath nodePath = object->getNodePath();
+	if ((fields & TRANSFORM) and (not nodePath.is_empty()))
+	{
+		nodePath.set_pos(nodePath.get_top(), interpolated.mPos);
+		nodePath.set_hpr(nodePath.get_top(), interpolated.mHpr);
+	}
+	if (fields & FSM_STATE)
+	{
+		SMARTPTR(Component) component = object->getComponent(
+				ComponentType("Activity"));
+		if (component)
+		{
+			DCAST(Activity, component)->forceState(interpolated.mFSMState);
+		}
+	}
+}
+
+} // namespace ely
@@ -0,0 +1,303 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/Support/ReplicationCodec.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "Support/ReplicationCodec.h"
+
+namespace
+{
+using namespace ely;
+
+///Snapshot entry flags.
+enum EntryFlag
+{
+	ENTRY_REMOVED = 1 << 0,
+	ENTRY_IDENTITY = 1 << 1,
+	ENTRY_POS = 1 << 2,
+	ENTRY_HPR = 1 << 3,
+	ENTRY_VELOCITY = 1 << 4,
+	ENTRY_FSM_STATE = 1 << 5
+};
+
+///Entries' count size.
+const unsigned int COUNT_SIZE = 4;
+
+///Signed values: zigzag, then 7 bits per byte.
+void writeVarInt(Datagram& dg, int value)
+{
+	unsigned int zigzag = (static_cast<unsigned int>(value) << 1)
+			^ static_cast<unsigned int>(value >> 31);
+	while (zigzag >= 0x80)
+	{
+		dg.add_uint8((zigzag & 0x7F) | 0x80);
+		zigzag >>= 7;
+	}
+	dg.add_uint8(zigzag);
+}
+
+bool readVarInt(DatagramIterator& scan, int& value)
+{
+	unsigned int zigzag = 0;
+	for (int shift = 0; shift < 35; shift += 7)
+	{
+		RETURN_ON_COND(scan.get_remaining_size() < 1, false)
+
+		unsigned int byte = scan.get_uint8();
+		zigzag |= (byte & 0x7F) << shift;
+		if (not (byte & 0x80))
+		{
+			value = static_cast<int>(zigzag >> 1)
+					^ -static_cast<int>(zigzag & 1);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool equal3(const int* first, const int* second)
+{
+	return (first[0] == second[0]) and (first[1] == second[1])
+			and (first[2] == second[2]);
+}
+
+void writeDelta3(Datagram& dg, const int* values, const int* base)
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		writeVarInt(dg, values[i] - (base ? base[i] : 0));
+	}
+}
+
+bool readDelta3(DatagramIterator& scan, int* values)
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		int delta;
+		RETURN_ON_COND(not readVarInt(scan, delta), false)
+
+		values[i] += delta;
+	}
+	return true;
+}
+
+///Writes the entry of a state against its base, if changed.
+bool writeEntry(unsigned int netId, const ReplicationCodec::EntityState& state,
+		const ReplicationCodec::EntityStates& baseline, Datagram& entry)
+{
+	ReplicationCodec::EntityStates::const_iterator baseIter = baseline.find(
+			netId);
+	//a full entry if there is no base or the fields changed
+	const ReplicationCodec::EntityState* base = (
+			baseIter != baseline.end() ? &baseIter->second : NULL);
+	if (base and (base->mFields != state.mFields))
+	{
+		base = NULL;
+	}
+	unsigned char flags = (base ? 0 : ENTRY_IDENTITY);
+	if (state.mFields & ReplicationCodec::TRANSFORM)
+	{
+		flags |= ((not base) or (not equal3(base->mPos, state.mPos)) ?
+				ENTRY_POS : 0);
+		flags |= ((not base) or (not equal3(base->mHpr, state.mHpr)) ?
+				ENTRY_HPR : 0);
+	}
+	if (state.mFields & ReplicationCodec::VELOCITY)
+	{
+		flags |= ((not base)
+				or (not equal3(base->mVelocity, state.mVelocity)) ?
+				ENTRY_VELOCITY : 0);
+	}
+	if (state.mFields & ReplicationCodec::FSM_STATE)
+	{
+		flags |= ((not base) or (base->mFSMState != state.mFSMState) ?
+				ENTRY_FSM_STATE : 0);
+	}
+	//unchanged: omitted
+	RETURN_ON_COND(flags == 0, false)
+
+	writeVarInt(entry, netId);
+	entry.add_uint8(flags);
+	if (flags & ENTRY_IDENTITY)
+	{
+		entry.add_string(state.mObjectId);
+		entry.add_string(state.mObjectType);
+		entry.add_uint8(state.mFields);
+	}
+	if (flags & ENTRY_POS)
+	{
+		writeDelta3(entry, state.mPos, base ? base->mPos : NULL);
+	}
+	if (flags & ENTRY_HPR)
+	{
+		writeDelta3(entry, state.mHpr, base ? base->mHpr : NULL);
+	}
+	if (flags & ENTRY_VELOCITY)
+	{
+		writeDelta3(entry, state.mVelocity, base ? base->mVelocity : NULL);
+	}
+	if (flags & ENTRY_FSM_STATE)
+	{
+		entry.add_string(state.mFSMState);
+	}
+	return true;
+}
+
+///Collects the entries into parts of at most maxPartSize bytes.
+class PartWriter
+{
+public:
+	PartWriter(std::vector<Datagram>& parts, unsigned int maxPartSize) :
+			mParts(parts), mMaxPartSize(maxPartSize), mNumEntries(0)
+	{
+	}
+	void add(const Datagram& entry)
+	{
+		if ((mNumEntries > 0)
+				and (COUNT_SIZE + mEntries.get_length() + entry.get_length()
+						> mMaxPartSize))
+		{
+			flush();
+		}
+		mEntries.append_data(entry.get_data(), entry.get_length());
+		++mNumEntries;
+	}
+	///Writes the last part (an empty one if there are none).
+	void flush()
+	{
+		mParts.push_back(Datagram());
+		mParts.back().add_uint32(mNumEntries);
+		mParts.back().append_data(mEntries.get_data(), mEntries.get_length());
+		mEntries.clear();
+		mNumEntries = 0;
+	}
+private:
+	std::vector<Datagram>& mParts;
+	unsigned int mMaxPartSize, mNumEntries;
+	Datagram mEntries;
+};
+}
+
+namespace ely
+{
+
+ReplicationCodec::EntityState::EntityState() :
+		mFields(0)
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		mPos[i] = mHpr[i] = mVelocity[i] = 0;
+	}
+}
+
+void ReplicationCodec::writeDelta(const EntityStates& baseline,
+		const EntityStates& states, Datagram& dg)
+{
+	std::vector<Datagram> parts;
+	writeDelta(baseline, states, parts, 0xFFFFFFFF);
+	dg.append_data(parts.front().get_data(), parts.front().get_length());
+}
+
+bool ReplicationCodec::readDelta(const EntityStates& baseline,
+		DatagramIterator& scan, EntityStates& states)
+{
+	states = baseline;
+	return applyDelta(scan, states);
+}
+
+void ReplicationCodec::writeDelta(const EntityStates& baseline,
+		const EntityStates& states, std::vector<Datagram>& parts,
+		unsigned int maxPartSize)
+{
+	parts.clear();
+	PartWriter writer(parts, maxPartSize);
+	Datagram entry;
+	EntityStates::const_iterator iter;
+	for (iter = states.begin(); iter != states.end(); ++iter)
+	{
+		entry.clear();
+		if (writeEntry(iter->first, iter->second, baseline, entry))
+		{
+			writer.add(entry);
+		}
+	}
+	//no longer present: removed
+	for (iter = baseline.begin(); iter != baseline.end(); ++iter)
+	{
+		if (states.find(iter->first) == states.end())
+		{
+			entry.clear();
+			writeVarInt(entry, iter->first);
+			entry.add_uint8(ENTRY_REMOVED);
+			writer.add(entry);
+		}
+	}
+	writer.flush();
+}
+
+bool ReplicationCodec::applyDelta(DatagramIterator& scan, EntityStates& states)
+{
+	RETURN_ON_COND(scan.get_remaining_size() < COUNT_SIZE, false)
+
+	unsigned int numEntries = scan.get_uint32();
+	for (unsigned int e = 0; e < numEntries; ++e)
+	{
+		int netId;
+		RETURN_ON_COND(not readVarInt(scan, netId), false)
+		RETURN_ON_COND(scan.get_remaining_size() < 1, false)
+
+		unsigned char flags = scan.get_uint8();
+		if (flags & ENTRY_REMOVED)
+		{
+			states.erase(netId);
+			continue;
+		}
+		EntityStates::iterator iter = states.find(netId);
+		if (flags & ENTRY_IDENTITY)
+		{
+			EntityState& state = states[netId];
+			state = EntityState();
+			state.mObjectId = scan.get_string();
+			state.mObjectType = scan.get_string();
+			state.mFields = scan.get_uint8();
+			iter = states.find(netId);
+		}
+		//a delta needs its base
+		RETURN_ON_COND(iter == states.end(), false)
+
+		EntityState& state = iter->second;
+		RETURN_ON_COND((flags & ENTRY_POS) and (not readDelta3(scan, state.mPos)),
+				false)
+		RETURN_ON_COND((flags & ENTRY_HPR) and (not readDelta3(scan, state.mHpr)),
+				false)
+		RETURN_ON_COND(
+				(flags & ENTRY_VELOCITY) and (not readDelta3(scan, state.mVelocity)),
+				false)
+
+		if (flags & ENTRY_FSM_STATE)
+		{
+			state.mFSMState = scan.get_string();
+		}
+	}
+	return true;
+}
+
+} // namespace ely
@@ -0,0 +1,506 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/Support/Snapshot.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "Support/Snapshot.h"
+#include "ObjectModel/ObjectTemplateManager.h"
+#include <asyncTaskManager.h>
+#include <trueClock.h>
+#include <mutexHolder.h>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+///File header: magic and version.
+const char MAGIC[4] =
+{ 'E', 'L', 'Y', 'S' };
+const unsigned int VERSION = 2;
+
+///Chunk kinds.
+enum ChunkKind
+{
+	FULL = 1, DELTA
+};
+
+double getTime()
+{
+	return TrueClock::get_global_ptr()->get_short_time();
+}
+}
+
+namespace ely
+{
+
+Snapshot::Snapshot(const std::string& name) :
+		mName(name)
+{
+	mStats.mRecords = mStats.mChunks = mStats.mErrors = mStats.mUnrestorable =
+			0;
+	mStats.mSavedBytes = 0;
+	mStats.mTakeTime = mStats.mRestoreTime = 0.0;
+	//one worker thread: chunks are written in order
+	mTaskChainName = name + "-saveChain";
+	AsyncTaskChain* taskChain =
+			AsyncTaskManager::get_global_ptr()->make_task_chain(
+					mTaskChainName);
+	taskChain->set_num_threads(1);
+	taskChain->set_frame_sync(false);
+}
+
+Snapshot::~Snapshot()
+{
+	cleanup();
+}
+
+void Snapshot::cleanup()
+{
+	AsyncTaskChain* taskChain =
+			AsyncTaskManager::get_global_ptr()->find_task_chain(mTaskChainName);
+	if (taskChain)
+	{
+		taskChain->wait_for_tasks();
+		AsyncTaskManager::get_global_ptr()->remove_task_chain(mTaskChainName);
+	}
+}
+
+unsigned int Snapshot::take()
+{
+	double startTime = getTime();
+	unsigned int changes = 0;
+	std::set<ObjectId> current;
+	std::list<SMARTPTR(Object)> objects =
+			ObjectTemplateManager::GetSingletonPtr()->getCreatedObjects();
+	std::list<SMARTPTR(Object)>::const_iterator iter;
+	for (iter = objects.begin(); iter != objects.end(); ++iter)
+	{
+		ObjectId objectId = (*iter)->objectId();
+		current.insert(objectId);
+		std::string record = doWriteRecord(*iter);
+		std::map<ObjectId, std::string>::iterator recordIter = mRecords.find(
+				objectId);
+		if ((recordIter != mRecords.end()) and (recordIter->second == record))
+		{
+			continue;
+		}
+		mRecords[objectId] = record;
+		mChanged.insert(objectId);
+		mRemoved.erase(objectId);
+		++changes;
+	}
+	//records of destroyed Objects
+	std::map<ObjectId, std::string>::iterator recordIter = mRecords.begin();
+	while (recordIter != mRecords.end())
+	{
+		if (current.find(recordIter->first) == current.end())
+		{
+			mChanged.erase(recordIter->first);
+			mRemoved.insert(recordIter->first);
+			mRecords.erase(recordIter++);
+			++changes;
+		}
+		else
+		{
+			++recordIter;
+		}
+	}
+	mStats.mRecords = mRecords.size();
+	mStats.mTakeTime = getTime() - startTime;
+	return changes;
+}
+
+void Snapshot::save(const std::string& fileName)
+{
+	//build the chunk: all records or only the changes
+	bool full = (fileName != mFileName);
+	Datagram chunk;
+	chunk.add_uint8(full ? FULL : DELTA);
+	if (full)
+	{
+		chunk.add_uint32(mRecords.size());
+		std::map<ObjectId, std::string>::const_iterator iter;
+		for (iter = mRecords.begin(); iter != mRecords.end(); ++iter)
+		{
+			chunk.add_string(iter->first);
+			chunk.add_string32(iter->second);
+		}
+		chunk.add_uint32(0);
+	}
+	else
+	{
+		chunk.add_uint32(mChanged.size());
+		std::set<ObjectId>::const_iterator iter;
+		for (iter = mChanged.begin(); iter != mChanged.end(); ++iter)
+		{
+			chunk.add_string(*iter);
+			chunk.add_string32(mRecords[*iter]);
+		}
+		chunk.add_uint32(mRemoved.size());
+		for (iter = mRemoved.begin(); iter != mRemoved.end(); ++iter)
+		{
+			chunk.add_string(*iter);
+		}
+	}
+	mFileName = fileName;
+	mChanged.clear();
+	mRemoved.clear();
+	//queue it for the worker
+	SaveRequest request;
+	request.mFileName = fileName;
+	request.mFull = full;
+	request.mChunk = chunk.get_message();
+	{
+		MutexHolder guard(mSaveMutex);
+		mSaveQueue.push_back(request);
+	}
+	PT(AsyncTask)task = new SaveTask(this);
+	task->set_task_chain(mTaskChainName);
+	AsyncTaskManager::get_global_ptr()->add(task);
+}
+
+void Snapshot::waitSaved()
+{
+	AsyncTaskChain* taskChain =
+			AsyncTaskManager::get_global_ptr()->find_task_chain(mTaskChainName);
+	if (taskChain)
+	{
+		taskChain->wait_for_tasks();
+	}
+}
+
+bool Snapshot::load(const std::string& fileName)
+{
+	//pending saves could target the file
+	waitSaved();
+	std::ifstream in(fileName.c_str(), std::ios::in | std::ios::binary);
+	RETURN_ON_COND(not in, false)
+
+	std::ostringstream content;
+	content << in.rdbuf();
+	Datagram data(content.str());
+	DatagramIterator scan(data);
+	//check the header
+	RETURN_ON_COND(scan.get_remaining_size() < sizeof(MAGIC) + 4, false)
+	RETURN_ON_COND(scan.extract_bytes(sizeof(MAGIC))
+			!= std::string(MAGIC, sizeof(MAGIC)), false)
+	RETURN_ON_COND(scan.get_uint32() != VERSION, false)
+
+	//apply the chunks in order (a truncated one ends the file)
+	mRecords.clear();
+	while (scan.get_remaining_size() >= 4)
+	{
+		unsigned int size = scan.get_uint32();
+		if (scan.get_remaining_size() < size)
+		{
+			PRINT_ERR_DEBUG("Snapshot::load: truncated chunk in " << fileName);
+			break;
+		}
+		if (not doApplyChunk(scan.extract_bytes(size)))
+		{
+			PRINT_ERR_DEBUG("Snapshot::load: bad chunk in " << fileName);
+			break;
+		}
+	}
+	mFileName = fileName;
+	mChanged.clear();
+	mRemoved.clear();
+	mStats.mRecords = mRecords.size();
+	return true;
+}
+
+bool Snapshot::restore()
+{
+	double startTime = getTime();
+	bool result = true;
+	ObjectTemplateManager* objectTmplMgr =
+			ObjectTemplateManager::GetSingletonPtr();
+	//create the missing Objects: an owner before its owned ones
+	std::list<ObjectId> missing;
+	std::map<ObjectId, std::string>::const_iterator iter;
+	for (iter = mRecords.begin(); iter != mRecords.end(); ++iter)
+	{
+		if (not objectTmplMgr->getCreatedObject(iter->first))
+		{
+			missing.push_back(iter->first);
+		}
+	}
+	//refuse if a missing Object cannot be recreated as it was
+	mStats.mUnrestorable = 0;
+	std::list<ObjectId>::const_iterator checkIter;
+	for (checkIter = missing.begin(); checkIter != missing.end(); ++checkIter)
+	{
+		Datagram record(mRecords[*checkIter]);
+		DatagramIterator scan(record);
+		ObjectType objectType;
+		ObjectId ownerId;
+		bool paramsStored;
+		ParameterTable objectParams;
+		ParameterTableMap componentsParams;
+		doReadRecordIdentity(scan, objectType, ownerId, paramsStored,
+				objectParams, componentsParams);
+		if (not paramsStored)
+		{
+			PRINT_ERR_DEBUG(
+					"Snapshot::restore: no creation parameters stored for "
+					<< *checkIter);
+			++mStats.mUnrestorable;
+		}
+	}
+	if (mStats.mUnrestorable > 0)
+	{
+		mStats.mRestoreTime = getTime() - startTime;
+		return false;
+	}
+	bool progress = true;
+	while (progress and (not missing.empty()))
+	{
+		progress = false;
+		std::list<ObjectId>::iterator missingIter = missing.begin();
+		while (missingIter != missing.end())
+		{
+			Datagram record(mRecords[*missingIter]);
+			DatagramIterator scan(record);
+			ObjectType objectType;
+			ObjectId ownerId;
+			bool paramsStored;
+			ParameterTable objectParams;
+			ParameterTableMap componentsParams;
+			doReadRecordIdentity(scan, objectType, ownerId, paramsStored,
+					objectParams, componentsParams);
+			SMARTPTR(Object) owner;
+			if (not ownerId.empty())
+			{
+				owner = objectTmplMgr->getCreatedObject(ownerId);
+				if ((not owner) and (mRecords.find(ownerId) != mRecords.end()))
+				{
+					//wait for the owner
+					++missingIter;
+					continue;
+				}
+			}
+			if (not objectTmplMgr->createObject(objectType, *missingIter,
+					objectParams, componentsParams, true, owner))
+			{
+				PRINT_ERR_DEBUG(
+						"Snapshot::restore: cannot create " << *missingIter);
+				result = false;
+			}
+			missingIter = missing.erase(missingIter);
+			progress = true;
+		}
+	}
+	RETURN_ON_COND(not missing.empty(), false)
+
+	//destroy the Objects not in the snapshot
+	std::list<SMARTPTR(Object)> objects = objectTmplMgr->getCreatedObjects();
+	std::list<SMARTPTR(Object)>::const_iterator objectIter;
+	for (objectIter = objects.begin(); objectIter != objects.end(); ++objectIter)
+	{
+		if (mRecords.find((*objectIter)->objectId()) == mRecords.end())
+		{
+			objectTmplMgr->destroyObject((*objectIter)->objectId());
+		}
+	}
+	//fill in the runtime state
+	for (iter = mRecords.begin(); iter != mRecords.end(); ++iter)
+	{
+		SMARTPTR(Object) object = objectTmplMgr->getCreatedObject(iter->first);
+		if (not object)
+		{
+			continue;
+		}
+		Datagram record(iter->second);
+		DatagramIterator scan(record);
+		ObjectType objectType;
+		ObjectId ownerId;
+		bool paramsStored;
+		ParameterTable objectParams;
+		ParameterTableMap componentsParams;
+		doReadRecordIdentity(scan, objectType, ownerId, paramsStored,
+				objectParams, componentsParams);
+		object->fillin(scan, NULL);
+	}
+	mStats.mRestoreTime = getTime() - startTime;
+	return result;
+}
+
+void Snapshot::clear()
+{
+	mRecords.clear();
+	mChanged.clear();
+	mRemoved.clear();
+	mFileName.clear();
+	mStats.mRecords = 0;
+}
+
+Snapshot::SnapshotStats Snapshot::getStats()
+{
+	MutexHolder guard(mSaveMutex);
+	return mStats;
+}
+
+std::string Snapshot::doWriteRecord(SMARTPTR(Object) object) const
+{
+	Datagram record;
+	//identity
+	record.add_string(object->objectTmpl()->objectType());
+	SMARTPTR(Object) owner = object->getOwner();
+	record.add_string(owner ? owner->objectId() : ObjectId(""));
+	//stored parameters (needed to recreate the Object)
+	record.add_bool(object->hasStoredParams());
+	ParameterTable objectParams = object->getStoredObjTmplParams();
+	record.add_uint32(objectParams.size());
+	ParameterTable::const_iterator paramIter;
+	for (paramIter = objectParams.begin(); paramIter != objectParams.end();
+			++paramIter)
+	{
+		record.add_string(paramIter->first);
+		record.add_string(paramIter->second);
+	}
+	ParameterTableMap componentsParams = object->getStoredCompTmplParams();
+	record.add_uint32(componentsParams.size());
+	ParameterTableMap::const_iterator tableIter;
+	for (tableIter = componentsParams.begin();
+			tableIter != componentsParams.end(); ++tableIter)
+	{
+		record.add_string(tableIter->first);
+		record.add_uint32(tableIter->second.size());
+		for (paramIter = tableIter->second.begin();
+				paramIter != tableIter->second.end(); ++paramIter)
+		{
+			record.add_string(paramIter->first);
+			record.add_string(paramIter->second);
+		}
+	}
+	//runtime state
+	object->write_datagram(NULL, record);
+	return record.get_message();
+}
+
+void Snapshot::doReadRecordIdentity(DatagramIterator& scan,
+		ObjectType& objectType, ObjectId& ownerId, bool& paramsStored,
+		ParameterTable& objectParams, ParameterTableMap& componentsParams) const
+{
+	objectType = scan.get_string();
+	ownerId = scan.get_string();
+	paramsStored = scan.get_bool();
+	unsigned int numParams = scan.get_uint32();
+	for (unsigned int i = 0; i < numParams; ++i)
+	{
+		std::string name = scan.get_string();
+		objectParams.insert(ParameterNameValue(name, scan.get_string()));
+	}
+	unsigned int numTables = scan.get_uint32();
+	for (unsigned int t = 0; t < numTables; ++t)
+	{
+		ParameterTable& table = componentsParams[scan.get_string()];
+		numParams = scan.get_uint32();
+		for (unsigned int i = 0; i < numParams; ++i)
+		{
+			std::string name = scan.get_string();
+			table.insert(ParameterNameValue(name, scan.get_string()));
+		}
+	}
+}
+
+bool Snapshot::doApplyChunk(const std::string& chunk)
+{
+	Datagram data(chunk);
+	DatagramIterator scan(data);
+	RETURN_ON_COND(scan.get_remaining_size() < 1, false)
+
+	unsigned int kind = scan.get_uint8();
+	RETURN_ON_COND((kind != FULL) and (kind != DELTA), false)
+
+	if (kind == FULL)
+	{
+		mRecords.clear();
+	}
+	unsigned int numRecords = scan.get_uint32();
+	for (unsigned int i = 0; i < numRecords; ++i)
+	{
+		ObjectId objectId = scan.get_string();
+		mRecords[objectId] = scan.get_string32();
+	}
+	unsigned int numRemoved = scan.get_uint32();
+	for (unsigned int i = 0; i < numRemoved; ++i)
+	{
+		mRecords.erase(scan.get_string());
+	}
+	return true;
+}
+
+Snapshot::SaveTask::SaveTask(Snapshot* snapshot) :
+		AsyncTask(snapshot->mName + "-save"), mSnapshot(snapshot)
+{
+}
+
+AsyncTask::DoneStatus Snapshot::SaveTask::do_task()
+{
+	//drain the queue in order (later tasks may find it empty)
+	while (true)
+	{
+		SaveRequest request;
+		{
+			MutexHolder guard(mSnapshot->mSaveMutex);
+			if (mSnapshot->mSaveQueue.empty())
+			{
+				break;
+			}
+			request = mSnapshot->mSaveQueue.front();
+			mSnapshot->mSaveQueue.pop_front();
+		}
+		//full: new file with header; delta: appended
+		std::ofstream out(request.mFileName.c_str(),
+				std::ios::out | std::ios::binary
+						| (request.mFull ? std::ios::trunc : std::ios::app));
+		Datagram size;
+		size.add_uint32(request.mChunk.size());
+		if (out and request.mFull)
+		{
+			Datagram header;
+			header.append_data(MAGIC, sizeof(MAGIC));
+			header.add_uint32(VERSION);
+			out.write((const char*) header.get_data(), header.get_length());
+		}
+		out.write((const char*) size.get_data(), size.get_length());
+		out.write(request.mChunk.data(), request.mChunk.size());
+		out.close();
+		//update stats
+		MutexHolder guard(mSnapshot->mSaveMutex);
+		if (out)
+		{
+			++mSnapshot->mStats.mChunks;
+			mSnapshot->mStats.mSavedBytes += request.mChunk.size() + 4;
+		}
+		else
+		{
+			PRINT_ERR_DEBUG(
+					"Snapshot: cannot write to " << request.mFileName);
+			++mSnapshot->mStats.mErrors;
+		}
+	}
+	//
+	return DS_done;
+}
+
+} // namespace ely
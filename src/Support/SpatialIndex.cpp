@@ -0,0 +1,849 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/Support/SpatialIndex.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "Support/SpatialIndex.h"
+#include "ObjectModel/ObjectTemplateManager.h"
+#include <asyncTaskManager.h>
+#include <camera.h>
+#include <lens.h>
+#include <algorithm>
+#include <cmath>
+
+///Readers/writer lock guards.
+#ifdef ELY_THREAD
+#	define HOLD_READ(_index_) ReadHolder readGuard(_index_);
+#	define HOLD_WRITE(_index_) WriteHolder writeGuard(_index_);
+#else
+#	define HOLD_READ(_index_)
+#	define HOLD_WRITE(_index_)
+#endif
+
+namespace ely
+{
+
+const SpatialIndex::EntryId SpatialIndex::INVALID_ENTRY =
+		static_cast<SpatialIndex::EntryId>(-1);
+
+/**
+ * \brief A query shape, tested against nodes' loose bounds and entries.
+ */
+struct SpatialIndex::Shape
+{
+	enum Type
+	{
+		SPHERE, BOX, FRUSTUM, RAY
+	} mType;
+	///Sphere.
+	LPoint3f mCenter;
+	float mRadius;
+	///Box.
+	LPoint3f mMin, mMax;
+	///Frustum.
+	const std::vector<LPlanef>* mPlanes;
+	///Ray (unit direction).
+	LPoint3f mOrigin;
+	LVector3f mDirection;
+	float mLength;
+
+	bool overlapsBox(const LPoint3f& center, float halfWidth) const;
+	bool overlapsSphere(const LPoint3f& center, float radius) const;
+};
+
+bool SpatialIndex::Shape::overlapsBox(const LPoint3f& center,
+		float halfWidth) const
+{
+	switch (mType)
+	{
+	case SPHERE:
+	{
+		float distanceSquared = 0.0;
+		for (int i = 0; i < 3; ++i)
+		{
+			float delta = fabs(mCenter[i] - center[i]) - halfWidth;
+			if (delta > 0.0)
+			{
+				distanceSquared += delta * delta;
+			}
+		}
+		return distanceSquared <= mRadius * mRadius;
+	}
+	case BOX:
+		for (int i = 0; i < 3; ++i)
+		{
+			if ((mMax[i] < center[i] - halfWidth)
+					or (mMin[i] > center[i] + halfWidth))
+			{
+				return false;
+			}
+		}
+		return true;
+	case FRUSTUM:
+	{
+		std::vector<LPlanef>::const_iterator iter;
+		for (iter = mPlanes->begin(); iter != mPlanes->end(); ++iter)
+		{
+			LVector3f normal = iter->get_normal();
+			float extent = halfWidth
+					* (fabs(normal[0]) + fabs(normal[1]) + fabs(normal[2]));
+			if (iter->dist_to_plane(center) > extent)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	case RAY:
+	{
+		//slab test on the segment
+		float tMin = 0.0, tMax = mLength;
+		for (int i = 0; i < 3; ++i)
+		{
+			float low = center[i] - halfWidth, high = center[i] + halfWidth;
+			if (fabs(mDirection[i]) < 1.0e-8)
+			{
+				if ((mOrigin[i] < low) or (mOrigin[i] > high))
+				{
+					return false;
+				}
+				continue;
+			}
+			float t1 = (low - mOrigin[i]) / mDirection[i];
+			float t2 = (high - mOrigin[i]) / mDirection[i];
+			if (t1 > t2)
+			{
+				std::swap(t1, t2);
+			}
+			tMin = std::max(tMin, t1);
+			tMax = std::min(tMax, t2);
+			if (tMin > tMax)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	default:
+		break;
+	}
+	return false;
+}
+
+bool SpatialIndex::Shape::overlapsSphere(const LPoint3f& center,
+		float radius) const
+{
+	switch (mType)
+	{
+	case SPHERE:
+		return (center - mCenter).length_squared()
+				<= (radius + mRadius) * (radius + mRadius);
+	case BOX:
+	{
+		float distanceSquared = 0.0;
+		for (int i = 0; i < 3; ++i)
+		{
+			float delta =
+					center[i] < mMin[i] ? mMin[i] - center[i] :
+					(center[i] > mMax[i] ? center[i] - mMax[i] : 0.0);
+			distanceSquared += delta * delta;
+		}
+		return distanceSquared <= radius * radius;
+	}
+	case FRUSTUM:
+	{
+		std::vector<LPlanef>::const_iterator iter;
+		for (iter = mPlanes->begin(); iter != mPlanes->end(); ++iter)
+		{
+			if (iter->dist_to_plane(center)
+					> radius * iter->get_normal().length())
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	case RAY:
+	{
+		//the closest point of the segment
+		float t = std::max(0.0f,
+				std::min(mLength, (center - mOrigin).dot(mDirection)));
+		return (center - (mOrigin + mDirection * t)).length_squared()
+				<= radius * radius;
+	}
+	default:
+		break;
+	}
+	return false;
+}
+
+SpatialIndex::SpatialIndex(const LPoint3f& center, float halfWidth,
+		unsigned int maxDepth, int sort, int priority) :
+		mCenter(center), mHalfWidth(halfWidth > 0.0 ? halfWidth : 1024.0), mMaxDepth(
+				maxDepth)
+#ifdef ELY_THREAD
+				, mLockVar(mLockMutex), mReaders(0), mWritersWaiting(0), mWriter(
+						false)
+#endif
+{
+	mStats.mEntries = mStats.mNodes = mStats.mMoved = mStats.mRelinked = 0;
+	//the root (never released)
+	doNewNode(-1, 0);
+	//track the already created objects
+	ObjectTemplateManager* objectTmplMgr =
+			ObjectTemplateManager::GetSingletonPtr();
+	if (objectTmplMgr)
+	{
+		std::list<SMARTPTR(Object)> objects = objectTmplMgr->getCreatedObjects();
+		std::list<SMARTPTR(Object)>::const_iterator iter;
+		for (iter = objects.begin(); iter != objects.end(); ++iter)
+		{
+			addObject(*iter);
+		}
+	}
+	//create the task for updating the index
+	mUpdateData = new TaskInterface<SpatialIndex>::TaskData(this,
+			&SpatialIndex::update);
+	mUpdateTask = new GenericAsyncTask("SpatialIndex::update",
+			&TaskInterface<SpatialIndex>::taskFunction,
+			reinterpret_cast<void*>(mUpdateData.p()));
+	//set sort/priority
+	mUpdateTask->set_sort(sort);
+	mUpdateTask->set_priority(priority);
+	//Adds mUpdateTask to the active queue.
+	AsyncTaskManager::get_global_ptr()->add(mUpdateTask);
+}
+
+SpatialIndex::~SpatialIndex()
+{
+	//lock (guard) the writer's lock
+	HOLD_WRITE(this)
+
+	if (mUpdateTask)
+	{
+		AsyncTaskManager::get_global_ptr()->remove(mUpdateTask);
+	}
+	mObjectEntries.clear();
+	mEntries.clear();
+	mFreeEntries.clear();
+	mNodes.clear();
+	mFreeNodes.clear();
+}
+
+SpatialIndex::EntryId SpatialIndex::insert(const NodePath& nodePath,
+		float radius, void* userData)
+{
+	RETURN_ON_COND(nodePath.is_empty(), INVALID_ENTRY)
+
+	LPoint3f center;
+	doGetSphere(nodePath, center, radius);
+
+	//lock (guard) the writer's lock
+	HOLD_WRITE(this)
+
+	return doInsert(center, radius, nodePath, userData);
+}
+
+SpatialIndex::EntryId SpatialIndex::insert(const LPoint3f& center, float radius,
+		void* userData)
+{
+	//lock (guard) the writer's lock
+	HOLD_WRITE(this)
+
+	return doInsert(center, radius, NodePath(), userData);
+}
+
+void SpatialIndex::remove(EntryId entryId)
+{
+	//lock (guard) the writer's lock
+	HOLD_WRITE(this)
+
+	RETURN_ON_COND(not doIsValid(entryId),)
+
+	doRemove(entryId);
+}
+
+void SpatialIndex::move(EntryId entryId, const LPoint3f& center)
+{
+	//lock (guard) the writer's lock
+	HOLD_WRITE(this)
+
+	RETURN_ON_COND(not doIsValid(entryId),)
+
+	doMove(entryId, center);
+}
+
+void SpatialIndex::setRadius(EntryId entryId, float radius)
+{
+	//lock (guard) the writer's lock
+	HOLD_WRITE(this)
+
+	RETURN_ON_COND(not doIsValid(entryId),)
+
+	//the depth could change: relink
+	doUnlink(entryId);
+	mEntries[entryId].mRadius = std::max(radius, 0.0f);
+	doLink(entryId,
+			doFindNode(mEntries[entryId].mCenter, mEntries[entryId].mRadius,
+					true));
+}
+
+bool SpatialIndex::getSphere(EntryId entryId, LPoint3f& center, float& radius)
+{
+	//lock (guard) the readers' lock
+	HOLD_READ(this)
+
+	RETURN_ON_COND(not doIsValid(entryId), false)
+
+	center = mEntries[entryId].mCenter;
+	radius = mEntries[entryId].mRadius;
+	return true;
+}
+
+NodePath SpatialIndex::getNodePath(EntryId entryId)
+{
+	//lock (guard) the readers' lock
+	HOLD_READ(this)
+
+	RETURN_ON_COND(not doIsValid(entryId), NodePath())
+
+	return mEntries[entryId].mNodePath;
+}
+
+void* SpatialIndex::getUserData(EntryId entryId)
+{
+	//lock (guard) the readers' lock
+	HOLD_READ(this)
+
+	RETURN_ON_COND(not doIsValid(entryId), NULL)
+
+	return mEntries[entryId].mUserData;
+}
+
+unsigned int SpatialIndex::getNumEntries()
+{
+	//lock (guard) the readers' lock
+	HOLD_READ(this)
+
+	return mStats.mEntries;
+}
+
+void SpatialIndex::addObject(SMARTPTR(Object) object, float radius)
+{
+	RETURN_ON_COND(not object,)
+
+	NodePath nodePath = object->getNodePath();
+	RETURN_ON_COND(nodePath.is_empty(),)
+
+	LPoint3f center;
+	doGetSphere(nodePath, center, radius);
+
+	//lock (guard) the writer's lock
+	HOLD_WRITE(this)
+
+	RETURN_ON_COND(
+			mObjectEntries.find(object->objectId()) != mObjectEntries.end(),)
+
+	EntryId entryId = doInsert(center, radius, nodePath, NULL);
+	mEntries[entryId].mObjectId = object->objectId();
+	mObjectEntries[object->objectId()] = entryId;
+}
+
+void SpatialIndex::removeObject(const ObjectId& objectId)
+{
+	//lock (guard) the writer's lock
+	HOLD_WRITE(this)
+
+	std::map<ObjectId, EntryId>::const_iterator iter = mObjectEntries.find(
+			objectId);
+	RETURN_ON_COND(iter == mObjectEntries.end(),)
+
+	doRemove(iter->second);
+}
+
+SpatialIndex::EntryId SpatialIndex::getObjectEntry(const ObjectId& objectId)
+{
+	//lock (guard) the readers' lock
+	HOLD_READ(this)
+
+	std::map<ObjectId, EntryId>::const_iterator iter = mObjectEntries.find(
+			objectId);
+	RETURN_ON_COND(iter == mObjectEntries.end(), INVALID_ENTRY)
+
+	return iter->second;
+}
+
+ObjectId SpatialIndex::getObjectId(EntryId entryId)
+{
+	//lock (guard) the readers' lock
+	HOLD_READ(this)
+
+	RETURN_ON_COND(not doIsValid(entryId), ObjectId())
+
+	return mEntries[entryId].mObjectId;
+}
+
+unsigned int SpatialIndex::refresh()
+{
+	//gather the moves: readers are not blocked meanwhile
+	mMoves.clear();
+	{
+		//lock (guard) the readers' lock
+		HOLD_READ(this)
+
+		for (EntryId entryId = 0; entryId < mEntries.size(); ++entryId)
+		{
+			const Entry& entry = mEntries[entryId];
+			if ((not entry.mUsed) or entry.mNodePath.is_empty())
+			{
+				continue;
+			}
+			LPoint3f center = entry.mNodePath.get_pos(
+					entry.mNodePath.get_top());
+			if (center != entry.mCenter)
+			{
+				Move move;
+				move.mEntryId = entryId;
+				move.mGeneration = entry.mGeneration;
+				move.mCenter = center;
+				mMoves.push_back(move);
+			}
+		}
+	}
+	//apply them all at once
+	//lock (guard) the writer's lock
+	HOLD_WRITE(this)
+
+	mStats.mMoved = mStats.mRelinked = 0;
+	std::vector<Move>::const_iterator iter;
+	for (iter = mMoves.begin(); iter != mMoves.end(); ++iter)
+	{
+		//could have been removed (and its id reused) in the meantime
+		if (doIsValid(iter->mEntryId)
+				and (mEntries[iter->mEntryId].mGeneration == iter->mGeneration))
+		{
+			doMove(iter->mEntryId, iter->mCenter);
+			++mStats.mMoved;
+		}
+	}
+	return mStats.mMoved;
+}
+
+void SpatialIndex::querySphere(const LPoint3f& center, float radius,
+		std::vector<EntryId>& result)
+{
+	//lock (guard) the readers' lock
+	HOLD_READ(this)
+
+	Shape shape;
+	shape.mType = Shape::SPHERE;
+	shape.mCenter = center;
+	shape.mRadius = radius;
+	doQuery(0, shape, result);
+}
+
+void SpatialIndex::queryBox(const LPoint3f& min, const LPoint3f& max,
+		std::vector<EntryId>& result)
+{
+	//lock (guard) the readers' lock
+	HOLD_READ(this)
+
+	Shape shape;
+	shape.mType = Shape::BOX;
+	shape.mMin = min;
+	shape.mMax = max;
+	doQuery(0, shape, result);
+}
+
+void SpatialIndex::queryFrustum(const std::vector<LPlanef>& planes,
+		std::vector<EntryId>& result)
+{
+	//lock (guard) the readers' lock
+	HOLD_READ(this)
+
+	Shape shape;
+	shape.mType = Shape::FRUSTUM;
+	shape.mPlanes = &planes;
+	doQuery(0, shape, result);
+}
+
+void SpatialIndex::queryFrustum(const BoundingHexahedron& frustum,
+		std::vector<EntryId>& result)
+{
+	std::vector<LPlanef> planes;
+	for (int i = 0; i < frustum.get_num_planes(); ++i)
+	{
+		planes.push_back(frustum.get_plane(i));
+	}
+	queryFrustum(planes, result);
+}
+
+void SpatialIndex::queryFrustum(const NodePath& camera,
+		std::vector<EntryId>& result)
+{
+	RETURN_ON_COND(
+			camera.is_empty()
+					or (not camera.node()->is_of_type(Camera::get_class_type())),)
+
+	Lens* lens = DCAST(Camera, camera.node())->get_lens();
+	RETURN_ON_COND(not lens,)
+
+	PT(BoundingVolume)bounds = lens->make_bounds();
+	RETURN_ON_COND(
+			(not bounds)
+					or (not bounds->is_of_type(
+							BoundingHexahedron::get_class_type())),)
+
+	//the lens bounds wrt the scene root
+	PT(BoundingHexahedron)frustum = DCAST(BoundingHexahedron, bounds);
+	frustum->xform(camera.get_mat(camera.get_top()));
+	queryFrustum(*frustum, result);
+}
+
+void SpatialIndex::queryRay(const LPoint3f& origin, const LVector3f& direction,
+		float length, std::vector<EntryId>& result)
+{
+	RETURN_ON_COND(direction.length_squared() == 0.0,)
+
+	Shape shape;
+	shape.mType = Shape::RAY;
+	shape.mOrigin = origin;
+	shape.mDirection = direction;
+	shape.mDirection.normalize();
+	shape.mLength = length;
+	std::vector<EntryId> hits;
+	std::vector<std::pair<float, EntryId> > sorted;
+	{
+		//lock (guard) the readers' lock
+		HOLD_READ(this)
+
+		doQuery(0, shape, hits);
+		//sort by the distance of the first intersection
+		std::vector<EntryId>::const_iterator iter;
+		for (iter = hits.begin(); iter != hits.end(); ++iter)
+		{
+			const Entry& entry = mEntries[*iter];
+			LVector3f toCenter = entry.mCenter - origin;
+			float along = toCenter.dot(shape.mDirection);
+			float offSquared = toCenter.length_squared() - along * along;
+			float inside = entry.mRadius * entry.mRadius - offSquared;
+			float distance = along - (inside > 0.0 ? sqrt(inside) : 0.0);
+			sorted.push_back(std::make_pair(std::max(distance, 0.0f), *iter));
+		}
+	}
+	std::sort(sorted.begin(), sorted.end());
+	std::vector<std::pair<float, EntryId> >::const_iterator iter;
+	for (iter = sorted.begin(); iter != sorted.end(); ++iter)
+	{
+		result.push_back(iter->second);
+	}
+}
+
+AsyncTask::DoneStatus SpatialIndex::update(GenericAsyncTask* task)
+{
+	refresh();
+	//
+	return AsyncTask::DS_cont;
+}
+
+SpatialIndex::SpatialIndexStats SpatialIndex::getStats()
+{
+	//lock (guard) the readers' lock
+	HOLD_READ(this)
+
+	return mStats;
+}
+
+SpatialIndex::EntryId SpatialIndex::doInsert(const LPoint3f& center,
+		float radius, const NodePath& nodePath, void* userData)
+{
+	EntryId entryId;
+	if (not mFreeEntries.empty())
+	{
+		entryId = mFreeEntries.back();
+		mFreeEntries.pop_back();
+	}
+	else
+	{
+		entryId = mEntries.size();
+		mEntries.push_back(Entry());
+		mEntries.back().mGeneration = 0;
+	}
+	Entry& entry = mEntries[entryId];
+	entry.mCenter = center;
+	entry.mRadius = std::max(radius, 0.0f);
+	entry.mNodePath = nodePath;
+	entry.mUserData = userData;
+	entry.mObjectId = ObjectId();
+	entry.mUsed = true;
+	entry.mNode = -1;
+	entry.mNodeIndex = 0;
+	doLink(entryId, doFindNode(entry.mCenter, entry.mRadius, true));
+	++mStats.mEntries;
+	return entryId;
+}
+
+void SpatialIndex::doRemove(EntryId entryId)
+{
+	doUnlink(entryId);
+	Entry& entry = mEntries[entryId];
+	if (not entry.mObjectId.empty())
+	{
+		mObjectEntries.erase(entry.mObjectId);
+	}
+	entry.mNodePath = NodePath();
+	entry.mUserData = NULL;
+	entry.mObjectId = ObjectId();
+	entry.mUsed = false;
+	//pending moves of this entry are stale from now on
+	++entry.mGeneration;
+	mFreeEntries.push_back(entryId);
+	--mStats.mEntries;
+}
+
+void SpatialIndex::doGetSphere(const NodePath& nodePath, LPoint3f& center,
+		float& radius) const
+{
+	if (radius < 0.0)
+	{
+		//from the (tight) bounds
+		LPoint3f minP, maxP;
+		radius =
+				nodePath.calc_tight_bounds(minP, maxP) ?
+						(maxP - minP).length() * 0.5 : 0.0;
+	}
+	center = nodePath.get_pos(nodePath.get_top());
+}
+
+int SpatialIndex::doFindNode(const LPoint3f& center, float radius,
+		bool create)
+{
+	//outside the region: the root
+	for (int i = 0; i < 3; ++i)
+	{
+		RETURN_ON_COND(fabs(center[i] - mCenter[i]) > mHalfWidth, 0)
+	}
+	//descend while the sphere fits the child's loose bounds
+	int node = 0;
+	while (mNodes[node].mDepth < mMaxDepth)
+	{
+		float childHalfWidth = mNodes[node].mHalfWidth * 0.5;
+		if (radius > childHalfWidth)
+		{
+			break;
+		}
+		const LPoint3f& nodeCenter = mNodes[node].mCenter;
+		unsigned int index = (center[0] > nodeCenter[0] ? 1 : 0)
+				| (center[1] > nodeCenter[1] ? 2 : 0)
+				| (center[2] > nodeCenter[2] ? 4 : 0);
+		int child = mNodes[node].mChildren[index];
+		if (child < 0)
+		{
+			RETURN_ON_COND(not create, -1)
+
+			child = doNewNode(node, index);
+		}
+		node = child;
+	}
+	return node;
+}
+
+int SpatialIndex::doNewNode(int parent, unsigned int index)
+{
+	int node;
+	if (not mFreeNodes.empty())
+	{
+		node = mFreeNodes.back();
+		mFreeNodes.pop_back();
+	}
+	else
+	{
+		node = mNodes.size();
+		mNodes.push_back(Node());
+	}
+	Node& newNode = mNodes[node];
+	newNode.mParent = parent;
+	newNode.mIndex = index;
+	for (int i = 0; i < 8; ++i)
+	{
+		newNode.mChildren[i] = -1;
+	}
+	newNode.mEntries.clear();
+	newNode.mSpheres.clear();
+	newNode.mCount = 0;
+	if (parent < 0)
+	{
+		newNode.mCenter = mCenter;
+		newNode.mHalfWidth = mHalfWidth;
+		newNode.mDepth = 0;
+	}
+	else
+	{
+		const Node& parentNode = mNodes[parent];
+		float step = parentNode.mHalfWidth * 0.5;
+		newNode.mCenter = parentNode.mCenter
+				+ LVector3f((index & 1) ? step : -step,
+						(index & 2) ? step : -step, (index & 4) ? step : -step);
+		newNode.mHalfWidth = step;
+		newNode.mDepth = parentNode.mDepth + 1;
+		mNodes[parent].mChildren[index] = node;
+	}
+	++mStats.mNodes;
+	return node;
+}
+
+void SpatialIndex::doLink(EntryId entryId, int node)
+{
+	Entry& entry = mEntries[entryId];
+	entry.mNode = node;
+	entry.mNodeIndex = mNodes[node].mEntries.size();
+	mNodes[node].mEntries.push_back(entryId);
+	mNodes[node].mSpheres.push_back(
+			LVecBase4f(entry.mCenter[0], entry.mCenter[1], entry.mCenter[2],
+					entry.mRadius));
+	for (int n = node; n >= 0; n = mNodes[n].mParent)
+	{
+		++mNodes[n].mCount;
+	}
+}
+
+void SpatialIndex::doUnlink(EntryId entryId)
+{
+	Entry& entry = mEntries[entryId];
+	RETURN_ON_COND(entry.mNode < 0,)
+
+	//swap with the last of the node and pop
+	int node = entry.mNode;
+	std::vector<EntryId>& entries = mNodes[node].mEntries;
+	std::vector<LVecBase4f>& spheres = mNodes[node].mSpheres;
+	EntryId lastId = entries.back();
+	entries[entry.mNodeIndex] = lastId;
+	spheres[entry.mNodeIndex] = spheres.back();
+	mEntries[lastId].mNodeIndex = entry.mNodeIndex;
+	entries.pop_back();
+	spheres.pop_back();
+	entry.mNode = -1;
+	for (int n = node; n >= 0; n = mNodes[n].mParent)
+	{
+		--mNodes[n].mCount;
+	}
+	//release the empty nodes (but the root)
+	while ((node > 0) and (mNodes[node].mCount == 0))
+	{
+		int parent = mNodes[node].mParent;
+		mNodes[parent].mChildren[mNodes[node].mIndex] = -1;
+		mFreeNodes.push_back(node);
+		--mStats.mNodes;
+		node = parent;
+	}
+}
+
+void SpatialIndex::doMove(EntryId entryId, const LPoint3f& center)
+{
+	Entry& entry = mEntries[entryId];
+	entry.mCenter = center;
+	//relink only if the node changes
+	if (doFindNode(center, entry.mRadius, false) == entry.mNode)
+	{
+		mNodes[entry.mNode].mSpheres[entry.mNodeIndex] = LVecBase4f(center[0],
+				center[1], center[2], entry.mRadius);
+		return;
+	}
+
+	doUnlink(entryId);
+	doLink(entryId, doFindNode(center, entry.mRadius, true));
+	++mStats.mRelinked;
+}
+
+void SpatialIndex::doQuery(int node, const Shape& shape,
+		std::vector<EntryId>& result)
+{
+	const Node& current = mNodes[node];
+	RETURN_ON_COND(current.mCount == 0,)
+	//the root keeps the entries outside the region too
+	RETURN_ON_COND(
+			(node > 0)
+					and (not shape.overlapsBox(current.mCenter,
+							current.mHalfWidth * 2.0)),)
+
+	//spheres are scanned contiguously
+	for (unsigned int i = 0; i < current.mSpheres.size(); ++i)
+	{
+		const LVecBase4f& sphere = current.mSpheres[i];
+		if (shape.overlapsSphere(
+				LPoint3f(sphere[0], sphere[1], sphere[2]), sphere[3]))
+		{
+			result.push_back(current.mEntries[i]);
+		}
+	}
+	for (int i = 0; i < 8; ++i)
+	{
+		if (current.mChildren[i] >= 0)
+		{
+			doQuery(current.mChildren[i], shape, result);
+		}
+	}
+}
+
+#ifdef ELY_THREAD
+SpatialIndex::ReadHolder::ReadHolder(SpatialIndex* index) :
+		mIndex(index)
+{
+	MutexHolder guard(mIndex->mLockMutex);
+	//waiting writers go first
+	while (mIndex->mWriter or (mIndex->mWritersWaiting > 0))
+	{
+		mIndex->mLockVar.wait();
+	}
+	++mIndex->mReaders;
+}
+
+SpatialIndex::ReadHolder::~ReadHolder()
+{
+	MutexHolder guard(mIndex->mLockMutex);
+	if (--mIndex->mReaders == 0)
+	{
+		mIndex->mLockVar.notify_all();
+	}
+}
+
+SpatialIndex::WriteHolder::WriteHolder(SpatialIndex* index) :
+		mIndex(index)
+{
+	MutexHolder guard(mIndex->mLockMutex);
+	++mIndex->mWritersWaiting;
+	while (mIndex->mWriter or (mIndex->mReaders > 0))
+	{
+		mIndex->mLockVar.wait();
+	}
+	--mIndex->mWritersWaiting;
+	mIndex->mWriter = true;
+}
+
+SpatialIndex::WriteHolder::~WriteHolder()
+{
+	MutexHolder guard(mIndex->mLockMutex);
+	mIndex->mWriter = false;
+	mIndex->mLockVar.notify_all();
+}
+#endif
+
+} // namespace ely
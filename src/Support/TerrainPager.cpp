@@ -0,0 +1,397 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/Support/TerrainPager.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "Support/TerrainPager.h"
+#include "Game/GamePhysicsManager.h"
+#include <asyncTaskManager.h>
+#include <clockObject.h>
+#include <texturePool.h>
+#include <bulletHeightfieldShape.h>
+#include <mutexHolder.h>
+#include <algorithm>
+#include <cmath>
+
+namespace ely
+{
+
+namespace
+{
+///Delay (seconds) before retrying a missing page, doubled by each failure
+///up to a maximum.
+const double RETRY_DELAY = 1.0;
+const double RETRY_DELAY_MAX = 60.0;
+///Orders pages' indexes by (page) distance.
+struct PageDistanceLess
+{
+	PageDistanceLess(const std::vector<int>& distances) :
+			mDistances(distances)
+	{
+	}
+	bool operator()(int p1, int p2) const
+	{
+		return mDistances[p1] < mDistances[p2];
+	}
+private:
+	const std::vector<int>& mDistances;
+};
+}
+
+TerrainPager::TerrainPager(const std::string& name, const Settings& settings,
+		int budget, int numThreads) :
+		mName(name), mSettings(settings), mFocalPoint(LPoint3f::zero())
+{
+	mRoot = NodePath(name + "_PagerRoot");
+	mSettings.mPagesX = (mSettings.mPagesX > 0 ? mSettings.mPagesX : 1);
+	mSettings.mPagesY = (mSettings.mPagesY > 0 ? mSettings.mPagesY : 1);
+	mSettings.mPageSize = (mSettings.mPageSize > 1 ? mSettings.mPageSize : 2);
+	mSettings.mRadius = (mSettings.mRadius >= 0 ? mSettings.mRadius : 0);
+	setBudget(budget);
+	//pages: all evicted
+	mPages.resize(mSettings.mPagesX * mSettings.mPagesY);
+	for (unsigned int p = 0; p < mPages.size(); ++p)
+	{
+		mPages[p].mState = Page::EVICTED;
+		mPages[p].mRetries = 0;
+		mPages[p].mNextRetry = 0.0;
+	}
+	//worker threads
+	mTaskChainName = name + "-pageChain";
+	AsyncTaskChain* taskChain =
+			AsyncTaskManager::get_global_ptr()->make_task_chain(
+					mTaskChainName);
+	taskChain->set_num_threads(numThreads > 0 ? numThreads : 0);
+	taskChain->set_frame_sync(false);
+	//counters
+	mStats.mResident = mStats.mLoading = mStats.mMissing = 0;
+	mStats.mTotalLoaded = mStats.mTotalEvicted = 0;
+}
+
+TerrainPager::~TerrainPager()
+{
+}
+
+void TerrainPager::generate()
+{
+	int fx, fy;
+	doGetFocalPage(fx, fy);
+	int pageIdx = fy * mSettings.mPagesX + fx;
+	RETURN_ON_COND(mPages[pageIdx].mState != Page::EVICTED,)
+
+	doAttachPage(doLoadPage(pageIdx));
+}
+
+void TerrainPager::update()
+{
+	//1: frame boundary: attach the pages loaded by workers
+	std::vector<LoadedPage> loadedPages;
+	{
+		MutexHolder guard(mLoadedMutex);
+		loadedPages.swap(mLoadedPages);
+	}
+	std::vector<LoadedPage>::const_iterator loadedIter;
+	for (loadedIter = loadedPages.begin(); loadedIter != loadedPages.end();
+			++loadedIter)
+	{
+		doAttachPage(*loadedIter);
+	}
+
+	//2: evict far pages and collect the missing near ones (including
+	//those that failed, once their retry time has come)
+	int fx, fy;
+	doGetFocalPage(fx, fy);
+	double now = ClockObject::get_global_clock()->get_frame_time();
+	std::vector<int> distances(mPages.size());
+	std::vector<int> missingPages;
+	for (unsigned int p = 0; p < mPages.size(); ++p)
+	{
+		distances[p] = doGetPageDistance(p, fx, fy);
+		if ((mPages[p].mState == Page::RESIDENT)
+				and (distances[p] > mSettings.mRadius + 1))
+		{
+			doEvictPage(p);
+		}
+		else if (((mPages[p].mState == Page::EVICTED)
+				or ((mPages[p].mState == Page::MISSING)
+						and (now >= mPages[p].mNextRetry)))
+				and (distances[p] <= mSettings.mRadius))
+		{
+			missingPages.push_back(p);
+		}
+	}
+
+	//3: dispatch the nearest missing pages, within budget
+	std::sort(missingPages.begin(), missingPages.end(),
+			PageDistanceLess(distances));
+	int dispatched = 0;
+	std::vector<int>::const_iterator missingIter;
+	for (missingIter = missingPages.begin();
+			(missingIter != missingPages.end()) and (dispatched < mBudget);
+			++missingIter)
+	{
+		if (mPages[*missingIter].mState == Page::MISSING)
+		{
+			--mStats.mMissing;
+		}
+		mPages[*missingIter].mState = Page::LOADING;
+		PT(AsyncTask) loadTask = new LoadTask(this, *missingIter);
+		loadTask->set_task_chain(mTaskChainName);
+		AsyncTaskManager::get_global_ptr()->add(loadTask);
+		++mStats.mLoading;
+		++dispatched;
+	}
+
+	//4: update resident pages' LOD
+	RETURN_ON_COND(mSettings.mBruteForce,)
+
+	for (unsigned int p = 0; p < mPages.size(); ++p)
+	{
+		Page& page = mPages[p];
+		if (page.mState == Page::RESIDENT)
+		{
+			//focal point wrt page origin
+			page.mTerrain->set_focal_point(
+					mFocalPoint - page.mTerrainNP.get_pos());
+			page.mTerrain->update();
+		}
+	}
+}
+
+void TerrainPager::cleanup()
+{
+	AsyncTaskChain* taskChain =
+			AsyncTaskManager::get_global_ptr()->find_task_chain(mTaskChainName);
+	if (taskChain)
+	{
+		taskChain->wait_for_tasks();
+		AsyncTaskManager::get_global_ptr()->remove_task_chain(mTaskChainName);
+	}
+	//free pages loaded but never attached
+	{
+		MutexHolder guard(mLoadedMutex);
+		std::vector<LoadedPage>::iterator loadedIter;
+		for (loadedIter = mLoadedPages.begin();
+				loadedIter != mLoadedPages.end(); ++loadedIter)
+		{
+			mPages[loadedIter->mPage].mState = Page::EVICTED;
+		}
+		mLoadedPages.clear();
+	}
+	//evict resident pages
+	for (unsigned int p = 0; p < mPages.size(); ++p)
+	{
+		if (mPages[p].mState == Page::RESIDENT)
+		{
+			doEvictPage(p);
+		}
+	}
+	mStats.mLoading = 0;
+}
+
+TerrainPager::LoadedPage TerrainPager::doLoadPage(int pageIdx) const
+{
+	LoadedPage loaded;
+	loaded.mPage = pageIdx;
+	int x = pageIdx % mSettings.mPagesX;
+	int y = pageIdx / mSettings.mPagesX;
+	PNMImage heightField;
+	if (not heightField.read(
+			Filename(doGetPageFileName(mSettings.mHeightfieldPattern, x, y))))
+	{
+		PRINT_ERR_DEBUG(
+				"TerrainPager::doLoadPage: cannot read heightfield of page " << x << "," << y);
+		return loaded;
+	}
+	//the page terrain
+	std::ostringstream pageName;
+	pageName << mName << "_Page_" << x << "_" << y;
+	loaded.mTerrain = new PageTerrain(pageName.str());
+	loaded.mTerrain->set_heightfield(heightField);
+	loaded.mTerrain->set_block_size(mSettings.mBlockSize);
+	loaded.mTerrain->set_near(mSettings.mNear);
+	loaded.mTerrain->set_far(mSettings.mFar);
+	loaded.mTerrain->set_min_level(
+			min<float>(mSettings.mMinLevel, loaded.mTerrain->get_max_level()));
+	loaded.mTerrain->set_auto_flatten(mSettings.mFlattenMode);
+	loaded.mTerrain->set_bruteforce(mSettings.mBruteForce);
+	//texture (if any)
+	if (not mSettings.mTexturePattern.empty())
+	{
+		SMARTPTR(Texture) texture = TexturePool::load_texture(
+				Filename(doGetPageFileName(mSettings.mTexturePattern, x, y)));
+		if (texture != NULL)
+		{
+			loaded.mTerrain->get_root().set_texture(mSettings.mTextureStage,
+					texture, 1);
+		}
+	}
+	loaded.mTerrain->generate();
+	//the static heightfield body: the shape is centered on the page, with
+	//heights in [0,1]
+	if (mSettings.mPhysics)
+	{
+		loaded.mBody = new BulletRigidBodyNode(
+				(pageName.str() + "_Body").c_str());
+		loaded.mBody->add_shape(
+				new BulletHeightfieldShape(heightField, 1.0, Z_up));
+		loaded.mBody->set_mass(0.0);
+		loaded.mBody->set_static(true);
+	}
+	return loaded;
+}
+
+void TerrainPager::doAttachPage(const LoadedPage& loaded)
+{
+	Page& page = mPages[loaded.mPage];
+	if (page.mState == Page::LOADING)
+	{
+		--mStats.mLoading;
+	}
+	if (not loaded.mTerrain)
+	{
+		//retry later, backing off
+		double delay = RETRY_DELAY * pow(2.0, page.mRetries);
+		page.mNextRetry = ClockObject::get_global_clock()->get_frame_time()
+				+ (delay < RETRY_DELAY_MAX ? delay : RETRY_DELAY_MAX);
+		++page.mRetries;
+		page.mState = Page::MISSING;
+		++mStats.mMissing;
+		return;
+	}
+	page.mRetries = 0;
+	int fx, fy;
+	doGetFocalPage(fx, fy);
+	if (doGetPageDistance(loaded.mPage, fx, fy) > mSettings.mRadius + 1)
+	{
+		//the focal point moved away meanwhile
+		page.mState = Page::EVICTED;
+		return;
+	}
+	float pageWidth = doGetPageWidth();
+	LPoint3f pageOrigin((loaded.mPage % mSettings.mPagesX) * pageWidth,
+			(loaded.mPage / mSettings.mPagesX) * pageWidth, 0.0);
+	page.mTerrain = loaded.mTerrain;
+	page.mTerrainNP = page.mTerrain->get_root();
+	page.mTerrainNP.reparent_to(mRoot);
+	page.mTerrainNP.set_pos(pageOrigin);
+	page.mBody = loaded.mBody;
+	if (page.mBody and GamePhysicsManager::GetSingletonPtr())
+	{
+		page.mBodyNP = mRoot.attach_new_node(page.mBody);
+		page.mBodyNP.set_pos(
+				pageOrigin + LVector3f(pageWidth / 2.0, pageWidth / 2.0, 0.5));
+		//lock (guard) the physics mutex
+		HOLD_REMUTEX(GamePhysicsManager::GetSingletonPtr()->getMutex())
+
+		GamePhysicsManager::GetSingletonPtr()->bulletWorld()->attach(
+				page.mBody);
+	}
+	page.mState = Page::RESIDENT;
+	++mStats.mResident;
+	++mStats.mTotalLoaded;
+}
+
+void TerrainPager::doEvictPage(int pageIdx)
+{
+	Page& page = mPages[pageIdx];
+	if (page.mBody and (not page.mBodyNP.is_empty()))
+	{
+		{
+			//lock (guard) the physics mutex
+			HOLD_REMUTEX(GamePhysicsManager::GetSingletonPtr()->getMutex())
+
+			GamePhysicsManager::GetSingletonPtr()->bulletWorld()->remove(
+					page.mBody);
+		}
+		page.mBodyNP.remove_node();
+	}
+	page.mBody.clear();
+	page.mTerrainNP.remove_node();
+	page.mTerrain.clear();
+	page.mState = Page::EVICTED;
+	--mStats.mResident;
+	++mStats.mTotalEvicted;
+}
+
+void TerrainPager::doGetFocalPage(int& fx, int& fy) const
+{
+	float pageWidth = doGetPageWidth();
+	fx = (int) floor(mFocalPoint.get_x() / pageWidth);
+	fy = (int) floor(mFocalPoint.get_y() / pageWidth);
+	fx = (fx < 0 ? 0 : (fx >= mSettings.mPagesX ? mSettings.mPagesX - 1 : fx));
+	fy = (fy < 0 ? 0 : (fy >= mSettings.mPagesY ? mSettings.mPagesY - 1 : fy));
+}
+
+int TerrainPager::doGetPageDistance(int pageIdx, int fx, int fy) const
+{
+	//Chebyshev distance in pages
+	int dx = abs(pageIdx % mSettings.mPagesX - fx);
+	int dy = abs(pageIdx / mSettings.mPagesX - fy);
+	return (dx > dy ? dx : dy);
+}
+
+std::string TerrainPager::doGetPageFileName(const std::string& pattern, int x,
+		int y) const
+{
+	std::string fileName = pattern;
+	std::string::size_type pos;
+	std::ostringstream xStr, yStr;
+	xStr << x;
+	yStr << y;
+	while ((pos = fileName.find("{x}")) != std::string::npos)
+	{
+		fileName.replace(pos, 3, xStr.str());
+	}
+	while ((pos = fileName.find("{y}")) != std::string::npos)
+	{
+		fileName.replace(pos, 3, yStr.str());
+	}
+	return fileName;
+}
+
+TerrainPager::LoadTask::LoadTask(TerrainPager* pager, int page) :
+		AsyncTask(pager->mName + "-load"), mPager(pager), mPage(page)
+{
+}
+
+AsyncTask::DoneStatus TerrainPager::LoadTask::do_task()
+{
+	//load out of the scene graph, then hand over to update()
+	LoadedPage loaded = mPager->doLoadPage(mPage);
+	{
+		MutexHolder guard(mPager->mLoadedMutex);
+		mPager->mLoadedPages.push_back(loaded);
+	}
+	//
+	return DS_done;
+}
+
+TerrainPager::PageTerrain::PageTerrain(const std::string& name) :
+		GeoMipTerrain(name)
+{
+}
+
+//TypedObject semantics: hardcoded
+TypeHandle TerrainPager::_type_handle;
+TypeHandle TerrainPager::PageTerrain::_type_handle;
+
+} // namespace ely
@@ -0,0 +1,552 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/Support/TerrainQuadTree.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "Support/TerrainQuadTree.h"
+#include <asyncTaskManager.h>
+#include <geomVertexFormat.h>
+#include <geomVertexData.h>
+#include <geomVertexWriter.h>
+#include <geomTriangles.h>
+#include <mutexHolder.h>
+#include <algorithm>
+#include <cmath>
+
+namespace ely
+{
+
+namespace
+{
+///Skirt depth (heightfield units) hiding cracks between blocks of different levels.
+const float SKIRT_DEPTH = 0.02;
+
+///Orders blocks' indexes by distance from a point.
+struct BlockDistanceLess
+{
+	BlockDistanceLess(const std::vector<LPoint3f>& centers,
+			const LPoint3f& point) :
+			mCenters(centers), mPoint(point)
+	{
+	}
+	bool operator()(int b1, int b2) const
+	{
+		return (mCenters[b1] - mPoint).length_squared()
+				< (mCenters[b2] - mPoint).length_squared();
+	}
+private:
+	const std::vector<LPoint3f>& mCenters;
+	LPoint3f mPoint;
+};
+}
+
+TerrainQuadTree::TerrainQuadTree(const std::string& name,
+		const PNMImage& heightField, int blockSize, int minLevel,
+		float nearDist, float farDist, int budget, int numThreads) :
+		mName(name), mFocalPoint(LPoint3f::zero())
+{
+	mRoot = NodePath(name + "_QuadTreeRoot");
+	//copy heights with GeoMipTerrain orientation (y flipped)
+	mXSize = heightField.get_x_size();
+	mYSize = heightField.get_y_size();
+	mHeights.resize(mXSize * mYSize);
+	for (int y = 0; y < mYSize; ++y)
+	{
+		for (int x = 0; x < mXSize; ++x)
+		{
+			mHeights[y * mXSize + x] = heightField.get_gray(x, mYSize - 1 - y);
+		}
+	}
+	//levels: block size is rounded to a power of 2
+	mMaxLevel = 0;
+	while ((2 << mMaxLevel) <= blockSize)
+	{
+		++mMaxLevel;
+	}
+	mBlockSize = 1 << mMaxLevel;
+	mMinLevel = (minLevel < mMaxLevel ? minLevel : mMaxLevel);
+	mNear = nearDist;
+	mFar = (farDist > nearDist ? farDist : nearDist);
+	setBudget(budget);
+	//blocks
+	mNumBlocksX = (mXSize > 1 ? (mXSize - 2) / mBlockSize + 1 : 0);
+	mNumBlocksY = (mYSize > 1 ? (mYSize - 2) / mBlockSize + 1 : 0);
+	mBlocks.resize(mNumBlocksX * mNumBlocksY);
+	for (int by = 0; by < mNumBlocksY; ++by)
+	{
+		for (int bx = 0; bx < mNumBlocksX; ++bx)
+		{
+			Block& block = mBlocks[by * mNumBlocksX + bx];
+			block.mX = bx;
+			block.mY = by;
+			block.mLevel = block.mWantedLevel = block.mBuildLevel = -1;
+			block.mDirty = block.mBuilding = false;
+			std::ostringstream blockName;
+			blockName << name << "_Block_" << bx << "_" << by;
+			block.mNP = mRoot.attach_new_node(blockName.str());
+		}
+	}
+	//quadtree (sets blocks' centers too)
+	mQuadNodes.clear();
+	if (not mBlocks.empty())
+	{
+		mQuadNodes.reserve(2 * mBlocks.size());
+		doBuildQuadNode(0, 0, mNumBlocksX, mNumBlocksY);
+	}
+	//worker threads
+	mTaskChainName = name + "-regenChain";
+	AsyncTaskChain* taskChain =
+			AsyncTaskManager::get_global_ptr()->make_task_chain(
+					mTaskChainName);
+	taskChain->set_num_threads(numThreads > 0 ? numThreads : 0);
+	taskChain->set_frame_sync(false);
+	//counters
+	mStats.mRegenerated = mStats.mDispatched = mStats.mPending =
+			mStats.mVisited = 0;
+	mStats.mTotalRegenerated = 0;
+	mLastStats = mStats;
+}
+
+TerrainQuadTree::~TerrainQuadTree()
+{
+}
+
+void TerrainQuadTree::generate()
+{
+	//build every block at its level, synchronously
+	for (unsigned int b = 0; b < mBlocks.size(); ++b)
+	{
+		Block& block = mBlocks[b];
+		int level = doGetLevel((block.mCenter - mFocalPoint).length());
+		doSwapBlock(b, doBuildBlockGeom(b, level));
+		block.mLevel = block.mWantedLevel = level;
+	}
+	//quadtree uniform levels are recomputed at the next update
+	for (unsigned int n = 0; n < mQuadNodes.size(); ++n)
+	{
+		mQuadNodes[n].mUniformLevel = -1;
+	}
+}
+
+void TerrainQuadTree::update()
+{
+	mStats.mRegenerated = mStats.mDispatched = mStats.mVisited = 0;
+
+	//1: frame boundary: swap in the blocks built by workers
+	std::vector<int> readyBlocks;
+	{
+		MutexHolder guard(mReadyMutex);
+		readyBlocks.swap(mReadyBlocks);
+	}
+	std::vector<int>::const_iterator readyIter;
+	for (readyIter = readyBlocks.begin(); readyIter != readyBlocks.end();
+			++readyIter)
+	{
+		Block& block = mBlocks[*readyIter];
+		PT(GeomNode) geomNode;
+		int level;
+		{
+			MutexHolder guard(mReadyMutex);
+			geomNode = block.mBackBuffer;
+			level = block.mBuildLevel;
+			block.mBackBuffer.clear();
+		}
+		doSwapBlock(*readyIter, geomNode);
+		block.mLevel = level;
+		block.mBuilding = false;
+		++mStats.mRegenerated;
+		//wanted level could have changed meanwhile
+		if ((block.mWantedLevel != block.mLevel) and (not block.mDirty))
+		{
+			block.mDirty = true;
+			mDirtyBlocks.push_back(*readyIter);
+		}
+	}
+	mStats.mTotalRegenerated += mStats.mRegenerated;
+
+	//2: select levels through the quadtree
+	if (not mQuadNodes.empty())
+	{
+		doSelectLevels(0);
+	}
+
+	//3: dispatch the nearest dirty blocks, within budget
+	std::vector<int> stillDirty;
+	std::vector<int>::iterator dirtyIter;
+	for (dirtyIter = mDirtyBlocks.begin(); dirtyIter != mDirtyBlocks.end();
+			++dirtyIter)
+	{
+		Block& block = mBlocks[*dirtyIter];
+		if ((block.mWantedLevel == block.mLevel) and (not block.mBuilding))
+		{
+			//no more dirty
+			block.mDirty = false;
+			continue;
+		}
+		stillDirty.push_back(*dirtyIter);
+	}
+	std::vector<LPoint3f> centers(mBlocks.size());
+	for (unsigned int b = 0; b < mBlocks.size(); ++b)
+	{
+		centers[b] = mBlocks[b].mCenter;
+	}
+	std::sort(stillDirty.begin(), stillDirty.end(),
+			BlockDistanceLess(centers, mFocalPoint));
+	mDirtyBlocks.clear();
+	for (dirtyIter = stillDirty.begin(); dirtyIter != stillDirty.end();
+			++dirtyIter)
+	{
+		Block& block = mBlocks[*dirtyIter];
+		if ((not block.mBuilding) and (mStats.mDispatched < (unsigned int) mBudget))
+		{
+			block.mBuilding = true;
+			block.mDirty = false;
+			PT(AsyncTask) regenTask = new RegenTask(this, *dirtyIter,
+					block.mWantedLevel);
+			regenTask->set_task_chain(mTaskChainName);
+			AsyncTaskManager::get_global_ptr()->add(regenTask);
+			++mStats.mDispatched;
+			continue;
+		}
+		mDirtyBlocks.push_back(*dirtyIter);
+	}
+	mStats.mPending = mDirtyBlocks.size();
+	//publish the counters
+	MutexHolder guard(mReadyMutex);
+	mLastStats = mStats;
+}
+
+TerrainQuadTree::Stats TerrainQuadTree::getStats() const
+{
+	MutexHolder guard(mReadyMutex);
+	return mLastStats;
+}
+
+void TerrainQuadTree::cleanup()
+{
+	AsyncTaskChain* taskChain =
+			AsyncTaskManager::get_global_ptr()->find_task_chain(mTaskChainName);
+	if (taskChain)
+	{
+		taskChain->wait_for_tasks();
+		AsyncTaskManager::get_global_ptr()->remove_task_chain(mTaskChainName);
+	}
+	//
+	MutexHolder guard(mReadyMutex);
+	std::vector<int>::const_iterator readyIter;
+	for (readyIter = mReadyBlocks.begin(); readyIter != mReadyBlocks.end();
+			++readyIter)
+	{
+		mBlocks[*readyIter].mBackBuffer.clear();
+	}
+	mReadyBlocks.clear();
+	mDirtyBlocks.clear();
+}
+
+int TerrainQuadTree::doBuildQuadNode(int x0, int y0, int x1, int y1)
+{
+	int nodeIdx = mQuadNodes.size();
+	mQuadNodes.push_back(QuadNode());
+	QuadNode node;
+	node.mX0 = x0;
+	node.mY0 = y0;
+	node.mX1 = x1;
+	node.mY1 = y1;
+	node.mUniformLevel = -1;
+	node.mChildren[0] = node.mChildren[1] = node.mChildren[2] =
+			node.mChildren[3] = -1;
+	float minZ = 1.0, maxZ = 0.0;
+	if ((x1 - x0 == 1) and (y1 - y0 == 1))
+	{
+		//leaf: scan block heights
+		int xEnd = min(x1 * mBlockSize, mXSize - 1);
+		int yEnd = min(y1 * mBlockSize, mYSize - 1);
+		for (int y = y0 * mBlockSize; y <= yEnd; ++y)
+		{
+			for (int x = x0 * mBlockSize; x <= xEnd; ++x)
+			{
+				float h = doGetHeight(x, y);
+				minZ = (h < minZ ? h : minZ);
+				maxZ = (h > maxZ ? h : maxZ);
+			}
+		}
+		mBlocks[y0 * mNumBlocksX + x0].mCenter = LPoint3f(
+				(x0 * mBlockSize + xEnd) / 2.0, (y0 * mBlockSize + yEnd) / 2.0,
+				(minZ + maxZ) / 2.0);
+	}
+	else
+	{
+		//split in (up to) four children
+		int xm = x0 + (x1 - x0 + 1) / 2;
+		int ym = y0 + (y1 - y0 + 1) / 2;
+		int ranges[4][4] =
+		{
+		{ x0, y0, xm, ym },
+		{ xm, y0, x1, ym },
+		{ x0, ym, xm, y1 },
+		{ xm, ym, x1, y1 } };
+		int c = 0;
+		for (int r = 0; r < 4; ++r)
+		{
+			if ((ranges[r][2] > ranges[r][0]) and (ranges[r][3] > ranges[r][1]))
+			{
+				int child = doBuildQuadNode(ranges[r][0], ranges[r][1],
+						ranges[r][2], ranges[r][3]);
+				node.mChildren[c++] = child;
+				minZ = min(minZ, mQuadNodes[child].mMin.get_z());
+				maxZ = max(maxZ, mQuadNodes[child].mMax.get_z());
+			}
+		}
+	}
+	node.mMin = LPoint3f(x0 * mBlockSize, y0 * mBlockSize, minZ);
+	node.mMax = LPoint3f(min(x1 * mBlockSize, mXSize - 1),
+			min(y1 * mBlockSize, mYSize - 1), maxZ);
+	mQuadNodes[nodeIdx] = node;
+	return nodeIdx;
+}
+
+void TerrainQuadTree::doSelectLevels(int nodeIdx)
+{
+	++mStats.mVisited;
+	QuadNode& node = mQuadNodes[nodeIdx];
+	//min/max distances of the focal point from the node's box
+	LVector3f minDelta, maxDelta;
+	for (int i = 0; i < 3; ++i)
+	{
+		float p = mFocalPoint[i];
+		minDelta[i] =
+				(p < node.mMin[i] ?
+						node.mMin[i] - p : (p > node.mMax[i] ? p - node.mMax[i] : 0.0));
+		maxDelta[i] = max(fabs(p - node.mMin[i]), fabs(p - node.mMax[i]));
+	}
+	int minLevel = doGetLevel(minDelta.length());
+	int maxLevel = doGetLevel(maxDelta.length());
+	if (minLevel == maxLevel)
+	{
+		//the whole subtree is at the same level
+		if (node.mUniformLevel != minLevel)
+		{
+			doAssignLevel(nodeIdx, minLevel);
+		}
+		return;
+	}
+	node.mUniformLevel = -1;
+	if (node.mChildren[0] == -1)
+	{
+		//leaf: decide by block center
+		int blockIdx = node.mY0 * mNumBlocksX + node.mX0;
+		doSetWantedLevel(blockIdx,
+				doGetLevel((mBlocks[blockIdx].mCenter - mFocalPoint).length()));
+		return;
+	}
+	for (int c = 0; (c < 4) and (node.mChildren[c] != -1); ++c)
+	{
+		doSelectLevels(node.mChildren[c]);
+	}
+}
+
+void TerrainQuadTree::doAssignLevel(int nodeIdx, int level)
+{
+	QuadNode& node = mQuadNodes[nodeIdx];
+	node.mUniformLevel = level;
+	if (node.mChildren[0] == -1)
+	{
+		doSetWantedLevel(node.mY0 * mNumBlocksX + node.mX0, level);
+		return;
+	}
+	for (int c = 0; (c < 4) and (node.mChildren[c] != -1); ++c)
+	{
+		doAssignLevel(node.mChildren[c], level);
+	}
+}
+
+void TerrainQuadTree::doSetWantedLevel(int blockIdx, int level)
+{
+	Block& block = mBlocks[blockIdx];
+	RETURN_ON_COND(block.mWantedLevel == level,)
+
+	block.mWantedLevel = level;
+	if (not block.mDirty)
+	{
+		block.mDirty = true;
+		mDirtyBlocks.push_back(blockIdx);
+	}
+}
+
+int TerrainQuadTree::doGetLevel(float distance) const
+{
+	//same as GeoMipTerrain: linear between near and far
+	if (distance <= mNear)
+	{
+		return mMinLevel;
+	}
+	if (distance >= mFar)
+	{
+		return mMaxLevel;
+	}
+	int level = mMinLevel
+			+ (int) ((distance - mNear) / (mFar - mNear)
+					* (mMaxLevel - mMinLevel + 1));
+	return (level > mMaxLevel ? mMaxLevel : level);
+}
+
+PT(GeomNode) TerrainQuadTree::doBuildBlockGeom(int blockIdx, int level) const
+{
+	const Block& block = mBlocks[blockIdx];
+	int step = 1 << level;
+	int x0 = block.mX * mBlockSize;
+	int y0 = block.mY * mBlockSize;
+	//vertices per side (block may be clipped at heightfield borders)
+	int nx = min(mBlockSize, mXSize - 1 - x0) / step + 1;
+	int ny = min(mBlockSize, mYSize - 1 - y0) / step + 1;
+	//grid + 4 skirts
+	int numSkirtVerts = 2 * nx + 2 * ny;
+	PT(GeomVertexData) vdata = new GeomVertexData(mName,
+			GeomVertexFormat::get_v3n3t2(), Geom::UH_static);
+	vdata->reserve_num_rows(nx * ny + numSkirtVerts);
+	GeomVertexWriter vertex(vdata, InternalName::get_vertex());
+	GeomVertexWriter normal(vdata, InternalName::get_normal());
+	GeomVertexWriter texcoord(vdata, InternalName::get_texcoord());
+	float uScale = 1.0 / (mXSize - 1);
+	float vScale = 1.0 / (mYSize - 1);
+	//grid
+	for (int j = 0; j < ny; ++j)
+	{
+		for (int i = 0; i < nx; ++i)
+		{
+			int x = x0 + i * step;
+			int y = y0 + j * step;
+			vertex.add_data3f(x, y, doGetHeight(x, y));
+			//same as GeoMipTerrain::get_normal
+			LVector3f n((doGetHeight(x - 1, y) - doGetHeight(x + 1, y)) * 0.5,
+					(doGetHeight(x, y - 1) - doGetHeight(x, y + 1)) * 0.5, 1.0);
+			n.normalize();
+			normal.add_data3f(n);
+			texcoord.add_data2f(x * uScale, y * vScale);
+		}
+	}
+	//skirts: bottom, top, left, right edges lowered
+	int edgeStart[4] =
+	{ 0, (ny - 1) * nx, 0, nx - 1 };
+	int edgeStride[4] =
+	{ 1, 1, nx, nx };
+	int edgeLen[4] =
+	{ nx, nx, ny, ny };
+	int skirtStart[4];
+	int base = nx * ny;
+	for (int e = 0; e < 4; ++e)
+	{
+		skirtStart[e] = base;
+		for (int k = 0; k < edgeLen[e]; ++k)
+		{
+			int gridIdx = edgeStart[e] + k * edgeStride[e];
+			int i = gridIdx % nx;
+			int j = gridIdx / nx;
+			int x = x0 + i * step;
+			int y = y0 + j * step;
+			vertex.add_data3f(x, y, doGetHeight(x, y) - SKIRT_DEPTH);
+			normal.add_data3f(0.0, 0.0, 1.0);
+			texcoord.add_data2f(x * uScale, y * vScale);
+		}
+		base += edgeLen[e];
+	}
+	//triangles
+	PT(GeomTriangles) tris = new GeomTriangles(Geom::UH_static);
+	for (int j = 0; j < ny - 1; ++j)
+	{
+		for (int i = 0; i < nx - 1; ++i)
+		{
+			int v00 = j * nx + i;
+			int v10 = v00 + 1;
+			int v01 = v00 + nx;
+			int v11 = v01 + 1;
+			tris->add_vertices(v00, v10, v11);
+			tris->add_vertices(v00, v11, v01);
+		}
+	}
+	for (int e = 0; e < 4; ++e)
+	{
+		for (int k = 0; k < edgeLen[e] - 1; ++k)
+		{
+			int a = edgeStart[e] + k * edgeStride[e];
+			int b = a + edgeStride[e];
+			int c = skirtStart[e] + k;
+			int d = c + 1;
+			//facing outwards: the bottom and right edges run
+			//counterclockwise (seen from outside), the others clockwise
+			if ((e == 0) or (e == 3))
+			{
+				tris->add_vertices(a, c, b);
+				tris->add_vertices(b, c, d);
+			}
+			else
+			{
+				tris->add_vertices(a, b, c);
+				tris->add_vertices(b, d, c);
+			}
+		}
+	}
+	tris->close_primitive();
+	PT(Geom) geom = new Geom(vdata);
+	geom->add_primitive(tris);
+	std::ostringstream geomName;
+	geomName << mName << "_Geom_" << block.mX << "_" << block.mY << "_" << level;
+	PT(GeomNode) geomNode = new GeomNode(geomName.str());
+	geomNode->add_geom(geom);
+	return geomNode;
+}
+
+void TerrainQuadTree::doSwapBlock(int blockIdx, PT(GeomNode) geomNode)
+{
+	PandaNode* blockNode = mBlocks[blockIdx].mNP.node();
+	blockNode->remove_all_children();
+	if (geomNode)
+	{
+		blockNode->add_child(geomNode);
+	}
+}
+
+TerrainQuadTree::RegenTask::RegenTask(TerrainQuadTree* tree, int block,
+		int level) :
+		AsyncTask(tree->mName + "-regen"), mTree(tree), mBlock(block), mLevel(
+				level)
+{
+}
+
+AsyncTask::DoneStatus TerrainQuadTree::RegenTask::do_task()
+{
+	//build into the back buffer
+	PT(GeomNode) geomNode = mTree->doBuildBlockGeom(mBlock, mLevel);
+	{
+		MutexHolder guard(mTree->mReadyMutex);
+		Block& block = mTree->mBlocks[mBlock];
+		block.mBackBuffer = geomNode;
+		block.mBuildLevel = mLevel;
+		mTree->mReadyBlocks.push_back(mBlock);
+	}
+	//
+	return DS_done;
+}
+
+//TypedObject semantics: hardcoded
+TypeHandle TerrainQuadTree::_type_handle;
+
+} // namespace ely
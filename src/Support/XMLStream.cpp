@@ -0,0 +1,416 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/Support/XMLStream.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "Support/XMLStream.h"
+#include "Utilities/Tools.h"
+#include "Support/tinyxlm2/tinyxml2.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdlib>
+
+using tinyxml2::XMLUtil;
+
+namespace
+{
+///The predefined entities.
+struct Entity
+{
+	const char* mPattern;
+	int mLength;
+	char mValue;
+};
+const Entity ENTITIES[] =
+{
+{ "quot", 4, '\"' },
+{ "amp", 3, '&' },
+{ "apos", 4, '\'' },
+{ "lt", 2, '<' },
+{ "gt", 2, '>' } };
+const int NUM_ENTITIES = sizeof(ENTITIES) / sizeof(ENTITIES[0]);
+}
+
+namespace ely
+{
+
+XMLStream::XMLStream() :
+		mBuffer(NULL), mSize(0), mMapSize(0), mOwnedBuffer(false), mErrorLine(0)
+{
+}
+
+XMLStream::~XMLStream()
+{
+	close();
+}
+
+bool XMLStream::open(const std::string& fileName)
+{
+	close();
+	int fd = ::open(fileName.c_str(), O_RDONLY);
+	RETURN_ON_COND(fd < 0, doSetError(NULL, "Cannot open " + fileName))
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0)
+	{
+		::close(fd);
+		return doSetError(NULL, "Cannot stat " + fileName);
+	}
+	mSize = fileStat.st_size;
+	long pageSize = sysconf(_SC_PAGESIZE);
+	if ((mSize > 0) and (mSize % pageSize != 0))
+	{
+		//private writable mapping: the bytes past the end of the file, up to
+		//the page end, are zero so the buffer is NUL terminated
+		void* mapped = mmap(NULL, mSize, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+				fd, 0);
+		if (mapped != MAP_FAILED)
+		{
+			mBuffer = reinterpret_cast<char*>(mapped);
+			mMapSize = mSize;
+		}
+	}
+	if (not mBuffer)
+	{
+		//no room for the terminator (or mapping failed): read the file
+		mBuffer = reinterpret_cast<char*>(malloc(mSize + 1));
+		mOwnedBuffer = (mBuffer != NULL);
+		size_t read = 0;
+		while (mBuffer and (read < mSize))
+		{
+			ssize_t num = ::read(fd, mBuffer + read, mSize - read);
+			if (num <= 0)
+			{
+				break;
+			}
+			read += num;
+		}
+		if ((not mBuffer) or (read != mSize))
+		{
+			::close(fd);
+			close();
+			return doSetError(NULL, "Cannot read " + fileName);
+		}
+		mBuffer[mSize] = '\0';
+	}
+	::close(fd);
+	return true;
+}
+
+bool XMLStream::openBuffer(char* buffer, size_t size)
+{
+	close();
+	RETURN_ON_COND(not buffer, false)
+
+	mBuffer = buffer;
+	mSize = size;
+	mBuffer[mSize] = '\0';
+	return true;
+}
+
+void XMLStream::close()
+{
+	if (mMapSize > 0)
+	{
+		munmap(mBuffer, mMapSize);
+	}
+	else if (mOwnedBuffer)
+	{
+		free(mBuffer);
+	}
+	mBuffer = NULL;
+	mSize = mMapSize = 0;
+	mOwnedBuffer = false;
+}
+
+bool XMLStream::parse(XMLStreamHandler& handler)
+{
+	RETURN_ON_COND(not mBuffer, doSetError(NULL, "No open buffer"))
+
+	mErrorStr.clear();
+	mErrorLine = 0;
+	mElements.clear();
+	bool hasBOM;
+	char* p = const_cast<char*>(XMLUtil::ReadBOM(mBuffer, &hasBOM));
+	while (true)
+	{
+		//text
+		char* text = p;
+		while (*p and (*p != '<'))
+		{
+			++p;
+		}
+		if ((not mElements.empty()) and (XMLUtil::SkipWhiteSpace(text) < p))
+		{
+			if (not handler.text(XMLStringView(text, doDecode(text, p - text))))
+			{
+				return true;
+			}
+		}
+		if (not *p)
+		{
+			break;
+		}
+		//markup
+		if (XMLUtil::StringEqual(p, "<?", 2))
+		{
+			//declaration or processing instruction
+			char* end = strstr(p, "?>");
+			RETURN_ON_COND(not end, doSetError(p, "Unterminated declaration"))
+
+			p = end + 2;
+		}
+		else if (XMLUtil::StringEqual(p, "<!--", 4))
+		{
+			char* end = strstr(p + 4, "-->");
+			RETURN_ON_COND(not end, doSetError(p, "Unterminated comment"))
+
+			p = end + 3;
+		}
+		else if (XMLUtil::StringEqual(p, "<![CDATA[", 9))
+		{
+			char* data = p + 9;
+			char* end = strstr(data, "]]>");
+			RETURN_ON_COND(not end, doSetError(p, "Unterminated CDATA"))
+
+			p = end + 3;
+			if ((not mElements.empty())
+					and (not handler.text(XMLStringView(data, end - data))))
+			{
+				return true;
+			}
+		}
+		else if (XMLUtil::StringEqual(p, "<!", 2))
+		{
+			//DTD (without internal subset)
+			char* end = strchr(p, '>');
+			RETURN_ON_COND(not end, doSetError(p, "Unterminated DTD"))
+
+			p = end + 1;
+		}
+		else if (p[1] == '/')
+		{
+			//end tag
+			char* tag = p;
+			XMLStringView name;
+			p = doParseName(p + 2, name);
+			RETURN_ON_COND(not p, doSetError(tag, "Bad end tag name"))
+
+			char* nameEnd = p;
+			p = XMLUtil::SkipWhiteSpace(p);
+			RETURN_ON_COND(*p != '>', doSetError(tag, "Bad end tag"))
+			RETURN_ON_COND(
+					mElements.empty() or (mElements.back().mSize != name.mSize)
+					or strncmp(mElements.back().mData, name.mData,
+							name.mSize), doSetError(tag, "Mismatched end tag"))
+
+			++p;
+			*nameEnd = '\0';
+			mElements.pop_back();
+			if (not handler.endElement(name))
+			{
+				return true;
+			}
+		}
+		else
+		{
+			//start tag
+			char* tag = p;
+			XMLStringView name;
+			p = doParseName(p + 1, name);
+			RETURN_ON_COND(not p, doSetError(tag, "Bad element name"))
+
+			//positions to be NUL terminated once the tag has been scanned
+			char* nameEnd = p;
+			mAttributes.clear();
+			bool empty = false;
+			while (true)
+			{
+				p = XMLUtil::SkipWhiteSpace(p);
+				if (*p == '>')
+				{
+					++p;
+					break;
+				}
+				if ((p[0] == '/') and (p[1] == '>'))
+				{
+					p += 2;
+					empty = true;
+					break;
+				}
+				XMLStreamAttribute attribute;
+				char* attrName = p;
+				p = doParseName(p, attribute.mName);
+				RETURN_ON_COND(not p, doSetError(attrName, "Bad attribute name"))
+
+				char* attrNameEnd = p;
+				p = XMLUtil::SkipWhiteSpace(p);
+				RETURN_ON_COND(*p != '=', doSetError(attrName, "Missing '='"))
+
+				p = XMLUtil::SkipWhiteSpace(p + 1);
+				char quote = *p;
+				RETURN_ON_COND((quote != '\"') and (quote != '\''),
+						doSetError(attrName, "Missing quote"))
+
+				char* value = p + 1;
+				p = strchr(value, quote);
+				RETURN_ON_COND(not p, doSetError(attrName, "Unterminated value"))
+
+				*attrNameEnd = '\0';
+				*p = '\0';
+				++p;
+				attribute.mValue = XMLStringView(value,
+						doDecode(value, (p - 1) - value));
+				mAttributes.push_back(attribute);
+			}
+			*nameEnd = '\0';
+			if (not handler.startElement(name,
+					mAttributes.empty() ? NULL : &mAttributes[0],
+					mAttributes.size()))
+			{
+				return true;
+			}
+			if (empty)
+			{
+				if (not handler.endElement(name))
+				{
+					return true;
+				}
+			}
+			else
+			{
+				mElements.push_back(name);
+			}
+		}
+	}
+	RETURN_ON_COND(not mElements.empty(),
+			doSetError(p, "Unclosed element " + mElements.back().str()))
+
+	return true;
+}
+
+bool XMLStream::doSetError(const char* p, const std::string& error)
+{
+	mErrorStr = error;
+	mErrorLine = 0;
+	if (p and mBuffer)
+	{
+		mErrorLine = 1;
+		for (const char* c = mBuffer; c < p; ++c)
+		{
+			if (*c == '\n')
+			{
+				++mErrorLine;
+			}
+		}
+	}
+	return false;
+}
+
+char* XMLStream::doParseName(char* p, XMLStringView& name)
+{
+	RETURN_ON_COND(not XMLUtil::IsNameStartChar(*p), NULL)
+
+	char* start = p;
+	while (*p and XMLUtil::IsNameChar(*p))
+	{
+		++p;
+	}
+	name = XMLStringView(start, p - start);
+	return p;
+}
+
+size_t XMLStream::doDecode(char* data, size_t size)
+{
+	//fast path: nothing to decode (so nothing is written)
+	char* end = data + size;
+	char* q = data;
+	while ((q < end) and (*q != '&') and (*q != '\r'))
+	{
+		++q;
+	}
+	RETURN_ON_COND(q == end, size)
+
+	//decode in place: the result is never longer than the source
+	char* p = q;
+	while (p < end)
+	{
+		if (*p == '\r')
+		{
+			//new line normalization
+			*q++ = '\n';
+			p += ((p + 1 < end) and (p[1] == '\n')) ? 2 : 1;
+		}
+		else if ((*p == '&') and (p + 1 < end) and (p[1] == '#'))
+		{
+			//character reference
+			char buf[10];
+			int len = 0;
+			const char* next = XMLUtil::GetCharacterRef(p, buf, &len);
+			if ((not next) or (next > end))
+			{
+				*q++ = *p++;
+				continue;
+			}
+			for (int i = 0; i < len; ++i)
+			{
+				*q++ = buf[i];
+			}
+			p = const_cast<char*>(next);
+		}
+		else if (*p == '&')
+		{
+			//predefined entity
+			int i;
+			for (i = 0; i < NUM_ENTITIES; ++i)
+			{
+				const Entity& entity = ENTITIES[i];
+				if ((p + entity.mLength + 1 < end)
+						and (strncmp(p + 1, entity.mPattern, entity.mLength)
+								== 0) and (p[entity.mLength + 1] == ';'))
+				{
+					*q++ = entity.mValue;
+					p += entity.mLength + 2;
+					break;
+				}
+			}
+			if (i == NUM_ENTITIES)
+			{
+				//not an entity: copied as is
+				*q++ = *p++;
+			}
+		}
+		else
+		{
+			*q++ = *p++;
+		}
+	}
+	//keep names and values NUL terminated
+	if (q < end)
+	{
+		*q = '\0';
+	}
+	return q - data;
+}
+
+} // namespace ely
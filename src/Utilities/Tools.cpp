@@ -24,6 +24,7 @@
 #include "Utilities/Tools.h"
 #include "ObjectModel/Object.h"
 #include "Utilities/ComponentSuite.h"
+#include "Support/FrameArena.h"
 
 namespace ely
 {
@@ -66,7 +67,9 @@ std::vector<std::string> parseCompoundString(
 	//parse
 	std::vector<std::string> substrings;
 	int len = compoundString.size() + 1;
-	char* dest = new char[len];
+	//scratch buffer
+	FrameArena::Scope scratch;
+	char* dest = scratch.getArena().allocArray<char>(len);
 	strncpy(dest, compoundString.c_str(), len);
 	//find
 	char* pch;
@@ -99,7 +102,6 @@ std::vector<std::string> parseCompoundString(
 			stop = true;
 		}
 	}
-	delete[] dest;
 	//
 	return substrings;
 }
@@ -107,7 +109,9 @@ std::vector<std::string> parseCompoundString(
 std::string eraseCharacter(const std::string& source, int character)
 {
 	int len = source.size() + 1;
-	char* dest = new char[len];
+	//scratch buffer
+	FrameArena::Scope scratch;
+	char* dest = scratch.getArena().allocArray<char>(len);
 	char* start = dest;
 	strncpy(dest, source.c_str(), len);
 	//erase
@@ -122,7 +126,6 @@ std::string eraseCharacter(const std::string& source, int character)
 		pch = strchr(pch, character);
 	}
 	std::string outStr(dest);
-	delete[] dest;
 	return outStr;
 }
 
@@ -130,7 +133,9 @@ std::string replaceCharacter(const std::string& source, int character,
 		int replacement)
 {
 	int len = source.size() + 1;
-	char* dest = new char[len];
+	//scratch buffer
+	FrameArena::Scope scratch;
+	char* dest = scratch.getArena().allocArray<char>(len);
 	strncpy(dest, source.c_str(), len);
 	//replace hyphens
 	char* pch;
@@ -141,7 +146,6 @@ std::string replaceCharacter(const std::string& source, int character,
 		pch = strchr(pch + 1, character);
 	}
 	std::string outStr(dest);
-	delete[] dest;
 	return outStr;
 }
 
@@ -199,6 +203,11 @@ void initTypedObjects()
 	Terrain::init_type();
 	TerrainTemplate::init_type();
 	GeoMipTerrainRef::init_type();
+	TerrainQuadTree::init_type();
+	TerrainPager::init_type();
+	TerrainPager::PageTerrain::init_type();
+	InstanceBatch::init_type();
+	ModelLoader::init_type();
 	//
 }
 
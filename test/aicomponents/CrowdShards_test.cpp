@@ -0,0 +1,201 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/test/aicomponents/CrowdShards_test.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "AISuiteFixture.h"
+#include "Support/RecastNavigationLocal/CrowdShards.h"
+#include <DetourNavMeshBuilder.h>
+#include <DetourCommon.h>
+#include <cstring>
+
+struct CrowdShardsTestCaseFixture
+{
+	///a flat 20x10 navmesh (a single quad) split into two 10x10 shards
+	CrowdShardsTestCaseFixture() :
+			nav(NULL)
+	{
+		static const unsigned short verts[] =
+		{ 0, 0, 0, 0, 0, 20, 40, 0, 20, 40, 0, 0 };
+		static const unsigned short polys[] =
+		{ 0, 1, 2, 3, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff,
+				0xffff };
+		static const unsigned short polyFlags[] =
+		{ 1 };
+		static const unsigned char polyAreas[] =
+		{ 0 };
+		dtNavMeshCreateParams params;
+		memset(&params, 0, sizeof(params));
+		params.verts = verts;
+		params.vertCount = 4;
+		params.polys = polys;
+		params.polyFlags = polyFlags;
+		params.polyAreas = polyAreas;
+		params.polyCount = 1;
+		params.nvp = 6;
+		params.walkableHeight = 2.0;
+		params.walkableRadius = 0.5;
+		params.walkableClimb = 0.5;
+		dtVset(params.bmin, 0.0, 0.0, 0.0);
+		dtVset(params.bmax, 20.0, 1.0, 10.0);
+		params.cs = 0.5;
+		params.ch = 0.2;
+		params.buildBvTree = true;
+		unsigned char* data = NULL;
+		int dataSize = 0;
+		if (dtCreateNavMeshData(&params, &data, &dataSize))
+		{
+			nav = dtAllocNavMesh();
+			if (dtStatusFailed(nav->init(data, dataSize, DT_TILE_FREE_DATA)))
+			{
+				dtFreeNavMesh(nav);
+				nav = NULL;
+			}
+		}
+		dtVcopy(bmin, params.bmin);
+		dtVcopy(bmax, params.bmax);
+		memset(&agentParams, 0, sizeof(agentParams));
+		agentParams.radius = 0.5;
+		agentParams.height = 2.0;
+		agentParams.maxAcceleration = 8.0;
+		agentParams.maxSpeed = 2.0;
+		agentParams.collisionQueryRange = 3.0;
+		agentParams.pathOptimizationRange = 10.0;
+	}
+	~CrowdShardsTestCaseFixture()
+	{
+		shards.cleanup();
+		dtFreeNavMesh(nav);
+	}
+	///the (first) active agent's index of a shard's crowd
+	int activeAgent(int shard)
+	{
+		dtCrowd* crowd = shards.getShardCrowd(shard);
+		for (int i = 0; i < crowd->getAgentCount(); ++i)
+		{
+			if (crowd->getAgent(i)->active)
+			{
+				return i;
+			}
+		}
+		return -1;
+	}
+	dtNavMesh* nav;
+	float bmin[3], bmax[3];
+	dtCrowdAgentParams agentParams;
+	CrowdShards shards;
+};
+
+/// AI suite
+BOOST_FIXTURE_TEST_SUITE(AI, AISuiteFixture)
+
+/// Test cases
+BOOST_FIXTURE_TEST_CASE(CrowdShardsBoundaryCrossingTEST,
+		CrowdShardsTestCaseFixture)
+{
+	BOOST_REQUIRE(nav);
+	BOOST_REQUIRE(shards.init(2, 4, 2, 0.5, nav, NULL, bmin, bmax, 0, "test"));
+	BOOST_REQUIRE_EQUAL(shards.getNumShards(), 2);
+	//an agent near the boundary, walking across it
+	float pos[3] =
+	{ 8.0, 0.0, 5.0 };
+	int idx = shards.addAgent(pos, &agentParams);
+	BOOST_REQUIRE(idx != -1);
+	BOOST_CHECK_EQUAL(shards.getShardAgentCount(0), 1);
+	float vel[3] =
+	{ 1.0, 0.0, 0.0 };
+	BOOST_CHECK(shards.requestMoveVelocity(idx, vel));
+	//its ghost is persistent and updated in place
+	shards.update(0.1);
+	BOOST_CHECK_EQUAL(shards.getNumGhosts(), 1u);
+	int ghostIdx = activeAgent(1);
+	BOOST_REQUIRE(ghostIdx != -1);
+	for (int i = 0; i < 5; ++i)
+	{
+		shards.update(0.1);
+		BOOST_CHECK_EQUAL(shards.getNumGhosts(), 1u);
+		BOOST_CHECK_EQUAL(activeAgent(1), ghostIdx);
+	}
+	BOOST_CHECK_EQUAL(shards.getShardAgentCount(1), 0);
+	//cross the boundary (by more than the radius)
+	for (int i = 0; (i < 100) and (shards.getNumMigrations() == 0); ++i)
+	{
+		shards.update(0.1);
+	}
+	BOOST_CHECK_EQUAL(shards.getNumMigrations(), 1u);
+	BOOST_CHECK_EQUAL(shards.getShardAgentCount(0), 0);
+	BOOST_CHECK_EQUAL(shards.getShardAgentCount(1), 1);
+	BOOST_REQUIRE(shards.getAgent(idx));
+	float x = shards.getAgent(idx)->npos[0];
+	BOOST_CHECK(x > 10.0 + agentParams.radius);
+	//the move request survives the migration
+	shards.update(0.1);
+	BOOST_CHECK(shards.getAgent(idx)->npos[0] > x);
+	//now mirrored into the first shard, until far from the boundary
+	BOOST_CHECK_EQUAL(shards.getNumGhosts(), 1u);
+	BOOST_CHECK(activeAgent(0) != -1);
+	for (int i = 0; (i < 100) and (shards.getNumGhosts() > 0); ++i)
+	{
+		shards.update(0.1);
+	}
+	BOOST_CHECK_EQUAL(shards.getNumGhosts(), 0u);
+	BOOST_CHECK_EQUAL(activeAgent(0), -1);
+	BOOST_CHECK_EQUAL(shards.getNumDroppedGhosts(), 0u);
+	BOOST_CHECK_EQUAL(shards.getNumDeferredMigrations(), 0u);
+}
+
+BOOST_FIXTURE_TEST_CASE(CrowdShardsFullShardsTEST, CrowdShardsTestCaseFixture)
+{
+	BOOST_REQUIRE(nav);
+	//one ghost and one agent per shard
+	BOOST_REQUIRE(shards.init(2, 1, 1, 0.5, nav, NULL, bmin, bmax, 0, "test"));
+	float pos[3] =
+	{ 9.0, 0.0, 2.0 };
+	int first = shards.addAgent(pos, &agentParams);
+	pos[2] = 8.0;
+	//no room left in the first shard: into the nearest one
+	int second = shards.addAgent(pos, &agentParams);
+	BOOST_REQUIRE((first != -1) and (second != -1));
+	BOOST_CHECK_EQUAL(shards.getShardAgentCount(0), 1);
+	BOOST_CHECK_EQUAL(shards.getShardAgentCount(1), 1);
+	BOOST_CHECK_EQUAL(shards.addAgent(pos, &agentParams), -1);
+	//both near the boundary: each one mirrored into the other shard
+	shards.update(0.1);
+	BOOST_CHECK_EQUAL(shards.getNumGhosts(), 2u);
+	BOOST_CHECK_EQUAL(shards.getNumDroppedGhosts(), 0u);
+	//the ghost of a removed agent goes away
+	shards.removeAgent(second);
+	shards.update(0.1);
+	BOOST_CHECK_EQUAL(shards.getNumGhosts(), 1u);
+	//more agents near the boundary than room for ghosts: dropped, and counted
+	BOOST_REQUIRE(shards.init(2, 2, 1, 0.5, nav, NULL, bmin, bmax, 0, "test"));
+	pos[2] = 2.0;
+	BOOST_REQUIRE(shards.addAgent(pos, &agentParams) != -1);
+	pos[2] = 8.0;
+	BOOST_REQUIRE(shards.addAgent(pos, &agentParams) != -1);
+	shards.update(0.1);
+	BOOST_CHECK_EQUAL(shards.getNumGhosts(), 1u);
+	BOOST_CHECK_EQUAL(shards.getNumDroppedGhosts(), 1u);
+	//owned agents keep their room
+	BOOST_CHECK_EQUAL(shards.getShardAgentCount(0), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // AI suite
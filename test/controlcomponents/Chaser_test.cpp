@@ -43,4 +43,53 @@ BOOST_AUTO_TEST_CASE(ChaserInitializeTEST)
 	BOOST_TEST_MESSAGE("TESTING Chaser");
 }
 
+BOOST_AUTO_TEST_CASE(ChaserSweepStartTEST)
+{
+	LPoint3f center(10.0, 0.0, 0.0);
+	LVector3f dir(1.0, 0.0, 0.0);
+	//from inside the chased bounds: where the ray leaves them
+	BOOST_CHECK_CLOSE(Chaser::getSphereExit(center, dir, center, 2.0), 2.0,
+			1.0e-3);
+	BOOST_CHECK_CLOSE(
+			Chaser::getSphereExit(LPoint3f(9.0, 0.0, 0.0), dir, center, 2.0),
+			3.0, 1.0e-3);
+	//from before them: past their far side
+	BOOST_CHECK_CLOSE(
+			Chaser::getSphereExit(LPoint3f::zero(), dir, center, 2.0), 12.0,
+			1.0e-3);
+	//bounds missed or behind: from the origin
+	BOOST_CHECK_EQUAL(
+			Chaser::getSphereExit(LPoint3f(0.0, 5.0, 0.0), dir, center, 2.0),
+			0.0);
+	BOOST_CHECK_EQUAL(
+			Chaser::getSphereExit(LPoint3f(20.0, 0.0, 0.0), dir, center, 2.0),
+			0.0);
+}
+
+BOOST_AUTO_TEST_CASE(ChaserHeightCacheTEST)
+{
+	Chaser::HeightCache cache;
+	float height = 0.0;
+	BOOST_CHECK(not cache.lookup(0, 0, 0, 1, 0.0, 1.0, height));
+	cache.store(0, 0, 0, 1, 0.0, 5.0);
+	BOOST_REQUIRE(cache.lookup(0, 0, 0, 1, 0.5, 1.0, height));
+	BOOST_CHECK_EQUAL(height, 5.0);
+	//expired
+	BOOST_CHECK(not cache.lookup(0, 0, 0, 1, 2.0, 1.0, height));
+	//other heights and terrains don't match
+	BOOST_CHECK(not cache.lookup(0, 0, 3, 1, 0.5, 1.0, height));
+	BOOST_CHECK(not cache.lookup(0, 0, 0, 2, 0.5, 1.0, height));
+	//the oldest are replaced
+	for (int i = 1; i <= Chaser::HeightCache::SIZE; ++i)
+	{
+		cache.store(i, 0, 0, 1, 0.0, (float) i);
+	}
+	BOOST_CHECK(not cache.lookup(0, 0, 0, 1, 0.5, 1.0, height));
+	BOOST_REQUIRE(cache.lookup(1, 0, 0, 1, 0.5, 1.0, height));
+	BOOST_CHECK_EQUAL(height, 1.0);
+	//swapped terrain: all forgotten
+	cache.invalidate();
+	BOOST_CHECK(not cache.lookup(1, 0, 0, 1, 0.5, 1.0, height));
+}
+
 BOOST_AUTO_TEST_SUITE_END() // Control suite
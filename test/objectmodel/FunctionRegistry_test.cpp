@@ -0,0 +1,148 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/test/objectmodel/FunctionRegistry_test.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "ObjectModelSuiteFixture.h"
+#include "ObjectModel/FunctionRegistry.h"
+#include <sstream>
+
+void FunctionRegistryTestFunction()
+{
+}
+
+void FunctionRegistryTestOther()
+{
+}
+
+struct FunctionRegistryTestCaseFixture
+{
+	FunctionRegistryTestCaseFixture() :
+			registry(FunctionRegistry::GetSingleton())
+	{
+		registry.unregisterFunctions(FunctionRegistry::INSTANCEUPDATES);
+	}
+	~FunctionRegistryTestCaseFixture()
+	{
+		registry.unregisterFunctions(FunctionRegistry::INSTANCEUPDATES);
+	}
+	FunctionRegistry& registry;
+};
+
+/// ObjectModel suite
+BOOST_FIXTURE_TEST_SUITE(ObjectModel, ObjectModelSuiteFixture)
+
+/// Test cases
+BOOST_FIXTURE_TEST_CASE(FunctionRegistryLookupTEST,
+		FunctionRegistryTestCaseFixture)
+{
+	unsigned int numFunctions = registry.getNumFunctions();
+	ELY_REGISTER_FUNCTION(INSTANCEUPDATES, FunctionRegistryTestFunction);
+	BOOST_CHECK_EQUAL(registry.getNumFunctions(), numFunctions + 1);
+	BOOST_CHECK(
+			registry.findFunction(FunctionRegistry::INSTANCEUPDATES, "FunctionRegistryTestFunction") == &FunctionRegistryTestFunction);
+	//per library
+	BOOST_CHECK(
+			registry.findFunction(FunctionRegistry::CALLBACKS, "FunctionRegistryTestFunction") == NULL);
+	//missing functions (e.g. per Object names) aren't recorded
+	for (int i = 0; i < 100; ++i)
+	{
+		std::ostringstream name;
+		name << "Object" << i << "_initialization";
+		BOOST_CHECK(
+				registry.findFunction(FunctionRegistry::INSTANCEUPDATES, name.str()) == NULL);
+	}
+	BOOST_CHECK_EQUAL(registry.getNumFunctions(), numFunctions + 1);
+	//a missing function found once registered
+	BOOST_CHECK(
+			registry.findFunction(FunctionRegistry::INSTANCEUPDATES, "FunctionRegistryTestOther") == NULL);
+	ELY_REGISTER_FUNCTION(INSTANCEUPDATES, FunctionRegistryTestOther);
+	BOOST_CHECK(
+			registry.findFunction(FunctionRegistry::INSTANCEUPDATES, "FunctionRegistryTestOther") == &FunctionRegistryTestOther);
+	registry.unregisterFunctions(FunctionRegistry::INSTANCEUPDATES);
+	BOOST_CHECK(
+			registry.findFunction(FunctionRegistry::INSTANCEUPDATES, "FunctionRegistryTestFunction") == NULL);
+	BOOST_CHECK_EQUAL(registry.getNumFunctions(), numFunctions);
+}
+
+BOOST_FIXTURE_TEST_CASE(FunctionCacheTEST, FunctionRegistryTestCaseFixture)
+{
+	ELY_REGISTER_FUNCTION(INSTANCEUPDATES, FunctionRegistryTestFunction);
+	FunctionCache cache;
+	unsigned long int lookups = registry.getLookups();
+	//resolved once per template, missing functions included
+	BOOST_CHECK(
+			cache.findFunction(FunctionRegistry::INSTANCEUPDATES, "FunctionRegistryTestFunction") == &FunctionRegistryTestFunction);
+	BOOST_CHECK(
+			cache.findFunction(FunctionRegistry::INSTANCEUPDATES, "FunctionRegistryTestOther") == NULL);
+	BOOST_CHECK_EQUAL(registry.getLookups(), lookups + 2);
+	BOOST_CHECK(
+			cache.findFunction(FunctionRegistry::INSTANCEUPDATES, "FunctionRegistryTestFunction") == &FunctionRegistryTestFunction);
+	BOOST_CHECK(
+			cache.findFunction(FunctionRegistry::INSTANCEUPDATES, "FunctionRegistryTestOther") == NULL);
+	BOOST_CHECK_EQUAL(registry.getLookups(), lookups + 2);
+	BOOST_CHECK_EQUAL(cache.getNumFunctions(), 2u);
+	//registry changes are seen
+	ELY_REGISTER_FUNCTION(INSTANCEUPDATES, FunctionRegistryTestOther);
+	BOOST_CHECK(
+			cache.findFunction(FunctionRegistry::INSTANCEUPDATES, "FunctionRegistryTestOther") == &FunctionRegistryTestOther);
+	registry.unregisterFunctions(FunctionRegistry::INSTANCEUPDATES);
+	BOOST_CHECK(
+			cache.findFunction(FunctionRegistry::INSTANCEUPDATES, "FunctionRegistryTestFunction") == NULL);
+	cache.clear();
+	BOOST_CHECK_EQUAL(cache.getNumFunctions(), 0u);
+}
+
+BOOST_FIXTURE_TEST_CASE(FunctionRegistryPluginTEST,
+		FunctionRegistryTestCaseFixture)
+{
+	lt_dlinit();
+	//a library whose symbols aren't registered: looked up with lt_dlsym
+	//(it is opened at the first lookup since closed)
+	registry.closeLibraries();
+	registry.setLibraryPath(FunctionRegistry::INSTANCEUPDATES, "libm.so.6");
+	registry.setPluginMode(true);
+	unsigned long int symbolLookups = registry.getLibrarySymbolLookups();
+	BOOST_CHECK(
+			registry.findFunction(FunctionRegistry::INSTANCEUPDATES, "cos") != NULL);
+	BOOST_CHECK_EQUAL(registry.getLibrarySymbolLookups(), symbolLookups + 1);
+	//found symbols are recorded
+	BOOST_CHECK(
+			registry.findFunction(FunctionRegistry::INSTANCEUPDATES, "cos") != NULL);
+	BOOST_CHECK_EQUAL(registry.getLibrarySymbolLookups(), symbolLookups + 1);
+	//not plug-in: only registered functions
+	registry.setPluginMode(false);
+	BOOST_CHECK(
+			registry.findFunction(FunctionRegistry::INSTANCEUPDATES, "sin") == NULL);
+	BOOST_CHECK_EQUAL(registry.getLibrarySymbolLookups(), symbolLookups + 1);
+	BOOST_CHECK(
+			registry.findFunction(FunctionRegistry::INSTANCEUPDATES, "cos") != NULL);
+	//the library functions are no more valid once closed
+	registry.closeLibraries();
+	BOOST_CHECK(
+			registry.findFunction(FunctionRegistry::INSTANCEUPDATES, "cos") == NULL);
+	registry.setLibraryPath(FunctionRegistry::INSTANCEUPDATES, "");
+	registry.setPluginMode(true);
+	registry.closeLibraries();
+	lt_dlexit();
+}
+
+BOOST_AUTO_TEST_SUITE_END() // ObjectModel suite
@@ -0,0 +1,118 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/test/objectmodel/ObjectIndex_test.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "ObjectModelSuiteFixture.h"
+#include "ObjectModel/ObjectIndex.h"
+#include <sstream>
+
+struct ObjectIndexTestCaseFixture
+{
+	ObjectIndexTestCaseFixture()
+	{
+	}
+	~ObjectIndexTestCaseFixture()
+	{
+	}
+	static ObjectId makeId(int i)
+	{
+		std::ostringstream id;
+		id << "IndexObject" << i;
+		return id.str();
+	}
+};
+
+/// ObjectModel suite
+BOOST_FIXTURE_TEST_SUITE(ObjectModel, ObjectModelSuiteFixture)
+
+/// Test cases
+BOOST_FIXTURE_TEST_CASE(ObjectIndexLookupTEST, ObjectIndexTestCaseFixture)
+{
+	ObjectIndex index;
+	mObjectTmpl = new ObjectTemplate(ObjectType("ObjectIndex_test"),
+			ObjectTemplateManager::GetSingletonPtr(), mPanda, mWin);
+	mObject = new Object(ObjectId("TestObject"), mObjectTmpl);
+	PT(PandaNode) node = new PandaNode("TestNode");
+	PT(PandaNode) otherNode = new PandaNode("OtherNode");
+	ObjectHandle handle = index.insert(mObject, mObject->objectId(), node);
+	BOOST_REQUIRE(handle.isValid());
+	BOOST_CHECK_EQUAL(index.getNumObjects(), 1u);
+	BOOST_CHECK(index.findHandle("TestObject") == handle);
+	BOOST_CHECK(index.find("TestObject") == mObject);
+	BOOST_CHECK(index.find(handle) == mObject);
+	BOOST_CHECK(index.findByNode(node) == mObject);
+	BOOST_CHECK(index.find("Unknown") == NULL);
+	//change the node
+	index.setNode(handle, otherNode);
+	BOOST_CHECK(index.findByNode(node) == NULL);
+	BOOST_CHECK(index.findByNode(otherNode) == mObject);
+	//the index holds a reference
+	int refs = mObject->get_ref_count();
+	BOOST_CHECK(index.erase(handle));
+	BOOST_CHECK(not index.erase(handle));
+	BOOST_CHECK_EQUAL(index.getNumObjects(), 0u);
+	BOOST_CHECK(index.find("TestObject") == NULL);
+	BOOST_CHECK(index.find(handle) == NULL);
+	BOOST_CHECK(index.findByNode(otherNode) == NULL);
+	//no readers: released by the writer that retired it
+	BOOST_CHECK_EQUAL(mObject->get_ref_count(), refs - 1);
+	//the slot is reused with a new generation
+	ObjectHandle newHandle = index.insert(mObject, mObject->objectId(), NULL);
+	BOOST_CHECK_EQUAL(newHandle.mIndex, handle.mIndex);
+	BOOST_CHECK(not (newHandle == handle));
+	BOOST_CHECK(index.find(handle) == NULL);
+	BOOST_CHECK(index.find(newHandle) == mObject);
+}
+
+BOOST_FIXTURE_TEST_CASE(ObjectIndexReclaimTEST, ObjectIndexTestCaseFixture)
+{
+	ObjectIndex index;
+	mObjectTmpl = new ObjectTemplate(ObjectType("ObjectIndex_test"),
+			ObjectTemplateManager::GetSingletonPtr(), mPanda, mWin);
+	//grow the tables (retiring the old copies) with lookups in between
+	std::vector<SMARTPTR(Object)> objects;
+	std::vector<ObjectHandle> handles;
+	for (int i = 0; i < 500; ++i)
+	{
+		objects.push_back(new Object(makeId(i), mObjectTmpl));
+		handles.push_back(index.insert(objects.back(), makeId(i), NULL));
+		BOOST_CHECK(index.find(makeId(i / 2)) == objects[i / 2]);
+	}
+	BOOST_CHECK_EQUAL(index.getNumObjects(), 500u);
+	for (int i = 0; i < 500; ++i)
+	{
+		BOOST_CHECK(index.findHandle(makeId(i)) == handles[i]);
+	}
+	//every retired reference is released while lookups go on
+	for (int i = 0; i < 500; i += 2)
+	{
+		BOOST_CHECK(index.erase(handles[i]));
+		BOOST_CHECK(index.find(makeId(i + 1)) == objects[i + 1]);
+	}
+	for (int i = 0; i < 500; ++i)
+	{
+		BOOST_CHECK_EQUAL(objects[i]->get_ref_count(), (i % 2) ? 2 : 1);
+		BOOST_CHECK((index.find(makeId(i)) == NULL) == (i % 2 == 0));
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END() // ObjectModel suite
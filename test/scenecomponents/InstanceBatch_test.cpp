@@ -0,0 +1,168 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/test/scenecomponents/InstanceBatch_test.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "SceneSuiteFixture.h"
+#include "Support/InstanceBatch.h"
+#include <graphicsEngine.h>
+#include <clockObject.h>
+
+struct InstanceBatchTestCaseFixture
+{
+	InstanceBatchTestCaseFixture(WindowFramework* win,
+			PandaFramework* panda) :
+			mWin(win), mPanda(panda)
+	{
+		mRender = mWin->get_render();
+		mModel = mWin->load_default_model(NodePath("models"));
+		//instances' transforms holder: stashed so it isn't culled
+		mHolders = mRender.attach_new_node("holders");
+		mHolders.stash();
+	}
+	~InstanceBatchTestCaseFixture()
+	{
+		mHolders.remove_node();
+	}
+	//a grid of side x side instances
+	void makeGrid(const NodePath& parent, int side, float spacing)
+	{
+		for (int i = 0; i < side * side; ++i)
+		{
+			NodePath np = parent.attach_new_node("instance");
+			np.set_pos((i % side) * spacing, (i / side) * spacing, 0.0);
+			mInstances.push_back(np);
+		}
+	}
+	//average (real) time of a frame: cull + submit on this thread
+	double renderFrames(int numFrames)
+	{
+		GraphicsEngine* engine = mPanda->get_graphics_engine();
+		engine->render_frame();
+		engine->sync_frame();
+		double start = ClockObject::get_global_clock()->get_real_time();
+		for (int f = 0; f < numFrames; ++f)
+		{
+			engine->render_frame();
+		}
+		engine->sync_frame();
+		return (ClockObject::get_global_clock()->get_real_time() - start)
+				/ numFrames;
+	}
+	WindowFramework* mWin;
+	PandaFramework* mPanda;
+	NodePath mRender, mModel, mHolders;
+	std::vector<NodePath> mInstances;
+};
+
+/// Scene suite
+BOOST_FIXTURE_TEST_SUITE(Scene, SceneSuiteFixture)
+
+/// Test cases
+BOOST_AUTO_TEST_CASE(InstanceBatchUpdateTEST)
+{
+	InstanceBatchTestCaseFixture data(mWin, mPanda);
+	data.makeGrid(data.mHolders, 10, 10.0);
+	SMARTPTR(InstanceBatch) batch = new InstanceBatch("test", data.mModel,
+			data.mRender, 50.0);
+	std::vector<int> handles;
+	for (unsigned int i = 0; i < data.mInstances.size(); ++i)
+	{
+		handles.push_back(batch->addInstance(data.mInstances[i]));
+	}
+	batch->update();
+	//100 instances in 2x2 cells
+	BOOST_CHECK_EQUAL(batch->getStats().mInstances, 100u);
+	BOOST_CHECK_EQUAL(batch->getStats().mCells, 4u);
+	BOOST_CHECK_EQUAL(batch->getStats().mMoved, 100u);
+	//nothing moved
+	batch->update();
+	BOOST_CHECK_EQUAL(batch->getStats().mMoved, 0u);
+	//one moved inside its cell, one moved into another cell
+	data.mInstances[0].set_pos(1.0, 1.0, 0.0);
+	data.mInstances[1].set_pos(60.0, 1.0, 0.0);
+	batch->update();
+	BOOST_CHECK_EQUAL(batch->getStats().mMoved, 2u);
+	BOOST_CHECK_EQUAL(batch->getStats().mCellChanges, 1u);
+	//removal
+	batch->removeInstance(handles[0]);
+	batch->update();
+	BOOST_CHECK_EQUAL(batch->getStats().mInstances, 99u);
+	batch->cleanup();
+}
+
+BOOST_AUTO_TEST_CASE(InstanceBatchSetModelTEST)
+{
+	InstanceBatchTestCaseFixture data(mWin, mPanda);
+	data.makeGrid(data.mHolders, 2, 10.0);
+	//an empty placeholder, then the loaded model
+	NodePath placeholder("placeholder");
+	SMARTPTR(InstanceBatch) batch = new InstanceBatch("test", placeholder,
+			data.mRender, 50.0);
+	for (unsigned int i = 0; i < data.mInstances.size(); ++i)
+	{
+		batch->addInstance(data.mInstances[i]);
+	}
+	batch->update();
+	NodePath cell = batch->getRoot().get_child(0);
+	LPoint3f minP, maxP;
+	BOOST_CHECK(not cell.calc_tight_bounds(minP, maxP));
+	batch->setModel(data.mModel);
+	batch->update();
+	//cells draw the new model and keep their instances
+	BOOST_CHECK(cell.calc_tight_bounds(minP, maxP));
+	BOOST_CHECK_EQUAL(batch->getStats().mInstances, 4u);
+	BOOST_CHECK_EQUAL(batch->getStats().mCells, 1u);
+	batch->cleanup();
+}
+
+BOOST_AUTO_TEST_CASE(InstanceBatchCullSubmitBENCH)
+{
+	const int side = 71; //~5000 instances
+	const int numFrames = 50;
+	InstanceBatchTestCaseFixture data(mWin, mPanda);
+	//separate nodes (InstanceOf default)
+	NodePath separateRoot = data.mRender.attach_new_node("separate");
+	data.makeGrid(separateRoot, side, 2.0);
+	for (unsigned int i = 0; i < data.mInstances.size(); ++i)
+	{
+		data.mModel.instance_to(data.mInstances[i]);
+	}
+	double separateTime = data.renderFrames(numFrames);
+	separateRoot.remove_node();
+	data.mInstances.clear();
+	//instanced
+	data.makeGrid(data.mHolders, side, 2.0);
+	SMARTPTR(InstanceBatch) batch = new InstanceBatch("bench", data.mModel,
+			data.mRender, 32.0);
+	for (unsigned int i = 0; i < data.mInstances.size(); ++i)
+	{
+		batch->addInstance(data.mInstances[i]);
+	}
+	batch->update();
+	double instancedTime = data.renderFrames(numFrames);
+	BOOST_TEST_MESSAGE(
+			"InstanceBatch cull+submit (" << side * side << " instances): separate " << separateTime * 1000.0 << " ms/frame, instanced " << instancedTime * 1000.0 << " ms/frame (" << batch->getStats().mCells << " cells)");
+	BOOST_CHECK(batch->getStats().mCells < (unsigned int) (side * side));
+	batch->cleanup();
+}
+
+BOOST_AUTO_TEST_SUITE_END() // Scene suite
@@ -0,0 +1,158 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/test/scenecomponents/ModelLoader_test.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "SceneSuiteFixture.h"
+#include "Support/ModelLoader.h"
+#include <modelPool.h>
+#include <mutexHolder.h>
+#include <thread.h>
+#include <fstream>
+
+struct ModelLoaderTestCaseFixture
+{
+	ModelLoaderTestCaseFixture()
+	{
+		//a one triangle egg file
+		mFileName = Filename(Filename::get_temp_directory(),
+				"ModelLoaderTest.egg");
+		mFileName.set_text();
+		std::ofstream out(mFileName.to_os_specific().c_str());
+		out << "<CoordinateSystem> { Z-Up }" << std::endl
+				<< "<Group> triangle {" << std::endl
+				<< "  <VertexPool> vpool {" << std::endl
+				<< "    <Vertex> 0 { 0 0 0 }" << std::endl
+				<< "    <Vertex> 1 { 1 0 0 }" << std::endl
+				<< "    <Vertex> 2 { 0 1 0 }" << std::endl
+				<< "  }" << std::endl
+				<< "  <Polygon> { <VertexRef> { 0 1 2 <Ref> { vpool } } }"
+				<< std::endl << "}" << std::endl;
+	}
+	~ModelLoaderTestCaseFixture()
+	{
+		mFileName.unlink();
+	}
+	Filename mFileName;
+};
+
+///Loads a model on a loader thread.
+class ModelLoaderTestTask: public AsyncTask
+{
+public:
+	ModelLoaderTestTask(ModelLoader* loader, const Filename& fileName) :
+			AsyncTask("ModelLoaderTestTask"), mLoader(loader), mFileName(
+					fileName), mThread(NULL)
+	{
+	}
+	virtual DoneStatus do_task()
+	{
+		NodePath model = mLoader->loadModel(mFileName);
+		MutexHolder guard(mMutex);
+		mModel = model;
+		mThread = Thread::get_current_thread();
+		return DS_done;
+	}
+	NodePath getModel()
+	{
+		MutexHolder guard(mMutex);
+		return mModel;
+	}
+	Thread* getThread()
+	{
+		MutexHolder guard(mMutex);
+		return mThread;
+	}
+private:
+	PT(ModelLoader) mLoader;
+	Filename mFileName;
+	Mutex mMutex;
+	NodePath mModel;
+	Thread* mThread;
+};
+
+/// Scene suite
+BOOST_FIXTURE_TEST_SUITE(Scene, SceneSuiteFixture)
+
+/// Test cases
+BOOST_FIXTURE_TEST_CASE(ModelLoaderCacheTEST, ModelLoaderTestCaseFixture)
+{
+	PT(ModelLoader) loader = new ModelLoader("ModelLoaderCache", 1);
+	NodePath model1 = loader->loadModel(mFileName);
+	BOOST_REQUIRE(not model1.is_empty());
+	BOOST_CHECK_EQUAL(loader->getCacheMisses(), 1u);
+	BOOST_CHECK_EQUAL(loader->getCacheHits(), 0u);
+	BOOST_CHECK_EQUAL(loader->getCacheSize(), 1u);
+	BOOST_CHECK(ModelPool::has_model(mFileName));
+	//parsed once, but every load is a copy
+	NodePath model2 = loader->loadModel(mFileName);
+	BOOST_REQUIRE(not model2.is_empty());
+	BOOST_CHECK_EQUAL(loader->getCacheMisses(), 1u);
+	BOOST_CHECK_EQUAL(loader->getCacheHits(), 1u);
+	BOOST_CHECK(model1.node() != model2.node());
+	model1.find("**/triangle").set_name("modified");
+	BOOST_CHECK(not model2.find("**/triangle").is_empty());
+	//released from the pool
+	loader->clearCache();
+	BOOST_CHECK_EQUAL(loader->getCacheSize(), 0u);
+	BOOST_CHECK(not ModelPool::has_model(mFileName));
+	NodePath model3 = loader->loadModel(mFileName);
+	BOOST_CHECK(not model3.is_empty());
+	BOOST_CHECK_EQUAL(loader->getCacheMisses(), 2u);
+	//missing file
+	BOOST_CHECK(loader->loadModel(Filename("ModelLoaderTestMissing.egg")).is_empty());
+	loader->cleanup();
+	BOOST_CHECK(not ModelPool::has_model(mFileName));
+}
+
+BOOST_FIXTURE_TEST_CASE(ModelLoaderAsyncTEST, ModelLoaderTestCaseFixture)
+{
+	PT(ModelLoader) loader = new ModelLoader("ModelLoaderAsync", 2);
+	std::vector<PT(ModelLoaderTestTask)> tasks;
+	for (int i = 0; i < 4; ++i)
+	{
+		tasks.push_back(new ModelLoaderTestTask(loader, mFileName));
+		loader->dispatch(tasks.back());
+	}
+	//waits for completion: every task got its own copy, on a loader thread
+	loader->cleanup();
+	for (unsigned int i = 0; i < tasks.size(); ++i)
+	{
+		BOOST_CHECK(tasks[i]->is_alive() == false);
+		NodePath model = tasks[i]->getModel();
+		BOOST_REQUIRE(not model.is_empty());
+		BOOST_CHECK(not model.find("**/triangle").is_empty());
+		for (unsigned int j = 0; j < i; ++j)
+		{
+			BOOST_CHECK(tasks[j]->getModel().node() != model.node());
+		}
+		if (Thread::is_threading_supported())
+		{
+			BOOST_CHECK(tasks[i]->getThread() != Thread::get_main_thread());
+		}
+	}
+	//concurrent misses are possible, but parsed at least once
+	BOOST_CHECK_EQUAL(loader->getCacheHits() + loader->getCacheMisses(), 4u);
+	BOOST_CHECK(loader->getCacheMisses() >= 1u);
+	BOOST_CHECK_EQUAL(loader->getCacheSize(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // Scene suite
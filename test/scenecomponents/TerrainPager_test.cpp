@@ -0,0 +1,155 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/test/scenecomponents/TerrainPager_test.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "SceneSuiteFixture.h"
+#include "Support/TerrainPager.h"
+#include <asyncTaskManager.h>
+#include <clockObject.h>
+#include <pnmImage.h>
+
+struct TerrainPagerTestCaseFixture
+{
+	TerrainPagerTestCaseFixture()
+	{
+		//a row of 4 pages, 17x17 pixels each
+		settings.mHeightfieldPattern = "TerrainPagerTest_{x}_{y}.png";
+		settings.mPagesX = 4;
+		settings.mPagesY = 1;
+		settings.mPageSize = 17;
+		settings.mRadius = 0;
+		settings.mBlockSize = 8;
+		settings.mMinLevel = 0;
+		settings.mNear = 10.0;
+		settings.mFar = 100.0;
+		settings.mBruteForce = true;
+		settings.mFlattenMode = GeoMipTerrain::AFM_off;
+		settings.mPhysics = false;
+	}
+	~TerrainPagerTestCaseFixture()
+	{
+		for (int x = 0; x < settings.mPagesX; ++x)
+		{
+			getPageFile(x).unlink();
+		}
+	}
+	Filename getPageFile(int x)
+	{
+		std::ostringstream fileName;
+		fileName << "TerrainPagerTest_" << x << "_0.png";
+		return Filename(fileName.str());
+	}
+	void writePage(int x)
+	{
+		PNMImage heightField(17, 17);
+		heightField.fill(x / 4.0);
+		heightField.write(getPageFile(x));
+	}
+	///an update() whose dispatched loads are run on this thread
+	static void updateAndLoad(TerrainPager* pager)
+	{
+		pager->update();
+		AsyncTaskManager::get_global_ptr()->poll();
+		pager->update();
+	}
+	TerrainPager::Settings settings;
+};
+
+/// Scene suite
+BOOST_FIXTURE_TEST_SUITE(Scene, SceneSuiteFixture)
+
+/// Test cases
+BOOST_FIXTURE_TEST_CASE(TerrainPagerRetryTEST, TerrainPagerTestCaseFixture)
+{
+	//page 1 has no heightfield yet
+	writePage(0);
+	settings.mRadius = 1;
+	PT(TerrainPager) pager = new TerrainPager("TerrainPagerRetry", settings,
+			4, 0);
+	pager->setFocalPoint(LPoint3f(8.0, 8.0, 0.0));
+	pager->generate();
+	BOOST_CHECK_EQUAL(pager->getStats().mResident, 1u);
+	updateAndLoad(pager);
+	BOOST_CHECK_EQUAL(pager->getStats().mResident, 1u);
+	BOOST_CHECK_EQUAL(pager->getStats().mLoading, 0u);
+	BOOST_CHECK_EQUAL(pager->getStats().mMissing, 1u);
+	//not retried before its delay
+	writePage(1);
+	pager->update();
+	BOOST_CHECK_EQUAL(pager->getStats().mLoading, 0u);
+	BOOST_CHECK_EQUAL(pager->getStats().mMissing, 1u);
+	//retried after its delay
+	ClockObject* clock = ClockObject::get_global_clock();
+	clock->set_frame_time(clock->get_frame_time() + 2.0);
+	pager->update();
+	BOOST_CHECK_EQUAL(pager->getStats().mLoading, 1u);
+	BOOST_CHECK_EQUAL(pager->getStats().mMissing, 0u);
+	AsyncTaskManager::get_global_ptr()->poll();
+	pager->update();
+	BOOST_CHECK_EQUAL(pager->getStats().mResident, 2u);
+	BOOST_CHECK_EQUAL(pager->getStats().mLoading, 0u);
+	BOOST_CHECK_EQUAL(pager->getStats().mMissing, 0u);
+	BOOST_CHECK_EQUAL(pager->getStats().mTotalLoaded, 2u);
+	pager->cleanup();
+}
+
+BOOST_FIXTURE_TEST_CASE(TerrainPagerEvictionTEST, TerrainPagerTestCaseFixture)
+{
+	for (int x = 0; x < settings.mPagesX; ++x)
+	{
+		writePage(x);
+	}
+	PT(TerrainPager) pager = new TerrainPager("TerrainPagerEviction",
+			settings, 4, 0);
+	pager->setFocalPoint(LPoint3f(8.0, 8.0, 0.0));
+	pager->generate();
+	BOOST_CHECK_EQUAL(pager->getStats().mResident, 1u);
+	//keep page 0 root node only
+	NodePath pageNP = pager->getRoot().find("TerrainPagerEviction_Page_0_0");
+	BOOST_REQUIRE(not pageNP.is_empty());
+	PT(PandaNode) pageNode = pageNP.node();
+	pageNP.clear();
+	//a neighbor within the hysteresis band isn't evicted
+	pager->setFocalPoint(LPoint3f(24.0, 8.0, 0.0));
+	updateAndLoad(pager);
+	BOOST_CHECK_EQUAL(pager->getStats().mResident, 2u);
+	BOOST_CHECK_EQUAL(pager->getStats().mTotalEvicted, 0u);
+	BOOST_CHECK_EQUAL(pageNode->get_num_parents(), 1);
+	//farther: page 0 is detached and its terrain freed
+	pager->setFocalPoint(LPoint3f(56.0, 8.0, 0.0));
+	updateAndLoad(pager);
+	BOOST_CHECK_EQUAL(pager->getStats().mResident, 1u);
+	BOOST_CHECK_EQUAL(pager->getStats().mTotalEvicted, 2u);
+	BOOST_CHECK_EQUAL(pageNode->get_num_parents(), 0);
+	BOOST_CHECK_EQUAL(pageNode->get_ref_count(), 1);
+	//and is reloaded when back
+	pager->setFocalPoint(LPoint3f(8.0, 8.0, 0.0));
+	updateAndLoad(pager);
+	BOOST_CHECK(not pager->getRoot().find(
+			"TerrainPagerEviction_Page_0_0").is_empty());
+	BOOST_CHECK(pager->getRoot().find(
+			"TerrainPagerEviction_Page_0_0").node() != pageNode);
+	pager->cleanup();
+	BOOST_CHECK_EQUAL(pager->getStats().mResident, 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // Scene suite
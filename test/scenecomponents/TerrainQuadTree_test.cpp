@@ -0,0 +1,129 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/test/scenecomponents/TerrainQuadTree_test.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "SceneSuiteFixture.h"
+#include "Support/TerrainQuadTree.h"
+#include <asyncTaskManager.h>
+#include <geomVertexReader.h>
+#include <geomTriangles.h>
+
+struct TerrainQuadTreeTestCaseFixture
+{
+	TerrainQuadTreeTestCaseFixture() :
+			heightField(129, 129)
+	{
+		//a slope along x
+		for (int y = 0; y < 129; ++y)
+		{
+			for (int x = 0; x < 129; ++x)
+			{
+				heightField.set_gray(x, y, x / 128.0);
+			}
+		}
+	}
+	///the triangles of a block's geometry
+	static CPT(GeomPrimitive) getTriangles(const NodePath& blockNP,
+			CPT(GeomVertexData)& vdata)
+	{
+		NodePath geomNP = blockNP.get_child(0);
+		const Geom* geom = DCAST(GeomNode, geomNP.node())->get_geom(0);
+		vdata = geom->get_vertex_data();
+		return geom->get_primitive(0)->decompose();
+	}
+	PNMImage heightField;
+};
+
+/// Scene suite
+BOOST_FIXTURE_TEST_SUITE(Scene, SceneSuiteFixture)
+
+/// Test cases
+BOOST_FIXTURE_TEST_CASE(TerrainQuadTreeBudgetTEST,
+		TerrainQuadTreeTestCaseFixture)
+{
+	//8x8 blocks, regenerated on the main thread by polling
+	PT(TerrainQuadTree) tree = new TerrainQuadTree("TerrainQuadTreeBudget",
+			heightField, 16, 0, 10.0, 200.0, 4, 0);
+	BOOST_CHECK_EQUAL(tree->getMaxLevel(), 4);
+	tree->setFocalPoint(LPoint3f::zero());
+	tree->generate();
+	tree->update();
+	BOOST_CHECK_EQUAL(tree->getStats().mDispatched, 0u);
+	//far away: most blocks change level, but at most budget per update
+	tree->setFocalPoint(LPoint3f(128.0, 128.0, 0.0));
+	unsigned int updates = 0, dispatched = 0;
+	do
+	{
+		tree->update();
+		TerrainQuadTree::Stats stats = tree->getStats();
+		BOOST_CHECK(stats.mDispatched <= 4u);
+		BOOST_CHECK(stats.mRegenerated <= 4u);
+		dispatched += stats.mDispatched;
+		AsyncTaskManager::get_global_ptr()->poll();
+		++updates;
+	} while (((tree->getStats().mPending > 0)
+			or (tree->getStats().mDispatched > 0)) and (updates < 100));
+	BOOST_CHECK(dispatched > 4u);
+	BOOST_CHECK(updates > 2u);
+	BOOST_CHECK_EQUAL(tree->getStats().mPending, 0u);
+	BOOST_CHECK_EQUAL(tree->getStats().mTotalRegenerated, dispatched);
+	//nothing left to do
+	tree->update();
+	BOOST_CHECK_EQUAL(tree->getStats().mDispatched, 0u);
+	BOOST_CHECK_EQUAL(tree->getStats().mRegenerated, 0u);
+	tree->cleanup();
+}
+
+BOOST_FIXTURE_TEST_CASE(TerrainQuadTreeSkirtsTEST,
+		TerrainQuadTreeTestCaseFixture)
+{
+	PT(TerrainQuadTree) tree = new TerrainQuadTree("TerrainQuadTreeSkirts",
+			heightField, 16, 0, 1000.0, 2000.0, 4, 0);
+	tree->generate();
+	NodePath blockNP = tree->getRoot().get_child(0);
+	CPT(GeomVertexData) vdata;
+	CPT(GeomPrimitive) tris = getTriangles(blockNP, vdata);
+	//level 0: 17x17 vertices, each skirt edge 16 quads of one winding
+	int gridTris = 2 * 16 * 16;
+	int skirtTris = 4 * 2 * 16;
+	BOOST_REQUIRE_EQUAL(tris->get_num_primitives(), gridTris + skirtTris);
+	GeomVertexReader vertex(vdata, InternalName::get_vertex());
+	//the block center
+	LPoint3f center(8.0, 8.0, 0.0);
+	for (int t = gridTris; t < tris->get_num_primitives(); ++t)
+	{
+		LPoint3f v[3];
+		for (int k = 0; k < 3; ++k)
+		{
+			vertex.set_row(tris->get_vertex(3 * t + k));
+			v[k] = vertex.get_data3f();
+		}
+		//counterclockwise front faces point away from the block
+		LVector3f normal = (v[1] - v[0]).cross(v[2] - v[0]);
+		LVector3f outwards = (v[0] + v[1] + v[2]) / 3.0 - center;
+		outwards.set_z(0.0);
+		BOOST_CHECK(normal.dot(outwards) > 0.0);
+	}
+	tree->cleanup();
+}
+
+BOOST_AUTO_TEST_SUITE_END() // Scene suite
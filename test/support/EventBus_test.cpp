@@ -0,0 +1,137 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/test/support/EventBus_test.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "SupportSuiteFixture.h"
+#include "Support/EventBus.h"
+#include <eventHandler.h>
+
+struct EventBusTestCaseFixture
+{
+	EventBusTestCaseFixture()
+	{
+		bus = new EventBus();
+		id = bus->registerEvent("Test");
+		calls = 0;
+		received.clear();
+	}
+	~EventBusTestCaseFixture()
+	{
+		delete bus;
+	}
+	///records the batches
+	static void subscriber(EventBus::EventId id,
+			const std::vector<EventBus::Payload>& events, void* data)
+	{
+		++calls;
+		received.insert(received.end(), events.begin(), events.end());
+	}
+	///posts a new event while dispatching, then unsubscribes
+	static void reposter(EventBus::EventId id,
+			const std::vector<EventBus::Payload>& events, void* data)
+	{
+		EventBus* bus = reinterpret_cast<EventBus*>(data);
+		bus->post(id, "", NULL, NULL, events.back().mValue + 1.0);
+		bus->unsubscribe(id, &EventBusTestCaseFixture::reposter, data);
+	}
+	static void hook(const Event* event, void* data)
+	{
+	}
+	EventBus* bus;
+	EventBus::EventId id;
+	static int calls;
+	static std::vector<EventBus::Payload> received;
+};
+int EventBusTestCaseFixture::calls;
+std::vector<EventBus::Payload> EventBusTestCaseFixture::received;
+
+/// Support suite
+BOOST_FIXTURE_TEST_SUITE(Support, SupportSuiteFixture)
+
+/// Test cases
+BOOST_FIXTURE_TEST_CASE(EventBusRegisterTEST, EventBusTestCaseFixture)
+{
+	BOOST_CHECK_EQUAL(id, (EventBus::EventId) EventBus::BUILTIN_EVENT_NUM);
+	BOOST_CHECK_EQUAL(bus->registerEvent("Test"), id);
+	BOOST_CHECK_EQUAL(bus->getEventId("Collision"),
+			(EventBus::EventId) EventBus::COLLISION_EVENT);
+	BOOST_CHECK_EQUAL(bus->getEventName(id), "Test");
+	BOOST_CHECK_EQUAL(bus->getEventId("Unknown"),
+			(EventBus::EventId) EventBus::INVALID_EVENT);
+}
+
+BOOST_FIXTURE_TEST_CASE(EventBusDispatchTEST, EventBusTestCaseFixture)
+{
+	//no subscribers: nothing queued
+	bus->post(id, "");
+	BOOST_CHECK_EQUAL(bus->getStats().mPosted, 0u);
+	//one batch per frame
+	bus->subscribe(id, &EventBusTestCaseFixture::subscriber);
+	bus->subscribe(id, &EventBusTestCaseFixture::subscriber);
+	BOOST_CHECK(bus->hasSubscribers(id));
+	for (int i = 0; i < 3; ++i)
+	{
+		bus->post(id, "", NULL, NULL, (float) i);
+	}
+	bus->dispatch();
+	BOOST_CHECK_EQUAL(calls, 1);
+	BOOST_REQUIRE_EQUAL(received.size(), 3u);
+	BOOST_CHECK_EQUAL(received[2].mValue, 2.0);
+	bus->dispatch();
+	BOOST_CHECK_EQUAL(calls, 1);
+	//events posted while dispatching go to the next frame
+	bus->subscribe(id, &EventBusTestCaseFixture::reposter, bus);
+	bus->post(id, "", NULL, NULL, 10.0);
+	bus->dispatch();
+	BOOST_CHECK_EQUAL(calls, 2);
+	BOOST_CHECK_EQUAL(received.back().mValue, 10.0);
+	bus->dispatch();
+	BOOST_CHECK_EQUAL(calls, 3);
+	BOOST_CHECK_EQUAL(received.back().mValue, 11.0);
+	BOOST_CHECK_EQUAL(bus->getStats().mPosted, 5u);
+	BOOST_CHECK_EQUAL(bus->getStats().mDispatched, 5u);
+	//no more subscribers: pending events are discarded
+	bus->post(id, "");
+	bus->unsubscribe(id, &EventBusTestCaseFixture::subscriber);
+	BOOST_CHECK(not bus->hasSubscribers(id));
+	bus->dispatch();
+	BOOST_CHECK_EQUAL(calls, 3);
+}
+
+BOOST_FIXTURE_TEST_CASE(EventBusPandaBridgeTEST, EventBusTestCaseFixture)
+{
+	EventHandler* eventHandler = EventHandler::get_global_event_handler();
+	//nobody handles the Panda event
+	BOOST_CHECK(not bus->post(id, "EventBusTest"));
+	BOOST_CHECK(not bus->post(id, ""));
+	//somebody does
+	eventHandler->add_hook("EventBusTest", &EventBusTestCaseFixture::hook);
+	BOOST_CHECK(bus->post(id, "EventBusTest"));
+	BOOST_CHECK(EventBus::postEvent(id, "EventBusTest"));
+	//unless the bridge is disabled
+	bus->setPandaBridge(id, false);
+	BOOST_CHECK(not bus->getPandaBridge(id));
+	BOOST_CHECK(not EventBus::postEvent(id, "EventBusTest"));
+	eventHandler->remove_hooks("EventBusTest");
+}
+
+BOOST_AUTO_TEST_SUITE_END() // Support suite
@@ -0,0 +1,177 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/test/support/FastFSM_test.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "SupportSuiteFixture.h"
+#include "Support/FastFSM.h"
+#include <thread.h>
+
+//the owner: records the callbacks sequence
+struct Recorder
+{
+	std::string mSequence;
+	int mDemandOnEnter;
+};
+typedef FastFSM<Recorder> rfsm;
+
+struct FastFSMTestCaseFixture
+{
+	FastFSMTestCaseFixture()
+	{
+		recorder.mDemandOnEnter = rfsm::Null;
+		fsm1 = new rfsm("fsm1", recorder);
+	}
+	~FastFSMTestCaseFixture()
+	{
+		delete fsm1;
+	}
+	Recorder recorder;
+	rfsm* fsm1;
+};
+
+void fastEnter(rfsm* _fsm, Recorder& rec, const FSMArgs& args)
+{
+	rec.mSequence += "+" + _fsm->getStateKey(_fsm->getCurrentOrNextState());
+	if (args.size() > 0)
+	{
+		std::ostringstream arg;
+		arg << "(" << args.getInt(0) << ")";
+		rec.mSequence += arg.str();
+	}
+	if (rec.mDemandOnEnter != rfsm::Null)
+	{
+		int demanded = rec.mDemandOnEnter;
+		rec.mDemandOnEnter = rfsm::Null;
+		_fsm->demand(demanded);
+	}
+}
+void fastExit(rfsm* _fsm, Recorder& rec)
+{
+	rfsm::StateId from, to;
+	_fsm->getCurrentStateOrTransition(from, to);
+	rec.mSequence += "-" + _fsm->getStateKey(from);
+}
+void fastFromTo(rfsm* _fsm, Recorder& rec, const FSMArgs& args)
+{
+	rec.mSequence += "*";
+}
+rfsm::StateId fastFilterDenyAll(rfsm* _fsm, Recorder& rec,
+		rfsm::StateId toState, const FSMArgs& args, FSMArgs& enterArgs)
+{
+	return rfsm::Null;
+}
+
+/// Support suite
+BOOST_FIXTURE_TEST_SUITE(Support, SupportSuiteFixture)
+
+/// Test cases
+BOOST_FIXTURE_TEST_CASE(FastFSMRequestDemand, FastFSMTestCaseFixture)
+{
+	fsm1->addState("s01", &fastEnter, &fastExit, NULL);
+	std::vector<rfsm::StateId> allowed;
+	allowed.push_back(fsm1->intern("s01"));
+	fsm1->addState("s02", &fastEnter, &fastExit, NULL, allowed);
+	fsm1->addState("s03", &fastEnter, &fastExit, &fastFilterDenyAll);
+	fsm1->addFromToFunc("s01", "s03", &fastFromTo);
+	rfsm::StateId s01 = fsm1->getStateId("s01"), s02 = fsm1->getStateId(
+			"s02"), s03 = fsm1->getStateId("s03");
+	BOOST_CHECK_EQUAL(fsm1->getNumStates(), 3u);
+	BOOST_CHECK_EQUAL(fsm1->getCurrentOrNextState(), (int) rfsm::Off);
+	//enter/exit with args
+	FSMArgs args;
+	args.pushInt(7);
+	BOOST_CHECK_EQUAL(fsm1->request(s01, args), s01);
+	BOOST_CHECK_EQUAL(fsm1->request(s02), s02);
+	BOOST_CHECK_EQUAL(recorder.mSequence, "+s01(7)-s01+s02");
+	//default filter with allowed states: denied, so unchanged
+	BOOST_CHECK_EQUAL(fsm1->request(s03), s02);
+	//fromTo replaces exit/enter
+	recorder.mSequence.clear();
+	fsm1->request(s01);
+	fsm1->request(s03);
+	BOOST_CHECK_EQUAL(recorder.mSequence, "-s02+s01*");
+	//filter denying all
+	BOOST_CHECK_EQUAL(fsm1->request(s01), s03);
+	//forceTransition bypasses the filter
+	fsm1->forceTransition(s01);
+	BOOST_CHECK_EQUAL(fsm1->getCurrentOrNextState(), s01);
+	//demand in a transition is queued up
+	recorder.mSequence.clear();
+	recorder.mDemandOnEnter = s01;
+	fsm1->demand(s02);
+	BOOST_CHECK_EQUAL(recorder.mSequence, "-s01+s02-s02+s01");
+	BOOST_CHECK_EQUAL(fsm1->getCurrentOrNextState(), s01);
+	//cleanup
+	fsm1->cleanup();
+	BOOST_CHECK_EQUAL(fsm1->getCurrentOrNextState(), (int) rfsm::Off);
+	BOOST_CHECK_EQUAL(fsm1->getNumStates(), 0u);
+}
+
+//posts a number of requests
+class PostThread: public Thread
+{
+public:
+	PostThread(rfsm* _fsm, rfsm::StateId state, int num) :
+			Thread("PostThread", "PostThread"), mFSM(_fsm), mState(state), mNum(
+					num), mFailed(0)
+	{
+	}
+	virtual void thread_main()
+	{
+		for (int i = 0; i < mNum; ++i)
+		{
+			FSMArgs args;
+			args.pushInt(i);
+			while (not mFSM->post(mState, args, true))
+			{
+				++mFailed;
+				Thread::force_yield();
+			}
+		}
+	}
+	rfsm* mFSM;
+	rfsm::StateId mState;
+	int mNum, mFailed;
+};
+
+BOOST_FIXTURE_TEST_CASE(FastFSMPostedRequests, FastFSMTestCaseFixture)
+{
+	fsm1->addState("s01", NULL, NULL, NULL);
+	fsm1->addState("s02", NULL, NULL, NULL);
+	const int num = 1000;
+	PT(PostThread) t1 = new PostThread(fsm1, fsm1->getStateId("s01"), num);
+	PT(PostThread) t2 = new PostThread(fsm1, fsm1->getStateId("s02"), num);
+	t1->start(TP_normal, true);
+	t2->start(TP_normal, true);
+	unsigned int processed = 0;
+	while (processed < 2 * num)
+	{
+		processed += fsm1->processRequests();
+		Thread::force_yield();
+	}
+	t1->join();
+	t2->join();
+	BOOST_CHECK_EQUAL(processed, (unsigned int) (2 * num));
+	BOOST_CHECK_EQUAL(fsm1->processRequests(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // Support suite
@@ -0,0 +1,83 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/test/support/FrameArena_test.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "SupportSuiteFixture.h"
+#include "Support/FrameArena.h"
+
+struct FrameArenaTestCaseFixture
+{
+	FrameArenaTestCaseFixture() :
+			arena(1024)
+	{
+		arena.setPoison(true);
+	}
+	FrameArena arena;
+};
+
+/// Support suite
+BOOST_FIXTURE_TEST_SUITE(Support, SupportSuiteFixture)
+
+/// Test cases
+BOOST_FIXTURE_TEST_CASE(FrameArenaScopes, FrameArenaTestCaseFixture)
+{
+	{
+		FrameArena::Scope outer(arena);
+		double* values = arena.allocArray<double>(4);
+		BOOST_CHECK_EQUAL(reinterpret_cast<size_t>(values) % sizeof(double), 0u);
+		values[0] = 1.0;
+		unsigned char* inner = NULL;
+		{
+			FrameArena::Scope scope(arena);
+			//bigger than a block
+			inner = arena.allocArray<unsigned char>(4096);
+			inner[0] = 1;
+			BOOST_CHECK_EQUAL(arena.getStats().mBlocks, 2u);
+		}
+		//the inner allocation is released (and poisoned), the outer isn't
+		BOOST_CHECK_EQUAL(inner[0], FrameArena::POISON_BYTE);
+		BOOST_CHECK_EQUAL(values[0], 1.0);
+	}
+	BOOST_CHECK_EQUAL(arena.getStats().mUsed, 0u);
+	//blocks are kept
+	FrameArena::FrameArenaStats stats = arena.getStats();
+	BOOST_CHECK_EQUAL(stats.mBlocks, 2u);
+	BOOST_CHECK(stats.mHighWater > 4096u);
+}
+
+BOOST_FIXTURE_TEST_CASE(FrameArenaContainers, FrameArenaTestCaseFixture)
+{
+	FrameArena::Scope scope(arena);
+	FrameAllocator<int> allocator(arena);
+	FrameVector<int>::type numbers(allocator);
+	FrameMap<int, int>::type squares(std::less<int>(), allocator);
+	for (int i = 0; i < 100; ++i)
+	{
+		numbers.push_back(i);
+		squares[i] = i * i;
+	}
+	BOOST_CHECK_EQUAL(numbers[99], 99);
+	BOOST_CHECK_EQUAL(squares[9], 81);
+	BOOST_CHECK(arena.getStats().mUsed > 100 * sizeof(int));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // Support suite
@@ -0,0 +1,189 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/test/support/InterestGrid_test.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "SupportSuiteFixture.h"
+#include "Support/InterestGrid.h"
+#include "ObjectModel/ObjectTemplateManager.h"
+#include <pandaFramework.h>
+#include <algorithm>
+
+struct InterestGridTestCaseFixture
+{
+	InterestGridTestCaseFixture() :
+			objectTmplMgr(NULL), grid(NULL), root("root")
+	{
+		int argc = 0;
+		char** argv = NULL;
+		panda = new PandaFramework();
+		panda->open_framework(argc, argv);
+		win = panda->open_window();
+		Object::init_type();
+		ObjectTemplate::init_type();
+		if (not ObjectTemplateManager::GetSingletonPtr())
+		{
+			objectTmplMgr = new ObjectTemplateManager();
+		}
+		ObjectTemplateManager::GetSingletonPtr()->addObjectTemplate(
+				new ObjectTemplate(ObjectType("InterestGrid_test"),
+						ObjectTemplateManager::GetSingletonPtr(), panda, win));
+	}
+	~InterestGridTestCaseFixture()
+	{
+		delete grid;
+		std::list<SMARTPTR(Object)> objects =
+				ObjectTemplateManager::GetSingletonPtr()->getCreatedObjects();
+		std::list<SMARTPTR(Object)>::const_iterator iter;
+		for (iter = objects.begin(); iter != objects.end(); ++iter)
+		{
+			ObjectTemplateManager::GetSingletonPtr()->destroyObject(
+					(*iter)->objectId());
+		}
+		ObjectTemplateManager::GetSingletonPtr()->removeObjectTemplate(
+				ObjectType("InterestGrid_test"));
+		delete objectTmplMgr;
+		panda->close_framework();
+		delete panda;
+	}
+	///creates an Object at a position (wrt the root)
+	SMARTPTR(Object) create(const ObjectId& objectId, const LPoint3f& pos)
+	{
+		SMARTPTR(Object) object =
+				ObjectTemplateManager::GetSingletonPtr()->createObject(
+						ObjectType("InterestGrid_test"), objectId);
+		if (object)
+		{
+			object->getNodePath().reparent_to(root);
+			object->getNodePath().set_pos(pos);
+		}
+		return object;
+	}
+	void move(const ObjectId& objectId, const LPoint3f& pos)
+	{
+		ObjectTemplateManager::GetSingletonPtr()->getCreatedObject(objectId)->getNodePath().set_pos(
+				pos);
+	}
+	///the Objects within a radius, sorted and joined
+	std::string query(const LPoint3f& center, float radius)
+	{
+		std::vector<ObjectId> result;
+		grid->queryRadius(center, radius, result);
+		return join(result);
+	}
+	static std::string join(std::vector<ObjectId>& result)
+	{
+		std::sort(result.begin(), result.end());
+		std::string joined;
+		for (unsigned int i = 0; i < result.size(); ++i)
+		{
+			joined += result[i];
+		}
+		return joined;
+	}
+	ObjectTemplateManager* objectTmplMgr;
+	PandaFramework* panda;
+	WindowFramework* win;
+	InterestGrid* grid;
+	NodePath root;
+};
+
+/// Support suite
+BOOST_FIXTURE_TEST_SUITE(Support, SupportSuiteFixture)
+
+/// Test cases
+BOOST_FIXTURE_TEST_CASE(InterestGridQueriesTEST, InterestGridTestCaseFixture)
+{
+	//already created Objects are tracked too
+	BOOST_REQUIRE(create("A", LPoint3f(1, 1, 0)));
+	BOOST_REQUIRE(create("B", LPoint3f(5, 0, 3)));
+	grid = new InterestGrid(10.0, 64);
+	BOOST_REQUIRE(create("C", LPoint3f(30, 0, 0)));
+	BOOST_REQUIRE(create("D", LPoint3f(-15, -15, 0)));
+	grid->refresh();
+	BOOST_CHECK_EQUAL(grid->getStats().mObjects, 4u);
+	LPoint3f pos;
+	BOOST_REQUIRE(grid->getPosition("C", pos));
+	BOOST_CHECK(pos == LPoint3f(30, 0, 0));
+	BOOST_CHECK(not grid->getPosition("Unknown", pos));
+	//on the plane only: B's z doesn't count
+	BOOST_CHECK_EQUAL(query(LPoint3f::zero(), 10.0), "AB");
+	BOOST_CHECK_EQUAL(query(LPoint3f(20, 0, 0), 10.0), "C");
+	BOOST_CHECK_EQUAL(query(LPoint3f(100, 100, 0), 10.0), "");
+	BOOST_CHECK_EQUAL(query(LPoint3f::zero(), -1.0), "");
+	//a huge circle visits the entries instead of the cells
+	BOOST_CHECK_EQUAL(query(LPoint3f::zero(), 1000.0), "ABCD");
+	//near an Object: excluding it
+	std::vector<ObjectId> result;
+	BOOST_REQUIRE(grid->queryNear("A", 5.0, result));
+	BOOST_CHECK_EQUAL(join(result), "B");
+	BOOST_CHECK(not grid->queryNear("Unknown", 5.0, result));
+}
+
+BOOST_FIXTURE_TEST_CASE(InterestGridRefreshTEST, InterestGridTestCaseFixture)
+{
+	grid = new InterestGrid(10.0, 64);
+	BOOST_REQUIRE(create("A", LPoint3f(1, 1, 0)));
+	BOOST_REQUIRE(create("B", LPoint3f(5, 0, 0)));
+	BOOST_REQUIRE(create("C", LPoint3f(30, 0, 0)));
+	grid->refresh();
+	BOOST_CHECK_EQUAL(query(LPoint3f::zero(), 10.0), "AB");
+	//only the Objects changing cell are moved
+	move("A", LPoint3f(2, 2, 0));
+	move("C", LPoint3f(3, 3, 0));
+	grid->refresh();
+	BOOST_CHECK_EQUAL(grid->getStats().mCellChanges, 1u);
+	BOOST_CHECK_EQUAL(query(LPoint3f::zero(), 10.0), "ABC");
+	//updated now, not at the next refresh
+	move("B", LPoint3f(50, 50, 0));
+	grid->updateObject("B");
+	BOOST_CHECK_EQUAL(query(LPoint3f::zero(), 10.0), "AC");
+	BOOST_CHECK_EQUAL(query(LPoint3f(50, 50, 0), 1.0), "B");
+	//destroyed Objects are untracked, their entries reused
+	ObjectTemplateManager::GetSingletonPtr()->destroyObject("A");
+	BOOST_CHECK_EQUAL(grid->getStats().mObjects, 2u);
+	BOOST_CHECK_EQUAL(query(LPoint3f::zero(), 10.0), "C");
+	BOOST_REQUIRE(create("E", LPoint3f(-1, 0, 0)));
+	grid->refresh();
+	BOOST_CHECK_EQUAL(query(LPoint3f::zero(), 10.0), "CE");
+}
+
+BOOST_FIXTURE_TEST_CASE(InterestGridCollidingCellsTEST,
+		InterestGridTestCaseFixture)
+{
+	//two buckets: at least two of the three cells collide
+	grid = new InterestGrid(1.0, 2);
+	BOOST_REQUIRE(create("A", LPoint3f(0.5, 0.5, 0)));
+	BOOST_REQUIRE(create("B", LPoint3f(2.5, 0.5, 0)));
+	BOOST_REQUIRE(create("C", LPoint3f(-3.5, 7.5, 0)));
+	grid->refresh();
+	//one cell queries: the other cells' entries are skipped
+	BOOST_CHECK_EQUAL(query(LPoint3f(0.5, 0.5, 0), 0.4), "A");
+	BOOST_CHECK_EQUAL(query(LPoint3f(2.5, 0.5, 0), 0.4), "B");
+	BOOST_CHECK_EQUAL(query(LPoint3f(-3.5, 7.5, 0), 0.4), "C");
+	InterestGrid::InterestGridStats stats = grid->getStats();
+	BOOST_CHECK_EQUAL(stats.mQueries, 3u);
+	BOOST_CHECK_EQUAL(stats.mFound, 3u);
+	BOOST_CHECK(stats.mVisited > stats.mFound);
+	BOOST_CHECK_EQUAL(query(LPoint3f::zero(), 100.0), "ABC");
+}
+
+BOOST_AUTO_TEST_SUITE_END() // Support suite
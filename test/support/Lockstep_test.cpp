@@ -0,0 +1,135 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/test/support/Lockstep_test.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "SupportSuiteFixture.h"
+#include "Support/Lockstep.h"
+#include "ObjectModel/ObjectTemplateManager.h"
+#include <pandaFramework.h>
+#include <cstdlib>
+#include <sstream>
+
+struct LockstepTestCaseFixture
+{
+	LockstepTestCaseFixture() :
+			objectTmplMgr(NULL)
+	{
+		int argc = 0;
+		char** argv = NULL;
+		panda = new PandaFramework();
+		panda->open_framework(argc, argv);
+		win = panda->open_window();
+		Object::init_type();
+		ObjectTemplate::init_type();
+		if (not ObjectTemplateManager::GetSingletonPtr())
+		{
+			objectTmplMgr = new ObjectTemplateManager();
+		}
+		ObjectTemplateManager::GetSingletonPtr()->addObjectTemplate(
+				new ObjectTemplate(ObjectType("Lockstep_test"),
+						ObjectTemplateManager::GetSingletonPtr(), panda, win));
+	}
+	~LockstepTestCaseFixture()
+	{
+		ObjectTemplateManager::GetSingletonPtr()->removeObjectTemplate(
+				ObjectType("Lockstep_test"));
+		delete objectTmplMgr;
+		panda->close_framework();
+		delete panda;
+	}
+	///a run: objects moved by (per object seeded) random draws
+	std::vector<unsigned int> run(unsigned int seed, int numTicks)
+	{
+		std::vector<unsigned int> checksums;
+		Lockstep* lockstep = new Lockstep(1.0 / 60.0, seed, numTicks);
+		std::vector<ObjectId> objectIds;
+		for (int i = 0; i < 4; ++i)
+		{
+			std::ostringstream objectId;
+			objectId << "LockstepObject" << i;
+			objectIds.push_back(objectId.str());
+			SMARTPTR(Object) object =
+					ObjectTemplateManager::GetSingletonPtr()->createObject(
+							ObjectType("Lockstep_test"), objectIds.back());
+			BOOST_REQUIRE(object);
+			object->setNodePath(NodePath(objectIds.back()));
+		}
+		for (int t = 0; t < numTicks; ++t)
+		{
+			for (unsigned int i = 0; i < objectIds.size(); ++i)
+			{
+				Lockstep::seedRandom(objectIds[i]);
+				SMARTPTR(Object) object =
+						ObjectTemplateManager::GetSingletonPtr()->getCreatedObject(
+								objectIds[i]);
+				object->getNodePath().set_pos(rand() % 100, rand() % 100,
+						rand() % 100);
+			}
+			lockstep->endTick(NULL);
+		}
+		for (int t = 0; t < numTicks; ++t)
+		{
+			unsigned int checksum;
+			BOOST_CHECK(lockstep->getChecksum(t, checksum));
+			checksums.push_back(checksum);
+		}
+		//not yet computed
+		unsigned int checksum;
+		BOOST_CHECK(not lockstep->getChecksum(numTicks, checksum));
+		for (unsigned int i = 0; i < objectIds.size(); ++i)
+		{
+			ObjectTemplateManager::GetSingletonPtr()->destroyObject(objectIds[i]);
+		}
+		delete lockstep;
+		return checksums;
+	}
+	ObjectTemplateManager* objectTmplMgr;
+	PandaFramework* panda;
+	WindowFramework* win;
+};
+
+/// Support suite
+BOOST_FIXTURE_TEST_SUITE(Support, SupportSuiteFixture)
+
+/// Test cases
+BOOST_FIXTURE_TEST_CASE(LockstepChecksumsTEST, LockstepTestCaseFixture)
+{
+	//same seed: same checksums
+	std::vector<unsigned int> first = run(12345, 30);
+	std::vector<unsigned int> second = run(12345, 30);
+	BOOST_REQUIRE_EQUAL(first.size(), 30u);
+	BOOST_CHECK(first == second);
+	//another seed: other random draws
+	std::vector<unsigned int> other = run(54321, 30);
+	BOOST_CHECK(first != other);
+}
+
+BOOST_AUTO_TEST_CASE(LockstepHash64TEST)
+{
+	//the little endian bytes of the value, whatever the platform
+	const unsigned char bytes[8] =
+	{ 0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01 };
+	BOOST_CHECK_EQUAL(Lockstep::hash64(0x0102030405060708ULL),
+			Lockstep::hash(bytes, sizeof(bytes)));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // Support suite
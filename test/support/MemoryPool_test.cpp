@@ -0,0 +1,168 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/test/support/MemoryPool_test.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "SupportSuiteFixture.h"
+#include "Support/MemoryPool/ConcurrentMemoryPool.h"
+#include <vector>
+
+struct MemoryPoolTestCaseFixture
+{
+	MemoryPoolTestCaseFixture()
+	{
+	}
+	~MemoryPoolTestCaseFixture()
+	{
+	}
+	///allocates num chunks from a concurrent pool
+	void allocChunks(ConcurrentMemoryPool& pool, unsigned int num)
+	{
+		for (unsigned int i = 0; i < num; ++i)
+		{
+			chunks.push_back(pool.alloc());
+		}
+	}
+	///frees all the chunks to a concurrent pool
+	void freeChunks(ConcurrentMemoryPool& pool)
+	{
+		for (unsigned int i = 0; i < chunks.size(); ++i)
+		{
+			pool.free(chunks[i]);
+		}
+		chunks.clear();
+	}
+	std::vector<void*> chunks;
+};
+
+/// Support suite
+BOOST_FIXTURE_TEST_SUITE(Support, SupportSuiteFixture)
+
+/// Test cases
+BOOST_FIXTURE_TEST_CASE(MemoryPoolTrimTEST, MemoryPoolTestCaseFixture)
+{
+	MemoryPool pool;
+	BOOST_REQUIRE(pool.Init(32, 4));
+	//three blocks, in allocation order
+	void* pMem[12];
+	for (int i = 0; i < 12; ++i)
+	{
+		pMem[i] = pool.Alloc();
+		BOOST_REQUIRE(pMem[i]);
+	}
+	BOOST_CHECK_EQUAL(pool.GetNumBlocks(), 3u);
+	BOOST_CHECK_EQUAL(pool.GetNumFreeBlocks(), 0u);
+	BOOST_CHECK_EQUAL(pool.Trim(), 0u);
+	//free the first two blocks
+	for (int i = 0; i < 8; ++i)
+	{
+		BOOST_CHECK(pool.Free(pMem[i]));
+	}
+	BOOST_CHECK_EQUAL(pool.GetNumFreeBlocks(), 2u);
+	BOOST_CHECK_EQUAL(pool.Trim(), 2u);
+	BOOST_CHECK_EQUAL(pool.GetNumBlocks(), 1u);
+	//chunks not belonging to the pool are refused
+	int local;
+	BOOST_CHECK(not pool.Free(&local));
+	BOOST_CHECK(not pool.Free(pMem[0]));
+	BOOST_CHECK(not pool.Free(reinterpret_cast<char*>(pMem[8]) + 1));
+	BOOST_CHECK(pool.Free(NULL));
+	//the remaining block is still usable
+	for (int i = 8; i < 12; ++i)
+	{
+		BOOST_CHECK(pool.Free(pMem[i]));
+	}
+	BOOST_CHECK_EQUAL(pool.Trim(), 1u);
+	BOOST_CHECK_EQUAL(pool.GetNumBlocks(), 0u);
+	void* pNew = pool.Alloc();
+	BOOST_CHECK(pNew);
+	BOOST_CHECK_EQUAL(pool.GetNumBlocks(), 1u);
+	BOOST_CHECK(pool.Free(pNew));
+}
+
+BOOST_FIXTURE_TEST_CASE(ConcurrentMemoryPoolStatsTEST, MemoryPoolTestCaseFixture)
+{
+	ConcurrentMemoryPool pool;
+	//16 chunks per block, caches of 8 chunks refilled by 4
+	BOOST_REQUIRE(pool.init(40, 16, 8));
+	allocChunks(pool, 20);
+	MemoryPoolStats stats = pool.getStats();
+	BOOST_CHECK_EQUAL(stats.mChunkSize, 40u);
+	BOOST_CHECK_EQUAL(stats.mMisses, 5u);
+	//the last refill's hits are still in the cache
+	BOOST_CHECK_EQUAL(stats.mHits, 12u);
+	BOOST_CHECK_EQUAL(stats.mOutstanding, 20u);
+	BOOST_CHECK_EQUAL(stats.mHighWater, 20u);
+	BOOST_CHECK_EQUAL(stats.mBlocks, 2u);
+	//the cache keeps at most 8 chunks: the others go back
+	freeChunks(pool);
+	stats = pool.getStats();
+	BOOST_CHECK_EQUAL(stats.mOutstanding, 5u);
+	BOOST_CHECK_EQUAL(stats.mHighWater, 20u);
+	BOOST_CHECK_EQUAL(stats.mInvalid, 0u);
+	//no auto trimming by default
+	BOOST_CHECK_EQUAL(stats.mBlocks, 2u);
+	BOOST_CHECK_EQUAL(stats.mTrimmed, 0u);
+	unsigned int trimmed = pool.trim();
+	stats = pool.getStats();
+	BOOST_CHECK_EQUAL(stats.mTrimmed, trimmed);
+	BOOST_CHECK_EQUAL(stats.mBlocks + trimmed, 2u);
+}
+
+BOOST_FIXTURE_TEST_CASE(ConcurrentMemoryPoolAutoTrimTEST, MemoryPoolTestCaseFixture)
+{
+	ConcurrentMemoryPool pool;
+	BOOST_REQUIRE(pool.init(64, 4, 4));
+	pool.setAutoTrim(true);
+	allocChunks(pool, 40);
+	BOOST_CHECK_EQUAL(pool.getStats().mBlocks, 10u);
+	//the totally free blocks are released while draining
+	freeChunks(pool);
+	MemoryPoolStats stats = pool.getStats();
+	BOOST_CHECK(stats.mTrimmed > 0);
+	BOOST_CHECK_EQUAL(stats.mBlocks + stats.mTrimmed, 10u);
+	//and reallocated on demand
+	allocChunks(pool, 40);
+	for (unsigned int i = 0; i < chunks.size(); ++i)
+	{
+		BOOST_CHECK(chunks[i]);
+	}
+	BOOST_CHECK_EQUAL(pool.getStats().mOutstanding, 40u);
+	freeChunks(pool);
+}
+
+BOOST_AUTO_TEST_CASE(SizeClassPoolsTEST)
+{
+	BOOST_CHECK_EQUAL(SizeClassPools::getNumSizeClasses(), 15u);
+	//the smallest class not less than the size
+	void* pMem = SizeClassPools::alloc(100);
+	BOOST_CHECK(pMem);
+	BOOST_CHECK_EQUAL(SizeClassPools::getStats(4).mChunkSize, 128u);
+	BOOST_CHECK(SizeClassPools::getStats(4).mOutstanding > 0);
+	SizeClassPools::free(pMem, 100);
+	//bigger requests go to the heap
+	pMem = SizeClassPools::alloc(5000);
+	BOOST_CHECK(pMem);
+	SizeClassPools::free(pMem, 5000);
+	BOOST_CHECK_EQUAL(SizeClassPools::getStats(15).mChunkSize, 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // Support suite
@@ -0,0 +1,213 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/test/support/Profiler_test.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "SupportSuiteFixture.h"
+#include "Support/Profiler.h"
+#include <trueClock.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+struct ProfilerTestCaseFixture
+{
+	ProfilerTestCaseFixture() :
+			fileName("Profiler_test.json")
+	{
+		//4 frames, small rings
+		profiler = new Profiler(4, 64);
+		profiler->setEnabled(true);
+		outer = Profiler::registerZone("ProfilerTest::outer");
+		inner = Profiler::registerZone("ProfilerTest::inner");
+	}
+	~ProfilerTestCaseFixture()
+	{
+		delete profiler;
+		remove(fileName.c_str());
+	}
+	static void busyWait(double seconds)
+	{
+		TrueClock* clock = TrueClock::get_global_ptr();
+		double start = clock->get_short_time();
+		while (clock->get_short_time() - start < seconds)
+		{
+		}
+	}
+	static int count(const std::string& text, const std::string& pattern)
+	{
+		int num = 0;
+		std::string::size_type pos = text.find(pattern);
+		while (pos != std::string::npos)
+		{
+			++num;
+			pos = text.find(pattern, pos + pattern.size());
+		}
+		return num;
+	}
+	std::string fileName;
+	Profiler* profiler;
+	Profiler::ZoneId outer, inner;
+};
+
+/// Support suite
+BOOST_FIXTURE_TEST_SUITE(Support, SupportSuiteFixture)
+
+/// Test cases
+BOOST_FIXTURE_TEST_CASE(ProfilerNestedZonesTEST, ProfilerTestCaseFixture)
+{
+	//zones are registered once
+	BOOST_CHECK_EQUAL(Profiler::registerZone("ProfilerTest::outer"), outer);
+	BOOST_CHECK_EQUAL(Profiler::getZoneName(inner), "ProfilerTest::inner");
+	BOOST_CHECK(Profiler::getZoneName(-1).empty());
+	{
+		ProfileScope outerScope(outer);
+		busyWait(0.002);
+		{
+			ProfileScope innerScope(inner);
+			busyWait(0.002);
+		}
+		{
+			PROFILE_ZONE("ProfilerTest::inner");
+		}
+	}
+	//an end without its begin is discarded
+	profiler->end(inner);
+	profiler->collect();
+	std::vector<Profiler::Frame> frames;
+	profiler->getFrames(frames);
+	BOOST_REQUIRE_EQUAL(frames.size(), 1u);
+	BOOST_CHECK_EQUAL(frames[0].mNumber, 0u);
+	//zones in closing order
+	const std::vector<Profiler::Zone>& zones = frames[0].mZones;
+	BOOST_REQUIRE_EQUAL(zones.size(), 3u);
+	BOOST_CHECK_EQUAL(zones[0].mId, inner);
+	BOOST_CHECK_EQUAL(zones[1].mId, inner);
+	BOOST_CHECK_EQUAL(zones[2].mId, outer);
+	BOOST_CHECK_EQUAL(zones[0].mDepth, 1);
+	BOOST_CHECK_EQUAL(zones[1].mDepth, 1);
+	BOOST_CHECK_EQUAL(zones[2].mDepth, 0);
+	for (unsigned int z = 0; z < 2; ++z)
+	{
+		BOOST_CHECK_EQUAL(zones[z].mThread, zones[2].mThread);
+		BOOST_CHECK(zones[z].mStart >= zones[2].mStart);
+		BOOST_CHECK(zones[z].mEnd <= zones[2].mEnd);
+	}
+	BOOST_CHECK(zones[1].mStart >= zones[0].mEnd);
+	//timings
+	BOOST_CHECK(zones[0].mEnd - zones[0].mStart >= 0.002);
+	BOOST_CHECK(zones[2].mEnd - zones[2].mStart >= 0.004);
+	BOOST_CHECK(frames[0].mEnd >= zones[2].mEnd);
+	//disabled: nothing is recorded
+	profiler->setEnabled(false);
+	{
+		ProfileScope outerScope(outer);
+	}
+	profiler->collect();
+	profiler->getFrames(frames);
+	BOOST_REQUIRE_EQUAL(frames.size(), 2u);
+	BOOST_CHECK(frames[1].mZones.empty());
+	BOOST_CHECK_EQUAL(frames[1].mStart, frames[0].mEnd);
+	Profiler::ProfilerStats stats = profiler->getStats();
+	BOOST_CHECK_EQUAL(stats.mFrames, 2u);
+	BOOST_CHECK_EQUAL(stats.mZones, 3u);
+	BOOST_CHECK_EQUAL(stats.mDropped, 0u);
+	BOOST_CHECK_EQUAL(stats.mThreads, 1u);
+}
+
+BOOST_FIXTURE_TEST_CASE(ProfilerFramesTEST, ProfilerTestCaseFixture)
+{
+	//a zone can span frames
+	profiler->begin(outer);
+	profiler->collect();
+	profiler->end(outer);
+	profiler->collect();
+	std::vector<Profiler::Frame> frames;
+	profiler->getFrames(frames);
+	BOOST_REQUIRE_EQUAL(frames.size(), 2u);
+	BOOST_CHECK(frames[0].mZones.empty());
+	BOOST_REQUIRE_EQUAL(frames[1].mZones.size(), 1u);
+	BOOST_CHECK(frames[1].mZones[0].mStart <= frames[1].mStart);
+	//only the recent frames are kept, the oldest first
+	for (int f = 0; f < 5; ++f)
+	{
+		profiler->collect();
+	}
+	profiler->getFrames(frames);
+	BOOST_REQUIRE_EQUAL(frames.size(), 4u);
+	for (unsigned int f = 0; f < frames.size(); ++f)
+	{
+		BOOST_CHECK_EQUAL(frames[f].mNumber, f + 3);
+	}
+	//a full ring drops the events
+	for (int z = 0; z < 64; ++z)
+	{
+		profiler->begin(inner);
+	}
+	profiler->collect();
+	BOOST_CHECK(profiler->getStats().mDropped > 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(ProfilerChromeTraceTEST, ProfilerTestCaseFixture)
+{
+	Profiler::ZoneId quoted = Profiler::registerZone(
+			"ProfilerTest::\"quoted\\zone\"");
+	{
+		ProfileScope outerScope(outer);
+		ProfileScope quotedScope(quoted);
+	}
+	profiler->collect();
+	{
+		ProfileScope innerScope(inner);
+	}
+	profiler->collect();
+	BOOST_REQUIRE(profiler->writeChromeTrace(fileName));
+	std::ifstream file(fileName.c_str());
+	std::ostringstream content;
+	content << file.rdbuf();
+	std::string trace = content.str();
+	BOOST_CHECK_EQUAL(trace.find("{\"traceEvents\":["), 0u);
+	BOOST_CHECK(
+			trace.find("],\"displayTimeUnit\":\"ms\"}")
+					!= std::string::npos);
+	//a complete event per frame and per zone
+	BOOST_CHECK_EQUAL(count(trace, "\"ph\":\"X\""), 5);
+	BOOST_CHECK_EQUAL(count(trace, "\"cat\":\"frame\""), 2);
+	BOOST_CHECK_EQUAL(count(trace, "\"cat\":\"zone\""), 3);
+	BOOST_CHECK(trace.find("\"name\":\"Frame 0\"") != std::string::npos);
+	BOOST_CHECK(trace.find("\"name\":\"Frame 1\"") != std::string::npos);
+	BOOST_CHECK(
+			trace.find("\"name\":\"ProfilerTest::outer\"")
+					!= std::string::npos);
+	//names are escaped
+	BOOST_CHECK(
+			trace.find("\"name\":\"ProfilerTest::\\\"quoted\\\\zone\\\"\"")
+					!= std::string::npos);
+	//zones are on their thread's track, frames on track 0
+	BOOST_CHECK_EQUAL(count(trace, "\"tid\":0}"), 2);
+	BOOST_CHECK_EQUAL(count(trace, "\"tid\":1}"), 3);
+	//not writable
+	BOOST_CHECK(
+			not profiler->writeChromeTrace(
+					"ProfilerTestNoDir/Profiler_test.json"));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // Support suite
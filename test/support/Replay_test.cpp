@@ -0,0 +1,186 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/test/support/Replay_test.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "SupportSuiteFixture.h"
+#include "Support/Replay.h"
+#include "Support/Lockstep.h"
+#include "ObjectModel/ObjectTemplateManager.h"
+#include <pandaFramework.h>
+#include <clockObject.h>
+#include <cstdio>
+
+struct ReplayTestCaseFixture
+{
+	ReplayTestCaseFixture() :
+			fileName("Replay_test.rpl"), objectTmplMgr(NULL)
+	{
+		int argc = 0;
+		char** argv = NULL;
+		panda = new PandaFramework();
+		panda->open_framework(argc, argv);
+		win = panda->open_window();
+		Object::init_type();
+		ObjectTemplate::init_type();
+		if (not ObjectTemplateManager::GetSingletonPtr())
+		{
+			objectTmplMgr = new ObjectTemplateManager();
+		}
+		ObjectTemplateManager::GetSingletonPtr()->addObjectTemplate(
+				new ObjectTemplate(ObjectType("Replay_test"),
+						ObjectTemplateManager::GetSingletonPtr(), panda, win));
+		//frames' delta times are set by the test
+		clock = ClockObject::get_global_clock();
+		clock->set_mode(ClockObject::M_slave);
+	}
+	~ReplayTestCaseFixture()
+	{
+		clock->set_mode(ClockObject::M_normal);
+		ObjectTemplateManager::GetSingletonPtr()->removeObjectTemplate(
+				ObjectType("Replay_test"));
+		delete objectTmplMgr;
+		panda->close_framework();
+		delete panda;
+		remove(fileName.c_str());
+	}
+	SMARTPTR(Object) create(const ObjectId& objectId)
+	{
+		return ObjectTemplateManager::GetSingletonPtr()->createObject(
+				ObjectType("Replay_test"), objectId);
+	}
+	bool destroy(const ObjectId& objectId)
+	{
+		return ObjectTemplateManager::GetSingletonPtr()->destroyObject(
+				objectId);
+	}
+	bool exists(const ObjectId& objectId)
+	{
+		return ObjectTemplateManager::GetSingletonPtr()->getCreatedObject(
+				objectId) != NULL;
+	}
+	///starts a frame with the given (real) delta time
+	void frame(Replay* replay, float dt)
+	{
+		clock->set_dt(dt);
+		replay->update(NULL);
+	}
+	std::string fileName;
+	PandaFramework* panda;
+	WindowFramework* win;
+	ObjectTemplateManager* objectTmplMgr;
+	ClockObject* clock;
+};
+
+/// Support suite
+BOOST_FIXTURE_TEST_SUITE(Support, SupportSuiteFixture)
+
+/// Test cases
+BOOST_FIXTURE_TEST_CASE(ReplayRoundTripTEST, ReplayTestCaseFixture)
+{
+	//record: 3 frames
+	Replay* replay = new Replay(Replay::RECORDING, fileName);
+	BOOST_REQUIRE(replay->start());
+	BOOST_CHECK(replay->isRecording());
+	BOOST_CHECK(not replay->start());
+	frame(replay, 0.01);
+	BOOST_REQUIRE(create(ObjectId("ReplayObject0")));
+	SMARTPTR(Object) generated = create(ObjectId(""));
+	BOOST_REQUIRE(generated);
+	ObjectId generatedId = generated->objectId();
+	generated.clear();
+	frame(replay, 0.02);
+	BOOST_CHECK(destroy(ObjectId("ReplayObject0")));
+	bool moved = true;
+	float deltaX = 1.5, deltaY = -2.5;
+	Replay::pointerInput("ReplayPointer", moved, deltaX, deltaY);
+	frame(replay, 0.03);
+	//the last frame is written on destruction
+	delete replay;
+	BOOST_CHECK(not Replay::GetSingletonPtr());
+	//not recorded
+	BOOST_CHECK(destroy(generatedId));
+	BOOST_CHECK(not exists(ObjectId("ReplayObject0")));
+
+	//replay with other real delta times
+	replay = new Replay(Replay::REPLAYING, fileName);
+	BOOST_REQUIRE(replay->start());
+	BOOST_CHECK(replay->isReplaying());
+	//runtime creations are refused
+	BOOST_CHECK(not create(ObjectId("ReplayOther")));
+	frame(replay, 0.5);
+	BOOST_CHECK_EQUAL(Lockstep::getFrameDt(), 0.01f);
+	BOOST_CHECK_EQUAL(replay->getFrameDt(), 0.01f);
+	BOOST_CHECK(exists(ObjectId("ReplayObject0")));
+	BOOST_CHECK(exists(generatedId));
+	BOOST_CHECK(not create(ObjectId("ReplayOther")));
+	//runtime destructions are refused
+	BOOST_CHECK(not destroy(generatedId));
+	BOOST_CHECK(exists(generatedId));
+	//no recorded pointer movement in this frame
+	moved = true;
+	Replay::pointerInput("ReplayPointer", moved, deltaX, deltaY);
+	BOOST_CHECK(not moved);
+	frame(replay, 0.5);
+	BOOST_CHECK_EQUAL(Lockstep::getFrameDt(), 0.02f);
+	BOOST_CHECK(not exists(ObjectId("ReplayObject0")));
+	BOOST_CHECK(exists(generatedId));
+	moved = false;
+	deltaX = deltaY = 0.0;
+	Replay::pointerInput("ReplayPointer", moved, deltaX, deltaY);
+	BOOST_CHECK(moved);
+	BOOST_CHECK_EQUAL(deltaX, 1.5f);
+	BOOST_CHECK_EQUAL(deltaY, -2.5f);
+	frame(replay, 0.5);
+	BOOST_CHECK_EQUAL(Lockstep::getFrameDt(), 0.03f);
+	BOOST_CHECK(replay->isReplaying());
+	//stream consumed
+	frame(replay, 0.5);
+	BOOST_CHECK(replay->isFinished());
+	BOOST_CHECK(not replay->isReplaying());
+	BOOST_CHECK_EQUAL(Lockstep::getFrameDt(), 0.5f);
+	BOOST_CHECK_EQUAL(replay->getStats().mFrames, 3u);
+	//runtime creations/destructions are allowed again
+	BOOST_CHECK(create(ObjectId("ReplayOther")));
+	BOOST_CHECK(destroy(ObjectId("ReplayOther")));
+	BOOST_CHECK(destroy(generatedId));
+	delete replay;
+}
+
+BOOST_FIXTURE_TEST_CASE(ReplayBadStreamTEST, ReplayTestCaseFixture)
+{
+	//no stream
+	remove(fileName.c_str());
+	Replay* replay = new Replay(Replay::REPLAYING, fileName);
+	BOOST_CHECK(not replay->start());
+	BOOST_CHECK(not replay->isReplaying());
+	delete replay;
+	//not a replay stream
+	FILE* file = fopen(fileName.c_str(), "wb");
+	BOOST_REQUIRE(file);
+	fputs("NOTAREPLAY", file);
+	fclose(file);
+	replay = new Replay(Replay::REPLAYING, fileName);
+	BOOST_CHECK(not replay->start());
+	delete replay;
+}
+
+BOOST_AUTO_TEST_SUITE_END() // Support suite
@@ -0,0 +1,143 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/test/support/Replication_test.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "SupportSuiteFixture.h"
+#include "Support/ReplicationCodec.h"
+
+struct ReplicationTestCaseFixture
+{
+	ReplicationTestCaseFixture()
+	{
+		for (unsigned int i = 1; i <= 50; ++i)
+		{
+			ReplicationCodec::EntityState& state = states[i];
+			state.mObjectId = "Object" + format_string(i);
+			state.mObjectType = "Type";
+			state.mFields = ReplicationCodec::ALL_FIELDS;
+			state.mPos[0] = i * 1000;
+			state.mPos[1] = -(int) i * 700;
+			state.mHpr[0] = -360;
+			state.mVelocity[2] = -100000;
+			state.mFSMState = "Idle";
+		}
+	}
+	bool equal(const ReplicationCodec::EntityStates& first,
+			const ReplicationCodec::EntityStates& second)
+	{
+		Datagram firstDg, secondDg;
+		ReplicationCodec::writeDelta(ReplicationCodec::EntityStates(), first, firstDg);
+		ReplicationCodec::writeDelta(ReplicationCodec::EntityStates(), second, secondDg);
+		return firstDg == secondDg;
+	}
+	ReplicationCodec::EntityStates states;
+};
+
+/// Support suite
+BOOST_FIXTURE_TEST_SUITE(Support, SupportSuiteFixture)
+
+/// Test cases
+BOOST_FIXTURE_TEST_CASE(ReplicationFullSnapshot, ReplicationTestCaseFixture)
+{
+	Datagram dg;
+	ReplicationCodec::writeDelta(ReplicationCodec::EntityStates(), states, dg);
+	DatagramIterator scan(dg);
+	ReplicationCodec::EntityStates decoded;
+	BOOST_REQUIRE(
+			ReplicationCodec::readDelta(ReplicationCodec::EntityStates(), scan, decoded));
+	BOOST_CHECK_EQUAL(scan.get_remaining_size(), 0u);
+	BOOST_CHECK(equal(decoded, states));
+}
+
+BOOST_FIXTURE_TEST_CASE(ReplicationDeltaSnapshot, ReplicationTestCaseFixture)
+{
+	ReplicationCodec::EntityStates changed = states;
+	changed[3].mPos[0] += 2;
+	changed[7].mFSMState = "Run";
+	changed.erase(10);
+	changed[99] = states[1];
+	changed[99].mObjectId = "Spawned";
+	Datagram full, delta, unchanged;
+	ReplicationCodec::writeDelta(ReplicationCodec::EntityStates(), changed, full);
+	ReplicationCodec::writeDelta(states, changed, delta);
+	ReplicationCodec::writeDelta(changed, changed, unchanged);
+	//changes only: two changed, one removed and one new
+	DatagramIterator scan(delta);
+	ReplicationCodec::EntityStates decoded;
+	BOOST_REQUIRE(ReplicationCodec::readDelta(states, scan, decoded));
+	BOOST_CHECK(equal(decoded, changed));
+	BOOST_CHECK(delta.get_length() * 10 < full.get_length());
+	//nothing changed: just the entries' count
+	BOOST_CHECK_EQUAL(unchanged.get_length(), 4u);
+	//a delta without its baseline is refused
+	DatagramIterator noBaseScan(delta);
+	BOOST_CHECK(
+			not ReplicationCodec::readDelta(ReplicationCodec::EntityStates(), noBaseScan,
+					decoded));
+}
+
+BOOST_FIXTURE_TEST_CASE(ReplicationSplitSnapshot, ReplicationTestCaseFixture)
+{
+	Datagram whole;
+	ReplicationCodec::writeDelta(ReplicationCodec::EntityStates(), states,
+			whole);
+	//parts no bigger than the max size, entries never split
+	std::vector<Datagram> parts;
+	ReplicationCodec::writeDelta(ReplicationCodec::EntityStates(), states,
+			parts, 256);
+	BOOST_REQUIRE(parts.size() > 1);
+	unsigned int totalSize = 0;
+	for (unsigned int p = 0; p < parts.size(); ++p)
+	{
+		BOOST_CHECK(parts[p].get_length() <= 256u);
+		totalSize += parts[p].get_length();
+	}
+	//just one entries' count more per part
+	BOOST_CHECK_EQUAL(totalSize, whole.get_length() + 4 * (parts.size() - 1));
+	//applied in order they give the whole snapshot
+	ReplicationCodec::EntityStates decoded;
+	for (unsigned int p = 0; p < parts.size(); ++p)
+	{
+		DatagramIterator scan(parts[p]);
+		BOOST_REQUIRE(ReplicationCodec::applyDelta(scan, decoded));
+		BOOST_CHECK_EQUAL(scan.get_remaining_size(), 0u);
+	}
+	BOOST_CHECK(equal(decoded, states));
+	//a delta split too: removed entries included
+	ReplicationCodec::EntityStates changed = states;
+	changed.erase(1);
+	changed[2].mVelocity[0] = 1;
+	ReplicationCodec::writeDelta(states, changed, parts, 256);
+	decoded = states;
+	for (unsigned int p = 0; p < parts.size(); ++p)
+	{
+		DatagramIterator scan(parts[p]);
+		BOOST_REQUIRE(ReplicationCodec::applyDelta(scan, decoded));
+	}
+	BOOST_CHECK(equal(decoded, changed));
+	//nothing changed: still one (empty) part
+	ReplicationCodec::writeDelta(states, states, parts, 256);
+	BOOST_REQUIRE_EQUAL(parts.size(), 1u);
+	BOOST_CHECK_EQUAL(parts[0].get_length(), 4u);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // Support suite
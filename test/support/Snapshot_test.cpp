@@ -0,0 +1,173 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/test/support/Snapshot_test.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "SupportSuiteFixture.h"
+#include "Support/Snapshot.h"
+#include "ObjectModel/ObjectTemplateManager.h"
+#include <pandaFramework.h>
+#include <cstdio>
+#include <fstream>
+
+struct SnapshotTestCaseFixture
+{
+	SnapshotTestCaseFixture() :
+			objectTmplMgr(NULL), fileName("Snapshot_test.snap")
+	{
+		int argc = 0;
+		char** argv = NULL;
+		panda = new PandaFramework();
+		panda->open_framework(argc, argv);
+		win = panda->open_window();
+		Object::init_type();
+		ObjectTemplate::init_type();
+		if (not ObjectTemplateManager::GetSingletonPtr())
+		{
+			objectTmplMgr = new ObjectTemplateManager();
+		}
+		ObjectTemplateManager::GetSingletonPtr()->addObjectTemplate(
+				new ObjectTemplate(ObjectType("Snapshot_test"),
+						ObjectTemplateManager::GetSingletonPtr(), panda, win));
+	}
+	~SnapshotTestCaseFixture()
+	{
+		std::list<SMARTPTR(Object)> objects =
+				ObjectTemplateManager::GetSingletonPtr()->getCreatedObjects();
+		std::list<SMARTPTR(Object)>::const_iterator iter;
+		for (iter = objects.begin(); iter != objects.end(); ++iter)
+		{
+			ObjectTemplateManager::GetSingletonPtr()->destroyObject(
+					(*iter)->objectId());
+		}
+		ObjectTemplateManager::GetSingletonPtr()->removeObjectTemplate(
+				ObjectType("Snapshot_test"));
+		delete objectTmplMgr;
+		panda->close_framework();
+		delete panda;
+		remove(fileName.c_str());
+	}
+	///creates an Object at a position
+	SMARTPTR(Object) create(const ObjectId& objectId, const LPoint3f& pos,
+			bool storeParams = true)
+	{
+		SMARTPTR(Object) object =
+				ObjectTemplateManager::GetSingletonPtr()->createObject(
+						ObjectType("Snapshot_test"), objectId, ParameterTable(),
+						ParameterTableMap(), storeParams);
+		if (object)
+		{
+			object->getNodePath().set_pos(pos);
+		}
+		return object;
+	}
+	SMARTPTR(Object) get(const ObjectId& objectId)
+	{
+		return ObjectTemplateManager::GetSingletonPtr()->getCreatedObject(
+				objectId);
+	}
+	void destroy(const ObjectId& objectId)
+	{
+		ObjectTemplateManager::GetSingletonPtr()->destroyObject(objectId);
+	}
+	ObjectTemplateManager* objectTmplMgr;
+	PandaFramework* panda;
+	WindowFramework* win;
+	std::string fileName;
+};
+
+/// Support suite
+BOOST_FIXTURE_TEST_SUITE(Support, SupportSuiteFixture)
+
+/// Test cases
+BOOST_FIXTURE_TEST_CASE(SnapshotChunksRoundTripTEST, SnapshotTestCaseFixture)
+{
+	Snapshot snapshot("SnapshotTest");
+	BOOST_REQUIRE(create("A", LPoint3f(1, 0, 0)));
+	BOOST_REQUIRE(create("B", LPoint3f(2, 0, 0)));
+	BOOST_REQUIRE(create("C", LPoint3f(3, 0, 0)));
+	//a full chunk...
+	BOOST_CHECK_EQUAL(snapshot.take(), 3u);
+	BOOST_CHECK_EQUAL(snapshot.take(), 0u);
+	snapshot.save(fileName);
+	//...then a delta one: A changed, C removed
+	get("A")->getNodePath().set_pos(LPoint3f(10, 0, 0));
+	destroy("C");
+	BOOST_CHECK_EQUAL(snapshot.take(), 2u);
+	snapshot.save(fileName);
+	snapshot.waitSaved();
+	BOOST_CHECK_EQUAL(snapshot.getStats().mChunks, 2u);
+	BOOST_CHECK_EQUAL(snapshot.getStats().mErrors, 0u);
+	//read back the chunks, and restore a changed world
+	Snapshot loaded("SnapshotTestLoaded");
+	BOOST_REQUIRE(loaded.load(fileName));
+	BOOST_CHECK_EQUAL(loaded.getStats().mRecords, 2u);
+	get("A")->getNodePath().set_pos(LPoint3f(20, 0, 0));
+	destroy("B");
+	BOOST_REQUIRE(create("D", LPoint3f(4, 0, 0)));
+	BOOST_CHECK(loaded.restore());
+	BOOST_REQUIRE(get("A"));
+	BOOST_CHECK(get("A")->getNodePath().get_pos() == LPoint3f(10, 0, 0));
+	BOOST_REQUIRE(get("B"));
+	BOOST_CHECK(get("B")->getNodePath().get_pos() == LPoint3f(2, 0, 0));
+	BOOST_CHECK(not get("C"));
+	BOOST_CHECK(not get("D"));
+	//a new file: a full chunk again, read back equally
+	BOOST_CHECK_EQUAL(snapshot.take(), 0u);
+	snapshot.save(fileName + "2");
+	snapshot.waitSaved();
+	BOOST_REQUIRE(loaded.load(fileName + "2"));
+	BOOST_CHECK_EQUAL(loaded.getStats().mRecords, 2u);
+	remove((fileName + "2").c_str());
+}
+
+BOOST_FIXTURE_TEST_CASE(SnapshotMissingParamsTEST, SnapshotTestCaseFixture)
+{
+	Snapshot snapshot("SnapshotTest");
+	BOOST_REQUIRE(create("A", LPoint3f(1, 0, 0)));
+	BOOST_REQUIRE(create("NoParams", LPoint3f(2, 0, 0), false));
+	snapshot.take();
+	//it cannot be recreated: the world is left untouched
+	destroy("NoParams");
+	get("A")->getNodePath().set_pos(LPoint3f(10, 0, 0));
+	BOOST_REQUIRE(create("B", LPoint3f(3, 0, 0)));
+	BOOST_CHECK(not snapshot.restore());
+	BOOST_CHECK_EQUAL(snapshot.getStats().mUnrestorable, 1u);
+	BOOST_CHECK(not get("NoParams"));
+	BOOST_CHECK(get("B"));
+	BOOST_CHECK(get("A")->getNodePath().get_pos() == LPoint3f(10, 0, 0));
+	//restorable again without it
+	snapshot.take();
+	BOOST_CHECK(snapshot.restore());
+	BOOST_CHECK_EQUAL(snapshot.getStats().mUnrestorable, 0u);
+}
+
+BOOST_FIXTURE_TEST_CASE(SnapshotBadFilesTEST, SnapshotTestCaseFixture)
+{
+	Snapshot snapshot("SnapshotTest");
+	BOOST_CHECK(not snapshot.load(fileName));
+	std::ofstream out(fileName.c_str(), std::ios::out | std::ios::binary);
+	out << "NOTASNAPSHOT";
+	out.close();
+	BOOST_CHECK(not snapshot.load(fileName));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // Support suite
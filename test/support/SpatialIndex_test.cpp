@@ -0,0 +1,379 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/test/support/SpatialIndex_test.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "SupportSuiteFixture.h"
+#include "Support/SpatialIndex.h"
+#include "ObjectModel/ObjectTemplateManager.h"
+#include <pandaFramework.h>
+#include <clockObject.h>
+#include <algorithm>
+#include <cstdlib>
+
+struct SpatialIndexTestCaseFixture
+{
+	SpatialIndexTestCaseFixture()
+	{
+		srand(1234);
+		index = new SpatialIndex(LPoint3f::zero(), 1000.0);
+	}
+	~SpatialIndexTestCaseFixture()
+	{
+		delete index;
+	}
+	static float random(float min, float max)
+	{
+		return min + (max - min) * (rand() / (float) RAND_MAX);
+	}
+	//spheres in the region (a few large ones, a few outside)
+	void makeSpheres(unsigned int num)
+	{
+		for (unsigned int i = 0; i < num; ++i)
+		{
+			LPoint3f center(random(-1050.0, 1050.0), random(-1050.0, 1050.0),
+					random(-100.0, 100.0));
+			float radius = random(0.1, i % 1000 == 0 ? 300.0 : 3.0);
+			centers.push_back(center);
+			radii.push_back(radius);
+			ids.push_back(index->insert(center, radius));
+		}
+	}
+	//brute force: the ids of the spheres satisfying a test
+	template<typename Test> void bruteForce(const Test& test,
+			std::vector<SpatialIndex::EntryId>& result)
+	{
+		for (unsigned int i = 0; i < ids.size(); ++i)
+		{
+			if ((ids[i] != SpatialIndex::INVALID_ENTRY)
+					and test(centers[i], radii[i]))
+			{
+				result.push_back(ids[i]);
+			}
+		}
+	}
+	template<typename Test> std::vector<SpatialIndex::EntryId> bruteForce(
+			const Test& test)
+	{
+		std::vector<SpatialIndex::EntryId> result;
+		bruteForce(test, result);
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+	static std::vector<SpatialIndex::EntryId> sorted(
+			std::vector<SpatialIndex::EntryId> result)
+	{
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+	SpatialIndex* index;
+	std::vector<LPoint3f> centers;
+	std::vector<float> radii;
+	std::vector<SpatialIndex::EntryId> ids;
+};
+
+struct SphereTest
+{
+	SphereTest(const LPoint3f& center, float radius) :
+			mCenter(center), mRadius(radius)
+	{
+	}
+	bool operator()(const LPoint3f& center, float radius) const
+	{
+		return (center - mCenter).length_squared()
+				<= (radius + mRadius) * (radius + mRadius);
+	}
+	LPoint3f mCenter;
+	float mRadius;
+};
+
+struct BoxTest
+{
+	BoxTest(const LPoint3f& min, const LPoint3f& max) :
+			mMin(min), mMax(max)
+	{
+	}
+	bool operator()(const LPoint3f& center, float radius) const
+	{
+		float distanceSquared = 0.0;
+		for (int i = 0; i < 3; ++i)
+		{
+			float delta =
+					center[i] < mMin[i] ? mMin[i] - center[i] :
+					(center[i] > mMax[i] ? center[i] - mMax[i] : 0.0);
+			distanceSquared += delta * delta;
+		}
+		return distanceSquared <= radius * radius;
+	}
+	LPoint3f mMin, mMax;
+};
+
+struct FrustumTest
+{
+	FrustumTest(const std::vector<LPlanef>& planes) :
+			mPlanes(planes)
+	{
+	}
+	bool operator()(const LPoint3f& center, float radius) const
+	{
+		for (unsigned int i = 0; i < mPlanes.size(); ++i)
+		{
+			if (mPlanes[i].dist_to_plane(center) > radius)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	std::vector<LPlanef> mPlanes;
+};
+
+struct RayTest
+{
+	RayTest(const LPoint3f& origin, const LVector3f& direction, float length) :
+			mOrigin(origin), mDirection(direction), mLength(length)
+	{
+		mDirection.normalize();
+	}
+	bool operator()(const LPoint3f& center, float radius) const
+	{
+		float t = std::max(0.0f,
+				std::min(mLength, (center - mOrigin).dot(mDirection)));
+		return (center - (mOrigin + mDirection * t)).length_squared()
+				<= radius * radius;
+	}
+	LPoint3f mOrigin;
+	LVector3f mDirection;
+	float mLength;
+};
+
+/// Support suite
+BOOST_FIXTURE_TEST_SUITE(Support, SupportSuiteFixture)
+
+/// Test cases
+BOOST_FIXTURE_TEST_CASE(SpatialIndexQueriesTEST, SpatialIndexTestCaseFixture)
+{
+	makeSpheres(5000);
+	//moves, removals and radius changes
+	for (unsigned int i = 0; i < ids.size(); i += 3)
+	{
+		centers[i] += LVector3f(random(-50.0, 50.0), random(-50.0, 50.0), 0.0);
+		index->move(ids[i], centers[i]);
+	}
+	for (unsigned int i = 0; i < ids.size(); i += 7)
+	{
+		index->remove(ids[i]);
+		ids[i] = SpatialIndex::INVALID_ENTRY;
+	}
+	for (unsigned int i = 1; i < ids.size(); i += 7)
+	{
+		radii[i] = random(0.1, 50.0);
+		index->setRadius(ids[i], radii[i]);
+	}
+	BOOST_CHECK_EQUAL(index->getNumEntries(), 5000u - 715u);
+	for (int q = 0; q < 50; ++q)
+	{
+		LPoint3f center(random(-1000.0, 1000.0), random(-1000.0, 1000.0),
+				random(-50.0, 50.0));
+		float radius = random(1.0, 60.0);
+		std::vector<SpatialIndex::EntryId> result;
+		//sphere
+		index->querySphere(center, radius, result);
+		BOOST_CHECK(sorted(result) == bruteForce(SphereTest(center, radius)));
+		//box
+		LPoint3f min = center - LVector3f(radius, radius, radius * 0.5);
+		LPoint3f max = center + LVector3f(radius, radius, radius * 0.5);
+		result.clear();
+		index->queryBox(min, max, result);
+		BOOST_CHECK(sorted(result) == bruteForce(BoxTest(min, max)));
+		//frustum: the box' planes
+		std::vector<LPlanef> planes;
+		for (int i = 0; i < 3; ++i)
+		{
+			LVector3f normal(0.0, 0.0, 0.0);
+			normal[i] = 1.0;
+			planes.push_back(LPlanef(normal, max));
+			planes.push_back(LPlanef(-normal, min));
+		}
+		result.clear();
+		index->queryFrustum(planes, result);
+		BOOST_CHECK(sorted(result) == bruteForce(FrustumTest(planes)));
+		//ray: hits by distance
+		LVector3f direction(random(-1.0, 1.0), random(-1.0, 1.0), 0.1);
+		float length = random(10.0, 800.0);
+		result.clear();
+		index->queryRay(center, direction, length, result);
+		BOOST_CHECK(
+				sorted(result) == bruteForce(RayTest(center, direction, length)));
+		direction.normalize();
+		for (unsigned int i = 1; i < result.size(); ++i)
+		{
+			LPoint3f previous, current;
+			float previousRadius, currentRadius;
+			index->getSphere(result[i - 1], previous, previousRadius);
+			index->getSphere(result[i], current, currentRadius);
+			BOOST_CHECK(
+					(previous - center).dot(direction) - previousRadius
+							<= (current - center).dot(direction) + currentRadius);
+		}
+	}
+	//only the root is left
+	for (unsigned int i = 0; i < ids.size(); ++i)
+	{
+		index->remove(ids[i]);
+	}
+	BOOST_CHECK_EQUAL(index->getStats().mEntries, 0u);
+	BOOST_CHECK_EQUAL(index->getStats().mNodes, 1u);
+}
+
+BOOST_FIXTURE_TEST_CASE(SpatialIndexRefreshTEST, SpatialIndexTestCaseFixture)
+{
+	NodePath root("root");
+	std::vector<NodePath> nodePaths;
+	for (int i = 0; i < 100; ++i)
+	{
+		NodePath np = root.attach_new_node("entity");
+		np.set_pos((i % 10) * 10.0, (i / 10) * 10.0, 0.0);
+		nodePaths.push_back(np);
+		index->insert(np, 1.0);
+	}
+	//nothing moved
+	BOOST_CHECK_EQUAL(index->refresh(), 0u);
+	//one moved a bit, one moved far
+	nodePaths[0].set_pos(-1.0, -1.0, 0.0);
+	nodePaths[1].set_pos(-500.0, 500.0, 0.0);
+	BOOST_CHECK_EQUAL(index->refresh(), 2u);
+	BOOST_CHECK_EQUAL(index->getStats().mRelinked, 1u);
+	std::vector<SpatialIndex::EntryId> result;
+	index->querySphere(LPoint3f(-500.0, 500.0, 0.0), 1.0, result);
+	BOOST_REQUIRE_EQUAL(result.size(), 1u);
+	BOOST_CHECK(index->getNodePath(result[0]) == nodePaths[1]);
+	root.remove_node();
+}
+
+BOOST_FIXTURE_TEST_CASE(SpatialIndexObjectsTEST, SpatialIndexTestCaseFixture)
+{
+	int argc = 0;
+	char** argv = NULL;
+	PandaFramework* panda = new PandaFramework();
+	panda->open_framework(argc, argv);
+	WindowFramework* win = panda->open_window();
+	Object::init_type();
+	ObjectTemplate::init_type();
+	ObjectTemplateManager* objectTmplMgr = NULL;
+	if (not ObjectTemplateManager::GetSingletonPtr())
+	{
+		objectTmplMgr = new ObjectTemplateManager();
+	}
+	ObjectTemplateManager* manager = ObjectTemplateManager::GetSingletonPtr();
+	manager->addObjectTemplate(
+			new ObjectTemplate(ObjectType("SpatialIndex_test"), manager, panda,
+					win));
+	NodePath root("root");
+	//already created Objects are tracked too
+	delete index;
+	SMARTPTR(Object) objectA = manager->createObject(
+			ObjectType("SpatialIndex_test"), "A");
+	BOOST_REQUIRE(objectA);
+	objectA->getNodePath().reparent_to(root);
+	objectA->getNodePath().set_pos(10.0, 0.0, 0.0);
+	index = new SpatialIndex(LPoint3f::zero(), 1000.0);
+	SMARTPTR(Object) objectB = manager->createObject(
+			ObjectType("SpatialIndex_test"), "B");
+	BOOST_REQUIRE(objectB);
+	objectB->getNodePath().reparent_to(root);
+	objectB->getNodePath().set_pos(-10.0, 0.0, 0.0);
+	BOOST_CHECK_EQUAL(index->getNumEntries(), 2u);
+	SpatialIndex::EntryId entryA = index->getObjectEntry("A");
+	BOOST_REQUIRE(entryA != SpatialIndex::INVALID_ENTRY);
+	BOOST_CHECK_EQUAL(index->getObjectId(entryA), "A");
+	BOOST_CHECK(index->getNodePath(entryA) == objectA->getNodePath());
+	//their NodePaths are followed (B was placed when created)
+	BOOST_CHECK_EQUAL(index->refresh(), 1u);
+	std::vector<SpatialIndex::EntryId> result;
+	index->querySphere(LPoint3f(-10.0, 0.0, 0.0), 1.0, result);
+	BOOST_REQUIRE_EQUAL(result.size(), 1u);
+	BOOST_CHECK_EQUAL(index->getObjectId(result[0]), "B");
+	//destroyed Objects are untracked, explicit removals too
+	manager->destroyObject("B");
+	BOOST_CHECK_EQUAL(index->getNumEntries(), 1u);
+	BOOST_CHECK(index->getObjectEntry("B") == SpatialIndex::INVALID_ENTRY);
+	index->remove(entryA);
+	BOOST_CHECK(index->getObjectEntry("A") == SpatialIndex::INVALID_ENTRY);
+	//a reused entry id is no more the Object's
+	SpatialIndex::EntryId entryC = index->insert(LPoint3f(10.0, 0.0, 0.0),
+			1.0);
+	BOOST_CHECK_EQUAL(entryC, entryA);
+	BOOST_CHECK_EQUAL(index->getObjectId(entryC), "");
+	manager->destroyObject("A");
+	BOOST_CHECK_EQUAL(index->getNumEntries(), 1u);
+	manager->removeObjectTemplate(ObjectType("SpatialIndex_test"));
+	delete objectTmplMgr;
+	root.remove_node();
+	panda->close_framework();
+	delete panda;
+}
+
+BOOST_FIXTURE_TEST_CASE(SpatialIndexQueriesBENCH, SpatialIndexTestCaseFixture)
+{
+	const int numQueries = 1000;
+	unsigned int sizes[] =
+	{ 1000, 10000, 100000 };
+	for (int s = 0; s < 3; ++s)
+	{
+		makeSpheres(sizes[s] - ids.size());
+		std::vector<LPoint3f> queryCenters;
+		std::vector<float> queryRadii;
+		for (int q = 0; q < numQueries; ++q)
+		{
+			queryCenters.push_back(
+					LPoint3f(random(-1000.0, 1000.0), random(-1000.0, 1000.0),
+							random(-50.0, 50.0)));
+			queryRadii.push_back(random(1.0, 30.0));
+		}
+		std::vector<SpatialIndex::EntryId> result;
+		unsigned long int indexFound = 0, bruteFound = 0;
+		double start = ClockObject::get_global_clock()->get_real_time();
+		for (int q = 0; q < numQueries; ++q)
+		{
+			result.clear();
+			index->querySphere(queryCenters[q], queryRadii[q], result);
+			indexFound += result.size();
+		}
+		double indexTime = ClockObject::get_global_clock()->get_real_time()
+				- start;
+		//the same work: into the same (reused) result, unsorted
+		start = ClockObject::get_global_clock()->get_real_time();
+		for (int q = 0; q < numQueries; ++q)
+		{
+			result.clear();
+			bruteForce(SphereTest(queryCenters[q], queryRadii[q]), result);
+			bruteFound += result.size();
+		}
+		double bruteTime = ClockObject::get_global_clock()->get_real_time()
+				- start;
+		BOOST_TEST_MESSAGE(
+				"SpatialIndex sphere query (" << sizes[s] << " entities): index " << indexTime * 1000.0 / numQueries << " ms, brute force " << bruteTime * 1000.0 / numQueries << " ms (" << index->getStats().mNodes << " nodes)");
+		BOOST_CHECK_EQUAL(indexFound, bruteFound);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END() // Support suite
@@ -0,0 +1,174 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/test/support/TickScheduler_test.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "SupportSuiteFixture.h"
+#include "Support/TickScheduler.h"
+
+struct TickSchedulerTestMember
+{
+	TickSchedule mSchedule;
+};
+
+struct TickSchedulerTestCaseFixture
+{
+	typedef TickScheduler<TickSchedulerTestMember*, std::string> Scheduler;
+	///ticks every due group, counting ticks per group
+	void tickAll(std::vector<int>& ticks)
+	{
+		ticks.resize(scheduler.getNumGroups(), 0);
+		for (int g = 0; g < scheduler.getNumGroups(); ++g)
+		{
+			if (scheduler.tick(g, inSync, others) >= 0.0)
+			{
+				++ticks[g];
+			}
+		}
+	}
+	Scheduler scheduler;
+	TickSchedulerTestMember a, b, c, d;
+	std::vector<TickSchedulerTestMember*> inSync;
+	std::vector<std::pair<TickSchedulerTestMember*, float> > others;
+};
+
+/// Support suite
+BOOST_FIXTURE_TEST_SUITE(Support, SupportSuiteFixture)
+
+/// Test cases
+BOOST_FIXTURE_TEST_CASE(TickSchedulerGroupingTEST, TickSchedulerTestCaseFixture)
+{
+	//grouped by key and period
+	scheduler.add(&a, "walk", 0.0);
+	scheduler.add(&b, "walk", 0.0);
+	scheduler.add(&c, "run", 0.0);
+	scheduler.add(&d, "walk", 0.5);
+	BOOST_REQUIRE_EQUAL(scheduler.getNumGroups(), 3);
+	BOOST_CHECK_EQUAL(a.mSchedule.mGroup, b.mSchedule.mGroup);
+	BOOST_CHECK(c.mSchedule.mGroup != a.mSchedule.mGroup);
+	BOOST_CHECK(d.mSchedule.mGroup != a.mSchedule.mGroup);
+	BOOST_CHECK_EQUAL(scheduler.getKey(d.mSchedule.mGroup), "walk");
+	BOOST_CHECK_EQUAL(scheduler.getPeriod(d.mSchedule.mGroup), 0.5);
+	BOOST_CHECK_EQUAL(a.mSchedule.mSlot, 0);
+	BOOST_CHECK_EQUAL(b.mSchedule.mSlot, 1);
+	//members stay contiguous
+	int walkGroup = a.mSchedule.mGroup;
+	scheduler.remove(&a);
+	BOOST_CHECK_EQUAL(a.mSchedule.mGroup, -1);
+	BOOST_CHECK_EQUAL(b.mSchedule.mSlot, 0);
+	BOOST_REQUIRE_EQUAL(scheduler.getMembers(walkGroup).size(), 1u);
+	BOOST_CHECK(scheduler.getMembers(walkGroup)[0] == &b);
+	//a state change moves into an existing group
+	scheduler.remove(&c);
+	scheduler.add(&c, "walk", 0.0);
+	BOOST_CHECK_EQUAL(scheduler.getNumGroups(), 3);
+	BOOST_CHECK_EQUAL(c.mSchedule.mGroup, walkGroup);
+	BOOST_CHECK_EQUAL(c.mSchedule.mSlot, 1);
+	scheduler.clear();
+	BOOST_CHECK_EQUAL(scheduler.getNumGroups(), 0);
+	BOOST_CHECK_EQUAL(b.mSchedule.mGroup, -1);
+	BOOST_CHECK_EQUAL(d.mSchedule.mGroup, -1);
+}
+
+BOOST_FIXTURE_TEST_CASE(TickSchedulerPeriodsTEST, TickSchedulerTestCaseFixture)
+{
+	//every frame, every 2 frames and every 4 frames
+	scheduler.add(&a, "walk", 0.0);
+	scheduler.add(&b, "walk", 0.5);
+	scheduler.add(&c, "idle", 1.0);
+	std::vector<int> ticks;
+	for (int f = 0; f < 8; ++f)
+	{
+		scheduler.advance(0.25);
+		tickAll(ticks);
+	}
+	BOOST_CHECK_EQUAL(scheduler.getFrame(), 8u);
+	BOOST_CHECK_EQUAL(ticks[a.mSchedule.mGroup], 8);
+	BOOST_CHECK_EQUAL(ticks[b.mSchedule.mGroup], 4);
+	BOOST_CHECK_EQUAL(ticks[c.mSchedule.mGroup], 2);
+	//ticked with the period elapsed
+	for (int f = 0; f < 3; ++f)
+	{
+		scheduler.advance(0.25);
+	}
+	BOOST_CHECK(scheduler.tick(c.mSchedule.mGroup, inSync, others) < 0.0);
+	scheduler.advance(0.25);
+	BOOST_CHECK_EQUAL(scheduler.tick(c.mSchedule.mGroup, inSync, others),
+			1.0);
+	BOOST_REQUIRE_EQUAL(inSync.size(), 1u);
+	BOOST_CHECK(inSync[0] == &c);
+	BOOST_CHECK(others.empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(TickSchedulerSyncTEST, TickSchedulerTestCaseFixture)
+{
+	//frame times not exactly representable
+	scheduler.add(&a, "walk", 0.25);
+	int group = a.mSchedule.mGroup;
+	scheduler.advance(0.1);
+	BOOST_CHECK(scheduler.tick(group, inSync, others) < 0.0);
+	//a newcomer elapsed less time than the group...
+	scheduler.add(&b, "walk", 0.25);
+	scheduler.advance(0.1);
+	scheduler.advance(0.1);
+	float elapsed = scheduler.tick(group, inSync, others);
+	BOOST_CHECK_CLOSE(elapsed, 0.3, 1.0e-3);
+	BOOST_REQUIRE_EQUAL(inSync.size(), 1u);
+	BOOST_CHECK(inSync[0] == &a);
+	BOOST_REQUIRE_EQUAL(others.size(), 1u);
+	BOOST_CHECK(others[0].first == &b);
+	BOOST_CHECK_CLOSE(others[0].second, 0.2, 1.0e-3);
+	//...until the group's next tick
+	for (int f = 0; f < 3; ++f)
+	{
+		scheduler.advance(0.1);
+	}
+	BOOST_CHECK(scheduler.tick(group, inSync, others) >= 0.0);
+	BOOST_CHECK_EQUAL(inSync.size(), 2u);
+	BOOST_CHECK(others.empty());
+	//leaving and joining back in the same frame
+	scheduler.advance(0.1);
+	scheduler.remove(&b);
+	scheduler.add(&b, "walk", 0.25);
+	scheduler.advance(0.1);
+	scheduler.advance(0.1);
+	BOOST_CHECK(scheduler.tick(group, inSync, others) >= 0.0);
+	BOOST_CHECK_EQUAL(inSync.size(), 1u);
+	BOOST_REQUIRE_EQUAL(others.size(), 1u);
+	BOOST_CHECK(others[0].first == &b);
+	//an emptied group restarts counting with its first member
+	scheduler.remove(&a);
+	scheduler.remove(&b);
+	for (int f = 0; f < 5; ++f)
+	{
+		scheduler.advance(0.1);
+	}
+	scheduler.add(&a, "walk", 0.25);
+	scheduler.advance(0.1);
+	BOOST_CHECK(scheduler.tick(group, inSync, others) < 0.0);
+	scheduler.advance(0.1);
+	scheduler.advance(0.1);
+	BOOST_CHECK(scheduler.tick(group, inSync, others) >= 0.0);
+	BOOST_CHECK_EQUAL(inSync.size(), 1u);
+	BOOST_CHECK(others.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END() // Support suite
@@ -0,0 +1,150 @@
+/*
+ *   This file is part of Ely.
+ *
+ *   Ely is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   Ely is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with Ely.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * \file /Ely/src/test/support/XMLStream_test.cpp
+ *
+ * \date 2026-10-19
+ * \author consultit
+ */
+
+#include "SupportSuiteFixture.h"
+#include "Support/XMLStream.h"
+#include <cstdio>
+#include <fstream>
+
+///records the events as strings
+struct XMLStreamTestHandler: public XMLStreamHandler
+{
+	XMLStreamTestHandler() :
+			stopAt(-1)
+	{
+	}
+	virtual bool startElement(const XMLStringView& name,
+			const XMLStreamAttribute* attributes, unsigned int numAttributes)
+	{
+		std::string event = "<" + name.str();
+		for (unsigned int i = 0; i < numAttributes; ++i)
+		{
+			event += " " + attributes[i].mName.str() + "="
+					+ attributes[i].mValue.str();
+			//views are NUL terminated once reported
+			BOOST_CHECK_EQUAL(std::string(attributes[i].mValue.c_str()),
+					attributes[i].mValue.str());
+		}
+		return record(event + ">");
+	}
+	virtual bool endElement(const XMLStringView& name)
+	{
+		return record("</" + name.str() + ">");
+	}
+	virtual bool text(const XMLStringView& text)
+	{
+		return record("[" + text.str() + "]");
+	}
+	bool record(const std::string& event)
+	{
+		events.push_back(event);
+		return (int) events.size() != stopAt;
+	}
+	std::vector<std::string> events;
+	int stopAt;
+};
+
+struct XMLStreamTestCaseFixture
+{
+	XMLStreamTestCaseFixture() :
+			fileName("XMLStream_test.xml")
+	{
+	}
+	~XMLStreamTestCaseFixture()
+	{
+		remove(fileName.c_str());
+	}
+	bool parse(const std::string& xml)
+	{
+		buffer.assign(xml.begin(), xml.end());
+		buffer.push_back('\0');
+		handler.events.clear();
+		return stream.openBuffer(&buffer[0], xml.size())
+				and stream.parse(handler);
+	}
+	std::string fileName;
+	std::vector<char> buffer;
+	XMLStream stream;
+	XMLStreamTestHandler handler;
+};
+
+/// Support suite
+BOOST_FIXTURE_TEST_SUITE(Support, SupportSuiteFixture)
+
+/// Test cases
+BOOST_FIXTURE_TEST_CASE(XMLStreamEventsTEST, XMLStreamTestCaseFixture)
+{
+	BOOST_REQUIRE(parse("<?xml version=\"1.0\" ?>\n"
+			"<!DOCTYPE Game>\n"
+			"<!-- a game world -->\n"
+			"<Game>\n"
+			"  <ObjectTmpl type=\"Actor\" priority='5'>\n"
+			"    <Param model_file=\"actor.egg\"/>\n"
+			"    <Param parent=\"render &amp; &#x63;o &lt;1&gt;\"/>\n"
+			"  </ObjectTmpl>\n"
+			"  <Text>a &quot;b&quot;<![CDATA[<c>]]></Text>\n"
+			"</Game>\n"));
+	const char* expected[] =
+	{ "<Game>", "<ObjectTmpl type=Actor priority=5>",
+			"<Param model_file=actor.egg>", "</Param>",
+			"<Param parent=render & co <1>>", "</Param>", "</ObjectTmpl>",
+			"<Text>", "[a \"b\"]", "[<c>]", "</Text>", "</Game>" };
+	BOOST_CHECK_EQUAL_COLLECTIONS(handler.events.begin(), handler.events.end(),
+			expected, expected + sizeof(expected) / sizeof(expected[0]));
+}
+
+BOOST_FIXTURE_TEST_CASE(XMLStreamStopTEST, XMLStreamTestCaseFixture)
+{
+	//the handler stops the parsing without errors
+	handler.stopAt = 2;
+	BOOST_CHECK(parse("<Game><ObjectSet><Object/></ObjectSet></Game>"));
+	BOOST_CHECK_EQUAL(handler.events.size(), 2u);
+	BOOST_CHECK(stream.getErrorStr().empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(XMLStreamErrorsTEST, XMLStreamTestCaseFixture)
+{
+	BOOST_CHECK(not parse("<Game>\n<ObjectSet>\n</Game>"));
+	BOOST_CHECK(not stream.getErrorStr().empty());
+	BOOST_CHECK_EQUAL(stream.getErrorLine(), 3);
+	BOOST_CHECK(not parse("<Game><Object type=Actor/></Game>"));
+	BOOST_CHECK(not parse("<Game>"));
+	//no file
+	remove(fileName.c_str());
+	BOOST_CHECK(not stream.open(fileName));
+}
+
+BOOST_FIXTURE_TEST_CASE(XMLStreamFileTEST, XMLStreamTestCaseFixture)
+{
+	{
+		std::ofstream file(fileName.c_str());
+		file << "<Game><Object id=\"o&amp;1\"/></Game>";
+	}
+	BOOST_REQUIRE(stream.open(fileName));
+	BOOST_REQUIRE(stream.parse(handler));
+	BOOST_REQUIRE_EQUAL(handler.events.size(), 4u);
+	BOOST_CHECK_EQUAL(handler.events[1], "<Object id=o&1>");
+	stream.close();
+}
+
+BOOST_AUTO_TEST_SUITE_END() // Support suite